@@ -17,20 +17,33 @@
 #ifndef CYBER_BASE_ATOMIC_HASH_MAP_H_
 #define CYBER_BASE_ATOMIC_HASH_MAP_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <memory>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
+#include "cyber/base/epoch_reclaimer.h"
+#include "cyber/base/macros.h"
+
 namespace apollo {
 namespace cyber {
 namespace base {
 /**
- * @brief A implementation of lock-free fixed size hash map
+ * @brief A implementation of lock-free hash map with open addressing
+ *
+ * The table doubles once half full. The resize is incremental: the new table
+ * takes new keys at once, while every Set moves a few slots of the old one
+ * until it is empty. Tables and replaced values are freed through
+ * EpochReclaimer, so readers never touch freed memory. Get(key, V*) copies
+ * the value out, Get(key, V**) returns the value in place, see there for how
+ * long it stays valid.
  *
  * @tparam K Type of key, must be integral
  * @tparam V Type of value
- * @tparam 128 Size of hash table
+ * @tparam 128 Initial size of hash table
  * @tparam 0 Type traits, use for checking types of key & value
  */
 template <typename K, typename V, std::size_t TableSize = 128,
@@ -39,258 +52,355 @@ template <typename K, typename V, std::size_t TableSize = 128,
                                   int>::type = 0>
 class AtomicHashMap {
  public:
-  AtomicHashMap() : capacity_(TableSize), mode_num_(capacity_ - 1) {}
+  AtomicHashMap() : table_(new Table(std::max<uint64_t>(TableSize, 16))) {}
   AtomicHashMap(const AtomicHashMap &other) = delete;
   AtomicHashMap &operator=(const AtomicHashMap &other) = delete;
+  ~AtomicHashMap();
 
   bool Has(K key) {
-    uint64_t index = key & mode_num_;
-    return table_[index].Has(key);
+    EpochReclaimer::Guard guard;
+    return Find(key) != nullptr;
   }
 
+  /**
+   * @brief Get the value of the key in place, it is neither copied nor
+   * locked. A Set of the same key retires the value through EpochReclaimer,
+   * so the pointer is only valid inside an EpochReclaimer::Guard the caller
+   * opened before this call. Keys which are never set again keep their value
+   * until the map is destroyed.
+   */
   bool Get(K key, V **value) {
-    uint64_t index = key & mode_num_;
-    return table_[index].Get(key, value);
+    EpochReclaimer::Guard guard;
+    V *val = Find(key);
+    if (val == nullptr) {
+      return false;
+    }
+    *value = val;
+    return true;
   }
 
   bool Get(K key, V *value) {
-    uint64_t index = key & mode_num_;
-    V *val = nullptr;
-    bool res = table_[index].Get(key, &val);
-    if (res) {
-      *value = *val;
+    EpochReclaimer::Guard guard;
+    V *val = Find(key);
+    if (val == nullptr) {
+      return false;
     }
-    return res;
+    *value = *val;
+    return true;
   }
 
-  void Set(K key) {
-    uint64_t index = key & mode_num_;
-    table_[index].Insert(key);
-  }
+  void Set(K key) { Insert(key, new V()); }
 
-  void Set(K key, const V &value) {
-    uint64_t index = key & mode_num_;
-    table_[index].Insert(key, value);
-  }
+  void Set(K key, const V &value) { Insert(key, new V(value)); }
+
+  void Set(K key, V &&value) { Insert(key, new V(std::forward<V>(value))); }
 
-  void Set(K key, V &&value) {
-    uint64_t index = key & mode_num_;
-    table_[index].Insert(key, std::forward<V>(value));
+  /**
+   * @brief Number of slots of the newest table
+   */
+  uint64_t Capacity() {
+    EpochReclaimer::Guard guard;
+    Table *table = table_.load(std::memory_order_acquire);
+    Table *next = table->next.load(std::memory_order_acquire);
+    return next == nullptr ? table->capacity : next->capacity;
   }
 
  private:
-  struct Entry {
-    Entry() {}
-    explicit Entry(K key) : key(key) {
-      value_ptr.store(new V(), std::memory_order_release);
-    }
-    Entry(K key, const V &value) : key(key) {
-      value_ptr.store(new V(value), std::memory_order_release);
-    }
-    Entry(K key, V &&value) : key(key) {
-      value_ptr.store(new V(std::forward<V>(value)), std::memory_order_release);
-    }
-    ~Entry() { delete value_ptr.load(std::memory_order_acquire); }
+  enum SlotState : uint32_t {
+    EMPTY = 0,
+    // key being written
+    BUSY,
+    FULL,
+    // key and value copied to the next table
+    MOVED,
+    // was empty when the table was migrated
+    CLOSED,
+  };
+
+  // set on the value of a slot being moved, updates go to the next table
+  static constexpr uintptr_t kFrozen = 1;
+  static constexpr uint64_t kMigrateChunk = 64;
 
+  struct Slot {
+    std::atomic<uint32_t> state = {EMPTY};
     K key = 0;
-    std::atomic<V *> value_ptr = {nullptr};
-    std::atomic<Entry *> next = {nullptr};
+    std::atomic<uintptr_t> value = {0};
   };
 
-  class Bucket {
-   public:
-    Bucket() : head_(new Entry()) {}
-    ~Bucket() {
-      Entry *ite = head_;
-      while (ite) {
-        auto tmp = ite->next.load(std::memory_order_acquire);
-        delete ite;
-        ite = tmp;
-      }
-    }
+  struct Table {
+    explicit Table(uint64_t size)
+        : capacity(size), mask(size - 1), slots(new Slot[size]) {}
 
-    bool Has(K key) {
-      Entry *m_target = head_->next.load(std::memory_order_acquire);
-      while (Entry *target = m_target) {
-        if (target->key < key) {
-          m_target = target->next.load(std::memory_order_acquire);
-          continue;
-        } else {
-          return target->key == key;
-        }
+    const uint64_t capacity;
+    const uint64_t mask;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> count = {0};
+    std::atomic<Table *> next = {nullptr};
+    // slots handed out to migrating threads, slots done
+    alignas(CACHELINE_SIZE) std::atomic<uint64_t> migrate_index = {0};
+    std::atomic<uint64_t> migrated = {0};
+  };
+
+  enum class Result { DONE, NEXT };
+
+  static uint64_t Hash(K key) {
+    // murmur3 finalizer, keys are often sequential or aligned
+    auto h = static_cast<uint64_t>(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  static V *Ptr(uintptr_t value) {
+    return reinterpret_cast<V *>(value & ~kFrozen);
+  }
+
+  static uint32_t WaitKey(const Slot &slot) {
+    uint32_t state = slot.state.load(std::memory_order_acquire);
+    for (uint32_t i = 0; state == BUSY; ++i) {
+      if (i < 64) {
+        cpu_relax();
+      } else {
+        std::this_thread::yield();
       }
-      return false;
+      state = slot.state.load(std::memory_order_acquire);
     }
+    return state;
+  }
 
-    bool Find(K key, Entry **prev_ptr, Entry **target_ptr) {
-      Entry *prev = head_;
-      Entry *m_target = head_->next.load(std::memory_order_acquire);
-      while (Entry *target = m_target) {
-        if (target->key == key) {
-          *prev_ptr = prev;
-          *target_ptr = target;
-          return true;
-        } else if (target->key > key) {
-          *prev_ptr = prev;
-          *target_ptr = target;
-          return false;
-        } else {
-          prev = target;
-          m_target = target->next.load(std::memory_order_acquire);
-        }
+  V *Find(K key);
+  void Insert(K key, V *value);
+  Result Upsert(Table *table, K key, uint64_t hash, V *value);
+  void StartResize(Table *table);
+  void Migrate(Table *table, bool all);
+  void MigrateSlot(Slot *slot, Table *next);
+
+  std::atomic<Table *> table_;
+};
+
+template <typename K, typename V, std::size_t TableSize,
+          typename std::enable_if<std::is_integral<K>::value &&
+                                      (TableSize & (TableSize - 1)) == 0,
+                                  int>::type T>
+AtomicHashMap<K, V, TableSize, T>::~AtomicHashMap() {
+  Table *table = table_.load(std::memory_order_acquire);
+  while (table != nullptr) {
+    for (uint64_t i = 0; i < table->capacity; ++i) {
+      auto &slot = table->slots[i];
+      // moved values are owned by the next table
+      if (slot.state.load(std::memory_order_acquire) == FULL) {
+        delete Ptr(slot.value.load(std::memory_order_acquire));
       }
-      *prev_ptr = prev;
-      *target_ptr = nullptr;
-      return false;
     }
+    Table *next = table->next.load(std::memory_order_acquire);
+    delete table;
+    table = next;
+  }
+}
 
-    void Insert(K key, const V &value) {
-      Entry *prev = nullptr;
-      Entry *target = nullptr;
-      Entry *new_entry = nullptr;
-      V *new_value = nullptr;
-      while (true) {
-        if (Find(key, &prev, &target)) {
-          // key exists, update value
-          if (!new_value) {
-            new_value = new V(value);
-          }
-          auto old_val_ptr = target->value_ptr.load(std::memory_order_acquire);
-          if (target->value_ptr.compare_exchange_strong(
-                  old_val_ptr, new_value, std::memory_order_acq_rel,
-                  std::memory_order_relaxed)) {
-            delete old_val_ptr;
-            if (new_entry) {
-              delete new_entry;
-              new_entry = nullptr;
-            }
-            return;
-          }
-          continue;
-        } else {
-          if (!new_entry) {
-            new_entry = new Entry(key, value);
-          }
-          new_entry->next.store(target, std::memory_order_release);
-          if (prev->next.compare_exchange_strong(target, new_entry,
-                                                 std::memory_order_acq_rel,
-                                                 std::memory_order_relaxed)) {
-            // Insert success
-            if (new_value) {
-              delete new_value;
-              new_value = nullptr;
-            }
-            return;
-          }
-          // another entry has been inserted, retry
-        }
+template <typename K, typename V, std::size_t TableSize,
+          typename std::enable_if<std::is_integral<K>::value &&
+                                      (TableSize & (TableSize - 1)) == 0,
+                                  int>::type T>
+V *AtomicHashMap<K, V, TableSize, T>::Find(K key) {
+  const uint64_t hash = Hash(key);
+  for (Table *table = table_.load(std::memory_order_acquire);
+       table != nullptr; table = table->next.load(std::memory_order_acquire)) {
+    for (uint64_t i = 0; i < table->capacity; ++i) {
+      auto &slot = table->slots[(hash + i) & table->mask];
+      uint32_t state = WaitKey(slot);
+      if (state == EMPTY || state == CLOSED) {
+        // not in this table, may have been added to the next one
+        break;
+      }
+      if (slot.key != key) {
+        continue;
       }
+      uintptr_t value = slot.value.load(std::memory_order_acquire);
+      if (slot.state.load(std::memory_order_acquire) == MOVED) {
+        break;
+      }
+      return Ptr(value);
     }
+  }
+  return nullptr;
+}
 
-    void Insert(K key, V &&value) {
-      Entry *prev = nullptr;
-      Entry *target = nullptr;
-      Entry *new_entry = nullptr;
-      V *new_value = nullptr;
-      while (true) {
-        if (Find(key, &prev, &target)) {
-          // key exists, update value
-          if (!new_value) {
-            new_value = new V(std::forward<V>(value));
-          }
-          auto old_val_ptr = target->value_ptr.load(std::memory_order_acquire);
-          if (target->value_ptr.compare_exchange_strong(
-                  old_val_ptr, new_value, std::memory_order_acq_rel,
-                  std::memory_order_relaxed)) {
-            delete old_val_ptr;
-            if (new_entry) {
-              delete new_entry;
-              new_entry = nullptr;
-            }
-            return;
-          }
-          continue;
-        } else {
-          if (!new_entry) {
-            new_entry = new Entry(key, value);
-          }
-          new_entry->next.store(target, std::memory_order_release);
-          if (prev->next.compare_exchange_strong(target, new_entry,
-                                                 std::memory_order_acq_rel,
-                                                 std::memory_order_relaxed)) {
-            // Insert success
-            if (new_value) {
-              delete new_value;
-              new_value = nullptr;
-            }
-            return;
-          }
-          // another entry has been inserted, retry
+template <typename K, typename V, std::size_t TableSize,
+          typename std::enable_if<std::is_integral<K>::value &&
+                                      (TableSize & (TableSize - 1)) == 0,
+                                  int>::type T>
+void AtomicHashMap<K, V, TableSize, T>::Insert(K key, V *value) {
+  EpochReclaimer::Guard guard;
+  const uint64_t hash = Hash(key);
+  Table *table = table_.load(std::memory_order_acquire);
+  if (table->next.load(std::memory_order_acquire) != nullptr) {
+    Migrate(table, false);
+    table = table_.load(std::memory_order_acquire);
+  }
+  while (Upsert(table, key, hash, value) == Result::NEXT) {
+    table = table->next.load(std::memory_order_acquire);
+  }
+}
+
+template <typename K, typename V, std::size_t TableSize,
+          typename std::enable_if<std::is_integral<K>::value &&
+                                      (TableSize & (TableSize - 1)) == 0,
+                                  int>::type T>
+typename AtomicHashMap<K, V, TableSize, T>::Result
+AtomicHashMap<K, V, TableSize, T>::Upsert(Table *table, K key, uint64_t hash,
+                                          V *value) {
+  if (table->next.load(std::memory_order_acquire) == nullptr &&
+      table->count.load(std::memory_order_relaxed) >= table->capacity / 2) {
+    StartResize(table);
+  }
+  for (uint64_t i = 0; i < table->capacity;) {
+    auto &slot = table->slots[(hash + i) & table->mask];
+    uint32_t state = WaitKey(slot);
+    if (state == EMPTY) {
+      if (table->next.load(std::memory_order_acquire) != nullptr) {
+        // new keys go to the next table, the migration closes the rest
+        if (slot.state.compare_exchange_strong(state, CLOSED,
+                                               std::memory_order_acq_rel)) {
+          return Result::NEXT;
         }
+      } else if (slot.state.compare_exchange_strong(
+                     state, BUSY, std::memory_order_acq_rel)) {
+        slot.key = key;
+        slot.value.store(reinterpret_cast<uintptr_t>(value),
+                         std::memory_order_relaxed);
+        slot.state.store(FULL, std::memory_order_release);
+        table->count.fetch_add(1, std::memory_order_relaxed);
+        return Result::DONE;
       }
+      // lost the slot, look at it again
+      continue;
     }
-
-    void Insert(K key) {
-      Entry *prev = nullptr;
-      Entry *target = nullptr;
-      Entry *new_entry = nullptr;
-      V *new_value = nullptr;
-      while (true) {
-        if (Find(key, &prev, &target)) {
-          // key exists, update value
-          if (!new_value) {
-            new_value = new V();
-          }
-          auto old_val_ptr = target->value_ptr.load(std::memory_order_acquire);
-          if (target->value_ptr.compare_exchange_strong(
-                  old_val_ptr, new_value, std::memory_order_acq_rel,
-                  std::memory_order_relaxed)) {
-            delete old_val_ptr;
-            if (new_entry) {
-              delete new_entry;
-              new_entry = nullptr;
-            }
-            return;
-          }
-          continue;
-        } else {
-          if (!new_entry) {
-            new_entry = new Entry(key);
-          }
-          new_entry->next.store(target, std::memory_order_release);
-          if (prev->next.compare_exchange_strong(target, new_entry,
-                                                 std::memory_order_acq_rel,
-                                                 std::memory_order_relaxed)) {
-            // Insert success
-            if (new_value) {
-              delete new_value;
-              new_value = nullptr;
-            }
-            return;
-          }
-          // another entry has been inserted, retry
+    if (state == CLOSED) {
+      return Result::NEXT;
+    }
+    if (slot.key != key) {
+      ++i;
+      continue;
+    }
+    if (state == MOVED) {
+      return Result::NEXT;
+    }
+    uintptr_t old_value = slot.value.load(std::memory_order_acquire);
+    while (true) {
+      if (old_value & kFrozen) {
+        // being moved, update the copy once it is there
+        while (slot.state.load(std::memory_order_acquire) != MOVED) {
+          std::this_thread::yield();
         }
+        return Result::NEXT;
+      }
+      if (slot.value.compare_exchange_weak(
+              old_value, reinterpret_cast<uintptr_t>(value),
+              std::memory_order_acq_rel, std::memory_order_acquire)) {
+        EpochReclaimer::Instance()->Retire(Ptr(old_value));
+        return Result::DONE;
       }
     }
+  }
+  // no room left, only when many threads insert at once
+  StartResize(table);
+  return Result::NEXT;
+}
 
-    bool Get(K key, V **value) {
-      Entry *prev = nullptr;
-      Entry *target = nullptr;
-      if (Find(key, &prev, &target)) {
-        *value = target->value_ptr.load(std::memory_order_acquire);
-        return true;
-      }
-      return false;
+template <typename K, typename V, std::size_t TableSize,
+          typename std::enable_if<std::is_integral<K>::value &&
+                                      (TableSize & (TableSize - 1)) == 0,
+                                  int>::type T>
+void AtomicHashMap<K, V, TableSize, T>::StartResize(Table *table) {
+  if (table->next.load(std::memory_order_acquire) != nullptr) {
+    return;
+  }
+  // one resize at a time, table is the next table of a migration
+  Table *root = table_.load(std::memory_order_acquire);
+  while (root != table) {
+    Migrate(root, true);
+    root = table_.load(std::memory_order_acquire);
+  }
+  Table *expected = nullptr;
+  Table *next = new Table(table->capacity * 2);
+  if (!table->next.compare_exchange_strong(expected, next,
+                                           std::memory_order_acq_rel)) {
+    delete next;
+  }
+}
+
+template <typename K, typename V, std::size_t TableSize,
+          typename std::enable_if<std::is_integral<K>::value &&
+                                      (TableSize & (TableSize - 1)) == 0,
+                                  int>::type T>
+void AtomicHashMap<K, V, TableSize, T>::Migrate(Table *table, bool all) {
+  Table *next = table->next.load(std::memory_order_acquire);
+  do {
+    uint64_t begin = table->migrate_index.fetch_add(
+        kMigrateChunk, std::memory_order_relaxed);
+    if (begin >= table->capacity) {
+      break;
     }
+    uint64_t end = std::min(begin + kMigrateChunk, table->capacity);
+    for (uint64_t i = begin; i < end; ++i) {
+      MigrateSlot(&table->slots[i], next);
+    }
+    if (table->migrated.fetch_add(end - begin, std::memory_order_acq_rel) +
+            (end - begin) ==
+        table->capacity) {
+      // the last chunk, readers still in the old table are guarded
+      table_.store(next, std::memory_order_release);
+      EpochReclaimer::Instance()->Retire(table);
+      return;
+    }
+  } while (all);
 
-    Entry *head_;
-  };
+  // every chunk is handed out, wait for the threads still moving them
+  while (all && table_.load(std::memory_order_acquire) == table) {
+    std::this_thread::yield();
+  }
+}
 
- private:
-  Bucket table_[TableSize];
-  uint64_t capacity_;
-  uint64_t mode_num_;
-};
+template <typename K, typename V, std::size_t TableSize,
+          typename std::enable_if<std::is_integral<K>::value &&
+                                      (TableSize & (TableSize - 1)) == 0,
+                                  int>::type T>
+void AtomicHashMap<K, V, TableSize, T>::MigrateSlot(Slot *slot, Table *next) {
+  uint32_t state = WaitKey(*slot);
+  while (state == EMPTY) {
+    if (slot->state.compare_exchange_strong(state, CLOSED,
+                                            std::memory_order_acq_rel)) {
+      return;
+    }
+    state = WaitKey(*slot);
+  }
+  if (state != FULL) {
+    return;
+  }
+  uintptr_t value = slot->value.fetch_or(kFrozen, std::memory_order_acq_rel);
+
+  // the key is not in the next table yet, inserters only get there after
+  // the slot is MOVED or through a CLOSED slot, which comes after it
+  const uint64_t hash = Hash(slot->key);
+  for (uint64_t i = 0;; ++i) {
+    auto &target = next->slots[(hash + i) & next->mask];
+    uint32_t expected = EMPTY;
+    if (target.state.load(std::memory_order_relaxed) == EMPTY &&
+        target.state.compare_exchange_strong(expected, BUSY,
+                                             std::memory_order_acq_rel)) {
+      target.key = slot->key;
+      target.value.store(value & ~kFrozen, std::memory_order_relaxed);
+      target.state.store(FULL, std::memory_order_release);
+      next->count.fetch_add(1, std::memory_order_relaxed);
+      break;
+    }
+  }
+  slot->state.store(MOVED, std::memory_order_release);
+}
 
 }  // namespace base
 }  // namespace cyber
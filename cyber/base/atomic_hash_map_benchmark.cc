@@ -0,0 +1,235 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/base/atomic_hash_map.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+// The previous AtomicHashMap: a fixed number of buckets, each a sorted list
+// of entries, values freed as soon as they are replaced. Kept here as the
+// baseline, Get and Set only.
+template <typename K, typename V, std::size_t TableSize = 128>
+class ChainedHashMap {
+ public:
+  bool Get(K key, V *value) {
+    V *val = nullptr;
+    bool res = table_[key & (TableSize - 1)].Get(key, &val);
+    if (res) {
+      *value = *val;
+    }
+    return res;
+  }
+
+  void Set(K key, const V &value) {
+    table_[key & (TableSize - 1)].Insert(key, value);
+  }
+
+ private:
+  struct Entry {
+    Entry() {}
+    Entry(K key, const V &value) : key(key), value_ptr(new V(value)) {}
+    ~Entry() { delete value_ptr.load(std::memory_order_acquire); }
+
+    K key = 0;
+    std::atomic<V *> value_ptr = {nullptr};
+    std::atomic<Entry *> next = {nullptr};
+  };
+
+  class Bucket {
+   public:
+    Bucket() : head_(new Entry()) {}
+    ~Bucket() {
+      Entry *ite = head_;
+      while (ite) {
+        auto tmp = ite->next.load(std::memory_order_acquire);
+        delete ite;
+        ite = tmp;
+      }
+    }
+
+    bool Find(K key, Entry **prev_ptr, Entry **target_ptr) {
+      Entry *prev = head_;
+      Entry *target = head_->next.load(std::memory_order_acquire);
+      while (target != nullptr && target->key < key) {
+        prev = target;
+        target = target->next.load(std::memory_order_acquire);
+      }
+      *prev_ptr = prev;
+      *target_ptr = target;
+      return target != nullptr && target->key == key;
+    }
+
+    void Insert(K key, const V &value) {
+      Entry *prev = nullptr;
+      Entry *target = nullptr;
+      Entry *new_entry = nullptr;
+      V *new_value = nullptr;
+      while (true) {
+        if (Find(key, &prev, &target)) {
+          if (!new_value) {
+            new_value = new V(value);
+          }
+          auto old_val_ptr = target->value_ptr.load(std::memory_order_acquire);
+          if (target->value_ptr.compare_exchange_strong(
+                  old_val_ptr, new_value, std::memory_order_acq_rel,
+                  std::memory_order_relaxed)) {
+            delete old_val_ptr;
+            delete new_entry;
+            return;
+          }
+          continue;
+        }
+        if (!new_entry) {
+          new_entry = new Entry(key, value);
+        }
+        new_entry->next.store(target, std::memory_order_release);
+        if (prev->next.compare_exchange_strong(target, new_entry,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_relaxed)) {
+          delete new_value;
+          return;
+        }
+      }
+    }
+
+    bool Get(K key, V **value) {
+      Entry *prev = nullptr;
+      Entry *target = nullptr;
+      if (Find(key, &prev, &target)) {
+        *value = target->value_ptr.load(std::memory_order_acquire);
+        return true;
+      }
+      return false;
+    }
+
+   private:
+    Entry *head_;
+  };
+
+  Bucket table_[TableSize];
+};
+
+// state.range(0) threads share a map of state.range(1) keys, e.g. one per
+// channel, and every thread does kOpNum operations per iteration, of which
+// one in state.range(2) is a Set and the rest are Gets. The keys are spread
+// like channel ids, hashes of the channel names.
+constexpr uint64_t kOpNum = 1 << 16;
+
+std::vector<uint64_t> MakeKeys(uint64_t key_num) {
+  std::vector<uint64_t> keys(key_num);
+  std::mt19937_64 rng(key_num);
+  for (auto &key : keys) {
+    key = rng();
+  }
+  return keys;
+}
+
+template <typename Map>
+void RunMixed(benchmark::State &state) {
+  const auto thread_num = static_cast<uint64_t>(state.range(0));
+  const auto keys = MakeKeys(static_cast<uint64_t>(state.range(1)));
+  const auto set_every = static_cast<uint64_t>(state.range(2));
+  Map map;
+  for (uint64_t i = 0; i < keys.size(); ++i) {
+    map.Set(keys[i], i);
+  }
+  for (auto _ : state) {
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < thread_num; ++t) {
+      threads.emplace_back([&map, &keys, set_every, t]() {
+        uint64_t value = 0;
+        uint64_t sum = 0;
+        uint64_t index = t * 7919;
+        for (uint64_t i = 0; i < kOpNum; ++i) {
+          index = (index + 40503) % keys.size();
+          if (set_every != 0 && i % set_every == 0) {
+            map.Set(keys[index], i);
+          } else if (map.Get(keys[index], &value)) {
+            sum += value;
+          }
+        }
+        benchmark::DoNotOptimize(sum);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * thread_num * kOpNum);
+}
+
+void BM_ChainedHashMap(benchmark::State &state) {
+  RunMixed<ChainedHashMap<uint64_t, uint64_t>>(state);
+}
+
+void BM_AtomicHashMap(benchmark::State &state) {
+  RunMixed<AtomicHashMap<uint64_t, uint64_t>>(state);
+}
+
+// Every iteration inserts state.range(0) keys into a new map of the default
+// size, so the open addressing map resizes on the way.
+template <typename Map>
+void RunInsert(benchmark::State &state) {
+  const auto keys = MakeKeys(static_cast<uint64_t>(state.range(0)));
+  for (auto _ : state) {
+    Map map;
+    for (uint64_t i = 0; i < keys.size(); ++i) {
+      map.Set(keys[i], i);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_ChainedHashMapInsert(benchmark::State &state) {
+  RunInsert<ChainedHashMap<uint64_t, uint64_t>>(state);
+}
+
+void BM_AtomicHashMapInsert(benchmark::State &state) {
+  RunInsert<AtomicHashMap<uint64_t, uint64_t>>(state);
+}
+
+void MixedArgs(benchmark::internal::Benchmark *b) {
+  for (int64_t threads : {1, 4, 8}) {
+    for (int64_t keys : {64, 4096}) {
+      // read only, 1% and 10% writes
+      for (int64_t set_every : {0, 100, 10}) {
+        b->Args({threads, keys, set_every});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_ChainedHashMap)->Apply(MixedArgs)->UseRealTime();
+BENCHMARK(BM_AtomicHashMap)->Apply(MixedArgs)->UseRealTime();
+BENCHMARK(BM_ChainedHashMapInsert)->Arg(64)->Arg(4096);
+BENCHMARK(BM_AtomicHashMapInsert)->Arg(64)->Arg(4096);
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
@@ -16,8 +16,10 @@
 
 #include "cyber/base/atomic_hash_map.h"
 
+#include <atomic>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -98,6 +100,76 @@ TEST(AtomicHashMapTest, concurrency) {
   EXPECT_EQ("0", *str);
 }
 
+TEST(AtomicHashMapTest, resize) {
+  AtomicHashMap<uint64_t, uint64_t, 16> map;
+  EXPECT_EQ(16, map.Capacity());
+  const uint64_t key_num = 10000;
+  std::atomic<bool> done = {false};
+  // readers follow the keys through every resize
+  std::thread reader([&]() {
+    uint64_t value = 0;
+    while (!done.load()) {
+      for (uint64_t i = 0; i < 64; ++i) {
+        if (map.Get(i * 4096, &value)) {
+          ASSERT_EQ(i, value);
+        }
+      }
+    }
+  });
+  std::vector<std::thread> writers;
+  for (uint64_t t = 0; t < 4; ++t) {
+    writers.emplace_back([&map, t, key_num]() {
+      for (uint64_t i = t; i < key_num; i += 4) {
+        map.Set(i * 4096, i);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+
+  EXPECT_GE(map.Capacity(), 2 * key_num);
+  uint64_t* value = nullptr;
+  for (uint64_t i = 0; i < key_num; ++i) {
+    ASSERT_TRUE(map.Get(i * 4096, &value));
+    EXPECT_EQ(i, *value);
+  }
+  EXPECT_FALSE(map.Has(1));
+}
+
+struct Counted {
+  Counted() { ++alive; }
+  Counted(const Counted&) { ++alive; }
+  ~Counted() { --alive; }
+  static int alive;
+};
+int Counted::alive = 0;
+
+TEST(AtomicHashMapTest, reclaim) {
+  {
+    AtomicHashMap<int, Counted> map;
+    map.Set(1);
+    Counted* first = nullptr;
+    ASSERT_TRUE(map.Get(1, &first));
+    {
+      // a guard older than the update keeps the old value alive
+      EpochReclaimer::Guard guard;
+      map.Set(1, Counted());
+      EpochReclaimer::Instance()->Flush();
+      EpochReclaimer::Instance()->Collect();
+      EXPECT_EQ(2, Counted::alive);
+      Counted* second = nullptr;
+      ASSERT_TRUE(map.Get(1, &second));
+      EXPECT_NE(first, second);
+    }
+    EpochReclaimer::Instance()->Collect();
+    EXPECT_EQ(1, Counted::alive);
+  }
+  EXPECT_EQ(0, Counted::alive);
+}
+
 }  // namespace base
 }  // namespace cyber
 }  // namespace apollo
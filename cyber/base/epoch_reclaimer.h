@@ -0,0 +1,213 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_EPOCH_RECLAIMER_H_
+#define CYBER_BASE_EPOCH_RECLAIMER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @class EpochReclaimer
+ * @brief Epoch based memory reclamation for lock-free structures. Readers
+ * hold a Guard while they touch shared nodes, writers Retire the nodes they
+ * unlinked, which are deleted once every guard older than the unlink is
+ * gone. Entering a guard costs one fence. Retired pointers are kept per
+ * thread and handed over in batches, so the mutex of the reclaimer is only
+ * taken every kRetireBatch retires.
+ */
+class EpochReclaimer {
+ private:
+  struct Record;
+
+ public:
+  class Guard {
+   public:
+    Guard() : record_(LocalRecord()) {
+      if (record_->depth++ == 0) {
+        record_->epoch.store(
+            Instance()->global_epoch_.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+        // pairs with the fence in Collect
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+      }
+    }
+    ~Guard() {
+      if (--record_->depth == 0) {
+        record_->epoch.store(0, std::memory_order_release);
+      }
+    }
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+   private:
+    Record* record_;
+  };
+
+  static EpochReclaimer* Instance() {
+    // never destroyed, threads may exit after static destructors ran
+    static EpochReclaimer* instance = new EpochReclaimer();
+    return instance;
+  }
+
+  template <typename T>
+  void Retire(T* ptr) {
+    Retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+  }
+
+  /**
+   * @brief Delete ptr with deleter once no guard can see it. ptr must not be
+   * reachable by new readers anymore.
+   */
+  void Retire(void* ptr, void (*deleter)(void*)) {
+    auto& retired = LocalRecord()->retired;
+    retired.push_back(
+        {ptr, deleter, global_epoch_.fetch_add(1, std::memory_order_seq_cst)});
+    if (retired.size() >= kRetireBatch) {
+      Flush();
+      Collect();
+    }
+  }
+
+  /**
+   * @brief Delete the retired pointers no guard can see anymore
+   */
+  void Collect() {
+    std::vector<RetiredPtr> expired;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      uint64_t min_epoch = std::numeric_limits<uint64_t>::max();
+      for (Record* record = records_.load(std::memory_order_acquire);
+           record != nullptr; record = record->next) {
+        uint64_t epoch = record->epoch.load(std::memory_order_acquire);
+        if (epoch != 0) {
+          min_epoch = std::min(min_epoch, epoch);
+        }
+      }
+      auto it = std::partition(retired_.begin(), retired_.end(),
+                               [min_epoch](const RetiredPtr& retired) {
+                                 return retired.epoch >= min_epoch;
+                               });
+      expired.assign(it, retired_.end());
+      retired_.erase(it, retired_.end());
+    }
+    for (auto& retired : expired) {
+      retired.deleter(retired.ptr);
+    }
+  }
+
+  /**
+   * @brief Hand the pointers retired by this thread over to Collect
+   */
+  void Flush() { FlushRecord(LocalRecord()); }
+
+  uint64_t PendingNum() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return retired_.size();
+  }
+
+ private:
+  static constexpr size_t kRetireBatch = 64;
+
+  struct RetiredPtr {
+    void* ptr;
+    void (*deleter)(void*);
+    uint64_t epoch;
+  };
+
+  struct alignas(CACHELINE_SIZE) Record {
+    // 0 outside of any guard
+    std::atomic<uint64_t> epoch = {0};
+    std::atomic<bool> in_use = {false};
+    uint32_t depth = 0;
+    Record* next = nullptr;
+    // only touched by the owning thread
+    std::vector<RetiredPtr> retired;
+  };
+
+  struct ThreadRecord {
+    Record* record = nullptr;
+    ~ThreadRecord() {
+      if (record != nullptr) {
+        Instance()->FlushRecord(record);
+        record->in_use.store(false, std::memory_order_release);
+      }
+    }
+  };
+
+  EpochReclaimer() = default;
+
+  // records are reused by later threads but never freed
+  static Record* LocalRecord() {
+    static thread_local ThreadRecord local;
+    if (cyber_unlikely(local.record == nullptr)) {
+      local.record = Instance()->AcquireRecord();
+    }
+    return local.record;
+  }
+
+  void FlushRecord(Record* record) {
+    auto& retired = record->retired;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      retired_.insert(retired_.end(), retired.begin(), retired.end());
+    }
+    retired.clear();
+  }
+
+  Record* AcquireRecord() {
+    for (Record* record = records_.load(std::memory_order_acquire);
+         record != nullptr; record = record->next) {
+      bool in_use = false;
+      if (!record->in_use.load(std::memory_order_relaxed) &&
+          record->in_use.compare_exchange_strong(in_use, true,
+                                                 std::memory_order_acquire)) {
+        return record;
+      }
+    }
+    auto record = new Record();
+    record->in_use.store(true, std::memory_order_relaxed);
+    Record* head = records_.load(std::memory_order_relaxed);
+    do {
+      record->next = head;
+    } while (!records_.compare_exchange_weak(head, record,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+    return record;
+  }
+
+  std::atomic<uint64_t> global_epoch_ = {1};
+  std::atomic<Record*> records_ = {nullptr};
+  std::mutex mutex_;
+  std::vector<RetiredPtr> retired_;
+};
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_EPOCH_RECLAIMER_H_
@@ -0,0 +1,391 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_MPMC_RING_H_
+#define CYBER_BASE_MPMC_RING_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @brief How the Wait* calls of a MpmcRing wait once a short spin is over.
+ * BLOCK sleeps on a condition variable, woken by the other side only when
+ * somebody sleeps. SPIN keeps polling and yielding, for threads that own a
+ * core and cannot afford a wakeup.
+ */
+enum class RingWaitMode { BLOCK, SPIN };
+
+/**
+ * @class MpmcRing
+ * @brief Bounded multi producer multi consumer ring. Every slot carries a
+ * sequence number and sits on its own cache line, so producers and consumers
+ * only contend on the position they claim. Unlike BoundedQueue, producers do
+ * not commit in order, elements are moved in and out, and the bulk calls
+ * claim a whole range with one atomic operation.
+ *
+ * The bulk calls may wait for a thread that claimed a neighbouring position
+ * to finish its copy, they are not lock free.
+ */
+template <typename T>
+class MpmcRing {
+ public:
+  using value_type = T;
+  using size_type = uint64_t;
+
+ public:
+  MpmcRing() {}
+  MpmcRing& operator=(const MpmcRing& other) = delete;
+  MpmcRing(const MpmcRing& other) = delete;
+  ~MpmcRing();
+
+  /**
+   * @brief Allocate the slots, size is rounded up to a power of two
+   */
+  bool Init(uint64_t size, RingWaitMode mode = RingWaitMode::BLOCK);
+
+  bool Enqueue(const T& element) { return EnqueueImpl(element); }
+  bool Enqueue(T&& element) { return EnqueueImpl(std::move(element)); }
+  bool Dequeue(T* element);
+
+  /**
+   * @brief Move up to count elements from first into the ring
+   *
+   * @return the number of elements moved, 0 if the ring is full
+   */
+  template <typename InputIt>
+  uint64_t EnqueueBulk(InputIt first, uint64_t count);
+
+  /**
+   * @brief Move up to max_count elements out of the ring
+   *
+   * @return the number of elements moved, 0 if the ring is empty
+   */
+  uint64_t DequeueBulk(T* elements, uint64_t max_count);
+
+  bool WaitEnqueue(const T& element);
+  bool WaitEnqueue(T&& element);
+  bool WaitDequeue(T* element);
+  uint64_t WaitDequeueBulk(T* elements, uint64_t max_count);
+
+  /**
+   * @brief Wake up every waiting thread, Wait* fail from now on
+   */
+  void BreakAllWait();
+
+  uint64_t Size() const;
+  bool Empty() const { return Size() == 0; }
+  uint64_t Capacity() const { return capacity_; }
+
+ private:
+  struct alignas(CACHELINE_SIZE) Slot {
+    std::atomic<uint64_t> seq = {0};
+    T value;
+  };
+
+  struct alignas(CACHELINE_SIZE) Waiters {
+    std::atomic<uint32_t> count = {0};
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+
+  static constexpr uint32_t kSpinCount = 64;
+
+  template <typename U>
+  bool EnqueueImpl(U&& element);
+  bool HasData() const {
+    auto pos = head_.load(std::memory_order_relaxed);
+    return slots_[pos & mask_].seq.load(std::memory_order_acquire) == pos + 1;
+  }
+  bool HasSpace() const {
+    auto pos = tail_.load(std::memory_order_relaxed);
+    return slots_[pos & mask_].seq.load(std::memory_order_acquire) == pos;
+  }
+  // the thread we wait for may have been preempted, yield after a while
+  static void WaitSeq(const Slot& slot, uint64_t seq) {
+    for (uint32_t i = 0; slot.seq.load(std::memory_order_acquire) != seq;
+         ++i) {
+      if (i < kSpinCount) {
+        cpu_relax();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+  void Notify(Waiters* waiters, bool all);
+  template <typename Op, typename Ready>
+  bool Wait(Waiters* waiters, Op&& op, Ready&& ready);
+
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> head_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> tail_ = {0};
+  alignas(CACHELINE_SIZE) uint64_t capacity_ = 0;
+  uint64_t mask_ = 0;
+  std::unique_ptr<Slot[]> slots_;
+  RingWaitMode mode_ = RingWaitMode::BLOCK;
+  std::atomic<bool> break_all_wait_ = {false};
+  Waiters not_empty_;
+  Waiters not_full_;
+};
+
+template <typename T>
+MpmcRing<T>::~MpmcRing() {
+  if (slots_) {
+    BreakAllWait();
+  }
+}
+
+template <typename T>
+bool MpmcRing<T>::Init(uint64_t size, RingWaitMode mode) {
+  capacity_ = 2;
+  while (capacity_ < size) {
+    capacity_ <<= 1;
+  }
+  mask_ = capacity_ - 1;
+  slots_.reset(new (std::nothrow) Slot[capacity_]);
+  if (slots_ == nullptr) {
+    return false;
+  }
+  for (uint64_t i = 0; i < capacity_; ++i) {
+    slots_[i].seq.store(i, std::memory_order_relaxed);
+  }
+  mode_ = mode;
+  return true;
+}
+
+template <typename T>
+template <typename U>
+bool MpmcRing<T>::EnqueueImpl(U&& element) {
+  Slot* slot = nullptr;
+  uint64_t pos = tail_.load(std::memory_order_relaxed);
+  while (true) {
+    slot = &slots_[pos & mask_];
+    auto diff = static_cast<int64_t>(
+        slot->seq.load(std::memory_order_acquire) - pos);
+    if (diff == 0) {
+      if (tail_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // the consumer of the previous round is not done
+      return false;
+    } else {
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+  slot->value = std::forward<U>(element);
+  slot->seq.store(pos + 1, std::memory_order_release);
+  Notify(&not_empty_, false);
+  return true;
+}
+
+template <typename T>
+bool MpmcRing<T>::Dequeue(T* element) {
+  Slot* slot = nullptr;
+  uint64_t pos = head_.load(std::memory_order_relaxed);
+  while (true) {
+    slot = &slots_[pos & mask_];
+    auto diff = static_cast<int64_t>(
+        slot->seq.load(std::memory_order_acquire) - (pos + 1));
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+  *element = std::move(slot->value);
+  slot->seq.store(pos + capacity_, std::memory_order_release);
+  Notify(&not_full_, false);
+  return true;
+}
+
+template <typename T>
+template <typename InputIt>
+uint64_t MpmcRing<T>::EnqueueBulk(InputIt first, uint64_t count) {
+  uint64_t num = 0;
+  uint64_t pos = tail_.load(std::memory_order_relaxed);
+  do {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t used = pos > head ? pos - head : 0;
+    if (used >= capacity_) {
+      return 0;
+    }
+    num = std::min(count, capacity_ - used);
+    if (num == 0) {
+      return 0;
+    }
+  } while (!tail_.compare_exchange_weak(pos, pos + num,
+                                        std::memory_order_relaxed));
+
+  for (uint64_t i = 0; i < num; ++i, ++first) {
+    auto& slot = slots_[(pos + i) & mask_];
+    // the consumer of the previous round claimed the slot but may still copy
+    WaitSeq(slot, pos + i);
+    slot.value = std::move(*first);
+    slot.seq.store(pos + i + 1, std::memory_order_release);
+  }
+  Notify(&not_empty_, num > 1);
+  return num;
+}
+
+template <typename T>
+uint64_t MpmcRing<T>::DequeueBulk(T* elements, uint64_t max_count) {
+  uint64_t num = 0;
+  uint64_t pos = head_.load(std::memory_order_relaxed);
+  do {
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    if (tail <= pos) {
+      return 0;
+    }
+    num = std::min(max_count, tail - pos);
+    if (num == 0) {
+      return 0;
+    }
+  } while (!head_.compare_exchange_weak(pos, pos + num,
+                                        std::memory_order_relaxed));
+
+  for (uint64_t i = 0; i < num; ++i) {
+    auto& slot = slots_[(pos + i) & mask_];
+    // the producer claimed the slot but may still copy
+    WaitSeq(slot, pos + i + 1);
+    elements[i] = std::move(slot.value);
+    slot.seq.store(pos + i + capacity_, std::memory_order_release);
+  }
+  Notify(&not_full_, num > 1);
+  return num;
+}
+
+template <typename T>
+void MpmcRing<T>::Notify(Waiters* waiters, bool all) {
+  if (mode_ != RingWaitMode::BLOCK) {
+    return;
+  }
+  // pairs with the fence in Wait, either the waiter sees the new state or
+  // we see the waiter
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters->count.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  { std::lock_guard<std::mutex> lock(waiters->mutex); }
+  if (all) {
+    waiters->cv.notify_all();
+  } else {
+    waiters->cv.notify_one();
+  }
+}
+
+template <typename T>
+template <typename Op, typename Ready>
+bool MpmcRing<T>::Wait(Waiters* waiters, Op&& op, Ready&& ready) {
+  for (uint32_t i = 0; i < kSpinCount; ++i) {
+    if (op()) {
+      return true;
+    }
+    cpu_relax();
+  }
+  while (!break_all_wait_.load(std::memory_order_acquire)) {
+    if (op()) {
+      return true;
+    }
+    if (mode_ == RingWaitMode::SPIN) {
+      std::this_thread::yield();
+      continue;
+    }
+    // op is not called under the lock, it notifies the other side
+    std::unique_lock<std::mutex> lock(waiters->mutex);
+    waiters->count.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    waiters->cv.wait(lock, [this, &ready]() {
+      return ready() || break_all_wait_.load(std::memory_order_acquire);
+    });
+    waiters->count.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return false;
+}
+
+template <typename T>
+bool MpmcRing<T>::WaitEnqueue(const T& element) {
+  return Wait(
+      &not_full_, [this, &element]() { return EnqueueImpl(element); },
+      [this]() { return HasSpace(); });
+}
+
+template <typename T>
+bool MpmcRing<T>::WaitEnqueue(T&& element) {
+  // only moved from once enqueued
+  return Wait(
+      &not_full_,
+      [this, &element]() { return EnqueueImpl(std::move(element)); },
+      [this]() { return HasSpace(); });
+}
+
+template <typename T>
+bool MpmcRing<T>::WaitDequeue(T* element) {
+  return Wait(
+      &not_empty_, [this, element]() { return Dequeue(element); },
+      [this]() { return HasData(); });
+}
+
+template <typename T>
+uint64_t MpmcRing<T>::WaitDequeueBulk(T* elements, uint64_t max_count) {
+  uint64_t num = 0;
+  Wait(
+      &not_empty_,
+      [this, elements, max_count, &num]() {
+        num = DequeueBulk(elements, max_count);
+        return num > 0;
+      },
+      [this]() { return HasData(); });
+  return num;
+}
+
+template <typename T>
+void MpmcRing<T>::BreakAllWait() {
+  break_all_wait_.store(true, std::memory_order_release);
+  for (auto waiters : {&not_empty_, &not_full_}) {
+    { std::lock_guard<std::mutex> lock(waiters->mutex); }
+    waiters->cv.notify_all();
+  }
+}
+
+template <typename T>
+uint64_t MpmcRing<T>::Size() const {
+  uint64_t head = head_.load(std::memory_order_acquire);
+  uint64_t tail = tail_.load(std::memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_MPMC_RING_H_
@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/base/bounded_queue.h"
+#include "cyber/base/mpmc_ring.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+// Every iteration moves kItemNum elements from state.range(0) producers to
+// state.range(1) consumers through a queue of kQueueSize, state.range(2) is
+// the batch size of the bulk calls.
+constexpr uint64_t kItemNum = 1 << 16;
+constexpr uint64_t kQueueSize = 1024;
+
+template <typename Queue, typename Init, typename Push, typename Pop>
+void RunProducersConsumers(benchmark::State& state, Init&& init, Push&& push,
+                           Pop&& pop) {
+  const auto producer_num = static_cast<uint64_t>(state.range(0));
+  const auto consumer_num = static_cast<uint64_t>(state.range(1));
+  const uint64_t per_producer = kItemNum / producer_num;
+  const uint64_t total = per_producer * producer_num;
+  for (auto _ : state) {
+    Queue queue;
+    init(&queue);
+    std::atomic<uint64_t> popped = {0};
+    std::vector<std::thread> threads;
+    for (uint64_t i = 0; i < producer_num; ++i) {
+      threads.emplace_back(
+          [&push, &queue, per_producer]() { push(&queue, per_producer); });
+    }
+    for (uint64_t i = 0; i < consumer_num; ++i) {
+      threads.emplace_back([&pop, &queue, &popped, total]() {
+        pop(&queue, &popped, total);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * total);
+}
+
+template <typename Queue>
+void Push(Queue* queue, uint64_t num) {
+  for (uint64_t i = 0; i < num; ++i) {
+    while (!queue->Enqueue(i)) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+template <typename Queue>
+void Pop(Queue* queue, std::atomic<uint64_t>* popped, uint64_t total) {
+  uint64_t value = 0;
+  while (popped->load(std::memory_order_relaxed) < total) {
+    if (queue->Dequeue(&value)) {
+      popped->fetch_add(1, std::memory_order_relaxed);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  benchmark::DoNotOptimize(value);
+}
+
+void BM_BoundedQueue(benchmark::State& state) {
+  using Queue = BoundedQueue<uint64_t>;
+  RunProducersConsumers<Queue>(
+      state,
+      [](Queue* queue) {
+        queue->Init(kQueueSize, new BusySpinWaitStrategy());
+      },
+      Push<Queue>, Pop<Queue>);
+}
+
+void BM_MpmcRing(benchmark::State& state) {
+  using Queue = MpmcRing<uint64_t>;
+  RunProducersConsumers<Queue>(
+      state, [](Queue* queue) { queue->Init(kQueueSize, RingWaitMode::SPIN); },
+      Push<Queue>, Pop<Queue>);
+}
+
+void BM_MpmcRingBulk(benchmark::State& state) {
+  using Queue = MpmcRing<uint64_t>;
+  const auto batch = static_cast<uint64_t>(state.range(2));
+  RunProducersConsumers<Queue>(
+      state, [](Queue* queue) { queue->Init(kQueueSize, RingWaitMode::SPIN); },
+      [batch](Queue* queue, uint64_t num) {
+        std::vector<uint64_t> values(batch);
+        for (uint64_t i = 0; i < num;) {
+          uint64_t count = std::min(batch, num - i);
+          auto it = values.begin();
+          while (count > 0) {
+            auto pushed = queue->EnqueueBulk(it, count);
+            if (pushed == 0) {
+              std::this_thread::yield();
+            }
+            it += pushed;
+            count -= pushed;
+            i += pushed;
+          }
+        }
+      },
+      [batch](Queue* queue, std::atomic<uint64_t>* popped, uint64_t total) {
+        std::vector<uint64_t> values(batch);
+        while (popped->load(std::memory_order_relaxed) < total) {
+          auto num = queue->DequeueBulk(values.data(), batch);
+          if (num > 0) {
+            popped->fetch_add(num, std::memory_order_relaxed);
+          } else {
+            std::this_thread::yield();
+          }
+        }
+        benchmark::DoNotOptimize(values.data());
+      });
+}
+
+// consumers sleep until woken up by the producers
+void BM_MpmcRingBlocking(benchmark::State& state) {
+  using Queue = MpmcRing<uint64_t>;
+  const auto batch = static_cast<uint64_t>(state.range(2));
+  RunProducersConsumers<Queue>(
+      state,
+      [](Queue* queue) { queue->Init(kQueueSize, RingWaitMode::BLOCK); },
+      [](Queue* queue, uint64_t num) {
+        for (uint64_t i = 0; i < num; ++i) {
+          queue->WaitEnqueue(i);
+        }
+      },
+      [batch](Queue* queue, std::atomic<uint64_t>* popped, uint64_t total) {
+        std::vector<uint64_t> values(batch);
+        while (popped->load() < total) {
+          auto num = queue->WaitDequeueBulk(values.data(), batch);
+          if (popped->fetch_add(num) + num == total) {
+            // the other consumers are still waiting
+            queue->BreakAllWait();
+          }
+        }
+      });
+}
+
+void ProducerConsumerArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t threads : {1, 2, 4}) {
+    b->Args({threads, threads, 32});
+  }
+  b->Args({4, 1, 32});
+  b->Args({1, 4, 32});
+}
+
+BENCHMARK(BM_BoundedQueue)->Apply(ProducerConsumerArgs)->UseRealTime();
+BENCHMARK(BM_MpmcRing)->Apply(ProducerConsumerArgs)->UseRealTime();
+BENCHMARK(BM_MpmcRingBulk)->Apply(ProducerConsumerArgs)->UseRealTime();
+BENCHMARK(BM_MpmcRingBlocking)->Apply(ProducerConsumerArgs)->UseRealTime();
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/base/mpmc_ring.h"
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+TEST(MpmcRingTest, EnqueueDequeue) {
+  MpmcRing<int> ring;
+  ASSERT_TRUE(ring.Init(100));
+  EXPECT_EQ(128, ring.Capacity());
+  EXPECT_TRUE(ring.Empty());
+  for (int i = 0; i < 128; ++i) {
+    EXPECT_TRUE(ring.Enqueue(i));
+  }
+  EXPECT_EQ(128, ring.Size());
+  EXPECT_FALSE(ring.Enqueue(128));
+  int value = 0;
+  for (int i = 0; i < 128; ++i) {
+    EXPECT_TRUE(ring.Dequeue(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(ring.Dequeue(&value));
+  EXPECT_TRUE(ring.Empty());
+}
+
+TEST(MpmcRingTest, Bulk) {
+  MpmcRing<std::unique_ptr<int>> ring;
+  ASSERT_TRUE(ring.Init(8));
+  std::vector<std::unique_ptr<int>> in;
+  for (int i = 0; i < 10; ++i) {
+    in.emplace_back(new int(i));
+  }
+  // only what fits is moved
+  EXPECT_EQ(8, ring.EnqueueBulk(in.begin(), in.size()));
+  EXPECT_EQ(nullptr, in[0]);
+  EXPECT_NE(nullptr, in[8]);
+  EXPECT_EQ(0, ring.EnqueueBulk(in.begin() + 8, 2));
+
+  std::unique_ptr<int> out[16];
+  EXPECT_EQ(5, ring.DequeueBulk(out, 5));
+  EXPECT_EQ(2, ring.EnqueueBulk(in.begin() + 8, 2));
+  EXPECT_EQ(5, ring.DequeueBulk(out + 5, 16));
+  EXPECT_EQ(0, ring.DequeueBulk(out, 16));
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_NE(nullptr, out[i]);
+    EXPECT_EQ(i, *out[i]);
+  }
+}
+
+TEST(MpmcRingTest, BreakAllWait) {
+  for (auto mode : {RingWaitMode::BLOCK, RingWaitMode::SPIN}) {
+    MpmcRing<int> ring;
+    ASSERT_TRUE(ring.Init(2, mode));
+    std::thread consumer([&ring]() {
+      int value = 0;
+      EXPECT_TRUE(ring.WaitDequeue(&value));
+      EXPECT_EQ(1, value);
+      EXPECT_FALSE(ring.WaitDequeue(&value));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(ring.WaitEnqueue(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ring.BreakAllWait();
+    consumer.join();
+  }
+}
+
+TEST(MpmcRingTest, concurrency) {
+  const int producer_num = 4;
+  const int consumer_num = 4;
+  const uint64_t per_producer = 50000;
+  for (auto mode : {RingWaitMode::BLOCK, RingWaitMode::SPIN}) {
+    MpmcRing<uint64_t> ring;
+    ASSERT_TRUE(ring.Init(64, mode));
+    std::atomic<uint64_t> sum = {0};
+    std::atomic<uint64_t> count = {0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producer_num; ++i) {
+      threads.emplace_back([&ring, i, per_producer]() {
+        std::vector<uint64_t> batch;
+        for (uint64_t j = 1; j <= per_producer; ++j) {
+          // mix single and bulk calls
+          if (i % 2 == 0) {
+            ASSERT_TRUE(ring.WaitEnqueue(j));
+            continue;
+          }
+          batch.push_back(j);
+          if (batch.size() == 16 || j == per_producer) {
+            auto it = batch.begin();
+            while (it != batch.end()) {
+              auto num = ring.EnqueueBulk(it, batch.end() - it);
+              if (num == 0) {
+                std::this_thread::yield();
+              }
+              it += num;
+            }
+            batch.clear();
+          }
+        }
+      });
+    }
+    const uint64_t total = producer_num * per_producer;
+    for (int i = 0; i < consumer_num; ++i) {
+      threads.emplace_back([&ring, &sum, &count, total]() {
+        uint64_t values[32];
+        while (count.load() < total) {
+          auto num = ring.WaitDequeueBulk(values, 32);
+          for (uint64_t k = 0; k < num; ++k) {
+            sum += values[k];
+          }
+          if (count.fetch_add(num) + num == total) {
+            ring.BreakAllWait();
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(total, count.load());
+    EXPECT_EQ(producer_num * per_producer * (per_producer + 1) / 2, sum.load());
+    EXPECT_TRUE(ring.Empty());
+  }
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
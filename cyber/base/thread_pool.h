@@ -82,7 +82,10 @@ auto ThreadPool::Enqueue(F&& f, Args&&... args)
   if (stop_) {
     return std::future<return_type>();
   }
-  task_queue_.Enqueue([task]() { (*task)(); });
+  // nor beyond max_task_num, the task would never run
+  if (!task_queue_.Enqueue([task]() { (*task)(); })) {
+    return std::future<return_type>();
+  }
   return res;
 };
 
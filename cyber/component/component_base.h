@@ -64,6 +64,27 @@ class ComponentBase : public std::enable_shared_from_this<ComponentBase> {
     return common::GetProtoFromFile(config_file_path_, config);
   }
 
+  static void LoadFlagFile(const std::string& path) {
+    std::string flag_file_path = path;
+    if (!common::GetFilePathWithEnv(path, "APOLLO_FLAG_PATH",
+                                    &flag_file_path)) {
+      AERROR << "flag file [" << path << "] not found!";
+    } else {
+      AINFO << "use flag file: " << flag_file_path;
+    }
+    google::SetCommandLineOption("flagfile", flag_file_path.c_str());
+  }
+
+  /**
+   * @brief Set while components are initialized concurrently: the flag files
+   * of all of them are loaded beforehand, Initialize doesn't load them again
+   * as the flags may be read by the other Init calls.
+   */
+  static std::atomic<bool>& FlagFilesPreloaded() {
+    static std::atomic<bool> preloaded = {false};
+    return preloaded;
+  }
+
  protected:
   virtual bool Init() = 0;
   virtual void Clear() { return; }
@@ -80,15 +101,8 @@ class ComponentBase : public std::enable_shared_from_this<ComponentBase> {
       }
     }
 
-    if (!config.flag_file_path().empty()) {
-      std::string flag_file_path = config.flag_file_path();
-      if (!common::GetFilePathWithEnv(config.flag_file_path(),
-                                      "APOLLO_FLAG_PATH", &flag_file_path)) {
-        AERROR << "flag file [" << config.flag_file_path() << "] not found!";
-      } else {
-        AINFO << "use flag file: " << flag_file_path;
-      }
-      google::SetCommandLineOption("flagfile", flag_file_path.c_str());
+    if (!config.flag_file_path().empty() && !FlagFilesPreloaded()) {
+      LoadFlagFile(config.flag_file_path());
     }
   }
 
@@ -103,15 +117,8 @@ class ComponentBase : public std::enable_shared_from_this<ComponentBase> {
       }
     }
 
-    if (!config.flag_file_path().empty()) {
-      std::string flag_file_path = config.flag_file_path();
-      if (!common::GetFilePathWithEnv(config.flag_file_path(),
-                                      "APOLLO_FLAG_PATH", &flag_file_path)) {
-        AERROR << "flag file [" << config.flag_file_path() << "] not found!";
-      } else {
-        AINFO << "use flag file: " << flag_file_path;
-      }
-      google::SetCommandLineOption("flagfile", flag_file_path.c_str());
+    if (!config.flag_file_path().empty() && !FlagFilesPreloaded()) {
+      LoadFlagFile(config.flag_file_path());
     }
   }
 
@@ -47,7 +47,11 @@ bool TimerComponent::Initialize(const TimerComponentConfig& config) {
   std::shared_ptr<TimerComponent> self =
       std::dynamic_pointer_cast<TimerComponent>(shared_from_this());
   auto func = [self]() { self->Process(); };
-  timer_.reset(new Timer(config.interval(), func, false));
+  // fire in a croutine named after the component, placed by the scheduler
+  // conf like the routines of the other components
+  TimerOption opt(config.interval(), func, false);
+  opt.name = config.name();
+  timer_.reset(new Timer(opt));
   timer_->Start();
   return true;
 }
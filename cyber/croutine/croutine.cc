@@ -30,6 +30,7 @@ namespace croutine {
 
 thread_local CRoutine *CRoutine::current_routine_ = nullptr;
 thread_local char *CRoutine::main_stack_ = nullptr;
+std::atomic<bool> CRoutine::trace_wakeup_ = {false};
 
 namespace {
 std::shared_ptr<base::CCObjectPool<RoutineContext>> context_pool = nullptr;
@@ -87,6 +88,8 @@ RoutineState CRoutine::Resume() {
 
 void CRoutine::Stop() { force_stop_ = true; }
 
+void CRoutine::EnableWakeupTrace(bool enable) { trace_wakeup_.store(enable); }
+
 }  // namespace croutine
 }  // namespace cyber
 }  // namespace apollo
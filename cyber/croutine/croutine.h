@@ -25,6 +25,7 @@
 #include <set>
 #include <string>
 
+#include "cyber/base/macros.h"
 #include "cyber/common/log.h"
 #include "cyber/croutine/detail/routine_context.h"
 
@@ -48,6 +49,8 @@ class CRoutine {
   static void SetMainContext(const std::shared_ptr<RoutineContext> &context);
   static CRoutine *GetCurrentRoutine();
   static char **GetMainStack();
+  // record when routines are woken up, used by scheduler tracing
+  static void EnableWakeupTrace(bool enable);
 
   // public interfaces
   bool Acquire();
@@ -88,6 +91,11 @@ class CRoutine {
 
   std::chrono::steady_clock::time_point wake_time() const;
 
+  // steady clock nanoseconds of the last wakeup that has not run yet, 0 if
+  // none. Only recorded while wakeup tracing is enabled.
+  uint64_t wakeup_time() const;
+  uint64_t TakeWakeupTime();
+
   void set_group_name(const std::string &group_name) {
     group_name_ = group_name;
   }
@@ -109,6 +117,7 @@ class CRoutine {
 
   std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
   std::atomic_flag updated_ = ATOMIC_FLAG_INIT;
+  std::atomic<uint64_t> wakeup_time_ = {0};
 
   bool force_stop_ = false;
 
@@ -120,6 +129,7 @@ class CRoutine {
 
   static thread_local CRoutine *current_routine_;
   static thread_local char *main_stack_;
+  static std::atomic<bool> trace_wakeup_;
 };
 
 inline void CRoutine::Yield(const RoutineState &state) {
@@ -150,6 +160,17 @@ inline std::chrono::steady_clock::time_point CRoutine::wake_time() const {
   return wake_time_;
 }
 
+inline uint64_t CRoutine::wakeup_time() const {
+  return wakeup_time_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t CRoutine::TakeWakeupTime() {
+  if (cyber_likely(!trace_wakeup_.load(std::memory_order_relaxed))) {
+    return 0;
+  }
+  return wakeup_time_.exchange(0, std::memory_order_relaxed);
+}
+
 inline void CRoutine::Wake() { state_ = RoutineState::READY; }
 
 inline void CRoutine::HangUp() { CRoutine::Yield(RoutineState::DATA_WAIT); }
@@ -178,6 +199,12 @@ inline RoutineState CRoutine::UpdateState() {
   if (state_ == RoutineState::SLEEP &&
       std::chrono::steady_clock::now() > wake_time_) {
     state_ = RoutineState::READY;
+    if (cyber_unlikely(trace_wakeup_.load(std::memory_order_relaxed))) {
+      wakeup_time_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             wake_time_.time_since_epoch())
+                             .count(),
+                         std::memory_order_relaxed);
+    }
     return state_;
   }
 
@@ -203,6 +230,16 @@ inline void CRoutine::Release() {
 }
 
 inline void CRoutine::SetUpdateFlag() {
+  if (cyber_unlikely(trace_wakeup_.load(std::memory_order_relaxed))) {
+    // keep the first of several notifications
+    uint64_t expected = 0;
+    wakeup_time_.compare_exchange_strong(
+        expected,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count(),
+        std::memory_order_relaxed);
+  }
   updated_.clear(std::memory_order_release);
 }
 
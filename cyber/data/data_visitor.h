@@ -27,7 +27,9 @@
 #include "cyber/data/data_dispatcher.h"
 #include "cyber/data/data_visitor_base.h"
 #include "cyber/data/fusion/all_latest.h"
+#include "cyber/data/fusion/approximate_time.h"
 #include "cyber/data/fusion/data_fusion.h"
+#include "cyber/proto/component_conf.pb.h"
 
 namespace apollo {
 namespace cyber {
@@ -47,7 +49,9 @@ template <typename M0, typename M1 = NullType, typename M2 = NullType,
           typename M3 = NullType>
 class DataVisitor : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(
+      const std::vector<VisitorConfig>& configs,
+      const proto::FusionConfig& fusion_config = proto::FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -61,8 +65,17 @@ class DataVisitor : public DataVisitorBase {
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
     DataDispatcher<M3>::Instance()->AddBuffer(buffer_m3_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
-        buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    if (fusion_config.policy() == proto::FusionConfig::APPROXIMATE_TIME) {
+      // a set may be completed by any of the readers
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m2_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m3_.channel_id(), notifier_);
+      data_fusion_ = new fusion::ApproximateTime<M0, M1, M2, M3>(
+          fusion_config, buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    } else {
+      data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
+          buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    }
   }
 
   ~DataVisitor() {
@@ -81,6 +94,10 @@ class DataVisitor : public DataVisitorBase {
     return false;
   }
 
+  bool GetFusionStats(fusion::FusionStats* stats) {
+    return data_fusion_->GetStats(stats);
+  }
+
  private:
   fusion::DataFusion<M0, M1, M2, M3>* data_fusion_ = nullptr;
   ChannelBuffer<M0> buffer_m0_;
@@ -92,7 +109,9 @@ class DataVisitor : public DataVisitorBase {
 template <typename M0, typename M1, typename M2>
 class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(
+      const std::vector<VisitorConfig>& configs,
+      const proto::FusionConfig& fusion_config = proto::FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -103,8 +122,15 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ =
-        new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_, buffer_m2_);
+    if (fusion_config.policy() == proto::FusionConfig::APPROXIMATE_TIME) {
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m2_.channel_id(), notifier_);
+      data_fusion_ = new fusion::ApproximateTime<M0, M1, M2>(
+          fusion_config, buffer_m0_, buffer_m1_, buffer_m2_);
+    } else {
+      data_fusion_ = new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_,
+                                                       buffer_m2_);
+    }
   }
 
   ~DataVisitor() {
@@ -123,6 +149,10 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
     return false;
   }
 
+  bool GetFusionStats(fusion::FusionStats* stats) {
+    return data_fusion_->GetStats(stats);
+  }
+
  private:
   fusion::DataFusion<M0, M1, M2>* data_fusion_ = nullptr;
   ChannelBuffer<M0> buffer_m0_;
@@ -133,7 +163,9 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
 template <typename M0, typename M1>
 class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(
+      const std::vector<VisitorConfig>& configs,
+      const proto::FusionConfig& fusion_config = proto::FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -141,7 +173,13 @@ class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_m0_);
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
+    if (fusion_config.policy() == proto::FusionConfig::APPROXIMATE_TIME) {
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_fusion_ = new fusion::ApproximateTime<M0, M1>(
+          fusion_config, buffer_m0_, buffer_m1_);
+    } else {
+      data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
+    }
   }
 
   ~DataVisitor() {
@@ -159,6 +197,10 @@ class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
     return false;
   }
 
+  bool GetFusionStats(fusion::FusionStats* stats) {
+    return data_fusion_->GetStats(stats);
+  }
+
  private:
   fusion::DataFusion<M0, M1>* data_fusion_ = nullptr;
   ChannelBuffer<M0> buffer_m0_;
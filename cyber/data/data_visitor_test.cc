@@ -139,6 +139,33 @@ TEST(DataVisitorTest, four_channel) {
   EXPECT_FALSE(dv->TryFetch(msg0, msg1, msg2, msg3));
 }
 
+TEST(DataVisitorTest, approximate_time) {
+  proto::FusionConfig fusion_config;
+  fusion_config.set_policy(proto::FusionConfig::APPROXIMATE_TIME);
+  fusion_config.set_tolerance_ms(1000.0);
+  auto dv = std::make_shared<DataVisitor<RawMessage, RawMessage>>(
+      InitConfigs(2), fusion_config);
+
+  std::shared_ptr<RawMessage> msg0;
+  std::shared_ptr<RawMessage> msg1;
+  // any reader completes a set
+  DispatchMessage(channel1, 1);
+  EXPECT_FALSE(dv->TryFetch(msg0, msg1));
+  DispatchMessage(channel0, 1);
+  EXPECT_TRUE(dv->TryFetch(msg0, msg1));
+  EXPECT_FALSE(dv->TryFetch(msg0, msg1));
+  DispatchMessage(channel0, 1);
+  EXPECT_FALSE(dv->TryFetch(msg0, msg1));
+  DispatchMessage(channel1, 1);
+  EXPECT_TRUE(dv->TryFetch(msg0, msg1));
+
+  fusion::FusionStats stats;
+  EXPECT_TRUE(dv->GetFusionStats(&stats));
+  EXPECT_EQ(2, stats.matched);
+  EXPECT_EQ(0, stats.dropped[0]);
+  EXPECT_EQ(0, stats.dropped[1]);
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
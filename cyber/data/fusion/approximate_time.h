@@ -0,0 +1,401 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
+#define CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/common/types.h"
+#include "cyber/data/channel_buffer.h"
+#include "cyber/data/fusion/data_fusion.h"
+#include "cyber/proto/component_conf.pb.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+namespace fusion {
+
+template <typename T, typename = void>
+struct HasHeaderTimestamp : std::false_type {};
+
+template <typename T>
+struct HasHeaderTimestamp<
+    T, decltype(void(std::declval<const T&>().header().timestamp_sec()))>
+    : std::true_type {};
+
+/**
+ * @brief Time a message is aligned by, in nanoseconds: header().timestamp_sec()
+ * if the message has one, its arrival time otherwise. Specialize it for
+ * messages stamped in another field.
+ */
+template <typename T, typename Enable = void>
+struct MessageTime {
+  static uint64_t Get(const T& msg) { return Time::Now().ToNanosecond(); }
+};
+
+template <typename T>
+struct MessageTime<
+    T, typename std::enable_if<HasHeaderTimestamp<T>::value>::type> {
+  static uint64_t Get(const T& msg) {
+    return static_cast<uint64_t>(msg.header().timestamp_sec() * 1e9);
+  }
+};
+
+/**
+ * @class ApproximateTimeSync
+ * @brief Aligns one message of every channel by time. The messages of a
+ * channel are queued in a preallocated ring of queue_size entries, the oldest
+ * one is dropped when it is full. The pivot is the latest of the oldest queued
+ * messages. Queued messages older than the pivot by more than the tolerance
+ * can't be part of any later set and are dropped. Once every channel has a
+ * message within tolerance, the one closest to the pivot of every channel
+ * makes a set, which is copied into a preallocated ring of output_size sets.
+ * Messages of a channel are expected to arrive in time order.
+ */
+template <typename... Ms>
+class ApproximateTimeSync {
+ public:
+  using FusionDataType = std::tuple<std::shared_ptr<Ms>...>;
+  static constexpr size_t kChannelNum = sizeof...(Ms);
+
+  ApproximateTimeSync(uint64_t channel_id, uint64_t tolerance_ns,
+                      uint32_t queue_size, uint64_t output_size)
+      : channel_id_(channel_id),
+        tolerance_(tolerance_ns),
+        output_(std::max<uint64_t>(output_size, 1)) {
+    queue_size = std::max<uint32_t>(queue_size, 1);
+    for (auto& ring : rings_) {
+      ring.stamps.resize(queue_size);
+    }
+    ResizeQueues(queue_size, std::index_sequence_for<Ms...>());
+  }
+
+  template <size_t I>
+  void Add(const std::shared_ptr<
+           typename std::tuple_element<I, std::tuple<Ms...>>::type>& msg) {
+    using MessageT = typename std::tuple_element<I, std::tuple<Ms...>>::type;
+    uint64_t stamp = MessageTime<MessageT>::Get(*msg);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& ring = rings_[I];
+    ++stats_.received[I];
+    if (ring.size == ring.stamps.size()) {
+      ring.Pop(1);
+      ++stats_.dropped[I];
+    }
+    // popped slots keep their message until they are reused
+    auto slot = ring.Slot(ring.size++);
+    ring.stamps[slot] = stamp;
+    std::get<I>(queues_)[slot] = msg;
+    Match();
+  }
+
+  bool Fetch(uint64_t* index, FusionDataType* data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (output_.Empty()) {
+      return false;
+    }
+
+    if (*index == 0) {
+      *index = output_.Tail();
+    } else if (*index == output_.Tail() + 1) {
+      return false;
+    } else if (*index < output_.Head()) {
+      auto interval = output_.Tail() - *index;
+      AWARN << "channel[" << GlobalData::GetChannelById(channel_id_) << "] "
+            << "fusion buffer overflow, drop_message[" << interval
+            << "] pre_index[" << *index << "] current_index["
+            << output_.Tail() << "] ";
+      *index = output_.Tail();
+    }
+    *data = output_.at(*index);
+    return true;
+  }
+
+  FusionStats Stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+ private:
+  struct Ring {
+    std::vector<uint64_t> stamps;
+    size_t head = 0;
+    size_t size = 0;
+
+    size_t Slot(size_t pos) const { return (head + pos) % stamps.size(); }
+    uint64_t Stamp(size_t pos) const { return stamps[Slot(pos)]; }
+    void Pop(size_t num) {
+      head = (head + num) % stamps.size();
+      size -= num;
+    }
+  };
+
+  static uint64_t Distance(uint64_t a, uint64_t b) {
+    return a > b ? a - b : b - a;
+  }
+
+  template <size_t... Is>
+  void ResizeQueues(size_t size, std::index_sequence<Is...>) {
+    int expand[] = {0, (std::get<Is>(queues_).resize(size), 0)...};
+    (void)expand;
+  }
+
+  template <size_t... Is>
+  void Emit(const std::array<size_t, kChannelNum>& picks,
+            std::index_sequence<Is...>) {
+    output_.Fill(FusionDataType(
+        std::get<Is>(queues_)[rings_[Is].Slot(picks[Is])]...));
+  }
+
+  void Match() {
+    std::array<size_t, kChannelNum> picks;
+    while (true) {
+      uint64_t pivot = 0;
+      for (auto& ring : rings_) {
+        if (ring.size == 0) {
+          return;
+        }
+        pivot = std::max(pivot, ring.Stamp(0));
+      }
+
+      bool dropped = false;
+      for (size_t i = 0; i < kChannelNum; ++i) {
+        auto& ring = rings_[i];
+        while (ring.size > 0 && ring.Stamp(0) + tolerance_ < pivot) {
+          ring.Pop(1);
+          ++stats_.dropped[i];
+          dropped = true;
+        }
+      }
+      // the pivot may have moved
+      if (dropped) {
+        continue;
+      }
+
+      // every oldest message is within tolerance, take the closest ones
+      for (size_t i = 0; i < kChannelNum; ++i) {
+        auto& ring = rings_[i];
+        size_t best = 0;
+        while (best + 1 < ring.size &&
+               Distance(ring.Stamp(best + 1), pivot) <=
+                   Distance(ring.Stamp(best), pivot)) {
+          ++best;
+        }
+        picks[i] = best;
+      }
+      Emit(picks, std::index_sequence_for<Ms...>());
+      ++stats_.matched;
+      for (size_t i = 0; i < kChannelNum; ++i) {
+        rings_[i].Pop(picks[i] + 1);
+        stats_.dropped[i] += picks[i];
+      }
+    }
+  }
+
+  uint64_t channel_id_;
+  uint64_t tolerance_;
+  std::mutex mutex_;
+  std::array<Ring, kChannelNum> rings_;
+  std::tuple<std::vector<std::shared_ptr<Ms>>...> queues_;
+  CacheBuffer<FusionDataType> output_;
+  FusionStats stats_;
+};
+
+template <typename M>
+void ResetFusionCallback(const ChannelBuffer<M>& buffer) {
+  std::lock_guard<std::mutex> lock(buffer.Buffer()->Mutex());
+  buffer.Buffer()->SetFusionCallback(nullptr);
+}
+
+inline uint64_t ToleranceNs(const proto::FusionConfig& config) {
+  return static_cast<uint64_t>(std::max(config.tolerance_ms(), 0.0) * 1e6);
+}
+
+template <typename M0, typename M1 = NullType, typename M2 = NullType,
+          typename M3 = NullType>
+class ApproximateTime : public DataFusion<M0, M1, M2, M3> {
+  using Sync = ApproximateTimeSync<M0, M1, M2, M3>;
+
+ public:
+  ApproximateTime(const proto::FusionConfig& config,
+                  const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<M1>& buffer_1,
+                  const ChannelBuffer<M2>& buffer_2,
+                  const ChannelBuffer<M3>& buffer_3)
+      : buffer_m0_(buffer_0),
+        buffer_m1_(buffer_1),
+        buffer_m2_(buffer_2),
+        buffer_m3_(buffer_3),
+        sync_(buffer_0.channel_id(), ToleranceNs(config), config.queue_size(),
+              buffer_0.Buffer()->Capacity() - uint64_t(1)) {
+    buffer_m0_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M0>& m0) { sync_.template Add<0>(m0); });
+    buffer_m1_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M1>& m1) { sync_.template Add<1>(m1); });
+    buffer_m2_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M2>& m2) { sync_.template Add<2>(m2); });
+    buffer_m3_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M3>& m3) { sync_.template Add<3>(m3); });
+  }
+
+  ~ApproximateTime() {
+    ResetFusionCallback(buffer_m0_);
+    ResetFusionCallback(buffer_m1_);
+    ResetFusionCallback(buffer_m2_);
+    ResetFusionCallback(buffer_m3_);
+  }
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,
+              std::shared_ptr<M2>& m2, std::shared_ptr<M3>& m3) override {
+    typename Sync::FusionDataType fusion_data;
+    if (!sync_.Fetch(index, &fusion_data)) {
+      return false;
+    }
+    m0 = std::get<0>(fusion_data);
+    m1 = std::get<1>(fusion_data);
+    m2 = std::get<2>(fusion_data);
+    m3 = std::get<3>(fusion_data);
+    return true;
+  }
+
+  bool GetStats(FusionStats* stats) override {
+    *stats = sync_.Stats();
+    return true;
+  }
+
+ private:
+  ChannelBuffer<M0> buffer_m0_;
+  ChannelBuffer<M1> buffer_m1_;
+  ChannelBuffer<M2> buffer_m2_;
+  ChannelBuffer<M3> buffer_m3_;
+  Sync sync_;
+};
+
+template <typename M0, typename M1, typename M2>
+class ApproximateTime<M0, M1, M2, NullType> : public DataFusion<M0, M1, M2> {
+  using Sync = ApproximateTimeSync<M0, M1, M2>;
+
+ public:
+  ApproximateTime(const proto::FusionConfig& config,
+                  const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<M1>& buffer_1,
+                  const ChannelBuffer<M2>& buffer_2)
+      : buffer_m0_(buffer_0),
+        buffer_m1_(buffer_1),
+        buffer_m2_(buffer_2),
+        sync_(buffer_0.channel_id(), ToleranceNs(config), config.queue_size(),
+              buffer_0.Buffer()->Capacity() - uint64_t(1)) {
+    buffer_m0_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M0>& m0) { sync_.template Add<0>(m0); });
+    buffer_m1_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M1>& m1) { sync_.template Add<1>(m1); });
+    buffer_m2_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M2>& m2) { sync_.template Add<2>(m2); });
+  }
+
+  ~ApproximateTime() {
+    ResetFusionCallback(buffer_m0_);
+    ResetFusionCallback(buffer_m1_);
+    ResetFusionCallback(buffer_m2_);
+  }
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,
+              std::shared_ptr<M2>& m2) override {
+    typename Sync::FusionDataType fusion_data;
+    if (!sync_.Fetch(index, &fusion_data)) {
+      return false;
+    }
+    m0 = std::get<0>(fusion_data);
+    m1 = std::get<1>(fusion_data);
+    m2 = std::get<2>(fusion_data);
+    return true;
+  }
+
+  bool GetStats(FusionStats* stats) override {
+    *stats = sync_.Stats();
+    return true;
+  }
+
+ private:
+  ChannelBuffer<M0> buffer_m0_;
+  ChannelBuffer<M1> buffer_m1_;
+  ChannelBuffer<M2> buffer_m2_;
+  Sync sync_;
+};
+
+template <typename M0, typename M1>
+class ApproximateTime<M0, M1, NullType, NullType> : public DataFusion<M0, M1> {
+  using Sync = ApproximateTimeSync<M0, M1>;
+
+ public:
+  ApproximateTime(const proto::FusionConfig& config,
+                  const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<M1>& buffer_1)
+      : buffer_m0_(buffer_0),
+        buffer_m1_(buffer_1),
+        sync_(buffer_0.channel_id(), ToleranceNs(config), config.queue_size(),
+              buffer_0.Buffer()->Capacity() - uint64_t(1)) {
+    buffer_m0_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M0>& m0) { sync_.template Add<0>(m0); });
+    buffer_m1_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M1>& m1) { sync_.template Add<1>(m1); });
+  }
+
+  ~ApproximateTime() {
+    ResetFusionCallback(buffer_m0_);
+    ResetFusionCallback(buffer_m1_);
+  }
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0,
+              std::shared_ptr<M1>& m1) override {
+    typename Sync::FusionDataType fusion_data;
+    if (!sync_.Fetch(index, &fusion_data)) {
+      return false;
+    }
+    m0 = std::get<0>(fusion_data);
+    m1 = std::get<1>(fusion_data);
+    return true;
+  }
+
+  bool GetStats(FusionStats* stats) override {
+    *stats = sync_.Stats();
+    return true;
+  }
+
+ private:
+  ChannelBuffer<M0> buffer_m0_;
+  ChannelBuffer<M1> buffer_m1_;
+  Sync sync_;
+};
+
+}  // namespace fusion
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
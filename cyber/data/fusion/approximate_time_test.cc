@@ -0,0 +1,203 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/data/fusion/approximate_time.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+class StampedMessage {
+ public:
+  class Header {
+   public:
+    double timestamp_sec() const { return timestamp_sec_; }
+
+   private:
+    friend class StampedMessage;
+    double timestamp_sec_ = 0.0;
+  };
+
+  explicit StampedMessage(double timestamp_sec) {
+    header_.timestamp_sec_ = timestamp_sec;
+  }
+  const Header& header() const { return header_; }
+
+ private:
+  Header header_;
+};
+
+using Buffer = CacheBuffer<std::shared_ptr<StampedMessage>>;
+
+void Fill(Buffer* buffer, double timestamp_sec) {
+  std::lock_guard<std::mutex> lock(buffer->Mutex());
+  buffer->Fill(std::make_shared<StampedMessage>(timestamp_sec));
+}
+
+proto::FusionConfig ApproximateTimeConfig(double tolerance_ms,
+                                          uint32_t queue_size) {
+  proto::FusionConfig config;
+  config.set_policy(proto::FusionConfig::APPROXIMATE_TIME);
+  config.set_tolerance_ms(tolerance_ms);
+  config.set_queue_size(queue_size);
+  return config;
+}
+
+TEST(ApproximateTimeTest, two_channels) {
+  auto cache0 = new Buffer(10);
+  auto cache1 = new Buffer(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  uint64_t index = 0;
+  fusion::ApproximateTime<StampedMessage, StampedMessage> fusion(
+      ApproximateTimeConfig(10.0, 5), buffer0, buffer1);
+
+  // waits for the other channel
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  Fill(cache0, 1.0);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  Fill(cache1, 1.005);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_DOUBLE_EQ(1.0, m0->header().timestamp_sec());
+  EXPECT_DOUBLE_EQ(1.005, m1->header().timestamp_sec());
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  // 2.0 is too old for the pivot 2.095
+  Fill(cache0, 2.0);
+  Fill(cache0, 2.1);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  Fill(cache1, 2.095);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_DOUBLE_EQ(2.1, m0->header().timestamp_sec());
+  EXPECT_DOUBLE_EQ(2.095, m1->header().timestamp_sec());
+
+  // the closest message to the pivot is taken, older ones are dropped
+  Fill(cache1, 2.992);
+  Fill(cache1, 2.998);
+  Fill(cache1, 3.02);
+  Fill(cache0, 3.0);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_DOUBLE_EQ(3.0, m0->header().timestamp_sec());
+  EXPECT_DOUBLE_EQ(2.998, m1->header().timestamp_sec());
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  fusion::FusionStats stats;
+  EXPECT_TRUE(fusion.GetStats(&stats));
+  EXPECT_EQ(3, stats.matched);
+  EXPECT_EQ(4, stats.received[0]);
+  EXPECT_EQ(5, stats.received[1]);
+  EXPECT_EQ(1, stats.dropped[0]);
+  EXPECT_EQ(1, stats.dropped[1]);
+
+  // 3.02 is dropped by the pivot 4.0, the queue keeps the last 5 messages
+  for (int i = 0; i < 8; ++i) {
+    Fill(cache0, 4.0 + i * 0.1);
+  }
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  Fill(cache1, 4.705);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  EXPECT_DOUBLE_EQ(4.7, m0->header().timestamp_sec());
+  EXPECT_TRUE(fusion.GetStats(&stats));
+  EXPECT_EQ(4, stats.matched);
+  EXPECT_EQ(1 + 3 + 4, stats.dropped[0]);
+  EXPECT_EQ(2, stats.dropped[1]);
+}
+
+TEST(ApproximateTimeTest, three_channels) {
+  auto cache0 = new Buffer(10);
+  auto cache1 = new Buffer(10);
+  auto cache2 = new Buffer(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  ChannelBuffer<StampedMessage> buffer2(2, cache2);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  std::shared_ptr<StampedMessage> m2;
+  uint64_t index = 0;
+  fusion::ApproximateTime<StampedMessage, StampedMessage, StampedMessage>
+      fusion(ApproximateTimeConfig(20.0, 10), buffer0, buffer1, buffer2);
+
+  Fill(cache0, 1.0);
+  Fill(cache1, 1.01);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+  Fill(cache2, 0.995);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+  index++;
+  EXPECT_DOUBLE_EQ(1.0, m0->header().timestamp_sec());
+  EXPECT_DOUBLE_EQ(1.01, m1->header().timestamp_sec());
+  EXPECT_DOUBLE_EQ(0.995, m2->header().timestamp_sec());
+
+  // every set is handed out once, in order
+  for (int i = 1; i <= 3; ++i) {
+    Fill(cache2, 1.0 + i * 0.1);
+    Fill(cache1, 1.0 + i * 0.1);
+    Fill(cache0, 1.0 + i * 0.1);
+  }
+  for (int i = 1; i <= 3; ++i) {
+    EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+    index++;
+    EXPECT_DOUBLE_EQ(1.0 + i * 0.1, m0->header().timestamp_sec());
+  }
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+}
+
+TEST(ApproximateTimeTest, four_channels) {
+  auto cache0 = new Buffer(10);
+  auto cache1 = new Buffer(10);
+  auto cache2 = new Buffer(10);
+  auto cache3 = new Buffer(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  ChannelBuffer<StampedMessage> buffer2(2, cache2);
+  ChannelBuffer<StampedMessage> buffer3(3, cache3);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  std::shared_ptr<StampedMessage> m2;
+  std::shared_ptr<StampedMessage> m3;
+  uint64_t index = 0;
+  {
+    fusion::ApproximateTime<StampedMessage, StampedMessage, StampedMessage,
+                            StampedMessage>
+        fusion(ApproximateTimeConfig(20.0, 10), buffer0, buffer1, buffer2,
+               buffer3);
+
+    Fill(cache0, 1.0);
+    Fill(cache1, 1.0);
+    Fill(cache2, 1.0);
+    EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2, m3));
+    Fill(cache3, 1.0);
+    EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2, m3));
+    EXPECT_DOUBLE_EQ(1.0, m3->header().timestamp_sec());
+  }
+
+  // the buffers are filled again once the fusion is gone
+  Fill(cache3, 2.0);
+  EXPECT_EQ(1, cache3->Size());
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
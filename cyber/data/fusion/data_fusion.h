@@ -17,6 +17,7 @@
 #ifndef CYBER_DATA_FUSION_DATA_FUSION_H_
 #define CYBER_DATA_FUSION_DATA_FUSION_H_
 
+#include <array>
 #include <deque>
 #include <memory>
 #include <string>
@@ -31,11 +32,25 @@ namespace cyber {
 namespace data {
 namespace fusion {
 
+/**
+ * @brief Counters of a fusion policy, indexed by reader
+ */
+struct FusionStats {
+  // sets handed to the component
+  uint64_t matched = 0;
+  std::array<uint64_t, 4> received{};
+  // received but never part of a set
+  std::array<uint64_t, 4> dropped{};
+};
+
 template <typename M0, typename M1 = NullType, typename M2 = NullType,
           typename M3 = NullType>
 class DataFusion {
  public:
   virtual ~DataFusion() {}
+
+  virtual bool GetStats(FusionStats* stats) { return false; }
+
   virtual bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0,  // NOLINT
                       std::shared_ptr<M1>& m1,                   // NOLINT
                       std::shared_ptr<M2>& m2,                   // NOLINT
@@ -47,6 +62,8 @@ class DataFusion<M0, M1, M2, NullType> {
  public:
   virtual ~DataFusion() {}
 
+  virtual bool GetStats(FusionStats* stats) { return false; }
+
   virtual bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0,  // NOLINT
                       std::shared_ptr<M1>& m1,                   // NOLINT
                       std::shared_ptr<M2>& m2) = 0;              // NOLINT
@@ -57,6 +74,8 @@ class DataFusion<M0, M1, NullType, NullType> {
  public:
   virtual ~DataFusion() {}
 
+  virtual bool GetStats(FusionStats* stats) { return false; }
+
   virtual bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0,  // NOLINT
                       std::shared_ptr<M1>& m1) = 0;              // NOLINT
 };
@@ -27,13 +27,17 @@
 #include <string>
 
 #include "cyber/proto/clock.pb.h"
+#include "cyber/proto/sched_stats.pb.h"
 
 #include "cyber/binary.h"
 #include "cyber/common/file.h"
 #include "cyber/common/global_data.h"
 #include "cyber/data/data_dispatcher.h"
 #include "cyber/logger/async_logger.h"
+#include "cyber/logger/binary_logger.h"
 #include "cyber/node/node.h"
+#include "cyber/record/record_writer.h"
+#include "cyber/scheduler/common/sched_tracer.h"
 #include "cyber/scheduler/scheduler.h"
 #include "cyber/service_discovery/topology_manager.h"
 #include "cyber/sysmo/sysmo.h"
@@ -45,6 +49,7 @@
 namespace apollo {
 namespace cyber {
 
+using apollo::cyber::scheduler::SchedTracer;
 using apollo::cyber::scheduler::Scheduler;
 using apollo::cyber::service_discovery::TopologyManager;
 
@@ -52,10 +57,12 @@ namespace {
 
 const std::string& kClockChannel = "/clock";
 const std::string& kClockNode = "clock";
+const std::string& kSchedStatsNode = "sched_stats";
 
 bool g_atexit_registered = false;
 std::mutex g_mutex;
 std::unique_ptr<Node> clock_node;
+std::unique_ptr<Node> sched_stats_node;
 
 logger::AsyncLogger* async_logger = nullptr;
 
@@ -78,9 +85,65 @@ void InitLogger(const char* binary_name) {
       google::base::GetLogger(FLAGS_minloglevel));
   google::base::SetLogger(FLAGS_minloglevel, async_logger);
   async_logger->Start();
+
+  // the deferred AINFO_FMT family, formatted into the async logger in TEXT
+  // mode
+  auto& global_conf = GlobalData::Instance()->Config();
+  if (global_conf.has_perf_conf() &&
+      global_conf.perf_conf().binary_log().enable()) {
+    auto binary_logger = logger::BinaryLogger::Instance();
+    if (binary_logger->Start(global_conf.perf_conf().binary_log())) {
+      scheduler::Instance()->SetInnerThreadAttr(
+          "binary_log", binary_logger->WriterThread());
+    }
+  }
+}
+
+void StopLogger() {
+  logger::BinaryLogger::CleanUp();
+  delete async_logger;
 }
 
-void StopLogger() { delete async_logger; }
+// publishes the scheduler statistics and appends them to a record file that
+// can be played back and inspected with cyber_monitor
+void InitSchedStatsExporter() {
+  auto tracer = SchedTracer::Instance();
+  if (!tracer->Enabled()) {
+    return;
+  }
+
+  auto& conf = tracer->conf();
+  auto node_name = kSchedStatsNode + "_" + std::to_string(getpid());
+  sched_stats_node = std::unique_ptr<Node>(new Node(node_name));
+  auto writer =
+      sched_stats_node->CreateWriter<proto::SchedStats>(conf.channel());
+  if (writer == nullptr) {
+    AERROR << "Failed to create writer for " << conf.channel();
+  }
+
+  std::shared_ptr<record::RecordWriter> record_writer = nullptr;
+  if (!conf.record_file().empty()) {
+    record_writer = std::make_shared<record::RecordWriter>();
+    if (!record_writer->Open(conf.record_file())) {
+      AERROR << "Failed to open sched stats record " << conf.record_file();
+      record_writer = nullptr;
+    }
+  }
+
+  std::string channel = conf.channel();
+  std::string proto_desc;
+  message::GetDescriptorString(proto::SchedStats(), &proto_desc);
+  tracer->SetExporter([writer, record_writer, channel,
+                       proto_desc](const proto::SchedStats& stats) {
+    if (writer != nullptr) {
+      writer->Write(stats);
+    }
+    if (record_writer != nullptr) {
+      record_writer->WriteMessage(channel, stats, stats.timestamp(),
+                                  proto_desc);
+    }
+  });
+}
 
 }  // namespace
 
@@ -127,6 +190,7 @@ bool Init(const char* binary_name) {
         };
     clock_node->CreateReader<apollo::cyber::proto::Clock>(kClockChannel, cb);
   }
+  InitSchedStatsExporter();
   return true;
 }
 
@@ -136,6 +200,8 @@ void Clear() {
     return;
   }
   SysMo::CleanUp();
+  SchedTracer::CleanUp();
+  sched_stats_node.reset();
   TaskManager::CleanUp();
   TimingWheel::CleanUp();
   scheduler::CleanUp();
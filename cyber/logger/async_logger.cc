@@ -16,10 +16,17 @@
 
 #include "cyber/logger/async_logger.h"
 
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
 #include <cstdlib>
+#include <ctime>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/base/macros.h"
 #include "cyber/logger/logger_util.h"
@@ -31,9 +38,11 @@ namespace logger {
 static const std::unordered_map<char, int> log_level_map = {
     {'F', 3}, {'E', 2}, {'W', 1}, {'I', 0}};
 
+// set on the logger thread, which must not wait for room in its own queue
+static thread_local bool is_log_thread = false;
+
 AsyncLogger::AsyncLogger(google::base::Logger* wrapped) : wrapped_(wrapped) {
-  active_buf_.reset(new std::deque<Msg>());
-  flushing_buf_.reset(new std::deque<Msg>());
+  ACHECK(msg_queue_.Init(kQueueSize, base::RingWaitMode::BLOCK));
 }
 
 AsyncLogger::~AsyncLogger() { Stop(); }
@@ -47,13 +56,16 @@ void AsyncLogger::Start() {
 
 void AsyncLogger::Stop() {
   state_.store(STOPPED, std::memory_order_release);
+  msg_queue_.BreakAllWait();
   if (log_thread_.joinable()) {
     log_thread_.join();
   }
 
-  FlushBuffer(active_buf_);
-  ACHECK(active_buf_->empty());
-  ACHECK(flushing_buf_->empty());
+  std::vector<Msg> buffer(kBatchSize);
+  uint64_t num = 0;
+  while ((num = msg_queue_.DequeueBulk(buffer.data(), kBatchSize)) > 0) {
+    FlushBuffer(&buffer, num);
+  }
   // std::cout << "Async Logger Stop!" << std::endl;
 }
 
@@ -64,13 +76,16 @@ void AsyncLogger::Write(bool force_flush, time_t timestamp, const char* message,
     return;
   }
   if (message_len > 0) {
-    auto msg_str = std::string(message, message_len);
-    while (flag_.test_and_set(std::memory_order_acquire)) {
-      cpu_relax();
+    Msg msg(timestamp, std::string(message, message_len),
+            log_level_map.at(message[0]));
+    // never block the caller on the disk for the routine messages, the drops
+    // are reported by the logger thread. Errors wait for room instead.
+    bool enqueued = msg.level < google::ERROR || is_log_thread
+                        ? msg_queue_.Enqueue(std::move(msg))
+                        : msg_queue_.WaitEnqueue(std::move(msg));
+    if (!enqueued) {
+      drop_count_.fetch_add(1, std::memory_order_relaxed);
     }
-    active_buf_->emplace_back(timestamp, std::move(msg_str),
-                              log_level_map.at(message[0]));
-    flag_.clear(std::memory_order_release);
   }
 
   if (force_flush && timestamp == 0 && message && message_len == 0) {
@@ -87,41 +102,74 @@ void AsyncLogger::Flush() {
 uint32_t AsyncLogger::LogSize() { return wrapped_->LogSize(); }
 
 void AsyncLogger::RunThread() {
+  is_log_thread = true;
+  std::vector<Msg> buffer(kBatchSize);
   while (state_ == RUNNING) {
-    while (flag_.test_and_set(std::memory_order_acquire)) {
-      cpu_relax();
-    }
-    active_buf_.swap(flushing_buf_);
-    flag_.clear(std::memory_order_release);
-    FlushBuffer(flushing_buf_);
-    if (active_buf_->size() < 800) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    auto num = msg_queue_.WaitDequeueBulk(buffer.data(), kBatchSize);
+    if (num > 0) {
+      FlushBuffer(&buffer, num);
     }
   }
 }
 
-void AsyncLogger::FlushBuffer(const std::unique_ptr<std::deque<Msg>>& buffer) {
+void AsyncLogger::FlushBuffer(std::vector<Msg>* buffer, uint64_t num) {
+  for (uint64_t i = 0; i < num; ++i) {
+    auto& msg = (*buffer)[i];
+    WriteMsg(&msg);
+  }
+  ReportDrops();
+  // under load the next batch is already waiting
+  if (msg_queue_.Empty()) {
+    Flush();
+  }
+  flush_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AsyncLogger::WriteMsg(Msg* msg) {
   std::string module_name = "";
-  while (!buffer->empty()) {
-    auto& msg = buffer->front();
-    FindModuleName(&(msg.message), &module_name);
-
-    if (module_logger_map_.find(module_name) == module_logger_map_.end()) {
-      std::string file_name = module_name + ".log.INFO.";
-      if (!FLAGS_log_dir.empty()) {
-        file_name = FLAGS_log_dir + "/" + file_name;
-      }
-      module_logger_map_[module_name].reset(
-          new LogFileObject(google::INFO, file_name.c_str()));
-      module_logger_map_[module_name]->SetSymlinkBasename(module_name.c_str());
+  FindModuleName(&(msg->message), &module_name);
+
+  if (module_logger_map_.find(module_name) == module_logger_map_.end()) {
+    std::string file_name = module_name + ".log.INFO.";
+    if (!FLAGS_log_dir.empty()) {
+      file_name = FLAGS_log_dir + "/" + file_name;
     }
-    const bool force_flush = msg.level > 0;
-    module_logger_map_.find(module_name)
-        ->second->Write(force_flush, msg.ts, msg.message.data(),
-                        static_cast<int>(msg.message.size()));
-    buffer->pop_front();
+    module_logger_map_[module_name].reset(
+        new LogFileObject(google::INFO, file_name.c_str()));
+    module_logger_map_[module_name]->SetSymlinkBasename(module_name.c_str());
+  }
+  const bool force_flush = msg->level > 0;
+  module_logger_map_.find(module_name)
+      ->second->Write(force_flush, msg->ts, msg->message.data(),
+                      static_cast<int>(msg->message.size()));
+  msg->message.clear();
+}
+
+void AsyncLogger::ReportDrops() {
+  uint64_t drop_count = drop_count_.load(std::memory_order_relaxed);
+  if (drop_count == reported_drop_count_) {
+    return;
   }
-  Flush();
+  uint64_t dropped = drop_count - reported_drop_count_;
+  reported_drop_count_ = drop_count;
+
+  // a warning of the process group, formatted as glog does
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  struct tm tm_time;
+  localtime_r(&tv.tv_sec, &tm_time);
+  char buf[160];
+  int length = snprintf(buf, sizeof(buf),
+                        "W%02d%02d %02d:%02d:%02d.%06d %5d async_logger.cc:%d] "
+                        "Log queue full, dropped %" PRIu64 " log messages\n",
+                        1 + tm_time.tm_mon, tm_time.tm_mday, tm_time.tm_hour,
+                        tm_time.tm_min, tm_time.tm_sec,
+                        static_cast<int>(tv.tv_usec), GetThreadId(), __LINE__,
+                        dropped);
+  Msg msg(tv.tv_sec,
+          std::string(buf, std::min<size_t>(length, sizeof(buf) - 1)),
+          google::WARNING);
+  WriteMsg(&msg);
 }
 
 }  // namespace logger
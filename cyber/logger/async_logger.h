@@ -21,7 +21,6 @@
 #include <condition_variable>
 #include <cstdint>
 #include <ctime>
-#include <deque>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -33,6 +32,7 @@
 
 #include "glog/logging.h"
 
+#include "cyber/base/mpmc_ring.h"
 #include "cyber/common/macros.h"
 #include "cyber/logger/log_file_object.h"
 
@@ -45,12 +45,11 @@ namespace logger {
  * @brief .
  * Wrapper for a glog Logger which asynchronously writes log messages.
  * This class starts a new thread responsible for forwarding the messages
- * to the logger, and performs double buffering. Writers append to the
- * current buffer and then wake up the logger thread. The logger swaps in
- * a new buffer and writes any accumulated messages to the wrapped
- * Logger.
+ * to the logger. Writers move their messages into a bounded MPMC ring and
+ * the logger thread, woken up only when it sleeps, drains the ring in
+ * batches and writes them to the per module log files.
  *
- * This double-buffering design dramatically improves performance, especially
+ * This buffering design dramatically improves performance, especially
  * for logging messages which require flushing the underlying file (i.e WARNING
  * and above for default). The flush can take a couple of milliseconds, and in
  * some cases can even block for hundreds of milliseconds or more. With the
@@ -67,8 +66,10 @@ namespace logger {
  * messages before exiting.
  *
  * @warning The logger limits the total amount of buffer space, so if the
- * underlying log blocks for too long, eventually the threads generating the log
- * messages will block as well. This prevents runaway memory usage.
+ * underlying log blocks for too long, the messages below ERROR that do not fit
+ * are dropped rather than blocking the threads generating them. The number of
+ * dropped messages is logged as a warning with the next batch written. ERROR
+ * and FATAL messages are never dropped, their writers wait for room.
  */
 class AsyncLogger : public google::base::Logger {
  public:
@@ -126,6 +127,8 @@ class AsyncLogger : public google::base::Logger {
   std::thread* LogThread() { return &log_thread_; }
 
  private:
+  friend class AsyncLoggerQueueTest;
+
   // A buffered message.
   //
   // TODO(todd): using std::string for buffered messages is convenient but not
@@ -163,8 +166,13 @@ class AsyncLogger : public google::base::Logger {
     }
   };
 
+  static constexpr uint64_t kQueueSize = 8192;
+  static constexpr uint64_t kBatchSize = 256;
+
   void RunThread();
-  void FlushBuffer(const std::unique_ptr<std::deque<Msg>>& msg);
+  void FlushBuffer(std::vector<Msg>* buffer, uint64_t num);
+  void WriteMsg(Msg* msg);
+  void ReportDrops();
 
   google::base::Logger* const wrapped_;
   std::thread log_thread_;
@@ -173,21 +181,18 @@ class AsyncLogger : public google::base::Logger {
   // 64 bits should be enough to never worry about overflow.
   std::atomic<uint64_t> flush_count_ = {0};
 
-  // Count of how many times the writer thread has dropped the log messages.
-  // 64 bits should be enough to never worry about overflow.
-  uint64_t drop_count_ = 0;
-
-  // The buffer to which application threads append new log messages.
-  std::unique_ptr<std::deque<Msg>> active_buf_;
+  // Count of how many log messages have been dropped because the queue was
+  // full. 64 bits should be enough to never worry about overflow.
+  std::atomic<uint64_t> drop_count_ = {0};
+  // drop_count_ when the drops were last reported, logger thread only
+  uint64_t reported_drop_count_ = 0;
 
-  // The buffer currently being flushed by the logger thread, cleared
-  // after a successful flush.
-  std::unique_ptr<std::deque<Msg>> flushing_buf_;
+  // Application threads enqueue, the logger thread dequeues in batches.
+  base::MpmcRing<Msg> msg_queue_;
 
   // Trigger for the logger thread to stop.
   enum State { INITTED, RUNNING, STOPPED };
   std::atomic<State> state_ = {INITTED};
-  std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
   std::unordered_map<std::string, std::unique_ptr<LogFileObject>>
       module_logger_map_;
 
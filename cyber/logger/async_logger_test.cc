@@ -16,10 +16,20 @@
 
 #include "cyber/logger/async_logger.h"
 
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 #include "glog/logging.h"
 
+#include "cyber/common/file.h"
 #include "cyber/common/log.h"
 
 namespace apollo {
@@ -54,6 +64,77 @@ TEST(AsyncLoggerTest, WriteAndFlush) {
   logger.Stop();
 }
 
+class AsyncLoggerQueueTest : public ::testing::Test {
+ protected:
+  // accepts writes but holds the logger thread back, so the queue fills up
+  static void Hold(AsyncLogger* logger) {
+    logger->state_.store(AsyncLogger::RUNNING);
+  }
+  static void Resume(AsyncLogger* logger) {
+    logger->log_thread_ = std::thread(&AsyncLogger::RunThread, logger);
+  }
+  static uint64_t DropCount(const AsyncLogger& logger) {
+    return logger.drop_count_.load();
+  }
+  static uint64_t QueueSize() { return AsyncLogger::kQueueSize; }
+
+  static std::string Message(char severity, const std::string& text) {
+    std::string message(1, severity);
+    message.append("0909 99:99:99.999999 99999 async_logger_test.cc:999] ");
+    message.append(LEFT_BRACKET);
+    message.append("AsyncLoggerQueueTest");
+    message.append(RIGHT_BRACKET);
+    message.append(text);
+    message.append("\n");
+    return message;
+  }
+  static void Write(AsyncLogger* logger, const std::string& message) {
+    logger->Write(false, time(nullptr), message.c_str(),
+                  static_cast<int>(message.length()));
+  }
+};
+
+TEST_F(AsyncLoggerQueueTest, ErrorNotDroppedWhenFull) {
+  char log_dir[] = "/tmp/async_logger_test_XXXXXX";
+  ASSERT_NE(mkdtemp(log_dir), nullptr);
+  const std::string old_log_dir = FLAGS_log_dir;
+  FLAGS_log_dir = log_dir;
+
+  AsyncLogger logger(google::base::GetLogger(google::INFO));
+  Hold(&logger);
+  for (uint64_t i = 0; i < QueueSize(); ++i) {
+    Write(&logger, Message('I', "filling message"));
+  }
+  EXPECT_EQ(DropCount(logger), 0);
+  Write(&logger, Message('W', "dropped warning"));
+  EXPECT_EQ(DropCount(logger), 1);
+
+  // the error waits until the logger thread makes room
+  std::atomic<bool> written = {false};
+  std::thread writer([&]() {
+    Write(&logger, Message('E', "error while the queue is full"));
+    written = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(written.load());
+  Resume(&logger);
+  writer.join();
+  logger.Stop();
+  EXPECT_EQ(DropCount(logger), 1);
+
+  auto files = common::Glob(std::string(log_dir) +
+                            "/AsyncLoggerQueueTest.log.INFO.*");
+  ASSERT_EQ(files.size(), 1);
+  std::string content;
+  ASSERT_TRUE(common::GetContent(files[0], &content));
+  EXPECT_NE(content.find("error while the queue is full"), std::string::npos);
+  EXPECT_EQ(content.find("dropped warning"), std::string::npos);
+
+  common::RemoveAllFiles(log_dir);
+  rmdir(log_dir);
+  FLAGS_log_dir = old_log_dir;
+}
+
 TEST(AsyncLoggerTest, SetLoggerToGlog) {
   google::InitGoogleLogging("AsyncLoggerTest2");
   google::SetLogDestination(google::ERROR, "");
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Logging with deferred formatting. AINFO_FMT("speed {} at {}", v, s)
+ * logs like AINFO << "speed " << v << " at " << s, but once a BinaryLogConf
+ * is enabled the calling thread only stores the format id and the raw
+ * arguments, the formatting is left to the writer thread or, in BINARY mode,
+ * to cyber_log_decoder. The format must be a string literal.
+ */
+
+#ifndef CYBER_LOGGER_BINARY_LOG_H_
+#define CYBER_LOGGER_BINARY_LOG_H_
+
+#include "cyber/common/log.h"
+#include "cyber/logger/binary_log_format.h"
+#include "cyber/logger/binary_logger.h"
+
+#define ALOG_FMT_MODULE(module, severity, fmt, ...)                          \
+  do {                                                                       \
+    if ((severity) >= FLAGS_minloglevel) {                                   \
+      static const ::apollo::cyber::logger::LogFormat* cyber_log_format =    \
+          ::apollo::cyber::logger::BinaryLogger::Instance()->RegisterFormat( \
+              severity, __FILE__, __LINE__, module, "" fmt);                 \
+      ::apollo::cyber::logger::BinaryLog(cyber_log_format, ##__VA_ARGS__);   \
+    }                                                                        \
+  } while (0)
+
+#define ADEBUG_FMT(fmt, ...)                                     \
+  do {                                                           \
+    if (VLOG_IS_ON(4)) {                                         \
+      ALOG_FMT_MODULE(MODULE_NAME, google::INFO, "[DEBUG] " fmt, \
+                      ##__VA_ARGS__);                            \
+    }                                                            \
+  } while (0)
+#define AINFO_FMT(fmt, ...)                                      \
+  ALOG_FMT_MODULE(MODULE_NAME, google::INFO, fmt, ##__VA_ARGS__)
+#define AWARN_FMT(fmt, ...)                                         \
+  ALOG_FMT_MODULE(MODULE_NAME, google::WARNING, fmt, ##__VA_ARGS__)
+#define AERROR_FMT(fmt, ...)                                      \
+  ALOG_FMT_MODULE(MODULE_NAME, google::ERROR, fmt, ##__VA_ARGS__)
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+template <typename... Args>
+void BinaryLog(const LogFormat* format, const Args&... args) {
+  auto record = BinaryLogger::LocalRecord();
+  record->Reset(format->id);
+  int expand[] = {0, (EncodeLogArg(args, record), 0)...};
+  (void)expand;
+  record->Finish();
+
+  auto logger = BinaryLogger::Instance();
+  if (logger->running()) {
+    logger->Write(*record);
+  } else {
+    BinaryLogger::WriteNow(*format, *record);
+  }
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_LOGGER_BINARY_LOG_H_
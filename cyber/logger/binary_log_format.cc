@@ -0,0 +1,262 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/binary_log_format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <ctime>
+
+#include "cyber/logger/logger_util.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+namespace {
+
+constexpr char kSeverityChars[] = "IWEF";
+
+template <typename T>
+bool ReadValue(const char* data, uint32_t size, uint32_t* pos, T* value) {
+  if (*pos + sizeof(T) > size) {
+    return false;
+  }
+  std::memcpy(value, data + *pos, sizeof(T));
+  *pos += static_cast<uint32_t>(sizeof(T));
+  return true;
+}
+
+bool ReadString(const char* data, uint32_t size, uint32_t* pos,
+                std::string* value) {
+  uint32_t length = 0;
+  if (!ReadValue(data, size, pos, &length) || *pos + length > size) {
+    return false;
+  }
+  value->assign(data + *pos, length);
+  *pos += length;
+  return true;
+}
+
+void WriteString(const std::string& value, std::string* data) {
+  auto length = static_cast<uint32_t>(value.size());
+  data->append(reinterpret_cast<const char*>(&length), sizeof(length));
+  data->append(value);
+}
+
+/**
+ * @brief Print the next argument, false at the end or if it is corrupted
+ */
+bool AppendArg(const char* args, uint32_t size, uint32_t* pos,
+               std::string* message, bool* corrupted) {
+  if (*pos >= size) {
+    return false;
+  }
+  auto type = static_cast<LogArgType>(args[(*pos)++]);
+  char buf[32];
+  int length = 0;
+  bool ok = true;
+  switch (type) {
+    case LogArgType::INT: {
+      int64_t value = 0;
+      ok = ReadValue(args, size, pos, &value);
+      length = snprintf(buf, sizeof(buf), "%" PRId64, value);
+      break;
+    }
+    case LogArgType::UINT: {
+      uint64_t value = 0;
+      ok = ReadValue(args, size, pos, &value);
+      length = snprintf(buf, sizeof(buf), "%" PRIu64, value);
+      break;
+    }
+    case LogArgType::DOUBLE: {
+      // same as the default precision of ostream
+      double value = 0.0;
+      ok = ReadValue(args, size, pos, &value);
+      length = snprintf(buf, sizeof(buf), "%g", value);
+      break;
+    }
+    case LogArgType::BOOL: {
+      uint8_t value = 0;
+      ok = ReadValue(args, size, pos, &value);
+      buf[0] = value != 0 ? '1' : '0';
+      length = 1;
+      break;
+    }
+    case LogArgType::CHAR: {
+      ok = ReadValue(args, size, pos, &buf[0]);
+      length = 1;
+      break;
+    }
+    case LogArgType::POINTER: {
+      uint64_t value = 0;
+      ok = ReadValue(args, size, pos, &value);
+      length = value == 0 ? snprintf(buf, sizeof(buf), "0")
+                          : snprintf(buf, sizeof(buf), "0x%" PRIx64, value);
+      break;
+    }
+    case LogArgType::STRING: {
+      uint32_t string_size = 0;
+      ok = ReadValue(args, size, pos, &string_size) &&
+           *pos + string_size <= size;
+      if (ok) {
+        message->append(args + *pos, string_size);
+        *pos += string_size;
+      }
+      break;
+    }
+    default:
+      ok = false;
+      break;
+  }
+  if (!ok) {
+    *corrupted = true;
+    return false;
+  }
+  message->append(buf, length);
+  return true;
+}
+
+void AppendLineHeader(int32_t severity, int64_t timestamp_ns, int32_t tid,
+                      const std::string& file, uint32_t line,
+                      std::string* out) {
+  time_t seconds = static_cast<time_t>(timestamp_ns / 1000000000);
+  auto usec = static_cast<int32_t>(timestamp_ns % 1000000000 / 1000);
+  struct tm tm_time;
+  localtime_r(&seconds, &tm_time);
+  char buf[64];
+  int length = snprintf(
+      buf, sizeof(buf), "%c%02d%02d %02d:%02d:%02d.%06d %5d ",
+      kSeverityChars[std::min(std::max(severity, 0), 3)], 1 + tm_time.tm_mon,
+      tm_time.tm_mday, tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec, usec,
+      tid);
+  out->append(buf, length);
+  out->append(file);
+  length = snprintf(buf, sizeof(buf), ":%u] ", line);
+  out->append(buf, length);
+}
+
+}  // namespace
+
+constexpr uint32_t LogRecordBuilder::kMaxSize;
+
+void LogRecordBuilder::Reset(uint32_t format_id) {
+  LogRecordHeader header;
+  header.size = 0;
+  header.format_id = format_id;
+  header.tid = GetThreadId();
+  header.reserved = 0;
+  header.timestamp_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  std::memcpy(data_, &header, sizeof(header));
+  size_ = sizeof(header);
+}
+
+void LogRecordBuilder::AppendString(const char* data, size_t length) {
+  constexpr uint32_t kPrefixSize = 1 + sizeof(uint32_t);
+  if (size_ + kPrefixSize > kMaxSize) {
+    return;
+  }
+  auto string_size = static_cast<uint32_t>(
+      std::min<size_t>(length, kMaxSize - size_ - kPrefixSize));
+  data_[size_] = static_cast<char>(LogArgType::STRING);
+  std::memcpy(data_ + size_ + 1, &string_size, sizeof(string_size));
+  std::memcpy(data_ + size_ + kPrefixSize, data, string_size);
+  size_ += kPrefixSize + string_size;
+}
+
+bool FormatLogMessage(const std::string& fmt, const char* args, uint32_t size,
+                      std::string* message) {
+  uint32_t pos = 0;
+  bool corrupted = false;
+  for (size_t i = 0; i < fmt.size(); ++i) {
+    char c = fmt[i];
+    char next = i + 1 < fmt.size() ? fmt[i + 1] : '\0';
+    if ((c == '{' || c == '}') && next == c) {
+      message->push_back(c);
+      ++i;
+    } else if (c == '{' && next == '}') {
+      if (!AppendArg(args, size, &pos, message, &corrupted)) {
+        message->append("{}");
+      }
+      ++i;
+    } else {
+      message->push_back(c);
+    }
+  }
+  while (pos < size && !corrupted) {
+    message->push_back(' ');
+    AppendArg(args, size, &pos, message, &corrupted);
+  }
+  return !corrupted;
+}
+
+bool FormatLogRecord(const LogFormat& format, const char* record,
+                     std::string* line) {
+  LogRecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+  if (header.size < sizeof(header)) {
+    return false;
+  }
+  AppendLineHeader(format.severity, header.timestamp_ns, header.tid,
+                   format.file, format.line, line);
+  line->append("[");
+  line->append(format.module);
+  line->append("]");
+  bool ok = FormatLogMessage(format.fmt, record + sizeof(header),
+                             header.size - sizeof(header), line);
+  line->push_back('\n');
+  return ok;
+}
+
+void FormatLogDrop(const LogDropEntry& drop, const std::string& module,
+                   std::string* line) {
+  AppendLineHeader(1, drop.timestamp_ns, drop.tid, "binary_log", 0, line);
+  line->append("[");
+  line->append(module);
+  line->append("]");
+  line->append("binary log dropped " + std::to_string(drop.count) +
+               " records of thread " + std::to_string(drop.tid) + "\n");
+}
+
+void SerializeLogFormat(const LogFormat& format, std::string* data) {
+  data->append(reinterpret_cast<const char*>(&format.id), sizeof(format.id));
+  data->append(reinterpret_cast<const char*>(&format.severity),
+               sizeof(format.severity));
+  data->append(reinterpret_cast<const char*>(&format.line),
+               sizeof(format.line));
+  WriteString(format.file, data);
+  WriteString(format.module, data);
+  WriteString(format.fmt, data);
+}
+
+bool ParseLogFormat(const char* data, uint32_t size, LogFormat* format) {
+  uint32_t pos = 0;
+  return ReadValue(data, size, &pos, &format->id) &&
+         ReadValue(data, size, &pos, &format->severity) &&
+         ReadValue(data, size, &pos, &format->line) &&
+         ReadString(data, size, &pos, &format->file) &&
+         ReadString(data, size, &pos, &format->module) &&
+         ReadString(data, size, &pos, &format->fmt);
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
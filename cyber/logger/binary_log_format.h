@@ -0,0 +1,256 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_LOGGER_BINARY_LOG_FORMAT_H_
+#define CYBER_LOGGER_BINARY_LOG_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+/**
+ * @brief Call site of a deferred log statement, registered once per site by
+ * the AINFO_FMT family of macros and referred to by id in the records.
+ */
+struct LogFormat {
+  uint32_t id = 0;
+  int32_t severity = 0;
+  uint32_t line = 0;
+  std::string file;
+  std::string module;
+  std::string fmt;
+};
+
+enum class LogArgType : uint8_t {
+  INT = 1,
+  UINT = 2,
+  DOUBLE = 3,
+  BOOL = 4,
+  CHAR = 5,
+  STRING = 6,
+  POINTER = 7,
+};
+
+/**
+ * @brief Head of every record, both in the thread rings and in binary log
+ * files. The arguments follow as a type tag and the raw value each, strings
+ * are prefixed by their uint32 length.
+ */
+struct LogRecordHeader {
+  // including the header
+  uint32_t size;
+  uint32_t format_id;
+  int32_t tid;
+  uint32_t reserved;
+  int64_t timestamp_ns;
+};
+
+// binary log file: kBinaryLogMagic, LogFileHeader and the binary name, then
+// entries made of a LogEntryHeader and its payload
+constexpr char kBinaryLogMagic[8] = "CYBLOG1";
+
+struct LogFileHeader {
+  int32_t pid;
+  uint32_t name_size;
+};
+
+enum class LogEntryType : uint32_t {
+  // serialized LogFormat, written before the first record using it
+  FORMAT = 1,
+  // a record as it was taken from the ring
+  RECORD = 2,
+  // LogDropEntry
+  DROP = 3,
+};
+
+struct LogEntryHeader {
+  uint32_t type;
+  uint32_t size;
+};
+
+struct LogDropEntry {
+  int32_t tid;
+  uint32_t reserved;
+  uint64_t count;
+  int64_t timestamp_ns;
+};
+
+/**
+ * @class LogRecordBuilder
+ * @brief Encodes one record into a fixed size buffer. Strings that do not
+ * fit are truncated, scalars that do not fit are left out.
+ */
+class LogRecordBuilder {
+ public:
+  static constexpr uint32_t kMaxSize = 2048;
+
+  /**
+   * @brief Start a record of the calling thread stamped with the wall time
+   */
+  void Reset(uint32_t format_id);
+
+  void AppendInt(int64_t value) { AppendScalar(LogArgType::INT, value); }
+  void AppendUint(uint64_t value) { AppendScalar(LogArgType::UINT, value); }
+  void AppendDouble(double value) { AppendScalar(LogArgType::DOUBLE, value); }
+  void AppendBool(bool value) {
+    AppendScalar(LogArgType::BOOL, static_cast<uint8_t>(value));
+  }
+  void AppendChar(char value) { AppendScalar(LogArgType::CHAR, value); }
+  void AppendPointer(const void* value) {
+    AppendScalar(LogArgType::POINTER, reinterpret_cast<uint64_t>(value));
+  }
+  void AppendString(const char* data, size_t length);
+
+  /**
+   * @brief Write the final size into the header
+   */
+  void Finish() { std::memcpy(data_, &size_, sizeof(size_)); }
+
+  const char* data() const { return data_; }
+  uint32_t size() const { return size_; }
+
+ private:
+  template <typename T>
+  void AppendScalar(LogArgType type, T value) {
+    if (size_ + 1 + sizeof(T) > kMaxSize) {
+      return;
+    }
+    data_[size_] = static_cast<char>(type);
+    std::memcpy(data_ + size_ + 1, &value, sizeof(T));
+    size_ += static_cast<uint32_t>(1 + sizeof(T));
+  }
+
+  alignas(8) char data_[kMaxSize];
+  uint32_t size_ = 0;
+};
+
+// Arguments are stored by type like operator<< would print them, anything
+// that is not a number, a character, a string or a pointer is formatted with
+// operator<< right away.
+inline void EncodeLogArg(bool value, LogRecordBuilder* record) {
+  record->AppendBool(value);
+}
+
+inline void EncodeLogArg(char value, LogRecordBuilder* record) {
+  record->AppendChar(value);
+}
+
+inline void EncodeLogArg(signed char value, LogRecordBuilder* record) {
+  record->AppendChar(static_cast<char>(value));
+}
+
+inline void EncodeLogArg(unsigned char value, LogRecordBuilder* record) {
+  record->AppendChar(static_cast<char>(value));
+}
+
+inline void EncodeLogArg(const char* value, LogRecordBuilder* record) {
+  if (value == nullptr) {
+    record->AppendString("(null)", 6);
+  } else {
+    record->AppendString(value, std::strlen(value));
+  }
+}
+
+inline void EncodeLogArg(const std::string& value, LogRecordBuilder* record) {
+  record->AppendString(value.data(), value.size());
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value &&
+                        std::is_signed<T>::value>::type
+EncodeLogArg(T value, LogRecordBuilder* record) {
+  record->AppendInt(static_cast<int64_t>(value));
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value &&
+                        std::is_unsigned<T>::value>::type
+EncodeLogArg(T value, LogRecordBuilder* record) {
+  record->AppendUint(static_cast<uint64_t>(value));
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type EncodeLogArg(
+    T value, LogRecordBuilder* record) {
+  record->AppendDouble(static_cast<double>(value));
+}
+
+template <typename T>
+typename std::enable_if<std::is_enum<T>::value>::type EncodeLogArg(
+    T value, LogRecordBuilder* record) {
+  record->AppendInt(static_cast<int64_t>(value));
+}
+
+template <typename T>
+void EncodeLogArg(const T* value, LogRecordBuilder* record) {
+  record->AppendPointer(value);
+}
+
+template <typename T>
+typename std::enable_if<!std::is_arithmetic<T>::value &&
+                        !std::is_enum<T>::value &&
+                        !std::is_pointer<T>::value &&
+                        !std::is_array<T>::value>::type
+EncodeLogArg(const T& value, LogRecordBuilder* record) {
+  std::ostringstream oss;
+  oss << value;
+  EncodeLogArg(oss.str(), record);
+}
+
+/**
+ * @brief Substitute the encoded arguments for the {} of fmt in order, {{
+ * and }} stand for literal braces. Arguments left over are appended
+ * separated by spaces.
+ *
+ * @return false if the arguments are corrupted
+ */
+bool FormatLogMessage(const std::string& fmt, const char* args, uint32_t size,
+                      std::string* message);
+
+/**
+ * @brief Format a record like glog formats a line of the module, e.g.
+ * "I1018 12:34:56.789012 12345 planning.cc:42] [planning]message\n"
+ *
+ * @param record starts with its LogRecordHeader
+ */
+bool FormatLogRecord(const LogFormat& format, const char* record,
+                     std::string* line);
+
+/**
+ * @brief Format the notice that a thread dropped records
+ */
+void FormatLogDrop(const LogDropEntry& drop, const std::string& module,
+                   std::string* line);
+
+/**
+ * @brief Serialize format for a FORMAT entry of a binary log file
+ */
+void SerializeLogFormat(const LogFormat& format, std::string* data);
+
+bool ParseLogFormat(const char* data, uint32_t size, LogFormat* format);
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_LOGGER_BINARY_LOG_FORMAT_H_
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/binary_log_reader.h"
+
+#include <cstring>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+BinaryLogReader::~BinaryLogReader() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+  }
+}
+
+bool BinaryLogReader::Open(const std::string& file_name) {
+  file_ = std::fopen(file_name.c_str(), "rb");
+  if (file_ == nullptr) {
+    AERROR << "Failed to open " << file_name;
+    return false;
+  }
+  char magic[sizeof(kBinaryLogMagic)];
+  LogFileHeader header;
+  if (std::fread(magic, sizeof(magic), 1, file_) != 1 ||
+      std::memcmp(magic, kBinaryLogMagic, sizeof(magic)) != 0 ||
+      std::fread(&header, sizeof(header), 1, file_) != 1) {
+    AERROR << file_name << " is not a binary log";
+    return false;
+  }
+  binary_name_.resize(header.name_size);
+  if (header.name_size > 0 &&
+      std::fread(&binary_name_[0], header.name_size, 1, file_) != 1) {
+    AERROR << file_name << " is truncated";
+    return false;
+  }
+  pid_ = header.pid;
+  return true;
+}
+
+bool BinaryLogReader::ReadLine(std::string* line) {
+  line->clear();
+  LogEntryHeader header;
+  while (file_ != nullptr &&
+         std::fread(&header, sizeof(header), 1, file_) == 1) {
+    buffer_.resize(header.size);
+    if (header.size > 0 &&
+        std::fread(buffer_.data(), header.size, 1, file_) != 1) {
+      AWARN << "binary log is truncated";
+      return false;
+    }
+    switch (static_cast<LogEntryType>(header.type)) {
+      case LogEntryType::FORMAT: {
+        LogFormat format;
+        if (!ParseLogFormat(buffer_.data(), header.size, &format)) {
+          AWARN << "corrupted format in binary log";
+          return false;
+        }
+        formats_[format.id] = format;
+        break;
+      }
+      case LogEntryType::RECORD: {
+        LogRecordHeader record;
+        if (header.size < sizeof(record)) {
+          AWARN << "corrupted record in binary log";
+          return false;
+        }
+        std::memcpy(&record, buffer_.data(), sizeof(record));
+        auto format = formats_.find(record.format_id);
+        if (record.size != header.size || format == formats_.end()) {
+          AWARN << "corrupted record in binary log";
+          return false;
+        }
+        FormatLogRecord(format->second, buffer_.data(), line);
+        return true;
+      }
+      case LogEntryType::DROP: {
+        LogDropEntry drop;
+        if (header.size != sizeof(drop)) {
+          AWARN << "corrupted drop entry in binary log";
+          return false;
+        }
+        std::memcpy(&drop, buffer_.data(), sizeof(drop));
+        FormatLogDrop(drop, binary_name_, line);
+        return true;
+      }
+      default:
+        // written by a newer version
+        break;
+    }
+  }
+  return false;
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
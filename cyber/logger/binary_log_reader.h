@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_LOGGER_BINARY_LOG_READER_H_
+#define CYBER_LOGGER_BINARY_LOG_READER_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/common/macros.h"
+#include "cyber/logger/binary_log_format.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+/**
+ * @class BinaryLogReader
+ * @brief Reads a binary log file written by BinaryLogger and formats its
+ * records the way the TEXT mode would have.
+ */
+class BinaryLogReader {
+ public:
+  BinaryLogReader() = default;
+  ~BinaryLogReader();
+
+  bool Open(const std::string& file_name);
+
+  /**
+   * @brief Format the next record or drop notice
+   *
+   * @return false at the end of the file or if it is corrupted
+   */
+  bool ReadLine(std::string* line);
+
+  const std::string& binary_name() const { return binary_name_; }
+  int32_t pid() const { return pid_; }
+
+ private:
+  std::FILE* file_ = nullptr;
+  std::string binary_name_;
+  int32_t pid_ = 0;
+  std::unordered_map<uint32_t, LogFormat> formats_;
+  std::vector<char> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(BinaryLogReader);
+};
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_LOGGER_BINARY_LOG_READER_H_
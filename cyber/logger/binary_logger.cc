@@ -0,0 +1,382 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/binary_logger.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#include "glog/logging.h"
+
+#include "cyber/binary.h"
+#include "cyber/common/log.h"
+#include "cyber/logger/logger_util.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+namespace {
+
+// a ring always holds a few records of the maximum size
+constexpr uint32_t kMinRingSize = 4 * LogRecordBuilder::kMaxSize;
+
+uint32_t RoundUpToPowerOfTwo(uint32_t size) {
+  uint32_t result = kMinRingSize;
+  while (result < size && result < (1U << 31)) {
+    result <<= 1;
+  }
+  return result;
+}
+
+struct LocalRingHolder {
+  std::shared_ptr<LogRing> ring;
+  uint64_t generation = 0;
+  ~LocalRingHolder() {
+    if (ring != nullptr) {
+      ring->Close();
+    }
+  }
+};
+
+}  // namespace
+
+LogRing::LogRing(uint32_t size, int32_t tid)
+    : size_(size), mask_(size - 1), tid_(tid), buffer_(new char[size]) {}
+
+bool LogRing::Write(const char* data, uint32_t size) {
+  uint64_t pos = write_pos_.load(std::memory_order_relaxed);
+  if (pos + size - cached_read_pos_ > size_) {
+    cached_read_pos_ = read_pos_.load(std::memory_order_acquire);
+    if (pos + size - cached_read_pos_ > size_) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  uint64_t offset = pos & mask_;
+  uint64_t first = std::min<uint64_t>(size, size_ - offset);
+  std::memcpy(buffer_.get() + offset, data, first);
+  std::memcpy(buffer_.get(), data + first, size - first);
+  write_pos_.store(pos + size, std::memory_order_release);
+  return true;
+}
+
+void LogRing::Drain(std::string* out) {
+  uint64_t end = write_pos_.load(std::memory_order_acquire);
+  uint64_t pos = read_pos_.load(std::memory_order_relaxed);
+  if (pos == end) {
+    return;
+  }
+  uint64_t offset = pos & mask_;
+  uint64_t size = end - pos;
+  uint64_t first = std::min(size, size_ - offset);
+  out->append(buffer_.get() + offset, first);
+  out->append(buffer_.get(), size - first);
+  read_pos_.store(end, std::memory_order_release);
+}
+
+BinaryLogger::BinaryLogger() {}
+
+const LogFormat* BinaryLogger::RegisterFormat(int32_t severity,
+                                              const char* file, uint32_t line,
+                                              const char* module,
+                                              const char* fmt) {
+  std::unique_ptr<LogFormat> format(new LogFormat());
+  format->severity = severity;
+  const char* slash = std::strrchr(file, '/');
+  format->file = slash != nullptr ? slash + 1 : file;
+  format->line = line;
+  format->module = module;
+  format->fmt = fmt;
+  std::lock_guard<std::mutex> lock(format_mutex_);
+  format->id = static_cast<uint32_t>(formats_.size());
+  formats_.emplace_back(std::move(format));
+  return formats_.back().get();
+}
+
+bool BinaryLogger::Start(const proto::BinaryLogConf& conf) {
+  if (running_.load()) {
+    return false;
+  }
+  conf_.CopyFrom(conf);
+  if (conf_.flush_interval_ms() == 0) {
+    conf_.set_flush_interval_ms(1);
+  }
+
+  if (conf_.mode() == proto::BinaryLogConf::BINARY) {
+    std::string file_name = conf_.file();
+    if (file_name.empty()) {
+      file_name = binary::GetName() + "." + std::to_string(getpid()) + ".blog";
+      if (!FLAGS_log_dir.empty()) {
+        file_name = FLAGS_log_dir + "/" + file_name;
+      }
+    }
+    file_ = std::fopen(file_name.c_str(), "wb");
+    if (file_ == nullptr) {
+      AERROR << "Failed to open binary log " << file_name << ": "
+             << std::strerror(errno);
+      return false;
+    }
+    LogFileHeader header;
+    header.pid = getpid();
+    header.name_size = static_cast<uint32_t>(binary::GetName().size());
+    std::fwrite(kBinaryLogMagic, sizeof(kBinaryLogMagic), 1, file_);
+    std::fwrite(&header, sizeof(header), 1, file_);
+    std::fwrite(binary::GetName().data(), header.name_size, 1, file_);
+    formats_written_ = 0;
+  }
+
+  ring_size_.store(RoundUpToPowerOfTwo(conf_.ring_size_kb() * 1024),
+                   std::memory_order_relaxed);
+  running_.store(true, std::memory_order_release);
+  thread_ = std::thread(&BinaryLogger::Run, this);
+  return true;
+}
+
+void BinaryLogger::Stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  // records written while stopping are picked up here or lost with the ring
+  Poll();
+
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+  for (auto& ring : rings_) {
+    removed_dropped_ += ring->dropped();
+  }
+  rings_.clear();
+  generation_.fetch_add(1, std::memory_order_release);
+  if (file_ != nullptr) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+void BinaryLogger::Write(const LogRecordBuilder& record) {
+  LocalRing()->Write(record.data(), record.size());
+}
+
+void BinaryLogger::WriteNow(const LogFormat& format,
+                            const LogRecordBuilder& record) {
+  std::string message;
+  auto header_size = static_cast<uint32_t>(sizeof(LogRecordHeader));
+  FormatLogMessage(format.fmt, record.data() + header_size,
+                   record.size() - header_size, &message);
+  google::LogMessage(format.file.c_str(), format.line, format.severity)
+          .stream()
+      << LEFT_BRACKET << format.module << RIGHT_BRACKET << message;
+}
+
+LogRecordBuilder* BinaryLogger::LocalRecord() {
+  static thread_local LogRecordBuilder record;
+  return &record;
+}
+
+uint64_t BinaryLogger::dropped() {
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+  uint64_t dropped = removed_dropped_;
+  for (auto& ring : rings_) {
+    dropped += ring->dropped();
+  }
+  return dropped;
+}
+
+LogRing* BinaryLogger::LocalRing() {
+  static thread_local LocalRingHolder local;
+  uint64_t generation = generation_.load(std::memory_order_acquire);
+  if (cyber_unlikely(local.ring == nullptr ||
+                     local.generation != generation)) {
+    local.ring = std::make_shared<LogRing>(
+        ring_size_.load(std::memory_order_relaxed), GetThreadId());
+    local.generation = generation;
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    rings_.push_back(local.ring);
+  }
+  return local.ring.get();
+}
+
+void BinaryLogger::Run() {
+  auto interval = std::chrono::milliseconds(conf_.flush_interval_ms());
+  while (running_.load(std::memory_order_acquire)) {
+    {
+      std::unique_lock<std::mutex> lk(thread_mutex_);
+      cv_.wait_for(lk, interval, [this]() { return !running_.load(); });
+    }
+    Poll();
+  }
+}
+
+void BinaryLogger::Poll() {
+  std::vector<std::shared_ptr<LogRing>> rings;
+  {
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    rings = rings_;
+  }
+
+  batch_.clear();
+  std::vector<std::shared_ptr<LogRing>> closed;
+  std::vector<std::pair<int32_t, uint64_t>> drops;
+  for (auto& ring : rings) {
+    // a closed ring is complete once drained
+    if (ring->closed()) {
+      closed.push_back(ring);
+    }
+    ring->Drain(&batch_);
+    uint64_t dropped = ring->dropped();
+    if (dropped != ring->reported_dropped) {
+      drops.emplace_back(ring->tid(), dropped - ring->reported_dropped);
+      ring->reported_dropped = dropped;
+    }
+  }
+  if (!closed.empty()) {
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    for (auto& ring : closed) {
+      auto it = std::find(rings_.begin(), rings_.end(), ring);
+      if (it != rings_.end()) {
+        removed_dropped_ += ring->dropped();
+        rings_.erase(it);
+      }
+    }
+  }
+
+  // every ring is in order, merge them by time
+  std::vector<std::pair<int64_t, size_t>> records;
+  LogRecordHeader header;
+  for (size_t pos = 0; pos + sizeof(header) <= batch_.size();
+       pos += header.size) {
+    std::memcpy(&header, batch_.data() + pos, sizeof(header));
+    records.emplace_back(header.timestamp_ns, pos);
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const std::pair<int64_t, size_t>& lhs,
+                      const std::pair<int64_t, size_t>& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+
+  if (file_ != nullptr) {
+    WriteFormats();
+  }
+  for (auto& record : records) {
+    OutputRecord(batch_.data() + record.second);
+  }
+  for (auto& drop : drops) {
+    OutputDrop(drop.first, drop.second);
+  }
+  if (file_ != nullptr) {
+    std::fflush(file_);
+  }
+}
+
+const LogFormat* BinaryLogger::GetFormat(uint32_t id) {
+  if (id >= known_formats_.size()) {
+    std::lock_guard<std::mutex> lock(format_mutex_);
+    for (size_t i = known_formats_.size(); i < formats_.size(); ++i) {
+      known_formats_.push_back(formats_[i].get());
+    }
+  }
+  return id < known_formats_.size() ? known_formats_[id] : nullptr;
+}
+
+void BinaryLogger::WriteFormats() {
+  std::string data;
+  while (GetFormat(formats_written_) != nullptr) {
+    data.clear();
+    SerializeLogFormat(*known_formats_[formats_written_], &data);
+    WriteEntry(LogEntryType::FORMAT, data.data(),
+               static_cast<uint32_t>(data.size()));
+    ++formats_written_;
+  }
+}
+
+void BinaryLogger::WriteEntry(LogEntryType type, const char* data,
+                              uint32_t size) {
+  LogEntryHeader header;
+  header.type = static_cast<uint32_t>(type);
+  header.size = size;
+  std::fwrite(&header, sizeof(header), 1, file_);
+  std::fwrite(data, size, 1, file_);
+}
+
+void BinaryLogger::OutputRecord(const char* record) {
+  LogRecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+  if (file_ != nullptr) {
+    WriteEntry(LogEntryType::RECORD, record, header.size);
+    return;
+  }
+  auto format = GetFormat(header.format_id);
+  if (format == nullptr) {
+    return;
+  }
+  line_.clear();
+  FormatLogRecord(*format, record, &line_);
+  OutputText(format->severity,
+             static_cast<time_t>(header.timestamp_ns / 1000000000), line_);
+}
+
+void BinaryLogger::OutputDrop(int32_t tid, uint64_t count) {
+  LogDropEntry drop;
+  drop.tid = tid;
+  drop.reserved = 0;
+  drop.count = count;
+  drop.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+  if (file_ != nullptr) {
+    WriteEntry(LogEntryType::DROP, reinterpret_cast<const char*>(&drop),
+               sizeof(drop));
+    return;
+  }
+  line_.clear();
+  FormatLogDrop(drop, binary::GetName(), &line_);
+  OutputText(google::WARNING,
+             static_cast<time_t>(drop.timestamp_ns / 1000000000), line_);
+}
+
+void BinaryLogger::OutputText(int32_t severity, time_t timestamp,
+                              const std::string& line) {
+  if (text_sink_) {
+    text_sink_(severity, timestamp, line);
+    return;
+  }
+  if (FLAGS_logtostderr || FLAGS_alsologtostderr ||
+      severity >= FLAGS_stderrthreshold) {
+    std::fwrite(line.data(), line.size(), 1, stderr);
+  }
+  if (!FLAGS_logtostderr) {
+    // as glog does, to the logger of every severity up to that of the line,
+    // the INFO one being the async logger in a cyber process
+    for (int32_t i = std::min(severity, google::NUM_SEVERITIES - 1);
+         i >= google::INFO; --i) {
+      google::base::GetLogger(i)->Write(severity >= google::WARNING, timestamp,
+                                        line.data(),
+                                        static_cast<int>(line.size()));
+    }
+  }
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
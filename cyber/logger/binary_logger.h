@@ -0,0 +1,183 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_LOGGER_BINARY_LOGGER_H_
+#define CYBER_LOGGER_BINARY_LOGGER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyber/proto/perf_conf.pb.h"
+
+#include "cyber/base/macros.h"
+#include "cyber/common/macros.h"
+#include "cyber/logger/binary_log_format.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+/**
+ * @class LogRing
+ * @brief Single producer single consumer byte ring of one logging thread.
+ * Records are published whole, a record that does not fit is dropped and
+ * counted instead of waiting for the writer thread.
+ */
+class LogRing {
+ public:
+  LogRing(uint32_t size, int32_t tid);
+
+  /**
+   * @brief Append a record, only called by the owning thread
+   */
+  bool Write(const char* data, uint32_t size);
+
+  /**
+   * @brief Move all published records to the end of out, only called by the
+   * writer thread
+   */
+  void Drain(std::string* out);
+
+  void Close() { closed_.store(true, std::memory_order_release); }
+  bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+  int32_t tid() const { return tid_; }
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  // drops already reported by the writer thread
+  uint64_t reported_dropped = 0;
+
+ private:
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> write_pos_ = {0};
+  uint64_t cached_read_pos_ = 0;
+  std::atomic<uint64_t> dropped_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> read_pos_ = {0};
+  std::atomic<bool> closed_ = {false};
+
+  const uint64_t size_;
+  const uint64_t mask_;
+  const int32_t tid_;
+  std::unique_ptr<char[]> buffer_;
+};
+
+/**
+ * @class BinaryLogger
+ * @brief Deferred formatting for the AINFO_FMT family of macros. Logging
+ * threads only copy a format id and the raw arguments into a ring of their
+ * own, the writer thread drains the rings every flush interval, orders the
+ * records by time and either formats them into the usual log files (TEXT)
+ * or appends them to a binary log file for cyber_log_decoder (BINARY).
+ * While stopped, records are formatted and logged by the calling thread.
+ */
+class BinaryLogger {
+ public:
+  using TextSink =
+      std::function<void(int32_t severity, time_t timestamp,
+                         const std::string& line)>;
+
+  /**
+   * @brief Register a call site, the returned format lives forever
+   */
+  const LogFormat* RegisterFormat(int32_t severity, const char* file,
+                                  uint32_t line, const char* module,
+                                  const char* fmt);
+
+  bool Start(const proto::BinaryLogConf& conf);
+  void Stop();
+  void Shutdown() { Stop(); }
+
+  bool running() const { return running_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Queue a finished record in the ring of the calling thread
+   */
+  void Write(const LogRecordBuilder& record);
+
+  /**
+   * @brief Format a finished record and log it through glog right away
+   */
+  static void WriteNow(const LogFormat& format, const LogRecordBuilder& record);
+
+  /**
+   * @brief Builder reused by all records of the calling thread
+   */
+  static LogRecordBuilder* LocalRecord();
+
+  /**
+   * @brief Receive the TEXT lines instead of the glog INFO logger, set it
+   * before Start
+   */
+  void SetTextSink(const TextSink& sink) { text_sink_ = sink; }
+
+  /**
+   * @brief Records dropped because a ring was full, over all threads
+   */
+  uint64_t dropped();
+
+  std::thread* WriterThread() { return &thread_; }
+
+ private:
+  LogRing* LocalRing();
+  void Run();
+  void Poll();
+  const LogFormat* GetFormat(uint32_t id);
+  void WriteFormats();
+  void WriteEntry(LogEntryType type, const char* data, uint32_t size);
+  void OutputRecord(const char* record);
+  void OutputDrop(int32_t tid, uint64_t count);
+  void OutputText(int32_t severity, time_t timestamp, const std::string& line);
+
+  proto::BinaryLogConf conf_;
+  TextSink text_sink_ = nullptr;
+  std::atomic<bool> running_ = {false};
+  std::atomic<uint32_t> ring_size_ = {0};
+  // bumped on Stop so that threads start over with a new ring
+  std::atomic<uint64_t> generation_ = {0};
+
+  std::mutex format_mutex_;
+  std::vector<std::unique_ptr<LogFormat>> formats_;
+
+  std::mutex ring_mutex_;
+  std::vector<std::shared_ptr<LogRing>> rings_;
+  uint64_t removed_dropped_ = 0;
+
+  // owned by the writer thread
+  std::thread thread_;
+  std::mutex thread_mutex_;
+  std::condition_variable cv_;
+  std::vector<const LogFormat*> known_formats_;
+  std::string batch_;
+  std::string line_;
+  std::FILE* file_ = nullptr;
+  uint32_t formats_written_ = 0;
+
+  DECLARE_SINGLETON(BinaryLogger)
+};
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_LOGGER_BINARY_LOGGER_H_
@@ -0,0 +1,226 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/binary_logger.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/logger/binary_log.h"
+#include "cyber/logger/binary_log_reader.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+namespace {
+
+enum Gear { PARK = 1, DRIVE = 4 };
+
+struct Point {
+  int x;
+  int y;
+};
+
+std::ostream& operator<<(std::ostream& os, const Point& point) {
+  return os << "(" << point.x << ", " << point.y << ")";
+}
+
+template <typename... Args>
+std::string Format(const std::string& fmt, const Args&... args) {
+  LogRecordBuilder record;
+  record.Reset(0);
+  int expand[] = {0, (EncodeLogArg(args, &record), 0)...};
+  (void)expand;
+  record.Finish();
+  std::string message;
+  auto header_size = static_cast<uint32_t>(sizeof(LogRecordHeader));
+  EXPECT_TRUE(FormatLogMessage(fmt, record.data() + header_size,
+                               record.size() - header_size, &message));
+  return message;
+}
+
+void LogFromThreads(int thread_num, int record_num) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([t, record_num]() {
+      for (int i = 0; i < record_num; ++i) {
+        ALOG_FMT_MODULE("BinaryLoggerTest", google::INFO,
+                        "thread {} record {} speed {}", t, i, 0.5 * i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+class CountingLogger : public google::base::Logger {
+ public:
+  void Write(bool force_flush, time_t timestamp, const char* message,
+             int message_len) override {
+    ++count;
+  }
+  void Flush() override {}
+  uint32_t LogSize() override { return 0; }
+
+  int count = 0;
+};
+
+}  // namespace
+
+TEST(BinaryLoggerTest, format) {
+  EXPECT_EQ(Format("int {} uint {}", -3, 7u), "int -3 uint 7");
+  EXPECT_EQ(Format("{} {}", 1.5, 1e-7), "1.5 1e-07");
+  EXPECT_EQ(Format("{}{}{}", true, 'c', std::string("str")), "1cstr");
+  EXPECT_EQ(Format("{} {}", "literal", static_cast<const char*>(nullptr)),
+               "literal (null)");
+  EXPECT_EQ(Format("gear {}", DRIVE), "gear 4");
+  EXPECT_EQ(Format("point {}", Point{1, 2}), "point (1, 2)");
+  EXPECT_EQ(Format("{}", static_cast<void*>(nullptr)), "0");
+  EXPECT_EQ(Format("{{}} {}", 1), "{} 1");
+  EXPECT_EQ(Format("{} {}", 1), "1 {}");
+  EXPECT_EQ(Format("extra", 1, "arg"), "extra 1 arg");
+
+  // strings longer than a record are cut
+  std::string message = Format("{}", std::string(3 * 1024, 'x'));
+  EXPECT_GT(message.size(), 1024);
+  EXPECT_LT(message.size(), LogRecordBuilder::kMaxSize);
+}
+
+TEST(BinaryLoggerTest, text) {
+  std::vector<std::string> lines;
+  auto logger = BinaryLogger::Instance();
+  logger->SetTextSink([&lines](int32_t severity, time_t timestamp,
+                               const std::string& line) {
+    EXPECT_EQ(severity, google::INFO);
+    EXPECT_GT(timestamp, 0);
+    lines.push_back(line);
+  });
+  proto::BinaryLogConf conf;
+  conf.set_enable(true);
+  conf.set_mode(proto::BinaryLogConf::TEXT);
+  conf.set_flush_interval_ms(1);
+  EXPECT_TRUE(logger->Start(conf));
+  EXPECT_FALSE(logger->Start(conf));
+  LogFromThreads(4, 100);
+  logger->Stop();
+  logger->SetTextSink(nullptr);
+
+  ASSERT_EQ(lines.size(), 400);
+  EXPECT_EQ(lines[0].substr(0, 1), "I");
+  EXPECT_NE(lines[0].find("binary_logger_test.cc:"), std::string::npos);
+  // the order of every thread is kept
+  std::vector<int> next(4, 0);
+  for (auto& line : lines) {
+    auto pos = line.find("[BinaryLoggerTest]thread ");
+    ASSERT_NE(pos, std::string::npos) << line;
+    int thread = 0;
+    int record = 0;
+    ASSERT_EQ(std::sscanf(line.c_str() + pos, "[BinaryLoggerTest]thread %d "
+                                              "record %d",
+                          &thread, &record),
+              2);
+    EXPECT_EQ(record, next[thread]++);
+    EXPECT_NE(line.find("speed " + Format("{}", 0.5 * record) + "\n"),
+              std::string::npos);
+  }
+  EXPECT_EQ(logger->dropped(), 0);
+}
+
+TEST(BinaryLoggerTest, severity_loggers) {
+  // as glog, a line goes to the logger of its severity and all lower ones
+  CountingLogger loggers[google::NUM_SEVERITIES];
+  google::base::Logger* saved[google::NUM_SEVERITIES];
+  for (int i = 0; i < google::NUM_SEVERITIES; ++i) {
+    saved[i] = google::base::GetLogger(i);
+    google::base::SetLogger(i, &loggers[i]);
+  }
+  auto logger = BinaryLogger::Instance();
+  proto::BinaryLogConf conf;
+  conf.set_enable(true);
+  conf.set_mode(proto::BinaryLogConf::TEXT);
+  EXPECT_TRUE(logger->Start(conf));
+  ALOG_FMT_MODULE("BinaryLoggerTest", google::INFO, "info {}", 1);
+  ALOG_FMT_MODULE("BinaryLoggerTest", google::WARNING, "warning {}", 2);
+  ALOG_FMT_MODULE("BinaryLoggerTest", google::ERROR, "error {}", 3);
+  logger->Stop();
+  for (int i = 0; i < google::NUM_SEVERITIES; ++i) {
+    google::base::SetLogger(i, saved[i]);
+  }
+
+  EXPECT_EQ(loggers[google::INFO].count, 3);
+  EXPECT_EQ(loggers[google::WARNING].count, 2);
+  EXPECT_EQ(loggers[google::ERROR].count, 1);
+  EXPECT_EQ(loggers[google::FATAL].count, 0);
+}
+
+TEST(BinaryLoggerTest, binary) {
+  const std::string file_name = "binary_logger_test.blog";
+  auto logger = BinaryLogger::Instance();
+  proto::BinaryLogConf conf;
+  conf.set_enable(true);
+  conf.set_mode(proto::BinaryLogConf::BINARY);
+  conf.set_file(file_name);
+  EXPECT_TRUE(logger->Start(conf));
+  LogFromThreads(2, 50);
+  logger->Stop();
+
+  BinaryLogReader reader;
+  ASSERT_TRUE(reader.Open(file_name));
+  std::string line;
+  int count = 0;
+  while (reader.ReadLine(&line)) {
+    EXPECT_NE(line.find("[BinaryLoggerTest]thread "), std::string::npos);
+    ++count;
+  }
+  EXPECT_EQ(count, 100);
+  std::remove(file_name.c_str());
+}
+
+TEST(BinaryLoggerTest, drop) {
+  std::vector<std::string> lines;
+  auto logger = BinaryLogger::Instance();
+  logger->SetTextSink([&lines](int32_t severity, time_t timestamp,
+                               const std::string& line) {
+    lines.push_back(line);
+  });
+  uint64_t dropped = logger->dropped();
+  proto::BinaryLogConf conf;
+  conf.set_enable(true);
+  conf.set_ring_size_kb(1);
+  // nothing is drained before Stop
+  conf.set_flush_interval_ms(10000);
+  EXPECT_TRUE(logger->Start(conf));
+  LogFromThreads(1, 1000);
+  logger->Stop();
+  logger->SetTextSink(nullptr);
+  dropped = logger->dropped() - dropped;
+
+  EXPECT_GT(dropped, 0);
+  ASSERT_EQ(lines.size(), 1000 - dropped + 1);
+  EXPECT_NE(lines.back().find("binary log dropped " + std::to_string(dropped) +
+                              " records"),
+            std::string::npos);
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
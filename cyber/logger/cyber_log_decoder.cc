@@ -0,0 +1,43 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <iostream>
+#include <string>
+
+#include "cyber/logger/binary_log_reader.h"
+
+// Prints the records of binary logs written with BinaryLogConf mode BINARY
+// as the text logs would have shown them.
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <file.blog>..." << std::endl;
+    return 1;
+  }
+  int ret = 0;
+  std::string line;
+  for (int i = 1; i < argc; ++i) {
+    apollo::cyber::logger::BinaryLogReader reader;
+    if (!reader.Open(argv[i])) {
+      std::cerr << "Failed to open binary log " << argv[i] << std::endl;
+      ret = 1;
+      continue;
+    }
+    while (reader.ReadLine(&line)) {
+      std::cout << line;
+    }
+  }
+  return ret;
+}
@@ -17,6 +17,7 @@
 #include "cyber/logger/logger_util.h"
 
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/time.h>
 #include <sys/utsname.h>
 #include <unistd.h>
@@ -46,6 +47,11 @@ bool PidHasChanged() {
   return true;
 }
 
+int32_t GetThreadId() {
+  static thread_local int32_t tid = static_cast<int32_t>(syscall(SYS_gettid));
+  return tid;
+}
+
 }  // namespace logger
 }  // namespace cyber
 }  // namespace apollo
@@ -59,6 +59,11 @@ int32_t GetMainThreadPid();
 
 bool PidHasChanged();
 
+/**
+ * @brief Kernel id of the calling thread, cached per thread
+ */
+int32_t GetThreadId();
+
 inline int32_t MaxLogSize() {
   return (FLAGS_max_log_size > 0 ? FLAGS_max_log_size : 1);
 }
@@ -0,0 +1,75 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/mainboard/component_depends.h"
+
+#include <unordered_map>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace mainboard {
+
+bool ResolveDepends(const std::vector<std::string>& names,
+                    const std::vector<std::vector<std::string>>& depends,
+                    std::vector<std::vector<size_t>>* dependents,
+                    std::vector<size_t>* order) {
+  std::unordered_map<std::string, size_t> indexes;
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (!indexes.emplace(names[i], i).second) {
+      AWARN << "duplicate component name " << names[i]
+            << ", depends refer to the first one";
+    }
+  }
+  dependents->assign(names.size(), std::vector<size_t>());
+  std::vector<size_t> pending(names.size(), 0);
+  for (size_t i = 0; i < names.size(); ++i) {
+    for (auto& depend : depends[i]) {
+      auto it = indexes.find(depend);
+      if (it == indexes.end() || it->second == i) {
+        AERROR << "component " << names[i] << " depends on unknown component "
+               << depend;
+        return false;
+      }
+      (*dependents)[it->second].emplace_back(i);
+      ++pending[i];
+    }
+  }
+
+  order->clear();
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (pending[i] == 0) {
+      order->emplace_back(i);
+    }
+  }
+  for (size_t i = 0; i < order->size(); ++i) {
+    for (auto dependent : (*dependents)[(*order)[i]]) {
+      if (--pending[dependent] == 0) {
+        order->emplace_back(dependent);
+      }
+    }
+  }
+  if (order->size() != names.size()) {
+    AERROR << "circular depends between components";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace mainboard
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,52 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_MAINBOARD_COMPONENT_DEPENDS_H_
+#define CYBER_MAINBOARD_COMPONENT_DEPENDS_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace mainboard {
+
+/**
+ * @brief Resolve the depends of components given by name
+ *
+ * A duplicate name refers to its first component.
+ *
+ * @param names the name of every component
+ * @param depends the names every component depends on
+ * @param dependents set to the indexes of the components that depend on
+ * every component, once per entry in their depends
+ * @param order set to an initialization order, every component comes after
+ * the ones it depends on
+ *
+ * @return false if a depend is unknown, the component itself or part of a
+ * cycle
+ */
+bool ResolveDepends(const std::vector<std::string>& names,
+                    const std::vector<std::vector<std::string>>& depends,
+                    std::vector<std::vector<size_t>>* dependents,
+                    std::vector<size_t>* order);
+
+}  // namespace mainboard
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_MAINBOARD_COMPONENT_DEPENDS_H_
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/mainboard/component_depends.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace mainboard {
+
+TEST(ComponentDependsTest, order) {
+  std::vector<std::string> names = {"planning", "perception", "prediction",
+                                    "localization", "control"};
+  std::vector<std::vector<std::string>> depends = {
+      {"prediction", "localization"},
+      {"localization"},
+      {"perception"},
+      {},
+      {"planning", "localization"}};
+  std::vector<std::vector<size_t>> dependents;
+  std::vector<size_t> order;
+  ASSERT_TRUE(ResolveDepends(names, depends, &dependents, &order));
+  ASSERT_EQ(order.size(), names.size());
+
+  std::vector<size_t> position(names.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    position[order[i]] = i;
+  }
+  for (size_t i = 0; i < names.size(); ++i) {
+    for (auto& depend : depends[i]) {
+      size_t index = std::find(names.begin(), names.end(), depend) -
+                     names.begin();
+      EXPECT_LT(position[index], position[i])
+          << names[i] << " before " << depend;
+      auto& list = dependents[index];
+      EXPECT_NE(std::find(list.begin(), list.end(), i), list.end());
+    }
+  }
+  EXPECT_EQ(order.front(), 3);
+  EXPECT_EQ(order.back(), 4);
+}
+
+TEST(ComponentDependsTest, no_depends) {
+  std::vector<std::string> names = {"a", "b", "c"};
+  std::vector<std::vector<std::string>> depends(names.size());
+  std::vector<std::vector<size_t>> dependents;
+  std::vector<size_t> order;
+  ASSERT_TRUE(ResolveDepends(names, depends, &dependents, &order));
+  EXPECT_EQ(order, std::vector<size_t>({0, 1, 2}));
+  for (auto& list : dependents) {
+    EXPECT_TRUE(list.empty());
+  }
+}
+
+TEST(ComponentDependsTest, cycle) {
+  std::vector<std::vector<size_t>> dependents;
+  std::vector<size_t> order;
+  std::vector<std::string> names = {"a", "b", "c", "d"};
+  std::vector<std::vector<std::string>> depends = {{}, {"c"}, {"d"}, {"b"}};
+  EXPECT_FALSE(ResolveDepends(names, depends, &dependents, &order));
+
+  depends = {{"b"}, {"a"}, {}, {}};
+  EXPECT_FALSE(ResolveDepends(names, depends, &dependents, &order));
+
+  // a component may not depend on itself
+  depends = {{}, {"b"}, {}, {}};
+  EXPECT_FALSE(ResolveDepends(names, depends, &dependents, &order));
+}
+
+TEST(ComponentDependsTest, unknown) {
+  std::vector<std::string> names = {"a", "b"};
+  std::vector<std::vector<std::string>> depends = {{"b"}, {"c"}};
+  std::vector<std::vector<size_t>> dependents;
+  std::vector<size_t> order;
+  EXPECT_FALSE(ResolveDepends(names, depends, &dependents, &order));
+}
+
+TEST(ComponentDependsTest, duplicate_name) {
+  // depends refer to the first component of a name
+  std::vector<std::string> names = {"a", "b", "a"};
+  std::vector<std::vector<std::string>> depends = {{}, {"a"}, {"b"}};
+  std::vector<std::vector<size_t>> dependents;
+  std::vector<size_t> order;
+  ASSERT_TRUE(ResolveDepends(names, depends, &dependents, &order));
+  EXPECT_EQ(order, std::vector<size_t>({0, 1, 2}));
+  EXPECT_EQ(dependents[0], std::vector<size_t>({1}));
+  EXPECT_TRUE(dependents[2].empty());
+}
+
+}  // namespace mainboard
+}  // namespace cyber
+}  // namespace apollo
@@ -19,6 +19,10 @@
 #include <getopt.h>
 #include <libgen.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
 using apollo::cyber::common::GlobalData;
 
 namespace apollo {
@@ -38,6 +42,11 @@ void ModuleArgument::DisplayUsage() {
            "plugin\n"
         << "    --disable_plugin_autoload : default enable autoload "
            "mode of plugins, use disable_plugin_autoload to ingore autoload\n"
+        << "    --parallel_startup[=thread_num]: load the libraries while "
+           "components are initialized by thread_num threads, default the "
+           "number of cpus. Components wait for the ones in their depends "
+           "only, flag files are all loaded before the first Init. "
+           "thread_num must follow '=', --parallel_startup 4 is rejected\n"
         << "Example:\n"
         << "    " << binary_name_ << " -h\n"
         << "    " << binary_name_ << " -d dag_conf_file1 -d dag_conf_file2 "
@@ -78,6 +87,8 @@ void ModuleArgument::GetOptions(const int argc, char* const argv[]) {
       {"plugin", required_argument, nullptr, ARGS_OPT_CODE_PLUGIN},
       {"disable_plugin_autoload", no_argument, nullptr,
        ARGS_OPT_CODE_DISABLE_PLUGIN_AUTOLOAD},
+      {"parallel_startup", optional_argument, nullptr,
+       ARGS_OPT_CODE_PARALLEL_STARTUP},
       {NULL, no_argument, nullptr, 0}};
 
   // log command for info
@@ -122,6 +133,12 @@ void ModuleArgument::GetOptions(const int argc, char* const argv[]) {
       case ARGS_OPT_CODE_DISABLE_PLUGIN_AUTOLOAD:
           disable_plugin_autoload_ = true;
         break;
+      case ARGS_OPT_CODE_PARALLEL_STARTUP:
+        startup_thread_num_ =
+            optarg != nullptr
+                ? static_cast<uint32_t>(std::max(std::atoi(optarg), 1))
+                : std::max(std::thread::hardware_concurrency(), 1u);
+        break;
       case 'h':
         DisplayUsage();
         exit(0);
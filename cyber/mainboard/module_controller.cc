@@ -16,17 +16,59 @@
 
 #include "cyber/mainboard/module_controller.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
+#include "cyber/base/thread_pool.h"
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
 #include "cyber/component/component_base.h"
+#include "cyber/mainboard/component_depends.h"
 #include "cyber/plugin_manager/plugin_manager.h"
+#include "cyber/time/time.h"
 
 namespace apollo {
 namespace cyber {
 namespace mainboard {
 
+using apollo::cyber::proto::ComponentInfo;
+using apollo::cyber::proto::TimerComponentInfo;
+
+struct ModuleController::ComponentTask {
+  // one of them is set
+  const ComponentInfo* info = nullptr;
+  const TimerComponentInfo* timer_info = nullptr;
+  std::shared_ptr<ComponentBase> component;
+  std::vector<size_t> dependents;
+  // dependencies not initialized yet
+  size_t pending = 0;
+  bool loaded = false;
+  StartupRecord record;
+
+  const std::string& name() const {
+    return info != nullptr ? info->config().name()
+                           : timer_info->config().name();
+  }
+  const std::string& class_name() const {
+    return info != nullptr ? info->class_name() : timer_info->class_name();
+  }
+  const std::string& flag_file_path() const {
+    return info != nullptr ? info->config().flag_file_path()
+                           : timer_info->config().flag_file_path();
+  }
+  const google::protobuf::RepeatedPtrField<std::string>& depends() const {
+    return info != nullptr ? info->depends() : timer_info->depends();
+  }
+  bool Initialize() {
+    return info != nullptr ? component->Initialize(info->config())
+                           : component->Initialize(timer_info->config());
+  }
+};
+
 void ModuleController::Clear() {
   for (auto& component : component_list_) {
     component->Shutdown();
@@ -36,10 +78,13 @@ void ModuleController::Clear() {
 }
 
 bool ModuleController::LoadAll() {
+  startup_begin_ = Time::MonoTime().ToNanosecond();
+  startup_records_.clear();
   const std::string work_root = common::WorkRoot();
   const std::string current_path = common::GetCurrentPath();
   const std::string dag_root_path = common::GetAbsolutePath(work_root, "dag");
   std::vector<std::string> paths;
+  std::vector<DagConfig> dag_configs;
   for (auto& plugin_description : args_.GetPluginDescriptionList()) {
     apollo::cyber::plugin_manager::PluginManager::Instance()->LoadPlugin(
         plugin_description);
@@ -56,21 +101,34 @@ bool ModuleController::LoadAll() {
       return false;
     }
     AINFO << "mainboard: use dag conf " << module_path;
-    total_component_nums += GetComponentNum(module_path);
+    DagConfig dag_config;
+    if (!common::GetProtoFromFile(module_path, &dag_config)) {
+      AERROR << "Get proto failed, file: " << module_path;
+      return false;
+    }
+    total_component_nums += GetComponentNum(dag_config);
     paths.emplace_back(std::move(module_path));
+    dag_configs.emplace_back(std::move(dag_config));
   }
   if (has_timer_component) {
     total_component_nums += scheduler::Instance()->TaskPoolSize();
   }
   common::GlobalData::Instance()->SetComponentNums(total_component_nums);
-  for (auto module_path : paths) {
-    AINFO << "Start initialize dag: " << module_path;
-    if (!LoadModule(module_path)) {
-      AERROR << "Failed to load module: " << module_path;
-      return false;
+  bool success = true;
+  if (args_.GetStartupThreadNum() > 0) {
+    success = LoadModulesParallel(dag_configs);
+  } else {
+    for (size_t i = 0; i < paths.size(); ++i) {
+      AINFO << "Start initialize dag: " << paths[i];
+      if (!LoadModule(dag_configs[i])) {
+        AERROR << "Failed to load module: " << paths[i];
+        success = false;
+        break;
+      }
     }
   }
-  return true;
+  ReportStartup(Elapsed());
+  return success;
 }
 
 bool ModuleController::LoadModule(const DagConfig& dag_config) {
@@ -84,54 +142,243 @@ bool ModuleController::LoadModule(const DagConfig& dag_config) {
     }
     AINFO << "mainboard: use module library " << load_path;
 
+    uint64_t load_start = Elapsed();
     class_loader_manager_.LoadLibrary(load_path);
+    uint64_t load_time = Elapsed() - load_start;
 
+    std::vector<ComponentTask> tasks;
     for (auto& component : module_config.components()) {
-      const std::string& class_name = component.class_name();
-      std::shared_ptr<ComponentBase> base =
-          class_loader_manager_.CreateClassObj<ComponentBase>(class_name);
-      if (base == nullptr || !base->Initialize(component.config())) {
-        return false;
-      }
-      component_list_.emplace_back(std::move(base));
+      tasks.emplace_back();
+      tasks.back().info = &component;
     }
-
     for (auto& component : module_config.timer_components()) {
-      const std::string& class_name = component.class_name();
-      std::shared_ptr<ComponentBase> base =
-          class_loader_manager_.CreateClassObj<ComponentBase>(class_name);
-      if (base == nullptr || !base->Initialize(component.config())) {
+      tasks.emplace_back();
+      tasks.back().timer_info = &component;
+    }
+    for (auto& task : tasks) {
+      auto& record = task.record;
+      record.name = task.name();
+      record.library = load_path;
+      record.load_time = load_time;
+      record.ready = record.start = Elapsed();
+      task.component = class_loader_manager_.CreateClassObj<ComponentBase>(
+          task.class_name());
+      record.success = task.component != nullptr && task.Initialize();
+      record.finish = Elapsed();
+      startup_records_.emplace_back(record);
+      if (!record.success) {
         return false;
       }
-      component_list_.emplace_back(std::move(base));
+      component_list_.emplace_back(std::move(task.component));
     }
   }
   return true;
 }
 
-bool ModuleController::LoadModule(const std::string& path) {
-  DagConfig dag_config;
-  if (!common::GetProtoFromFile(path, &dag_config)) {
-    AERROR << "Get proto failed, file: " << path;
+bool ModuleController::LoadModulesParallel(
+    const std::vector<DagConfig>& dag_configs) {
+  // the libraries in order of appearance and the components they contain
+  std::vector<std::string> libraries;
+  std::vector<std::vector<size_t>> library_tasks;
+  std::unordered_map<std::string, size_t> library_index;
+  std::vector<ComponentTask> tasks;
+  for (auto& dag_config : dag_configs) {
+    for (auto& module_config : dag_config.module_config()) {
+      std::string load_path;
+      if (!common::GetFilePathWithEnv(module_config.module_library(),
+                                      "APOLLO_LIB_PATH", &load_path)) {
+        AERROR << "no module library [" << module_config.module_library()
+               << "] found!";
+        return false;
+      }
+      auto library = library_index.emplace(load_path, libraries.size());
+      if (library.second) {
+        libraries.emplace_back(load_path);
+        library_tasks.emplace_back();
+      }
+      auto& indexes = library_tasks[library.first->second];
+      for (auto& component : module_config.components()) {
+        indexes.emplace_back(tasks.size());
+        tasks.emplace_back();
+        tasks.back().info = &component;
+      }
+      for (auto& component : module_config.timer_components()) {
+        indexes.emplace_back(tasks.size());
+        tasks.emplace_back();
+        tasks.back().timer_info = &component;
+      }
+    }
+  }
+
+  std::vector<std::string> names;
+  std::vector<std::vector<std::string>> depends;
+  for (auto& task : tasks) {
+    names.emplace_back(task.name());
+    depends.emplace_back(task.depends().begin(), task.depends().end());
+  }
+  std::vector<std::vector<size_t>> dependents;
+  std::vector<size_t> order;
+  if (!ResolveDepends(names, depends, &dependents, &order)) {
     return false;
   }
-  return LoadModule(dag_config);
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    tasks[i].pending = depends[i].size();
+    tasks[i].dependents = std::move(dependents[i]);
+  }
+
+  // flags may be read by any Init, they can't be changed once the first one
+  // started
+  for (auto& task : tasks) {
+    if (!task.flag_file_path().empty()) {
+      ComponentBase::LoadFlagFile(task.flag_file_path());
+    }
+  }
+  ComponentBase::FlagFilesPreloaded() = true;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t running = 0;
+  size_t finished = 0;
+  bool failed = false;
+  base::ThreadPool pool(args_.GetStartupThreadNum(), tasks.size() + 1);
+  // called with mutex held, once the library of the task is loaded and its
+  // dependencies are initialized
+  std::function<void(size_t)> submit = [&](size_t index) {
+    ++running;
+    tasks[index].record.ready = Elapsed();
+    pool.Enqueue([&, index]() {
+      auto& task = tasks[index];
+      task.record.start = Elapsed();
+      bool success = task.Initialize();
+      std::lock_guard<std::mutex> lock(mutex);
+      task.record.finish = Elapsed();
+      task.record.success = success;
+      --running;
+      ++finished;
+      if (!success) {
+        AERROR << "component " << task.name() << " Initialize failed.";
+        failed = true;
+      } else if (!failed) {
+        for (auto dependent : task.dependents) {
+          if (--tasks[dependent].pending == 0 && tasks[dependent].loaded) {
+            submit(dependent);
+          }
+        }
+      }
+      cv.notify_all();
+    });
+  };
+
+  // dlopen is serialized by the dynamic loader anyway, libraries are loaded
+  // here while the components of the previous ones are initialized
+  for (size_t library = 0; library < libraries.size(); ++library) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (failed) {
+        break;
+      }
+    }
+    AINFO << "mainboard: use module library " << libraries[library];
+    uint64_t load_start = Elapsed();
+    class_loader_manager_.LoadLibrary(libraries[library]);
+    uint64_t load_time = Elapsed() - load_start;
+    for (auto index : library_tasks[library]) {
+      auto& task = tasks[index];
+      task.record.name = task.name();
+      task.record.library = libraries[library];
+      task.record.load_time = load_time;
+      task.component = class_loader_manager_.CreateClassObj<ComponentBase>(
+          task.class_name());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto index : library_tasks[library]) {
+      auto& task = tasks[index];
+      if (task.component == nullptr) {
+        failed = true;
+        break;
+      }
+      task.loaded = true;
+      if (task.pending == 0 && !failed) {
+        submit(index);
+      }
+    }
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() {
+      return running == 0 && (failed || finished == tasks.size());
+    });
+  }
+  ComponentBase::FlagFilesPreloaded() = false;
+
+  // initialized ones are kept even on failure, Clear shuts them down
+  for (auto& task : tasks) {
+    if (task.record.name.empty()) {
+      continue;
+    }
+    startup_records_.emplace_back(task.record);
+    if (task.record.success) {
+      component_list_.emplace_back(std::move(task.component));
+    }
+  }
+  return !failed;
 }
 
-int ModuleController::GetComponentNum(const std::string& path) {
-  DagConfig dag_config;
+int ModuleController::GetComponentNum(const DagConfig& dag_config) {
   int component_nums = 0;
-  if (common::GetProtoFromFile(path, &dag_config)) {
-    for (auto module_config : dag_config.module_config()) {
-      component_nums += module_config.components_size();
-      if (module_config.timer_components_size() > 0) {
-        has_timer_component = true;
-      }
+  for (auto& module_config : dag_config.module_config()) {
+    component_nums += module_config.components_size();
+    if (module_config.timer_components_size() > 0) {
+      has_timer_component = true;
     }
   }
   return component_nums;
 }
 
+uint64_t ModuleController::Elapsed() const {
+  return Time::MonoTime().ToNanosecond() - startup_begin_;
+}
+
+void ModuleController::ReportStartup(uint64_t total_time) const {
+  constexpr double kNsPerMs = 1e6;
+  std::vector<const StartupRecord*> records;
+  uint64_t init_time = 0;
+  for (auto& record : startup_records_) {
+    records.emplace_back(&record);
+    if (record.finish > record.start) {
+      init_time += record.finish - record.start;
+    }
+  }
+  std::sort(records.begin(), records.end(),
+            [](const StartupRecord* lhs, const StartupRecord* rhs) {
+              // not started last
+              if ((lhs->start == 0) != (rhs->start == 0)) {
+                return rhs->start == 0;
+              }
+              return lhs->finish < rhs->finish;
+            });
+
+  AINFO << "mainboard startup: " << records.size() << " components in "
+        << static_cast<double>(total_time) / kNsPerMs << " ms, Init took "
+        << static_cast<double>(init_time) / kNsPerMs << " ms in total";
+  for (auto record : records) {
+    if (record->start == 0) {
+      AINFO << "  " << record->name << ": not started";
+      continue;
+    }
+    AINFO << "  " << record->name << (record->success ? "" : " FAILED")
+          << ": done at " << static_cast<double>(record->finish) / kNsPerMs
+          << " ms, Init "
+          << static_cast<double>(record->finish - record->start) / kNsPerMs
+          << " ms, queued "
+          << static_cast<double>(record->start - record->ready) / kNsPerMs
+          << " ms, library " << record->library << " loaded in "
+          << static_cast<double>(record->load_time) / kNsPerMs << " ms";
+  }
+}
+
 }  // namespace mainboard
 }  // namespace cyber
 }  // namespace apollo
@@ -16,6 +16,7 @@
 #ifndef CYBER_MAINBOARD_MODULE_CONTROLLER_H_
 #define CYBER_MAINBOARD_MODULE_CONTROLLER_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -42,15 +43,32 @@ class ModuleController {
   void Clear();
 
  private:
-  bool LoadModule(const std::string& path);
+  // startup timing of a component, in ns since LoadAll began
+  struct StartupRecord {
+    std::string name;
+    std::string library;
+    uint64_t load_time = 0;  // dlopen of the library
+    uint64_t ready = 0;      // library loaded and dependencies initialized
+    uint64_t start = 0;
+    uint64_t finish = 0;
+    bool success = false;
+  };
+
+  struct ComponentTask;
+
   bool LoadModule(const DagConfig& dag_config);
-  int GetComponentNum(const std::string& path);
+  bool LoadModulesParallel(const std::vector<DagConfig>& dag_configs);
+  int GetComponentNum(const DagConfig& dag_config);
+  uint64_t Elapsed() const;
+  void ReportStartup(uint64_t total_time) const;
   int total_component_nums = 0;
   bool has_timer_component = false;
 
   ModuleArgument args_;
   class_loader::ClassLoaderManager class_loader_manager_;
   std::vector<std::shared_ptr<ComponentBase>> component_list_;
+  uint64_t startup_begin_ = 0;
+  std::vector<StartupRecord> startup_records_;
 };
 
 inline ModuleController::ModuleController(const ModuleArgument& args)
@@ -17,7 +17,9 @@
 #ifndef CYBER_MESSAGE_MESSAGE_TRAITS_H_
 #define CYBER_MESSAGE_MESSAGE_TRAITS_H_
 
+#include <cstring>
 #include <string>
+#include <type_traits>
 
 #include "cyber/base/macros.h"
 #include "cyber/common/log.h"
@@ -53,6 +55,23 @@ class HasSerializer {
 template <typename T>
 constexpr bool HasSerializer<T>::value;
 
+// A flat message is a plain struct without its own serializer, whose memory
+// layout is its wire format. It can be copied with memcpy, and written and read
+// in place.
+template <typename T>
+class IsFlatMessage {
+ public:
+  static constexpr bool value =
+      std::is_class<T>::value && std::is_trivially_copyable<T>::value &&
+      std::is_standard_layout<T>::value &&
+      !std::is_base_of<google::protobuf::Message, T>::value &&
+      !HasSerializer<T>::value;
+};
+
+// avoid potential ODR violation
+template <typename T>
+constexpr bool IsFlatMessage<T>::value;
+
 template <typename T,
           typename std::enable_if<HasType<T>::value &&
                                       std::is_member_function_pointer<
@@ -126,8 +145,17 @@ typename std::enable_if<HasByteSize<T>::value, int>::type ByteSize(
 }
 
 template <typename T>
-typename std::enable_if<!HasByteSize<T>::value, int>::type ByteSize(
-    const T& message) {
+typename std::enable_if<!HasByteSize<T>::value && IsFlatMessage<T>::value,
+                        int>::type
+ByteSize(const T& message) {
+  (void)message;
+  return static_cast<int>(sizeof(T));
+}
+
+template <typename T>
+typename std::enable_if<!HasByteSize<T>::value && !IsFlatMessage<T>::value,
+                        int>::type
+ByteSize(const T& message) {
   (void)message;
   return -1;
 }
@@ -148,7 +176,18 @@ typename std::enable_if<HasParseFromArray<T>::value, bool>::type ParseFromArray(
 }
 
 template <typename T>
-typename std::enable_if<!HasParseFromArray<T>::value, bool>::type
+typename std::enable_if<!HasParseFromArray<T>::value && IsFlatMessage<T>::value,
+                        bool>::type
+ParseFromArray(const void* data, int size, T* message) {
+  RETURN_VAL_IF(data == nullptr || message == nullptr, false);
+  RETURN_VAL_IF(size != static_cast<int>(sizeof(T)), false);
+  memcpy(static_cast<void*>(message), data, sizeof(T));
+  return true;
+}
+
+template <typename T>
+typename std::enable_if<
+    !HasParseFromArray<T>::value && !IsFlatMessage<T>::value, bool>::type
 ParseFromArray(const void* data, int size, T* message) {
   return false;
 }
@@ -160,7 +199,15 @@ ParseFromString(const std::string& str, T* message) {
 }
 
 template <typename T>
-typename std::enable_if<!HasParseFromString<T>::value, bool>::type
+typename std::enable_if<
+    !HasParseFromString<T>::value && IsFlatMessage<T>::value, bool>::type
+ParseFromString(const std::string& str, T* message) {
+  return ParseFromArray(str.data(), static_cast<int>(str.size()), message);
+}
+
+template <typename T>
+typename std::enable_if<
+    !HasParseFromString<T>::value && !IsFlatMessage<T>::value, bool>::type
 ParseFromString(const std::string& str, T* message) {
   return false;
 }
@@ -191,7 +238,18 @@ SerializeToArray(const T& message, void* data, int size) {
 }
 
 template <typename T>
-typename std::enable_if<!HasSerializeToArray<T>::value, bool>::type
+typename std::enable_if<
+    !HasSerializeToArray<T>::value && IsFlatMessage<T>::value, bool>::type
+SerializeToArray(const T& message, void* data, int size) {
+  RETURN_VAL_IF(data == nullptr, false);
+  RETURN_VAL_IF(size < static_cast<int>(sizeof(T)), false);
+  memcpy(data, static_cast<const void*>(&message), sizeof(T));
+  return true;
+}
+
+template <typename T>
+typename std::enable_if<
+    !HasSerializeToArray<T>::value && !IsFlatMessage<T>::value, bool>::type
 SerializeToArray(const T& message, void* data, int size) {
   return false;
 }
@@ -203,7 +261,17 @@ SerializeToString(const T& message, std::string* str) {
 }
 
 template <typename T>
-typename std::enable_if<!HasSerializeToString<T>::value, bool>::type
+typename std::enable_if<
+    !HasSerializeToString<T>::value && IsFlatMessage<T>::value, bool>::type
+SerializeToString(const T& message, std::string* str) {
+  RETURN_VAL_IF_NULL(str, false);
+  str->assign(reinterpret_cast<const char*>(&message), sizeof(T));
+  return true;
+}
+
+template <typename T>
+typename std::enable_if<
+    !HasSerializeToString<T>::value && !IsFlatMessage<T>::value, bool>::type
 SerializeToString(const T& message, std::string* str) {
   return false;
 }
@@ -72,6 +72,11 @@ class Message {
   std::string TypeName() const { return "type"; }
 };
 
+struct FlatData {
+  uint64_t timestamp;
+  double value[3];
+};
+
 class PbMessage {
  public:
   static std::string TypeName() { return "protobuf"; }
@@ -232,6 +237,35 @@ TEST(MessageTraitsTest, parse_from_string) {
   EXPECT_EQ(str, raw.message);
 }
 
+TEST(MessageTraitsTest, flat_message) {
+  EXPECT_TRUE(IsFlatMessage<FlatData>::value);
+  EXPECT_FALSE(IsFlatMessage<Data>::value);
+  EXPECT_FALSE(IsFlatMessage<Message>::value);
+  EXPECT_FALSE(IsFlatMessage<RawMessage>::value);
+  EXPECT_FALSE(IsFlatMessage<proto::UnitTest>::value);
+  EXPECT_FALSE(IsFlatMessage<int>::value);
+
+  FlatData data{123, {1.0, 2.0, 3.0}};
+  EXPECT_EQ(ByteSize(data), sizeof(FlatData));
+
+  char array[sizeof(FlatData)] = {0};
+  EXPECT_FALSE(SerializeToArray(data, array, sizeof(array) - 1));
+  EXPECT_TRUE(SerializeToArray(data, array, sizeof(array)));
+
+  FlatData parsed{0, {0.0, 0.0, 0.0}};
+  EXPECT_FALSE(ParseFromArray(array, sizeof(array) - 1, &parsed));
+  EXPECT_TRUE(ParseFromArray(array, sizeof(array), &parsed));
+  EXPECT_EQ(parsed.timestamp, 123);
+  EXPECT_EQ(parsed.value[2], 3.0);
+
+  std::string str;
+  EXPECT_TRUE(SerializeToString(data, &str));
+  EXPECT_EQ(str.size(), sizeof(FlatData));
+  parsed.timestamp = 0;
+  EXPECT_TRUE(ParseFromString(str, &parsed));
+  EXPECT_EQ(parsed.timestamp, 123);
+}
+
 TEST(MessageTraitsTest, serialize_parse_hc) {
   auto msg = std::make_shared<proto::Chatter>();
   msg->set_timestamp(12345);
@@ -28,6 +28,13 @@ namespace apollo {
 namespace cyber {
 namespace message {
 
+/**
+ * @brief The serialized bytes of a message of any type. They are owned in
+ * `message`, unless the message was read in place from shared memory: then
+ * `message` is empty and the bytes stay in the block they were written to,
+ * read-only, until the last copy of the message is gone. data() and size()
+ * work for both.
+ */
 struct RawMessage {
   RawMessage() : message(""), timestamp(0) {}
 
@@ -37,12 +44,19 @@ struct RawMessage {
       : message(data), timestamp(ts) {}
 
   RawMessage(const RawMessage &raw_msg)
-      : message(raw_msg.message), timestamp(raw_msg.timestamp) {}
+      : message(raw_msg.message),
+        timestamp(raw_msg.timestamp),
+        view_(raw_msg.view_),
+        view_data_(raw_msg.view_data_),
+        view_size_(raw_msg.view_size_) {}
 
   RawMessage &operator=(const RawMessage &raw_msg) {
     if (this != &raw_msg) {
       this->message = raw_msg.message;
       this->timestamp = raw_msg.timestamp;
+      this->view_ = raw_msg.view_;
+      this->view_data_ = raw_msg.view_data_;
+      this->view_size_ = raw_msg.view_size_;
     }
     return *this;
   }
@@ -70,7 +84,7 @@ struct RawMessage {
       return false;
     }
 
-    memcpy(data, message.data(), message.size());
+    memcpy(data, this->data(), this->size());
     return true;
   }
 
@@ -78,7 +92,7 @@ struct RawMessage {
     if (str == nullptr) {
       return false;
     }
-    *str = message;
+    str->assign(data(), size());
     return true;
   }
 
@@ -88,20 +102,42 @@ struct RawMessage {
     }
 
     message.assign(reinterpret_cast<const char *>(data), size);
+    view_.reset();
     return true;
   }
 
   bool ParseFromString(const std::string &str) {
     message = str;
+    view_.reset();
     return true;
   }
 
-  int ByteSize() const { return static_cast<int>(message.size()); }
+  int ByteSize() const { return static_cast<int>(size()); }
+
+  const char *data() const { return view_ ? view_data_ : message.data(); }
+  std::size_t size() const { return view_ ? view_size_ : message.size(); }
+
+  /**
+   * @brief Refer to size bytes at data instead of owning a copy of them.
+   * They must stay valid as long as holder is alive.
+   */
+  void SetView(const std::shared_ptr<const void> &holder, const char *data,
+               std::size_t size) {
+    message.clear();
+    view_ = holder;
+    view_data_ = data;
+    view_size_ = size;
+  }
 
   static std::string TypeName() { return "apollo.cyber.message.RawMessage"; }
 
   std::string message;
   uint64_t timestamp;
+
+ private:
+  std::shared_ptr<const void> view_;
+  const char *view_data_ = nullptr;
+  std::size_t view_size_ = 0;
 };
 
 }  // namespace message
@@ -17,6 +17,7 @@
 #include "cyber/message/raw_message.h"
 
 #include <cstring>
+#include <memory>
 #include <string>
 
 #include "gtest/gtest.h"
@@ -67,6 +68,27 @@ TEST(RawMessageTest, parse_from_array) {
   EXPECT_EQ(msg.message, str);
 }
 
+TEST(RawMessageTest, view) {
+  auto bytes = std::make_shared<std::string>("view");
+  RawMessage msg("owned");
+  msg.SetView(bytes, bytes->data(), bytes->size());
+  EXPECT_TRUE(msg.message.empty());
+  EXPECT_EQ(msg.data(), bytes->data());
+  EXPECT_EQ(msg.ByteSize(), 4);
+
+  // copies share the view, and keep the bytes alive
+  RawMessage copy(msg);
+  bytes.reset();
+  msg = RawMessage();
+  EXPECT_EQ(std::string(copy.data(), copy.size()), "view");
+  std::string str;
+  EXPECT_TRUE(copy.SerializeToString(&str));
+  EXPECT_EQ(str, "view");
+
+  EXPECT_TRUE(copy.ParseFromString("parsed"));
+  EXPECT_EQ(std::string(copy.data(), copy.size()), "parsed");
+}
+
 TEST(RawMessageTest, message_type) {
   RawMessage msg;
   std::string msg_type = RawMessage::TypeName();
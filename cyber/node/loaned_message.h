@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_NODE_LOANED_MESSAGE_H_
+#define CYBER_NODE_LOANED_MESSAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "cyber/message/message_traits.h"
+#include "cyber/transport/message/loaned_buffer.h"
+#include "cyber/transport/transmitter/transmitter.h"
+
+namespace apollo {
+namespace cyber {
+
+template <typename MessageT>
+class Writer;
+
+/**
+ * @class LoanedMessage
+ * @brief A message buffer loaned from a Writer's transmitter. The content is
+ * written in place, in shared memory when possible, and published with
+ * `Writer::Write(LoanedMessage&&)` without being serialized again. A loan that
+ * is destroyed without being written is returned to the transmitter.
+ *
+ * For flat messages the buffer holds a `MessageT` that is accessed with
+ * `get()`; for other types such as RawMessage it holds the serialized bytes,
+ * accessed with `data()` and sized with `set_size()`.
+ */
+template <typename MessageT>
+class LoanedMessage {
+ public:
+  using TransmitterPtr = std::shared_ptr<transport::Transmitter<MessageT>>;
+
+  LoanedMessage() = default;
+  LoanedMessage(const TransmitterPtr& transmitter,
+                transport::LoanedBuffer&& buffer)
+      : transmitter_(transmitter), buffer_(std::move(buffer)) {}
+
+  LoanedMessage(LoanedMessage&& other) noexcept
+      : transmitter_(std::move(other.transmitter_)),
+        buffer_(std::move(other.buffer_)) {
+    other.transmitter_ = nullptr;
+    other.buffer_.Clear();
+  }
+
+  LoanedMessage& operator=(LoanedMessage&& other) noexcept {
+    if (this != &other) {
+      Release();
+      transmitter_ = std::move(other.transmitter_);
+      buffer_ = std::move(other.buffer_);
+      other.transmitter_ = nullptr;
+      other.buffer_.Clear();
+    }
+    return *this;
+  }
+
+  LoanedMessage(const LoanedMessage&) = delete;
+  LoanedMessage& operator=(const LoanedMessage&) = delete;
+
+  ~LoanedMessage() { Release(); }
+
+  /**
+   * @brief Is the loan still held, i.e. neither written nor released
+   */
+  bool IsValid() const {
+    return transmitter_ != nullptr && buffer_.buf != nullptr;
+  }
+
+  /**
+   * @brief Is the loaned buffer inside a shared memory segment
+   */
+  bool InSharedMemory() const { return buffer_.in_shm(); }
+
+  uint8_t* data() { return buffer_.buf; }
+  const uint8_t* data() const { return buffer_.buf; }
+  std::size_t capacity() const { return buffer_.capacity; }
+  std::size_t size() const { return buffer_.size; }
+
+  /**
+   * @brief Set the number of bytes that will be published
+   *
+   * @return false if size exceeds the capacity of the loan
+   */
+  bool set_size(std::size_t size) {
+    if (size > buffer_.capacity) {
+      return false;
+    }
+    buffer_.size = size;
+    return true;
+  }
+
+  template <typename T = MessageT>
+  typename std::enable_if<message::IsFlatMessage<T>::value, T*>::type get() {
+    return reinterpret_cast<T*>(buffer_.buf);
+  }
+
+  template <typename T = MessageT>
+  typename std::enable_if<message::IsFlatMessage<T>::value, T*>::type
+  operator->() {
+    return get();
+  }
+
+  template <typename T = MessageT>
+  typename std::enable_if<message::IsFlatMessage<T>::value, T&>::type
+  operator*() {
+    return *get();
+  }
+
+  /**
+   * @brief Give the buffer back without publishing it
+   */
+  void Release() {
+    if (IsValid()) {
+      transmitter_->Return(&buffer_);
+    }
+    transmitter_ = nullptr;
+    buffer_.Clear();
+  }
+
+ private:
+  friend class Writer<MessageT>;
+
+  bool Commit() {
+    if (!IsValid()) {
+      return false;
+    }
+    bool result = transmitter_->Commit(&buffer_);
+    transmitter_ = nullptr;
+    buffer_.Clear();
+    return result;
+  }
+
+  TransmitterPtr transmitter_ = nullptr;
+  transport::LoanedBuffer buffer_;
+};
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_NODE_LOANED_MESSAGE_H_
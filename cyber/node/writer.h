@@ -19,11 +19,14 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "cyber/proto/topology_change.pb.h"
 
 #include "cyber/common/log.h"
+#include "cyber/node/loaned_message.h"
 #include "cyber/node/writer_base.h"
 #include "cyber/service_discovery/topology_manager.h"
 #include "cyber/transport/transport.h"
@@ -84,6 +87,35 @@ class Writer : public WriterBase {
    */
   virtual bool Write(const std::shared_ptr<MessageT>& msg_ptr);
 
+  /**
+   * @brief Loan a buffer of `size` bytes to build a message in place. When
+   * the channel has readers in other processes the buffer is a shared memory
+   * block, so writing it publishes without any copy
+   *
+   * @param size number of bytes of the serialized message
+   * @return LoanedMessage<MessageT> invalid if the loan failed
+   */
+  LoanedMessage<MessageT> Loan(std::size_t size);
+
+  /**
+   * @brief Loan a value-initialized flat message to fill in place
+   *
+   * @return LoanedMessage<MessageT> invalid if the loan failed
+   */
+  template <typename T = MessageT>
+  typename std::enable_if<message::IsFlatMessage<T>::value,
+                          LoanedMessage<MessageT>>::type
+  Loan();
+
+  /**
+   * @brief Write a message previously loaned from this Writer
+   *
+   * @param loaned_msg the loan, it is consumed whatever the result
+   * @return true if write successfully
+   * @return false if write failed
+   */
+  bool Write(LoanedMessage<MessageT>&& loaned_msg);
+
   /**
    * @brief Is there any Reader that subscribes our Channel?
    * You can publish message when this return true
@@ -169,6 +201,38 @@ bool Writer<MessageT>::Write(const std::shared_ptr<MessageT>& msg_ptr) {
   return transmitter_->Transmit(msg_ptr);
 }
 
+template <typename MessageT>
+LoanedMessage<MessageT> Writer<MessageT>::Loan(std::size_t size) {
+  RETURN_VAL_IF(!WriterBase::IsInit(), LoanedMessage<MessageT>());
+  transport::LoanedBuffer buffer;
+  if (!transmitter_->Loan(size, &buffer)) {
+    AERROR << "loan " << size << " bytes on channel "
+           << role_attr_.channel_name() << " failed.";
+    return LoanedMessage<MessageT>();
+  }
+  return LoanedMessage<MessageT>(transmitter_, std::move(buffer));
+}
+
+template <typename MessageT>
+template <typename T>
+typename std::enable_if<message::IsFlatMessage<T>::value,
+                        LoanedMessage<MessageT>>::type
+Writer<MessageT>::Loan() {
+  auto loaned_msg = Loan(sizeof(MessageT));
+  if (loaned_msg.IsValid()) {
+    new (loaned_msg.data()) MessageT();
+  }
+  return loaned_msg;
+}
+
+template <typename MessageT>
+bool Writer<MessageT>::Write(LoanedMessage<MessageT>&& loaned_msg) {
+  LoanedMessage<MessageT> msg(std::move(loaned_msg));
+  RETURN_VAL_IF(!WriterBase::IsInit(), false);
+  RETURN_VAL_IF(!msg.IsValid(), false);
+  return msg.Commit();
+}
+
 template <typename MessageT>
 void Writer<MessageT>::JoinTheTopology() {
   // add listener
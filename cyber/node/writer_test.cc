@@ -16,6 +16,8 @@
 
 #include "cyber/node/writer.h"
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 
 #include "cyber/proto/unit_test.pb.h"
@@ -29,6 +31,12 @@ namespace writer {
 
 using proto::Chatter;
 
+struct FlatPose {
+  uint64_t timestamp;
+  double x;
+  double y;
+};
+
 TEST(WriterTest, test1) {
   proto::RoleAttributes role;
   Writer<Chatter> w(role);
@@ -73,6 +81,46 @@ TEST(WriterTest, test2) {
   EXPECT_FALSE(w.Write(c));
 }
 
+TEST(WriterTest, loan) {
+  proto::RoleAttributes role;
+  role.set_channel_name("/loan_raw");
+  role.set_node_name("loan_node");
+
+  Writer<message::RawMessage> raw_writer(role);
+  EXPECT_FALSE(raw_writer.Loan(8).IsValid());
+  EXPECT_TRUE(raw_writer.Init());
+  {
+    auto loaned = raw_writer.Loan(8);
+    EXPECT_TRUE(loaned.IsValid());
+    EXPECT_GE(loaned.capacity(), 8);
+    std::memcpy(loaned.data(), "content", 7);
+    EXPECT_TRUE(loaned.set_size(7));
+    EXPECT_FALSE(loaned.set_size(loaned.capacity() + 1));
+    EXPECT_TRUE(raw_writer.Write(std::move(loaned)));
+    EXPECT_FALSE(loaned.IsValid());
+    EXPECT_FALSE(raw_writer.Write(std::move(loaned)));
+  }
+  {
+    // a loan dropped without writing is given back
+    auto loaned = raw_writer.Loan(8);
+    EXPECT_TRUE(loaned.IsValid());
+    loaned.Release();
+    EXPECT_FALSE(loaned.IsValid());
+  }
+
+  role.set_channel_name("/loan_flat");
+  Writer<FlatPose> flat_writer(role);
+  EXPECT_TRUE(flat_writer.Init());
+  auto loaned = flat_writer.Loan();
+  EXPECT_TRUE(loaned.IsValid());
+  EXPECT_EQ(loaned.size(), sizeof(FlatPose));
+  EXPECT_EQ(loaned->timestamp, 0);
+  loaned->timestamp = Time::Now().ToNanosecond();
+  loaned->x = 1.0;
+  loaned->y = 2.0;
+  EXPECT_TRUE(flat_writer.Write(std::move(loaned)));
+}
+
 }  // namespace writer
 }  // namespace cyber
 }  // namespace apollo
@@ -163,7 +163,7 @@ class PyReader {
   void cb_rawmsg(const std::shared_ptr<const message::RawMessage>& message) {
     {
       std::lock_guard<std::mutex> lg(msg_lock_);
-      cache_.push_back(message->message);
+      cache_.emplace_back(message->data(), message->size());
     }
     if (func_) {
       func_(channel_name_.c_str());
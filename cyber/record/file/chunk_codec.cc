@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/file/chunk_codec.h"
+
+#include <limits>
+
+#include "lz4.h"
+#include "zstd.h"
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::ChunkBody;
+using apollo::cyber::proto::CompressedChunkBody;
+using apollo::cyber::proto::CompressType;
+
+namespace {
+
+// zstd level 3 is its default, a good ratio at several hundred MB/s
+constexpr int kZstdLevel = 3;
+
+bool CompressLz4(const std::string& raw, std::string* out) {
+  if (raw.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+    AERROR << "Chunk body too large for lz4, size: " << raw.size();
+    return false;
+  }
+  int bound = LZ4_compressBound(static_cast<int>(raw.size()));
+  out->resize(bound);
+  int size = LZ4_compress_default(raw.data(), &(*out)[0],
+                                  static_cast<int>(raw.size()), bound);
+  if (size <= 0) {
+    AERROR << "Lz4 compress failed, raw size: " << raw.size();
+    return false;
+  }
+  out->resize(size);
+  return true;
+}
+
+bool DecompressLz4(const std::string& data, uint64_t body_size,
+                   std::string* out) {
+  if (body_size > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+      data.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    AERROR << "Invalid lz4 chunk body size: " << body_size;
+    return false;
+  }
+  out->resize(body_size);
+  int size = LZ4_decompress_safe(data.data(), &(*out)[0],
+                                 static_cast<int>(data.size()),
+                                 static_cast<int>(body_size));
+  if (size < 0 || static_cast<uint64_t>(size) != body_size) {
+    AERROR << "Lz4 decompress failed, expect size: " << body_size
+           << ", result: " << size;
+    return false;
+  }
+  return true;
+}
+
+bool CompressZstd(const std::string& raw, std::string* out) {
+  size_t bound = ZSTD_compressBound(raw.size());
+  out->resize(bound);
+  size_t size =
+      ZSTD_compress(&(*out)[0], bound, raw.data(), raw.size(), kZstdLevel);
+  if (ZSTD_isError(size)) {
+    AERROR << "Zstd compress failed: " << ZSTD_getErrorName(size);
+    return false;
+  }
+  out->resize(size);
+  return true;
+}
+
+bool DecompressZstd(const std::string& data, uint64_t body_size,
+                    std::string* out) {
+  out->resize(body_size);
+  size_t size =
+      ZSTD_decompress(&(*out)[0], body_size, data.data(), data.size());
+  if (ZSTD_isError(size)) {
+    AERROR << "Zstd decompress failed: " << ZSTD_getErrorName(size);
+    return false;
+  }
+  if (size != body_size) {
+    AERROR << "Zstd decompress size mismatch, expect: " << body_size
+           << ", actual: " << size;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool IsCompressSupported(CompressType type) {
+  return type == CompressType::COMPRESS_NONE ||
+         type == CompressType::COMPRESS_LZ4 ||
+         type == CompressType::COMPRESS_ZSTD;
+}
+
+bool CompressChunkBody(CompressType type, const ChunkBody& body,
+                       CompressedChunkBody* compressed) {
+  std::string raw;
+  if (!body.SerializeToString(&raw)) {
+    AERROR << "Serialize chunk body failed.";
+    return false;
+  }
+  compressed->set_compress(type);
+  compressed->set_body_size(raw.size());
+  switch (type) {
+    case CompressType::COMPRESS_LZ4:
+      return CompressLz4(raw, compressed->mutable_data());
+    case CompressType::COMPRESS_ZSTD:
+      return CompressZstd(raw, compressed->mutable_data());
+    default:
+      AERROR << "Unsupported compress type: " << type;
+      return false;
+  }
+}
+
+bool DecompressChunkBody(const CompressedChunkBody& compressed,
+                         ChunkBody* body) {
+  std::string raw;
+  bool ok = false;
+  switch (compressed.compress()) {
+    case CompressType::COMPRESS_LZ4:
+      ok = DecompressLz4(compressed.data(), compressed.body_size(), &raw);
+      break;
+    case CompressType::COMPRESS_ZSTD:
+      ok = DecompressZstd(compressed.data(), compressed.body_size(), &raw);
+      break;
+    default:
+      AERROR << "Unsupported compress type: " << compressed.compress();
+      return false;
+  }
+  if (!ok) {
+    return false;
+  }
+  if (!body->ParseFromString(raw)) {
+    AERROR << "Parse decompressed chunk body failed.";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
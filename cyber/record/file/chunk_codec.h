@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_RECORD_FILE_CHUNK_CODEC_H_
+#define CYBER_RECORD_FILE_CHUNK_CODEC_H_
+
+#include <string>
+
+#include "cyber/proto/record.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+/**
+ * @brief Whether chunk bodies can be written with the compress type.
+ * COMPRESS_BZ2 is reserved and not supported.
+ */
+bool IsCompressSupported(proto::CompressType type);
+
+/**
+ * @brief Serialize the chunk body and compress it into compressed.
+ */
+bool CompressChunkBody(proto::CompressType type, const proto::ChunkBody& body,
+                       proto::CompressedChunkBody* compressed);
+
+/**
+ * @brief Decompress and parse a body written by CompressChunkBody.
+ */
+bool DecompressChunkBody(const proto::CompressedChunkBody& compressed,
+                         proto::ChunkBody* body);
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_RECORD_FILE_CHUNK_CODEC_H_
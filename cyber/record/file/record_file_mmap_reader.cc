@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/file/record_file_mmap_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <limits>
+
+#include "google/protobuf/io/coded_stream.h"
+
+#include "cyber/common/log.h"
+#include "cyber/record/file/chunk_codec.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::ChunkBody;
+using apollo::cyber::proto::CompressedChunkBody;
+using apollo::cyber::proto::SectionType;
+using google::protobuf::io::CodedInputStream;
+
+namespace {
+
+bool ParseSection(const char* data, int64_t size,
+                  google::protobuf::Message* message) {
+  if (size < 0 || size > std::numeric_limits<int>::max()) {
+    AERROR << "Section size out of the range of int: " << size;
+    return false;
+  }
+  CodedInputStream coded_input(reinterpret_cast<const uint8_t*>(data),
+                               static_cast<int>(size));
+  // chunk bodies can be larger than the default limit
+  coded_input.SetTotalBytesLimit(std::numeric_limits<int>::max());
+  if (!message->ParseFromCodedStream(&coded_input) ||
+      !coded_input.ConsumedEntireMessage()) {
+    AERROR << "Parse section message failed.";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+RecordFileMmapReader::~RecordFileMmapReader() { Close(); }
+
+bool RecordFileMmapReader::Open(const std::string& path) {
+  Close();
+  path_ = path;
+  int fd = open(path_.data(), O_RDONLY);
+  if (fd < 0) {
+    AERROR << "Open file failed, file: " << path_ << ", errno: " << errno;
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) < 0 || file_stat.st_size == 0) {
+    AERROR << "Stat file failed or file is empty, file: " << path_;
+    close(fd);
+    return false;
+  }
+  void* addr = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid after the descriptor is closed
+  close(fd);
+  if (addr == MAP_FAILED) {
+    AERROR << "Mmap file failed, file: " << path_ << ", errno: " << errno;
+    return false;
+  }
+  // chunks are visited in file order, mostly
+  madvise(addr, file_stat.st_size, MADV_SEQUENTIAL);
+  data_ = static_cast<const char*>(addr);
+  size_ = static_cast<uint64_t>(file_stat.st_size);
+  return true;
+}
+
+void RecordFileMmapReader::Close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+bool RecordFileMmapReader::ReadSection(uint64_t position, Section* section,
+                                       const char** data) const {
+  if (data_ == nullptr || position > size_ ||
+      size_ - position < sizeof(struct Section)) {
+    AERROR << "Section position out of file, position: " << position
+           << ", file size: " << size_;
+    return false;
+  }
+  memcpy(section, data_ + position, sizeof(struct Section));
+  uint64_t begin = position + sizeof(struct Section);
+  if (section->size < 0 ||
+      static_cast<uint64_t>(section->size) > size_ - begin) {
+    AERROR << "Section size out of file, position: " << position
+           << ", size: " << section->size;
+    return false;
+  }
+  *data = data_ + begin;
+  return true;
+}
+
+bool RecordFileMmapReader::ReadChunkBody(uint64_t position,
+                                         ChunkBody* body) const {
+  Section section;
+  const char* data = nullptr;
+  if (!ReadSection(position, &section, &data)) {
+    return false;
+  }
+  if (section.type == SectionType::SECTION_CHUNK_BODY) {
+    return ParseSection(data, section.size, body);
+  }
+  if (section.type != SectionType::SECTION_CHUNK_BODY_COMPRESSED) {
+    AERROR << "Not a chunk body section, type: " << section.type
+           << ", position: " << position;
+    return false;
+  }
+  CompressedChunkBody compressed;
+  if (!ParseSection(data, section.size, &compressed)) {
+    return false;
+  }
+  return DecompressChunkBody(compressed, body);
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_RECORD_FILE_RECORD_FILE_MMAP_READER_H_
+#define CYBER_RECORD_FILE_RECORD_FILE_MMAP_READER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "cyber/proto/record.pb.h"
+
+#include "cyber/record/file/section.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+/**
+ * @class RecordFileMmapReader
+ * @brief Read only mapping of a whole record file. Sections are parsed
+ * straight from the mapping at the positions given by the index, so any
+ * number of threads can read chunks at the same time.
+ */
+class RecordFileMmapReader {
+ public:
+  RecordFileMmapReader() = default;
+  ~RecordFileMmapReader();
+
+  RecordFileMmapReader(const RecordFileMmapReader&) = delete;
+  RecordFileMmapReader& operator=(const RecordFileMmapReader&) = delete;
+
+  bool Open(const std::string& path);
+  void Close();
+
+  const std::string& GetPath() const { return path_; }
+  uint64_t size() const { return size_; }
+
+  /**
+   * @brief Read the section at position, which must be a
+   * SECTION_CHUNK_BODY or a SECTION_CHUNK_BODY_COMPRESSED. Thread safe.
+   */
+  bool ReadChunkBody(uint64_t position, proto::ChunkBody* body) const;
+
+ private:
+  bool ReadSection(uint64_t position, Section* section,
+                   const char** data) const;
+
+  std::string path_;
+  const char* data_ = nullptr;
+  uint64_t size_ = 0;
+};
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_RECORD_FILE_RECORD_FILE_MMAP_READER_H_
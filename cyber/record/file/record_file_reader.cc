@@ -17,6 +17,7 @@
 #include "cyber/record/file/record_file_reader.h"
 
 #include "cyber/common/file.h"
+#include "cyber/record/file/chunk_codec.h"
 
 namespace apollo {
 namespace cyber {
@@ -132,6 +133,22 @@ bool RecordFileReader::ReadSection(Section* section) {
   return true;
 }
 
+bool RecordFileReader::ReadChunkBody(const Section& section,
+                                     proto::ChunkBody* body) {
+  if (section.type == SectionType::SECTION_CHUNK_BODY) {
+    return ReadSection<proto::ChunkBody>(section.size, body);
+  }
+  if (section.type != SectionType::SECTION_CHUNK_BODY_COMPRESSED) {
+    AERROR << "Not a chunk body section, type: " << section.type;
+    return false;
+  }
+  proto::CompressedChunkBody compressed;
+  if (!ReadSection<proto::CompressedChunkBody>(section.size, &compressed)) {
+    return false;
+  }
+  return DecompressChunkBody(compressed, body);
+}
+
 bool RecordFileReader::SkipSection(int64_t size) {
   int64_t pos = CurrentPosition();
   if (size > INT64_MAX - pos) {
@@ -53,6 +53,11 @@ class RecordFileReader : public RecordFileBase {
   bool SkipSection(int64_t size);
   template <typename T>
   bool ReadSection(int64_t size, T* message);
+  /**
+   * @brief Read the body of a SECTION_CHUNK_BODY or
+   * SECTION_CHUNK_BODY_COMPRESSED section, decompressing it if needed.
+   */
+  bool ReadChunkBody(const Section& section, proto::ChunkBody* body);
   bool ReadIndex();
   bool EndOfFile() { return end_of_file_; }
 
@@ -33,6 +33,7 @@ namespace record {
 using apollo::cyber::proto::Channel;
 using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkHeader;
+using apollo::cyber::proto::CompressType;
 using apollo::cyber::proto::Header;
 using apollo::cyber::proto::SectionType;
 using apollo::cyber::proto::SingleMessage;
@@ -308,6 +309,84 @@ TEST(RecordFileTest, TestIndex) {
   }
 }
 
+TEST(RecordFileTest, TestCompressedChunk) {
+  for (auto compress :
+       {CompressType::COMPRESS_LZ4, CompressType::COMPRESS_ZSTD}) {
+    {
+      RecordFileWriter rfw;
+      ASSERT_TRUE(rfw.Open(kTestFile1));
+      Header header = HeaderBuilder::GetHeaderWithChunkParams(0, 0);
+      header.set_compress(compress);
+      ASSERT_TRUE(rfw.WriteHeader(header));
+
+      Channel chan1;
+      chan1.set_name(kChan1);
+      chan1.set_message_type(kMsgType);
+      ASSERT_TRUE(rfw.WriteChannel(chan1));
+      Channel chan2;
+      chan2.set_name(kChan2);
+      chan2.set_message_type(kMsgType);
+      ASSERT_TRUE(rfw.WriteChannel(chan2));
+
+      for (int i = 1; i <= 100; ++i) {
+        SingleMessage msg;
+        msg.set_channel_name(i % 2 == 0 ? kChan2 : kChan1);
+        msg.set_content(std::string(100, static_cast<char>('a' + i % 26)));
+        msg.set_time(i);
+        ASSERT_TRUE(rfw.WriteMessage(msg));
+      }
+      rfw.Close();
+      ASSERT_EQ(compress, rfw.GetHeader().compress());
+    }
+
+    RecordFileReader rfr;
+    ASSERT_TRUE(rfr.Open(kTestFile1));
+    ASSERT_EQ(compress, rfr.GetHeader().compress());
+    ASSERT_TRUE(rfr.ReadIndex());
+    bool indexed = false;
+    for (const auto& row : rfr.GetIndex().indexes()) {
+      if (row.type() == SectionType::SECTION_CHUNK_HEADER) {
+        const auto& cache = row.chunk_header_cache();
+        EXPECT_EQ(compress, cache.compress());
+        ASSERT_EQ(2, cache.channels_size());
+        EXPECT_EQ(kChan1, cache.channels(0));
+        EXPECT_EQ(kChan2, cache.channels(1));
+        indexed = true;
+      }
+    }
+    EXPECT_TRUE(indexed);
+
+    Section sec;
+    ChunkBody body;
+    uint64_t raw_size = 0;
+    while (rfr.ReadSection(&sec)) {
+      if (sec.type == SectionType::SECTION_CHUNK_HEADER) {
+        ChunkHeader chunk_header;
+        ASSERT_TRUE(rfr.ReadSection<ChunkHeader>(sec.size, &chunk_header));
+        EXPECT_EQ(compress, chunk_header.compress());
+        raw_size = chunk_header.raw_size();
+      } else if (sec.type == SectionType::SECTION_CHUNK_BODY_COMPRESSED) {
+        ASSERT_TRUE(rfr.ReadChunkBody(sec, &body));
+        // highly repetitive content
+        EXPECT_LT(static_cast<uint64_t>(sec.size), raw_size);
+        break;
+      } else {
+        ASSERT_NE(SectionType::SECTION_CHUNK_BODY, sec.type);
+        ASSERT_TRUE(rfr.SkipSection(sec.size));
+      }
+    }
+    ASSERT_EQ(100, body.messages_size());
+    for (int i = 1; i <= 100; ++i) {
+      const auto& msg = body.messages(i - 1);
+      EXPECT_EQ(static_cast<uint64_t>(i), msg.time());
+      EXPECT_EQ(std::string(100, static_cast<char>('a' + i % 26)),
+                msg.content());
+    }
+    rfr.Close();
+    ASSERT_FALSE(remove(kTestFile1));
+  }
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
@@ -18,7 +18,10 @@
 
 #include <fcntl.h>
 
+#include <set>
+
 #include "cyber/common/file.h"
+#include "cyber/record/file/chunk_codec.h"
 #include "cyber/time/time.h"
 
 namespace apollo {
@@ -31,11 +34,14 @@ using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkBodyCache;
 using apollo::cyber::proto::ChunkHeader;
 using apollo::cyber::proto::ChunkHeaderCache;
+using apollo::cyber::proto::CompressedChunkBody;
+using apollo::cyber::proto::CompressType;
 using apollo::cyber::proto::Header;
 using apollo::cyber::proto::SectionType;
 using apollo::cyber::proto::SingleIndex;
 
-RecordFileWriter::RecordFileWriter() : is_writing_(false) {}
+RecordFileWriter::RecordFileWriter()
+    : is_writing_(false), compress_type_(CompressType::COMPRESS_NONE) {}
 
 RecordFileWriter::~RecordFileWriter() { Close(); }
 
@@ -53,7 +59,6 @@ bool RecordFileWriter::Open(const std::string& path) {
     return false;
   }
   chunk_active_.reset(new Chunk());
-  chunk_flush_.reset(new Chunk());
   is_writing_ = true;
   flush_thread_ = std::make_shared<std::thread>([this]() { this->Flush(); });
   if (flush_thread_ == nullptr) {
@@ -65,36 +70,15 @@ bool RecordFileWriter::Open(const std::string& path) {
 
 void RecordFileWriter::Close() {
   if (is_writing_) {
-    // wait for the flush operation that may exist now
-    while (1) {
-      {
-        std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-        if (chunk_flush_->empty()) {
-          break;
-        }
-      }
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-
-    // last swap
+    // queue the last chunk, the flush thread drains the queue before leaving
     {
-      std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-      chunk_flush_.swap(chunk_active_);
-      flush_cv_.notify_one();
-    }
-
-    // wait for the last flush operation
-    while (1) {
-      {
-        std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-        if (chunk_flush_->empty()) {
-          break;
-        }
+      std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+      if (!chunk_active_->empty()) {
+        chunk_queue_.emplace_back(std::move(chunk_active_));
+        chunk_active_.reset(new Chunk());
       }
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      is_writing_ = false;
     }
-
-    is_writing_ = false;
     flush_cv_.notify_all();
     if (flush_thread_ && flush_thread_->joinable()) {
       flush_thread_->join();
@@ -120,6 +104,12 @@ void RecordFileWriter::Close() {
 bool RecordFileWriter::WriteHeader(const Header& header) {
   std::lock_guard<std::mutex> lock(mutex_);
   header_ = header;
+  if (!IsCompressSupported(header_.compress())) {
+    AWARN << "Unsupported compress type " << header_.compress()
+          << ", chunks are written uncompressed, file: " << path_;
+    header_.set_compress(CompressType::COMPRESS_NONE);
+  }
+  compress_type_ = header_.compress();
   if (!WriteSection<Header>(header_)) {
     AERROR << "Write header section fail";
     return false;
@@ -170,9 +160,24 @@ bool RecordFileWriter::WriteChannel(const Channel& channel) {
 
 bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
                                   const ChunkBody& chunk_body) {
+  // index the channels and compress before taking the lock, the flush thread
+  // is the only one doing this work
+  std::set<std::string> channels;
+  for (const auto& message : chunk_body.messages()) {
+    channels.insert(message.channel_name());
+  }
+  ChunkHeader header(chunk_header);
+  header.set_compress(compress_type_.load());
+  CompressedChunkBody compressed_body;
+  if (header.compress() != CompressType::COMPRESS_NONE &&
+      !CompressChunkBody(header.compress(), chunk_body, &compressed_body)) {
+    AWARN << "Compress chunk body failed, write it uncompressed.";
+    header.set_compress(CompressType::COMPRESS_NONE);
+  }
+
   std::lock_guard<std::mutex> lock(mutex_);
   uint64_t pos = CurrentPosition();
-  if (!WriteSection<ChunkHeader>(chunk_header)) {
+  if (!WriteSection<ChunkHeader>(header)) {
     AERROR << "Write chunk header fail";
     return false;
   }
@@ -180,26 +185,39 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   single_index->set_type(SectionType::SECTION_CHUNK_HEADER);
   single_index->set_position(pos);
   ChunkHeaderCache* chunk_header_cache = new ChunkHeaderCache();
-  chunk_header_cache->set_begin_time(chunk_header.begin_time());
-  chunk_header_cache->set_end_time(chunk_header.end_time());
-  chunk_header_cache->set_message_number(chunk_header.message_number());
-  chunk_header_cache->set_raw_size(chunk_header.raw_size());
+  chunk_header_cache->set_begin_time(header.begin_time());
+  chunk_header_cache->set_end_time(header.end_time());
+  chunk_header_cache->set_message_number(header.message_number());
+  chunk_header_cache->set_raw_size(header.raw_size());
+  chunk_header_cache->set_compress(header.compress());
+  for (const auto& channel : channels) {
+    chunk_header_cache->add_channels(channel);
+  }
   single_index->set_allocated_chunk_header_cache(chunk_header_cache);
 
   pos = CurrentPosition();
-  if (!WriteSection<ChunkBody>(chunk_body)) {
-    AERROR << "Write chunk body fail";
-    return false;
+  SectionType body_type = SectionType::SECTION_CHUNK_BODY;
+  if (header.compress() == CompressType::COMPRESS_NONE) {
+    if (!WriteSection<ChunkBody>(chunk_body)) {
+      AERROR << "Write chunk body fail";
+      return false;
+    }
+  } else {
+    body_type = SectionType::SECTION_CHUNK_BODY_COMPRESSED;
+    if (!WriteSection<CompressedChunkBody>(compressed_body)) {
+      AERROR << "Write compressed chunk body fail";
+      return false;
+    }
   }
   header_.set_chunk_number(header_.chunk_number() + 1);
   if (header_.begin_time() == 0) {
-    header_.set_begin_time(chunk_header.begin_time());
+    header_.set_begin_time(header.begin_time());
   }
-  header_.set_end_time(chunk_header.end_time());
+  header_.set_end_time(header.end_time());
   header_.set_message_number(header_.message_number() +
-                             chunk_header.message_number());
+                             header.message_number());
   single_index = index_.add_indexes();
-  single_index->set_type(SectionType::SECTION_CHUNK_BODY);
+  single_index->set_type(body_type);
   single_index->set_position(pos);
   ChunkBodyCache* chunk_body_cache = new ChunkBodyCache();
   chunk_body_cache->set_message_number(chunk_body.messages_size());
@@ -209,6 +227,11 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
 
 bool RecordFileWriter::WriteMessage(const proto::SingleMessage& message) {
   chunk_active_->add(message);
+  uint64_t pending = pending_bytes_.fetch_add(message.content().size()) +
+                     message.content().size();
+  if (pending > max_pending_bytes_.load(std::memory_order_relaxed)) {
+    max_pending_bytes_.store(pending, std::memory_order_relaxed);
+  }
   auto it = channel_message_number_map_.find(message.channel_name());
   if (it != channel_message_number_map_.end()) {
     it->second++;
@@ -231,30 +254,81 @@ bool RecordFileWriter::WriteMessage(const proto::SingleMessage& message) {
   }
   {
     std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-    chunk_flush_.swap(chunk_active_);
-    flush_cv_.notify_one();
+    queue_cv_.wait(flush_lock, [this] {
+      return max_queued_chunks_ == 0 ||
+             chunk_queue_.size() < max_queued_chunks_;
+    });
+    chunk_queue_.emplace_back(std::move(chunk_active_));
   }
+  flush_cv_.notify_one();
+  chunk_active_.reset(new Chunk());
   return true;
 }
 
 void RecordFileWriter::Flush() {
-  while (is_writing_) {
-    std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-    flush_cv_.wait(flush_lock,
-                   [this] { return !chunk_flush_->empty() || !is_writing_; });
-    if (!is_writing_) {
-      break;
-    }
-    if (chunk_flush_->empty()) {
-      continue;
+  while (true) {
+    std::unique_ptr<Chunk> chunk;
+    {
+      std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+      flush_cv_.wait(flush_lock,
+                     [this] { return !chunk_queue_.empty() || !is_writing_; });
+      if (chunk_queue_.empty()) {
+        break;
+      }
+      chunk = std::move(chunk_queue_.front());
+      chunk_queue_.pop_front();
     }
-    if (!WriteChunk(chunk_flush_->header_, *(chunk_flush_->body_.get()))) {
+    queue_cv_.notify_one();
+
+    // the writer thread keeps filling chunks meanwhile
+    auto start = Time::MonoTime();
+    if (!WriteChunk(chunk->header_, *(chunk->body_.get()))) {
       AERROR << "Write chunk fail.";
     }
-    chunk_flush_->clear();
+    ReleaseWritten();
+    uint64_t write_time = (Time::MonoTime() - start).ToNanosecond();
+    if (write_time > max_chunk_write_time_.load()) {
+      max_chunk_write_time_.store(write_time);
+    }
+    written_chunks_.fetch_add(1);
+    pending_bytes_.fetch_sub(chunk->header_.raw_size());
   }
 }
 
+void RecordFileWriter::ReleaseWritten() {
+  int64_t end = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    end = CurrentPosition();
+  }
+  if (end <= started_end_) {
+    return;
+  }
+  // start the writeback of the chunk just written
+  sync_file_range(fd_, started_end_, end - started_end_,
+                  SYNC_FILE_RANGE_WRITE);
+  // the previous chunk had a whole chunk write to reach the disk, wait for
+  // the rest and drop its clean pages
+  if (started_end_ > released_end_) {
+    sync_file_range(fd_, released_end_, started_end_ - released_end_,
+                    SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                        SYNC_FILE_RANGE_WAIT_AFTER);
+    posix_fadvise(fd_, released_end_, started_end_ - released_end_,
+                  POSIX_FADV_DONTNEED);
+    released_end_ = started_end_;
+  }
+  started_end_ = end;
+}
+
+WriterStats RecordFileWriter::GetStats() const {
+  WriterStats stats;
+  stats.pending_bytes = pending_bytes_.load();
+  stats.max_pending_bytes = max_pending_bytes_.load();
+  stats.written_chunks = written_chunks_.load();
+  stats.max_chunk_write_time = max_chunk_write_time_.load();
+  return stats;
+}
+
 uint64_t RecordFileWriter::GetMessageNumber(
     const std::string& channel_name) const {
   auto search = channel_message_number_map_.find(channel_name);
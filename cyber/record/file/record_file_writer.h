@@ -17,7 +17,9 @@
 #ifndef CYBER_RECORD_FILE_RECORD_FILE_WRITER_H_
 #define CYBER_RECORD_FILE_RECORD_FILE_WRITER_H_
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -74,6 +76,24 @@ struct Chunk {
   std::unique_ptr<proto::ChunkBody> body_ = nullptr;
 };
 
+struct WriterStats {
+  // message bytes accepted but not in the file yet
+  uint64_t pending_bytes = 0;
+  uint64_t max_pending_bytes = 0;
+  uint64_t written_chunks = 0;
+  // slowest chunk write in nanoseconds, writeback stalls show up here
+  uint64_t max_chunk_write_time = 0;
+  uint64_t dropped_messages = 0;
+};
+
+/**
+ * @brief Messages are gathered in chunks by the caller of WriteMessage and
+ * written by a dedicated flush thread. Full chunks queue up until written,
+ * PendingBytes tells how much is waiting, and the caller only waits for the
+ * disk once the queue holds max_queued_chunks chunks. The flush thread starts
+ * the writeback of every chunk and drops the written pages from the page
+ * cache, which keeps dirty pages from piling up until write() blocks.
+ */
 class RecordFileWriter : public RecordFileBase {
  public:
   RecordFileWriter();
@@ -84,6 +104,16 @@ class RecordFileWriter : public RecordFileBase {
   bool WriteChannel(const proto::Channel& channel);
   bool WriteMessage(const proto::SingleMessage& message);
   uint64_t GetMessageNumber(const std::string& channel_name) const;
+  uint64_t PendingBytes() const { return pending_bytes_.load(); }
+  WriterStats GetStats() const;
+
+  /**
+   * @brief Bound the full chunks waiting for the flush thread, 0 for no bound
+   * when the caller limits the pending bytes itself. Call before Open.
+   */
+  void SetMaxQueuedChunks(uint32_t max_queued_chunks) {
+    max_queued_chunks_ = max_queued_chunks;
+  }
 
  private:
   bool WriteChunk(const proto::ChunkHeader& chunk_header,
@@ -92,12 +122,28 @@ class RecordFileWriter : public RecordFileBase {
   bool WriteSection(const T& message);
   bool WriteIndex();
   void Flush();
+  void ReleaseWritten();
   std::atomic_bool is_writing_;
+  // chunk body compression, done on the flush thread
+  std::atomic<proto::CompressType> compress_type_;
   std::unique_ptr<Chunk> chunk_active_ = nullptr;
-  std::unique_ptr<Chunk> chunk_flush_ = nullptr;
+  // full chunks, oldest first
+  std::deque<std::unique_ptr<Chunk>> chunk_queue_;
+  // as many as the active and the flushing chunk of the former writer
+  uint32_t max_queued_chunks_ = 2;
   std::shared_ptr<std::thread> flush_thread_ = nullptr;
   std::mutex flush_mutex_;
   std::condition_variable flush_cv_;
+  // signaled when the flush thread takes a chunk off the queue
+  std::condition_variable queue_cv_;
+  std::atomic<uint64_t> pending_bytes_ = {0};
+  std::atomic<uint64_t> max_pending_bytes_ = {0};
+  std::atomic<uint64_t> written_chunks_ = {0};
+  std::atomic<uint64_t> max_chunk_write_time_ = {0};
+  // end of the file range whose writeback was started, and released from the
+  // page cache
+  int64_t started_end_ = 0;
+  int64_t released_end_ = 0;
   std::unordered_map<std::string, uint64_t> channel_message_number_map_;
 };
 
@@ -108,6 +154,8 @@ bool RecordFileWriter::WriteSection(const T& message) {
     type = proto::SectionType::SECTION_CHUNK_HEADER;
   } else if (std::is_same<T, proto::ChunkBody>::value) {
     type = proto::SectionType::SECTION_CHUNK_BODY;
+  } else if (std::is_same<T, proto::CompressedChunkBody>::value) {
+    type = proto::SectionType::SECTION_CHUNK_BODY_COMPRESSED;
   } else if (std::is_same<T, proto::Channel>::value) {
     type = proto::SectionType::SECTION_CHANNEL;
   } else if (std::is_same<T, proto::Header>::value) {
@@ -16,6 +16,7 @@
 
 #include "cyber/record/record_reader.h"
 
+#include <algorithm>
 #include <utility>
 
 namespace apollo {
@@ -27,7 +28,10 @@ using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkHeader;
 using apollo::cyber::proto::SectionType;
 
-RecordReader::~RecordReader() {}
+RecordReader::~RecordReader() {
+  // decoding tasks hold their own reference to the mapping
+  DropPrefetched();
+}
 
 RecordReader::RecordReader(const std::string& file) {
   file_reader_.reset(new RecordFileReader());
@@ -53,14 +57,51 @@ RecordReader::RecordReader(const std::string& file) {
       channel_info_.insert(
           std::make_pair(channel_cache->name(), *channel_cache));
     }
+    BuildChunkIndex();
   }
   file_reader_->Reset();
 }
 
+void RecordReader::BuildChunkIndex() {
+  for (const auto& single_idx : index_.indexes()) {
+    switch (single_idx.type()) {
+      case SectionType::SECTION_CHUNK_HEADER: {
+        if (!single_idx.has_chunk_header_cache()) {
+          AWARN << "Chunk header index without cache, read sequentially.";
+          chunk_index_.clear();
+          return;
+        }
+        ChunkEntry entry;
+        entry.header = &single_idx.chunk_header_cache();
+        chunk_index_.push_back(entry);
+        break;
+      }
+      case SectionType::SECTION_CHUNK_BODY:
+      case SectionType::SECTION_CHUNK_BODY_COMPRESSED: {
+        if (chunk_index_.empty() || chunk_index_.back().body_position != 0) {
+          AWARN << "Chunk body index without header, read sequentially.";
+          chunk_index_.clear();
+          return;
+        }
+        chunk_index_.back().body_position = single_idx.position();
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  if (!chunk_index_.empty() && chunk_index_.back().body_position == 0) {
+    chunk_index_.clear();
+  }
+}
+
 void RecordReader::Reset() {
   file_reader_->Reset();
   reach_end_ = false;
   message_index_ = 0;
+  next_chunk_ = 0;
+  DropPrefetched();
+  prefetch_next_ = 0;
   chunk_.reset(new ChunkBody());
 }
 
@@ -73,7 +114,8 @@ std::set<std::string> RecordReader::GetChannelList() const {
 }
 
 bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
-                               uint64_t end_time) {
+                               uint64_t end_time,
+                               const std::set<std::string>& channels) {
   if (!is_valid_) {
     return false;
   }
@@ -92,6 +134,9 @@ bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
     if (time < begin_time) {
       continue;
     }
+    if (!channels.empty() && channels.count(next_message.channel_name()) == 0) {
+      continue;
+    }
 
     message->channel_name = next_message.channel_name();
     message->content = next_message.content();
@@ -100,10 +145,13 @@ bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
   }
 
   ADEBUG << "Read next chunk.";
-  if (ReadNextChunk(begin_time, end_time)) {
+  bool has_chunk = chunk_index_.empty()
+                       ? ReadNextChunk(begin_time, end_time)
+                       : ReadNextIndexedChunk(begin_time, end_time, channels);
+  if (has_chunk) {
     ADEBUG << "Read chunk successfully.";
     message_index_ = 0;
-    return ReadMessage(message, begin_time, end_time);
+    return ReadMessage(message, begin_time, end_time, channels);
   }
   ADEBUG << "No chunk to read.";
   return false;
@@ -147,7 +195,8 @@ bool RecordReader::ReadNextChunk(uint64_t begin_time, uint64_t end_time) {
         }
         break;
       }
-      case SectionType::SECTION_CHUNK_BODY: {
+      case SectionType::SECTION_CHUNK_BODY:
+      case SectionType::SECTION_CHUNK_BODY_COMPRESSED: {
         if (skip_next_chunk_body) {
           file_reader_->SkipSection(section.size);
           skip_next_chunk_body = false;
@@ -155,7 +204,7 @@ bool RecordReader::ReadNextChunk(uint64_t begin_time, uint64_t end_time) {
         }
 
         chunk_.reset(new ChunkBody());
-        if (!file_reader_->ReadSection<ChunkBody>(section.size, chunk_.get())) {
+        if (!file_reader_->ReadChunkBody(section, chunk_.get())) {
           AERROR << "Failed to read chunk body section.";
           return false;
         }
@@ -171,6 +220,157 @@ bool RecordReader::ReadNextChunk(uint64_t begin_time, uint64_t end_time) {
   return false;
 }
 
+bool RecordReader::ChunkMatches(const ChunkEntry& entry, uint64_t begin_time,
+                                const std::set<std::string>& channels) const {
+  if (entry.header->end_time() < begin_time) {
+    return false;
+  }
+  // files written before the channel list was indexed have none
+  if (channels.empty() || entry.header->channels_size() == 0) {
+    return true;
+  }
+  return std::any_of(entry.header->channels().begin(),
+                     entry.header->channels().end(),
+                     [&channels](const std::string& channel) {
+                       return channels.count(channel) > 0;
+                     });
+}
+
+bool RecordReader::ReadNextIndexedChunk(
+    uint64_t begin_time, uint64_t end_time,
+    const std::set<std::string>& channels) {
+  while (next_chunk_ < chunk_index_.size()) {
+    const auto& entry = chunk_index_[next_chunk_];
+    if (entry.header->begin_time() > end_time) {
+      return false;
+    }
+    size_t chunk = next_chunk_++;
+    if (!ChunkMatches(entry, begin_time, channels)) {
+      continue;
+    }
+
+    if (mmap_reader_ != nullptr) {
+      // keep the pool busy with the next chunks while this one is taken
+      Prefetch(begin_time, channels);
+      return TakePrefetchedChunk(chunk);
+    }
+
+    if (!file_reader_->SetPosition(entry.body_position)) {
+      AERROR << "Failed to seek to chunk body, file: "
+             << file_reader_->GetPath();
+      return false;
+    }
+    Section section;
+    if (!file_reader_->ReadSection(&section)) {
+      AERROR << "Failed to read section, file: " << file_reader_->GetPath();
+      return false;
+    }
+    chunk_.reset(new ChunkBody());
+    if (!file_reader_->ReadChunkBody(section, chunk_.get())) {
+      AERROR << "Failed to read chunk body section.";
+      return false;
+    }
+    return true;
+  }
+  reach_end_ = true;
+  return false;
+}
+
+bool RecordReader::EnableParallelRead(
+    const std::shared_ptr<base::ThreadPool>& pool, uint32_t prefetch_chunks) {
+  if (pool == nullptr || prefetch_chunks == 0) {
+    AERROR << "Parallel read needs a thread pool and a prefetch window.";
+    return false;
+  }
+  if (chunk_index_.empty()) {
+    AWARN << "No chunk index, read sequentially, file: "
+          << file_reader_->GetPath();
+    return false;
+  }
+  auto mmap_reader = std::make_shared<RecordFileMmapReader>();
+  if (!mmap_reader->Open(file_reader_->GetPath())) {
+    AERROR << "Failed to map record file: " << file_reader_->GetPath();
+    return false;
+  }
+  mmap_reader_ = mmap_reader;
+  pool_ = pool;
+  prefetch_chunks_ = prefetch_chunks;
+  DropPrefetched();
+  prefetch_next_ = next_chunk_;
+  return true;
+}
+
+void RecordReader::Prefetch(uint64_t begin_time,
+                            const std::set<std::string>& channels) {
+  prefetch_next_ = std::max(prefetch_next_, next_chunk_);
+  while (prefetched_.size() < prefetch_chunks_ &&
+         prefetch_next_ < chunk_index_.size()) {
+    size_t chunk = prefetch_next_++;
+    const auto& entry = chunk_index_[chunk];
+    if (!ChunkMatches(entry, begin_time, channels)) {
+      continue;
+    }
+    // the task keeps the mapping alive if the reader goes away first
+    auto mmap_reader = mmap_reader_;
+    uint64_t position = entry.body_position;
+    auto canceled = std::make_shared<std::atomic<bool>>(false);
+    auto future = pool_->Enqueue([mmap_reader, position, canceled]() {
+      std::unique_ptr<ChunkBody> body;
+      if (canceled->load()) {
+        return body;
+      }
+      body.reset(new ChunkBody());
+      if (!mmap_reader->ReadChunkBody(position, body.get())) {
+        body.reset();
+      }
+      return body;
+    });
+    if (!future.valid()) {
+      // the pool is stopped or its queue is full, try again on the next
+      // read, the chunk is decoded in place if it is never queued
+      --prefetch_next_;
+      break;
+    }
+    PrefetchedChunk prefetched;
+    prefetched.chunk = chunk;
+    prefetched.canceled = canceled;
+    prefetched.body = std::move(future);
+    prefetched_.emplace_back(std::move(prefetched));
+  }
+}
+
+void RecordReader::DropPrefetched() {
+  for (auto& prefetched : prefetched_) {
+    prefetched.canceled->store(true);
+  }
+  prefetched_.clear();
+}
+
+bool RecordReader::TakePrefetchedChunk(size_t chunk) {
+  // chunks prefetched for an earlier time range or other channels
+  while (!prefetched_.empty() && prefetched_.front().chunk < chunk) {
+    prefetched_.front().canceled->store(true);
+    prefetched_.pop_front();
+  }
+  std::unique_ptr<ChunkBody> body;
+  if (!prefetched_.empty() && prefetched_.front().chunk == chunk) {
+    body = prefetched_.front().body.get();
+    prefetched_.pop_front();
+  } else {
+    body.reset(new ChunkBody());
+    if (!mmap_reader_->ReadChunkBody(chunk_index_[chunk].body_position,
+                                     body.get())) {
+      body.reset();
+    }
+  }
+  if (body == nullptr) {
+    AERROR << "Failed to read chunk body, file: " << mmap_reader_->GetPath();
+    return false;
+  }
+  chunk_ = std::move(body);
+  return true;
+}
+
 uint64_t RecordReader::GetMessageNumber(const std::string& channel_name) const {
   auto search = channel_info_.find(channel_name);
   if (search == channel_info_.end()) {
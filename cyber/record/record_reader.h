@@ -17,14 +17,21 @@
 #ifndef CYBER_RECORD_RECORD_READER_H_
 #define CYBER_RECORD_RECORD_READER_H_
 
+#include <atomic>
+#include <deque>
+#include <future>
 #include <limits>
 #include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "cyber/proto/record.pb.h"
 
+#include "cyber/base/thread_pool.h"
+#include "cyber/record/file/record_file_mmap_reader.h"
 #include "cyber/record/file/record_file_reader.h"
 #include "cyber/record/record_base.h"
 #include "cyber/record/record_message.h"
@@ -63,14 +70,37 @@ class RecordReader : public RecordBase {
   /**
    * @brief Read one message from reader.
    *
+   * With a complete record file the chunk index is used to jump over the
+   * chunks ending before begin_time and the chunks without any of the
+   * channels, without reading them.
+   *
    * @param message
    * @param begin_time
    * @param end_time
+   * @param channels only read messages of these channels, all if empty
    *
    * @return True for success, false for not.
    */
   bool ReadMessage(RecordMessage* message, uint64_t begin_time = 0,
-                   uint64_t end_time = std::numeric_limits<uint64_t>::max());
+                   uint64_t end_time = std::numeric_limits<uint64_t>::max(),
+                   const std::set<std::string>& channels = {});
+
+  /**
+   * @brief Map the record file and decode up to prefetch_chunks chunks ahead
+   * of the reading position on the thread pool. Only possible with a
+   * complete record file, whose index lists the chunks.
+   *
+   * Chunks the pool can not queue are decoded in place when they are read,
+   * so the pool should be able to queue prefetch_chunks tasks for every
+   * reader sharing it.
+   *
+   * @param pool
+   * @param prefetch_chunks
+   *
+   * @return True for success, false if the reader stays sequential.
+   */
+  bool EnableParallelRead(const std::shared_ptr<base::ThreadPool>& pool,
+                          uint32_t prefetch_chunks);
 
   /**
    * @brief Reset the message index of record reader.
@@ -114,13 +144,42 @@ class RecordReader : public RecordBase {
   std::set<std::string> GetChannelList() const override;
 
  private:
+  struct ChunkEntry {
+    const proto::ChunkHeaderCache* header = nullptr;
+    uint64_t body_position = 0;
+  };
+
   bool ReadNextChunk(uint64_t begin_time, uint64_t end_time);
+  bool ReadNextIndexedChunk(uint64_t begin_time, uint64_t end_time,
+                            const std::set<std::string>& channels);
+  bool ChunkMatches(const ChunkEntry& entry, uint64_t begin_time,
+                    const std::set<std::string>& channels) const;
+  void BuildChunkIndex();
+  void Prefetch(uint64_t begin_time, const std::set<std::string>& channels);
+  bool TakePrefetchedChunk(size_t chunk);
+  void DropPrefetched();
+
+  struct PrefetchedChunk {
+    size_t chunk;
+    // set when the chunk is no longer wanted, the task skips the decoding
+    std::shared_ptr<std::atomic<bool>> canceled;
+    std::future<std::unique_ptr<proto::ChunkBody>> body;
+  };
 
   bool is_valid_ = false;
   bool reach_end_ = false;
   std::unique_ptr<proto::ChunkBody> chunk_ = nullptr;
   proto::Index index_;
   int message_index_ = 0;
+  // chunks in file order, empty if the file has no usable index
+  std::vector<ChunkEntry> chunk_index_;
+  size_t next_chunk_ = 0;
+  // parallel read, chunk index and decoded body of the chunks decoded ahead
+  std::shared_ptr<RecordFileMmapReader> mmap_reader_ = nullptr;
+  std::shared_ptr<base::ThreadPool> pool_ = nullptr;
+  uint32_t prefetch_chunks_ = 0;
+  size_t prefetch_next_ = 0;
+  std::deque<PrefetchedChunk> prefetched_;
   ChannelInfoMap channel_info_;
   FileReaderPtr file_reader_;
 };
@@ -16,7 +16,11 @@
 
 #include "cyber/record/record_reader.h"
 
+#include <chrono>
+#include <memory>
+#include <set>
 #include <string>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -29,6 +33,8 @@ namespace record {
 using apollo::cyber::message::RawMessage;
 
 constexpr char kChannelName1[] = "/test/channel1";
+constexpr char kChannelName2[] = "/test/channel2";
+constexpr char kChannelName3[] = "/test/channel3";
 constexpr char kMessageType1[] = "apollo.cyber.proto.Test";
 constexpr char kProtoDesc[] = "1234567890";
 constexpr char kStr10B[] = "1234567890";
@@ -122,6 +128,133 @@ TEST(RecordTest, TestReaderOrder) {
   ASSERT_FALSE(remove(kTestFile));
 }
 
+TEST(RecordTest, TestIndexedRead) {
+  // 1ms per message, a chunk every 10ms, channel2 only in the second half
+  proto::Header header = HeaderBuilder::GetHeaderWithChunkParams(10000000, 0);
+  header.set_compress(proto::CompressType::COMPRESS_LZ4);
+  RecordWriter writer(header);
+  writer.SetSizeOfFileSegmentation(0);
+  writer.SetIntervalOfFileSegmentation(0);
+  ASSERT_TRUE(writer.Open(kTestFile));
+  writer.WriteChannel(kChannelName1, kMessageType1, kProtoDesc);
+  writer.WriteChannel(kChannelName2, kMessageType1, kProtoDesc);
+  const uint64_t total = 200;
+  for (uint64_t i = 1; i <= total; ++i) {
+    auto msg = std::make_shared<RawMessage>(std::to_string(i));
+    const char* channel =
+        i > total / 2 && i % 4 == 0 ? kChannelName2 : kChannelName1;
+    writer.WriteMessage(channel, msg, i * 1000000);
+    // let the flush thread write every chunk on its own
+    if (i % 10 == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+  writer.Close();
+
+  RecordReader reader(kTestFile);
+  ASSERT_TRUE(reader.IsValid());
+  EXPECT_EQ(proto::CompressType::COMPRESS_LZ4, reader.GetHeader().compress());
+  RecordMessage message;
+
+  // seek to a time range
+  const uint64_t begin = 150 * 1000000;
+  const uint64_t end = 160 * 1000000;
+  uint64_t count = 0;
+  while (reader.ReadMessage(&message, begin, end)) {
+    ASSERT_EQ(begin + count * 1000000, message.time);
+    ASSERT_EQ(std::to_string(150 + count), message.content);
+    ++count;
+  }
+  EXPECT_EQ(11, count);
+
+  // a single channel
+  reader.Reset();
+  count = 0;
+  std::set<std::string> channels = {kChannelName2};
+  while (reader.ReadMessage(&message, 0, UINT64_MAX, channels)) {
+    ASSERT_EQ(kChannelName2, message.channel_name);
+    ASSERT_GT(message.time, total / 2 * 1000000);
+    ++count;
+  }
+  EXPECT_EQ(total / 2 / 4, count);
+
+  // everything, in order
+  reader.Reset();
+  count = 0;
+  while (reader.ReadMessage(&message)) {
+    ++count;
+    ASSERT_EQ(count * 1000000, message.time);
+  }
+  EXPECT_EQ(total, count);
+
+  // a pool that can not queue the prefetch window, the chunks it drops are
+  // decoded in place, also after a reset in the middle of the file
+  auto pool = std::make_shared<base::ThreadPool>(1, 1);
+  ASSERT_TRUE(reader.EnableParallelRead(pool, 8));
+  for (uint64_t stop : {total / 2, total}) {
+    reader.Reset();
+    count = 0;
+    while (count < stop && reader.ReadMessage(&message)) {
+      ++count;
+      ASSERT_EQ(count * 1000000, message.time);
+      ASSERT_EQ(std::to_string(count), message.content);
+    }
+    EXPECT_EQ(stop, count);
+  }
+  ASSERT_FALSE(remove(kTestFile));
+}
+
+TEST(RecordTest, TestWriteBufferDrop) {
+  // no chunk is flushed before Close, every message stays pending
+  proto::Header header = HeaderBuilder::GetHeaderWithChunkParams(0, 0);
+  RecordWriter writer(header);
+  writer.SetSizeOfFileSegmentation(0);
+  writer.SetIntervalOfFileSegmentation(0);
+  ASSERT_TRUE(writer.SetWriteBufferSize(1000));
+  writer.SetChannelPriority(kChannelName1, ChannelPriority::LOW);
+  writer.SetChannelPriority(kChannelName2, ChannelPriority::HIGH);
+  ASSERT_TRUE(writer.Open(kTestFile));
+  ASSERT_FALSE(writer.SetWriteBufferSize(0));
+  writer.WriteChannel(kChannelName1, kMessageType1, kProtoDesc);
+  writer.WriteChannel(kChannelName2, kMessageType1, kProtoDesc);
+  writer.WriteChannel(kChannelName3, kMessageType1, kProtoDesc);
+
+  const std::string content(100, 'x');
+  uint64_t time = 0;
+  // low priority up to 500 bytes, normal up to 750, high up to 1000
+  for (const char* channel : {kChannelName1, kChannelName3, kChannelName2}) {
+    for (int i = 0; i < 10; ++i) {
+      writer.WriteMessage(channel, std::make_shared<RawMessage>(content),
+                          ++time);
+    }
+  }
+  EXPECT_EQ(5, writer.GetMessageNumber(kChannelName1));
+  EXPECT_EQ(5, writer.GetDroppedMessageNumber(kChannelName1));
+  EXPECT_EQ(2, writer.GetMessageNumber(kChannelName3));
+  EXPECT_EQ(8, writer.GetDroppedMessageNumber(kChannelName3));
+  EXPECT_EQ(3, writer.GetMessageNumber(kChannelName2));
+  EXPECT_EQ(7, writer.GetDroppedMessageNumber(kChannelName2));
+
+  auto stats = writer.GetWriterStats();
+  EXPECT_EQ(1000, stats.pending_bytes);
+  EXPECT_EQ(20, stats.dropped_messages);
+  writer.Close();
+  stats = writer.GetWriterStats();
+  EXPECT_EQ(0, stats.pending_bytes);
+  EXPECT_EQ(1000, stats.max_pending_bytes);
+  EXPECT_EQ(1, stats.written_chunks);
+
+  // everything accepted was written on Close
+  RecordReader reader(kTestFile);
+  RecordMessage message;
+  uint64_t count = 0;
+  while (reader.ReadMessage(&message)) {
+    ++count;
+  }
+  EXPECT_EQ(10, count);
+  ASSERT_FALSE(remove(kTestFile));
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
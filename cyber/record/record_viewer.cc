@@ -74,6 +74,24 @@ bool RecordViewer::Update(RecordMessage* message) {
   return find;
 }
 
+size_t RecordViewer::EnableParallelRead(uint32_t thread_num,
+                                        uint32_t prefetch_chunks) {
+  if (thread_num == 0 || prefetch_chunks == 0) {
+    return 0;
+  }
+  // room for the whole prefetch window of every reader
+  pool_ = std::make_shared<base::ThreadPool>(
+      thread_num, readers_.size() * prefetch_chunks + 1);
+  size_t parallel = 0;
+  for (auto& reader : readers_) {
+    if (reader->IsValid() &&
+        reader->EnableParallelRead(pool_, prefetch_chunks)) {
+      ++parallel;
+    }
+  }
+  return parallel;
+}
+
 RecordViewer::Iterator RecordViewer::begin() { return Iterator(this); }
 
 RecordViewer::Iterator RecordViewer::end() { return Iterator(this, true); }
@@ -165,7 +183,7 @@ bool RecordViewer::FillBuffer() {
       while (true) {
         auto record_msg = std::make_shared<RecordMessage>();
         if (!reader->ReadMessage(record_msg.get(), this_begin_time,
-                                 this_end_time)) {
+                                 this_end_time, channels_)) {
           break;
         }
         msg_buffer_.emplace(std::make_pair(record_msg->time, record_msg));
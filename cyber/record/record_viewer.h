@@ -92,6 +92,19 @@ class RecordViewer {
    */
   std::set<std::string> GetChannelList() const { return channel_list_; }
 
+  /**
+   * @brief Decode the chunks of all readers on a pool of thread_num threads,
+   * up to prefetch_chunks chunks ahead for every reader. The messages are
+   * still iterated in timestamp order. Call before iterating.
+   *
+   * @param thread_num
+   * @param prefetch_chunks
+   *
+   * @return Number of readers reading in parallel, the others (incomplete
+   * files) stay sequential.
+   */
+  size_t EnableParallelRead(uint32_t thread_num, uint32_t prefetch_chunks = 4);
+
   /**
    * @brief The iterator.
    */
@@ -202,6 +215,7 @@ class RecordViewer {
   std::set<std::string> channel_list_;
   std::vector<RecordReaderPtr> readers_;
   std::vector<bool> readers_finished_;
+  std::shared_ptr<base::ThreadPool> pool_ = nullptr;
 
   uint64_t curr_begin_time_ = 0;
   std::multimap<uint64_t, std::shared_ptr<RecordMessage>> msg_buffer_;
@@ -20,8 +20,11 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -224,6 +227,68 @@ TEST(RecordTest, mult_iterator_test) {
   ASSERT_FALSE(remove(kTestFile));
 }
 
+TEST(RecordTest, parallel_read) {
+  // two files with interleaved timestamps and a chunk every 20ms
+  const uint64_t msg_num = 500;
+  const uint64_t step_time = 2000000;  // 2ms
+  const std::vector<std::string> files = {"viewer_test_even.record",
+                                          "viewer_test_odd.record"};
+  for (uint64_t f = 0; f < files.size(); ++f) {
+    auto header = HeaderBuilder::GetHeaderWithChunkParams(20000000, 0);
+    header.set_compress(proto::CompressType::COMPRESS_ZSTD);
+    RecordWriter writer(header);
+    writer.SetSizeOfFileSegmentation(0);
+    writer.SetIntervalOfFileSegmentation(0);
+    ASSERT_TRUE(writer.Open(files[f]));
+    writer.WriteChannel(kChannelName1, kMessageType1, kProtoDesc1);
+    for (uint64_t i = 0; i < msg_num; ++i) {
+      uint64_t time = step_time + i * step_time + f * step_time / 2;
+      auto msg = std::make_shared<RawMessage>(std::to_string(time));
+      writer.WriteMessage(kChannelName1, msg, time);
+      if (i % 10 == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      }
+    }
+    writer.Close();
+  }
+
+  std::vector<RecordViewer::RecordReaderPtr> readers;
+  for (const auto& file : files) {
+    readers.emplace_back(std::make_shared<RecordReader>(file));
+    ASSERT_GT(readers.back()->GetHeader().chunk_number(), 1);
+  }
+  RecordViewer viewer(readers);
+  EXPECT_EQ(files.size(), viewer.EnableParallelRead(4, 4));
+
+  // twice, the iterator resets the readers
+  for (int round = 0; round < 2; ++round) {
+    uint64_t count = 0;
+    uint64_t last_time = 0;
+    for (auto& msg : viewer) {
+      EXPECT_GT(msg.time, last_time);
+      EXPECT_EQ(std::to_string(msg.time), msg.content);
+      last_time = msg.time;
+      ++count;
+    }
+    EXPECT_EQ(msg_num * files.size(), count);
+  }
+
+  // a time range in the middle
+  RecordViewer range_viewer(readers, 400000000, 600000000);
+  range_viewer.EnableParallelRead(2, 2);
+  uint64_t count = 0;
+  for (auto& msg : range_viewer) {
+    EXPECT_GE(msg.time, 400000000);
+    EXPECT_LE(msg.time, 600000000);
+    ++count;
+  }
+  EXPECT_EQ(201, count);
+
+  for (const auto& file : files) {
+    ASSERT_FALSE(remove(file.c_str()));
+  }
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
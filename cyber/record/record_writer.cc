@@ -16,6 +16,7 @@
 
 #include "cyber/record/record_writer.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
@@ -49,6 +50,10 @@ bool RecordWriter::Open(const std::string& file) {
     path_ = file_;
   }
   file_writer_.reset(new RecordFileWriter());
+  if (write_buffer_size_ > 0) {
+    // messages are dropped by priority instead of waiting for the disk
+    file_writer_->SetMaxQueuedChunks(0);
+  }
   if (!file_writer_->Open(path_)) {
     AERROR << "Failed to open output record file: " << path_;
     return false;
@@ -63,6 +68,9 @@ bool RecordWriter::Open(const std::string& file) {
 }
 
 void RecordWriter::Close() {
+  if (close_thread_.joinable()) {
+    close_thread_.join();
+  }
   if (is_opened_) {
     file_writer_->Close();
     is_opened_ = false;
@@ -71,6 +79,10 @@ void RecordWriter::Close() {
 
 bool RecordWriter::SplitOutfile() {
   file_writer_.reset(new RecordFileWriter());
+  if (write_buffer_size_ > 0) {
+    // messages are dropped by priority instead of waiting for the disk
+    file_writer_->SetMaxQueuedChunks(0);
+  }
   if (file_index_ > 99999) {
     AWARN << "More than 99999 record files had been recored, will restart "
           << "counting from 0.";
@@ -125,8 +137,41 @@ bool RecordWriter::WriteChannel(const std::string& channel_name,
   return true;
 }
 
+bool RecordWriter::Admit(const SingleMessage& message) {
+  if (write_buffer_size_ == 0) {
+    return true;
+  }
+  uint64_t pending = file_writer_->PendingBytes();
+  if (file_writer_backup_ != nullptr) {
+    pending += file_writer_backup_->PendingBytes();
+  }
+  pending += message.content().size();
+  ChannelPriority priority = ChannelPriority::NORMAL;
+  auto search = channel_priority_map_.find(message.channel_name());
+  if (search != channel_priority_map_.end()) {
+    priority = search->second;
+  }
+  uint64_t limit = write_buffer_size_;
+  if (priority == ChannelPriority::LOW) {
+    limit = write_buffer_size_ / 2;
+  } else if (priority == ChannelPriority::NORMAL) {
+    limit = write_buffer_size_ / 4 * 3;
+  }
+  if (pending <= limit) {
+    return true;
+  }
+  ++channel_dropped_number_map_[message.channel_name()];
+  ++stats_.dropped_messages;
+  AWARN_EVERY(100) << "Write buffer full, " << pending << " bytes pending, "
+                   << "drop message of channel: " << message.channel_name();
+  return false;
+}
+
 bool RecordWriter::WriteMessage(const SingleMessage& message) {
   std::lock_guard<std::mutex> lg(mutex_);
+  if (!Admit(message)) {
+    return false;
+  }
   OnNewMessage(message.channel_name());
   if (!file_writer_->WriteMessage(message)) {
     AERROR << "Write message is failed.";
@@ -145,8 +190,16 @@ bool RecordWriter::WriteMessage(const SingleMessage& message) {
        message.time() - segment_begin_time_ > header_.segment_interval()) ||
       (header_.segment_raw_size() > 0 &&
        segment_raw_size_ > header_.segment_raw_size())) {
+    if (close_thread_.joinable()) {
+      close_thread_.join();
+    }
+    if (file_writer_backup_ != nullptr) {
+      MergeStats(*file_writer_backup_);
+    }
     file_writer_backup_.swap(file_writer_);
-    file_writer_backup_->Close();
+    // writing the rest of the segment can take a while
+    close_thread_ = std::thread(
+        [writer = file_writer_backup_.get()]() { writer->Close(); });
     if (!SplitOutfile()) {
       AERROR << "Split out file is failed.";
       return false;
@@ -173,6 +226,57 @@ bool RecordWriter::SetIntervalOfFileSegmentation(uint64_t time_sec) {
   return true;
 }
 
+bool RecordWriter::SetWriteBufferSize(uint64_t size_bytes) {
+  if (is_opened_) {
+    AWARN << "Please call this interface before opening file.";
+    return false;
+  }
+  write_buffer_size_ = size_bytes;
+  return true;
+}
+
+void RecordWriter::SetChannelPriority(const std::string& channel_name,
+                                      ChannelPriority priority) {
+  std::lock_guard<std::mutex> lg(mutex_);
+  channel_priority_map_[channel_name] = priority;
+}
+
+uint64_t RecordWriter::GetDroppedMessageNumber(
+    const std::string& channel_name) const {
+  auto search = channel_dropped_number_map_.find(channel_name);
+  if (search != channel_dropped_number_map_.end()) {
+    return search->second;
+  }
+  return 0;
+}
+
+void RecordWriter::MergeStats(const RecordFileWriter& writer) {
+  auto stats = writer.GetStats();
+  stats_.max_pending_bytes =
+      std::max(stats_.max_pending_bytes, stats.max_pending_bytes);
+  stats_.written_chunks += stats.written_chunks;
+  stats_.max_chunk_write_time =
+      std::max(stats_.max_chunk_write_time, stats.max_chunk_write_time);
+}
+
+WriterStats RecordWriter::GetWriterStats() {
+  std::lock_guard<std::mutex> lg(mutex_);
+  WriterStats stats = stats_;
+  for (const auto* writer : {file_writer_.get(), file_writer_backup_.get()}) {
+    if (writer == nullptr) {
+      continue;
+    }
+    auto file_stats = writer->GetStats();
+    stats.pending_bytes += file_stats.pending_bytes;
+    stats.max_pending_bytes =
+        std::max(stats.max_pending_bytes, file_stats.max_pending_bytes);
+    stats.written_chunks += file_stats.written_chunks;
+    stats.max_chunk_write_time =
+        std::max(stats.max_chunk_write_time, file_stats.max_chunk_write_time);
+  }
+  return stats;
+}
+
 bool RecordWriter::IsNewChannel(const std::string& channel_name) const {
   return channel_message_number_map_.find(channel_name) ==
          channel_message_number_map_.end();
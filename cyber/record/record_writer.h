@@ -23,6 +23,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include "cyber/proto/record.pb.h"
@@ -38,6 +39,14 @@ namespace apollo {
 namespace cyber {
 namespace record {
 
+/**
+ * @brief Order in which channels lose messages when the write buffer of a
+ * RecordWriter is full. LOW channels are dropped from half of the buffer
+ * size on, NORMAL ones from three quarters and HIGH ones only when the
+ * buffer is full.
+ */
+enum class ChannelPriority { LOW = 0, NORMAL = 1, HIGH = 2 };
+
 /**
  * @brief The record writer.
  */
@@ -126,6 +135,43 @@ class RecordWriter : public RecordBase {
    */
   bool SetIntervalOfFileSegmentation(uint64_t time_sec);
 
+  /**
+   * @brief Bound the memory of the messages waiting to be written. Messages
+   * are dropped by channel priority when the disk does not keep up. With 0,
+   * the default, WriteMessage waits for the disk once two full chunks are
+   * queued instead.
+   *
+   * @param size_bytes
+   *
+   * @return True for success, false for fail.
+   */
+  bool SetWriteBufferSize(uint64_t size_bytes);
+
+  /**
+   * @brief Set the priority of a channel, NORMAL by default.
+   *
+   * @param channel_name
+   * @param priority
+   */
+  void SetChannelPriority(const std::string& channel_name,
+                          ChannelPriority priority);
+
+  /**
+   * @brief Get the number of messages dropped by channel name.
+   *
+   * @param channel_name
+   *
+   * @return Dropped message number.
+   */
+  uint64_t GetDroppedMessageNumber(const std::string& channel_name) const;
+
+  /**
+   * @brief Get the write buffer statistics since the record was opened.
+   *
+   * @return Writer statistics.
+   */
+  WriterStats GetWriterStats();
+
   /**
    * @brief Get message number by channel name.
    *
@@ -172,6 +218,8 @@ class RecordWriter : public RecordBase {
  private:
   bool WriteMessage(const proto::SingleMessage& single_msg);
   bool SplitOutfile();
+  bool Admit(const proto::SingleMessage& message);
+  void MergeStats(const RecordFileWriter& writer);
   void OnNewChannel(const std::string& channel_name,
                     const std::string& message_type,
                     const std::string& proto_desc);
@@ -186,7 +234,13 @@ class RecordWriter : public RecordBase {
   MessageProtoDescMap channel_proto_desc_map_;
   FileWriterPtr file_writer_ = nullptr;
   FileWriterPtr file_writer_backup_ = nullptr;
+  // closes the previous segment without blocking the writing thread
+  std::thread close_thread_;
   std::mutex mutex_;
+  uint64_t write_buffer_size_ = 0;
+  std::unordered_map<std::string, ChannelPriority> channel_priority_map_;
+  MessageNumberMap channel_dropped_number_map_;
+  WriterStats stats_;
   std::stringstream sstream_;
 };
 
@@ -211,7 +265,9 @@ inline bool RecordWriter::WriteMessage(
     AERROR << "nullptr error, channel: " << channel_name;
     return false;
   }
-  return WriteMessage(channel_name, message->message, time_nanosec);
+  return WriteMessage(channel_name,
+                      std::string(message->data(), message->size()),
+                      time_nanosec);
 }
 
 template <typename MessageT>
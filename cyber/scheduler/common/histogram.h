@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_COMMON_HISTOGRAM_H_
+#define CYBER_SCHEDULER_COMMON_HISTOGRAM_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+/**
+ * @class Histogram
+ * @brief Fixed size log-linear histogram: every power of two is split into
+ * 16 buckets, so percentiles are within 1/16 of the recorded value. Values
+ * above 2^40 are counted in the last bucket. Not thread safe.
+ */
+class Histogram {
+ public:
+  void Add(uint64_t value) {
+    ++buckets_[Index(value)];
+    ++count_;
+    sum_ += value;
+    max_ = std::max(max_, value);
+  }
+
+  void Merge(const Histogram& other) {
+    for (size_t i = 0; i < kBucketNum; ++i) {
+      buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+  }
+
+  void Reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+    max_ = 0;
+  }
+
+  /**
+   * @brief Value below which the given share of the samples fall
+   *
+   * @param percentile in [0, 1]
+   */
+  uint64_t Percentile(double percentile) const {
+    if (count_ == 0) {
+      return 0;
+    }
+    auto rank = static_cast<uint64_t>(
+        std::ceil(std::min(std::max(percentile, 0.0), 1.0) * count_));
+    if (rank >= count_) {
+      return max_;
+    }
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketNum; ++i) {
+      seen += buckets_[i];
+      if (seen >= rank) {
+        return std::min(Value(i), max_);
+      }
+    }
+    return max_;
+  }
+
+  uint64_t count() const { return count_; }
+  uint64_t max() const { return max_; }
+  double mean() const {
+    return count_ == 0 ? 0.0 : static_cast<double>(sum_) / count_;
+  }
+
+ private:
+  static constexpr uint32_t kSubBits = 4;
+  static constexpr uint32_t kSubNum = 1 << kSubBits;
+  static constexpr uint32_t kMaxBits = 40;
+  static constexpr size_t kBucketNum = (kMaxBits - kSubBits + 1) * kSubNum;
+
+  static size_t Index(uint64_t value) {
+    if (value < kSubNum) {
+      return static_cast<size_t>(value);
+    }
+    uint32_t msb = 63 - __builtin_clzll(value);
+    if (msb >= kMaxBits) {
+      return kBucketNum - 1;
+    }
+    uint32_t shift = msb - kSubBits;
+    return (msb - kSubBits + 1) * kSubNum + ((value >> shift) & (kSubNum - 1));
+  }
+
+  // middle of the bucket
+  static uint64_t Value(size_t index) {
+    if (index < kSubNum) {
+      return index;
+    }
+    uint32_t shift = static_cast<uint32_t>(index / kSubNum) - 1;
+    uint64_t lower = (kSubNum + index % kSubNum) << shift;
+    return lower + ((1ULL << shift) >> 1);
+  }
+
+  std::array<uint64_t, kBucketNum> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t max_ = 0;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_COMMON_HISTOGRAM_H_
@@ -0,0 +1,277 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/common/sched_tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::RoutineState;
+using apollo::cyber::proto::LatencyStats;
+using apollo::cyber::proto::SchedStats;
+
+namespace {
+
+uint64_t SteadyNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void FillLatency(const Histogram& histogram, LatencyStats* stats) {
+  constexpr double kNsPerUs = 1000.0;
+  stats->set_count(histogram.count());
+  stats->set_mean(histogram.mean() / kNsPerUs);
+  stats->set_p50(static_cast<double>(histogram.Percentile(0.5)) / kNsPerUs);
+  stats->set_p99(static_cast<double>(histogram.Percentile(0.99)) / kNsPerUs);
+  stats->set_max(static_cast<double>(histogram.max()) / kNsPerUs);
+}
+
+}  // namespace
+
+SchedTracer::SchedTracer() {
+  auto& global_conf = GlobalData::Instance()->Config();
+  if (global_conf.has_perf_conf() &&
+      global_conf.perf_conf().has_sched_trace()) {
+    conf_.CopyFrom(global_conf.perf_conf().sched_trace());
+  }
+  enabled_ = conf_.enable();
+  interval_start_ = SteadyNow();
+  if (!enabled_) {
+    return;
+  }
+
+  if (conf_.sample_interval_ms() == 0) {
+    conf_.set_sample_interval_ms(1);
+  }
+  if (conf_.export_interval_ms() < conf_.sample_interval_ms()) {
+    conf_.set_export_interval_ms(conf_.sample_interval_ms());
+  }
+
+  CRoutine::EnableWakeupTrace(true);
+  thread_ = std::thread(&SchedTracer::Run, this);
+}
+
+SchedTracer::~SchedTracer() { Shutdown(); }
+
+void SchedTracer::Shutdown() {
+  if (!enabled_ || shutdown_.exchange(true)) {
+    return;
+  }
+
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  SetExporter(nullptr);
+}
+
+std::shared_ptr<ProcessorTrace> SchedTracer::CreateProcessorTrace() {
+  auto trace = std::make_shared<ProcessorTrace>(conf_.ring_size());
+  ProcessorEntry entry;
+  entry.trace = trace;
+  std::lock_guard<std::mutex> lock(mutex_);
+  processors_.emplace_back(entry);
+  return trace;
+}
+
+void SchedTracer::RegisterRoutine(const std::shared_ptr<CRoutine>& cr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& routine = routines_[cr->id()];
+  routine.name = cr->name();
+  routine.group = cr->group_name();
+  routine.cr = cr;
+}
+
+void SchedTracer::SetExporter(const Exporter& exporter) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  exporter_ = exporter;
+}
+
+SchedTracer::RoutineTrace* SchedTracer::GetRoutine(uint64_t cr_id) {
+  auto it = routines_.find(cr_id);
+  if (it != routines_.end()) {
+    return &it->second;
+  }
+  // dispatched without Scheduler::CreateTask
+  auto& routine = routines_[cr_id];
+  routine.name = GlobalData::GetTaskNameById(cr_id);
+  return &routine;
+}
+
+void SchedTracer::Collect() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  SchedSample sample;
+  for (auto& entry : processors_) {
+    while (entry.trace->Take(&sample)) {
+      auto routine = GetRoutine(sample.cr_id);
+      if (sample.wakeup_latency >= 0) {
+        routine->wakeup_latency.Add(sample.wakeup_latency);
+      }
+      routine->run_time.Add(sample.run_time);
+    }
+  }
+
+  // woken up, by a notification or the end of a sleep, but not running yet
+  auto now = std::chrono::steady_clock::now();
+  std::map<std::string, uint64_t> depths;
+  for (auto& routine : routines_) {
+    auto cr = routine.second.cr.lock();
+    if (cr == nullptr) {
+      continue;
+    }
+    auto& depth = depths[routine.second.group];
+    if (cr->wakeup_time() != 0 ||
+        (cr->state() == RoutineState::SLEEP && cr->wake_time() < now)) {
+      ++depth;
+    }
+  }
+  for (auto& depth : depths) {
+    queue_depths_[depth.first].Add(depth.second);
+  }
+}
+
+void SchedTracer::Export(SchedStats* stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto now = SteadyNow();
+  auto interval = std::max<uint64_t>(now - interval_start_, 1);
+  interval_start_ = now;
+
+  stats->Clear();
+  stats->set_timestamp(Time::Now().ToNanosecond());
+  stats->set_process_group(GlobalData::Instance()->ProcessGroup());
+  stats->set_pid(GlobalData::Instance()->ProcessId());
+  stats->set_interval_ms(static_cast<uint32_t>(interval / 1000000));
+
+  std::map<std::string, std::pair<Histogram, Histogram>> groups;
+  for (auto it = routines_.begin(); it != routines_.end();) {
+    auto& routine = it->second;
+    if (routine.run_time.count() > 0) {
+      auto routine_stats = stats->add_routines();
+      routine_stats->set_name(routine.name);
+      routine_stats->set_group(routine.group);
+      FillLatency(routine.wakeup_latency,
+                  routine_stats->mutable_wakeup_latency());
+      FillLatency(routine.run_time, routine_stats->mutable_run_time());
+
+      auto& group = groups[routine.group];
+      group.first.Merge(routine.wakeup_latency);
+      group.second.Merge(routine.run_time);
+      routine.wakeup_latency.Reset();
+      routine.run_time.Reset();
+    }
+
+    // the routine was removed from the scheduler
+    if (routine.cr.expired()) {
+      it = routines_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for (auto it = queue_depths_.begin(); it != queue_depths_.end();) {
+    // no routine of the group is left
+    if (it->second.count() == 0) {
+      it = queue_depths_.erase(it);
+      continue;
+    }
+    groups[it->first];
+    ++it;
+  }
+  for (auto& group : groups) {
+    auto group_stats = stats->add_groups();
+    group_stats->set_name(group.first);
+    FillLatency(group.second.first, group_stats->mutable_wakeup_latency());
+    FillLatency(group.second.second, group_stats->mutable_run_time());
+    auto depth = queue_depths_.find(group.first);
+    if (depth != queue_depths_.end()) {
+      group_stats->set_queue_depth_mean(depth->second.mean());
+      group_stats->set_queue_depth_p99(depth->second.Percentile(0.99));
+      group_stats->set_queue_depth_max(depth->second.max());
+      depth->second.Reset();
+    }
+  }
+
+  for (auto it = processors_.begin(); it != processors_.end();) {
+    auto& entry = *it;
+    auto busy_time = entry.trace->busy_time();
+    auto run_count = entry.trace->run_count();
+    auto dropped = entry.trace->dropped();
+    auto processor_stats = stats->add_processors();
+    processor_stats->set_tid(entry.trace->tid());
+    processor_stats->set_utilization(
+        std::min(1.0, static_cast<double>(busy_time - entry.last_busy_time) /
+                          static_cast<double>(interval)));
+    processor_stats->set_run_count(run_count - entry.last_run_count);
+    processor_stats->set_dropped_samples(dropped - entry.last_dropped);
+    entry.last_busy_time = busy_time;
+    entry.last_run_count = run_count;
+    entry.last_dropped = dropped;
+
+    // the processor is gone and its ring is drained
+    if (entry.trace.use_count() == 1) {
+      it = processors_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void SchedTracer::Run() {
+  auto sample_interval = std::chrono::milliseconds(conf_.sample_interval_ms());
+  auto export_interval = std::chrono::milliseconds(conf_.export_interval_ms());
+  auto next_export = std::chrono::steady_clock::now() + export_interval;
+  while (!shutdown_.load()) {
+    {
+      std::unique_lock<std::mutex> lk(thread_mutex_);
+      cv_.wait_for(lk, sample_interval, [this]() { return shutdown_.load(); });
+    }
+    if (shutdown_.load()) {
+      break;
+    }
+
+    Collect();
+    if (std::chrono::steady_clock::now() < next_export) {
+      continue;
+    }
+    next_export += export_interval;
+
+    SchedStats stats;
+    Export(&stats);
+    Exporter exporter = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exporter = exporter_;
+    }
+    if (exporter) {
+      exporter(stats);
+    }
+  }
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_COMMON_SCHED_TRACER_H_
+#define CYBER_SCHEDULER_COMMON_SCHED_TRACER_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/proto/perf_conf.pb.h"
+#include "cyber/proto/sched_stats.pb.h"
+
+#include "cyber/base/bounded_queue.h"
+#include "cyber/common/macros.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/common/histogram.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using croutine::CRoutine;
+
+struct SchedSample {
+  uint64_t cr_id = 0;
+  // nanoseconds, -1 if the routine ran without being woken up, e.g. after a
+  // yield
+  int64_t wakeup_latency = -1;
+  uint64_t run_time = 0;
+};
+
+/**
+ * @class ProcessorTrace
+ * @brief Written by one processor thread after each routine run, read by the
+ * tracer thread. Recording never blocks, samples are dropped when the ring
+ * is full.
+ */
+class ProcessorTrace {
+ public:
+  explicit ProcessorTrace(uint32_t ring_size) { samples_.Init(ring_size); }
+
+  /**
+   * @param wakeup_time steady clock ns of the wakeup, 0 if unknown
+   * @param start steady clock ns the run started
+   * @param end steady clock ns the run ended
+   */
+  void Record(uint64_t cr_id, uint64_t wakeup_time, uint64_t start,
+              uint64_t end) {
+    busy_time_.fetch_add(end - start, std::memory_order_relaxed);
+    run_count_.fetch_add(1, std::memory_order_relaxed);
+
+    SchedSample sample;
+    sample.cr_id = cr_id;
+    if (wakeup_time != 0 && wakeup_time <= start) {
+      sample.wakeup_latency = static_cast<int64_t>(start - wakeup_time);
+    }
+    sample.run_time = end - start;
+    if (!samples_.Enqueue(sample)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  bool Take(SchedSample* sample) { return samples_.Dequeue(sample); }
+
+  void set_tid(pid_t tid) { tid_.store(tid); }
+  pid_t tid() const { return tid_.load(); }
+  uint64_t busy_time() const { return busy_time_.load(); }
+  uint64_t run_count() const { return run_count_.load(); }
+  uint64_t dropped() const { return dropped_.load(); }
+
+ private:
+  base::BoundedQueue<SchedSample> samples_;
+  std::atomic<pid_t> tid_ = {-1};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> busy_time_ = {0};
+  std::atomic<uint64_t> run_count_ = {0};
+  std::atomic<uint64_t> dropped_ = {0};
+};
+
+/**
+ * @class SchedTracer
+ * @brief Aggregates the samples of all processors into wakeup latency and run
+ * time histograms per routine and per group, samples the run queue depth of
+ * every group and exports the result every export interval. Always on
+ * unless perf_conf.sched_trace.enable is false in cyber.pb.conf.
+ */
+class SchedTracer {
+ public:
+  using Exporter = std::function<void(const proto::SchedStats&)>;
+
+  ~SchedTracer();
+
+  bool Enabled() const { return enabled_; }
+  const proto::SchedTraceConf& conf() const { return conf_; }
+
+  std::shared_ptr<ProcessorTrace> CreateProcessorTrace();
+  void RegisterRoutine(const std::shared_ptr<CRoutine>& cr);
+
+  /**
+   * @brief Called from the tracer thread with the statistics of every export
+   * interval, nullptr to stop exporting
+   */
+  void SetExporter(const Exporter& exporter);
+
+  /**
+   * @brief Drain the sample rings and sample the run queue depths
+   */
+  void Collect();
+
+  /**
+   * @brief Fill the statistics collected since the previous call and start a
+   * new interval
+   */
+  void Export(proto::SchedStats* stats);
+
+  void Shutdown();
+
+ private:
+  struct RoutineTrace {
+    std::string name;
+    std::string group;
+    std::weak_ptr<CRoutine> cr;
+    Histogram wakeup_latency;
+    Histogram run_time;
+  };
+
+  struct ProcessorEntry {
+    std::shared_ptr<ProcessorTrace> trace;
+    uint64_t last_busy_time = 0;
+    uint64_t last_run_count = 0;
+    uint64_t last_dropped = 0;
+  };
+
+  void Run();
+  RoutineTrace* GetRoutine(uint64_t cr_id);
+
+  bool enabled_ = false;
+  proto::SchedTraceConf conf_;
+
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, RoutineTrace> routines_;
+  std::vector<ProcessorEntry> processors_;
+  std::map<std::string, Histogram> queue_depths_;
+  uint64_t interval_start_ = 0;
+  Exporter exporter_ = nullptr;
+
+  std::atomic<bool> shutdown_ = {false};
+  std::mutex thread_mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+
+  DECLARE_SINGLETON(SchedTracer)
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_COMMON_SCHED_TRACER_H_
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/common/sched_tracer.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/scheduler/common/histogram.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::proto::SchedStats;
+
+void func() {}
+
+TEST(HistogramTest, percentile) {
+  Histogram histogram;
+  EXPECT_EQ(histogram.Percentile(0.5), 0);
+
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    histogram.Add(i * 1000);
+  }
+  EXPECT_EQ(histogram.count(), 1000);
+  EXPECT_EQ(histogram.max(), 1000000);
+  EXPECT_DOUBLE_EQ(histogram.mean(), 500500.0);
+  EXPECT_NEAR(histogram.Percentile(0.5), 500000, 500000 / 16);
+  EXPECT_NEAR(histogram.Percentile(0.99), 990000, 990000 / 16);
+  EXPECT_EQ(histogram.Percentile(1.0), 1000000);
+
+  Histogram small;
+  small.Add(3);
+  small.Add(5);
+  EXPECT_EQ(small.Percentile(0.5), 3);
+  histogram.Merge(small);
+  EXPECT_EQ(histogram.count(), 1002);
+  EXPECT_EQ(histogram.Percentile(0.0), 3);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.max(), 0);
+}
+
+TEST(SchedTracerTest, export_stats) {
+  auto tracer = SchedTracer::Instance();
+  // the tracer is on by default, stop its thread so that the test owns the
+  // export intervals
+  tracer->Shutdown();
+  auto trace = tracer->CreateProcessorTrace();
+  trace->set_tid(12345);
+
+  auto cr = std::make_shared<CRoutine>(func);
+  cr->set_id(GlobalData::RegisterTaskName("traced_task"));
+  cr->set_name("traced_task");
+  cr->set_group_name("traced_group");
+  tracer->RegisterRoutine(cr);
+
+  // woken up at 1us, ran from 3us to 13us
+  trace->Record(cr->id(), 1000, 3000, 13000);
+  // yielded, no wakeup
+  trace->Record(cr->id(), 0, 20000, 40000);
+  tracer->Collect();
+
+  SchedStats stats;
+  tracer->Export(&stats);
+  ASSERT_EQ(stats.routines_size(), 1);
+  auto& routine = stats.routines(0);
+  EXPECT_EQ(routine.name(), "traced_task");
+  EXPECT_EQ(routine.group(), "traced_group");
+  EXPECT_EQ(routine.wakeup_latency().count(), 1);
+  EXPECT_DOUBLE_EQ(routine.wakeup_latency().p50(), 2.0);
+  EXPECT_EQ(routine.run_time().count(), 2);
+  EXPECT_DOUBLE_EQ(routine.run_time().max(), 20.0);
+  EXPECT_DOUBLE_EQ(routine.run_time().mean(), 15.0);
+
+  ASSERT_EQ(stats.groups_size(), 1);
+  EXPECT_EQ(stats.groups(0).name(), "traced_group");
+  EXPECT_EQ(stats.groups(0).run_time().count(), 2);
+  EXPECT_EQ(stats.groups(0).queue_depth_max(), 0);
+
+  bool found = false;
+  for (auto& processor : stats.processors()) {
+    if (processor.tid() == 12345) {
+      found = true;
+      EXPECT_EQ(processor.run_count(), 2);
+      EXPECT_GT(processor.utilization(), 0.0);
+    }
+  }
+  EXPECT_TRUE(found);
+
+  // a woken up routine that has not run yet counts in the queue depth
+  CRoutine::EnableWakeupTrace(true);
+  cr->SetUpdateFlag();
+  tracer->Collect();
+  tracer->Export(&stats);
+  EXPECT_EQ(stats.routines_size(), 0);
+  ASSERT_EQ(stats.groups_size(), 1);
+  EXPECT_EQ(stats.groups(0).queue_depth_max(), 1);
+  EXPECT_NE(cr->TakeWakeupTime(), 0);
+  EXPECT_EQ(cr->wakeup_time(), 0);
+  CRoutine::EnableWakeupTrace(false);
+
+  // removed routines and stopped processors are dropped
+  cr.reset();
+  trace.reset();
+  tracer->Export(&stats);
+  tracer->Export(&stats);
+  EXPECT_EQ(stats.routines_size(), 0);
+  for (auto& processor : stats.processors()) {
+    EXPECT_NE(processor.tid(), 12345);
+  }
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,290 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/scheduler_work_stealing.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "cyber/common/environment.h"
+#include "cyber/common/file.h"
+#include "cyber/common/global_data.h"
+#include "cyber/scheduler/processor.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::base::ReadLockGuard;
+using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::common::GetAbsolutePath;
+using apollo::cyber::common::GetProtoFromFile;
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::common::PathExists;
+using apollo::cyber::common::WorkRoot;
+using apollo::cyber::croutine::RoutineState;
+
+SchedulerWorkStealing::SchedulerWorkStealing() {
+  std::string conf("conf/");
+  conf.append(GlobalData::Instance()->ProcessGroup()).append(".conf");
+  auto cfg_file = GetAbsolutePath(WorkRoot(), conf);
+
+  apollo::cyber::proto::CyberConfig cfg;
+  if (PathExists(cfg_file) && GetProtoFromFile(cfg_file, &cfg)) {
+    for (auto& thr : cfg.scheduler_conf().threads()) {
+      inner_thr_confs_[thr.name()] = thr;
+    }
+
+    if (cfg.scheduler_conf().has_process_level_cpuset()) {
+      process_level_cpuset_ = cfg.scheduler_conf().process_level_cpuset();
+      ProcessLevelResourceControl();
+    }
+
+    work_stealing_conf_ = cfg.scheduler_conf().work_stealing_conf();
+    for (auto& group : work_stealing_conf_.groups()) {
+      auto& group_name = group.name();
+      for (auto task : group.tasks()) {
+        task.set_group_name(group_name);
+        cr_confs_[task.name()] = task;
+      }
+    }
+  }
+
+  if (work_stealing_conf_.groups_size() == 0) {
+    // if do not set default_proc_num in scheduler conf
+    // give a default value
+    uint32_t proc_num = 2;
+    auto& global_conf = GlobalData::Instance()->Config();
+    if (global_conf.has_scheduler_conf() &&
+        global_conf.scheduler_conf().has_default_proc_num()) {
+      proc_num = global_conf.scheduler_conf().default_proc_num();
+    }
+    task_pool_size_ = proc_num;
+
+    auto sched_group = work_stealing_conf_.add_groups();
+    sched_group->set_name(DEFAULT_GROUP_NAME);
+    sched_group->set_processor_num(proc_num);
+  }
+
+  CreateProcessor();
+}
+
+void SchedulerWorkStealing::CreateProcessor() {
+  // all contexts and their victims are set up before any processor runs
+  std::vector<std::shared_ptr<WorkStealingContext>> ctxs;
+  for (auto& group : work_stealing_conf_.groups()) {
+    auto& group_name = group.name();
+    for (uint32_t i = 0; i < group.processor_num(); i++) {
+      auto ctx = std::make_shared<WorkStealingContext>(
+          group_name, work_stealing_conf_.queue_size());
+      groups_[group_name].emplace_back(ctx);
+      ctxs.emplace_back(ctx);
+    }
+  }
+
+  for (auto& ctx : ctxs) {
+    // peers of the same group first, starting after the context itself so
+    // the processors of a group do not all hit the same victim
+    std::vector<WorkStealingContext*> victims;
+    auto& peers = groups_[ctx->group_name()];
+    auto self = std::find(peers.begin(), peers.end(), ctx);
+    auto pos = static_cast<size_t>(self - peers.begin());
+    for (size_t i = 1; i < peers.size(); ++i) {
+      victims.emplace_back(peers[(pos + i) % peers.size()].get());
+    }
+    if (work_stealing_conf_.steal_across_groups()) {
+      for (auto& other : ctxs) {
+        if (other->group_name() != ctx->group_name()) {
+          victims.emplace_back(other.get());
+        }
+      }
+    }
+    ctx->SetVictims(victims);
+  }
+
+  auto ctx_iter = ctxs.begin();
+  for (auto& group : work_stealing_conf_.groups()) {
+    auto proc_num = group.processor_num();
+    if (task_pool_size_ == 0) {
+      task_pool_size_ = proc_num;
+    }
+
+    auto& affinity = group.affinity();
+    auto& processor_policy = group.processor_policy();
+    auto processor_prio = group.processor_prio();
+    std::vector<int> cpuset;
+    ParseCpuset(group.cpuset(), &cpuset);
+
+    for (uint32_t i = 0; i < proc_num; i++) {
+      auto ctx = *ctx_iter++;
+      pctxs_.emplace_back(ctx);
+
+      auto proc = std::make_shared<Processor>();
+      proc->BindContext(ctx);
+      SetSchedAffinity(proc->Thread(), cpuset, affinity, i);
+      SetSchedPolicy(proc->Thread(), processor_policy, processor_prio,
+                     proc->Tid());
+      processors_.emplace_back(proc);
+    }
+  }
+}
+
+bool SchedulerWorkStealing::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  MutexWrapper* wrapper = nullptr;
+  if (!id_map_mutex_.Get(cr->id(), &wrapper)) {
+    {
+      std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+      if (!id_map_mutex_.Get(cr->id(), &wrapper)) {
+        wrapper = new MutexWrapper();
+        id_map_mutex_.Set(cr->id(), wrapper);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lg(wrapper->Mutex());
+
+  if (cr_confs_.find(cr->name()) != cr_confs_.end()) {
+    ClassicTask task = cr_confs_[cr->name()];
+    cr->set_priority(task.prio());
+    cr->set_group_name(task.group_name());
+  } else {
+    // croutine that not exist in conf
+    cr->set_group_name(work_stealing_conf_.groups(0).name());
+  }
+
+  if (cr->priority() >= MAX_PRIO) {
+    AWARN << cr->name() << " prio is greater than MAX_PRIO[ << " << MAX_PRIO
+          << "].";
+    cr->set_priority(MAX_PRIO - 1);
+  }
+
+  auto group = groups_.find(cr->group_name());
+  if (group == groups_.end() || group->second.empty()) {
+    AERROR << "group " << cr->group_name() << " of " << cr->name()
+           << " has no processor.";
+    return false;
+  }
+
+  StealableRoutine* routine = nullptr;
+  std::shared_ptr<WorkStealingContext> ctx = nullptr;
+  {
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    if (id_cr_.find(cr->id()) != id_cr_.end()) {
+      return false;
+    }
+    id_cr_[cr->id()] = cr;
+
+    // spread the routines of a group over its processors
+    auto& procs = group->second;
+    ctx = procs[next_proc_[group->first]++ % procs.size()];
+    routine = new StealableRoutine(cr);
+    routine->owner.store(ctx.get());
+    routines_[cr->id()] = routine;
+    // keeps the routine alive until it is queued, a removal may come first
+    routine->Ref();
+  }
+
+  ctx->Enqueue(routine);
+  routine->Unref();
+  return true;
+}
+
+bool SchedulerWorkStealing::NotifyProcessor(uint64_t crid) {
+  if (cyber_unlikely(stop_)) {
+    return true;
+  }
+
+  ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+  auto it = routines_.find(crid);
+  if (it == routines_.end()) {
+    return false;
+  }
+
+  auto routine = it->second;
+  auto& cr = routine->cr;
+  if (cr->state() == RoutineState::DATA_WAIT ||
+      cr->state() == RoutineState::IO_WAIT) {
+    cr->SetUpdateFlag();
+  }
+  routine->owner.load()->Enqueue(routine);
+  return true;
+}
+
+bool SchedulerWorkStealing::RemoveTask(const std::string& name) {
+  if (cyber_unlikely(stop_)) {
+    return true;
+  }
+
+  auto crid = GlobalData::GenerateHashId(name);
+  return RemoveCRoutine(crid);
+}
+
+bool SchedulerWorkStealing::RemoveCRoutine(uint64_t crid) {
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  MutexWrapper* wrapper = nullptr;
+  if (!id_map_mutex_.Get(crid, &wrapper)) {
+    {
+      std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+      if (!id_map_mutex_.Get(crid, &wrapper)) {
+        wrapper = new MutexWrapper();
+        id_map_mutex_.Set(crid, wrapper);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lg(wrapper->Mutex());
+
+  std::shared_ptr<CRoutine> cr = nullptr;
+  StealableRoutine* routine = nullptr;
+  {
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    auto it = routines_.find(crid);
+    if (it == routines_.end()) {
+      return false;
+    }
+    routine = it->second;
+    cr = routine->cr;
+    cr->Stop();
+    routines_.erase(it);
+    id_cr_.erase(crid);
+  }
+
+  while (!cr->Acquire()) {
+    std::this_thread::sleep_for(std::chrono::microseconds(1));
+    AINFO_EVERY(1000) << "waiting for task " << cr->name() << " completion";
+  }
+  routine->removed.store(true);
+  cr->Release();
+  // the contexts drop their references the next time they come across it
+  routine->Unref();
+  return true;
+}
+
+uint64_t SchedulerWorkStealing::StealCount() {
+  uint64_t count = 0;
+  for (auto& group : groups_) {
+    for (auto& ctx : group.second) {
+      count += ctx->steal_count();
+    }
+  }
+  return count;
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
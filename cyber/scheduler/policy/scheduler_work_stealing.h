@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_SCHEDULER_WORK_STEALING_H_
+#define CYBER_SCHEDULER_POLICY_SCHEDULER_WORK_STEALING_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/croutine/croutine.h"
+#include "cyber/proto/classic_conf.pb.h"
+#include "cyber/proto/work_stealing_conf.pb.h"
+#include "cyber/scheduler/policy/work_stealing_context.h"
+#include "cyber/scheduler/scheduler.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::CRoutine;
+using apollo::cyber::proto::ClassicTask;
+using apollo::cyber::proto::WorkStealingConf;
+
+/**
+ * @class SchedulerWorkStealing
+ * @brief Groups and task priorities are configured like the classic policy,
+ * but instead of one shared run queue per group every processor has its own
+ * run queues and steals from its peers when they are empty.
+ */
+class SchedulerWorkStealing : public Scheduler {
+ public:
+  bool RemoveCRoutine(uint64_t crid) override;
+  bool RemoveTask(const std::string& name) override;
+  bool DispatchTask(const std::shared_ptr<CRoutine>&) override;
+
+  /**
+   * @brief Number of routines taken from another processor so far
+   */
+  uint64_t StealCount();
+
+ private:
+  friend Scheduler* Instance();
+  SchedulerWorkStealing();
+
+  void CreateProcessor();
+  bool NotifyProcessor(uint64_t crid) override;
+
+  std::unordered_map<std::string, ClassicTask> cr_confs_;
+
+  // guarded by id_cr_lock_, holds the creation reference of each routine
+  std::unordered_map<uint64_t, StealableRoutine*> routines_;
+  std::unordered_map<std::string, uint32_t> next_proc_;
+
+  std::unordered_map<std::string,
+                     std::vector<std::shared_ptr<WorkStealingContext>>>
+      groups_;
+
+  WorkStealingConf work_stealing_conf_;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_SCHEDULER_WORK_STEALING_H_
@@ -0,0 +1,273 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/work_stealing_context.h"
+
+#include <algorithm>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::RoutineState;
+
+WorkStealingContext::WorkStealingContext(const std::string& group_name,
+                                         uint32_t queue_size)
+    : group_name_(group_name) {
+  for (auto& queue : run_queues_) {
+    queue.Init(queue_size);
+  }
+}
+
+WorkStealingContext::~WorkStealingContext() {
+  StealableRoutine* routine = nullptr;
+  for (auto& queue : run_queues_) {
+    while (queue.Dequeue(&routine)) {
+      routine->Unref();
+    }
+  }
+  while (!sleepers_.empty()) {
+    sleepers_.top().second->Unref();
+    sleepers_.pop();
+  }
+  if (last_routine_ != nullptr) {
+    last_routine_->Unref();
+  }
+}
+
+std::shared_ptr<CRoutine> WorkStealingContext::NextRoutine() {
+  if (cyber_unlikely(stop_.load())) {
+    return nullptr;
+  }
+
+  SettleLastRoutine();
+  WakeSleepers();
+
+  StealableRoutine* routine = nullptr;
+  while (Pop(&routine) || Steal(&routine)) {
+    // the reference of the run queue is ours now. Clear the flag first, a
+    // notification from now on queues it again
+    routine->queued.store(false);
+    if (routine->removed.load()) {
+      routine->Unref();
+      continue;
+    }
+
+    auto& cr = routine->cr;
+    if (!cr->Acquire()) {
+      // still running elsewhere, the processor running it requeues it on
+      // release. Retry once in case it was released in the meantime.
+      routine->pending.store(true);
+      if (!cr->Acquire()) {
+        routine->Unref();
+        continue;
+      }
+      routine->pending.store(false);
+    }
+
+    if (routine->removed.load()) {
+      cr->Release();
+      routine->Unref();
+      continue;
+    }
+
+    routine->owner.store(this);
+    if (cr->UpdateState() == RoutineState::READY) {
+      // hands the reference over to last_routine_
+      last_routine_ = routine;
+      return cr;
+    }
+
+    if (cr->state() == RoutineState::SLEEP) {
+      Park(routine);
+    }
+    cr->Release();
+    routine->Unref();
+  }
+
+  return nullptr;
+}
+
+void WorkStealingContext::Wait() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  idle_.store(true);
+  // pairs with the check of idle_ in Enqueue so a push is never missed
+  if (ready_mask_.load() == 0 && !stop_.load()) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(1000);
+    if (!sleepers_.empty()) {
+      deadline = std::min(deadline, sleepers_.top().first);
+    }
+    cv_.wait_until(lk, deadline,
+                   [this]() { return notified_ || stop_.load(); });
+  }
+  notified_ = false;
+  idle_.store(false);
+}
+
+void WorkStealingContext::Shutdown() {
+  stop_.store(true);
+  Notify();
+}
+
+bool WorkStealingContext::Enqueue(StealableRoutine* routine) {
+  if (routine->queued.exchange(true)) {
+    return true;
+  }
+
+  routine->Ref();
+  if (!Push(routine)) {
+    routine->queued.store(false);
+    routine->Unref();
+    AERROR_EVERY(100) << "run queue of group " << group_name_
+                      << " is full, croutine " << routine->cr->name()
+                      << " is not scheduled.";
+    return false;
+  }
+
+  if (idle_.load()) {
+    Notify();
+    return true;
+  }
+
+  // the owner is busy, let an idle peer take the routine
+  for (auto victim : victims_) {
+    if (victim->idle()) {
+      victim->Notify();
+      break;
+    }
+  }
+  return true;
+}
+
+bool WorkStealingContext::Push(StealableRoutine* routine) {
+  auto prio = routine->cr->priority();
+  if (!run_queues_[prio].Enqueue(routine)) {
+    return false;
+  }
+  ready_mask_.fetch_or(1u << prio);
+  return true;
+}
+
+bool WorkStealingContext::Pop(StealableRoutine** routine) {
+  uint32_t mask = ready_mask_.load(std::memory_order_acquire);
+  while (mask != 0) {
+    int prio = 31 - __builtin_clz(mask);
+    if (run_queues_[prio].Dequeue(routine)) {
+      return true;
+    }
+
+    // the queue ran dry, a concurrent push sets the bit again
+    ready_mask_.fetch_and(~(1u << prio));
+    if (!run_queues_[prio].Empty()) {
+      ready_mask_.fetch_or(1u << prio);
+    }
+    mask = ready_mask_.load(std::memory_order_acquire) & ((1u << prio) - 1);
+  }
+  return false;
+}
+
+bool WorkStealingContext::Steal(StealableRoutine** routine) {
+  auto victim_num = static_cast<uint32_t>(victims_.size());
+  for (uint32_t i = 0; i < victim_num; ++i) {
+    auto index = (next_victim_ + i) % victim_num;
+    if (victims_[index]->Pop(routine)) {
+      next_victim_ = index;
+      steal_count_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingContext::Notify() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    notified_ = true;
+  }
+  cv_.notify_one();
+}
+
+void WorkStealingContext::Requeue(StealableRoutine* routine) {
+  if (routine->queued.exchange(true)) {
+    return;
+  }
+  routine->Ref();
+  if (!Push(routine)) {
+    routine->queued.store(false);
+    routine->Unref();
+    return;
+  }
+
+  // more work than this processor can take right now, wake a peer for it
+  auto prio = routine->cr->priority();
+  if (__builtin_popcount(ready_mask_.load()) > 1 ||
+      run_queues_[prio].Size() > 1) {
+    for (auto victim : victims_) {
+      if (victim->idle()) {
+        victim->Notify();
+        break;
+      }
+    }
+  }
+}
+
+void WorkStealingContext::Park(StealableRoutine* routine) {
+  if (!routine->sleeping.exchange(true)) {
+    routine->Ref();
+    sleepers_.emplace(routine->cr->wake_time(), routine);
+  }
+}
+
+void WorkStealingContext::WakeSleepers() {
+  if (sleepers_.empty()) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  while (!sleepers_.empty() && sleepers_.top().first <= now) {
+    auto routine = sleepers_.top().second;
+    sleepers_.pop();
+    routine->sleeping.store(false);
+    if (!routine->removed.load()) {
+      Requeue(routine);
+    }
+    routine->Unref();
+  }
+}
+
+void WorkStealingContext::SettleLastRoutine() {
+  auto routine = last_routine_;
+  if (routine == nullptr) {
+    return;
+  }
+  last_routine_ = nullptr;
+  if (!routine->removed.load()) {
+    bool pending = routine->pending.exchange(false);
+    auto state = routine->cr->state();
+    if (state == RoutineState::READY || pending) {
+      Requeue(routine);
+    } else if (state == RoutineState::SLEEP) {
+      Park(routine);
+    }
+  }
+  routine->Unref();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
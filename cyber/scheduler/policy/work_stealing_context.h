@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
+#define CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cyber/base/bounded_queue.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/processor_context.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+class WorkStealingContext;
+
+/**
+ * @brief Scheduling state of a croutine under the work stealing policy.
+ * A routine sits in at most one run queue at a time, guarded by `queued`.
+ * It is created with one reference for its creator, and every run queue
+ * slot, sleeper entry and last run routine of a context holds another one.
+ * It frees itself with the last reference, so a processor which popped it
+ * can still look at it after the scheduler removed it.
+ */
+struct StealableRoutine {
+  explicit StealableRoutine(const std::shared_ptr<CRoutine>& routine)
+      : cr(routine) {}
+
+  void Ref() { refs.fetch_add(1, std::memory_order_relaxed); }
+  void Unref() {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  std::shared_ptr<CRoutine> cr;
+  std::atomic<uint32_t> refs = {1};
+  // the context whose run queue receives the routine when it is notified
+  std::atomic<WorkStealingContext*> owner = {nullptr};
+  std::atomic<bool> queued = {false};
+  // dequeued while another processor was running it
+  std::atomic<bool> pending = {false};
+  std::atomic<bool> sleeping = {false};
+  std::atomic<bool> removed = {false};
+};
+
+/**
+ * @class WorkStealingContext
+ * @brief Every processor owns one lock-free run queue per priority and a
+ * bitmap of the non-empty ones. Notified routines go to the queue of the
+ * processor that last ran them; a processor whose queues are empty takes
+ * work from its peers before going to sleep.
+ */
+class WorkStealingContext : public ProcessorContext {
+ public:
+  WorkStealingContext(const std::string& group_name, uint32_t queue_size);
+  // drops the references still held, the processor must have stopped
+  ~WorkStealingContext();
+
+  std::shared_ptr<CRoutine> NextRoutine() override;
+  void Wait() override;
+  void Shutdown() override;
+
+  /**
+   * @brief Queue a routine on this processor and wake it up, or wake an idle
+   * peer that can steal it if this processor is busy.
+   */
+  bool Enqueue(StealableRoutine* routine);
+
+  void SetVictims(const std::vector<WorkStealingContext*>& victims) {
+    victims_ = victims;
+  }
+
+  const std::string& group_name() const { return group_name_; }
+  bool idle() const { return idle_.load(std::memory_order_acquire); }
+  uint64_t steal_count() const { return steal_count_.load(); }
+
+ private:
+  using SleepItem =
+      std::pair<std::chrono::steady_clock::time_point, StealableRoutine*>;
+  struct SleepCompare {
+    bool operator()(const SleepItem& lhs, const SleepItem& rhs) const {
+      return lhs.first > rhs.first;
+    }
+  };
+
+  bool Push(StealableRoutine* routine);
+  bool Pop(StealableRoutine** routine);
+  bool Steal(StealableRoutine** routine);
+  void Notify();
+  void Requeue(StealableRoutine* routine);
+  void Park(StealableRoutine* routine);
+  void WakeSleepers();
+  void SettleLastRoutine();
+
+  std::string group_name_;
+  std::array<base::BoundedQueue<StealableRoutine*>, MAX_PRIO> run_queues_;
+  alignas(CACHELINE_SIZE) std::atomic<uint32_t> ready_mask_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<bool> idle_ = {false};
+  std::atomic<uint64_t> steal_count_ = {0};
+
+  std::vector<WorkStealingContext*> victims_;
+  uint32_t next_victim_ = 0;
+
+  // only touched by the processor thread
+  StealableRoutine* last_routine_ = nullptr;
+  std::priority_queue<SleepItem, std::vector<SleepItem>, SleepCompare>
+      sleepers_;
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  bool notified_ = false;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
@@ -33,7 +33,21 @@ namespace scheduler {
 
 using apollo::cyber::common::GlobalData;
 
-Processor::Processor() { running_.store(true); }
+namespace {
+uint64_t SteadyNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+Processor::Processor() {
+  running_.store(true);
+  auto tracer = SchedTracer::Instance();
+  if (tracer->Enabled()) {
+    trace_ = tracer->CreateProcessorTrace();
+  }
+}
 
 Processor::~Processor() { Stop(); }
 
@@ -41,6 +55,9 @@ void Processor::Run() {
   tid_.store(static_cast<int>(syscall(SYS_gettid)));
   AINFO << "processor_tid: " << tid_;
   snap_shot_->processor_id.store(tid_);
+  if (trace_) {
+    trace_->set_tid(tid_);
+  }
 
   while (cyber_likely(running_.load())) {
     if (cyber_likely(context_ != nullptr)) {
@@ -48,7 +65,14 @@ void Processor::Run() {
       if (croutine) {
         snap_shot_->execute_start_time.store(cyber::Time::Now().ToNanosecond());
         snap_shot_->routine_name = croutine->name();
-        croutine->Resume();
+        if (cyber_unlikely(trace_ != nullptr)) {
+          auto wakeup_time = croutine->TakeWakeupTime();
+          auto start = SteadyNow();
+          croutine->Resume();
+          trace_->Record(croutine->id(), wakeup_time, start, SteadyNow());
+        } else {
+          croutine->Resume();
+        }
         croutine->Release();
       } else {
         snap_shot_->execute_start_time.store(0);
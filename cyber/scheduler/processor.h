@@ -28,6 +28,7 @@
 #include "cyber/proto/scheduler_conf.pb.h"
 
 #include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/common/sched_tracer.h"
 #include "cyber/scheduler/processor_context.h"
 
 namespace apollo {
@@ -67,6 +68,8 @@ class Processor {
   std::atomic<bool> running_{false};
 
   std::shared_ptr<Snapshot> snap_shot_ = std::make_shared<Snapshot>();
+  // nullptr unless scheduler tracing is enabled
+  std::shared_ptr<ProcessorTrace> trace_ = nullptr;
 };
 
 }  // namespace scheduler
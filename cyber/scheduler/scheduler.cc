@@ -25,6 +25,7 @@
 #include "cyber/common/global_data.h"
 #include "cyber/common/util.h"
 #include "cyber/data/data_visitor.h"
+#include "cyber/scheduler/common/sched_tracer.h"
 #include "cyber/scheduler/processor.h"
 #include "cyber/scheduler/processor_context.h"
 
@@ -58,6 +59,11 @@ bool Scheduler::CreateTask(std::function<void()>&& func,
     return false;
   }
 
+  auto tracer = SchedTracer::Instance();
+  if (tracer->Enabled()) {
+    tracer->RegisterRoutine(cr);
+  }
+
   if (visitor != nullptr) {
     visitor->RegisterNotifyCallback([this, task_id]() {
       if (cyber_unlikely(stop_.load())) {
@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/scheduler_work_stealing.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/cyber.h"
+#include "cyber/scheduler/policy/work_stealing_context.h"
+#include "cyber/scheduler/scheduler_factory.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::RoutineState;
+
+void func() {}
+
+TEST(SchedulerWorkStealingTest, context) {
+  WorkStealingContext ctx1("group", 16);
+  WorkStealingContext ctx2("group", 16);
+  ctx2.SetVictims({&ctx1});
+
+  auto low = std::make_shared<CRoutine>(func);
+  low->set_priority(0);
+  auto high = std::make_shared<CRoutine>(func);
+  high->set_priority(5);
+  auto low_routine = new StealableRoutine(low);
+  auto high_routine = new StealableRoutine(high);
+
+  EXPECT_TRUE(ctx1.Enqueue(low_routine));
+  EXPECT_TRUE(ctx1.Enqueue(high_routine));
+  // already queued
+  EXPECT_TRUE(ctx1.Enqueue(high_routine));
+
+  // the higher priority runs first
+  auto cr = ctx1.NextRoutine();
+  EXPECT_EQ(cr, high);
+  cr->set_state(RoutineState::FINISHED);
+  cr->Release();
+
+  // ctx2 has nothing queued and steals from ctx1
+  cr = ctx2.NextRoutine();
+  EXPECT_EQ(cr, low);
+  EXPECT_EQ(ctx2.steal_count(), 1);
+  EXPECT_EQ(low_routine->owner.load(), &ctx2);
+  cr->set_state(RoutineState::DATA_WAIT);
+  cr->Release();
+
+  EXPECT_EQ(ctx1.NextRoutine(), nullptr);
+  EXPECT_EQ(ctx2.NextRoutine(), nullptr);
+
+  // a routine waiting for data only runs once notified
+  EXPECT_TRUE(ctx2.Enqueue(low_routine));
+  EXPECT_EQ(ctx2.NextRoutine(), nullptr);
+  low->SetUpdateFlag();
+  EXPECT_TRUE(ctx2.Enqueue(low_routine));
+  EXPECT_EQ(ctx2.NextRoutine(), low);
+  low->set_state(RoutineState::FINISHED);
+  low->Release();
+  EXPECT_EQ(ctx2.NextRoutine(), nullptr);
+
+  // a removed routine is freed once the contexts let go of it
+  high_routine->removed.store(true);
+  EXPECT_TRUE(ctx1.Enqueue(high_routine));
+  high_routine->Unref();
+  EXPECT_EQ(high.use_count(), 2);
+  EXPECT_EQ(ctx2.NextRoutine(), nullptr);
+  EXPECT_EQ(high.use_count(), 1);
+  low_routine->Unref();
+}
+
+TEST(SchedulerWorkStealingTest, sched_work_stealing) {
+  auto sched = dynamic_cast<SchedulerWorkStealing*>(scheduler::Instance());
+  ASSERT_NE(sched, nullptr);
+
+  std::shared_ptr<CRoutine> cr = std::make_shared<CRoutine>(func);
+  auto task_id = GlobalData::RegisterTaskName("ABC");
+  cr->set_id(task_id);
+  cr->set_name("ABC");
+  EXPECT_TRUE(sched->DispatchTask(cr));
+  // dispatch the same task
+  EXPECT_FALSE(sched->DispatchTask(cr));
+  EXPECT_TRUE(sched->RemoveTask("ABC"));
+  EXPECT_FALSE(sched->RemoveTask("ABC"));
+  // the processors free the removed routine once it leaves the run queue
+  for (int i = 0; i < 100 && cr.use_count() > 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(cr.use_count(), 1);
+
+  // croutines of one group spread over its processors and all complete
+  const int task_num = 64;
+  std::atomic<int> count = {0};
+  for (int i = 0; i < task_num; ++i) {
+    EXPECT_TRUE(sched->CreateTask(
+        [&count]() {
+          for (int j = 0; j < 10; ++j) {
+            cyber::SleepFor(std::chrono::milliseconds(1));
+          }
+          count++;
+        },
+        "work_stealing_" + std::to_string(i)));
+  }
+  for (int i = 0; i < 500 && count.load() < task_num; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(count.load(), task_num);
+
+  sched->Shutdown();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  // read example_sched_work_stealing.conf
+  apollo::cyber::common::GlobalData::Instance()->SetProcessGroup(
+      "example_sched_work_stealing");
+  apollo::cyber::Init(argv[0]);
+  auto res = RUN_ALL_TESTS();
+  apollo::cyber::Clear();
+  return res;
+}
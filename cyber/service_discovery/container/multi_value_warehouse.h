@@ -17,6 +17,7 @@
 #ifndef CYBER_SERVICE_DISCOVERY_CONTAINER_MULTI_VALUE_WAREHOUSE_H_
 #define CYBER_SERVICE_DISCOVERY_CONTAINER_MULTI_VALUE_WAREHOUSE_H_
 
+#include <array>
 #include <cstdint>
 #include <unordered_map>
 #include <vector>
@@ -28,6 +29,12 @@ namespace apollo {
 namespace cyber {
 namespace service_discovery {
 
+/**
+ * @class MultiValueWarehouse
+ * @brief Roles by key, split into shards with a lock each so that joins and
+ * lookups of different keys, e.g. channel ids, do not wait for each other.
+ * Searches by attributes visit the shards one after another.
+ */
 class MultiValueWarehouse : public WarehouseBase {
  public:
   using RoleMap = std::unordered_multimap<uint64_t, RolePtr>;
@@ -67,8 +74,17 @@ class MultiValueWarehouse : public WarehouseBase {
   void GetAllRoles(std::vector<proto::RoleAttributes>* roles_attr) override;
 
  private:
-  RoleMap roles_;
-  base::AtomicRWLock rw_lock_;
+  static constexpr std::size_t kShardNum = 16;
+
+  struct Shard {
+    RoleMap roles;
+    base::AtomicRWLock rw_lock;
+  };
+
+  // keys are hashes of names already
+  Shard& GetShard(uint64_t key) { return shards_[key % kShardNum]; }
+
+  std::array<Shard, kShardNum> shards_;
 };
 
 }  // namespace service_discovery
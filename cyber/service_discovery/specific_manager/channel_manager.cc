@@ -68,6 +68,12 @@ void ChannelManager::GetProtoDesc(const std::string& channel_name,
 
   if (writer->attributes().has_proto_desc()) {
     *proto_desc = writer->attributes().proto_desc();
+    return;
+  }
+  std::lock_guard<std::mutex> lock(proto_desc_mutex_);
+  auto it = proto_descs_.find(writer->attributes().message_type());
+  if (it != proto_descs_.end()) {
+    *proto_desc = it->second;
   }
 }
 
@@ -268,18 +274,56 @@ void ChannelManager::OnTopoModuleLeave(const std::string& host_name,
   }
 }
 
+void ChannelManager::ToDelta(ChangeMsg* msg) {
+  Manager::ToDelta(msg);
+  auto& role_attr = msg->role_attr();
+  if (msg->operate_type() != OperateType::OPT_JOIN ||
+      role_attr.proto_desc().empty() || role_attr.message_type().empty()) {
+    return;
+  }
+  // every type's desc goes out with its first writer JOIN, reader JOINs
+  // carry it as well until then
+  if (published_descs_.count(role_attr.message_type()) != 0) {
+    msg->mutable_role_attr()->clear_proto_desc();
+  } else if (msg->role_type() == RoleType::ROLE_WRITER) {
+    published_descs_.insert(role_attr.message_type());
+  }
+}
+
+void ChannelManager::FromDelta(ChangeMsg* msg) {
+  auto& role_attr = msg->role_attr();
+  if (msg->operate_type() != OperateType::OPT_JOIN ||
+      role_attr.has_proto_desc() || role_attr.message_type().empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(proto_desc_mutex_);
+  auto it = proto_descs_.find(role_attr.message_type());
+  if (it != proto_descs_.end()) {
+    msg->mutable_role_attr()->set_proto_desc(it->second);
+  }
+}
+
+bool ChannelManager::AddProtoDesc(const std::string& message_type,
+                                  const std::string& proto_desc) {
+  std::lock_guard<std::mutex> lock(proto_desc_mutex_);
+  return proto_descs_.emplace(message_type, proto_desc).second;
+}
+
 void ChannelManager::DisposeJoin(const ChangeMsg& msg) {
   ScanMessageType(msg);
 
   Vertice v(msg.role_attr().node_name());
   Edge e;
   e.set_value(msg.role_attr().channel_name());
+  if (msg.role_attr().has_proto_desc() && msg.role_attr().proto_desc() != "" &&
+      AddProtoDesc(msg.role_attr().message_type(),
+                   msg.role_attr().proto_desc())) {
+    // parsing the desc is costly, once per message type is enough, whichever
+    // role brings it first
+    message::ProtobufFactory::Instance()->RegisterMessage(
+        msg.role_attr().proto_desc());
+  }
   if (msg.role_type() == RoleType::ROLE_WRITER) {
-    if (msg.role_attr().has_proto_desc() &&
-        msg.role_attr().proto_desc() != "") {
-      message::ProtobufFactory::Instance()->RegisterMessage(
-          msg.role_attr().proto_desc());
-    }
     auto role = std::make_shared<RoleWriter>(msg.role_attr(), msg.timestamp());
     node_writers_.Add(role->attributes().node_id(), role);
     channel_writers_.Add(role->attributes().channel_id(), role);
@@ -318,9 +362,11 @@ void ChannelManager::ScanMessageType(const ChangeMsg& msg) {
     role_type = "writer";
   }
 
-  RoleAttrVec existed_writers;
+  // roles instead of copies of their attributes, a proto desc can be large
+  std::vector<RolePtr> existed_writers;
   channel_writers_.Search(key, &existed_writers);
-  for (auto& w_attr : existed_writers) {
+  for (auto& writer : existed_writers) {
+    auto& w_attr = writer->attributes();
     if (!IsMessageTypeMatching(msg.role_attr().message_type(),
                                w_attr.message_type())) {
       AERROR << "newly added " << role_type << "(belongs to node["
@@ -332,9 +378,10 @@ void ChannelManager::ScanMessageType(const ChangeMsg& msg) {
     }
   }
 
-  RoleAttrVec existed_readers;
+  std::vector<RolePtr> existed_readers;
   channel_readers_.Search(key, &existed_readers);
-  for (auto& r_attr : existed_readers) {
+  for (auto& reader : existed_readers) {
+    auto& r_attr = reader->attributes();
     if (!IsMessageTypeMatching(msg.role_attr().message_type(),
                                r_attr.message_type())) {
       AERROR << "newly added " << role_type << "(belongs to node["
@@ -18,6 +18,7 @@
 #define CYBER_SERVICE_DISCOVERY_SPECIFIC_MANAGER_CHANNEL_MANAGER_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -191,6 +192,14 @@ class ChannelManager : public Manager {
    */
   bool IsMessageTypeMatching(const std::string& lhs, const std::string& rhs);
 
+ protected:
+  /**
+   * @brief A proto desc is published with the first role of its message type
+   * only, the receivers fill it in for the later ones.
+   */
+  void ToDelta(ChangeMsg* msg) override;
+  void FromDelta(ChangeMsg* msg) override;
+
  private:
   bool Check(const RoleAttributes& attr) override;
   void Dispose(const ChangeMsg& msg) override;
@@ -201,8 +210,24 @@ class ChannelManager : public Manager {
 
   void ScanMessageType(const ChangeMsg& msg);
 
+  /**
+   * @brief Remember the proto desc of a message type
+   *
+   * @return true if the message type was not known yet
+   */
+  bool AddProtoDesc(const std::string& message_type,
+                    const std::string& proto_desc);
+
   ExemptedMessageTypes exempted_msg_types_;
 
+  // message types whose proto desc this manager has published with a writer
+  // JOIN, guarded by the publish lock
+  std::unordered_set<std::string> published_descs_;
+
+  // key: message type
+  std::unordered_map<std::string, std::string> proto_descs_;
+  std::mutex proto_desc_mutex_;
+
   Graph node_graph_;
   // key: node_id
   WriterWarehouse node_writers_;
@@ -141,6 +141,30 @@ TEST_F(ChannelManagerTest, get_proto_desc) {
   EXPECT_FALSE(channel_manager_.Leave(role_attr, RoleType::ROLE_WRITER));
 }
 
+TEST_F(ChannelManagerTest, register_desc_from_reader) {
+  // a reader that joins before any writer still registers its message type
+  const std::string type = message::MessageType<proto::ChatterBenchmark>();
+  RoleAttributes role_attr;
+  role_attr.set_host_name(common::GlobalData::Instance()->HostName());
+  role_attr.set_process_id(common::GlobalData::Instance()->ProcessId());
+  role_attr.set_node_name("reader_first");
+  role_attr.set_node_id(common::GlobalData::RegisterNode("reader_first"));
+  role_attr.set_channel_name("reader_first");
+  role_attr.set_channel_id(
+      common::GlobalData::Instance()->RegisterChannel("reader_first"));
+  transport::Identity id;
+  role_attr.set_id(id.HashValue());
+  role_attr.set_message_type(type);
+  std::string desc;
+  message::GetDescriptorString<proto::ChatterBenchmark>(type, &desc);
+  role_attr.set_proto_desc(desc);
+  channel_manager_.Join(role_attr, RoleType::ROLE_READER);
+
+  EXPECT_NE(message::ProtobufFactory::Instance()->FindMessageTypeByName(type),
+            nullptr);
+  EXPECT_FALSE(channel_manager_.Leave(role_attr, RoleType::ROLE_READER));
+}
+
 TEST_F(ChannelManagerTest, has_writer) {
   for (int i = 0; i < channel_num_; ++i) {
     EXPECT_TRUE(channel_manager_.HasWriter("channel_" + std::to_string(i)));
@@ -430,6 +454,70 @@ TEST_F(ChannelManagerTest, is_message_type_matching) {
       channel_manager_.IsMessageTypeMatching(raw_msg_type_1, py_msg_type));
 }
 
+class DeltaChannelManager : public ChannelManager {
+ public:
+  using ChannelManager::Convert;
+  using ChannelManager::OnRemoteChange;
+  using ChannelManager::ToDelta;
+};
+
+TEST(ChannelManagerDeltaTest, proto_desc_sent_once) {
+  DeltaChannelManager sender;
+  DeltaChannelManager receiver;
+
+  std::string desc;
+  message::GetDescriptorString<proto::Chatter>(
+      message::MessageType<proto::Chatter>(), &desc);
+  RoleAttributes role_attr;
+  role_attr.set_host_name(common::GlobalData::Instance()->HostName());
+  // pretend to be another process, the receiver ignores its own changes
+  role_attr.set_process_id(common::GlobalData::Instance()->ProcessId() + 1);
+  role_attr.set_node_name("delta");
+  role_attr.set_node_id(common::GlobalData::RegisterNode("delta"));
+  role_attr.set_message_type(message::MessageType<proto::Chatter>());
+  role_attr.set_proto_desc(desc);
+
+  std::vector<proto::ChangeMsg> msgs(3);
+  for (int i = 0; i < 2; ++i) {
+    role_attr.set_channel_name("delta_" + std::to_string(i));
+    role_attr.set_channel_id(
+        common::GlobalData::RegisterChannel(role_attr.channel_name()));
+    transport::Identity id;
+    role_attr.set_id(id.HashValue());
+    sender.Convert(role_attr, RoleType::ROLE_WRITER, OperateType::OPT_JOIN,
+                   &msgs[i]);
+    sender.ToDelta(&msgs[i]);
+  }
+  sender.Convert(role_attr, RoleType::ROLE_WRITER, OperateType::OPT_LEAVE,
+                 &msgs[2]);
+  sender.ToDelta(&msgs[2]);
+  EXPECT_EQ(msgs[0].role_attr().proto_desc(), desc);
+  EXPECT_FALSE(msgs[1].role_attr().has_proto_desc());
+  EXPECT_FALSE(msgs[2].role_attr().has_proto_desc());
+
+  for (int i = 0; i < 2; ++i) {
+    std::string msg_str;
+    ASSERT_TRUE(msgs[i].SerializeToString(&msg_str));
+    receiver.OnRemoteChange(msg_str);
+  }
+  std::vector<proto::RoleAttributes> writers;
+  receiver.GetWritersOfChannel("delta_1", &writers);
+  ASSERT_EQ(writers.size(), 1);
+  EXPECT_EQ(writers[0].proto_desc(), desc);
+  std::string proto_desc;
+  receiver.GetProtoDesc("delta_1", &proto_desc);
+  EXPECT_EQ(proto_desc, desc);
+
+  std::string msg_str;
+  ASSERT_TRUE(msgs[2].SerializeToString(&msg_str));
+  receiver.OnRemoteChange(msg_str);
+  EXPECT_FALSE(receiver.HasWriter("delta_1"));
+  EXPECT_TRUE(receiver.HasWriter("delta_0"));
+
+  sender.Shutdown();
+  receiver.Shutdown();
+}
+
 }  // namespace service_discovery
 }  // namespace cyber
 }  // namespace apollo
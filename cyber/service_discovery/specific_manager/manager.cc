@@ -107,7 +107,7 @@ bool Manager::Join(const RoleAttributes& attr, RoleType role,
   Convert(attr, role, OperateType::OPT_JOIN, &msg);
   Dispose(msg);
   if (need_publish) {
-    return Publish(msg);
+    return Publish(&msg);
   }
   return true;
 }
@@ -123,7 +123,7 @@ bool Manager::Leave(const RoleAttributes& attr, RoleType role) {
   Convert(attr, role, OperateType::OPT_LEAVE, &msg);
   Dispose(msg);
   if (NeedPublish(msg)) {
-    return Publish(msg);
+    return Publish(&msg);
   }
   return true;
 }
@@ -167,6 +167,18 @@ bool Manager::NeedPublish(const ChangeMsg& msg) const {
   return true;
 }
 
+void Manager::ToDelta(ChangeMsg* msg) {
+  if (msg->operate_type() != OperateType::OPT_LEAVE) {
+    return;
+  }
+  auto role_attr = msg->mutable_role_attr();
+  role_attr->clear_proto_desc();
+  role_attr->clear_qos_profile();
+  role_attr->clear_socket_addr();
+}
+
+void Manager::FromDelta(ChangeMsg* msg) { (void)msg; }
+
 void Manager::Convert(const RoleAttributes& attr, RoleType role,
                       OperateType opt, ChangeMsg* msg) {
   msg->set_timestamp(cyber::Time::Now().ToNanosecond());
@@ -197,22 +209,24 @@ void Manager::OnRemoteChange(const std::string& msg_str) {
     return;
   }
   RETURN_IF(!Check(msg.role_attr()));
+  FromDelta(&msg);
   Dispose(msg);
 }
 
-bool Manager::Publish(const ChangeMsg& msg) {
+bool Manager::Publish(ChangeMsg* msg) {
   if (!is_discovery_started_.load()) {
     ADEBUG << "discovery is not started.";
     return false;
   }
 
   apollo::cyber::transport::UnderlayMessage m;
-  RETURN_VAL_IF(!message::SerializeToString(msg, &m.data()), false);
-  {
-    std::lock_guard<std::mutex> lg(lock_);
-    if (publisher_ != nullptr) {
-      return publisher_->write(reinterpret_cast<void*>(&m));
-    }
+  // deltas are built in publishing order, a receiver sees what a delta
+  // refers to first
+  std::lock_guard<std::mutex> lg(lock_);
+  ToDelta(msg);
+  RETURN_VAL_IF(!message::SerializeToString(*msg, &m.data()), false);
+  if (publisher_ != nullptr) {
+    return publisher_->write(reinterpret_cast<void*>(&m));
   }
   return true;
 }
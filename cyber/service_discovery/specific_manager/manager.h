@@ -143,11 +143,22 @@ class Manager {
   virtual void Dispose(const ChangeMsg& msg) = 0;
   virtual bool NeedPublish(const ChangeMsg& msg) const;
 
+  /**
+   * @brief Drop what the other managers already know from msg before it is
+   * published. Leave messages only need the fields roles are matched by.
+   */
+  virtual void ToDelta(ChangeMsg* msg);
+
+  /**
+   * @brief Fill in what ToDelta of the sender left out of a remote msg
+   */
+  virtual void FromDelta(ChangeMsg* msg);
+
   void Convert(const RoleAttributes& attr, RoleType role, OperateType opt,
                ChangeMsg* msg);
 
   void Notify(const ChangeMsg& msg);
-  bool Publish(const ChangeMsg& msg);
+  bool Publish(ChangeMsg* msg);
   void OnRemoteChange(const std::string& msg_str);
   bool IsFromSameProcess(const ChangeMsg& msg);
 
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Topology convergence: nodes of different processes join at the same time,
+// every node writes its share of the channels and reads all the others. The
+// changes of each node are handed to one channel manager from a thread per
+// node. Reports how long the manager took to see every role and how many
+// bytes went over the wire, with full and with delta changes.
+//
+// usage: topology_benchmark [nodes] [channels]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyber/common/global_data.h"
+#include "cyber/message/message_traits.h"
+#include "cyber/proto/cyber_conf.pb.h"
+#include "cyber/proto/record.pb.h"
+#include "cyber/proto/topology_change.pb.h"
+#include "cyber/proto/unit_test.pb.h"
+#include "cyber/service_discovery/specific_manager/channel_manager.h"
+
+namespace apollo {
+namespace cyber {
+namespace service_discovery {
+
+class SimulatedChannelManager : public ChannelManager {
+ public:
+  using ChannelManager::Convert;
+  using ChannelManager::OnRemoteChange;
+  using ChannelManager::ToDelta;
+};
+
+struct MessageInfo {
+  std::string type;
+  std::string desc;
+};
+
+template <typename T>
+MessageInfo GetMessageInfo() {
+  MessageInfo info;
+  info.type = message::MessageType<T>();
+  message::GetDescriptorString<T>(info.type, &info.desc);
+  return info;
+}
+
+void Run(bool delta, uint32_t node_num, uint32_t channel_num) {
+  const std::vector<MessageInfo> messages = {
+      GetMessageInfo<proto::Chatter>(), GetMessageInfo<proto::ChangeMsg>(),
+      GetMessageInfo<proto::CyberConfig>(), GetMessageInfo<proto::Header>(),
+      GetMessageInfo<proto::Index>()};
+  auto& host_name = common::GlobalData::Instance()->HostName();
+  int process_id = common::GlobalData::Instance()->ProcessId();
+
+  SimulatedChannelManager receiver;
+  std::atomic<uint64_t> bytes = {0};
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> nodes;
+  for (uint32_t node = 0; node < node_num; ++node) {
+    nodes.emplace_back([&, node]() {
+      SimulatedChannelManager sender;
+      RoleAttributes attr;
+      attr.set_host_name(host_name);
+      attr.set_process_id(process_id + 1 + node);
+      attr.set_node_name("node_" + std::to_string(node));
+      attr.set_node_id(common::GlobalData::RegisterNode(attr.node_name()));
+      uint64_t node_bytes = 0;
+      for (uint32_t channel = 0; channel < channel_num; ++channel) {
+        auto& message = messages[channel % messages.size()];
+        attr.set_channel_name("channel_" + std::to_string(channel));
+        attr.set_channel_id(
+            common::GlobalData::RegisterChannel(attr.channel_name()));
+        attr.set_id((static_cast<uint64_t>(node) << 32) | channel);
+        attr.set_message_type(message.type);
+        attr.set_proto_desc(message.desc);
+        auto role = channel % node_num == node ? RoleType::ROLE_WRITER
+                                               : RoleType::ROLE_READER;
+        ChangeMsg msg;
+        sender.Convert(attr, role, OperateType::OPT_JOIN, &msg);
+        if (delta) {
+          sender.ToDelta(&msg);
+        }
+        std::string msg_str;
+        msg.SerializeToString(&msg_str);
+        node_bytes += msg_str.size();
+        receiver.OnRemoteChange(msg_str);
+      }
+      bytes.fetch_add(node_bytes);
+      sender.Shutdown();
+    });
+  }
+  for (auto& node : nodes) {
+    node.join();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  std::vector<RoleAttributes> writers;
+  std::vector<RoleAttributes> readers;
+  receiver.GetWriters(&writers);
+  receiver.GetReaders(&readers);
+  printf("%-5s converged in %.1f ms, %lu writers %lu readers, %.1f KB sent\n",
+         delta ? "delta" : "full",
+         std::chrono::duration<double, std::milli>(elapsed).count(),
+         static_cast<unsigned long>(writers.size()),  // NOLINT
+         static_cast<unsigned long>(readers.size()),  // NOLINT
+         static_cast<double>(bytes.load()) / 1024.0);
+  receiver.Shutdown();
+}
+
+}  // namespace service_discovery
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  uint32_t node_num = argc > 1 ? std::atoi(argv[1]) : 20;
+  uint32_t channel_num = argc > 2 ? std::atoi(argv[2]) : 200;
+  if (node_num == 0) {
+    node_num = 1;
+  }
+  printf("%u nodes, %u channels\n", node_num, channel_num);
+  for (bool delta : {false, true}) {
+    apollo::cyber::service_discovery::Run(delta, node_num, channel_num);
+  }
+  return 0;
+}
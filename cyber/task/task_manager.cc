@@ -29,8 +29,9 @@ static const char* const task_prefix = "/internal/task";
 
 TaskManager::TaskManager()
     : task_queue_size_(1000),
-      task_queue_(new base::BoundedQueue<std::function<void()>>()) {
-  if (!task_queue_->Init(task_queue_size_, new base::BlockWaitStrategy())) {
+      task_queue_(new base::MpmcRing<std::function<void()>>()) {
+  // nobody waits on the queue, idle routines hang up until notified
+  if (!task_queue_->Init(task_queue_size_, base::RingWaitMode::SPIN)) {
     AERROR << "Task queue init failed";
     throw std::runtime_error("Task queue init failed");
   }
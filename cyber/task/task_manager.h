@@ -25,7 +25,7 @@
 #include <utility>
 #include <vector>
 
-#include "cyber/base/bounded_queue.h"
+#include "cyber/base/mpmc_ring.h"
 #include "cyber/scheduler/scheduler_factory.h"
 
 namespace apollo {
@@ -58,7 +58,7 @@ class TaskManager {
   uint32_t task_queue_size_ = 1000;
   std::atomic<bool> stop_ = {false};
   std::vector<uint64_t> tasks_;
-  std::shared_ptr<base::BoundedQueue<std::function<void()>>> task_queue_;
+  std::shared_ptr<base::MpmcRing<std::function<void()>>> task_queue_;
   DECLARE_SINGLETON(TaskManager);
 };
 
@@ -59,15 +59,21 @@ bool Timer::InitTimerTask() {
     return false;
   }
 
-  task_.reset(new TimerTask(timer_id_));
+  // GetStats reads task_ from other threads
+  std::shared_ptr<TimerTask> task(new TimerTask(timer_id_));
+  std::atomic_store(&task_, task);
   task_->interval_ms = timer_opt_.period;
   task_->next_fire_duration_ms = task_->interval_ms;
+  if (!timer_opt_.name.empty()) {
+    task_->dispatcher = timing_wheel_->GetDispatcher(timer_opt_.name);
+  }
   if (timer_opt_.oneshot) {
     std::weak_ptr<TimerTask> task_weak_ptr = task_;
     task_->callback = [callback = this->timer_opt_.callback, task_weak_ptr]() {
       auto task = task_weak_ptr.lock();
       if (task) {
         std::lock_guard<std::mutex> lg(task->mutex);
+        task->RecordFire(Time::MonoTime().ToNanosecond());
         callback();
       }
     };
@@ -80,6 +86,7 @@ bool Timer::InitTimerTask() {
       }
       std::lock_guard<std::mutex> lg(task->mutex);
       auto start = Time::MonoTime().ToNanosecond();
+      task->RecordFire(start);
       callback();
       auto end = Time::MonoTime().ToNanosecond();
       uint64_t execute_time_ns = end - start;
@@ -142,15 +149,44 @@ void Timer::Start() {
 void Timer::Stop() {
   if (started_.exchange(false) && task_) {
     AINFO << "stop timer, the timer_id: " << timer_id_;
+    TimerStats stats;
+    if (GetStats(&stats) && stats.fire_count > 0) {
+      AINFO << "timer [" << timer_id_ << "] fired " << stats.fire_count
+            << " times, lateness mean: " << stats.lateness_mean_us
+            << "us p99: " << stats.lateness_p99_us
+            << "us max: " << stats.lateness_max_us << "us, early "
+            << stats.early_count << " times by up to "
+            << stats.earliness_max_us << "us";
+    }
     // using a shared pointer to hold task_->mutex before task_ reset
     auto tmp_task = task_;
     {
       std::lock_guard<std::mutex> lg(tmp_task->mutex);
-      task_.reset();
+      std::atomic_store(&task_, std::shared_ptr<TimerTask>());
     }
   }
 }
 
+bool Timer::GetStats(TimerStats* stats) const {
+  auto task = std::atomic_load(&task_);
+  if (stats == nullptr || task == nullptr) {
+    return false;
+  }
+  constexpr double kNsPerUs = 1000.0;
+  std::lock_guard<std::mutex> lock(task->stats_mutex);
+  stats->fire_count = task->lateness.count();
+  stats->lateness_mean_us = task->lateness.mean() / kNsPerUs;
+  stats->lateness_p50_us =
+      static_cast<double>(task->lateness.Percentile(0.5)) / kNsPerUs;
+  stats->lateness_p99_us =
+      static_cast<double>(task->lateness.Percentile(0.99)) / kNsPerUs;
+  stats->lateness_max_us = static_cast<double>(task->lateness.max()) / kNsPerUs;
+  stats->early_count = task->early_count;
+  stats->earliness_max_us =
+      static_cast<double>(task->earliness_max_ns) / kNsPerUs;
+  return true;
+}
+
 Timer::~Timer() {
   if (task_) {
     Stop();
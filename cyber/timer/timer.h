@@ -19,6 +19,7 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
 
 #include "cyber/timer/timing_wheel.h"
 
@@ -61,6 +62,28 @@ struct TimerOption {
    * False: perform the callback every timed period
    */
   bool oneshot;
+
+  /**
+   * Timers with a name run in a croutine of that name, so the scheduler conf
+   * decides the group they run in, and all of them expiring in the same tick
+   * are dispatched at once. Timers without a name run on the task pool.
+   */
+  std::string name;
+};
+
+/**
+ * @brief Lateness of the callback starts against their due time, in
+ * microseconds. Callbacks started before their due time count as on time in
+ * the lateness and are counted in early_count.
+ */
+struct TimerStats {
+  uint64_t fire_count = 0;
+  double lateness_mean_us = 0.0;
+  double lateness_p50_us = 0.0;
+  double lateness_p99_us = 0.0;
+  double lateness_max_us = 0.0;
+  uint64_t early_count = 0;
+  double earliness_max_us = 0.0;
 };
 
 /**
@@ -109,6 +132,14 @@ class Timer {
    */
   void Stop();
 
+  /**
+   * @brief Get the jitter statistics since the timer started, safe to call
+   * from any thread
+   *
+   * @return false if the timer is not started
+   */
+  bool GetStats(TimerStats* stats) const;
+
  private:
   bool InitTimerTask();
   uint64_t timer_id_;
@@ -17,28 +17,33 @@
 #ifndef CYBER_TIMER_TIMER_BUCKET_H_
 #define CYBER_TIMER_TIMER_BUCKET_H_
 
-#include <list>
+#include <cstdint>
 #include <memory>
-#include <mutex>
+#include <utility>
+#include <vector>
 
 #include "cyber/timer/timer_task.h"
 
 namespace apollo {
 namespace cyber {
 
+struct TimerEntry {
+  std::weak_ptr<TimerTask> task;
+  // tick the task fires on
+  uint64_t fire_tick = 0;
+};
+
+/**
+ * @brief Tasks of one slot of a wheel, only touched by the tick thread
+ */
 class TimerBucket {
  public:
-  void AddTask(const std::shared_ptr<TimerTask>& task) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    task_list_.push_back(task);
-  }
+  void AddTask(TimerEntry&& entry) { entries_.emplace_back(std::move(entry)); }
 
-  std::mutex& mutex() { return mutex_; }
-  std::list<std::weak_ptr<TimerTask>>& task_list() { return task_list_; }
+  std::vector<TimerEntry>& entries() { return entries_; }
 
  private:
-  std::mutex mutex_;
-  std::list<std::weak_ptr<TimerTask>> task_list_;
+  std::vector<TimerEntry> entries_;
 };
 
 }  // namespace cyber
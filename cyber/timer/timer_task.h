@@ -17,16 +17,35 @@
 #ifndef CYBER_TIMER_TIMER_TASK_H_
 #define CYBER_TIMER_TIMER_TASK_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 
+#include "cyber/scheduler/common/histogram.h"
+
 namespace apollo {
 namespace cyber {
 
-class TimerBucket;
+class TimerDispatcher;
 
 struct TimerTask {
   explicit TimerTask(uint64_t timer_id) : timer_id_(timer_id) {}
+
+  // lateness of the callback start against the due time, a callback started
+  // up to a tick early counts as on time in the lateness and is reported on
+  // its own
+  void RecordFire(uint64_t start_ns) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    if (start_ns >= due_ns) {
+      lateness.Add(start_ns - due_ns);
+      return;
+    }
+    lateness.Add(0);
+    ++early_count;
+    earliness_max_ns = std::max(earliness_max_ns, due_ns - start_ns);
+  }
+
   uint64_t timer_id_ = 0;
   std::function<void()> callback;
   uint64_t interval_ms = 0;
@@ -34,7 +53,15 @@ struct TimerTask {
   uint64_t next_fire_duration_ms = 0;
   int64_t accumulated_error_ns = 0;
   uint64_t last_execute_time_ns = 0;
+  // monotonic time the callback should start, set by TimingWheel::AddTask
+  uint64_t due_ns = 0;
+  // nullptr to run the callback on the task pool
+  TimerDispatcher* dispatcher = nullptr;
   std::mutex mutex;
+  std::mutex stats_mutex;
+  scheduler::Histogram lateness;
+  uint64_t early_count = 0;
+  uint64_t earliness_max_ns = 0;
 };
 
 }  // namespace cyber
@@ -18,6 +18,7 @@
 
 #include "cyber/timer/timer.h"
 
+#include <atomic>
 #include <memory>
 #include <utility>
 
@@ -26,6 +27,7 @@
 #include "cyber/common/util.h"
 #include "cyber/cyber.h"
 #include "cyber/init.h"
+#include "cyber/timer/timer_task.h"
 
 namespace apollo {
 namespace cyber {
@@ -79,6 +81,68 @@ TEST(TimerTest, start_stop) {
   }
 }
 
+TEST(TimerTest, named_timer_stats) {
+  std::atomic<int> count = {0};
+  TimerOption opt(10, [&count] { count++; }, false);
+  opt.name = "timer_test_routine";
+  Timer timer(opt);
+  TimerStats stats;
+  EXPECT_FALSE(timer.GetStats(&stats));
+
+  timer.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  EXPECT_TRUE(timer.GetStats(&stats));
+  EXPECT_GT(stats.fire_count, 0);
+  EXPECT_GT(count.load(), 0);
+  EXPECT_LE(stats.lateness_p50_us, stats.lateness_max_us);
+  EXPECT_LE(stats.early_count, stats.fire_count);
+  timer.Stop();
+  EXPECT_FALSE(timer.GetStats(&stats));
+}
+
+TEST(TimerTest, named_timer_never_stalls) {
+  // Short periods on one routine make expiries land while it is about to hang
+  // up. A lost notification stops its periodic timers for good.
+  constexpr int kTimerNum = 4;
+  std::atomic<int> counts[kTimerNum];
+  std::unique_ptr<Timer> timers[kTimerNum];
+  for (int i = 0; i < kTimerNum; i++) {
+    counts[i] = 0;
+    auto count = &counts[i];
+    TimerOption opt(2 + i, [count] { (*count)++; }, false);
+    opt.name = "timer_test_stall_routine";
+    timers[i].reset(new Timer(opt));
+    timers[i]->Start();
+  }
+  int last[kTimerNum] = {0};
+  for (int round = 0; round < 30; round++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (int i = 0; i < kTimerNum; i++) {
+      int current = counts[i].load();
+      EXPECT_GT(current, last[i])
+          << "timer " << i << " stalled after " << current << " fires";
+      last[i] = current;
+    }
+  }
+  for (int i = 0; i < kTimerNum; i++) {
+    timers[i]->Stop();
+  }
+  EXPECT_GT(last[0], 500);
+}
+
+TEST(TimerTest, early_fire) {
+  TimerTask task(0);
+  task.due_ns = 5000000;
+  // 0.6ms early, then 2ms late
+  task.RecordFire(4400000);
+  task.due_ns = 10000000;
+  task.RecordFire(12000000);
+  EXPECT_EQ(2, task.lateness.count());
+  EXPECT_EQ(2000000, task.lateness.max());
+  EXPECT_EQ(1, task.early_count);
+  EXPECT_EQ(600000, task.earliness_max_ns);
+}
+
 TEST(TimerTest, sim_mode) {
   auto count = 0;
 
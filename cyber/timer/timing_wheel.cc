@@ -16,13 +16,87 @@
 
 #include "cyber/timer/timing_wheel.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <utility>
 
+#include "cyber/common/global_data.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/croutine/routine_factory.h"
 #include "cyber/task/task.h"
+#include "cyber/time/time.h"
 
 namespace apollo {
 namespace cyber {
 
+TimerDispatcher::TimerDispatcher(const std::string& name) : name_(name) {}
+
+TimerDispatcher::~TimerDispatcher() { Shutdown(); }
+
+bool TimerDispatcher::Init() {
+  // nobody waits on the queue, the routine hangs up until notified
+  if (!expired_.Init(kQueueSize, base::RingWaitMode::SPIN)) {
+    return false;
+  }
+  auto func = [this]() {
+    constexpr uint64_t kBatchSize = 16;
+    std::shared_ptr<TimerTask> tasks[kBatchSize];
+    // a Dispatch which does not see the routine yet is seen by the dequeue
+    routine_.store(croutine::CRoutine::GetCurrentRoutine());
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!stop_.load()) {
+      auto num = expired_.DequeueBulk(tasks, kBatchSize);
+      if (num == 0) {
+        croutine::CRoutine::GetCurrentRoutine()->HangUp();
+        continue;
+      }
+      for (uint64_t i = 0; i < num; ++i) {
+        tasks[i]->callback();
+        tasks[i].reset();
+      }
+    }
+  };
+  routine_id_ = common::GlobalData::RegisterTaskName(name_);
+  return scheduler::Instance()->CreateTask(
+      croutine::CreateRoutineFactory(std::move(func)), name_);
+}
+
+void TimerDispatcher::Shutdown() {
+  if (stop_.exchange(true) || routine_id_ == 0) {
+    return;
+  }
+  routine_.store(nullptr);
+  scheduler::Instance()->RemoveTask(name_);
+}
+
+bool TimerDispatcher::Dispatch(std::vector<std::shared_ptr<TimerTask>>* tasks) {
+  if (stop_.load()) {
+    return false;
+  }
+  auto num = expired_.EnqueueBulk(tasks->begin(), tasks->size());
+  if (num > 0) {
+    // The scheduler only sets the update flag of a routine in DATA_WAIT, so
+    // the notification is lost if the routine found the queue empty but has
+    // not hung up yet. Setting the flag here whatever the state makes the
+    // next schedule wake it. Otherwise a periodic timer, which is only added
+    // back by its callback, would stop for good.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto routine = routine_.load();
+    if (routine != nullptr) {
+      routine->SetUpdateFlag();
+    }
+    scheduler::Instance()->NotifyTask(routine_id_);
+    tasks->erase(tasks->begin(), tasks->begin() + num);
+  }
+  return tasks->empty();
+}
+
+TimingWheel::TimingWheel() {
+  pending_.Init(kPendingSize, base::RingWaitMode::SPIN);
+  drained_.resize(kPendingSize);
+}
+
 void TimingWheel::Start() {
   std::lock_guard<std::mutex> lock(running_mutex_);
   if (!running_) {
@@ -41,107 +115,142 @@ void TimingWheel::Shutdown() {
       tick_thread_.join();
     }
   }
-}
-
-void TimingWheel::Tick() {
-  auto& bucket = work_wheel_[current_work_wheel_index_];
-  {
-    std::lock_guard<std::mutex> lock(bucket.mutex());
-    auto ite = bucket.task_list().begin();
-    while (ite != bucket.task_list().end()) {
-      auto task = ite->lock();
-      if (task) {
-        ADEBUG << "index: " << current_work_wheel_index_
-               << " timer id: " << task->timer_id_;
-        auto* callback =
-            reinterpret_cast<std::function<void()>*>(&(task->callback));
-        cyber::Async([this, callback] {
-          if (this->running_) {
-            (*callback)();
-          }
-        });
-      }
-      ite = bucket.task_list().erase(ite);
+  std::lock_guard<std::mutex> dispatchers_lock(dispatchers_mutex_);
+  for (auto& dispatcher : dispatchers_) {
+    if (dispatcher.second != nullptr) {
+      dispatcher.second->Shutdown();
     }
   }
 }
 
 void TimingWheel::AddTask(const std::shared_ptr<TimerTask>& task) {
-  AddTask(task, current_work_wheel_index_);
-}
-
-void TimingWheel::AddTask(const std::shared_ptr<TimerTask>& task,
-                          const uint64_t current_work_wheel_index) {
   if (!running_) {
     Start();
   }
-  auto work_wheel_index = current_work_wheel_index +
-                          static_cast<uint64_t>(std::ceil(
-                              static_cast<double>(task->next_fire_duration_ms) /
-                              TIMER_RESOLUTION_MS));
-  if (work_wheel_index >= WORK_WHEEL_SIZE) {
-    auto real_work_wheel_index = GetWorkWheelIndex(work_wheel_index);
-    task->remainder_interval_ms = real_work_wheel_index;
-    auto assistant_ticks = work_wheel_index / WORK_WHEEL_SIZE;
-    if (assistant_ticks == 1 &&
-        real_work_wheel_index < current_work_wheel_index_) {
-      work_wheel_[real_work_wheel_index].AddTask(task);
-      ADEBUG << "add task to work wheel. index :" << real_work_wheel_index;
-    } else {
-      auto assistant_wheel_index = 0;
-      {
-        std::lock_guard<std::mutex> lock(current_assistant_wheel_index_mutex_);
-        assistant_wheel_index = GetAssistantWheelIndex(
-            current_assistant_wheel_index_ + assistant_ticks);
-        assistant_wheel_[assistant_wheel_index].AddTask(task);
-      }
-      ADEBUG << "add task to assistant wheel. index : "
-             << assistant_wheel_index;
+  task->due_ns =
+      Time::MonoTime().ToNanosecond() + task->next_fire_duration_ms * 1000000;
+  auto ticks = static_cast<uint64_t>(
+      std::ceil(static_cast<double>(task->next_fire_duration_ms) /
+                TIMER_RESOLUTION_MS));
+  TimerEntry entry;
+  entry.task = task;
+  entry.fire_tick = tick_count_.load(std::memory_order_acquire) +
+                    std::max<uint64_t>(ticks, 1) - 1;
+  while (!pending_.Enqueue(entry)) {
+    // the tick thread drains the queue every tick
+    if (!running_) {
+      AWARN << "timing wheel is shutdown, drop timer task [" << task->timer_id_
+            << "]";
+      return;
     }
+    std::this_thread::yield();
+  }
+  ADEBUG << "add task [" << task->timer_id_
+         << "] to fire at tick: " << entry.fire_tick;
+}
+
+TimerDispatcher* TimingWheel::GetDispatcher(const std::string& name) {
+  std::lock_guard<std::mutex> lock(dispatchers_mutex_);
+  auto it = dispatchers_.find(name);
+  if (it != dispatchers_.end()) {
+    return it->second.get();
+  }
+  std::unique_ptr<TimerDispatcher> dispatcher(new TimerDispatcher(name));
+  if (!dispatcher->Init()) {
+    AWARN << "create timer routine [" << name
+          << "] failed, run its timers on the task pool.";
+    dispatcher.reset();
+  }
+  auto result = dispatcher.get();
+  dispatchers_[name] = std::move(dispatcher);
+  return result;
+}
+
+void TimingWheel::Place(TimerEntry&& entry) {
+  uint64_t tick = tick_count_.load(std::memory_order_relaxed);
+  if (entry.fire_tick <= tick) {
+    work_wheel_[GetWorkWheelIndex(tick)].AddTask(std::move(entry));
+  } else if (entry.fire_tick - tick < WORK_WHEEL_SIZE) {
+    work_wheel_[GetWorkWheelIndex(entry.fire_tick)].AddTask(std::move(entry));
   } else {
-    work_wheel_[work_wheel_index].AddTask(task);
-    ADEBUG << "add task [" << task->timer_id_
-           << "] to work wheel. index :" << work_wheel_index;
+    // moved to the work wheel when the work wheel starts the round of the
+    // fire tick
+    auto index = GetAssistantWheelIndex(entry.fire_tick / WORK_WHEEL_SIZE);
+    assistant_wheel_[index].AddTask(std::move(entry));
   }
 }
 
 void TimingWheel::Cascade(const uint64_t assistant_wheel_index) {
-  auto& bucket = assistant_wheel_[assistant_wheel_index];
-  std::lock_guard<std::mutex> lock(bucket.mutex());
-  auto ite = bucket.task_list().begin();
-  while (ite != bucket.task_list().end()) {
-    auto task = ite->lock();
-    if (task) {
-      work_wheel_[task->remainder_interval_ms].AddTask(task);
+  std::vector<TimerEntry> entries;
+  entries.swap(assistant_wheel_[assistant_wheel_index].entries());
+  for (auto& entry : entries) {
+    Place(std::move(entry));
+  }
+}
+
+void TimingWheel::Fire(TimerEntry* entry) {
+  auto task = entry->task.lock();
+  if (!task) {
+    return;
+  }
+  ADEBUG << "tick: " << entry->fire_tick << " timer id: " << task->timer_id_;
+  if (task->dispatcher != nullptr) {
+    dispatched_[task->dispatcher].emplace_back(std::move(task));
+  } else {
+    pool_tasks_.emplace_back(std::move(task));
+  }
+}
+
+void TimingWheel::Tick() {
+  uint64_t tick = tick_count_.load(std::memory_order_relaxed);
+  uint64_t work_wheel_index = GetWorkWheelIndex(tick);
+  if (work_wheel_index == 0 && tick != 0) {
+    Cascade(GetAssistantWheelIndex(tick / WORK_WHEEL_SIZE));
+  }
+
+  uint64_t num = 0;
+  while ((num = pending_.DequeueBulk(drained_.data(), drained_.size())) > 0) {
+    for (uint64_t i = 0; i < num; ++i) {
+      Place(std::move(drained_[i]));
     }
-    ite = bucket.task_list().erase(ite);
   }
+
+  auto& entries = work_wheel_[work_wheel_index].entries();
+  for (auto& entry : entries) {
+    Fire(&entry);
+  }
+  entries.clear();
+
+  // all timers of a dispatcher expired in this tick are handed over at once
+  for (auto& dispatched : dispatched_) {
+    auto& tasks = dispatched.second;
+    if (tasks.empty() || dispatched.first->Dispatch(&tasks)) {
+      continue;
+    }
+    AWARN_EVERY(100) << "timer routine [" << dispatched.first->name()
+                     << "] is busy, run timers on the task pool.";
+    std::move(tasks.begin(), tasks.end(), std::back_inserter(pool_tasks_));
+    tasks.clear();
+  }
+  for (auto& task : pool_tasks_) {
+    cyber::Async([this, task] {
+      if (this->running_) {
+        task->callback();
+      }
+    });
+  }
+  pool_tasks_.clear();
+
+  tick_count_.store(tick + 1, std::memory_order_release);
 }
 
 void TimingWheel::TickFunc() {
   Rate rate(TIMER_RESOLUTION_MS * 1000000);  // ms to ns
   while (running_) {
     Tick();
-    // AINFO_EVERY(1000) << "Tick " << TickCount();
-    tick_count_++;
     rate.Sleep();
-    {
-      std::lock_guard<std::mutex> lock(current_work_wheel_index_mutex_);
-      current_work_wheel_index_ =
-          GetWorkWheelIndex(current_work_wheel_index_ + 1);
-    }
-    if (current_work_wheel_index_ == 0) {
-      {
-        std::lock_guard<std::mutex> lock(current_assistant_wheel_index_mutex_);
-        current_assistant_wheel_index_ =
-            GetAssistantWheelIndex(current_assistant_wheel_index_ + 1);
-      }
-      Cascade(current_assistant_wheel_index_);
-    }
   }
 }
 
-TimingWheel::TimingWheel() {}
-
 }  // namespace cyber
 }  // namespace apollo
@@ -17,13 +17,18 @@
 #ifndef CYBER_TIMER_TIMING_WHEEL_H_
 #define CYBER_TIMER_TIMING_WHEEL_H_
 
-#include <future>
-#include <list>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "cyber/base/mpmc_ring.h"
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
+#include "cyber/croutine/croutine.h"
 #include "cyber/scheduler/scheduler_factory.h"
 #include "cyber/time/rate.h"
 #include "cyber/timer/timer_bucket.h"
@@ -39,6 +44,42 @@ static const uint64_t TIMER_RESOLUTION_MS = 2;
 static const uint64_t TIMER_MAX_INTERVAL_MS =
     WORK_WHEEL_SIZE * ASSISTANT_WHEEL_SIZE * TIMER_RESOLUTION_MS;
 
+/**
+ * @class TimerDispatcher
+ * @brief A croutine running the expired timers of one name. The tick thread
+ * hands over all timers expired in a tick at once and notifies the croutine
+ * once, the scheduler conf of the name decides the group it runs in.
+ */
+class TimerDispatcher {
+ public:
+  explicit TimerDispatcher(const std::string& name);
+  ~TimerDispatcher();
+
+  bool Init();
+  void Shutdown();
+
+  bool Dispatch(std::vector<std::shared_ptr<TimerTask>>* tasks);
+
+  const std::string& name() const { return name_; }
+
+ private:
+  static constexpr uint32_t kQueueSize = 256;
+
+  std::string name_;
+  uint64_t routine_id_ = 0;
+  // set by the routine when it starts, removed only by Shutdown, which runs
+  // after the tick thread is joined
+  std::atomic<croutine::CRoutine*> routine_ = {nullptr};
+  std::atomic<bool> stop_ = {false};
+  base::MpmcRing<std::shared_ptr<TimerTask>> expired_;
+};
+
+/**
+ * @class TimingWheel
+ * @brief Two level timing wheel driven by a tick thread. AddTask only pushes
+ * to a lock free queue, the wheels are owned by the tick thread, which drains
+ * the queue every tick.
+ */
 class TimingWheel {
  public:
   ~TimingWheel() {
@@ -51,20 +92,24 @@ class TimingWheel {
 
   void Shutdown();
 
-  void Tick();
-
   void AddTask(const std::shared_ptr<TimerTask>& task);
 
-  void AddTask(const std::shared_ptr<TimerTask>& task,
-               const uint64_t current_work_wheel_index);
+  /**
+   * @brief The dispatcher running the timers of the name, created on first
+   * use. nullptr if the croutine can not be created, the timers then run on
+   * the task pool.
+   */
+  TimerDispatcher* GetDispatcher(const std::string& name);
 
-  void Cascade(const uint64_t assistant_wheel_index);
+  inline uint64_t TickCount() const { return tick_count_.load(); }
 
+ private:
+  void Tick();
+  void Place(TimerEntry&& entry);
+  void Cascade(const uint64_t assistant_wheel_index);
+  void Fire(TimerEntry* entry);
   void TickFunc();
 
-  inline uint64_t TickCount() const { return tick_count_; }
-
- private:
   inline uint64_t GetWorkWheelIndex(const uint64_t index) {
     return index & (WORK_WHEEL_SIZE - 1);
   }
@@ -72,17 +117,27 @@ class TimingWheel {
     return index & (ASSISTANT_WHEEL_SIZE - 1);
   }
 
-  bool running_ = false;
-  uint64_t tick_count_ = 0;
+  static constexpr uint32_t kPendingSize = 4096;
+
+  std::atomic<bool> running_ = {false};
+  // last tick processed by the tick thread
+  std::atomic<uint64_t> tick_count_ = {0};
   std::mutex running_mutex_;
+  base::MpmcRing<TimerEntry> pending_;
   TimerBucket work_wheel_[WORK_WHEEL_SIZE];
   TimerBucket assistant_wheel_[ASSISTANT_WHEEL_SIZE];
-  uint64_t current_work_wheel_index_ = 0;
-  std::mutex current_work_wheel_index_mutex_;
-  uint64_t current_assistant_wheel_index_ = 0;
-  std::mutex current_assistant_wheel_index_mutex_;
   std::thread tick_thread_;
 
+  // tick thread only
+  std::vector<TimerEntry> drained_;
+  std::vector<std::shared_ptr<TimerTask>> pool_tasks_;
+  std::unordered_map<TimerDispatcher*, std::vector<std::shared_ptr<TimerTask>>>
+      dispatched_;
+
+  std::mutex dispatchers_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<TimerDispatcher>>
+      dispatchers_;
+
   DECLARE_SINGLETON(TimingWheel)
 };
 
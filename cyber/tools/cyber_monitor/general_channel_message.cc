@@ -245,25 +245,26 @@ void GeneralChannelMessage::RenderDebugString(const Screen* s, int key,
 
       decltype(channel_message_) channel_msg = CopyMsgPtr();
 
-      if (channel_msg->message.size()) {
+      if (channel_msg->size()) {
         s->AddStr(0, (*line_no)++, "RawMessage Size: ");
         out_str.str("");
-        out_str << channel_msg->message.size() << " Bytes";
-        if (channel_msg->message.size() >= kGB) {
+        out_str << channel_msg->size() << " Bytes";
+        if (channel_msg->size() >= kGB) {
           out_str << " ("
-                  << static_cast<float>(channel_msg->message.size()) / kGB
+                  << static_cast<float>(channel_msg->size()) / kGB
                   << " GB)";
-        } else if (channel_msg->message.size() >= kMB) {
+        } else if (channel_msg->size() >= kMB) {
           out_str << " ("
-                  << static_cast<float>(channel_msg->message.size()) / kMB
+                  << static_cast<float>(channel_msg->size()) / kMB
                   << " MB)";
-        } else if (channel_msg->message.size() >= kKB) {
+        } else if (channel_msg->size() >= kKB) {
           out_str << " ("
-                  << static_cast<float>(channel_msg->message.size()) / kKB
+                  << static_cast<float>(channel_msg->size()) / kKB
                   << " KB)";
         }
         s->AddStr(out_str.str().c_str());
-        if (raw_msg_class_->ParseFromString(channel_msg->message)) {
+        if (raw_msg_class_->ParseFromArray(
+                channel_msg->data(), static_cast<int>(channel_msg->size()))) {
           int lcount = LineCount(*raw_msg_class_, s->Width());
           page_item_count_ = s->Height() - *line_no;
           pages_ = lcount / page_item_count_ + 1;
@@ -111,8 +111,8 @@ int GeneralMessage::Render(const Screen* s, int key) {
     clear();
 
     auto channel_msg = channel_msg_ptr->CopyMsgPtr();
-    if (!channel_msg_ptr->raw_msg_class_->ParseFromString(
-            channel_msg->message)) {
+    if (!channel_msg_ptr->raw_msg_class_->ParseFromArray(
+            channel_msg->data(), static_cast<int>(channel_msg->size()))) {
       s->AddStr(0, line_no++,
                 "Cannot Parse the message for Real-Time Updating");
       return line_no;
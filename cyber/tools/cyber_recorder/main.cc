@@ -42,7 +42,7 @@ using apollo::cyber::record::Recoverer;
 using apollo::cyber::record::Spliter;
 
 const char INFO_OPTIONS[] = "h";
-const char RECORD_OPTIONS[] = "o:ac:k:i:m:h";
+const char RECORD_OPTIONS[] = "o:ac:k:i:m:z:B:H:L:h";
 const char PLAY_OPTIONS[] = "f:ac:k:lr:b:e:s:d:p:h";
 const char SPLIT_OPTIONS[] = "f:o:c:k:b:e:h";
 const char RECOVER_OPTIONS[] = "f:o:h";
@@ -145,6 +145,25 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-m, --segment-size <MB>\t\t\t" << command
                   << " segmented every n megabyte(s)" << std::endl;
         break;
+      case 'z':
+        std::cout << "\t-z, --compress <lz4|zstd>\t\t" << command
+                  << " with compressed chunks" << std::endl;
+        break;
+      case 'B':
+        std::cout << "\t-B, --buffer-size <MB>\t\t\tdrop messages when more "
+                     "than n megabyte(s) wait for the disk"
+                  << std::endl;
+        break;
+      case 'H':
+        std::cout << "\t-H, --high-priority-channel <name>\tdrop the "
+                     "specified channel last"
+                  << std::endl;
+        break;
+      case 'L':
+        std::cout << "\t-L, --low-priority-channel <name>\tdrop the "
+                     "specified channel first"
+                  << std::endl;
+        break;
       case 'h':
         std::cout << "\t-h, --help\t\t\t\tshow help message" << std::endl;
         break;
@@ -170,7 +189,7 @@ int main(int argc, char** argv) {
   }
 
   int long_index = 0;
-  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:h";
+  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:z:B:H:L:h";
   static const struct option long_opts[] = {
       {"files", required_argument, nullptr, 'f'},
       {"white-channel", required_argument, nullptr, 'c'},
@@ -186,12 +205,19 @@ int main(int argc, char** argv) {
       {"preload", required_argument, nullptr, 'p'},
       {"segment-interval", required_argument, nullptr, 'i'},
       {"segment-size", required_argument, nullptr, 'm'},
+      {"compress", required_argument, nullptr, 'z'},
+      {"buffer-size", required_argument, nullptr, 'B'},
+      {"high-priority-channel", required_argument, nullptr, 'H'},
+      {"low-priority-channel", required_argument, nullptr, 'L'},
       {"help", no_argument, nullptr, 'h'}};
 
   std::vector<std::string> opt_file_vec;
   std::vector<std::string> opt_output_vec;
   std::vector<std::string> opt_white_channels;
   std::vector<std::string> opt_black_channels;
+  std::vector<std::string> opt_high_channels;
+  std::vector<std::string> opt_low_channels;
+  uint64_t opt_buffer_size = 0;
   bool opt_all = false;
   bool opt_loop = false;
   float opt_rate = 1.0f;
@@ -346,6 +372,58 @@ int main(int argc, char** argv) {
           return -1;
         }
         break;
+      case 'z': {
+        const std::string compress(optarg);
+        if (compress == "lz4") {
+          opt_header.set_compress(apollo::cyber::proto::COMPRESS_LZ4);
+        } else if (compress == "zstd") {
+          opt_header.set_compress(apollo::cyber::proto::COMPRESS_ZSTD);
+        } else {
+          std::cout << "Invalid argument: -z/--compress " << compress
+                    << std::endl;
+          return -1;
+        }
+        break;
+      }
+      case 'B':
+        try {
+          int size_mb = std::stoi(optarg);
+          if (size_mb < 0) {
+            std::cout << "Argument is less than zero: -B/--buffer-size "
+                      << std::string(optarg) << std::endl;
+            return -1;
+          }
+          opt_buffer_size = size_mb * 1024 * 1024ULL;
+        } catch (std::invalid_argument& ia) {
+          std::cout << "Invalid argument: -B/--buffer-size "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        } catch (const std::out_of_range& e) {
+          std::cout << "Argument is out of range: -B/--buffer-size "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        }
+        break;
+      case 'H':
+        opt_high_channels.emplace_back(std::string(optarg));
+        for (int i = optind; i < argc; i++) {
+          if (*argv[i] != '-') {
+            opt_high_channels.emplace_back(std::string(argv[i]));
+          } else {
+            break;
+          }
+        }
+        break;
+      case 'L':
+        opt_low_channels.emplace_back(std::string(optarg));
+        for (int i = optind; i < argc; i++) {
+          if (*argv[i] != '-') {
+            opt_low_channels.emplace_back(std::string(argv[i]));
+          } else {
+            break;
+          }
+        }
+        break;
       case 'h':
         DisplayUsage(binary, command);
         return 0;
@@ -426,6 +504,8 @@ int main(int argc, char** argv) {
     auto recorder = std::make_shared<Recorder>(opt_output_vec[0], opt_all,
                                                opt_white_channels,
                                                opt_black_channels, opt_header);
+    recorder->SetWriteBufferSize(opt_buffer_size);
+    recorder->SetChannelPriority(opt_high_channels, opt_low_channels);
     bool record_result = recorder->Start();
     if (record_result) {
       while (!::apollo::cyber::IsShutdown()) {
@@ -46,6 +46,17 @@ Recorder::Recorder(const std::string& output, bool all_channels,
 
 Recorder::~Recorder() { Stop(); }
 
+void Recorder::SetWriteBufferSize(uint64_t size_bytes) {
+  write_buffer_size_ = size_bytes;
+}
+
+void Recorder::SetChannelPriority(
+    const std::vector<std::string>& high_channels,
+    const std::vector<std::string>& low_channels) {
+  high_channels_ = high_channels;
+  low_channels_ = low_channels;
+}
+
 bool Recorder::Start() {
   for (const auto& channel_name : white_channels_) {
     if (std::find(black_channels_.begin(), black_channels_.end(),
@@ -79,6 +90,13 @@ bool Recorder::Start() {
   get_patterns_func(black_channels_, &black_channel_patterns_);
 
   writer_.reset(new RecordWriter(header_));
+  writer_->SetWriteBufferSize(write_buffer_size_);
+  for (const auto& channel_name : high_channels_) {
+    writer_->SetChannelPriority(channel_name, ChannelPriority::HIGH);
+  }
+  for (const auto& channel_name : low_channels_) {
+    writer_->SetChannelPriority(channel_name, ChannelPriority::LOW);
+  }
   if (!writer_->Open(output_)) {
     AERROR << "Datafile open file error.";
     return false;
@@ -264,7 +282,8 @@ void Recorder::ReaderCallback(const std::shared_ptr<RawMessage>& message,
 
   message_time_ = Time::Now().ToNanosecond();
   if (!writer_->WriteMessage(channel_name, message, message_time_)) {
-    AERROR << "write data fail, channel: " << channel_name;
+    // also fails when dropped, which the writer reports itself
+    AERROR_EVERY(100) << "write data fail, channel: " << channel_name;
     return;
   }
 
@@ -277,6 +296,10 @@ void Recorder::ShowProgress() {
               << message_time_ / 1000000000
               << "    Progress: " << channel_reader_map_.size() << " channels, "
               << message_count_ << " messages";
+    auto stats = writer_->GetWriterStats();
+    if (stats.dropped_messages > 0) {
+      std::cout << ", " << stats.dropped_messages << " dropped";
+    }
     std::cout.flush();
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
   }
@@ -56,6 +56,15 @@ class Recorder : public std::enable_shared_from_this<Recorder> {
            const std::vector<std::string>& black_channels,
            const proto::Header& header);
   ~Recorder();
+
+  /**
+   * @brief Messages are dropped, low priority channels first, when more than
+   * size_bytes wait for the disk. 0 for no limit. Call before Start.
+   */
+  void SetWriteBufferSize(uint64_t size_bytes);
+  void SetChannelPriority(const std::vector<std::string>& high_channels,
+                          const std::vector<std::string>& low_channels);
+
   bool Start();
   bool Stop();
 
@@ -73,6 +82,9 @@ class Recorder : public std::enable_shared_from_this<Recorder> {
   std::vector<std::string> black_channels_;
   std::vector<std::regex> black_channel_patterns_;
   proto::Header header_;
+  uint64_t write_buffer_size_ = 0;
+  std::vector<std::string> high_channels_;
+  std::vector<std::string> low_channels_;
   std::unordered_map<std::string, std::shared_ptr<ReaderBase>>
       channel_reader_map_;
   uint64_t message_count_;
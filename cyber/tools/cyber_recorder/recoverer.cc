@@ -41,6 +41,7 @@ bool Recoverer::Proc() {
 
   // open output file
   proto::Header new_hdr = HeaderBuilder::GetHeader();
+  new_hdr.set_compress(reader_.GetHeader().compress());
   if (!writer_.Open(output_file_)) {
     AERROR << "open output file failed. file: " << output_file_;
     return false;
@@ -103,9 +104,10 @@ bool Recoverer::Proc() {
         }
         break;
       }
-      case SectionType::SECTION_CHUNK_BODY: {
+      case SectionType::SECTION_CHUNK_BODY:
+      case SectionType::SECTION_CHUNK_BODY_COMPRESSED: {
         ChunkBody cbd;
-        if (!reader_.ReadSection<ChunkBody>(section.size, &cbd)) {
+        if (!reader_.ReadChunkBody(section, &cbd)) {
           AINFO << "one chunk body section broken, skip it";
           break;
         }
@@ -68,6 +68,7 @@ bool Spliter::Proc() {
 
   // open output file
   Header new_hdr = HeaderBuilder::GetHeader();
+  new_hdr.set_compress(header.compress());
   if (!writer_.Open(output_file_)) {
     AERROR << "open output file failed. file: " << output_file_;
     return false;
@@ -117,14 +118,15 @@ bool Spliter::Proc() {
         }
         break;
       }
-      case SectionType::SECTION_CHUNK_BODY: {
+      case SectionType::SECTION_CHUNK_BODY:
+      case SectionType::SECTION_CHUNK_BODY_COMPRESSED: {
         if (skip_next_chunk_body) {
           reader_.SkipSection(section.size);
           skip_next_chunk_body = false;
           break;
         }
         ChunkBody cbd;
-        if (!reader_.ReadSection<ChunkBody>(section.size, &cbd)) {
+        if (!reader_.ReadChunkBody(section, &cbd)) {
           AERROR << "read chunk body section fail.";
           return false;
         }
@@ -20,6 +20,8 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+thread_local MessageConversion* MessageConversion::current_ = nullptr;
+
 IntraDispatcher::IntraDispatcher() { chain_.reset(new ChannelChain()); }
 
 IntraDispatcher::~IntraDispatcher() {}
@@ -17,12 +17,15 @@
 #ifndef CYBER_TRANSPORT_DISPATCHER_INTRA_DISPATCHER_H_
 #define CYBER_TRANSPORT_DISPATCHER_INTRA_DISPATCHER_H_
 
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 
+#include "cyber/base/atomic_hash_map.h"
 #include "cyber/base/atomic_rw_lock.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
@@ -43,6 +46,113 @@ template <typename MessageT>
 using MessageListener =
     std::function<void(const std::shared_ptr<MessageT>&, const MessageInfo&)>;
 
+// how often the messages of a channel took the slow path
+struct ChannelChainStats {
+  // messages written to the channel
+  uint64_t messages = 0;
+  // messages serialized for handlers of another type than the writer's
+  uint64_t serialized = 0;
+  // handler runs fed from the serialized bytes
+  uint64_t converted = 0;
+};
+
+// The message being dispatched, and its serialized form once a handler of
+// another type asked for it. The message is serialized at most once and the
+// bytes are shared by every such handler, RawMessage handlers get them
+// without a copy. A handler writing to a channel starts a nested
+// conversion, the innermost one is current.
+class MessageConversion {
+ public:
+  template <typename MessageT>
+  MessageConversion(uint64_t channel_id, const std::string& message_type,
+                    const std::shared_ptr<MessageT>& message)
+      : channel_id_(channel_id),
+        message_type_(message_type),
+        message_(&message),
+        serialize_(&Serialize<MessageT>),
+        run_(&RunMessage<MessageT>),
+        prev_(current_) {
+    current_ = this;
+  }
+  ~MessageConversion() { current_ = prev_; }
+
+  // the conversion of the message dispatched on channel_id by this thread
+  static MessageConversion* Current(uint64_t channel_id) {
+    if (current_ != nullptr && current_->channel_id_ == channel_id) {
+      return current_;
+    }
+    return nullptr;
+  }
+
+  const std::string& message_type() const { return message_type_; }
+  bool serialized() const { return serialized_; }
+  uint64_t converted() const { return converted_; }
+
+  // handler must be of message_type()
+  void Run(ListenerHandlerBase* handler, const MessageInfo& message_info) {
+    run_(message_, handler, message_info);
+  }
+
+  bool RunFromSerialized(ListenerHandlerBase* handler,
+                         const MessageInfo& message_info) {
+    if (!serialized_) {
+      serialized_ = true;
+      if (!serialize_(message_, &raw_, &type_name_)) {
+        AERROR << "Failed to serialize message. channel["
+               << GlobalData::GetChannelById(channel_id_) << "]";
+        raw_ = nullptr;
+      }
+    }
+    if (raw_ == nullptr) {
+      return false;
+    }
+    ++converted_;
+    handler->RunFromRawMessage(raw_, type_name_, message_info);
+    return true;
+  }
+
+ private:
+  using RawMessagePtr = std::shared_ptr<message::RawMessage>;
+
+  template <typename MessageT>
+  static bool Serialize(const void* message, RawMessagePtr* raw,
+                        std::string* type_name) {
+    auto& msg = *static_cast<const std::shared_ptr<MessageT>*>(message);
+    *raw = std::make_shared<message::RawMessage>();
+    *type_name = message::MessageType(*msg);
+    return message::SerializeToString(*msg, &(*raw)->message);
+  }
+
+  template <typename MessageT>
+  static void RunMessage(const void* message, ListenerHandlerBase* handler,
+                         const MessageInfo& message_info) {
+    static_cast<ListenerHandler<MessageT>*>(handler)->Run(
+        *static_cast<const std::shared_ptr<MessageT>*>(message), message_info);
+  }
+
+  uint64_t channel_id_;
+  const std::string& message_type_;
+  const void* message_;
+  bool (*serialize_)(const void*, RawMessagePtr*, std::string*);
+  void (*run_)(const void*, ListenerHandlerBase*, const MessageInfo&);
+  bool serialized_ = false;
+  RawMessagePtr raw_ = nullptr;
+  std::string type_name_;
+  uint64_t converted_ = 0;
+  MessageConversion* prev_;
+
+  static thread_local MessageConversion* current_;
+};
+
+// a RawMessage is its own serialized form
+template <>
+inline bool MessageConversion::Serialize<message::RawMessage>(
+    const void* message, RawMessagePtr* raw, std::string* type_name) {
+  *raw = *static_cast<const RawMessagePtr*>(message);
+  *type_name = message::MessageType(**raw);
+  return true;
+}
+
 // use a channel chain to wrap specific ListenerHandler.
 // If the message is MessageT, then we use pointer directly, or we first parse
 // to a string, and use it to serialise to another message type.
@@ -51,10 +161,17 @@ class ChannelChain {
       std::map<uint64_t, std::map<std::string, ListenerHandlerBasePtr>>;
 
  public:
+  struct Counters {
+    std::atomic<uint64_t> messages = {0};
+    std::atomic<uint64_t> serialized = {0};
+    std::atomic<uint64_t> converted = {0};
+  };
+
   template <typename MessageT>
   bool AddListener(uint64_t self_id, uint64_t channel_id,
                    const std::string& message_type,
                    const MessageListener<MessageT>& listener) {
+    AddCounters(channel_id);
     WriteLockGuard<base::AtomicRWLock> lg(rw_lock_);
     auto ret = GetHandler<MessageT>(channel_id, message_type, &handlers_);
     auto handler = ret.first;
@@ -72,6 +189,7 @@ class ChannelChain {
   bool AddListener(uint64_t self_id, uint64_t oppo_id, uint64_t channel_id,
                    const std::string& message_type,
                    const MessageListener<MessageT>& listener) {
+    AddCounters(channel_id);
     WriteLockGuard<base::AtomicRWLock> lg(oppo_rw_lock_);
     if (oppo_handlers_.find(oppo_id) == oppo_handlers_.end()) {
       oppo_handlers_[oppo_id] = BaseHandlersType();
@@ -138,7 +256,32 @@ class ChannelChain {
     Run(channel_id, message_type, handlers, message, message_info);
   }
 
+  // counters of the channel, kept after its listeners are gone
+  Counters* GetCounters(uint64_t channel_id) {
+    Counters* counters = nullptr;
+    counters_.Get(channel_id, &counters);
+    return counters;
+  }
+
+  bool GetStats(uint64_t channel_id, ChannelChainStats* stats) {
+    auto counters = GetCounters(channel_id);
+    if (counters == nullptr) {
+      return false;
+    }
+    stats->messages = counters->messages.load(std::memory_order_relaxed);
+    stats->serialized = counters->serialized.load(std::memory_order_relaxed);
+    stats->converted = counters->converted.load(std::memory_order_relaxed);
+    return true;
+  }
+
  private:
+  void AddCounters(uint64_t channel_id) {
+    std::lock_guard<std::mutex> lock(counters_mutex_);
+    if (!counters_.Has(channel_id)) {
+      counters_.Set(channel_id);
+    }
+  }
+
   // NOTE: lock hold
   template <typename MessageT>
   std::pair<std::shared_ptr<ListenerHandler<MessageT>>, bool> GetHandler(
@@ -207,37 +350,40 @@ class ChannelChain {
     ADEBUG << GlobalData::GetChannelById(channel_id)
            << "'s chain run, size: " << channel_handlers.size()
            << ", message type: " << message_type;
-    std::string msg;
-    for (const auto& ele : channel_handlers) {
-      auto handler_base = ele.second;
+    // set up by IntraDispatcher::OnMessage, shared by the self and the
+    // opposite handlers
+    auto conversion = MessageConversion::Current(channel_id);
+    if (conversion == nullptr) {
+      MessageConversion local(channel_id, message_type, message);
+      Run(message_type, channel_handlers, message, message_info, &local);
+    } else {
+      Run(message_type, channel_handlers, message, message_info, conversion);
+    }
+  }
+
+  template <typename MessageT>
+  void Run(const std::string& message_type,
+           const std::map<std::string, ListenerHandlerBasePtr>& handlers,
+           const std::shared_ptr<MessageT>& message,
+           const MessageInfo& message_info, MessageConversion* conversion) {
+    for (const auto& ele : handlers) {
+      auto handler_base = ele.second.get();
       if (message_type == ele.first) {
         ADEBUG << "Run handler for message type: " << ele.first << " directly";
-        auto handler =
-            std::static_pointer_cast<ListenerHandler<MessageT>>(handler_base);
+        auto handler = static_cast<ListenerHandler<MessageT>*>(handler_base);
         if (handler == nullptr) {
           continue;
         }
         handler->Run(message, message_info);
+      } else if (conversion->message_type() == ele.first) {
+        // message was converted from the type of the writer in OnMessage
+        ADEBUG << "Run handler for message type: " << ele.first
+               << " with the written message";
+        conversion->Run(handler_base, message_info);
       } else {
         ADEBUG << "Run handler for message type: " << ele.first
                << " from string";
-        if (msg.empty()) {
-          auto msg_size = message::FullByteSize(*message);
-          if (msg_size < 0) {
-            AERROR << "Failed to get message size. channel["
-                   << common::GlobalData::GetChannelById(channel_id) << "]";
-            continue;
-          }
-          msg.resize(msg_size);
-          if (!message::SerializeToHC(*message, const_cast<char*>(msg.data()),
-                                      msg_size)) {
-            AERROR << "Chain Serialize error for channel id: " << channel_id;
-            msg.clear();
-          }
-        }
-        if (!msg.empty()) {
-          (handler_base)->RunFromString(msg, message_info);
-        }
+        conversion->RunFromSerialized(handler_base, message_info);
       }
     }
   }
@@ -246,6 +392,9 @@ class ChannelChain {
   base::AtomicRWLock rw_lock_;
   std::map<uint64_t, BaseHandlersType> oppo_handlers_;
   base::AtomicRWLock oppo_rw_lock_;
+  // key: channel_id
+  base::AtomicHashMap<uint64_t, Counters> counters_;
+  std::mutex counters_mutex_;
 };
 
 class IntraDispatcher : public Dispatcher {
@@ -272,12 +421,28 @@ class IntraDispatcher : public Dispatcher {
   void RemoveListener(const RoleAttributes& self_attr,
                       const RoleAttributes& opposite_attr);
 
+  /**
+   * @brief How often the messages of a channel were converted for readers of
+   * another message type than the writer's
+   *
+   * @return false if the channel never had a reader
+   */
+  bool GetChainStats(uint64_t channel_id, ChannelChainStats* stats) {
+    return chain_->GetStats(channel_id, stats);
+  }
+
   DECLARE_SINGLETON(IntraDispatcher)
 
  private:
   template <typename MessageT>
   std::shared_ptr<ListenerHandler<MessageT>> GetHandler(uint64_t channel_id);
 
+  template <typename MessageT>
+  static const std::string& MessageName() {
+    static const std::string name = message::GetMessageName<MessageT>();
+    return name;
+  }
+
   ChannelChainPtr chain_;
 };
 
@@ -291,27 +456,26 @@ void IntraDispatcher::OnMessage(uint64_t channel_id,
   ListenerHandlerBasePtr* handler_base = nullptr;
   ADEBUG << "intra on message, channel:"
          << common::GlobalData::GetChannelById(channel_id);
-  if (msg_listeners_.Get(channel_id, &handler_base)) {
-    auto handler =
-        std::dynamic_pointer_cast<ListenerHandler<MessageT>>(*handler_base);
-    if (handler) {
-      handler->Run(message, message_info);
-    } else {
-      auto msg_size = message::FullByteSize(*message);
-      if (msg_size < 0) {
-        AERROR << "Failed to get message size. channel["
-               << common::GlobalData::GetChannelById(channel_id) << "]";
-        return;
-      }
-      std::string msg;
-      msg.resize(msg_size);
-      if (message::SerializeToHC(*message, const_cast<char*>(msg.data()),
-                                 msg_size)) {
-        (*handler_base)->RunFromString(msg, message_info);
-      } else {
-        AERROR << "Failed to serialize message. channel["
-               << common::GlobalData::GetChannelById(channel_id) << "]";
-      }
+  if (!msg_listeners_.Get(channel_id, &handler_base)) {
+    return;
+  }
+
+  MessageConversion conversion(channel_id, MessageName<MessageT>(), message);
+  auto handler =
+      std::dynamic_pointer_cast<ListenerHandler<MessageT>>(*handler_base);
+  if (handler) {
+    handler->Run(message, message_info);
+  } else {
+    conversion.RunFromSerialized(handler_base->get(), message_info);
+  }
+
+  auto counters = chain_->GetCounters(channel_id);
+  if (counters != nullptr) {
+    counters->messages.fetch_add(1, std::memory_order_relaxed);
+    if (conversion.serialized()) {
+      counters->serialized.fetch_add(1, std::memory_order_relaxed);
+      counters->converted.fetch_add(conversion.converted(),
+                                    std::memory_order_relaxed);
     }
   }
 }
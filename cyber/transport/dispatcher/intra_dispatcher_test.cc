@@ -124,6 +124,94 @@ TEST(DispatcherTest, on_message) {
   EXPECT_EQ(0, raw_msgs.size());
 }
 
+TEST(DispatcherTest, conversion) {
+  auto dispatcher = IntraDispatcher::Instance();
+  std::vector<std::shared_ptr<proto::Chatter>> chatter_msgs;
+  std::vector<std::shared_ptr<message::RawMessage>> raw_msgs;
+  std::vector<std::shared_ptr<proto::ChatterBenchmark>> benchmark_msgs;
+  auto chatter_callback = [&chatter_msgs](
+                              const std::shared_ptr<proto::Chatter>& msg,
+                              const MessageInfo&) {
+    chatter_msgs.push_back(msg);
+  };
+  auto raw_callback = [&raw_msgs](
+                          const std::shared_ptr<message::RawMessage>& msg,
+                          const MessageInfo&) { raw_msgs.push_back(msg); };
+  auto benchmark_callback =
+      [&benchmark_msgs](const std::shared_ptr<proto::ChatterBenchmark>& msg,
+                        const MessageInfo&) { benchmark_msgs.push_back(msg); };
+
+  const std::string channel_name = "conversion";
+  const uint64_t channel_id = common::Hash(channel_name);
+  proto::RoleAttributes chatter_attr;
+  chatter_attr.set_channel_name(channel_name);
+  chatter_attr.set_channel_id(channel_id);
+  chatter_attr.set_id(Identity().HashValue());
+  proto::RoleAttributes raw_attr(chatter_attr);
+  raw_attr.set_id(Identity().HashValue());
+  proto::RoleAttributes benchmark_attr(chatter_attr);
+  benchmark_attr.set_id(Identity().HashValue());
+  proto::RoleAttributes oppo_attr(chatter_attr);
+  Identity oppo;
+  oppo_attr.set_id(oppo.HashValue());
+
+  dispatcher->AddListener<proto::Chatter>(chatter_attr, chatter_callback);
+  dispatcher->AddListener<message::RawMessage>(raw_attr, raw_callback);
+  dispatcher->AddListener<proto::ChatterBenchmark>(benchmark_attr,
+                                                   benchmark_callback);
+  dispatcher->AddListener<proto::Chatter>(chatter_attr, oppo_attr,
+                                          chatter_callback);
+  dispatcher->AddListener<message::RawMessage>(raw_attr, oppo_attr,
+                                               raw_callback);
+
+  // serialized once for the raw and the benchmark handlers, the raw readers
+  // share the bytes
+  auto chatter = std::make_shared<proto::Chatter>();
+  chatter->set_content("chatter");
+  std::string str;
+  chatter->SerializeToString(&str);
+  MessageInfo msg_info;
+  msg_info.set_sender_id(oppo);
+  dispatcher->OnMessage<proto::Chatter>(channel_id, chatter, msg_info);
+  ASSERT_EQ(2, chatter_msgs.size());
+  EXPECT_EQ(chatter, chatter_msgs[0]);
+  EXPECT_EQ(chatter, chatter_msgs[1]);
+  ASSERT_EQ(2, raw_msgs.size());
+  EXPECT_EQ(raw_msgs[0], raw_msgs[1]);
+  EXPECT_EQ(str, raw_msgs[0]->message);
+  EXPECT_EQ(1, benchmark_msgs.size());
+
+  ChannelChainStats stats;
+  EXPECT_TRUE(dispatcher->GetChainStats(channel_id, &stats));
+  EXPECT_EQ(1, stats.messages);
+  EXPECT_EQ(1, stats.serialized);
+  EXPECT_EQ(3, stats.converted);
+
+  // raw readers get the written message, the chatter handler is fed from it
+  auto raw = std::make_shared<message::RawMessage>(str);
+  dispatcher->OnMessage<message::RawMessage>(channel_id, raw, msg_info);
+  ASSERT_EQ(4, chatter_msgs.size());
+  EXPECT_EQ("chatter", chatter_msgs[2]->content());
+  ASSERT_EQ(4, raw_msgs.size());
+  EXPECT_EQ(raw, raw_msgs[2]);
+  EXPECT_EQ(raw, raw_msgs[3]);
+  EXPECT_EQ(2, benchmark_msgs.size());
+
+  EXPECT_TRUE(dispatcher->GetChainStats(channel_id, &stats));
+  EXPECT_EQ(2, stats.messages);
+  EXPECT_EQ(2, stats.serialized);
+  EXPECT_EQ(5, stats.converted);
+
+  EXPECT_FALSE(
+      dispatcher->GetChainStats(common::Hash("no_conversion"), &stats));
+
+  dispatcher->RemoveListener<proto::Chatter>(chatter_attr);
+  dispatcher->RemoveListener<message::RawMessage>(raw_attr);
+  dispatcher->RemoveListener<proto::ChatterBenchmark>(benchmark_attr);
+  dispatcher->RemoveListener<proto::Chatter>(chatter_attr, oppo_attr);
+  dispatcher->RemoveListener<message::RawMessage>(raw_attr, oppo_attr);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -45,30 +45,41 @@ void ShmDispatcher::Shutdown() {
   }
 }
 
-void ShmDispatcher::AddSegment(const RoleAttributes& self_attr) {
+void ShmDispatcher::AddSegment(const RoleAttributes& self_attr,
+                               bool read_in_place) {
   uint64_t channel_id = self_attr.channel_id();
   WriteLockGuard<AtomicRWLock> lock(segments_lock_);
+  if (read_in_place) {
+    in_place_channels_.insert(channel_id);
+  }
   if (segments_.count(channel_id) > 0) {
     return;
   }
   auto segment = SegmentFactory::CreateSegment(channel_id);
   segments_[channel_id] = segment;
   previous_indexes_[channel_id] = UINT32_MAX;
+  notifier_->Subscribe(channel_id);
 }
 
 void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
   ADEBUG << "Reading sharedmem message: "
          << GlobalData::GetChannelById(channel_id)
          << " from block: " << block_index;
+  auto& segment = segments_[channel_id];
   auto rb = std::make_shared<ReadableBlock>();
   rb->index = block_index;
-  if (!segments_[channel_id]->AcquireBlockToRead(rb.get())) {
+  if (!segment->AcquireBlockToRead(rb.get())) {
     AWARN << "fail to acquire block, channel: "
           << GlobalData::GetChannelById(channel_id)
           << " index: " << block_index;
     return;
   }
 
+  // the view releases the block once the readers dropped the messages read
+  // in place from it
+  bool viewed = in_place_channels_.count(channel_id) > 0 &&
+                segment->ViewReadBlock(rb.get());
+
   MessageInfo msg_info;
   const char* msg_info_addr =
       reinterpret_cast<char*>(rb->buf) + rb->block->msg_size();
@@ -79,7 +90,9 @@ void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
     AERROR << "error msg info of channel:"
            << GlobalData::GetChannelById(channel_id);
   }
-  segments_[channel_id]->ReleaseReadBlock(*rb);
+  if (!viewed) {
+    segment->ReleaseReadBlock(*rb);
+  }
 }
 
 void ShmDispatcher::OnMessage(uint64_t channel_id,
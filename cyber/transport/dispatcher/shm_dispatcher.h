@@ -21,13 +21,16 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "cyber/base/atomic_rw_lock.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
 #include "cyber/message/message_traits.h"
+#include "cyber/message/raw_message.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
 #include "cyber/transport/shm/notifier_factory.h"
 #include "cyber/transport/shm/segment_factory.h"
@@ -61,7 +64,35 @@ class ShmDispatcher : public Dispatcher {
                    const MessageListener<MessageT>& listener);
 
  private:
-  void AddSegment(const RoleAttributes& self_attr);
+  // Flat messages and raw messages are read in place, without a parse step,
+  // as long as the segment has views left. The block stays read locked until
+  // the last reference to the message is dropped, and readers must not
+  // modify such messages. Otherwise flat messages are copied out of the block
+  // with a single memcpy and raw messages copy their bytes.
+  template <typename MessageT>
+  struct IsReadInPlace {
+    static constexpr bool value =
+        message::IsFlatMessage<MessageT>::value ||
+        std::is_same<MessageT, message::RawMessage>::value;
+  };
+
+  template <typename MessageT>
+  static typename std::enable_if<message::IsFlatMessage<MessageT>::value,
+                                 std::shared_ptr<MessageT>>::type
+  ToMessage(const std::shared_ptr<ReadableBlock>& rb);
+
+  template <typename MessageT>
+  static typename std::enable_if<
+      std::is_same<MessageT, message::RawMessage>::value,
+      std::shared_ptr<MessageT>>::type
+  ToMessage(const std::shared_ptr<ReadableBlock>& rb);
+
+  template <typename MessageT>
+  static typename std::enable_if<!IsReadInPlace<MessageT>::value,
+                                 std::shared_ptr<MessageT>>::type
+  ToMessage(const std::shared_ptr<ReadableBlock>& rb);
+
+  void AddSegment(const RoleAttributes& self_attr, bool read_in_place);
   void ReadMessage(uint64_t channel_id, uint32_t block_index);
   void OnMessage(uint64_t channel_id, const std::shared_ptr<ReadableBlock>& rb,
                  const MessageInfo& msg_info);
@@ -71,6 +102,8 @@ class ShmDispatcher : public Dispatcher {
   uint64_t host_id_;
   SegmentContainer segments_;
   std::unordered_map<uint64_t, uint32_t> previous_indexes_;
+  // channels with readers of messages read in place
+  std::unordered_set<uint64_t> in_place_channels_;
   AtomicRWLock segments_lock_;
   std::thread thread_;
   NotifierPtr notifier_;
@@ -78,38 +111,81 @@ class ShmDispatcher : public Dispatcher {
   DECLARE_SINGLETON(ShmDispatcher)
 };
 
+template <typename MessageT>
+typename std::enable_if<message::IsFlatMessage<MessageT>::value,
+                        std::shared_ptr<MessageT>>::type
+ShmDispatcher::ToMessage(const std::shared_ptr<ReadableBlock>& rb) {
+  if (rb->block->msg_size() != sizeof(MessageT)) {
+    AERROR << "flat message size mismatch, expect " << sizeof(MessageT)
+           << " but got " << rb->block->msg_size();
+    return nullptr;
+  }
+  if (rb->view != nullptr &&
+      reinterpret_cast<uintptr_t>(rb->buf) % alignof(MessageT) == 0) {
+    return std::shared_ptr<MessageT>(rb->view,
+                                     reinterpret_cast<MessageT*>(rb->buf));
+  }
+  auto msg = std::make_shared<MessageT>();
+  std::memcpy(static_cast<void*>(msg.get()), rb->buf, sizeof(MessageT));
+  return msg;
+}
+
+template <typename MessageT>
+typename std::enable_if<std::is_same<MessageT, message::RawMessage>::value,
+                        std::shared_ptr<MessageT>>::type
+ShmDispatcher::ToMessage(const std::shared_ptr<ReadableBlock>& rb) {
+  auto msg = std::make_shared<MessageT>();
+  auto size = rb->block->msg_size();
+  if (rb->view != nullptr && size > 0) {
+    msg->SetView(rb->view, reinterpret_cast<const char*>(rb->buf), size);
+    return msg;
+  }
+  if (!msg->ParseFromArray(rb->buf, static_cast<int>(size))) {
+    return nullptr;
+  }
+  return msg;
+}
+
+template <typename MessageT>
+typename std::enable_if<!ShmDispatcher::IsReadInPlace<MessageT>::value,
+                        std::shared_ptr<MessageT>>::type
+ShmDispatcher::ToMessage(const std::shared_ptr<ReadableBlock>& rb) {
+  auto msg = std::make_shared<MessageT>();
+  if (!message::ParseFromArray(
+          rb->buf, static_cast<int>(rb->block->msg_size()), msg.get())) {
+    return nullptr;
+  }
+  return msg;
+}
+
 template <typename MessageT>
 void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
                                 const MessageListener<MessageT>& listener) {
-  // FIXME: make it more clean
   auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
                                      const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+    auto msg = ShmDispatcher::ToMessage<MessageT>(rb);
+    RETURN_IF(msg == nullptr);
     listener(msg, msg_info);
   };
 
   Dispatcher::AddListener<ReadableBlock>(self_attr, listener_adapter);
-  AddSegment(self_attr);
+  AddSegment(self_attr, IsReadInPlace<MessageT>::value);
 }
 
 template <typename MessageT>
 void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
                                 const RoleAttributes& opposite_attr,
                                 const MessageListener<MessageT>& listener) {
-  // FIXME: make it more clean
   auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
                                      const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+    auto msg = ShmDispatcher::ToMessage<MessageT>(rb);
+    RETURN_IF(msg == nullptr);
     listener(msg, msg_info);
   };
 
   Dispatcher::AddListener<ReadableBlock>(self_attr, opposite_attr,
                                          listener_adapter);
-  AddSegment(self_attr);
+  AddSegment(self_attr, IsReadInPlace<MessageT>::value);
 }
 
 }  // namespace transport
@@ -86,7 +86,7 @@ TEST(ShmDispatcherTest, on_message) {
       self_attr, [&recv_msg](const std::shared_ptr<message::RawMessage>& msg,
                              const MessageInfo& msg_info) {
         (void)msg_info;
-        recv_msg->message = msg->message;
+        recv_msg->message = std::string(msg->data(), msg->size());
       });
 
   transmitter->Transmit(send_msg);
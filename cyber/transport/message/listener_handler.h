@@ -50,6 +50,11 @@ class ListenerHandlerBase {
   inline bool IsRawMessage() const { return is_raw_message_; }
   virtual void RunFromString(const std::string& str,
                              const MessageInfo& msg_info) = 0;
+  // raw holds the serialized message of type_name, RawMessage handlers run
+  // with raw itself
+  virtual void RunFromRawMessage(
+      const std::shared_ptr<message::RawMessage>& raw,
+      const std::string& type_name, const MessageInfo& msg_info) = 0;
 
  protected:
   bool is_raw_message_ = false;
@@ -78,6 +83,9 @@ class ListenerHandler : public ListenerHandlerBase {
   void Run(const Message& msg, const MessageInfo& msg_info);
   void RunFromString(const std::string& str,
                      const MessageInfo& msg_info) override;
+  void RunFromRawMessage(const std::shared_ptr<message::RawMessage>& raw,
+                         const std::string& type_name,
+                         const MessageInfo& msg_info) override;
 
  private:
   using SignalPtr = std::shared_ptr<MessageSignal>;
@@ -183,6 +191,28 @@ void ListenerHandler<MessageT>::RunFromString(const std::string& str,
   }
 }
 
+template <typename MessageT>
+void ListenerHandler<MessageT>::RunFromRawMessage(
+    const std::shared_ptr<message::RawMessage>& raw,
+    const std::string& type_name, const MessageInfo& msg_info) {
+  auto msg = std::make_shared<MessageT>();
+  message::SetTypeName(type_name, msg.get());
+  if (message::ParseFromArray(raw->data(), static_cast<int>(raw->size()),
+                              msg.get())) {
+    Run(msg, msg_info);
+  } else {
+    AWARN << "Failed to parse message. Content: "
+          << std::string(raw->data(), raw->size());
+  }
+}
+
+template <>
+inline void ListenerHandler<message::RawMessage>::RunFromRawMessage(
+    const std::shared_ptr<message::RawMessage>& raw,
+    const std::string& type_name, const MessageInfo& msg_info) {
+  Run(raw, msg_info);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_MESSAGE_LOANED_BUFFER_H_
+#define CYBER_TRANSPORT_MESSAGE_LOANED_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cyber/transport/shm/segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @brief A buffer handed out by Transmitter::Loan. The message is written into
+ * `buf` in its wire format and published with Transmitter::Commit. When the
+ * buffer lives inside a shm block, `segment` is set and the block stays write
+ * locked until the loan is committed or returned.
+ */
+struct LoanedBuffer {
+  uint8_t* buf = nullptr;
+  std::size_t capacity = 0;
+  std::size_t size = 0;
+
+  SegmentPtr segment = nullptr;
+  WritableBlock block;
+
+  std::vector<uint8_t> heap;
+
+  bool in_shm() const { return segment != nullptr; }
+
+  void Clear() {
+    buf = nullptr;
+    capacity = 0;
+    size = 0;
+    segment = nullptr;
+    block = WritableBlock();
+    heap.clear();
+  }
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_MESSAGE_LOANED_BUFFER_H_
@@ -25,7 +25,9 @@ namespace cyber {
 namespace transport {
 
 class Block {
+  friend class BlockView;
   friend class Segment;
+  friend class SlabSegment;
 
  public:
   Block();
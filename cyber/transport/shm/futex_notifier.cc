@@ -0,0 +1,553 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/futex_notifier.h"
+
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using common::Hash;
+
+namespace {
+
+// layout version of the shared memory
+constexpr uint32_t kMagic = 0x46555403;
+
+// lookups probe past freed channel entries, and stop at unused ones
+constexpr uint64_t kFreedChannel = ~0ULL;
+
+int FutexWait(std::atomic<uint32_t>* futex, uint32_t value,
+              int64_t timeout_ns) {
+  struct timespec ts;
+  ts.tv_sec = static_cast<time_t>(timeout_ns / 1000000000);
+  ts.tv_nsec = static_cast<long>(timeout_ns % 1000000000);  // NOLINT
+  return static_cast<int>(syscall(SYS_futex, reinterpret_cast<uint32_t*>(futex),
+                                  FUTEX_WAIT, value, &ts, nullptr, 0));
+}
+
+int FutexWake(std::atomic<uint32_t>* futex) {
+  return static_cast<int>(syscall(SYS_futex, reinterpret_cast<uint32_t*>(futex),
+                                  FUTEX_WAKE, 1, nullptr, nullptr, 0));
+}
+
+uint32_t ChannelIndex(uint64_t channel_id) {
+  return static_cast<uint32_t>((channel_id * 0x9E3779B97F4A7C15ULL) >> 32) &
+         (FutexNotifier::kMaxChannels - 1);
+}
+
+int64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+constexpr uint32_t FutexNotifier::kMaxReaders;
+constexpr uint32_t FutexNotifier::kMaxChannels;
+constexpr uint32_t FutexNotifier::kRingLength;
+
+FutexNotifier::FutexNotifier() {
+  key_ = static_cast<key_t>(Hash("/apollo/cyber/transport/shm/futex_notifier"));
+  ADEBUG << "futex notifier key: " << key_;
+  shm_size_ = sizeof(Indicator);
+
+  if (!Init()) {
+    AERROR << "fail to init futex notifier.";
+    is_shutdown_.store(true);
+  }
+}
+
+FutexNotifier::~FutexNotifier() { Shutdown(); }
+
+void FutexNotifier::Shutdown() {
+  if (is_shutdown_.exchange(true)) {
+    return;
+  }
+
+  auto reader = reader_.load();
+  if (reader != nullptr) {
+    reader->futex.fetch_add(1);
+    FutexWake(&reader->futex);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ReleaseReader();
+  if (broadcast_.load() && indicator_ != nullptr) {
+    indicator_->broadcast_readers.fetch_sub(1);
+  }
+  Reset();
+}
+
+uint64_t FutexNotifier::dropped_count() const {
+  auto reader = reader_.load();
+  return reader == nullptr ? 0 : reader->dropped.load();
+}
+
+bool FutexNotifier::Notify(const ReadableInfo& info) {
+  if (is_shutdown_.load()) {
+    ADEBUG << "notifier is shutdown.";
+    return false;
+  }
+
+  uint64_t readers = indicator_->all_channel_readers.load();
+  uint64_t channel_id = info.channel_id();
+  uint32_t index = ChannelIndex(channel_id);
+  for (uint32_t i = 0; i < kMaxChannels && channel_id != 0; ++i) {
+    auto& channel = indicator_->channels[(index + i) & (kMaxChannels - 1)];
+    uint64_t id = channel.channel_id.load();
+    if (id == channel_id) {
+      readers |= channel.readers.load();
+      break;
+    }
+    if (id == 0) {
+      break;
+    }
+  }
+
+  Notification notification;
+  notification.host_id = info.host_id();
+  notification.channel_id = channel_id;
+  notification.block_index = info.block_index();
+  while (readers != 0) {
+    auto slot = static_cast<uint32_t>(__builtin_ctzll(readers));
+    readers &= readers - 1;
+    Push(slot, notification);
+  }
+  if (indicator_->broadcast_readers.load(std::memory_order_relaxed) != 0) {
+    PushBroadcast(notification);
+  }
+  return true;
+}
+
+bool FutexNotifier::Listen(int timeout_ms, ReadableInfo* info) {
+  if (info == nullptr) {
+    AERROR << "info nullptr.";
+    return false;
+  }
+
+  if (is_shutdown_.load()) {
+    ADEBUG << "notifier is shutdown.";
+    return false;
+  }
+
+  auto reader = AcquireReader();
+  if (reader == nullptr) {
+    return ListenBroadcast(timeout_ms, info);
+  }
+
+  Notification notification;
+  int64_t deadline = SteadyNowNs() + static_cast<int64_t>(timeout_ms) * 1000000;
+  while (!is_shutdown_.load()) {
+    if (Pop(&notification)) {
+      info->set_host_id(notification.host_id);
+      info->set_channel_id(notification.channel_id);
+      info->set_block_index(notification.block_index);
+      return true;
+    }
+
+    int64_t remaining = deadline - SteadyNowNs();
+    if (remaining <= 0) {
+      return false;
+    }
+    // the writers check waiting after publishing their notification, so
+    // either they see it set and bump the futex, or the Pop below sees their
+    // notification
+    uint32_t futex = reader->futex.load();
+    reader->waiting.store(1);
+    if (Pop(&notification)) {
+      reader->waiting.store(0, std::memory_order_relaxed);
+      info->set_host_id(notification.host_id);
+      info->set_channel_id(notification.channel_id);
+      info->set_block_index(notification.block_index);
+      return true;
+    }
+    wait_count_.fetch_add(1, std::memory_order_relaxed);
+    FutexWait(&reader->futex, futex, remaining);
+    reader->waiting.store(0, std::memory_order_relaxed);
+  }
+  return false;
+}
+
+void FutexNotifier::Subscribe(uint64_t channel_id) {
+  if (is_shutdown_.load()) {
+    return;
+  }
+  auto reader = AcquireReader();
+  if (reader == nullptr) {
+    return;
+  }
+
+  uint64_t bit = 1ULL << slot_;
+  // the first entry the channel can take if it is not in the table yet
+  Channel* free_channel = nullptr;
+  LockChannels();
+  uint32_t index = ChannelIndex(channel_id);
+  for (uint32_t i = 0;
+       i < kMaxChannels && channel_id != 0 && channel_id != kFreedChannel;
+       ++i) {
+    auto& channel = indicator_->channels[(index + i) & (kMaxChannels - 1)];
+    uint64_t id = channel.channel_id.load();
+    if (id == channel_id) {
+      channel.readers.fetch_or(bit);
+      UnlockChannels();
+      return;
+    }
+    if ((id == 0 || id == kFreedChannel) && free_channel == nullptr) {
+      free_channel = &channel;
+    }
+    if (id == 0) {
+      break;
+    }
+  }
+  if (free_channel != nullptr) {
+    // Notify reads the id first, so it never finds the entry without readers
+    free_channel->readers.store(bit);
+    free_channel->channel_id.store(channel_id);
+    UnlockChannels();
+    return;
+  }
+  UnlockChannels();
+  AERROR << "too many channels in futex notifier, max channels: "
+         << kMaxChannels << ", receive notifications of all channels.";
+  indicator_->all_channel_readers.fetch_or(bit);
+}
+
+FutexNotifier::Reader* FutexNotifier::AcquireReader() {
+  auto reader = reader_.load(std::memory_order_acquire);
+  if (cyber_likely(reader != nullptr)) {
+    return reader;
+  }
+
+  if (broadcast_.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(reader_mutex_);
+  reader = reader_.load(std::memory_order_relaxed);
+  if (reader != nullptr || broadcast_.load() || is_shutdown_.load()) {
+    return reader;
+  }
+  pid_t self = getpid();
+  for (uint32_t slot = 0; slot < kMaxReaders; ++slot) {
+    auto& candidate = indicator_->readers[slot];
+    pid_t pid = candidate.pid.load();
+    // free, or left behind by a process that died without Shutdown
+    if (pid == 0 || (pid != self && kill(pid, 0) == -1 && errno == ESRCH)) {
+      if (!candidate.pid.compare_exchange_strong(pid, self)) {
+        continue;
+      }
+      RemoveChannelReader(slot);
+      slot_ = slot;
+      reader_.store(&candidate, std::memory_order_release);
+      // drop what was left for the previous owner
+      Notification notification;
+      while (Pop(&notification)) {
+      }
+      candidate.dropped.store(0);
+      return &candidate;
+    }
+  }
+  AERROR << "no free reader slot in futex notifier, max readers: "
+         << kMaxReaders << ", poll the notifications of all channels.";
+  broadcast_next_seq_ = indicator_->broadcast_seq.load();
+  indicator_->broadcast_readers.fetch_add(1);
+  broadcast_.store(true);
+  return nullptr;
+}
+
+void FutexNotifier::ReleaseReader() {
+  std::lock_guard<std::mutex> lock(reader_mutex_);
+  auto reader = reader_.exchange(nullptr);
+  if (reader == nullptr || indicator_ == nullptr) {
+    return;
+  }
+  RemoveChannelReader(slot_);
+  reader->pid.store(0);
+}
+
+void FutexNotifier::LockChannels() {
+  pid_t self = getpid();
+  while (true) {
+    pid_t pid = 0;
+    if (indicator_->channels_lock.compare_exchange_weak(pid, self)) {
+      return;
+    }
+    // left locked by a process that died without unlocking
+    if (pid != 0 && pid != self && kill(pid, 0) == -1 && errno == ESRCH &&
+        indicator_->channels_lock.compare_exchange_strong(pid, self)) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+}
+
+void FutexNotifier::UnlockChannels() { indicator_->channels_lock.store(0); }
+
+void FutexNotifier::RemoveChannelReader(uint32_t slot) {
+  uint64_t mask = ~(1ULL << slot);
+  indicator_->all_channel_readers.fetch_and(mask);
+  LockChannels();
+  for (auto& channel : indicator_->channels) {
+    uint64_t id = channel.channel_id.load(std::memory_order_relaxed);
+    if (id == 0 || id == kFreedChannel ||
+        (channel.readers.load(std::memory_order_relaxed) & ~mask) == 0) {
+      continue;
+    }
+    // A lookup that still finds the entry after it is taken by another
+    // channel notifies the readers of that channel once too often, which
+    // they ignore.
+    if ((channel.readers.fetch_and(mask) & mask) == 0) {
+      channel.channel_id.store(kFreedChannel);
+    }
+  }
+  // freed entries right before an unused one end the lookups just as well,
+  // turn them back into unused ones so that lookups stay short
+  for (uint32_t i = 0; i < kMaxChannels; ++i) {
+    if (indicator_->channels[i].channel_id.load() != 0) {
+      continue;
+    }
+    for (uint32_t j = (i - 1) & (kMaxChannels - 1);
+         indicator_->channels[j].channel_id.load() == kFreedChannel;
+         j = (j - 1) & (kMaxChannels - 1)) {
+      indicator_->channels[j].channel_id.store(0);
+    }
+  }
+  UnlockChannels();
+}
+
+void FutexNotifier::Push(uint32_t slot, const Notification& notification) {
+  auto reader = &indicator_->readers[slot];
+  uint64_t pos = reader->enqueue_pos.load(std::memory_order_relaxed);
+  Cell* cell = nullptr;
+  while (true) {
+    cell = &reader->cells[pos & (kRingLength - 1)];
+    uint64_t seq = cell->seq.load(std::memory_order_acquire);
+    auto diff = static_cast<int64_t>(seq - pos);
+    if (diff == 0) {
+      if (reader->enqueue_pos.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // the reader is too slow or gone
+      reader->dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = reader->enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+  cell->notification = notification;
+  cell->seq.store(pos + 1, std::memory_order_release);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (reader->waiting.load(std::memory_order_relaxed) != 0) {
+    Wake(reader);
+  }
+}
+
+bool FutexNotifier::Pop(Notification* notification) {
+  auto reader = reader_.load(std::memory_order_relaxed);
+  uint64_t pos = reader->dequeue_pos.load(std::memory_order_relaxed);
+  Cell* cell = nullptr;
+  while (true) {
+    cell = &reader->cells[pos & (kRingLength - 1)];
+    uint64_t seq = cell->seq.load(std::memory_order_acquire);
+    auto diff = static_cast<int64_t>(seq - (pos + 1));
+    if (diff == 0) {
+      if (reader->dequeue_pos.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = reader->dequeue_pos.load(std::memory_order_relaxed);
+    }
+  }
+  *notification = cell->notification;
+  cell->seq.store(pos + kRingLength, std::memory_order_release);
+  return true;
+}
+
+void FutexNotifier::Wake(Reader* reader) {
+  reader->futex.fetch_add(1);
+  FutexWake(&reader->futex);
+}
+
+void FutexNotifier::PushBroadcast(const Notification& notification) {
+  uint64_t seq = indicator_->broadcast_seq.fetch_add(1);
+  auto& cell = indicator_->broadcast[seq & (kRingLength - 1)];
+  // 0 while the cell is written
+  cell.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  cell.notification = notification;
+  cell.seq.store(seq + 1, std::memory_order_release);
+}
+
+bool FutexNotifier::ListenBroadcast(int timeout_ms, ReadableInfo* info) {
+  int timeout_us = timeout_ms * 1000;
+  while (!is_shutdown_.load()) {
+    uint64_t seq = indicator_->broadcast_seq.load();
+    if (seq != broadcast_next_seq_) {
+      auto& cell = indicator_->broadcast[broadcast_next_seq_ &
+                                         (kRingLength - 1)];
+      uint64_t written = cell.seq.load(std::memory_order_acquire);
+      Notification notification = cell.notification;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // the cell was not rewritten while it was copied, a writer a whole ring
+      // ahead skips the notifications in between
+      if (written > broadcast_next_seq_ &&
+          cell.seq.load(std::memory_order_relaxed) == written) {
+        broadcast_next_seq_ = written;
+        info->set_host_id(notification.host_id);
+        info->set_channel_id(notification.channel_id);
+        info->set_block_index(notification.block_index);
+        return true;
+      }
+      ADEBUG << "seq[" << broadcast_next_seq_
+             << "] is writing, can not read now.";
+    }
+
+    if (timeout_us > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+      timeout_us -= 50;
+    } else {
+      return false;
+    }
+  }
+  return false;
+}
+
+bool FutexNotifier::Init() { return OpenOrCreate(); }
+
+bool FutexNotifier::OpenOrCreate() {
+  // create managed_shm_
+  int retry = 0;
+  int shmid = 0;
+  while (retry < 2) {
+    shmid = shmget(key_, shm_size_, 0644 | IPC_CREAT | IPC_EXCL);
+    if (shmid != -1) {
+      break;
+    }
+
+    if (EINVAL == errno) {
+      AINFO << "need larger space, recreate.";
+      Reset();
+      Remove();
+      ++retry;
+    } else if (EEXIST == errno) {
+      ADEBUG << "shm already exist, open only.";
+      return OpenOnly();
+    } else {
+      break;
+    }
+  }
+
+  if (shmid == -1) {
+    AERROR << "create shm failed, error code: " << strerror(errno);
+    return false;
+  }
+
+  // attach managed_shm_
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed.";
+    managed_shm_ = nullptr;
+    shmctl(shmid, IPC_RMID, 0);
+    return false;
+  }
+
+  // create indicator_, the openers wait for the magic
+  indicator_ = new (managed_shm_) Indicator();
+  for (auto& reader : indicator_->readers) {
+    for (uint32_t i = 0; i < kRingLength; ++i) {
+      reader.cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+  indicator_->magic.store(kMagic, std::memory_order_release);
+
+  ADEBUG << "open or create true.";
+  return true;
+}
+
+bool FutexNotifier::OpenOnly() {
+  // get managed_shm_
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1) {
+    AERROR << "get shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  // attach managed_shm_
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed, error: " << strerror(errno);
+    managed_shm_ = nullptr;
+    return false;
+  }
+
+  // get indicator_, created by another process right now or long ago
+  indicator_ = reinterpret_cast<Indicator*>(managed_shm_);
+  for (int i = 0; i < 1000; ++i) {
+    if (indicator_->magic.load(std::memory_order_acquire) == kMagic) {
+      ADEBUG << "open true.";
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  AERROR << "futex notifier shm is not initialized or has another layout.";
+  Reset();
+  return false;
+}
+
+bool FutexNotifier::Remove() {
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1 || shmctl(shmid, IPC_RMID, 0) == -1) {
+    AERROR << "remove shm failed, error code: " << strerror(errno);
+    return false;
+  }
+  ADEBUG << "remove success.";
+
+  return true;
+}
+
+void FutexNotifier::Reset() {
+  indicator_ = nullptr;
+  if (managed_shm_ != nullptr) {
+    shmdt(managed_shm_);
+    managed_shm_ = nullptr;
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
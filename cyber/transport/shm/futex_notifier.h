@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
+#define CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "cyber/base/macros.h"
+#include "cyber/common/macros.h"
+#include "cyber/transport/shm/notifier_base.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class FutexNotifier
+ * @brief Every reader process owns a notification ring in shared memory and
+ * registers the channels it reads. Notify only pushes to the rings of the
+ * processes reading the channel and wakes them through a futex if they are
+ * sleeping, so a process never wakes up for channels it does not read.
+ *
+ * At most kMaxReaders processes and kMaxChannels channels are tracked, a
+ * process that can not register a channel receives every notification. A
+ * channel is dropped from the table once the last process reading it has
+ * left, so the cap only applies to the channels read at the same time. A
+ * process that finds no free reader slot polls a ring that every notification
+ * is also written to while such a process exists, as with ConditionNotifier.
+ * Slots of crashed processes are reclaimed by the next process that starts.
+ */
+class FutexNotifier : public NotifierBase {
+  friend class FutexNotifierChannelTest;
+
+ public:
+  static constexpr uint32_t kMaxReaders = 64;
+  static constexpr uint32_t kMaxChannels = 4096;
+  static constexpr uint32_t kRingLength = 1024;
+
+  virtual ~FutexNotifier();
+
+  void Shutdown() override;
+  bool Notify(const ReadableInfo& info) override;
+  bool Listen(int timeout_ms, ReadableInfo* info) override;
+  void Subscribe(uint64_t channel_id) override;
+
+  // times the listening thread went to sleep in Listen, and notifications
+  // dropped because the ring of a reader was full
+  uint64_t wait_count() const { return wait_count_.load(); }
+  uint64_t dropped_count() const;
+
+  static const char* Type() { return "futex"; }
+
+ private:
+  struct Notification {
+    uint64_t host_id;
+    uint64_t channel_id;
+    uint32_t block_index;
+  };
+
+  struct Cell {
+    std::atomic<uint64_t> seq;
+    Notification notification;
+  };
+
+  struct alignas(CACHELINE_SIZE) Reader {
+    // 0 if the slot is free
+    std::atomic<pid_t> pid;
+    // bumped by the writers that found the reader waiting
+    std::atomic<uint32_t> futex;
+    std::atomic<uint32_t> waiting;
+    std::atomic<uint64_t> dropped;
+    alignas(CACHELINE_SIZE) std::atomic<uint64_t> enqueue_pos;
+    alignas(CACHELINE_SIZE) std::atomic<uint64_t> dequeue_pos;
+    Cell cells[kRingLength];
+  };
+
+  struct Channel {
+    // 0 if the entry was never used, kFreedChannel once its readers left
+    std::atomic<uint64_t> channel_id;
+    // one bit per reader slot
+    std::atomic<uint64_t> readers;
+  };
+
+  struct Indicator {
+    std::atomic<uint32_t> magic;
+    // readers of every channel
+    std::atomic<uint64_t> all_channel_readers;
+    // pid of the process adding or removing channels, 0 if none is
+    std::atomic<pid_t> channels_lock;
+    Channel channels[kMaxChannels];
+    Reader readers[kMaxReaders];
+    // processes without a reader slot, they poll the broadcast ring, whose
+    // cells hold their sequence number plus one once written
+    alignas(CACHELINE_SIZE) std::atomic<uint32_t> broadcast_readers;
+    alignas(CACHELINE_SIZE) std::atomic<uint64_t> broadcast_seq;
+    Cell broadcast[kRingLength];
+  };
+
+  bool Init();
+  bool OpenOrCreate();
+  bool OpenOnly();
+  bool Remove();
+  void Reset();
+
+  Reader* AcquireReader();
+  void ReleaseReader();
+  void LockChannels();
+  void UnlockChannels();
+  void RemoveChannelReader(uint32_t slot);
+  void Push(uint32_t slot, const Notification& notification);
+  bool Pop(Notification* notification);
+  void Wake(Reader* reader);
+  void PushBroadcast(const Notification& notification);
+  bool ListenBroadcast(int timeout_ms, ReadableInfo* info);
+
+  key_t key_ = 0;
+  void* managed_shm_ = nullptr;
+  size_t shm_size_ = 0;
+  Indicator* indicator_ = nullptr;
+  // taken by the first Subscribe or Listen
+  std::mutex reader_mutex_;
+  std::atomic<Reader*> reader_ = {nullptr};
+  uint32_t slot_ = 0;
+  // no reader slot was free, the process listens to the broadcast ring
+  std::atomic<bool> broadcast_ = {false};
+  uint64_t broadcast_next_seq_ = 0;
+  std::atomic<uint64_t> wait_count_ = {0};
+  std::atomic<bool> is_shutdown_ = {false};
+
+  DECLARE_SINGLETON(FutexNotifier)
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/futex_notifier.h"
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+class FutexNotifierChannelTest : public ::testing::Test {
+ protected:
+  // channels in the table, and channels read by the process
+  static uint32_t ChannelNum(FutexNotifier* notifier, uint64_t* readers) {
+    uint32_t num = 0;
+    *readers = 0;
+    for (auto& channel : notifier->indicator_->channels) {
+      uint64_t id = channel.channel_id.load();
+      if (id != 0 && id != ~0ULL) {
+        ++num;
+        *readers |= channel.readers.load() & (1ULL << notifier->slot_);
+      }
+    }
+    return num;
+  }
+
+  static bool AllChannels(FutexNotifier* notifier) {
+    return (notifier->indicator_->all_channel_readers.load() &
+            (1ULL << notifier->slot_)) != 0;
+  }
+
+  static void ReleaseReader(FutexNotifier* notifier) {
+    notifier->ReleaseReader();
+  }
+};
+
+TEST_F(FutexNotifierChannelTest, channels_freed) {
+  auto notifier = FutexNotifier::Instance();
+  ReleaseReader(notifier);
+  uint64_t readers = 0;
+  auto channel_num = ChannelNum(notifier, &readers);
+
+  // more channels than the table holds, but never at the same time
+  const uint32_t round_channel_num = FutexNotifier::kMaxChannels / 2;
+  for (uint64_t round = 0; round < 3; ++round) {
+    for (uint64_t i = 1; i <= round_channel_num; ++i) {
+      notifier->Subscribe(round << 32 | i);
+    }
+    EXPECT_EQ(ChannelNum(notifier, &readers),
+              channel_num + round_channel_num);
+    EXPECT_NE(readers, 0);
+    EXPECT_FALSE(AllChannels(notifier));
+    ReleaseReader(notifier);
+    EXPECT_EQ(ChannelNum(notifier, &readers), channel_num);
+  }
+
+  // channels freed are found again once subscribed again
+  notifier->Subscribe(1);
+  ReadableInfo readable_info;
+  while (notifier->Listen(10, &readable_info)) {
+  }
+  EXPECT_TRUE(notifier->Notify(ReadableInfo(10, 8, 1)));
+  EXPECT_TRUE(notifier->Listen(100, &readable_info));
+  EXPECT_EQ(readable_info.block_index(), 8);
+}
+
+TEST(FutexNotifierTest, constructor) {
+  auto notifier = FutexNotifier::Instance();
+  EXPECT_NE(notifier, nullptr);
+}
+
+TEST(FutexNotifierTest, notify_listen) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Subscribe(1);
+  ReadableInfo readable_info;
+  while (notifier->Listen(10, &readable_info)) {
+  }
+
+  EXPECT_TRUE(notifier->Notify(ReadableInfo(10, 3, 1)));
+  EXPECT_TRUE(notifier->Listen(100, &readable_info));
+  EXPECT_EQ(readable_info.host_id(), 10);
+  EXPECT_EQ(readable_info.block_index(), 3);
+  EXPECT_EQ(readable_info.channel_id(), 1);
+  EXPECT_FALSE(notifier->Listen(10, &readable_info));
+
+  // not subscribed
+  EXPECT_TRUE(notifier->Notify(ReadableInfo(10, 4, 2)));
+  EXPECT_FALSE(notifier->Listen(10, &readable_info));
+
+  notifier->Subscribe(2);
+  EXPECT_TRUE(notifier->Notify(ReadableInfo(10, 5, 1)));
+  EXPECT_TRUE(notifier->Notify(ReadableInfo(10, 6, 2)));
+  EXPECT_TRUE(notifier->Listen(100, &readable_info));
+  EXPECT_EQ(readable_info.block_index(), 5);
+  EXPECT_TRUE(notifier->Listen(100, &readable_info));
+  EXPECT_EQ(readable_info.block_index(), 6);
+  EXPECT_FALSE(notifier->Listen(10, &readable_info));
+}
+
+TEST(FutexNotifierTest, wakeup) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Subscribe(1);
+  ReadableInfo readable_info;
+  while (notifier->Listen(10, &readable_info)) {
+  }
+
+  auto wait_count = notifier->wait_count();
+  auto start = std::chrono::steady_clock::now();
+  std::thread writer([notifier]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    notifier->Notify(ReadableInfo(10, 7, 1));
+  });
+  EXPECT_TRUE(notifier->Listen(5000, &readable_info));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+  EXPECT_EQ(readable_info.block_index(), 7);
+  EXPECT_GT(notifier->wait_count(), wait_count);
+  writer.join();
+
+  // notifications beyond the ring are dropped
+  auto dropped = notifier->dropped_count();
+  for (uint32_t i = 0; i < FutexNotifier::kRingLength + 10; ++i) {
+    notifier->Notify(ReadableInfo(10, i, 1));
+  }
+  EXPECT_EQ(notifier->dropped_count(), dropped + 10);
+  uint32_t count = 0;
+  while (notifier->Listen(10, &readable_info)) {
+    ++count;
+  }
+  EXPECT_EQ(count, FutexNotifier::kRingLength);
+}
+
+TEST(FutexNotifierTest, shutdown) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Shutdown();
+  ReadableInfo readable_info;
+  EXPECT_FALSE(notifier->Notify(readable_info));
+  EXPECT_FALSE(notifier->Listen(100, &readable_info));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -17,6 +17,7 @@
 #ifndef CYBER_TRANSPORT_SHM_NOTIFIER_BASE_H_
 #define CYBER_TRANSPORT_SHM_NOTIFIER_BASE_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "cyber/transport/shm/readable_info.h"
@@ -35,6 +36,12 @@ class NotifierBase {
   virtual void Shutdown() = 0;
   virtual bool Notify(const ReadableInfo& info) = 0;
   virtual bool Listen(int timeout_ms, ReadableInfo* info) = 0;
+
+  /**
+   * @brief Tell the notifier this process reads the channel. Notifiers that
+   * deliver every notification to every process ignore it.
+   */
+  virtual void Subscribe(uint64_t channel_id) {}
 };
 
 }  // namespace transport
@@ -0,0 +1,196 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Stress test of the shm notifiers: reader processes each read a share of
+// the channels while one writer notifies every channel in turn. Reports how
+// often the readers were woken up compared to the messages they read.
+//
+// usage: notifier_benchmark [readers] [channels] [messages] [interval_us]
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyber/transport/shm/condition_notifier.h"
+#include "cyber/transport/shm/futex_notifier.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+// every reader reads the stop channel
+constexpr uint64_t kStopChannel = 0xFFFFFFFFULL;
+constexpr uint64_t kHostId = 1;
+
+struct ReaderResult {
+  uint64_t notifications = 0;
+  uint64_t messages = 0;
+  uint64_t context_switches = 0;
+  uint64_t cpu_us = 0;
+};
+
+NotifierPtr CreateNotifier(const std::string& type) {
+  if (type == FutexNotifier::Type()) {
+    return FutexNotifier::Instance();
+  }
+  return ConditionNotifier::Instance();
+}
+
+void RunReader(const std::string& type, uint32_t reader, uint32_t reader_num,
+               uint32_t channel_num, int ready_fd, int result_fd) {
+  auto notifier = CreateNotifier(type);
+  for (uint32_t channel = reader; channel < channel_num;
+       channel += reader_num) {
+    notifier->Subscribe(channel + 1);
+  }
+  notifier->Subscribe(kStopChannel);
+  ReadableInfo info;
+  while (notifier->Listen(0, &info)) {
+  }
+
+  struct rusage start_usage;
+  getrusage(RUSAGE_SELF, &start_usage);
+  char ready = 1;
+  if (write(ready_fd, &ready, 1) != 1) {
+    _exit(1);
+  }
+
+  ReaderResult result;
+  while (true) {
+    if (!notifier->Listen(100, &info)) {
+      continue;
+    }
+    ++result.notifications;
+    if (info.channel_id() == kStopChannel) {
+      break;
+    }
+    if ((info.channel_id() - 1) % reader_num == reader) {
+      ++result.messages;
+    }
+  }
+
+  struct rusage end_usage;
+  getrusage(RUSAGE_SELF, &end_usage);
+  result.context_switches = (end_usage.ru_nvcsw - start_usage.ru_nvcsw) +
+                            (end_usage.ru_nivcsw - start_usage.ru_nivcsw);
+  auto cpu_us = [](const struct rusage& usage) {
+    return static_cast<uint64_t>(usage.ru_utime.tv_sec +
+                                 usage.ru_stime.tv_sec) *
+               1000000 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+  };
+  result.cpu_us = cpu_us(end_usage) - cpu_us(start_usage);
+  if (write(result_fd, &result, sizeof(result)) != sizeof(result)) {
+    _exit(1);
+  }
+  _exit(0);
+}
+
+void Run(const std::string& type, uint32_t reader_num, uint32_t channel_num,
+         uint32_t message_num, uint32_t interval_us) {
+  int ready_pipe[2];
+  int result_pipe[2];
+  if (pipe(ready_pipe) != 0 || pipe(result_pipe) != 0) {
+    perror("pipe");
+    return;
+  }
+
+  std::vector<pid_t> pids;
+  for (uint32_t i = 0; i < reader_num; ++i) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      RunReader(type, i, reader_num, channel_num, ready_pipe[1],
+                result_pipe[1]);
+    }
+    pids.push_back(pid);
+  }
+  for (uint32_t i = 0; i < reader_num; ++i) {
+    char ready = 0;
+    if (read(ready_pipe[0], &ready, 1) != 1) {
+      perror("read");
+    }
+  }
+
+  auto notifier = CreateNotifier(type);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < message_num; ++i) {
+    notifier->Notify(ReadableInfo(kHostId, i, i % channel_num + 1));
+    if (interval_us > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  notifier->Notify(ReadableInfo(kHostId, 0, kStopChannel));
+
+  ReaderResult total;
+  for (uint32_t i = 0; i < reader_num; ++i) {
+    ReaderResult result;
+    if (read(result_pipe[0], &result, sizeof(result)) != sizeof(result)) {
+      perror("read");
+      continue;
+    }
+    total.notifications += result.notifications;
+    total.messages += result.messages;
+    total.context_switches += result.context_switches;
+    total.cpu_us += result.cpu_us;
+  }
+  for (auto pid : pids) {
+    waitpid(pid, nullptr, 0);
+  }
+  for (int fd :
+       {ready_pipe[0], ready_pipe[1], result_pipe[0], result_pipe[1]}) {
+    close(fd);
+  }
+
+  double messages =
+      static_cast<double>(total.messages > 0 ? total.messages : 1);
+  printf(
+      "%-10s sent %u in %.0f ms, read %lu of %u, notifications/message "
+      "%.2f, wakeups/message %.2f, reader cpu %.1f ms\n",
+      type.c_str(), message_num,
+      std::chrono::duration<double, std::milli>(elapsed).count(),
+      static_cast<unsigned long>(total.messages), message_num,  // NOLINT
+      static_cast<double>(total.notifications) / messages,
+      static_cast<double>(total.context_switches) / messages,
+      static_cast<double>(total.cpu_us) / 1000.0);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  uint32_t reader_num = argc > 1 ? std::atoi(argv[1]) : 20;
+  uint32_t channel_num = argc > 2 ? std::atoi(argv[2]) : 200;
+  uint32_t message_num = argc > 3 ? std::atoi(argv[3]) : 20000;
+  uint32_t interval_us = argc > 4 ? std::atoi(argv[4]) : 50;
+  printf("%u readers, %u channels, %u messages, %u us apart\n", reader_num,
+         channel_num, message_num, interval_us);
+  for (const char* type : {apollo::cyber::transport::ConditionNotifier::Type(),
+                           apollo::cyber::transport::FutexNotifier::Type()}) {
+    apollo::cyber::transport::Run(type, reader_num, channel_num, message_num,
+                                  interval_us);
+  }
+  return 0;
+}
@@ -231,7 +231,9 @@ void PosixSegment::Reset() {
     block_buf_addrs_.clear();
   }
   if (managed_shm_ != nullptr) {
-    munmap(managed_shm_, conf_.managed_shm_size());
+    ReleaseMapping([addr = managed_shm_, size = conf_.managed_shm_size()]() {
+      munmap(addr, size);
+    });
     managed_shm_ = nullptr;
     return;
   }
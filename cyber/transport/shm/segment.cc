@@ -16,6 +16,9 @@
 
 #include "cyber/transport/shm/segment.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
 #include "cyber/transport/shm/shm_conf.h"
@@ -24,6 +27,17 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+BlockView::BlockView(const std::shared_ptr<SegmentMapping>& mapping,
+                     Block* block, const uint8_t* buf)
+    : mapping_(mapping), block_(block), buf_(buf) {
+  mapping_->view_num.fetch_add(1);
+}
+
+BlockView::~BlockView() {
+  block_->ReleaseReadLock();
+  mapping_->view_num.fetch_sub(1);
+}
+
 Segment::Segment(uint64_t channel_id)
     : init_(false),
       conf_(),
@@ -47,7 +61,7 @@ bool Segment::AcquireBlockToWrite(std::size_t msg_size,
     result = Remap();
   }
 
-  if (msg_size > conf_.ceiling_msg_size()) {
+  if (result && msg_size > conf_.ceiling_msg_size()) {
     AINFO << "msg_size: " << msg_size
           << " larger than current shm_buffer_size: "
           << conf_.ceiling_msg_size() << " , need recreate.";
@@ -59,10 +73,17 @@ bool Segment::AcquireBlockToWrite(std::size_t msg_size,
     return false;
   }
 
-  uint32_t index = GetNextWritableBlockIndex();
+  uint32_t index = 0;
+  if (!GetNextWritableBlockIndex(&index)) {
+    AERROR << "no writable block, all " << conf_.block_num()
+           << " blocks are in use.";
+    return false;
+  }
+  acquired_blocks_.fetch_add(1);
   writable_block->index = index;
   writable_block->block = &blocks_[index];
   writable_block->buf = block_buf_addrs_[index];
+  writable_block->capacity = conf_.ceiling_msg_size();
   return true;
 }
 
@@ -72,6 +93,7 @@ void Segment::ReleaseWrittenBlock(const WritableBlock& writable_block) {
     return;
   }
   blocks_[index].ReleaseWriteLock();
+  acquired_blocks_.fetch_sub(1);
 }
 
 bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
@@ -100,8 +122,10 @@ bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
   if (!blocks_[index].TryLockForRead()) {
     return false;
   }
+  acquired_blocks_.fetch_add(1);
   readable_block->block = blocks_ + index;
   readable_block->buf = block_buf_addrs_[index];
+  readable_block->capacity = conf_.ceiling_msg_size();
   return true;
 }
 
@@ -111,6 +135,60 @@ void Segment::ReleaseReadBlock(const ReadableBlock& readable_block) {
     return;
   }
   blocks_[index].ReleaseReadLock();
+  acquired_blocks_.fetch_sub(1);
+}
+
+bool Segment::ViewReadBlock(ReadableBlock* readable_block) {
+  RETURN_VAL_IF_NULL(readable_block, false);
+  std::lock_guard<std::mutex> lock(mapping_lock_);
+  if (mapping_ == nullptr) {
+    mapping_ = std::make_shared<SegmentMapping>();
+  }
+  if (mapping_->view_num.load() >= MaxBlockViews(*readable_block)) {
+    return false;
+  }
+  readable_block->view = std::make_shared<BlockView>(
+      mapping_, readable_block->block, readable_block->buf);
+  acquired_blocks_.fetch_sub(1);
+  return true;
+}
+
+void Segment::GetStats(SegmentStats* stats) {
+  RETURN_IF_NULL(stats);
+  stats->block_classes.clear();
+  stats->mapped_size = 0;
+  if (!init_) {
+    return;
+  }
+
+  SegmentStats::BlockClass block_class;
+  block_class.block_buf_size = conf_.block_buf_size();
+  block_class.block_num = conf_.block_num();
+  for (uint32_t i = 0; i < conf_.block_num(); ++i) {
+    if (blocks_[i].lock_num_.load() != Block::kRWLockFree) {
+      ++block_class.blocks_in_use;
+    }
+  }
+  // the sequence advances once per block tried, so this is an upper bound
+  block_class.write_count = state_->seq();
+  stats->block_classes.push_back(block_class);
+  stats->mapped_size = conf_.managed_shm_size();
+}
+
+uint32_t Segment::MaxBlockViews(const ReadableBlock& readable_block) {
+  (void)readable_block;
+  return std::max<uint32_t>(conf_.block_num() / 4, 1);
+}
+
+void Segment::ReleaseMapping(std::function<void()> unmap) {
+  std::lock_guard<std::mutex> lock(mapping_lock_);
+  if (mapping_ == nullptr) {
+    unmap();
+    return;
+  }
+  // the last one of the segment and the views runs it
+  mapping_->unmap = std::move(unmap);
+  mapping_.reset();
 }
 
 bool Segment::Destroy() {
@@ -134,6 +212,11 @@ bool Segment::Destroy() {
 }
 
 bool Segment::Remap() {
+  if (acquired_blocks_.load() > 0) {
+    AWARN << "segment of channel " << channel_id_ << " needs remap, but "
+          << acquired_blocks_.load() << " blocks are still held.";
+    return false;
+  }
   init_ = false;
   ADEBUG << "before reset.";
   Reset();
@@ -142,6 +225,11 @@ bool Segment::Remap() {
 }
 
 bool Segment::Recreate(const uint64_t& msg_size) {
+  if (acquired_blocks_.load() > 0) {
+    AERROR << "can't grow segment of channel " << channel_id_ << " while "
+           << acquired_blocks_.load() << " blocks are still held.";
+    return false;
+  }
   init_ = false;
   state_->set_need_remap(true);
   Reset();
@@ -150,15 +238,21 @@ bool Segment::Recreate(const uint64_t& msg_size) {
   return OpenOrCreate();
 }
 
-uint32_t Segment::GetNextWritableBlockIndex() {
+bool Segment::GetNextWritableBlockIndex(uint32_t* index) {
   const auto block_num = conf_.block_num();
-  while (1) {
+  // Writers may keep blocks locked while their loans are filled, and readers
+  // while they view messages in place, so give up after a few rounds instead
+  // of spinning until one is released.
+  const uint64_t max_try_times =
+      static_cast<uint64_t>(block_num) * Block::kMaxTryLockTimes;
+  for (uint64_t i = 0; i < max_try_times; ++i) {
     uint32_t try_idx = state_->FetchAddSeq(1) % block_num;
     if (blocks_[try_idx].TryLockForWrite()) {
-      return try_idx;
+      *index = try_idx;
+      return true;
     }
   }
-  return 0;
+  return false;
 }
 
 }  // namespace transport
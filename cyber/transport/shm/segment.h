@@ -17,10 +17,13 @@
 #ifndef CYBER_TRANSPORT_SHM_SEGMENT_H_
 #define CYBER_TRANSPORT_SHM_SEGMENT_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/transport/shm/block.h"
 #include "cyber/transport/shm/shm_conf.h"
@@ -37,19 +40,84 @@ struct WritableBlock {
   uint32_t index = 0;
   Block* block = nullptr;
   uint8_t* buf = nullptr;
+  // payload capacity of buf, excluding the trailing message info
+  uint64_t capacity = 0;
+};
+
+// One mapping of a segment in this process. It is torn down once the segment
+// has let go of it and the last view into it is gone.
+struct SegmentMapping {
+  ~SegmentMapping() {
+    if (unmap) {
+      unmap();
+    }
+  }
+
+  std::atomic<uint32_t> view_num = {0};
+  std::function<void()> unmap;
+};
+
+/**
+ * @brief A block a reader keeps read locked after the read, so the message in
+ * it can be used in place. The read lock is released with the view. Until
+ * then the block stays mapped, even if the segment is remapped or destroyed.
+ */
+class BlockView {
+ public:
+  BlockView(const std::shared_ptr<SegmentMapping>& mapping, Block* block,
+            const uint8_t* buf);
+  ~BlockView();
+
+  const uint8_t* buf() const { return buf_; }
+
+ private:
+  std::shared_ptr<SegmentMapping> mapping_;
+  Block* block_;
+  const uint8_t* buf_;
+};
+
+struct ReadableBlock : WritableBlock {
+  // set once the read lock is handed over, see Segment::ViewReadBlock
+  std::shared_ptr<BlockView> view;
+};
+
+struct SegmentStats {
+  struct BlockClass {
+    uint64_t block_buf_size = 0;
+    uint32_t block_num = 0;
+    uint32_t blocks_in_use = 0;
+    uint64_t write_count = 0;
+  };
+
+  std::vector<BlockClass> block_classes;
+  uint64_t mapped_size = 0;
 };
-using ReadableBlock = WritableBlock;
 
 class Segment {
  public:
   explicit Segment(uint64_t channel_id);
   virtual ~Segment() {}
 
-  bool AcquireBlockToWrite(std::size_t msg_size, WritableBlock* writable_block);
-  void ReleaseWrittenBlock(const WritableBlock& writable_block);
+  virtual bool AcquireBlockToWrite(std::size_t msg_size,
+                                   WritableBlock* writable_block);
+  virtual void ReleaseWrittenBlock(const WritableBlock& writable_block);
+
+  virtual bool AcquireBlockToRead(ReadableBlock* readable_block);
+  virtual void ReleaseReadBlock(const ReadableBlock& readable_block);
 
-  bool AcquireBlockToRead(ReadableBlock* readable_block);
-  void ReleaseReadBlock(const ReadableBlock& readable_block);
+  /**
+   * @brief Hand the read lock of an acquired block over to a view, which
+   * releases it on destruction instead of ReleaseReadBlock. Fails once the
+   * views of this process reach a quarter of the blocks of its size, so that
+   * writers always find free blocks; the block stays acquired then.
+   */
+  bool ViewReadBlock(ReadableBlock* readable_block);
+
+  // occupancy of the blocks, as seen by this process
+  virtual void GetStats(SegmentStats* stats);
+
+  // number of blocks this process currently holds a read or write lock on
+  uint32_t acquired_blocks() const { return acquired_blocks_.load(); }
 
  protected:
   virtual bool Destroy();
@@ -58,6 +126,11 @@ class Segment {
   virtual bool OpenOnly() = 0;
   virtual bool OpenOrCreate() = 0;
 
+  // views of blocks of the size of readable_block this process may keep
+  virtual uint32_t MaxBlockViews(const ReadableBlock& readable_block);
+  // unmaps now, or once the last view into the current mapping is gone
+  void ReleaseMapping(std::function<void()> unmap);
+
   bool init_;
   ShmConf conf_;
   uint64_t channel_id_;
@@ -68,10 +141,18 @@ class Segment {
   std::mutex block_buf_lock_;
   std::unordered_map<uint32_t, uint8_t*> block_buf_addrs_;
 
+  // Blocks loaned to a writer are held across calls, so the mapping must not
+  // be torn down while any are acquired. Views keep their mapping themselves
+  // and are not counted.
+  std::atomic<uint32_t> acquired_blocks_ = {0};
+
+  std::mutex mapping_lock_;
+  std::shared_ptr<SegmentMapping> mapping_;
+
  private:
   bool Remap();
   bool Recreate(const uint64_t& msg_size);
-  uint32_t GetNextWritableBlockIndex();
+  bool GetNextWritableBlockIndex(uint32_t* index);
 };
 
 }  // namespace transport
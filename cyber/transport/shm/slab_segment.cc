@@ -0,0 +1,454 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/slab_segment.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/log.h"
+#include "cyber/transport/shm/block.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+// Both structures live in shared memory and are valid when zero filled, so
+// a freshly truncated shm object needs no construction.
+struct SlabControl {
+  std::atomic<uint32_t> reference_count;
+};
+
+struct SlabHeader {
+  std::atomic<uint32_t> ready;
+  std::atomic<uint32_t> seq;
+  std::atomic<uint64_t> write_count;
+};
+
+namespace {
+
+constexpr uint32_t kSlabIndexShift = 24;
+constexpr uint32_t kBlockIndexMask = (1u << kSlabIndexShift) - 1;
+constexpr uint64_t kMinBlockBufSize = 1024 * 4;
+// Same room as ShmConf keeps behind each message for its MessageInfo
+constexpr uint64_t kMessageInfoSize = 1024;
+// Memory a slab aims at, the block number is clamped to [8, 512]
+constexpr uint64_t kSlabTargetSize = 1024 * 1024 * 64;
+constexpr uint32_t kMinBlockNum = 8;
+constexpr uint32_t kMaxBlockNum = 512;
+constexpr uint64_t kCacheLineSize = 64;
+
+static_assert(sizeof(SlabHeader) <= kCacheLineSize,
+              "slab header must fit in one cache line");
+
+uint64_t AlignUp(uint64_t size) {
+  return (size + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+}
+
+uint64_t GetBlocksOffset() { return kCacheLineSize; }
+
+uint64_t GetBufsOffset(uint32_t block_num) {
+  return AlignUp(GetBlocksOffset() + block_num * sizeof(Block));
+}
+
+}  // namespace
+
+SlabSegment::SlabSegment(uint64_t channel_id)
+    : Segment(channel_id), control_(nullptr), slabs_() {
+  shm_name_ = std::to_string(channel_id) + "_slab";
+}
+
+SlabSegment::~SlabSegment() {
+  Destroy();
+  Reset();
+}
+
+int32_t SlabSegment::GetSlabId(uint64_t msg_size) {
+  uint64_t needed = msg_size + kMessageInfoSize;
+  for (uint32_t id = 0; id < kSlabNum; ++id) {
+    if (needed <= GetBlockBufSize(id)) {
+      return static_cast<int32_t>(id);
+    }
+  }
+  return -1;
+}
+
+uint64_t SlabSegment::GetBlockBufSize(uint32_t slab_id) {
+  return kMinBlockBufSize << slab_id;
+}
+
+uint32_t SlabSegment::GetBlockNum(uint32_t slab_id) {
+  uint64_t num = kSlabTargetSize / GetBlockBufSize(slab_id);
+  num = std::max<uint64_t>(num, kMinBlockNum);
+  num = std::min<uint64_t>(num, kMaxBlockNum);
+  return static_cast<uint32_t>(num);
+}
+
+bool SlabSegment::AcquireBlockToWrite(std::size_t msg_size,
+                                      WritableBlock* writable_block) {
+  RETURN_VAL_IF_NULL(writable_block, false);
+  if (!init_ && !OpenOrCreate()) {
+    AERROR << "create shm failed, can't write now.";
+    return false;
+  }
+
+  int32_t first_id = GetSlabId(msg_size);
+  if (first_id < 0) {
+    AERROR << "msg_size: " << msg_size << " exceeds the largest block size: "
+           << GetBlockBufSize(kSlabNum - 1) - kMessageInfoSize;
+    return false;
+  }
+
+  // Only the best fitting slab is created on demand. When all of its blocks
+  // are busy, blocks of bigger slabs that already exist are used instead.
+  for (uint32_t id = static_cast<uint32_t>(first_id); id < kSlabNum; ++id) {
+    Slab* slab = GetSlab(id, id == static_cast<uint32_t>(first_id));
+    if (slab == nullptr) {
+      continue;
+    }
+    uint32_t block_index = 0;
+    if (!LockNextWritableBlock(slab, &block_index)) {
+      continue;
+    }
+    slab->header->write_count.fetch_add(1);
+    acquired_blocks_.fetch_add(1);
+    writable_block->index = (id << kSlabIndexShift) | block_index;
+    writable_block->block = slab->blocks + block_index;
+    writable_block->buf = slab->bufs + block_index * GetBlockBufSize(id);
+    writable_block->capacity = GetBlockBufSize(id) - kMessageInfoSize;
+    return true;
+  }
+
+  AERROR << "no writable block for msg_size: " << msg_size;
+  return false;
+}
+
+void SlabSegment::ReleaseWrittenBlock(const WritableBlock& writable_block) {
+  Slab* slab = nullptr;
+  uint32_t block_index = 0;
+  if (!Decode(writable_block.index, &slab, &block_index)) {
+    return;
+  }
+  slab->blocks[block_index].ReleaseWriteLock();
+  acquired_blocks_.fetch_sub(1);
+}
+
+bool SlabSegment::AcquireBlockToRead(ReadableBlock* readable_block) {
+  RETURN_VAL_IF_NULL(readable_block, false);
+  if (!init_ && !OpenOnly()) {
+    AERROR << "failed to open shared memory, can't read now.";
+    return false;
+  }
+
+  Slab* slab = nullptr;
+  uint32_t block_index = 0;
+  if (!Decode(readable_block->index, &slab, &block_index)) {
+    AERROR << "invalid block_index[" << readable_block->index << "].";
+    return false;
+  }
+
+  if (!slab->blocks[block_index].TryLockForRead()) {
+    return false;
+  }
+  acquired_blocks_.fetch_add(1);
+  uint32_t slab_id = readable_block->index >> kSlabIndexShift;
+  readable_block->block = slab->blocks + block_index;
+  readable_block->buf = slab->bufs + block_index * GetBlockBufSize(slab_id);
+  readable_block->capacity = GetBlockBufSize(slab_id) - kMessageInfoSize;
+  return true;
+}
+
+void SlabSegment::ReleaseReadBlock(const ReadableBlock& readable_block) {
+  Slab* slab = nullptr;
+  uint32_t block_index = 0;
+  if (!Decode(readable_block.index, &slab, &block_index)) {
+    return;
+  }
+  slab->blocks[block_index].ReleaseReadLock();
+  acquired_blocks_.fetch_sub(1);
+}
+
+uint32_t SlabSegment::MaxBlockViews(const ReadableBlock& readable_block) {
+  uint32_t slab_id = readable_block.index >> kSlabIndexShift;
+  if (slab_id >= kSlabNum) {
+    return 0;
+  }
+  return GetBlockNum(slab_id) / 4;
+}
+
+void SlabSegment::GetStats(SegmentStats* stats) {
+  RETURN_IF_NULL(stats);
+  stats->block_classes.clear();
+  stats->mapped_size = 0;
+  if (!init_) {
+    return;
+  }
+
+  for (uint32_t id = 0; id < kSlabNum; ++id) {
+    Slab* slab = GetSlab(id, false);
+    if (slab == nullptr) {
+      continue;
+    }
+    SegmentStats::BlockClass block_class;
+    block_class.block_buf_size = GetBlockBufSize(id);
+    block_class.block_num = GetBlockNum(id);
+    for (uint32_t i = 0; i < block_class.block_num; ++i) {
+      if (slab->blocks[i].lock_num_.load() != Block::kRWLockFree) {
+        ++block_class.blocks_in_use;
+      }
+    }
+    block_class.write_count = slab->header->write_count.load();
+    stats->block_classes.push_back(block_class);
+    stats->mapped_size += slab->mapped_size;
+  }
+}
+
+bool SlabSegment::Destroy() {
+  if (!init_) {
+    return true;
+  }
+  init_ = false;
+
+  uint32_t reference_count = control_->reference_count.load();
+  while (reference_count > 0 &&
+         !control_->reference_count.compare_exchange_weak(
+             reference_count, reference_count - 1)) {
+  }
+  if (reference_count <= 1) {
+    return Remove();
+  }
+  ADEBUG << "destroy.";
+  return true;
+}
+
+void SlabSegment::Reset() {
+  std::vector<std::pair<void*, uint64_t>> mapped;
+  {
+    std::lock_guard<std::mutex> lock(slabs_mutex_);
+    for (auto& slab : slabs_) {
+      if (slab.addr != nullptr) {
+        mapped.emplace_back(slab.addr, slab.mapped_size);
+      }
+      slab = Slab();
+    }
+  }
+  if (control_ != nullptr) {
+    mapped.emplace_back(control_, sizeof(SlabControl));
+    control_ = nullptr;
+  }
+  if (!mapped.empty()) {
+    ReleaseMapping([mapped]() {
+      for (const auto& region : mapped) {
+        munmap(region.first, region.second);
+      }
+    });
+  }
+}
+
+bool SlabSegment::Remove() {
+  for (uint32_t id = 0; id < kSlabNum; ++id) {
+    if (shm_unlink(SlabName(id).c_str()) < 0 && errno != ENOENT) {
+      AERROR << "shm_unlink slab " << id << " failed: " << strerror(errno);
+    }
+  }
+  if (shm_unlink(shm_name_.c_str()) < 0) {
+    AERROR << "shm_unlink failed: " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool SlabSegment::OpenOnly() { return OpenControl(false); }
+
+bool SlabSegment::OpenOrCreate() { return OpenControl(true); }
+
+bool SlabSegment::OpenControl(bool create) {
+  if (init_) {
+    return true;
+  }
+
+  int flags = create ? O_RDWR | O_CREAT : O_RDWR;
+  int fd = shm_open(shm_name_.c_str(), flags, 0644);
+  if (fd < 0) {
+    AERROR << "open shm failed: " << strerror(errno);
+    return false;
+  }
+
+  struct stat file_attr;
+  if (fstat(fd, &file_attr) < 0) {
+    AERROR << "fstat failed: " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  if (static_cast<uint64_t>(file_attr.st_size) < sizeof(SlabControl)) {
+    if (!create) {
+      AERROR << "shm is not ready yet.";
+      close(fd);
+      return false;
+    }
+    if (ftruncate(fd, sizeof(SlabControl)) < 0) {
+      AERROR << "ftruncate failed: " << strerror(errno);
+      close(fd);
+      return false;
+    }
+  }
+
+  void* addr = mmap(nullptr, sizeof(SlabControl), PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    AERROR << "attach shm failed: " << strerror(errno);
+    return false;
+  }
+
+  control_ = static_cast<SlabControl*>(addr);
+  control_->reference_count.fetch_add(1);
+  init_ = true;
+  return true;
+}
+
+SlabSegment::Slab* SlabSegment::GetSlab(uint32_t slab_id, bool create) {
+  std::lock_guard<std::mutex> lock(slabs_mutex_);
+  Slab* slab = &slabs_[slab_id];
+  if (slab->addr == nullptr && !MapSlab(slab_id, create, slab)) {
+    return nullptr;
+  }
+  return slab;
+}
+
+bool SlabSegment::MapSlab(uint32_t slab_id, bool create, Slab* slab) {
+  const std::string name = SlabName(slab_id);
+  const uint32_t block_num = GetBlockNum(slab_id);
+  const uint64_t bufs_offset = GetBufsOffset(block_num);
+  const uint64_t mapped_size =
+      bufs_offset + block_num * GetBlockBufSize(slab_id);
+
+  bool created = false;
+  int fd = -1;
+  if (create) {
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd >= 0) {
+      created = true;
+    } else if (errno != EEXIST) {
+      AERROR << "create slab " << name << " failed: " << strerror(errno);
+      return false;
+    }
+  }
+  if (fd < 0) {
+    fd = shm_open(name.c_str(), O_RDWR, 0644);
+    if (fd < 0) {
+      ADEBUG << "slab " << name << " does not exist.";
+      return false;
+    }
+  }
+
+  if (created) {
+    if (ftruncate(fd, mapped_size) < 0) {
+      AERROR << "ftruncate slab " << name << " failed: " << strerror(errno);
+      close(fd);
+      shm_unlink(name.c_str());
+      return false;
+    }
+  } else {
+    struct stat file_attr;
+    if (fstat(fd, &file_attr) < 0 ||
+        static_cast<uint64_t>(file_attr.st_size) != mapped_size) {
+      ADEBUG << "slab " << name << " is not ready yet.";
+      close(fd);
+      return false;
+    }
+  }
+
+  void* addr =
+      mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    AERROR << "attach slab " << name << " failed: " << strerror(errno);
+    if (created) {
+      shm_unlink(name.c_str());
+    }
+    return false;
+  }
+
+  char* base = static_cast<char*>(addr);
+  auto header = reinterpret_cast<SlabHeader*>(base);
+  auto blocks = reinterpret_cast<Block*>(base + GetBlocksOffset());
+  if (created) {
+    for (uint32_t i = 0; i < block_num; ++i) {
+      new (blocks + i) Block();
+    }
+    header->ready.store(1, std::memory_order_release);
+    AINFO << "channel " << channel_id_ << " creates slab of " << block_num
+          << " x " << GetBlockBufSize(slab_id) << " bytes.";
+  } else if (header->ready.load(std::memory_order_acquire) == 0) {
+    ADEBUG << "slab " << name << " is not ready yet.";
+    munmap(addr, mapped_size);
+    return false;
+  }
+
+  slab->addr = addr;
+  slab->mapped_size = mapped_size;
+  slab->header = header;
+  slab->blocks = blocks;
+  slab->bufs = reinterpret_cast<uint8_t*>(base + bufs_offset);
+  return true;
+}
+
+bool SlabSegment::LockNextWritableBlock(Slab* slab, uint32_t* block_index) {
+  uint32_t slab_id = static_cast<uint32_t>(slab - slabs_.data());
+  const uint32_t block_num = GetBlockNum(slab_id);
+  const uint64_t max_try_times =
+      static_cast<uint64_t>(block_num) * Block::kMaxTryLockTimes;
+  for (uint64_t i = 0; i < max_try_times; ++i) {
+    uint32_t try_idx = slab->header->seq.fetch_add(1) % block_num;
+    if (slab->blocks[try_idx].TryLockForWrite()) {
+      *block_index = try_idx;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SlabSegment::Decode(uint32_t index, Slab** slab, uint32_t* block_index) {
+  uint32_t slab_id = index >> kSlabIndexShift;
+  if (slab_id >= kSlabNum) {
+    return false;
+  }
+  *block_index = index & kBlockIndexMask;
+  if (*block_index >= GetBlockNum(slab_id)) {
+    return false;
+  }
+  *slab = GetSlab(slab_id, false);
+  return *slab != nullptr;
+}
+
+std::string SlabSegment::SlabName(uint32_t slab_id) const {
+  return shm_name_ + "_" + std::to_string(slab_id);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
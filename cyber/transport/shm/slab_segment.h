@@ -0,0 +1,100 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_SLAB_SEGMENT_H_
+#define CYBER_TRANSPORT_SHM_SLAB_SEGMENT_H_
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "cyber/transport/shm/segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+struct SlabControl;
+struct SlabHeader;
+
+/**
+ * @brief A segment made of one slab per power-of-two block size. Slabs are
+ * separate posix shm objects created on first use, so blocks of different
+ * sizes coexist and a bigger message only adds a slab instead of recreating
+ * the whole segment. Readers map slabs lazily from the block index, whose
+ * upper bits select the slab.
+ */
+class SlabSegment : public Segment {
+ public:
+  explicit SlabSegment(uint64_t channel_id);
+  virtual ~SlabSegment();
+
+  static const char* Type() { return "slab"; }
+
+  bool AcquireBlockToWrite(std::size_t msg_size,
+                           WritableBlock* writable_block) override;
+  void ReleaseWrittenBlock(const WritableBlock& writable_block) override;
+
+  bool AcquireBlockToRead(ReadableBlock* readable_block) override;
+  void ReleaseReadBlock(const ReadableBlock& readable_block) override;
+
+  void GetStats(SegmentStats* stats) override;
+
+  // block sizes go from 4K to 512M
+  static constexpr uint32_t kSlabNum = 18;
+
+  // slab id whose blocks fit msg_size, -1 if the message is too large
+  static int32_t GetSlabId(uint64_t msg_size);
+  static uint64_t GetBlockBufSize(uint32_t slab_id);
+  static uint32_t GetBlockNum(uint32_t slab_id);
+
+ protected:
+  bool Destroy() override;
+
+ private:
+  struct Slab {
+    void* addr = nullptr;
+    uint64_t mapped_size = 0;
+    SlabHeader* header = nullptr;
+    Block* blocks = nullptr;
+    uint8_t* bufs = nullptr;
+  };
+
+  void Reset() override;
+  bool Remove() override;
+  bool OpenOnly() override;
+  bool OpenOrCreate() override;
+  uint32_t MaxBlockViews(const ReadableBlock& readable_block) override;
+
+  bool OpenControl(bool create);
+  Slab* GetSlab(uint32_t slab_id, bool create);
+  bool MapSlab(uint32_t slab_id, bool create, Slab* slab);
+  bool LockNextWritableBlock(Slab* slab, uint32_t* block_index);
+  bool Decode(uint32_t index, Slab** slab, uint32_t* block_index);
+  std::string SlabName(uint32_t slab_id) const;
+
+  std::string shm_name_;
+  SlabControl* control_;
+  std::mutex slabs_mutex_;
+  std::array<Slab, kSlabNum> slabs_;
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_SLAB_SEGMENT_H_
@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/slab_segment.h"
+
+#include <cstring>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+TEST(SlabSegmentTest, size_classes) {
+  EXPECT_EQ(SlabSegment::GetSlabId(0), 0);
+  EXPECT_EQ(SlabSegment::GetSlabId(1024), 0);
+  EXPECT_EQ(SlabSegment::GetSlabId(1024 * 3 + 1), 1);
+  EXPECT_EQ(SlabSegment::GetSlabId(1024 * 1024 * 8), 12);
+  EXPECT_EQ(SlabSegment::GetSlabId(1024ULL * 1024 * 1024), -1);
+
+  EXPECT_EQ(SlabSegment::GetBlockNum(0), 512);
+  EXPECT_EQ(SlabSegment::GetBlockNum(8), 64);
+  EXPECT_EQ(SlabSegment::GetBlockNum(SlabSegment::kSlabNum - 1), 8);
+}
+
+TEST(SlabSegmentTest, write_read_mixed_sizes) {
+  const uint64_t channel_id = 0x51ab5e9;
+  SlabSegment writer(channel_id);
+  SlabSegment reader(channel_id);
+
+  SegmentStats stats;
+  writer.GetStats(&stats);
+  EXPECT_TRUE(stats.block_classes.empty());
+
+  std::vector<std::size_t> sizes = {100, 1024 * 100, 1024 * 1024 * 5, 200};
+  for (std::size_t size : sizes) {
+    WritableBlock wb;
+    ASSERT_TRUE(writer.AcquireBlockToWrite(size, &wb));
+    EXPECT_GE(wb.capacity, size);
+    memset(wb.buf, static_cast<int>(size % 255), size);
+    wb.block->set_msg_size(size);
+    writer.ReleaseWrittenBlock(wb);
+
+    ReadableBlock rb;
+    rb.index = wb.index;
+    ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+    EXPECT_EQ(rb.block->msg_size(), size);
+    EXPECT_EQ(rb.buf[size - 1], static_cast<uint8_t>(size % 255));
+    EXPECT_EQ(reader.acquired_blocks(), 1);
+    reader.ReleaseReadBlock(rb);
+    EXPECT_EQ(reader.acquired_blocks(), 0);
+  }
+
+  // small and large blocks coexist, nothing was recreated
+  writer.GetStats(&stats);
+  ASSERT_EQ(stats.block_classes.size(), 3);
+  EXPECT_EQ(stats.block_classes[0].block_buf_size, 1024 * 4);
+  EXPECT_EQ(stats.block_classes[0].write_count, 2);
+  EXPECT_EQ(stats.block_classes[0].blocks_in_use, 0);
+  EXPECT_GT(stats.mapped_size, 0);
+}
+
+TEST(SlabSegmentTest, blocks_in_use) {
+  const uint64_t channel_id = 0x51ab5ea;
+  SlabSegment segment(channel_id);
+
+  WritableBlock wb;
+  ASSERT_TRUE(segment.AcquireBlockToWrite(10, &wb));
+  SegmentStats stats;
+  segment.GetStats(&stats);
+  ASSERT_EQ(stats.block_classes.size(), 1);
+  EXPECT_EQ(stats.block_classes[0].blocks_in_use, 1);
+
+  ReadableBlock rb;
+  rb.index = wb.index;
+  EXPECT_FALSE(segment.AcquireBlockToRead(&rb));
+  segment.ReleaseWrittenBlock(wb);
+  EXPECT_TRUE(segment.AcquireBlockToRead(&rb));
+  segment.ReleaseReadBlock(rb);
+
+  rb.index = 0xFFFFFFFF;
+  EXPECT_FALSE(segment.AcquireBlockToRead(&rb));
+}
+
+TEST(SlabSegmentTest, block_views) {
+  const uint64_t channel_id = 0x51ab5eb;
+  SlabSegment writer(channel_id);
+  std::unique_ptr<SlabSegment> reader(new SlabSegment(channel_id));
+
+  // a quarter of the 512 blocks of the smallest slab may be viewed
+  std::vector<std::shared_ptr<BlockView>> views;
+  std::set<uint32_t> viewed_indexes;
+  for (int i = 0; i <= 128; ++i) {
+    WritableBlock wb;
+    ASSERT_TRUE(writer.AcquireBlockToWrite(10, &wb));
+    // blocks still viewed are never written
+    EXPECT_EQ(viewed_indexes.count(wb.index), 0);
+    memset(wb.buf, i, 10);
+    wb.block->set_msg_size(10);
+    writer.ReleaseWrittenBlock(wb);
+
+    ReadableBlock rb;
+    rb.index = wb.index;
+    ASSERT_TRUE(reader->AcquireBlockToRead(&rb));
+    if (i < 128) {
+      ASSERT_TRUE(reader->ViewReadBlock(&rb));
+      ASSERT_NE(rb.view, nullptr);
+      EXPECT_EQ(rb.view->buf(), rb.buf);
+      views.push_back(rb.view);
+      viewed_indexes.insert(wb.index);
+    } else {
+      EXPECT_FALSE(reader->ViewReadBlock(&rb));
+      EXPECT_EQ(rb.view, nullptr);
+      reader->ReleaseReadBlock(rb);
+    }
+    EXPECT_EQ(reader->acquired_blocks(), 0);
+  }
+
+  SegmentStats stats;
+  writer.GetStats(&stats);
+  ASSERT_EQ(stats.block_classes.size(), 1);
+  EXPECT_EQ(stats.block_classes[0].blocks_in_use, 128);
+
+  // the views outlive the mapping of the reader
+  reader.reset();
+  for (int i = 0; i < 128; ++i) {
+    EXPECT_EQ(views[i]->buf()[9], static_cast<uint8_t>(i));
+  }
+  views.clear();
+  writer.GetStats(&stats);
+  EXPECT_EQ(stats.block_classes[0].blocks_in_use, 0);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
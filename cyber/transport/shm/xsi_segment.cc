@@ -227,7 +227,7 @@ void XsiSegment::Reset() {
     block_buf_addrs_.clear();
   }
   if (managed_shm_ != nullptr) {
-    shmdt(managed_shm_);
+    ReleaseMapping([addr = managed_shm_]() { shmdt(addr); });
     managed_shm_ = nullptr;
     return;
   }
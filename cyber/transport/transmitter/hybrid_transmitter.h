@@ -71,6 +71,10 @@ class HybridTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  using Transmitter<M>::Commit;
+  bool Loan(std::size_t size, LoanedBuffer* loan) override;
+  bool Commit(LoanedBuffer* loan, const MessageInfo& msg_info) override;
+
  private:
   void InitMode();
   void ObtainConfig();
@@ -171,6 +175,64 @@ bool HybridTransmitter<M>::Transmit(const MessagePtr& msg,
   return true;
 }
 
+template <typename M>
+bool HybridTransmitter<M>::Loan(std::size_t size, LoanedBuffer* loan) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = transmitters_.find(OptionalMode::SHM);
+    if (iter != transmitters_.end() &&
+        !receivers_[OptionalMode::SHM].empty() &&
+        iter->second->Loan(size, loan)) {
+      return true;
+    }
+  }
+  return Transmitter<M>::Loan(size, loan);
+}
+
+template <typename M>
+bool HybridTransmitter<M>::Commit(LoanedBuffer* loan,
+                                  const MessageInfo& msg_info) {
+  RETURN_VAL_IF_NULL(loan, false);
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Readers outside the shm segment and the history still need a message
+  // object, it is parsed from the loaned bytes at most once.
+  MessagePtr msg = nullptr;
+  auto materialize = [&msg, loan]() {
+    if (msg == nullptr) {
+      auto parsed = std::make_shared<M>();
+      if (message::ParseFromArray(loan->buf, static_cast<int>(loan->size),
+                                  parsed.get())) {
+        msg = parsed;
+      }
+    }
+    return msg != nullptr;
+  };
+
+  if (this->attr_.qos_profile().durability() ==
+          QosDurabilityPolicy::DURABILITY_TRANSIENT_LOCAL &&
+      materialize()) {
+    history_->Add(msg, msg_info);
+  }
+
+  for (auto& item : transmitters_) {
+    if (loan->in_shm() && item.first == OptionalMode::SHM) {
+      continue;
+    }
+    if (receivers_[item.first].empty() && loan->in_shm()) {
+      continue;
+    }
+    if (materialize()) {
+      item.second->Transmit(msg, msg_info);
+    }
+  }
+
+  if (loan->in_shm()) {
+    return transmitters_[OptionalMode::SHM]->Commit(loan, msg_info);
+  }
+  Transmitter<M>::Return(loan);
+  return msg != nullptr;
+}
+
 template <typename M>
 void HybridTransmitter<M>::InitMode() {
   mode_ = std::make_shared<proto::CommunicationMode>();
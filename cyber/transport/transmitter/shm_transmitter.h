@@ -48,8 +48,14 @@ class ShmTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  using Transmitter<M>::Commit;
+  bool Loan(std::size_t size, LoanedBuffer* loan) override;
+  bool Commit(LoanedBuffer* loan, const MessageInfo& msg_info) override;
+
  private:
   bool Transmit(const M& msg, const MessageInfo& msg_info);
+  bool Publish(const WritableBlock& wb, std::size_t msg_size,
+               const MessageInfo& msg_info);
 
   SegmentPtr segment_;
   uint64_t channel_id_;
@@ -117,6 +123,58 @@ bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
     segment_->ReleaseWrittenBlock(wb);
     return false;
   }
+  return Publish(wb, msg_size, msg_info);
+}
+
+template <typename M>
+bool ShmTransmitter<M>::Loan(std::size_t size, LoanedBuffer* loan) {
+  RETURN_VAL_IF_NULL(loan, false);
+  if (!this->enabled_) {
+    ADEBUG << "not enable.";
+    return false;
+  }
+
+  WritableBlock wb;
+  if (!segment_->AcquireBlockToWrite(size, &wb)) {
+    AERROR << "acquire block to loan failed.";
+    return false;
+  }
+
+  loan->Clear();
+  loan->buf = wb.buf;
+  loan->capacity = wb.capacity;
+  loan->size = size;
+  loan->segment = segment_;
+  loan->block = wb;
+  return true;
+}
+
+template <typename M>
+bool ShmTransmitter<M>::Commit(LoanedBuffer* loan,
+                               const MessageInfo& msg_info) {
+  RETURN_VAL_IF_NULL(loan, false);
+  if (!loan->in_shm()) {
+    return Transmitter<M>::Commit(loan, msg_info);
+  }
+
+  if (!this->enabled_ || loan->segment != segment_ ||
+      loan->size > loan->capacity) {
+    AERROR << "loaned block of channel "
+           << common::GlobalData::GetChannelById(channel_id_)
+           << " is no longer valid.";
+    this->Return(loan);
+    return false;
+  }
+
+  WritableBlock wb = loan->block;
+  std::size_t msg_size = loan->size;
+  loan->Clear();
+  return Publish(wb, msg_size, msg_info);
+}
+
+template <typename M>
+bool ShmTransmitter<M>::Publish(const WritableBlock& wb, std::size_t msg_size,
+                                const MessageInfo& msg_info) {
   wb.block->set_msg_size(msg_size);
 
   char* msg_info_addr = reinterpret_cast<char*>(wb.buf) + msg_size;
@@ -21,8 +21,11 @@
 #include <memory>
 #include <string>
 
+#include "cyber/common/log.h"
 #include "cyber/event/perf_event_cache.h"
+#include "cyber/message/message_traits.h"
 #include "cyber/transport/common/endpoint.h"
+#include "cyber/transport/message/loaned_buffer.h"
 #include "cyber/transport/message/message_info.h"
 
 namespace apollo {
@@ -49,6 +52,15 @@ class Transmitter : public Endpoint {
   virtual bool Transmit(const MessagePtr& msg);
   virtual bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) = 0;
 
+  // Loan a buffer of at least `size` bytes to write a message in place. The
+  // default loan lives on the heap and is parsed into a message on Commit;
+  // transmitters that own shared memory loan a block of it instead.
+  virtual bool Loan(std::size_t size, LoanedBuffer* loan);
+  virtual void Return(LoanedBuffer* loan);
+
+  bool Commit(LoanedBuffer* loan);
+  virtual bool Commit(LoanedBuffer* loan, const MessageInfo& msg_info);
+
   uint64_t NextSeqNum() { return ++seq_num_; }
 
   uint64_t seq_num() const { return seq_num_; }
@@ -76,6 +88,50 @@ bool Transmitter<M>::Transmit(const MessagePtr& msg) {
   return Transmit(msg, msg_info_);
 }
 
+template <typename M>
+bool Transmitter<M>::Loan(std::size_t size, LoanedBuffer* loan) {
+  RETURN_VAL_IF_NULL(loan, false);
+  loan->Clear();
+  loan->heap.resize(size);
+  loan->buf = loan->heap.data();
+  loan->capacity = size;
+  loan->size = size;
+  return true;
+}
+
+template <typename M>
+void Transmitter<M>::Return(LoanedBuffer* loan) {
+  if (loan == nullptr) {
+    return;
+  }
+  if (loan->in_shm()) {
+    loan->segment->ReleaseWrittenBlock(loan->block);
+  }
+  loan->Clear();
+}
+
+template <typename M>
+bool Transmitter<M>::Commit(LoanedBuffer* loan) {
+  msg_info_.set_seq_num(NextSeqNum());
+  PerfEventCache::Instance()->AddTransportEvent(
+      TransPerf::TRANSMIT_BEGIN, attr_.channel_id(), msg_info_.seq_num());
+  return Commit(loan, msg_info_);
+}
+
+template <typename M>
+bool Transmitter<M>::Commit(LoanedBuffer* loan, const MessageInfo& msg_info) {
+  RETURN_VAL_IF_NULL(loan, false);
+  auto msg = std::make_shared<M>();
+  bool parsed = message::ParseFromArray(
+      loan->buf, static_cast<int>(loan->size), msg.get());
+  Return(loan);
+  if (!parsed) {
+    AERROR << "parse loaned buffer failed.";
+    return false;
+  }
+  return Transmit(msg, msg_info);
+}
+
 template <typename M>
 void Transmitter<M>::Enable(const RoleAttributes& opposite_attr) {
   (void)opposite_attr;
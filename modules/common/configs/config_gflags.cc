@@ -38,6 +38,15 @@ DEFINE_string(park_go_routing_filename, "park_go_routing.txt",
               "Park go routing of the map, support for dreamview contest.");
 DEFINE_string(speed_control_filename, "speed_control.pb.txt",
               "The speed control region in a map.");
+DEFINE_bool(use_map_tile_streaming, false,
+            "Keep only the map tiles around the vehicle and ahead on the "
+            "route in memory, only for maps in the .flat format.");
+DEFINE_double(map_tile_size, 250.0, "Side length of a map tile in meters.");
+DEFINE_double(map_tile_resident_radius, 1000.0,
+              "Map tiles within this radius of the vehicle are kept.");
+DEFINE_double(map_tile_prefetch_distance, 2000.0,
+              "Map tiles along the route up to this distance ahead of the "
+              "vehicle are loaded in the background.");
 
 DEFINE_string(vehicle_config_path,
               "/apollo/modules/common/data/vehicle_param.pb.txt",
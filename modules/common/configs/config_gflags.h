@@ -31,6 +31,10 @@ DECLARE_string(end_way_point_filename);
 DECLARE_string(default_routing_filename);
 DECLARE_string(park_go_routing_filename);
 DECLARE_string(speed_control_filename);
+DECLARE_bool(use_map_tile_streaming);
+DECLARE_double(map_tile_size);
+DECLARE_double(map_tile_resident_radius);
+DECLARE_double(map_tile_prefetch_distance);
 
 DECLARE_double(look_forward_time_sec);
 
@@ -0,0 +1,130 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/flat_aaboxkdtree2d.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace apollo {
+namespace common {
+namespace math {
+
+namespace {
+
+// max(min - value, 0, value - max), the distance of value to [min, max]
+inline double AxisDistance(double min, double max, double value) {
+  return std::max({min - value, 0.0, value - max});
+}
+
+}  // namespace
+
+// Map coordinates need double precision, so a vector holds 4 boxes with AVX
+// and 2 with SSE2, the remainder and other architectures use the scalar loop.
+void BoxDistanceSquareToPoint(const double *min_x, const double *min_y,
+                              const double *max_x, const double *max_y,
+                              size_t num, const Vec2d &point,
+                              double *distance_sqr) {
+  size_t i = 0;
+#if defined(__AVX__)
+  const __m256d x = _mm256_set1_pd(point.x());
+  const __m256d y = _mm256_set1_pd(point.y());
+  const __m256d zero = _mm256_setzero_pd();
+  for (; i + 4 <= num; i += 4) {
+    const __m256d dx = _mm256_max_pd(
+        _mm256_max_pd(_mm256_sub_pd(_mm256_loadu_pd(min_x + i), x), zero),
+        _mm256_sub_pd(x, _mm256_loadu_pd(max_x + i)));
+    const __m256d dy = _mm256_max_pd(
+        _mm256_max_pd(_mm256_sub_pd(_mm256_loadu_pd(min_y + i), y), zero),
+        _mm256_sub_pd(y, _mm256_loadu_pd(max_y + i)));
+    _mm256_storeu_pd(distance_sqr + i,
+                     _mm256_add_pd(_mm256_mul_pd(dx, dx),
+                                   _mm256_mul_pd(dy, dy)));
+  }
+#elif defined(__SSE2__)
+  const __m128d x = _mm_set1_pd(point.x());
+  const __m128d y = _mm_set1_pd(point.y());
+  const __m128d zero = _mm_setzero_pd();
+  for (; i + 2 <= num; i += 2) {
+    const __m128d dx =
+        _mm_max_pd(_mm_max_pd(_mm_sub_pd(_mm_loadu_pd(min_x + i), x), zero),
+                   _mm_sub_pd(x, _mm_loadu_pd(max_x + i)));
+    const __m128d dy =
+        _mm_max_pd(_mm_max_pd(_mm_sub_pd(_mm_loadu_pd(min_y + i), y), zero),
+                   _mm_sub_pd(y, _mm_loadu_pd(max_y + i)));
+    _mm_storeu_pd(distance_sqr + i,
+                  _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+  }
+#endif
+  for (; i < num; ++i) {
+    const double dx = AxisDistance(min_x[i], max_x[i], point.x());
+    const double dy = AxisDistance(min_y[i], max_y[i], point.y());
+    distance_sqr[i] = dx * dx + dy * dy;
+  }
+}
+
+void PointDistanceSquareToBox(const double *x, const double *y, size_t num,
+                              const AABox2d &box, double *distance_sqr) {
+  size_t i = 0;
+#if defined(__AVX__)
+  const __m256d min_x = _mm256_set1_pd(box.min_x());
+  const __m256d min_y = _mm256_set1_pd(box.min_y());
+  const __m256d max_x = _mm256_set1_pd(box.max_x());
+  const __m256d max_y = _mm256_set1_pd(box.max_y());
+  const __m256d zero = _mm256_setzero_pd();
+  for (; i + 4 <= num; i += 4) {
+    const __m256d px = _mm256_loadu_pd(x + i);
+    const __m256d py = _mm256_loadu_pd(y + i);
+    const __m256d dx = _mm256_max_pd(
+        _mm256_max_pd(_mm256_sub_pd(min_x, px), zero),
+        _mm256_sub_pd(px, max_x));
+    const __m256d dy = _mm256_max_pd(
+        _mm256_max_pd(_mm256_sub_pd(min_y, py), zero),
+        _mm256_sub_pd(py, max_y));
+    _mm256_storeu_pd(distance_sqr + i,
+                     _mm256_add_pd(_mm256_mul_pd(dx, dx),
+                                   _mm256_mul_pd(dy, dy)));
+  }
+#elif defined(__SSE2__)
+  const __m128d min_x = _mm_set1_pd(box.min_x());
+  const __m128d min_y = _mm_set1_pd(box.min_y());
+  const __m128d max_x = _mm_set1_pd(box.max_x());
+  const __m128d max_y = _mm_set1_pd(box.max_y());
+  const __m128d zero = _mm_setzero_pd();
+  for (; i + 2 <= num; i += 2) {
+    const __m128d px = _mm_loadu_pd(x + i);
+    const __m128d py = _mm_loadu_pd(y + i);
+    const __m128d dx = _mm_max_pd(_mm_max_pd(_mm_sub_pd(min_x, px), zero),
+                                  _mm_sub_pd(px, max_x));
+    const __m128d dy = _mm_max_pd(_mm_max_pd(_mm_sub_pd(min_y, py), zero),
+                                  _mm_sub_pd(py, max_y));
+    _mm_storeu_pd(distance_sqr + i,
+                  _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+  }
+#endif
+  for (; i < num; ++i) {
+    const double dx = AxisDistance(box.min_x(), box.max_x(), x[i]);
+    const double dy = AxisDistance(box.min_y(), box.max_y(), y[i]);
+    distance_sqr[i] = dx * dx + dy * dy;
+  }
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
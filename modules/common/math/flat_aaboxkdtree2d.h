@@ -0,0 +1,553 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Defines the templated FlatAABoxKDTree2d class.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "cyber/common/log.h"
+
+#include "modules/common/math/aabox2d.h"
+#include "modules/common/math/aaboxkdtree2d.h"
+#include "modules/common/math/math_utils.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+/**
+ * @brief Compute the squared distances from a point to boxes given as
+ *        structure of arrays, 0 for boxes containing the point.
+ * @param min_x Minimum x of the boxes.
+ * @param min_y Minimum y of the boxes.
+ * @param max_x Maximum x of the boxes.
+ * @param max_y Maximum y of the boxes.
+ * @param num Number of boxes.
+ * @param point The point.
+ * @param distance_sqr Output of num squared distances.
+ */
+void BoxDistanceSquareToPoint(const double *min_x, const double *min_y,
+                              const double *max_x, const double *max_y,
+                              size_t num, const Vec2d &point,
+                              double *distance_sqr);
+
+/**
+ * @brief Compute the squared distances from points given as structure of
+ *        arrays to a box, 0 for points inside the box.
+ * @param x X of the points.
+ * @param y Y of the points.
+ * @param num Number of points.
+ * @param box The box.
+ * @param distance_sqr Output of num squared distances.
+ */
+void PointDistanceSquareToBox(const double *x, const double *y, size_t num,
+                              const AABox2d &box, double *distance_sqr);
+
+/**
+ * @class FlatAABoxKDTree2d
+ * @brief A KD-tree of axis-aligned bounding boxes with the same partitioning
+ *        and queries as AABoxKDTree2d. The nodes are kept in one array in
+ *        depth first order, so the objects of a subtree are contiguous, and
+ *        the boxes of the objects are kept as structure of arrays, which
+ *        range queries filter several at a time with SIMD before the exact
+ *        distance of an object is computed. The batch queries answer many
+ *        points at once.
+ */
+template <class ObjectType>
+class FlatAABoxKDTree2d {
+ public:
+  using ObjectPtr = const ObjectType *;
+
+  /**
+   * @brief Constructor which takes a vector of objects and parameters.
+   * @param objects Objects to build the KD-tree, which have to outlive it.
+   * @param params Parameters to build the KD-tree.
+   */
+  FlatAABoxKDTree2d(const std::vector<ObjectType> &objects,
+                    const AABoxKDTreeParams &params) {
+    if (objects.empty()) {
+      return;
+    }
+    std::vector<ObjectPtr> object_ptrs;
+    object_ptrs.reserve(objects.size());
+    for (const auto &object : objects) {
+      object_ptrs.push_back(&object);
+    }
+    objects_.reserve(objects.size());
+    BuildNode(object_ptrs, params, 0);
+    SortObjects();
+  }
+
+  /**
+   * @brief Get the nearest object to a target point.
+   * @param point The target point. Search it's nearest object.
+   * @return The nearest object to the target point.
+   */
+  ObjectPtr GetNearestObject(const Vec2d &point) const {
+    if (nodes_.empty()) {
+      return nullptr;
+    }
+    ObjectPtr nearest_object = nullptr;
+    double min_distance_sqr = std::numeric_limits<double>::infinity();
+    GetNearestObjectInternal(0, point, &min_distance_sqr, &nearest_object);
+    return nearest_object;
+  }
+
+  /**
+   * @brief Get the nearest objects to many points. The result of a point is
+   *        the first bound of the search for the next one, so points along
+   *        a path are answered faster than one by one.
+   * @param points The target points.
+   * @param nearest_objects The nearest object to each point.
+   */
+  void GetNearestObjects(const std::vector<Vec2d> &points,
+                         std::vector<ObjectPtr> *const nearest_objects) const {
+    nearest_objects->assign(points.size(), nullptr);
+    if (nodes_.empty()) {
+      return;
+    }
+    ObjectPtr last_object = nullptr;
+    for (size_t i = 0; i < points.size(); ++i) {
+      ObjectPtr nearest_object = last_object;
+      double min_distance_sqr =
+          last_object == nullptr ? std::numeric_limits<double>::infinity()
+                                 : last_object->DistanceSquareTo(points[i]);
+      GetNearestObjectInternal(0, points[i], &min_distance_sqr,
+                               &nearest_object);
+      (*nearest_objects)[i] = nearest_object;
+      last_object = nearest_object;
+    }
+  }
+
+  /**
+   * @brief Get objects within a distance to a point.
+   * @param point The center point of the range to search objects.
+   * @param distance The radius of the range to search objects.
+   * @return All objects within the specified distance to the specified point.
+   */
+  std::vector<ObjectPtr> GetObjects(const Vec2d &point,
+                                    const double distance) const {
+    std::vector<ObjectPtr> result_objects;
+    if (!nodes_.empty()) {
+      GetObjectsInternal(0, point, Square(distance), &result_objects);
+    }
+    return result_objects;
+  }
+
+  /**
+   * @brief Get objects within a distance to each of many points. Every node
+   *        is visited once for all points whose range reaches it.
+   * @param points The center points of the ranges to search objects.
+   * @param distance The radius of the ranges to search objects.
+   * @param result_objects All objects within the distance to each point.
+   */
+  void GetObjects(const std::vector<Vec2d> &points, const double distance,
+                  std::vector<std::vector<ObjectPtr>> *const result_objects)
+      const {
+    result_objects->assign(points.size(), std::vector<ObjectPtr>());
+    if (nodes_.empty() || points.empty()) {
+      return;
+    }
+    std::vector<PointBatch> batches(max_depth_ + 1);
+    auto &root_batch = batches[0];
+    root_batch.x.reserve(points.size());
+    root_batch.y.reserve(points.size());
+    root_batch.index.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      root_batch.x.push_back(points[i].x());
+      root_batch.y.push_back(points[i].y());
+      root_batch.index.push_back(i);
+    }
+    GetObjectsBatchInternal(0, 0, Square(distance), &batches, result_objects);
+  }
+
+  /**
+   * @brief Get the axis-aligned bounding box of the objects.
+   * @return The axis-aligned bounding box of the objects.
+   */
+  AABox2d GetBoundingBox() const {
+    if (nodes_.empty()) {
+      return AABox2d();
+    }
+    const Node &root = nodes_[0];
+    return AABox2d({root.min_x, root.min_y}, {root.max_x, root.max_y});
+  }
+
+ private:
+  struct Node {
+    // Boundary of the objects in the subtree.
+    double min_x = 0.0;
+    double max_x = 0.0;
+    double min_y = 0.0;
+    double max_y = 0.0;
+    double mid_x = 0.0;
+    double mid_y = 0.0;
+    bool partition_x = true;
+    double partition_position = 0.0;
+    // objects_[object_begin, object_end) are the objects of this node which
+    // are not in a subnode, objects_[object_begin, subtree_end) are all the
+    // objects of the subtree.
+    int object_begin = 0;
+    int object_end = 0;
+    int subtree_end = 0;
+    // Indexes of the subnodes in nodes_, -1 if there is none.
+    int left = -1;
+    int right = -1;
+  };
+
+  // Points of a batch query which still have to visit a node.
+  struct PointBatch {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<size_t> index;
+    std::vector<double> distance_sqr;
+  };
+
+  // Number of object boxes filtered at once.
+  static constexpr int kBlockSize = 16;
+
+  int BuildNode(const std::vector<ObjectPtr> &objects,
+                const AABoxKDTreeParams &params, int depth) {
+    ACHECK(!objects.empty());
+    max_depth_ = std::max(max_depth_, depth);
+    const int node_index = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();
+    Node node;
+    node.min_x = std::numeric_limits<double>::infinity();
+    node.min_y = std::numeric_limits<double>::infinity();
+    node.max_x = -std::numeric_limits<double>::infinity();
+    node.max_y = -std::numeric_limits<double>::infinity();
+    for (ObjectPtr object : objects) {
+      node.min_x = std::fmin(node.min_x, object->aabox().min_x());
+      node.max_x = std::fmax(node.max_x, object->aabox().max_x());
+      node.min_y = std::fmin(node.min_y, object->aabox().min_y());
+      node.max_y = std::fmax(node.max_y, object->aabox().max_y());
+    }
+    ACHECK(!std::isinf(node.max_x) && !std::isinf(node.max_y) &&
+           !std::isinf(node.min_x) && !std::isinf(node.min_y))
+        << "the provided object box size is infinity";
+    node.mid_x = (node.min_x + node.max_x) / 2.0;
+    node.mid_y = (node.min_y + node.max_y) / 2.0;
+    node.partition_x = node.max_x - node.min_x >= node.max_y - node.min_y;
+    node.partition_position = node.partition_x ? node.mid_x : node.mid_y;
+
+    node.object_begin = static_cast<int>(objects_.size());
+    if (!SplitToSubNodes(node, objects, params, depth)) {
+      objects_.insert(objects_.end(), objects.begin(), objects.end());
+      node.object_end = static_cast<int>(objects_.size());
+      node.subtree_end = node.object_end;
+      nodes_[node_index] = node;
+      return node_index;
+    }
+    std::vector<ObjectPtr> left_subnode_objects;
+    std::vector<ObjectPtr> right_subnode_objects;
+    for (ObjectPtr object : objects) {
+      const double min =
+          node.partition_x ? object->aabox().min_x() : object->aabox().min_y();
+      const double max =
+          node.partition_x ? object->aabox().max_x() : object->aabox().max_y();
+      if (max <= node.partition_position) {
+        left_subnode_objects.push_back(object);
+      } else if (min >= node.partition_position) {
+        right_subnode_objects.push_back(object);
+      } else {
+        objects_.push_back(object);
+      }
+    }
+    node.object_end = static_cast<int>(objects_.size());
+    if (!left_subnode_objects.empty()) {
+      node.left = BuildNode(left_subnode_objects, params, depth + 1);
+    }
+    if (!right_subnode_objects.empty()) {
+      node.right = BuildNode(right_subnode_objects, params, depth + 1);
+    }
+    node.subtree_end = static_cast<int>(objects_.size());
+    nodes_[node_index] = node;
+    return node_index;
+  }
+
+  // Sorts the objects of every node by their lower bound along the partition
+  // of the node, and a copy of them by their upper bound, so a nearest
+  // search scanning them from the side of the point stops early.
+  void SortObjects() {
+    objects_by_max_ = objects_;
+    min_bound_.resize(objects_.size());
+    max_bound_.resize(objects_.size());
+    for (const Node &node : nodes_) {
+      const auto begin = node.object_begin;
+      const auto end = node.object_end;
+      const bool partition_x = node.partition_x;
+      std::sort(objects_.begin() + begin, objects_.begin() + end,
+                [partition_x](ObjectPtr obj1, ObjectPtr obj2) {
+                  return partition_x
+                             ? obj1->aabox().min_x() < obj2->aabox().min_x()
+                             : obj1->aabox().min_y() < obj2->aabox().min_y();
+                });
+      std::sort(objects_by_max_.begin() + begin, objects_by_max_.begin() + end,
+                [partition_x](ObjectPtr obj1, ObjectPtr obj2) {
+                  return partition_x
+                             ? obj1->aabox().max_x() > obj2->aabox().max_x()
+                             : obj1->aabox().max_y() > obj2->aabox().max_y();
+                });
+      for (int i = begin; i < end; ++i) {
+        min_bound_[i] = partition_x ? objects_[i]->aabox().min_x()
+                                    : objects_[i]->aabox().min_y();
+        max_bound_[i] = partition_x ? objects_by_max_[i]->aabox().max_x()
+                                    : objects_by_max_[i]->aabox().max_y();
+      }
+    }
+    object_min_x_.reserve(objects_.size());
+    object_min_y_.reserve(objects_.size());
+    object_max_x_.reserve(objects_.size());
+    object_max_y_.reserve(objects_.size());
+    for (ObjectPtr object : objects_) {
+      object_min_x_.push_back(object->aabox().min_x());
+      object_min_y_.push_back(object->aabox().min_y());
+      object_max_x_.push_back(object->aabox().max_x());
+      object_max_y_.push_back(object->aabox().max_y());
+    }
+  }
+
+  static bool SplitToSubNodes(const Node &node,
+                              const std::vector<ObjectPtr> &objects,
+                              const AABoxKDTreeParams &params, int depth) {
+    if (params.max_depth >= 0 && depth >= params.max_depth) {
+      return false;
+    }
+    if (static_cast<int>(objects.size()) <= std::max(1, params.max_leaf_size)) {
+      return false;
+    }
+    if (params.max_leaf_dimension >= 0.0 &&
+        std::max(node.max_x - node.min_x, node.max_y - node.min_y) <=
+            params.max_leaf_dimension) {
+      return false;
+    }
+    return true;
+  }
+
+  static double LowerDistanceSquareToPoint(const Node &node,
+                                           const Vec2d &point) {
+    double dx = 0.0;
+    if (point.x() < node.min_x) {
+      dx = node.min_x - point.x();
+    } else if (point.x() > node.max_x) {
+      dx = point.x() - node.max_x;
+    }
+    double dy = 0.0;
+    if (point.y() < node.min_y) {
+      dy = node.min_y - point.y();
+    } else if (point.y() > node.max_y) {
+      dy = point.y() - node.max_y;
+    }
+    return dx * dx + dy * dy;
+  }
+
+  static double UpperDistanceSquareToPoint(const Node &node,
+                                           const Vec2d &point) {
+    const double dx = (point.x() > node.mid_x ? (point.x() - node.min_x)
+                                              : (point.x() - node.max_x));
+    const double dy = (point.y() > node.mid_y ? (point.y() - node.min_y)
+                                              : (point.y() - node.max_y));
+    return dx * dx + dy * dy;
+  }
+
+  // Calls check(index) on the objects in [begin, end) whose boxes are within
+  // distance_sqr of point.
+  template <class Check>
+  void FilterObjects(int begin, int end, const Vec2d &point,
+                     const double distance_sqr, Check check) const {
+    double box_distance_sqr[kBlockSize];
+    for (int i = begin; i < end; i += kBlockSize) {
+      const int num = std::min(kBlockSize, end - i);
+      BoxDistanceSquareToPoint(&object_min_x_[i], &object_min_y_[i],
+                               &object_max_x_[i], &object_max_y_[i], num,
+                               point, box_distance_sqr);
+      for (int j = 0; j < num; ++j) {
+        if (box_distance_sqr[j] <= distance_sqr) {
+          check(i + j);
+        }
+      }
+    }
+  }
+
+  void GetNearestObjectInternal(int node_index, const Vec2d &point,
+                                double *const min_distance_sqr,
+                                ObjectPtr *const nearest_object) const {
+    const Node &node = nodes_[node_index];
+    if (LowerDistanceSquareToPoint(node, point) >=
+        *min_distance_sqr - kMathEpsilon) {
+      return;
+    }
+    const double pvalue = node.partition_x ? point.x() : point.y();
+    const bool search_left_first = pvalue < node.partition_position;
+    const int first = search_left_first ? node.left : node.right;
+    const int second = search_left_first ? node.right : node.left;
+    if (first >= 0) {
+      GetNearestObjectInternal(first, point, min_distance_sqr,
+                               nearest_object);
+    }
+    if (*min_distance_sqr <= kMathEpsilon) {
+      return;
+    }
+    if (search_left_first) {
+      for (int i = node.object_begin; i < node.object_end; ++i) {
+        const double bound = min_bound_[i];
+        if (bound > pvalue && Square(bound - pvalue) > *min_distance_sqr) {
+          break;
+        }
+        ObjectPtr object = objects_[i];
+        const double distance_sqr = object->DistanceSquareTo(point);
+        if (distance_sqr < *min_distance_sqr) {
+          *min_distance_sqr = distance_sqr;
+          *nearest_object = object;
+        }
+      }
+    } else {
+      for (int i = node.object_begin; i < node.object_end; ++i) {
+        const double bound = max_bound_[i];
+        if (bound < pvalue && Square(bound - pvalue) > *min_distance_sqr) {
+          break;
+        }
+        ObjectPtr object = objects_by_max_[i];
+        const double distance_sqr = object->DistanceSquareTo(point);
+        if (distance_sqr < *min_distance_sqr) {
+          *min_distance_sqr = distance_sqr;
+          *nearest_object = object;
+        }
+      }
+    }
+    if (*min_distance_sqr <= kMathEpsilon) {
+      return;
+    }
+    if (second >= 0) {
+      GetNearestObjectInternal(second, point, min_distance_sqr,
+                               nearest_object);
+    }
+  }
+
+  void GetObjectsInternal(int node_index, const Vec2d &point,
+                          const double distance_sqr,
+                          std::vector<ObjectPtr> *const result_objects) const {
+    const Node &node = nodes_[node_index];
+    if (LowerDistanceSquareToPoint(node, point) > distance_sqr) {
+      return;
+    }
+    if (UpperDistanceSquareToPoint(node, point) <= distance_sqr) {
+      result_objects->insert(result_objects->end(),
+                             objects_.begin() + node.object_begin,
+                             objects_.begin() + node.subtree_end);
+      return;
+    }
+    FilterObjects(node.object_begin, node.object_end, point, distance_sqr,
+                  [this, &point, distance_sqr, result_objects](int index) {
+                    ObjectPtr object = objects_[index];
+                    if (object->DistanceSquareTo(point) <= distance_sqr) {
+                      result_objects->push_back(object);
+                    }
+                  });
+    if (node.left >= 0) {
+      GetObjectsInternal(node.left, point, distance_sqr, result_objects);
+    }
+    if (node.right >= 0) {
+      GetObjectsInternal(node.right, point, distance_sqr, result_objects);
+    }
+  }
+
+  // (*batches)[depth] holds the points which reach the node, the subnodes
+  // are given the points left after this node in (*batches)[depth + 1].
+  void GetObjectsBatchInternal(
+      int node_index, int depth, const double distance_sqr,
+      std::vector<PointBatch> *const batches,
+      std::vector<std::vector<ObjectPtr>> *const result_objects) const {
+    const Node &node = nodes_[node_index];
+    auto &batch = (*batches)[depth];
+    const size_t num_points = batch.index.size();
+    batch.distance_sqr.resize(num_points);
+    PointDistanceSquareToBox(
+        batch.x.data(), batch.y.data(), num_points,
+        AABox2d({node.min_x, node.min_y}, {node.max_x, node.max_y}),
+        batch.distance_sqr.data());
+    // keeps the points which reach the node but not all of its objects
+    size_t num_left = 0;
+    for (size_t i = 0; i < num_points; ++i) {
+      if (batch.distance_sqr[i] > distance_sqr) {
+        continue;
+      }
+      const Vec2d point(batch.x[i], batch.y[i]);
+      auto &objects = (*result_objects)[batch.index[i]];
+      if (UpperDistanceSquareToPoint(node, point) <= distance_sqr) {
+        objects.insert(objects.end(), objects_.begin() + node.object_begin,
+                       objects_.begin() + node.subtree_end);
+        continue;
+      }
+      FilterObjects(node.object_begin, node.object_end, point, distance_sqr,
+                    [this, &point, distance_sqr, &objects](int index) {
+                      ObjectPtr object = objects_[index];
+                      if (object->DistanceSquareTo(point) <= distance_sqr) {
+                        objects.push_back(object);
+                      }
+                    });
+      batch.x[num_left] = batch.x[i];
+      batch.y[num_left] = batch.y[i];
+      batch.index[num_left] = batch.index[i];
+      ++num_left;
+    }
+    if (num_left == 0) {
+      return;
+    }
+    for (const int subnode : {node.left, node.right}) {
+      if (subnode < 0) {
+        continue;
+      }
+      auto &sub_batch = (*batches)[depth + 1];
+      sub_batch.x.assign(batch.x.begin(), batch.x.begin() + num_left);
+      sub_batch.y.assign(batch.y.begin(), batch.y.begin() + num_left);
+      sub_batch.index.assign(batch.index.begin(),
+                             batch.index.begin() + num_left);
+      GetObjectsBatchInternal(subnode, depth + 1, distance_sqr, batches,
+                              result_objects);
+    }
+  }
+
+  std::vector<Node> nodes_;
+  int max_depth_ = 0;
+  std::vector<ObjectPtr> objects_;
+  // objects_ of each node sorted by upper bound, and the bounds along the
+  // partition of the node of both orders.
+  std::vector<ObjectPtr> objects_by_max_;
+  std::vector<double> min_bound_;
+  std::vector<double> max_bound_;
+  // Boxes of objects_, as structure of arrays for BoxDistanceSquareToPoint.
+  std::vector<double> object_min_x_;
+  std::vector<double> object_min_y_;
+  std::vector<double> object_max_x_;
+  std::vector<double> object_max_y_;
+};
+
+template <class ObjectType>
+constexpr int FlatAABoxKDTree2d<ObjectType>::kBlockSize;
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
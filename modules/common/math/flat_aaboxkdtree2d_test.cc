@@ -0,0 +1,161 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/flat_aaboxkdtree2d.h"
+
+#include <memory>
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/math/line_segment2d.h"
+#include "modules/common/math/math_utils.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+namespace {
+
+class Object {
+ public:
+  Object(const double x1, const double y1, const double x2, const double y2,
+         const int id)
+      : aabox_({x1, y1}, {x2, y2}),
+        line_segment_({x1, y1}, {x2, y2}),
+        id_(id) {}
+  const AABox2d &aabox() const { return aabox_; }
+  double DistanceTo(const Vec2d &point) const {
+    return line_segment_.DistanceTo(point);
+  }
+  double DistanceSquareTo(const Vec2d &point) const {
+    return line_segment_.DistanceSquareTo(point);
+  }
+  int id() const { return id_; }
+
+ private:
+  AABox2d aabox_;
+  LineSegment2d line_segment_;
+  int id_ = 0;
+};
+
+std::set<int> Ids(const std::vector<const Object *> &objects) {
+  std::set<int> ids;
+  for (const Object *object : objects) {
+    ids.insert(object->id());
+  }
+  return ids;
+}
+
+}  // namespace
+
+TEST(FlatAABoxKDTree2d, BoxDistance) {
+  const double min_x[5] = {0.0, 0.0, 2.0, -3.0, 0.0};
+  const double min_y[5] = {0.0, 2.0, 0.0, -4.0, 0.0};
+  const double max_x[5] = {1.0, 1.0, 3.0, -2.0, 1.0};
+  const double max_y[5] = {1.0, 3.0, 1.0, -3.0, 1.0};
+  double distance_sqr[5];
+  BoxDistanceSquareToPoint(min_x, min_y, max_x, max_y, 5, {0.5, 0.5},
+                           distance_sqr);
+  EXPECT_DOUBLE_EQ(0.0, distance_sqr[0]);
+  EXPECT_DOUBLE_EQ(2.25, distance_sqr[1]);
+  EXPECT_DOUBLE_EQ(2.25, distance_sqr[2]);
+  EXPECT_DOUBLE_EQ(2.5 * 2.5 + 3.5 * 3.5, distance_sqr[3]);
+  EXPECT_DOUBLE_EQ(0.0, distance_sqr[4]);
+
+  const double x[3] = {0.5, -1.0, 3.0};
+  const double y[3] = {0.5, 0.5, 5.0};
+  PointDistanceSquareToBox(x, y, 3, AABox2d({0.0, 0.0}, {1.0, 1.0}),
+                           distance_sqr);
+  EXPECT_DOUBLE_EQ(0.0, distance_sqr[0]);
+  EXPECT_DOUBLE_EQ(1.0, distance_sqr[1]);
+  EXPECT_DOUBLE_EQ(4.0 + 16.0, distance_sqr[2]);
+}
+
+TEST(FlatAABoxKDTree2d, SameAsAABoxKDTree2d) {
+  const int kNumBoxes[5] = {1, 10, 50, 100, 1000};
+  const int kNumQueries = 500;
+  const double kSize = 100;
+  const int kNumTrees = 4;
+  AABoxKDTreeParams kdtree_params[kNumTrees];
+  kdtree_params[1].max_depth = 2;
+  kdtree_params[2].max_leaf_dimension = kSize / 4.0;
+  kdtree_params[3].max_leaf_size = 20;
+
+  for (int num_boxes : kNumBoxes) {
+    std::vector<Object> objects;
+    for (int i = 0; i < num_boxes; ++i) {
+      const double cx = RandomDouble(-kSize, kSize);
+      const double cy = RandomDouble(-kSize, kSize);
+      const double dx = RandomDouble(-kSize / 10.0, kSize / 10.0);
+      const double dy = RandomDouble(-kSize / 10.0, kSize / 10.0);
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    std::vector<Vec2d> points;
+    for (int i = 0; i < kNumQueries; ++i) {
+      points.emplace_back(RandomDouble(-kSize * 1.5, kSize * 1.5),
+                          RandomDouble(-kSize * 1.5, kSize * 1.5));
+    }
+    const double distance = RandomDouble(0, kSize / 2.0);
+    for (int k = 0; k < kNumTrees; ++k) {
+      AABoxKDTree2d<Object> kdtree(objects, kdtree_params[k]);
+      FlatAABoxKDTree2d<Object> flat_kdtree(objects, kdtree_params[k]);
+      EXPECT_DOUBLE_EQ(kdtree.GetBoundingBox().min_x(),
+                       flat_kdtree.GetBoundingBox().min_x());
+      EXPECT_DOUBLE_EQ(kdtree.GetBoundingBox().max_y(),
+                       flat_kdtree.GetBoundingBox().max_y());
+
+      std::vector<const Object *> nearest_objects;
+      flat_kdtree.GetNearestObjects(points, &nearest_objects);
+      std::vector<std::vector<const Object *>> batch_objects;
+      flat_kdtree.GetObjects(points, distance, &batch_objects);
+      ASSERT_EQ(points.size(), nearest_objects.size());
+      ASSERT_EQ(points.size(), batch_objects.size());
+      for (size_t i = 0; i < points.size(); ++i) {
+        const Vec2d &point = points[i];
+        const double expected_distance =
+            kdtree.GetNearestObject(point)->DistanceTo(point);
+        EXPECT_NEAR(expected_distance,
+                    flat_kdtree.GetNearestObject(point)->DistanceTo(point),
+                    1e-3);
+        EXPECT_NEAR(expected_distance, nearest_objects[i]->DistanceTo(point),
+                    1e-3);
+
+        const auto expected_ids = Ids(kdtree.GetObjects(point, distance));
+        const auto objects_in_range = flat_kdtree.GetObjects(point, distance);
+        EXPECT_EQ(expected_ids.size(), objects_in_range.size());
+        EXPECT_EQ(expected_ids, Ids(objects_in_range));
+        EXPECT_EQ(expected_ids.size(), batch_objects[i].size());
+        EXPECT_EQ(expected_ids, Ids(batch_objects[i]));
+      }
+    }
+  }
+}
+
+TEST(FlatAABoxKDTree2d, Empty) {
+  std::vector<Object> objects;
+  FlatAABoxKDTree2d<Object> kdtree(objects, AABoxKDTreeParams());
+  EXPECT_EQ(nullptr, kdtree.GetNearestObject({0.0, 0.0}));
+  EXPECT_TRUE(kdtree.GetObjects({0.0, 0.0}, 10.0).empty());
+  std::vector<const Object *> nearest_objects;
+  kdtree.GetNearestObjects({{0.0, 0.0}, {1.0, 1.0}}, &nearest_objects);
+  EXPECT_EQ(2, nearest_objects.size());
+  EXPECT_EQ(nullptr, nearest_objects[0]);
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,674 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/map/hdmap/flat_map.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+#include "cyber/common/log.h"
+#include "modules/common/math/line_segment2d.h"
+#include "modules/map/hdmap/hdmap_common.h"
+
+namespace apollo {
+namespace hdmap {
+namespace {
+
+using apollo::common::math::AABox2d;
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+using google::protobuf::Message;
+using google::protobuf::RepeatedPtrField;
+
+// Layout of the file, every struct is a multiple of 8 bytes so the arrays
+// stay aligned in the mapping:
+//   FileHeader
+//   Section[kNumMapObjectTypes]
+//   per type: Entry[num_entries] Node[num_nodes] Element[num_elements]
+//   ids, serialized objects and the serialized map header
+constexpr char kMagic[8] = {'A', 'P', 'O', 'L', 'L', 'O', 'F', 'M'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kNoChild = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t kMaxLeafSize = 8;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_types;
+  uint64_t file_size;
+  uint64_t header_offset;
+  uint32_t header_size;
+  uint32_t has_header;
+};
+
+struct Section {
+  uint64_t entries_offset;
+  uint64_t nodes_offset;
+  uint64_t elements_offset;
+  uint32_t num_entries;
+  uint32_t num_nodes;
+  uint32_t num_elements;
+  uint32_t reserved;
+};
+
+// objects are sorted by id
+struct Entry {
+  uint64_t id_offset;
+  uint64_t data_offset;
+  uint32_t id_size;
+  uint32_t data_size;
+  // only set for lanes
+  int32_t road_index;
+  int32_t section_index;
+};
+
+// elements [begin, end) are in the subtree of the node, node 0 is the root
+struct Node {
+  double min_x;
+  double min_y;
+  double max_x;
+  double max_y;
+  uint32_t begin;
+  uint32_t end;
+  uint32_t left;
+  uint32_t right;
+};
+
+// a segment, or the bounding box of a polygon
+struct Element {
+  double min_x;
+  double min_y;
+  double max_x;
+  double max_y;
+  double start_x;
+  double start_y;
+  double end_x;
+  double end_y;
+  uint32_t object;
+  uint32_t element;
+};
+
+struct TypeData {
+  // sorted by id
+  std::vector<const Message*> objects;
+  std::vector<std::string> ids;
+  std::vector<Entry> entries;
+  std::vector<Node> nodes;
+  std::vector<Element> elements;
+};
+
+template <class Proto>
+bool SortObjects(const RepeatedPtrField<Proto>& objects, TypeData* data) {
+  std::vector<const Proto*> sorted;
+  for (const auto& object : objects) {
+    sorted.push_back(&object);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const Proto* lhs, const Proto* rhs) {
+              return lhs->id().id() < rhs->id().id();
+            });
+  for (const auto* object : sorted) {
+    if (!data->ids.empty() && data->ids.back() == object->id().id()) {
+      AERROR << "Duplicated map object id: " << object->id().id();
+      return false;
+    }
+    data->objects.push_back(object);
+    data->ids.push_back(object->id().id());
+  }
+  return true;
+}
+
+Element MakeElement(const AABox2d& box, uint32_t object, uint32_t element) {
+  Element result;
+  std::memset(&result, 0, sizeof(result));
+  result.min_x = box.min_x();
+  result.min_y = box.min_y();
+  result.max_x = box.max_x();
+  result.max_y = box.max_y();
+  result.object = object;
+  result.element = element;
+  return result;
+}
+
+template <class Info, class Proto>
+void AddSegments(TypeData* data) {
+  for (uint32_t i = 0; i < data->objects.size(); ++i) {
+    const Info info(*static_cast<const Proto*>(data->objects[i]));
+    for (uint32_t id = 0; id < info.segments().size(); ++id) {
+      const auto& segment = info.segments()[id];
+      Element element =
+          MakeElement(AABox2d(segment.start(), segment.end()), i, id);
+      element.start_x = segment.start().x();
+      element.start_y = segment.start().y();
+      element.end_x = segment.end().x();
+      element.end_y = segment.end().y();
+      data->elements.push_back(element);
+    }
+  }
+}
+
+template <class Info, class Proto>
+void AddPolygons(TypeData* data) {
+  for (uint32_t i = 0; i < data->objects.size(); ++i) {
+    const Info info(*static_cast<const Proto*>(data->objects[i]));
+    data->elements.push_back(
+        MakeElement(info.polygon().AABoundingBox(), i, 0));
+  }
+}
+
+uint32_t BuildTree(uint32_t begin, uint32_t end, TypeData* data) {
+  Node node;
+  node.min_x = std::numeric_limits<double>::max();
+  node.min_y = std::numeric_limits<double>::max();
+  node.max_x = std::numeric_limits<double>::lowest();
+  node.max_y = std::numeric_limits<double>::lowest();
+  for (uint32_t i = begin; i < end; ++i) {
+    const auto& element = data->elements[i];
+    node.min_x = std::min(node.min_x, element.min_x);
+    node.min_y = std::min(node.min_y, element.min_y);
+    node.max_x = std::max(node.max_x, element.max_x);
+    node.max_y = std::max(node.max_y, element.max_y);
+  }
+  node.begin = begin;
+  node.end = end;
+  node.left = kNoChild;
+  node.right = kNoChild;
+  const uint32_t index = static_cast<uint32_t>(data->nodes.size());
+  data->nodes.push_back(node);
+  if (end - begin <= kMaxLeafSize) {
+    return index;
+  }
+
+  // split at the median center along the longer side
+  const bool split_x = node.max_x - node.min_x >= node.max_y - node.min_y;
+  const uint32_t middle = begin + (end - begin) / 2;
+  auto elements = data->elements.begin();
+  std::nth_element(elements + begin, elements + middle, elements + end,
+                   [split_x](const Element& lhs, const Element& rhs) {
+                     return split_x ? lhs.min_x + lhs.max_x <
+                                          rhs.min_x + rhs.max_x
+                                    : lhs.min_y + lhs.max_y <
+                                          rhs.min_y + rhs.max_y;
+                   });
+  const uint32_t left = BuildTree(begin, middle, data);
+  const uint32_t right = BuildTree(middle, end, data);
+  data->nodes[index].left = left;
+  data->nodes[index].right = right;
+  return index;
+}
+
+template <class T>
+void AppendArray(const std::vector<T>& values, std::string* out) {
+  out->append(reinterpret_cast<const char*>(values.data()),
+              values.size() * sizeof(T));
+}
+
+template <class T>
+bool InFile(uint64_t offset, uint64_t num, size_t file_size) {
+  return offset <= file_size && num <= (file_size - offset) / sizeof(T);
+}
+
+template <class Box>
+double DistanceSquareTo(const Box& box, const Vec2d& point) {
+  const double dx =
+      std::max({box.min_x - point.x(), 0.0, point.x() - box.max_x});
+  const double dy =
+      std::max({box.min_y - point.y(), 0.0, point.y() - box.max_y});
+  return dx * dx + dy * dy;
+}
+
+template <class Box>
+bool Overlaps(const Box& box, const AABox2d& other) {
+  return box.min_x <= other.max_x() && box.max_x >= other.min_x() &&
+         box.min_y <= other.max_y() && box.max_y >= other.min_y();
+}
+
+double SegmentDistanceSquareTo(const Element& element, const Vec2d& point) {
+  return LineSegment2d({element.start_x, element.start_y},
+                       {element.end_x, element.end_y})
+      .DistanceSquareTo(point);
+}
+
+const FileHeader& GetFileHeader(const char* data) {
+  return *reinterpret_cast<const FileHeader*>(data);
+}
+
+const Section& GetSection(const char* data, MapObjectType type) {
+  return reinterpret_cast<const Section*>(
+      data + sizeof(FileHeader))[static_cast<size_t>(type)];
+}
+
+template <class T>
+const T* GetArray(const char* data, uint64_t offset) {
+  return reinterpret_cast<const T*>(data + offset);
+}
+
+}  // namespace
+
+FlatMap::~FlatMap() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+bool FlatMap::IsSegmentType(MapObjectType type) {
+  return type == MapObjectType::LANE || type == MapObjectType::SIGNAL ||
+         type == MapObjectType::STOP_SIGN ||
+         type == MapObjectType::YIELD_SIGN ||
+         type == MapObjectType::SPEED_BUMP;
+}
+
+bool FlatMap::IsPolygonType(MapObjectType type) {
+  return type == MapObjectType::JUNCTION ||
+         type == MapObjectType::CROSSWALK ||
+         type == MapObjectType::CLEAR_AREA ||
+         type == MapObjectType::PARKING_SPACE ||
+         type == MapObjectType::PNC_JUNCTION;
+}
+
+bool FlatMap::Write(const Map& map, const std::string& file_name) {
+  std::vector<TypeData> types(kNumMapObjectTypes);
+  auto type_data = [&types](MapObjectType type) {
+    return &types[static_cast<size_t>(type)];
+  };
+  if (!SortObjects(map.lane(), type_data(MapObjectType::LANE)) ||
+      !SortObjects(map.junction(), type_data(MapObjectType::JUNCTION)) ||
+      !SortObjects(map.signal(), type_data(MapObjectType::SIGNAL)) ||
+      !SortObjects(map.crosswalk(), type_data(MapObjectType::CROSSWALK)) ||
+      !SortObjects(map.stop_sign(), type_data(MapObjectType::STOP_SIGN)) ||
+      !SortObjects(map.yield(), type_data(MapObjectType::YIELD_SIGN)) ||
+      !SortObjects(map.clear_area(), type_data(MapObjectType::CLEAR_AREA)) ||
+      !SortObjects(map.speed_bump(), type_data(MapObjectType::SPEED_BUMP)) ||
+      !SortObjects(map.overlap(), type_data(MapObjectType::OVERLAP)) ||
+      !SortObjects(map.road(), type_data(MapObjectType::ROAD)) ||
+      !SortObjects(map.parking_space(),
+                   type_data(MapObjectType::PARKING_SPACE)) ||
+      !SortObjects(map.pnc_junction(),
+                   type_data(MapObjectType::PNC_JUNCTION)) ||
+      !SortObjects(map.rsu(), type_data(MapObjectType::RSU))) {
+    return false;
+  }
+
+  AddSegments<LaneInfo, Lane>(type_data(MapObjectType::LANE));
+  AddSegments<SignalInfo, Signal>(type_data(MapObjectType::SIGNAL));
+  AddSegments<StopSignInfo, StopSign>(type_data(MapObjectType::STOP_SIGN));
+  AddSegments<YieldSignInfo, YieldSign>(type_data(MapObjectType::YIELD_SIGN));
+  AddSegments<SpeedBumpInfo, SpeedBump>(type_data(MapObjectType::SPEED_BUMP));
+  AddPolygons<JunctionInfo, Junction>(type_data(MapObjectType::JUNCTION));
+  AddPolygons<CrosswalkInfo, Crosswalk>(type_data(MapObjectType::CROSSWALK));
+  AddPolygons<ClearAreaInfo, ClearArea>(type_data(MapObjectType::CLEAR_AREA));
+  AddPolygons<ParkingSpaceInfo, ParkingSpace>(
+      type_data(MapObjectType::PARKING_SPACE));
+  AddPolygons<PNCJunctionInfo, PNCJunction>(
+      type_data(MapObjectType::PNC_JUNCTION));
+
+  std::string blob;
+  for (auto& data : types) {
+    for (size_t i = 0; i < data.objects.size(); ++i) {
+      Entry entry;
+      std::memset(&entry, 0, sizeof(entry));
+      const auto& id = data.ids[i];
+      entry.id_offset = blob.size();
+      entry.id_size = static_cast<uint32_t>(id.size());
+      blob.append(id);
+      entry.data_offset = blob.size();
+      data.objects[i]->AppendToString(&blob);
+      entry.data_size = static_cast<uint32_t>(blob.size() - entry.data_offset);
+      entry.road_index = -1;
+      entry.section_index = -1;
+      data.entries.push_back(entry);
+    }
+    if (!data.elements.empty()) {
+      BuildTree(0, static_cast<uint32_t>(data.elements.size()), &data);
+    }
+  }
+
+  auto* lanes = type_data(MapObjectType::LANE);
+  const auto& roads = type_data(MapObjectType::ROAD)->objects;
+  for (size_t i = 0; i < roads.size(); ++i) {
+    const auto& road = *static_cast<const Road*>(roads[i]);
+    for (int j = 0; j < road.section_size(); ++j) {
+      for (const auto& lane_id : road.section(j).lane_id()) {
+        auto it = std::lower_bound(lanes->ids.begin(), lanes->ids.end(),
+                                   lane_id.id());
+        if (it == lanes->ids.end() || *it != lane_id.id()) {
+          AERROR << "Unknown lane id: " << lane_id.id();
+          return false;
+        }
+        auto& entry = lanes->entries[it - lanes->ids.begin()];
+        entry.road_index = static_cast<int32_t>(i);
+        entry.section_index = j;
+      }
+    }
+  }
+
+  FileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_types = static_cast<uint32_t>(kNumMapObjectTypes);
+  header.has_header = map.has_header() ? 1 : 0;
+  header.header_offset = blob.size();
+  map.header().AppendToString(&blob);
+  header.header_size =
+      static_cast<uint32_t>(blob.size() - header.header_offset);
+
+  std::vector<Section> sections(kNumMapObjectTypes);
+  uint64_t offset =
+      sizeof(FileHeader) + sizeof(Section) * kNumMapObjectTypes;
+  for (size_t i = 0; i < kNumMapObjectTypes; ++i) {
+    auto& section = sections[i];
+    std::memset(&section, 0, sizeof(section));
+    section.num_entries = static_cast<uint32_t>(types[i].entries.size());
+    section.num_nodes = static_cast<uint32_t>(types[i].nodes.size());
+    section.num_elements = static_cast<uint32_t>(types[i].elements.size());
+    section.entries_offset = offset;
+    offset += sizeof(Entry) * section.num_entries;
+    section.nodes_offset = offset;
+    offset += sizeof(Node) * section.num_nodes;
+    section.elements_offset = offset;
+    offset += sizeof(Element) * section.num_elements;
+  }
+  const uint64_t blob_offset = offset;
+  header.header_offset += blob_offset;
+  header.file_size = blob_offset + blob.size();
+  for (auto& data : types) {
+    for (auto& entry : data.entries) {
+      entry.id_offset += blob_offset;
+      entry.data_offset += blob_offset;
+    }
+  }
+
+  std::string buffer;
+  buffer.reserve(header.file_size);
+  buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  AppendArray(sections, &buffer);
+  for (const auto& data : types) {
+    AppendArray(data.entries, &buffer);
+    AppendArray(data.nodes, &buffer);
+    AppendArray(data.elements, &buffer);
+  }
+  buffer.append(blob);
+
+  std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+  if (!file.write(buffer.data(), buffer.size()) || !file.flush()) {
+    AERROR << "Failed to write flat map " << file_name;
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<FlatMap> FlatMap::Open(const std::string& file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    AERROR << "Failed to open flat map " << file_name;
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) <
+          sizeof(FileHeader) + sizeof(Section) * kNumMapObjectTypes) {
+    AERROR << "Invalid flat map " << file_name;
+    close(fd);
+    return nullptr;
+  }
+  const size_t size = file_stat.st_size;
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    AERROR << "Failed to mmap flat map " << file_name;
+    return nullptr;
+  }
+  std::unique_ptr<FlatMap> flat_map(new FlatMap());
+  flat_map->data_ = static_cast<const char*>(addr);
+  flat_map->size_ = size;
+
+  // everything read through offsets is checked once here
+  const char* data = flat_map->data_;
+  const auto& header = GetFileHeader(data);
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion || header.num_types != kNumMapObjectTypes ||
+      header.file_size != size ||
+      !InFile<char>(header.header_offset, header.header_size, size)) {
+    AERROR << "Invalid flat map header in " << file_name;
+    return nullptr;
+  }
+  const uint32_t num_roads =
+      GetSection(data, MapObjectType::ROAD).num_entries;
+  for (size_t i = 0; i < kNumMapObjectTypes; ++i) {
+    const auto type = static_cast<MapObjectType>(i);
+    const auto& section = GetSection(data, type);
+    if (!InFile<Entry>(section.entries_offset, section.num_entries, size) ||
+        !InFile<Node>(section.nodes_offset, section.num_nodes, size) ||
+        !InFile<Element>(section.elements_offset, section.num_elements,
+                         size)) {
+      AERROR << "Invalid flat map section in " << file_name;
+      return nullptr;
+    }
+    const auto* entries = GetArray<Entry>(data, section.entries_offset);
+    for (uint32_t j = 0; j < section.num_entries; ++j) {
+      if (!InFile<char>(entries[j].id_offset, entries[j].id_size, size) ||
+          !InFile<char>(entries[j].data_offset, entries[j].data_size, size)) {
+        AERROR << "Invalid flat map entry in " << file_name;
+        return nullptr;
+      }
+      // a lane is in no road or in a section of a known one, the section is
+      // checked against the road when the lane is built
+      const int32_t road_index = entries[j].road_index;
+      const int32_t section_index = entries[j].section_index;
+      const bool in_road =
+          type == MapObjectType::LANE && road_index >= 0 &&
+          static_cast<uint32_t>(road_index) < num_roads && section_index >= 0;
+      if (!in_road && (road_index != -1 || section_index != -1)) {
+        AERROR << "Invalid flat map road index in " << file_name;
+        return nullptr;
+      }
+    }
+    // children are written after their parent, which also rules out cycles
+    const auto* nodes = GetArray<Node>(data, section.nodes_offset);
+    for (uint32_t j = 0; j < section.num_nodes; ++j) {
+      const auto& node = nodes[j];
+      const bool is_leaf = node.left == kNoChild && node.right == kNoChild;
+      if (node.begin > node.end || node.end > section.num_elements ||
+          (!is_leaf && (node.left <= j || node.left >= section.num_nodes ||
+                        node.right <= j || node.right >= section.num_nodes))) {
+        AERROR << "Invalid flat map index in " << file_name;
+        return nullptr;
+      }
+    }
+    const auto* elements = GetArray<Element>(data, section.elements_offset);
+    for (uint32_t j = 0; j < section.num_elements; ++j) {
+      if (elements[j].object >= section.num_entries ||
+          (!IsSegmentType(type) && elements[j].element != 0)) {
+        AERROR << "Invalid flat map index in " << file_name;
+        return nullptr;
+      }
+    }
+  }
+  return flat_map;
+}
+
+bool FlatMap::GetHeader(Header* header) const {
+  const auto& file_header = GetFileHeader(data_);
+  if (!file_header.has_header) {
+    return false;
+  }
+  return header->ParseFromArray(data_ + file_header.header_offset,
+                                file_header.header_size);
+}
+
+size_t FlatMap::Size(MapObjectType type) const {
+  return GetSection(data_, type).num_entries;
+}
+
+int FlatMap::Find(MapObjectType type, const std::string& id) const {
+  const auto& section = GetSection(data_, type);
+  const auto* begin = GetArray<Entry>(data_, section.entries_offset);
+  const auto* end = begin + section.num_entries;
+  const char* data = data_;
+  auto compare = [data](const Entry& entry, const std::string& id) {
+    return id.compare(0, std::string::npos, data + entry.id_offset,
+                      entry.id_size) > 0;
+  };
+  const auto* it = std::lower_bound(begin, end, id, compare);
+  if (it == end ||
+      id.compare(0, std::string::npos, data + it->id_offset, it->id_size) !=
+          0) {
+    return -1;
+  }
+  return static_cast<int>(it - begin);
+}
+
+bool FlatMap::Parse(MapObjectType type, size_t index,
+                    google::protobuf::MessageLite* proto) const {
+  const auto& section = GetSection(data_, type);
+  if (index >= section.num_entries) {
+    return false;
+  }
+  const auto& entry =
+      GetArray<Entry>(data_, section.entries_offset)[index];
+  return proto->ParseFromArray(data_ + entry.data_offset, entry.data_size);
+}
+
+void FlatMap::GetLaneRoad(size_t lane_index, int* road_index,
+                          int* section_index) const {
+  const auto& section = GetSection(data_, MapObjectType::LANE);
+  *road_index = -1;
+  *section_index = -1;
+  if (lane_index < section.num_entries) {
+    const auto& entry =
+        GetArray<Entry>(data_, section.entries_offset)[lane_index];
+    *road_index = entry.road_index;
+    *section_index = entry.section_index;
+  }
+}
+
+void FlatMap::Search(MapObjectType type, const Vec2d& point,
+                     double distance, std::vector<Hit>* hits) const {
+  hits->clear();
+  const auto& section = GetSection(data_, type);
+  if (section.num_nodes == 0) {
+    return;
+  }
+  const auto* nodes = GetArray<Node>(data_, section.nodes_offset);
+  const auto* elements = GetArray<Element>(data_, section.elements_offset);
+  const bool is_segment = IsSegmentType(type);
+  const double distance_sqr = distance * distance;
+  std::vector<uint32_t> stack = {0};
+  while (!stack.empty()) {
+    const auto& node = nodes[stack.back()];
+    stack.pop_back();
+    if (DistanceSquareTo(node, point) > distance_sqr) {
+      continue;
+    }
+    if (node.left != kNoChild) {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+      continue;
+    }
+    for (uint32_t i = node.begin; i < node.end; ++i) {
+      const auto& element = elements[i];
+      const double element_distance_sqr =
+          is_segment ? SegmentDistanceSquareTo(element, point)
+                     : DistanceSquareTo(element, point);
+      if (element_distance_sqr <= distance_sqr) {
+        hits->push_back({element.object, element.element});
+      }
+    }
+  }
+}
+
+bool FlatMap::GetNearest(MapObjectType type, const Vec2d& point,
+                         Hit* hit) const {
+  const auto& section = GetSection(data_, type);
+  if (!IsSegmentType(type) || section.num_nodes == 0) {
+    return false;
+  }
+  const auto* nodes = GetArray<Node>(data_, section.nodes_offset);
+  const auto* elements = GetArray<Element>(data_, section.elements_offset);
+  using QueueItem = std::pair<double, uint32_t>;
+  std::priority_queue<QueueItem, std::vector<QueueItem>,
+                      std::greater<QueueItem>>
+      queue;
+  queue.emplace(DistanceSquareTo(nodes[0], point), 0);
+  double min_distance_sqr = std::numeric_limits<double>::max();
+  bool found = false;
+  while (!queue.empty() && queue.top().first < min_distance_sqr) {
+    const auto& node = nodes[queue.top().second];
+    queue.pop();
+    if (node.left != kNoChild) {
+      queue.emplace(DistanceSquareTo(nodes[node.left], point), node.left);
+      queue.emplace(DistanceSquareTo(nodes[node.right], point), node.right);
+      continue;
+    }
+    for (uint32_t i = node.begin; i < node.end; ++i) {
+      const auto& element = elements[i];
+      const double distance_sqr = SegmentDistanceSquareTo(element, point);
+      if (distance_sqr < min_distance_sqr) {
+        min_distance_sqr = distance_sqr;
+        hit->object = element.object;
+        hit->element = element.element;
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+void FlatMap::GetObjectsInBox(MapObjectType type, const AABox2d& box,
+                              std::vector<uint32_t>* objects) const {
+  objects->clear();
+  const auto& section = GetSection(data_, type);
+  if (section.num_nodes == 0) {
+    return;
+  }
+  const auto* nodes = GetArray<Node>(data_, section.nodes_offset);
+  const auto* elements = GetArray<Element>(data_, section.elements_offset);
+  std::vector<uint32_t> stack = {0};
+  while (!stack.empty()) {
+    const auto& node = nodes[stack.back()];
+    stack.pop_back();
+    if (!Overlaps(node, box)) {
+      continue;
+    }
+    if (node.left != kNoChild) {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+      continue;
+    }
+    for (uint32_t i = node.begin; i < node.end; ++i) {
+      if (Overlaps(elements[i], box)) {
+        objects->push_back(elements[i].object);
+      }
+    }
+  }
+  std::sort(objects->begin(), objects->end());
+  objects->erase(std::unique(objects->begin(), objects->end()),
+                 objects->end());
+}
+
+}  // namespace hdmap
+}  // namespace apollo
@@ -0,0 +1,151 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Defines the FlatMap class, a precompiled map file which is mapped
+ * read only into memory instead of being parsed.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "modules/common/math/aabox2d.h"
+#include "modules/common/math/vec2d.h"
+#include "modules/common_msgs/map_msgs/map.pb.h"
+
+namespace apollo {
+namespace hdmap {
+
+enum class MapObjectType : uint32_t {
+  LANE = 0,
+  JUNCTION,
+  SIGNAL,
+  CROSSWALK,
+  STOP_SIGN,
+  YIELD_SIGN,
+  CLEAR_AREA,
+  SPEED_BUMP,
+  OVERLAP,
+  ROAD,
+  PARKING_SPACE,
+  PNC_JUNCTION,
+  RSU,
+  NUM_TYPES,
+};
+
+constexpr size_t kNumMapObjectTypes =
+    static_cast<size_t>(MapObjectType::NUM_TYPES);
+
+/**
+ * @class FlatMap
+ * @brief A map compiled by Write is a table of the serialized objects of
+ * every type sorted by id, followed by a bounding volume tree over the
+ * segments or polygons of the types HDMapImpl searches by position.
+ * Open maps the file with mmap, so nothing is parsed at load time and
+ * processes using the same file share its pages. Objects are parsed one by
+ * one by the caller when they are first needed.
+ */
+class FlatMap {
+ public:
+  /**
+   * @brief a segment or polygon of an object found by a position query
+   */
+  struct Hit {
+    // index of the object in its type
+    uint32_t object;
+    // index of the segment in the object, 0 for polygons
+    uint32_t element;
+  };
+
+  ~FlatMap();
+
+  /**
+   * @brief compile a map into a flat map file
+   * @return false if the map is inconsistent or the file can not be written
+   */
+  static bool Write(const Map& map, const std::string& file_name);
+
+  /**
+   * @brief map a file written by Write into memory
+   * @return nullptr if the file is missing or malformed
+   */
+  static std::unique_ptr<FlatMap> Open(const std::string& file_name);
+
+  bool GetHeader(Header* header) const;
+
+  size_t Size(MapObjectType type) const;
+
+  /**
+   * @brief binary search an object by id
+   * @return index of the object, -1 if there is no such object
+   */
+  int Find(MapObjectType type, const std::string& id) const;
+
+  /**
+   * @brief parse the object at index into proto
+   */
+  bool Parse(MapObjectType type, size_t index,
+             google::protobuf::MessageLite* proto) const;
+
+  /**
+   * @brief indexes of the road and section a lane belongs to, -1 if the lane
+   * is not part of any road
+   */
+  void GetLaneRoad(size_t lane_index, int* road_index,
+                   int* section_index) const;
+
+  /**
+   * @brief find the segments within distance to point, or for polygon types
+   * the polygons whose bounding box is, polygons are not stored in the index
+   * so the caller has to check the exact distance.
+   */
+  void Search(MapObjectType type, const apollo::common::math::Vec2d& point,
+              double distance, std::vector<Hit>* hits) const;
+
+  /**
+   * @brief find the nearest segment of a segment type
+   * @return false if there are no segments
+   */
+  bool GetNearest(MapObjectType type, const apollo::common::math::Vec2d& point,
+                  Hit* hit) const;
+
+  /**
+   * @brief find the objects of a segment or polygon type with a segment or
+   * a polygon bounding box overlapping box
+   * @param objects sorted indexes of the objects, without duplicates
+   */
+  void GetObjectsInBox(MapObjectType type,
+                       const apollo::common::math::AABox2d& box,
+                       std::vector<uint32_t>* objects) const;
+
+  static bool IsSegmentType(MapObjectType type);
+  static bool IsPolygonType(MapObjectType type);
+
+ private:
+  FlatMap() = default;
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace hdmap
+}  // namespace apollo
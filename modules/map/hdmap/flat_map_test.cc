@@ -0,0 +1,250 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/map/hdmap/flat_map.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/file.h"
+#include "modules/map/hdmap/hdmap_impl.h"
+
+namespace apollo {
+namespace hdmap {
+namespace {
+
+constexpr char kMapFilename[] = "modules/map/hdmap/test-data/base_map.bin";
+
+// offsets in a flat map file, see the layout in flat_map.cc
+constexpr size_t kFileHeaderSize = 40;
+constexpr size_t kSectionSize = 40;
+constexpr size_t kSectionNodesOffset = 8;
+constexpr size_t kSectionNumEntriesOffset = 24;
+constexpr size_t kEntrySize = 32;
+constexpr size_t kEntryRoadIndexOffset = 24;
+constexpr size_t kNodeLeftOffset = 40;
+
+template <class T>
+std::set<std::string> Ids(const std::vector<T>& objects) {
+  std::set<std::string> ids;
+  for (const auto& object : objects) {
+    ids.insert(object->id().id());
+  }
+  return ids;
+}
+
+Id MakeId(const std::string& id) {
+  Id result;
+  result.set_id(id);
+  return result;
+}
+
+}  // namespace
+
+class FlatMapTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    std::string dir = ::testing::TempDir() + "flat_map_test.XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(&dir[0]));
+    temp_dir_ = dir;
+    flat_map_file_ = temp_dir_ + "/base_map.flat";
+    Map map;
+    ASSERT_TRUE(cyber::common::GetProtoFromFile(kMapFilename, &map));
+    ASSERT_TRUE(FlatMap::Write(map, flat_map_file_));
+  }
+
+  static void TearDownTestCase() {
+    cyber::common::RemoveAllFiles(temp_dir_);
+    rmdir(temp_dir_.c_str());
+  }
+
+  void SetUp() override {
+    ASSERT_EQ(0, map_.LoadMapFromFile(kMapFilename));
+    ASSERT_EQ(0, flat_map_.LoadMapFromFile(flat_map_file_));
+  }
+
+  // writes the flat map with the bytes at offset replaced by value
+  template <class T>
+  static std::string WriteCorrupted(const std::string& name, size_t offset,
+                                    const T& value) {
+    std::string content;
+    EXPECT_TRUE(cyber::common::GetContent(flat_map_file_, &content));
+    EXPECT_LE(offset + sizeof(value), content.size());
+    std::memcpy(&content[offset], &value, sizeof(value));
+    const std::string file_name = temp_dir_ + "/" + name;
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), content.size());
+    return file_name;
+  }
+
+  template <class T>
+  static T Read(size_t offset) {
+    std::string content;
+    EXPECT_TRUE(cyber::common::GetContent(flat_map_file_, &content));
+    T value;
+    std::memcpy(&value, content.data() + offset, sizeof(value));
+    return value;
+  }
+
+  static size_t SectionOffset(MapObjectType type) {
+    return kFileHeaderSize + kSectionSize * static_cast<size_t>(type);
+  }
+
+  static std::string temp_dir_;
+  static std::string flat_map_file_;
+
+  HDMapImpl map_;
+  HDMapImpl flat_map_;
+};
+
+std::string FlatMapTest::temp_dir_;
+std::string FlatMapTest::flat_map_file_;
+
+TEST_F(FlatMapTest, GetById) {
+  EXPECT_EQ(nullptr, flat_map_.GetLaneById(MakeId("1")));
+  EXPECT_EQ(nullptr, flat_map_.GetJunctionById(MakeId("1")));
+
+  const auto lane = map_.GetLaneById(MakeId("1272_1_-1"));
+  const auto flat_lane = flat_map_.GetLaneById(MakeId("1272_1_-1"));
+  ASSERT_NE(nullptr, flat_lane);
+  EXPECT_EQ(flat_lane, flat_map_.GetLaneById(MakeId("1272_1_-1")));
+  EXPECT_EQ(lane->road_id().id(), flat_lane->road_id().id());
+  EXPECT_EQ(lane->section_id().id(), flat_lane->section_id().id());
+  EXPECT_DOUBLE_EQ(lane->total_length(), flat_lane->total_length());
+  EXPECT_EQ(lane->overlaps().size(), flat_lane->overlaps().size());
+  EXPECT_EQ(lane->cross_lanes().size(), flat_lane->cross_lanes().size());
+  EXPECT_EQ(lane->signals().size(), flat_lane->signals().size());
+  EXPECT_EQ(lane->junctions().size(), flat_lane->junctions().size());
+
+  const auto signal = flat_map_.GetSignalById(MakeId("1278"));
+  ASSERT_NE(nullptr, signal);
+  EXPECT_EQ("1278", signal->id().id());
+  EXPECT_TRUE(flat_map_.HasObject(MapObjectType::JUNCTION, MakeId("1183")));
+  EXPECT_FALSE(flat_map_.HasObject(MapObjectType::LANE, MakeId("1183")));
+  EXPECT_TRUE(map_.HasObject(MapObjectType::JUNCTION, MakeId("1183")));
+
+  Header header;
+  Header flat_header;
+  EXPECT_EQ(map_.GetMapHeader(&header), flat_map_.GetMapHeader(&flat_header));
+  EXPECT_EQ(header.SerializeAsString(), flat_header.SerializeAsString());
+}
+
+TEST_F(FlatMapTest, SearchSameAsKDTree) {
+  for (double x = 586380.0; x <= 586480.0; x += 10.0) {
+    for (double y = 4140700.0; y <= 4140800.0; y += 10.0) {
+      common::PointENU point;
+      point.set_x(x);
+      point.set_y(y);
+
+      std::vector<LaneInfoConstPtr> lanes;
+      std::vector<LaneInfoConstPtr> flat_lanes;
+      EXPECT_EQ(0, map_.GetLanes(point, 10.0, &lanes));
+      EXPECT_EQ(0, flat_map_.GetLanes(point, 10.0, &flat_lanes));
+      EXPECT_EQ(Ids(lanes), Ids(flat_lanes));
+
+      std::vector<JunctionInfoConstPtr> junctions;
+      std::vector<JunctionInfoConstPtr> flat_junctions;
+      EXPECT_EQ(0, map_.GetJunctions(point, 10.0, &junctions));
+      EXPECT_EQ(0, flat_map_.GetJunctions(point, 10.0, &flat_junctions));
+      EXPECT_EQ(Ids(junctions), Ids(flat_junctions));
+
+      std::vector<CrosswalkInfoConstPtr> crosswalks;
+      std::vector<CrosswalkInfoConstPtr> flat_crosswalks;
+      EXPECT_EQ(0, map_.GetCrosswalks(point, 10.0, &crosswalks));
+      EXPECT_EQ(0, flat_map_.GetCrosswalks(point, 10.0, &flat_crosswalks));
+      EXPECT_EQ(Ids(crosswalks), Ids(flat_crosswalks));
+
+      std::vector<SignalInfoConstPtr> signals;
+      std::vector<SignalInfoConstPtr> flat_signals;
+      EXPECT_EQ(0, map_.GetSignals(point, 10.0, &signals));
+      EXPECT_EQ(0, flat_map_.GetSignals(point, 10.0, &flat_signals));
+      EXPECT_EQ(Ids(signals), Ids(flat_signals));
+
+      LaneInfoConstPtr lane;
+      LaneInfoConstPtr flat_lane;
+      double s = 0.0;
+      double l = 0.0;
+      double flat_s = 0.0;
+      double flat_l = 0.0;
+      EXPECT_EQ(0, map_.GetNearestLane(point, &lane, &s, &l));
+      EXPECT_EQ(0, flat_map_.GetNearestLane(point, &flat_lane, &flat_s,
+                                            &flat_l));
+      // lanes or segments sharing the nearest point may be picked in
+      // another order, which only changes l
+      const common::math::Vec2d xy(x, y);
+      EXPECT_NEAR(lane->DistanceTo(xy), flat_lane->DistanceTo(xy), 1e-6);
+      if (lane->id().id() == flat_lane->id().id()) {
+        EXPECT_NEAR(s, flat_s, 1e-6);
+      }
+    }
+  }
+}
+
+TEST_F(FlatMapTest, RejectInvalidFile) {
+  const std::string file_name = temp_dir_ + "/invalid.flat";
+  {
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+    file << "not a flat map";
+  }
+  EXPECT_EQ(nullptr, FlatMap::Open(file_name));
+  HDMapImpl map;
+  EXPECT_EQ(-1, map.LoadMapFromFile(file_name));
+  EXPECT_EQ(-1, map.LoadMapFromFile(temp_dir_ + "/missing.flat"));
+}
+
+TEST_F(FlatMapTest, RejectInvalidReference) {
+  ASSERT_NE(nullptr, FlatMap::Open(flat_map_file_));
+
+  // the first lane in a road that does not exist
+  const size_t lanes = SectionOffset(MapObjectType::LANE);
+  const size_t lane_road = Read<uint64_t>(lanes) + kEntryRoadIndexOffset;
+  const uint32_t num_roads = Read<uint32_t>(
+      SectionOffset(MapObjectType::ROAD) + kSectionNumEntriesOffset);
+  EXPECT_EQ(nullptr, FlatMap::Open(WriteCorrupted(
+                         "road.flat", lane_road,
+                         static_cast<int32_t>(num_roads))));
+  // or in a road without a section
+  const int32_t no_section[] = {0, -1};
+  EXPECT_EQ(nullptr, FlatMap::Open(WriteCorrupted("section.flat", lane_road,
+                                                  no_section)));
+  // a junction in a road
+  const size_t junction_road =
+      Read<uint64_t>(SectionOffset(MapObjectType::JUNCTION)) +
+      kEntryRoadIndexOffset;
+  EXPECT_EQ(nullptr, FlatMap::Open(WriteCorrupted(
+                         "junction.flat", junction_road, int32_t{0})));
+
+  // the root of the lane index is its own child
+  const size_t root = Read<uint64_t>(lanes + kSectionNodesOffset);
+  EXPECT_EQ(nullptr, FlatMap::Open(WriteCorrupted(
+                         "cycle.flat", root + kNodeLeftOffset, uint32_t{0})));
+  // or has a single child
+  EXPECT_EQ(nullptr,
+            FlatMap::Open(WriteCorrupted("child.flat", root + kNodeLeftOffset,
+                                         uint32_t{0xffffffff})));
+}
+
+}  // namespace hdmap
+}  // namespace apollo
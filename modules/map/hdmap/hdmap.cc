@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "modules/map/hdmap/hdmap.h"
 
+#include "modules/common/configs/config_gflags.h"
 #include "modules/map/hdmap/hdmap_util.h"
 
 namespace apollo {
@@ -22,12 +23,25 @@ namespace hdmap {
 
 int HDMap::LoadMapFromFile(const std::string& map_filename) {
   AINFO << "Loading HDMap: " << map_filename << " ...";
-  return impl_.LoadMapFromFile(map_filename);
+  tile_streamer_.reset();
+  const int status = impl_.LoadMapFromFile(map_filename);
+  if (status == 0 && FLAGS_use_map_tile_streaming) {
+    if (impl_.IsFlatMap()) {
+      tile_streamer_.reset(new MapTileStreamer(
+          &impl_, FLAGS_map_tile_size, FLAGS_map_tile_resident_radius,
+          FLAGS_map_tile_prefetch_distance));
+    } else {
+      AWARN << "Map tile streaming needs a map in the .flat format, "
+            << map_filename << " is loaded as a whole.";
+    }
+  }
+  return status;
 }
 
 int HDMap::LoadMapFromProto(const Map& map_proto) {
   ADEBUG << "Loading HDMap with header: "
          << map_proto.header().ShortDebugString();
+  tile_streamer_.reset();
   return impl_.LoadMapFromProto(map_proto);
 }
 
@@ -230,5 +244,25 @@ bool HDMap::GetMapHeader(Header* map_header) const {
   return impl_.GetMapHeader(map_header);
 }
 
+void HDMap::UpdateStreamingPosition(
+    const apollo::common::PointENU& position) const {
+  if (tile_streamer_ != nullptr) {
+    tile_streamer_->UpdatePosition({position.x(), position.y()});
+  }
+}
+
+void HDMap::SetStreamingRoute(
+    const std::vector<apollo::common::PointENU>& route) const {
+  if (tile_streamer_ == nullptr) {
+    return;
+  }
+  std::vector<apollo::common::math::Vec2d> points;
+  points.reserve(route.size());
+  for (const auto& point : route) {
+    points.emplace_back(point.x(), point.y());
+  }
+  tile_streamer_->SetRoute(std::move(points));
+}
+
 }  // namespace hdmap
 }  // namespace apollo
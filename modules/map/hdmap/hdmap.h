@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -37,6 +38,7 @@
 
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/map/hdmap/hdmap_impl.h"
+#include "modules/map/hdmap/map_tile_streamer.h"
 
 /**
  * @namespace apollo::hdmap
@@ -329,8 +331,25 @@ class HDMap {
 
   bool GetMapHeader(Header* map_header) const;
 
+  /**
+   * @brief with FLAGS_use_map_tile_streaming and a map in the .flat format,
+   * only the map tiles around position and ahead on the route set by
+   * SetStreamingRoute are kept in memory, otherwise this does nothing
+   * @param position the position of the vehicle
+   */
+  void UpdateStreamingPosition(const apollo::common::PointENU& position) const;
+
+  /**
+   * @brief set the route whose tiles are loaded ahead of the vehicle
+   * @param route points along the route, in driving order
+   */
+  void SetStreamingRoute(
+      const std::vector<apollo::common::PointENU>& route) const;
+
  private:
   HDMapImpl impl_;
+  // declared after impl_ so it is stopped before the map goes away
+  std::unique_ptr<MapTileStreamer> tile_streamer_;
 };
 
 }  // namespace hdmap
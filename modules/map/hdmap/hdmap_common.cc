@@ -501,34 +501,34 @@ void LaneInfo::UpdateOverlaps(const HDMapImpl &map_instance) {
         continue;
       }
       const auto &object_map_id = MakeMapId(object_id);
-      if (map_instance.GetLaneById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::LANE, object_map_id)) {
         cross_lanes_.emplace_back(overlap_ptr);
       }
-      if (map_instance.GetSignalById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::SIGNAL, object_map_id)) {
         signals_.emplace_back(overlap_ptr);
       }
-      if (map_instance.GetYieldSignById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::YIELD_SIGN, object_map_id)) {
         yield_signs_.emplace_back(overlap_ptr);
       }
-      if (map_instance.GetStopSignById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::STOP_SIGN, object_map_id)) {
         stop_signs_.emplace_back(overlap_ptr);
       }
-      if (map_instance.GetCrosswalkById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::CROSSWALK, object_map_id)) {
         crosswalks_.emplace_back(overlap_ptr);
       }
-      if (map_instance.GetJunctionById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::JUNCTION, object_map_id)) {
         junctions_.emplace_back(overlap_ptr);
       }
-      if (map_instance.GetClearAreaById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::CLEAR_AREA, object_map_id)) {
         clear_areas_.emplace_back(overlap_ptr);
       }
-      if (map_instance.GetSpeedBumpById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::SPEED_BUMP, object_map_id)) {
         speed_bumps_.emplace_back(overlap_ptr);
       }
-      if (map_instance.GetParkingSpaceById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::PARKING_SPACE, object_map_id)) {
         parking_spaces_.emplace_back(overlap_ptr);
       }
-      if (map_instance.GetPNCJunctionById(object_map_id) != nullptr) {
+      if (map_instance.HasObject(MapObjectType::PNC_JUNCTION, object_map_id)) {
         pnc_junctions_.emplace_back(overlap_ptr);
       }
     }
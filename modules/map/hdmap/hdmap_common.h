@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "modules/common/math/aabox2d.h"
 #include "modules/common/math/aaboxkdtree2d.h"
+#include "modules/common/math/flat_aaboxkdtree2d.h"
 #include "modules/common/math/math_utils.h"
 #include "modules/common/math/polygon2d.h"
 #include "modules/common/math/vec2d.h"
@@ -120,6 +121,7 @@ struct RoadRoi {
 
 using LaneSegmentBox =
     ObjectWithAABox<LaneInfo, apollo::common::math::LineSegment2d>;
+// kept on AABoxKDTree2d, whose nearest object search is the faster one
 using LaneSegmentKDTree = apollo::common::math::AABoxKDTree2d<LaneSegmentBox>;
 using OverlapInfoConstPtr = std::shared_ptr<const OverlapInfo>;
 using LaneInfoConstPtr = std::shared_ptr<const LaneInfo>;
@@ -299,7 +301,7 @@ class JunctionInfo {
 using JunctionPolygonBox =
     ObjectWithAABox<JunctionInfo, apollo::common::math::Polygon2d>;
 using JunctionPolygonKDTree =
-    apollo::common::math::AABoxKDTree2d<JunctionPolygonBox>;
+    apollo::common::math::FlatAABoxKDTree2d<JunctionPolygonBox>;
 
 class SignalInfo {
  public:
@@ -321,7 +323,7 @@ class SignalInfo {
 using SignalSegmentBox =
     ObjectWithAABox<SignalInfo, apollo::common::math::LineSegment2d>;
 using SignalSegmentKDTree =
-    apollo::common::math::AABoxKDTree2d<SignalSegmentBox>;
+    apollo::common::math::FlatAABoxKDTree2d<SignalSegmentBox>;
 
 class CrosswalkInfo {
  public:
@@ -341,7 +343,7 @@ class CrosswalkInfo {
 using CrosswalkPolygonBox =
     ObjectWithAABox<CrosswalkInfo, apollo::common::math::Polygon2d>;
 using CrosswalkPolygonKDTree =
-    apollo::common::math::AABoxKDTree2d<CrosswalkPolygonBox>;
+    apollo::common::math::FlatAABoxKDTree2d<CrosswalkPolygonBox>;
 
 class StopSignInfo {
  public:
@@ -374,7 +376,7 @@ class StopSignInfo {
 using StopSignSegmentBox =
     ObjectWithAABox<StopSignInfo, apollo::common::math::LineSegment2d>;
 using StopSignSegmentKDTree =
-    apollo::common::math::AABoxKDTree2d<StopSignSegmentBox>;
+    apollo::common::math::FlatAABoxKDTree2d<StopSignSegmentBox>;
 
 class YieldSignInfo {
  public:
@@ -396,7 +398,7 @@ class YieldSignInfo {
 using YieldSignSegmentBox =
     ObjectWithAABox<YieldSignInfo, apollo::common::math::LineSegment2d>;
 using YieldSignSegmentKDTree =
-    apollo::common::math::AABoxKDTree2d<YieldSignSegmentBox>;
+    apollo::common::math::FlatAABoxKDTree2d<YieldSignSegmentBox>;
 
 class ClearAreaInfo {
  public:
@@ -416,7 +418,7 @@ class ClearAreaInfo {
 using ClearAreaPolygonBox =
     ObjectWithAABox<ClearAreaInfo, apollo::common::math::Polygon2d>;
 using ClearAreaPolygonKDTree =
-    apollo::common::math::AABoxKDTree2d<ClearAreaPolygonBox>;
+    apollo::common::math::FlatAABoxKDTree2d<ClearAreaPolygonBox>;
 
 class SpeedBumpInfo {
  public:
@@ -438,7 +440,7 @@ class SpeedBumpInfo {
 using SpeedBumpSegmentBox =
     ObjectWithAABox<SpeedBumpInfo, apollo::common::math::LineSegment2d>;
 using SpeedBumpSegmentKDTree =
-    apollo::common::math::AABoxKDTree2d<SpeedBumpSegmentBox>;
+    apollo::common::math::FlatAABoxKDTree2d<SpeedBumpSegmentBox>;
 
 class OverlapInfo {
  public:
@@ -489,7 +491,7 @@ class ParkingSpaceInfo {
 using ParkingSpacePolygonBox =
     ObjectWithAABox<ParkingSpaceInfo, apollo::common::math::Polygon2d>;
 using ParkingSpacePolygonKDTree =
-    apollo::common::math::AABoxKDTree2d<ParkingSpacePolygonBox>;
+    apollo::common::math::FlatAABoxKDTree2d<ParkingSpacePolygonBox>;
 
 class PNCJunctionInfo {
  public:
@@ -511,7 +513,7 @@ class PNCJunctionInfo {
 using PNCJunctionPolygonBox =
     ObjectWithAABox<PNCJunctionInfo, apollo::common::math::Polygon2d>;
 using PNCJunctionPolygonKDTree =
-    apollo::common::math::AABoxKDTree2d<PNCJunctionPolygonBox>;
+    apollo::common::math::FlatAABoxKDTree2d<PNCJunctionPolygonBox>;
 
 struct JunctionBoundary {
   JunctionInfoConstPtr junction_info;
@@ -20,6 +20,7 @@ limitations under the License.
 #include <mutex>
 #include <set>
 #include <unordered_set>
+#include <utility>
 
 #include "absl/strings/match.h"
 #include "cyber/common/file.h"
@@ -31,6 +32,7 @@ namespace hdmap {
 namespace {
 
 using apollo::common::PointENU;
+using apollo::common::math::AABox2d;
 using apollo::common::math::AABoxKDTreeParams;
 using apollo::common::math::Vec2d;
 
@@ -45,12 +47,25 @@ constexpr double kLanesSearchRange = 10.0;
 // backward search distance in GetForwardNearestSignalsOnLane
 constexpr int kBackwardDistance = 4;
 
+// the Info classes keep a reference to their proto, so a flat map object
+// owns both
+template <class Info, class Proto>
+struct FlatMapObject {
+  explicit FlatMapObject(Proto&& object)
+      : proto(std::move(object)), info(proto) {}
+  Proto proto;
+  Info info;
+};
+
 }  // namespace
 
 int HDMapImpl::LoadMapFromFile(const std::string& map_filename) {
   Clear();
   // TODO(All) seems map_ can be changed to a local variable of this
   // function, but test will fail if I do so. if so.
+  if (absl::EndsWith(map_filename, ".flat")) {
+    return LoadMapFromFlatMap(map_filename);
+  }
   if (absl::EndsWith(map_filename, ".xml")) {
     if (!adapter::OpendriveAdapter::LoadData(map_filename, &map_)) {
       return -1;
@@ -63,6 +78,9 @@ int HDMapImpl::LoadMapFromFile(const std::string& map_filename) {
 }
 
 bool HDMapImpl::GetMapHeader(Header* map_header) const {
+  if (flat_map_ != nullptr) {
+    return flat_map_->GetHeader(map_header);
+  }
   if (!map_.has_header()) {
     return false;
   }
@@ -161,69 +179,152 @@ int HDMapImpl::LoadMapFromProto(const Map& map_proto) {
 }
 
 LaneInfoConstPtr HDMapImpl::GetLaneById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<LaneInfo, Lane>(MapObjectType::LANE, id);
+  }
   LaneTable::const_iterator it = lane_table_.find(id.id());
   return it != lane_table_.end() ? it->second : nullptr;
 }
 
 JunctionInfoConstPtr HDMapImpl::GetJunctionById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<JunctionInfo, Junction>(MapObjectType::JUNCTION,
+                                                    id);
+  }
   JunctionTable::const_iterator it = junction_table_.find(id.id());
   return it != junction_table_.end() ? it->second : nullptr;
 }
 
 SignalInfoConstPtr HDMapImpl::GetSignalById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<SignalInfo, Signal>(MapObjectType::SIGNAL, id);
+  }
   SignalTable::const_iterator it = signal_table_.find(id.id());
   return it != signal_table_.end() ? it->second : nullptr;
 }
 
 CrosswalkInfoConstPtr HDMapImpl::GetCrosswalkById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<CrosswalkInfo, Crosswalk>(MapObjectType::CROSSWALK,
+                                                      id);
+  }
   CrosswalkTable::const_iterator it = crosswalk_table_.find(id.id());
   return it != crosswalk_table_.end() ? it->second : nullptr;
 }
 
 StopSignInfoConstPtr HDMapImpl::GetStopSignById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<StopSignInfo, StopSign>(MapObjectType::STOP_SIGN,
+                                                    id);
+  }
   StopSignTable::const_iterator it = stop_sign_table_.find(id.id());
   return it != stop_sign_table_.end() ? it->second : nullptr;
 }
 
 YieldSignInfoConstPtr HDMapImpl::GetYieldSignById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<YieldSignInfo, YieldSign>(MapObjectType::YIELD_SIGN,
+                                                      id);
+  }
   YieldSignTable::const_iterator it = yield_sign_table_.find(id.id());
   return it != yield_sign_table_.end() ? it->second : nullptr;
 }
 
 ClearAreaInfoConstPtr HDMapImpl::GetClearAreaById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<ClearAreaInfo, ClearArea>(MapObjectType::CLEAR_AREA,
+                                                      id);
+  }
   ClearAreaTable::const_iterator it = clear_area_table_.find(id.id());
   return it != clear_area_table_.end() ? it->second : nullptr;
 }
 
 SpeedBumpInfoConstPtr HDMapImpl::GetSpeedBumpById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<SpeedBumpInfo, SpeedBump>(MapObjectType::SPEED_BUMP,
+                                                      id);
+  }
   SpeedBumpTable::const_iterator it = speed_bump_table_.find(id.id());
   return it != speed_bump_table_.end() ? it->second : nullptr;
 }
 
 OverlapInfoConstPtr HDMapImpl::GetOverlapById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<OverlapInfo, Overlap>(MapObjectType::OVERLAP, id);
+  }
   OverlapTable::const_iterator it = overlap_table_.find(id.id());
   return it != overlap_table_.end() ? it->second : nullptr;
 }
 
 RoadInfoConstPtr HDMapImpl::GetRoadById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<RoadInfo, Road>(MapObjectType::ROAD, id);
+  }
   RoadTable::const_iterator it = road_table_.find(id.id());
   return it != road_table_.end() ? it->second : nullptr;
 }
 
 ParkingSpaceInfoConstPtr HDMapImpl::GetParkingSpaceById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<ParkingSpaceInfo, ParkingSpace>(
+        MapObjectType::PARKING_SPACE, id);
+  }
   ParkingSpaceTable::const_iterator it = parking_space_table_.find(id.id());
   return it != parking_space_table_.end() ? it->second : nullptr;
 }
 
 PNCJunctionInfoConstPtr HDMapImpl::GetPNCJunctionById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<PNCJunctionInfo, PNCJunction>(
+        MapObjectType::PNC_JUNCTION, id);
+  }
   PNCJunctionTable::const_iterator it = pnc_junction_table_.find(id.id());
   return it != pnc_junction_table_.end() ? it->second : nullptr;
 }
 
 RSUInfoConstPtr HDMapImpl::GetRSUById(const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return GetFlatMapObject<RSUInfo, RSU>(MapObjectType::RSU, id);
+  }
   RSUTable::const_iterator it = rsu_table_.find(id.id());
   return it != rsu_table_.end() ? it->second : nullptr;
 }
+bool HDMapImpl::HasObject(MapObjectType type, const Id& id) const {
+  if (flat_map_ != nullptr) {
+    return flat_map_->Find(type, id.id()) >= 0;
+  }
+  switch (type) {
+    case MapObjectType::LANE:
+      return lane_table_.count(id.id()) > 0;
+    case MapObjectType::JUNCTION:
+      return junction_table_.count(id.id()) > 0;
+    case MapObjectType::SIGNAL:
+      return signal_table_.count(id.id()) > 0;
+    case MapObjectType::CROSSWALK:
+      return crosswalk_table_.count(id.id()) > 0;
+    case MapObjectType::STOP_SIGN:
+      return stop_sign_table_.count(id.id()) > 0;
+    case MapObjectType::YIELD_SIGN:
+      return yield_sign_table_.count(id.id()) > 0;
+    case MapObjectType::CLEAR_AREA:
+      return clear_area_table_.count(id.id()) > 0;
+    case MapObjectType::SPEED_BUMP:
+      return speed_bump_table_.count(id.id()) > 0;
+    case MapObjectType::OVERLAP:
+      return overlap_table_.count(id.id()) > 0;
+    case MapObjectType::ROAD:
+      return road_table_.count(id.id()) > 0;
+    case MapObjectType::PARKING_SPACE:
+      return parking_space_table_.count(id.id()) > 0;
+    case MapObjectType::PNC_JUNCTION:
+      return pnc_junction_table_.count(id.id()) > 0;
+    case MapObjectType::RSU:
+      return rsu_table_.count(id.id()) > 0;
+    default:
+      return false;
+  }
+}
+
 int HDMapImpl::GetLanes(const PointENU& point, double distance,
                         std::vector<LaneInfoConstPtr>* lanes) const {
   return GetLanes({point.x(), point.y()}, distance, lanes);
@@ -231,6 +332,10 @@ int HDMapImpl::GetLanes(const PointENU& point, double distance,
 
 int HDMapImpl::GetLanes(const Vec2d& point, double distance,
                         std::vector<LaneInfoConstPtr>* lanes) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMap<LaneInfo, Lane>(MapObjectType::LANE, point, distance,
+                                         lanes);
+  }
   if (lanes == nullptr || lane_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -283,6 +388,10 @@ int HDMapImpl::GetJunctions(
 int HDMapImpl::GetJunctions(
     const Vec2d& point, double distance,
     std::vector<JunctionInfoConstPtr>* junctions) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMapPolygons<JunctionInfo, Junction>(
+        MapObjectType::JUNCTION, point, distance, junctions);
+  }
   if (junctions == nullptr || junction_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -306,6 +415,10 @@ int HDMapImpl::GetSignals(const PointENU& point, double distance,
 
 int HDMapImpl::GetSignals(const Vec2d& point, double distance,
                           std::vector<SignalInfoConstPtr>* signals) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMap<SignalInfo, Signal>(MapObjectType::SIGNAL, point,
+                                             distance, signals);
+  }
   if (signals == nullptr || signal_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -331,6 +444,10 @@ int HDMapImpl::GetCrosswalks(
 int HDMapImpl::GetCrosswalks(
     const Vec2d& point, double distance,
     std::vector<CrosswalkInfoConstPtr>* crosswalks) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMapPolygons<CrosswalkInfo, Crosswalk>(
+        MapObjectType::CROSSWALK, point, distance, crosswalks);
+  }
   if (crosswalks == nullptr || crosswalk_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -356,6 +473,10 @@ int HDMapImpl::GetStopSigns(
 int HDMapImpl::GetStopSigns(
     const Vec2d& point, double distance,
     std::vector<StopSignInfoConstPtr>* stop_signs) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMap<StopSignInfo, StopSign>(MapObjectType::STOP_SIGN,
+                                                 point, distance, stop_signs);
+  }
   if (stop_signs == nullptr || stop_sign_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -381,6 +502,10 @@ int HDMapImpl::GetYieldSigns(
 int HDMapImpl::GetYieldSigns(
     const Vec2d& point, double distance,
     std::vector<YieldSignInfoConstPtr>* yield_signs) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMap<YieldSignInfo, YieldSign>(
+        MapObjectType::YIELD_SIGN, point, distance, yield_signs);
+  }
   if (yield_signs == nullptr || yield_sign_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -407,6 +532,10 @@ int HDMapImpl::GetClearAreas(
 int HDMapImpl::GetClearAreas(
     const Vec2d& point, double distance,
     std::vector<ClearAreaInfoConstPtr>* clear_areas) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMapPolygons<ClearAreaInfo, ClearArea>(
+        MapObjectType::CLEAR_AREA, point, distance, clear_areas);
+  }
   if (clear_areas == nullptr || clear_area_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -433,6 +562,10 @@ int HDMapImpl::GetSpeedBumps(
 int HDMapImpl::GetSpeedBumps(
     const Vec2d& point, double distance,
     std::vector<SpeedBumpInfoConstPtr>* speed_bumps) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMap<SpeedBumpInfo, SpeedBump>(
+        MapObjectType::SPEED_BUMP, point, distance, speed_bumps);
+  }
   if (speed_bumps == nullptr || speed_bump_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -459,6 +592,10 @@ int HDMapImpl::GetParkingSpaces(
 int HDMapImpl::GetParkingSpaces(
     const Vec2d& point, double distance,
     std::vector<ParkingSpaceInfoConstPtr>* parking_spaces) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMapPolygons<ParkingSpaceInfo, ParkingSpace>(
+        MapObjectType::PARKING_SPACE, point, distance, parking_spaces);
+  }
   if (parking_spaces == nullptr || parking_space_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -485,6 +622,10 @@ int HDMapImpl::GetPNCJunctions(
 int HDMapImpl::GetPNCJunctions(
     const apollo::common::math::Vec2d& point, double distance,
     std::vector<PNCJunctionInfoConstPtr>* pnc_junctions) const {
+  if (flat_map_ != nullptr) {
+    return SearchFlatMapPolygons<PNCJunctionInfo, PNCJunction>(
+        MapObjectType::PNC_JUNCTION, point, distance, pnc_junctions);
+  }
   if (pnc_junctions == nullptr || pnc_junction_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -520,14 +661,10 @@ int HDMapImpl::GetNearestLaneWithDistance(
   CHECK_NOTNULL(nearest_lane);
   CHECK_NOTNULL(nearest_s);
   CHECK_NOTNULL(nearest_l);
-  const auto* segment_object = lane_segment_kdtree_->GetNearestObject(point);
-  if (segment_object == nullptr) {
+  int id = 0;
+  if (!GetNearestLaneSegment(point, nearest_lane, &id)) {
     return -1;
   }
-  const Id& lane_id = segment_object->object()->id();
-  *nearest_lane = GetLaneById(lane_id);
-  ACHECK(*nearest_lane);
-  const int id = segment_object->id();
   const auto& segment = (*nearest_lane)->segments()[id];
   Vec2d nearest_pt;
   double apart_distance = segment.DistanceTo(point, &nearest_pt);
@@ -556,14 +693,10 @@ int HDMapImpl::GetNearestLane(const Vec2d& point,
   CHECK_NOTNULL(nearest_lane);
   CHECK_NOTNULL(nearest_s);
   CHECK_NOTNULL(nearest_l);
-  const auto* segment_object = lane_segment_kdtree_->GetNearestObject(point);
-  if (segment_object == nullptr) {
+  int id = 0;
+  if (!GetNearestLaneSegment(point, nearest_lane, &id)) {
     return -1;
   }
-  const Id& lane_id = segment_object->object()->id();
-  *nearest_lane = GetLaneById(lane_id);
-  ACHECK(*nearest_lane);
-  const int id = segment_object->id();
   const auto& segment = (*nearest_lane)->segments()[id];
   Vec2d nearest_pt;
   segment.DistanceTo(point, &nearest_pt);
@@ -1465,6 +1598,281 @@ void HDMapImpl::BuildPNCJunctionPolygonKDTree() {
                      &pnc_junction_polygon_kdtree_);
 }
 
+bool HDMapImpl::GetNearestLaneSegment(const Vec2d& point,
+                                      LaneInfoConstPtr* nearest_lane,
+                                      int* segment_id) const {
+  if (flat_map_ != nullptr) {
+    FlatMap::Hit hit;
+    if (!flat_map_->GetNearest(MapObjectType::LANE, point, &hit)) {
+      return false;
+    }
+    *nearest_lane = GetFlatMapObject<LaneInfo, Lane>(
+        MapObjectType::LANE, static_cast<int>(hit.object));
+    // the segment index is only known to be valid once the lane is parsed
+    if (*nearest_lane == nullptr ||
+        hit.element >= (*nearest_lane)->segments().size()) {
+      AERROR << "Invalid lane segment " << hit.element << " in flat map";
+      return false;
+    }
+    *segment_id = static_cast<int>(hit.element);
+  } else {
+    const auto* segment_object =
+        lane_segment_kdtree_->GetNearestObject(point);
+    if (segment_object == nullptr) {
+      return false;
+    }
+    *nearest_lane = GetLaneById(segment_object->object()->id());
+    *segment_id = segment_object->id();
+  }
+  ACHECK(*nearest_lane);
+  return true;
+}
+
+int HDMapImpl::LoadMapFromFlatMap(const std::string& map_filename) {
+  flat_map_ = FlatMap::Open(map_filename);
+  if (flat_map_ == nullptr) {
+    return -1;
+  }
+  for (size_t i = 0; i < kNumMapObjectTypes; ++i) {
+    flat_map_objects_[i].resize(
+        flat_map_->Size(static_cast<MapObjectType>(i)));
+    flat_map_pins_[i].assign(flat_map_objects_[i].size(), 0);
+  }
+  return 0;
+}
+
+template <class Info, class Proto>
+std::shared_ptr<Info> HDMapImpl::GetFlatMapObject(MapObjectType type,
+                                                  int index) const {
+  auto& objects = flat_map_objects_[static_cast<size_t>(type)];
+  if (index < 0 || static_cast<size_t>(index) >= objects.size()) {
+    return nullptr;
+  }
+  auto& slot = objects[index];
+  auto object = std::atomic_load(&slot);
+  if (object == nullptr) {
+    std::lock_guard<std::recursive_mutex> lock(flat_map_mutex_);
+    object = std::atomic_load(&slot);
+    if (object == nullptr) {
+      Proto proto;
+      if (!flat_map_->Parse(type, index, &proto)) {
+        AERROR << "Failed to parse object " << index << " of type "
+               << static_cast<int>(type) << " from flat map";
+        return nullptr;
+      }
+      auto holder =
+          std::make_shared<FlatMapObject<Info, Proto>>(std::move(proto));
+      std::shared_ptr<Info> info(holder, &holder->info);
+      PostProcessFlatMapObject(index, info.get());
+      object = info;
+      std::atomic_store(&slot, object);
+    }
+  }
+  return std::static_pointer_cast<Info>(object);
+}
+
+template <class Info, class Proto>
+std::shared_ptr<Info> HDMapImpl::GetFlatMapObject(MapObjectType type,
+                                                  const Id& id) const {
+  return GetFlatMapObject<Info, Proto>(type, flat_map_->Find(type, id.id()));
+}
+
+void HDMapImpl::PostProcessFlatMapObject(size_t index, LaneInfo* lane) const {
+  int road_index = -1;
+  int section_index = -1;
+  flat_map_->GetLaneRoad(index, &road_index, &section_index);
+  auto road =
+      GetFlatMapObject<RoadInfo, Road>(MapObjectType::ROAD, road_index);
+  if (road != nullptr && section_index >= 0 &&
+      section_index < static_cast<int>(road->sections().size())) {
+    lane->set_road_id(road->id());
+    lane->set_section_id(road->sections()[section_index].id());
+  }
+  lane->PostProcess(*this);
+}
+
+void HDMapImpl::PostProcessFlatMapObject(size_t /*index*/,
+                                         JunctionInfo* junction) const {
+  junction->PostProcess(*this);
+}
+
+void HDMapImpl::PostProcessFlatMapObject(size_t /*index*/,
+                                         StopSignInfo* stop_sign) const {
+  stop_sign->PostProcess(*this);
+}
+
+bool HDMapImpl::BuildFlatMapObject(MapObjectType type, int index) const {
+  switch (type) {
+    case MapObjectType::LANE:
+      return GetFlatMapObject<LaneInfo, Lane>(type, index) != nullptr;
+    case MapObjectType::JUNCTION:
+      return GetFlatMapObject<JunctionInfo, Junction>(type, index) != nullptr;
+    case MapObjectType::SIGNAL:
+      return GetFlatMapObject<SignalInfo, Signal>(type, index) != nullptr;
+    case MapObjectType::CROSSWALK:
+      return GetFlatMapObject<CrosswalkInfo, Crosswalk>(type, index) !=
+             nullptr;
+    case MapObjectType::STOP_SIGN:
+      return GetFlatMapObject<StopSignInfo, StopSign>(type, index) != nullptr;
+    case MapObjectType::YIELD_SIGN:
+      return GetFlatMapObject<YieldSignInfo, YieldSign>(type, index) !=
+             nullptr;
+    case MapObjectType::CLEAR_AREA:
+      return GetFlatMapObject<ClearAreaInfo, ClearArea>(type, index) !=
+             nullptr;
+    case MapObjectType::SPEED_BUMP:
+      return GetFlatMapObject<SpeedBumpInfo, SpeedBump>(type, index) !=
+             nullptr;
+    case MapObjectType::OVERLAP:
+      return GetFlatMapObject<OverlapInfo, Overlap>(type, index) != nullptr;
+    case MapObjectType::ROAD:
+      return GetFlatMapObject<RoadInfo, Road>(type, index) != nullptr;
+    case MapObjectType::PARKING_SPACE:
+      return GetFlatMapObject<ParkingSpaceInfo, ParkingSpace>(type, index) !=
+             nullptr;
+    case MapObjectType::PNC_JUNCTION:
+      return GetFlatMapObject<PNCJunctionInfo, PNCJunction>(type, index) !=
+             nullptr;
+    case MapObjectType::RSU:
+      return GetFlatMapObject<RSUInfo, RSU>(type, index) != nullptr;
+    default:
+      return false;
+  }
+}
+
+size_t HDMapImpl::PinArea(const AABox2d& box) const {
+  if (flat_map_ == nullptr) {
+    return 0;
+  }
+  size_t num_objects = 0;
+  std::vector<uint32_t> objects;
+  for (size_t i = 0; i < kNumMapObjectTypes; ++i) {
+    const auto type = static_cast<MapObjectType>(i);
+    if (!FlatMap::IsSegmentType(type) && !FlatMap::IsPolygonType(type)) {
+      continue;
+    }
+    flat_map_->GetObjectsInBox(type, box, &objects);
+    {
+      std::lock_guard<std::recursive_mutex> lock(flat_map_mutex_);
+      for (const uint32_t object : objects) {
+        ++flat_map_pins_[i][object];
+      }
+    }
+    // built without holding the lock for the whole area, so queries which
+    // miss are not blocked behind a prefetch
+    for (const uint32_t object : objects) {
+      BuildFlatMapObject(type, static_cast<int>(object));
+    }
+    num_objects += objects.size();
+  }
+  return num_objects;
+}
+
+void HDMapImpl::UnpinArea(const AABox2d& box) const {
+  if (flat_map_ == nullptr) {
+    return;
+  }
+  std::vector<uint32_t> objects;
+  for (size_t i = 0; i < kNumMapObjectTypes; ++i) {
+    const auto type = static_cast<MapObjectType>(i);
+    if (!FlatMap::IsSegmentType(type) && !FlatMap::IsPolygonType(type)) {
+      continue;
+    }
+    flat_map_->GetObjectsInBox(type, box, &objects);
+    std::lock_guard<std::recursive_mutex> lock(flat_map_mutex_);
+    for (const uint32_t object : objects) {
+      auto& pins = flat_map_pins_[i][object];
+      if (pins > 0) {
+        --pins;
+      }
+    }
+  }
+}
+
+size_t HDMapImpl::EvictUnpinnedObjects() const {
+  if (flat_map_ == nullptr) {
+    return 0;
+  }
+  std::lock_guard<std::recursive_mutex> lock(flat_map_mutex_);
+  size_t num_evicted = 0;
+  // overlaps come after the objects holding them, so an overlap is free to
+  // go in the same sweep as the lanes it was built for
+  static const MapObjectType kEvictOrder[] = {
+      MapObjectType::LANE,          MapObjectType::JUNCTION,
+      MapObjectType::SIGNAL,        MapObjectType::CROSSWALK,
+      MapObjectType::STOP_SIGN,     MapObjectType::YIELD_SIGN,
+      MapObjectType::CLEAR_AREA,    MapObjectType::SPEED_BUMP,
+      MapObjectType::PARKING_SPACE, MapObjectType::PNC_JUNCTION,
+      MapObjectType::RSU,           MapObjectType::OVERLAP,
+      MapObjectType::ROAD};
+  for (const auto type : kEvictOrder) {
+    auto& objects = flat_map_objects_[static_cast<size_t>(type)];
+    const auto& pins = flat_map_pins_[static_cast<size_t>(type)];
+    for (size_t j = 0; j < objects.size(); ++j) {
+      // objects still held by a caller are kept, dropping them would only
+      // build a second copy on their next use
+      if (pins[j] > 0 || objects[j] == nullptr ||
+          objects[j].use_count() > 1) {
+        continue;
+      }
+      std::atomic_store(&objects[j], std::shared_ptr<void>());
+      ++num_evicted;
+    }
+  }
+  return num_evicted;
+}
+
+template <class Info, class Proto>
+int HDMapImpl::SearchFlatMap(
+    MapObjectType type, const Vec2d& point, double distance,
+    std::vector<std::shared_ptr<const Info>>* objects) const {
+  if (objects == nullptr) {
+    return -1;
+  }
+  objects->clear();
+  std::vector<FlatMap::Hit> hits;
+  flat_map_->Search(type, point, distance, &hits);
+  std::sort(hits.begin(), hits.end(),
+            [](const FlatMap::Hit& lhs, const FlatMap::Hit& rhs) {
+              return lhs.object < rhs.object;
+            });
+  hits.erase(std::unique(hits.begin(), hits.end(),
+                         [](const FlatMap::Hit& lhs, const FlatMap::Hit& rhs) {
+                           return lhs.object == rhs.object;
+                         }),
+             hits.end());
+  for (const auto& hit : hits) {
+    auto object =
+        GetFlatMapObject<Info, Proto>(type, static_cast<int>(hit.object));
+    if (object == nullptr) {
+      return -1;
+    }
+    objects->emplace_back(std::move(object));
+  }
+  return 0;
+}
+
+template <class Info, class Proto>
+int HDMapImpl::SearchFlatMapPolygons(
+    MapObjectType type, const Vec2d& point, double distance,
+    std::vector<std::shared_ptr<const Info>>* objects) const {
+  const int status = SearchFlatMap<Info, Proto>(type, point, distance, objects);
+  if (status != 0) {
+    return status;
+  }
+  // the index only knows the bounding boxes of polygons
+  const double distance_sqr = distance * distance;
+  objects->erase(
+      std::remove_if(objects->begin(), objects->end(),
+                     [&point, distance_sqr](
+                         const std::shared_ptr<const Info>& object) {
+                       return object->polygon().DistanceSquareTo(point) >
+                              distance_sqr;
+                     }),
+      objects->end());
+  return 0;
+}
+
 template <class KDTree>
 int HDMapImpl::SearchObjects(const Vec2d& center, const double radius,
                              const KDTree& kdtree,
@@ -1516,6 +1924,13 @@ void HDMapImpl::Clear() {
   parking_space_polygon_kdtree_.reset(nullptr);
   pnc_junction_polygon_boxes_.clear();
   pnc_junction_polygon_kdtree_.reset(nullptr);
+  flat_map_.reset(nullptr);
+  for (auto& objects : flat_map_objects_) {
+    objects.clear();
+  }
+  for (auto& pins : flat_map_pins_) {
+    pins.clear();
+  }
 }
 
 }  // namespace hdmap
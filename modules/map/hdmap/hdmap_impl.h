@@ -15,7 +15,9 @@ limitations under the License.
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -26,6 +28,7 @@ limitations under the License.
 #include "modules/common/math/line_segment2d.h"
 #include "modules/common/math/polygon2d.h"
 #include "modules/common/math/vec2d.h"
+#include "modules/map/hdmap/flat_map.h"
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/common_msgs/map_msgs/map.pb.h"
 #include "modules/common_msgs/map_msgs/map_clear_area.pb.h"
@@ -82,7 +85,8 @@ class HDMapImpl {
 
  public:
   /**
-   * @brief load map from local file
+   * @brief load map from local file, a .flat file written by FlatMap::Write
+   * is mapped into memory and its objects are built on first access
    * @param map_filename path of map data file
    * @return 0:success, otherwise failed
    */
@@ -109,6 +113,37 @@ class HDMapImpl {
   PNCJunctionInfoConstPtr GetPNCJunctionById(const Id& id) const;
   RSUInfoConstPtr GetRSUById(const Id& id) const;
 
+  /**
+   * @brief check if the map has an object, unlike the Get*ById functions
+   * this does not build the object when the map is a flat map
+   * @param type type of the object
+   * @param id id of the object
+   * @return true if the object exists
+   */
+  bool HasObject(MapObjectType type, const Id& id) const;
+
+  /**
+   * @brief check if the map was loaded from a flat map, whose objects are
+   * built on first use and can be dropped again by EvictUnpinnedObjects
+   */
+  bool IsFlatMap() const { return flat_map_ != nullptr; }
+
+  /**
+   * @brief build the objects of a flat map which are in box and keep them
+   * until UnpinArea is called with the same box, areas may overlap
+   * @param box the area to pin
+   * @return number of objects in box
+   */
+  size_t PinArea(const apollo::common::math::AABox2d& box) const;
+  void UnpinArea(const apollo::common::math::AABox2d& box) const;
+
+  /**
+   * @brief drop the objects of a flat map which are neither pinned nor
+   * referenced outside of the map, they are built again on their next use
+   * @return number of dropped objects
+   */
+  size_t EvictUnpinnedObjects() const;
+
   /**
    * @brief get all lanes in certain range
    * @param point the central point of the range
@@ -429,6 +464,35 @@ class HDMapImpl {
                            const double radius, const KDTree& kdtree,
                            std::vector<std::string>* const results);
 
+  bool GetNearestLaneSegment(const apollo::common::math::Vec2d& point,
+                             LaneInfoConstPtr* nearest_lane,
+                             int* segment_id) const;
+
+  int LoadMapFromFlatMap(const std::string& map_filename);
+
+  template <class Info, class Proto>
+  std::shared_ptr<Info> GetFlatMapObject(MapObjectType type, int index) const;
+  template <class Info, class Proto>
+  std::shared_ptr<Info> GetFlatMapObject(MapObjectType type,
+                                         const Id& id) const;
+
+  template <class Info>
+  void PostProcessFlatMapObject(size_t /*index*/, Info* /*info*/) const {}
+  void PostProcessFlatMapObject(size_t index, LaneInfo* lane) const;
+  void PostProcessFlatMapObject(size_t index, JunctionInfo* junction) const;
+  void PostProcessFlatMapObject(size_t index, StopSignInfo* stop_sign) const;
+  bool BuildFlatMapObject(MapObjectType type, int index) const;
+
+  template <class Info, class Proto>
+  int SearchFlatMap(MapObjectType type,
+                    const apollo::common::math::Vec2d& point, double distance,
+                    std::vector<std::shared_ptr<const Info>>* objects) const;
+  template <class Info, class Proto>
+  int SearchFlatMapPolygons(
+      MapObjectType type, const apollo::common::math::Vec2d& point,
+      double distance,
+      std::vector<std::shared_ptr<const Info>>* objects) const;
+
   void Clear();
 
  private:
@@ -476,6 +540,17 @@ class HDMapImpl {
 
   std::vector<PNCJunctionPolygonBox> pnc_junction_polygon_boxes_;
   std::unique_ptr<PNCJunctionPolygonKDTree> pnc_junction_polygon_kdtree_;
+
+  // set instead of the tables and kd trees when loaded from a flat map
+  std::unique_ptr<FlatMap> flat_map_;
+  // objects built from flat_map_ by type and index, read with atomic_load
+  // and only written under flat_map_mutex_
+  mutable std::array<std::vector<std::shared_ptr<void>>, kNumMapObjectTypes>
+      flat_map_objects_;
+  // number of pinned areas each object of flat_map_objects_ is in
+  mutable std::array<std::vector<uint32_t>, kNumMapObjectTypes> flat_map_pins_;
+  // recursive since building a lane looks up its overlaps
+  mutable std::recursive_mutex flat_map_mutex_;
 };
 
 }  // namespace hdmap
@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+#include "modules/common/math/aaboxkdtree2d.h"
+#include "modules/common/math/flat_aaboxkdtree2d.h"
+#include "modules/common_msgs/map_msgs/map.pb.h"
+#include "modules/map/hdmap/hdmap_common.h"
+
+namespace apollo {
+namespace hdmap {
+
+using apollo::common::math::AABoxKDTree2d;
+using apollo::common::math::AABoxKDTreeParams;
+using apollo::common::math::FlatAABoxKDTree2d;
+using apollo::common::math::Vec2d;
+
+// The lane segments of the test map indexed like HDMapImpl does, queried at
+// points along the lanes as a reference line projection would. The map is
+// repeated on a grid of copies x copies to get the size of a city map.
+class LaneSegments {
+ public:
+  static const LaneSegments& Instance(int copies) {
+    static std::map<int, std::unique_ptr<LaneSegments>> instances;
+    auto& instance = instances[copies];
+    if (instance == nullptr) {
+      instance.reset(new LaneSegments(copies));
+    }
+    return *instance;
+  }
+
+  AABoxKDTreeParams params() const {
+    AABoxKDTreeParams params;
+    params.max_leaf_dimension = 5.0;
+    params.max_leaf_size = 16;
+    return params;
+  }
+
+  std::vector<std::unique_ptr<Lane>> lane_protos;
+  std::vector<std::unique_ptr<LaneInfo>> lanes;
+  std::vector<LaneSegmentBox> boxes;
+  std::vector<Vec2d> points;
+
+ private:
+  explicit LaneSegments(int copies) {
+    Map map;
+    ACHECK(cyber::common::GetProtoFromFile(
+        "modules/map/hdmap/test-data/base_map.bin", &map));
+    std::vector<Vec2d> lane_points;
+    for (const auto& lane : map.lane()) {
+      for (const auto& segment : lane.central_curve().segment()) {
+        for (const auto& point : segment.line_segment().point()) {
+          lane_points.emplace_back(point.x(), point.y());
+        }
+      }
+    }
+    const auto extent = apollo::common::math::AABox2d(lane_points);
+    const double spacing = std::max(extent.length(), extent.width()) + 100.0;
+    for (int i = 0; i < copies; ++i) {
+      for (int j = 0; j < copies; ++j) {
+        for (const auto& lane : map.lane()) {
+          // LaneInfo keeps a reference to its lane
+          lane_protos.emplace_back(new Lane(lane));
+          auto* curve = lane_protos.back()->mutable_central_curve();
+          for (auto& segment : *curve->mutable_segment()) {
+            for (auto& point :
+                 *segment.mutable_line_segment()->mutable_point()) {
+              point.set_x(point.x() + i * spacing);
+              point.set_y(point.y() + j * spacing);
+            }
+          }
+          lanes.emplace_back(new LaneInfo(*lane_protos.back()));
+        }
+      }
+    }
+    for (const auto& lane : lanes) {
+      for (size_t id = 0; id < lane->segments().size(); ++id) {
+        const auto& segment = lane->segments()[id];
+        boxes.emplace_back(
+            apollo::common::math::AABox2d(segment.start(), segment.end()),
+            lane.get(), &segment, static_cast<int>(id));
+      }
+    }
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> offset(-3.0, 3.0);
+    for (const auto& lane : lanes) {
+      for (const auto& point : lane->points()) {
+        points.emplace_back(point.x() + offset(random),
+                            point.y() + offset(random));
+      }
+    }
+  }
+};
+
+template <class KDTree>
+void BM_NearestObject(benchmark::State& state) {
+  const auto& data = LaneSegments::Instance(static_cast<int>(state.range(0)));
+  KDTree kdtree(data.boxes, data.params());
+  for (auto _ : state) {
+    for (const auto& point : data.points) {
+      benchmark::DoNotOptimize(kdtree.GetNearestObject(point));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.points.size());
+}
+
+// The batch queries take the points in chunks of about one reference line.
+constexpr size_t kBatchSize = 256;
+
+std::vector<std::vector<Vec2d>> Batches(const std::vector<Vec2d>& points) {
+  std::vector<std::vector<Vec2d>> batches;
+  for (size_t i = 0; i < points.size(); i += kBatchSize) {
+    batches.emplace_back(points.begin() + i,
+                         points.begin() + std::min(i + kBatchSize,
+                                                   points.size()));
+  }
+  return batches;
+}
+
+void BM_FlatNearestObjects(benchmark::State& state) {
+  const auto& data = LaneSegments::Instance(static_cast<int>(state.range(0)));
+  FlatAABoxKDTree2d<LaneSegmentBox> kdtree(data.boxes, data.params());
+  const auto batches = Batches(data.points);
+  std::vector<const LaneSegmentBox*> nearest_objects;
+  for (auto _ : state) {
+    for (const auto& batch : batches) {
+      kdtree.GetNearestObjects(batch, &nearest_objects);
+      benchmark::DoNotOptimize(nearest_objects.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.points.size());
+}
+
+template <class KDTree>
+void BM_Objects(benchmark::State& state) {
+  const auto& data = LaneSegments::Instance(static_cast<int>(state.range(0)));
+  KDTree kdtree(data.boxes, data.params());
+  const double distance = static_cast<double>(state.range(1));
+  for (auto _ : state) {
+    for (const auto& point : data.points) {
+      benchmark::DoNotOptimize(kdtree.GetObjects(point, distance));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.points.size());
+}
+
+void BM_FlatObjectsBatch(benchmark::State& state) {
+  const auto& data = LaneSegments::Instance(static_cast<int>(state.range(0)));
+  FlatAABoxKDTree2d<LaneSegmentBox> kdtree(data.boxes, data.params());
+  const double distance = static_cast<double>(state.range(1));
+  const auto batches = Batches(data.points);
+  std::vector<std::vector<const LaneSegmentBox*>> objects;
+  for (auto _ : state) {
+    for (const auto& batch : batches) {
+      kdtree.GetObjects(batch, distance, &objects);
+      benchmark::DoNotOptimize(objects.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.points.size());
+}
+
+// state.range(0) is the number of copies of the map along each axis,
+// state.range(1) the search radius of the range queries.
+BENCHMARK_TEMPLATE(BM_NearestObject, AABoxKDTree2d<LaneSegmentBox>)
+    ->Arg(1)
+    ->Arg(8);
+BENCHMARK_TEMPLATE(BM_NearestObject, FlatAABoxKDTree2d<LaneSegmentBox>)
+    ->Arg(1)
+    ->Arg(8);
+BENCHMARK(BM_FlatNearestObjects)->Arg(1)->Arg(8);
+BENCHMARK_TEMPLATE(BM_Objects, AABoxKDTree2d<LaneSegmentBox>)
+    ->ArgsProduct({{1, 8}, {5, 50}});
+BENCHMARK_TEMPLATE(BM_Objects, FlatAABoxKDTree2d<LaneSegmentBox>)
+    ->ArgsProduct({{1, 8}, {5, 50}});
+BENCHMARK(BM_FlatObjectsBatch)->ArgsProduct({{1, 8}, {5, 50}});
+
+}  // namespace hdmap
+}  // namespace apollo
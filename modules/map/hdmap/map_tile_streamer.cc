@@ -0,0 +1,226 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/map/hdmap/map_tile_streamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace hdmap {
+
+using apollo::common::math::AABox2d;
+using apollo::common::math::Vec2d;
+
+MapTileStreamer::MapTileStreamer(const HDMapImpl* map, double tile_size,
+                                 double resident_radius,
+                                 double prefetch_distance)
+    : map_(map),
+      tile_size_(tile_size),
+      resident_radius_(resident_radius),
+      prefetch_distance_(prefetch_distance) {
+  CHECK_NOTNULL(map_);
+  CHECK_GT(tile_size_, 0.0);
+  thread_ = std::thread(&MapTileStreamer::Run, this);
+}
+
+MapTileStreamer::~MapTileStreamer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  update_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  for (const auto& tile : resident_tiles_) {
+    map_->UnpinArea(GetTileBox(tile));
+  }
+}
+
+void MapTileStreamer::UpdatePosition(const Vec2d& position) {
+  const TileId tile = GetTileId(position);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    position_ = position;
+    // the tiles only change when the vehicle enters another tile
+    if (has_position_ && tile == position_tile_) {
+      return;
+    }
+    has_position_ = true;
+    position_tile_ = tile;
+    pending_ = true;
+  }
+  update_cv_.notify_one();
+}
+
+void MapTileStreamer::SetRoute(std::vector<Vec2d> route) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    route_ = std::make_shared<const std::vector<Vec2d>>(std::move(route));
+    pending_ = has_position_;
+  }
+  update_cv_.notify_one();
+}
+
+void MapTileStreamer::WaitUntilIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cv_.wait(lock, [this] { return (!pending_ && !busy_) || stopped_; });
+}
+
+MapTileStreamer::Stats MapTileStreamer::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void MapTileStreamer::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    update_cv_.wait(lock, [this] { return pending_ || stopped_; });
+    if (stopped_) {
+      break;
+    }
+    pending_ = false;
+    busy_ = true;
+    const Vec2d position = position_;
+    auto route = route_;
+    lock.unlock();
+    UpdateTiles(position, route == nullptr ? std::vector<Vec2d>() : *route);
+    lock.lock();
+    busy_ = false;
+    idle_cv_.notify_all();
+  }
+  idle_cv_.notify_all();
+}
+
+void MapTileStreamer::UpdateTiles(const Vec2d& position,
+                                  const std::vector<Vec2d>& route) {
+  std::set<TileId> tiles;
+  AddTilesInRadius(position, resident_radius_, &tiles);
+  AddTilesOnRoute(position, route, &tiles);
+  // a tile is kept a bit longer than it is wanted, so driving along a tile
+  // border does not load and drop the same tiles over and over
+  std::set<TileId> kept_tiles;
+  AddTilesInRadius(position, resident_radius_ + tile_size_, &kept_tiles);
+
+  Stats stats;
+  std::vector<TileId> unloaded_tiles;
+  for (const auto& tile : resident_tiles_) {
+    if (tiles.count(tile) == 0 && kept_tiles.count(tile) == 0) {
+      unloaded_tiles.push_back(tile);
+    }
+  }
+  for (const auto& tile : unloaded_tiles) {
+    map_->UnpinArea(GetTileBox(tile));
+    resident_tiles_.erase(tile);
+  }
+  stats.num_unloaded_tiles = unloaded_tiles.size();
+  stats.num_evicted_objects = map_->EvictUnpinnedObjects();
+
+  // the tiles nearest to the vehicle are loaded first
+  std::vector<TileId> loaded_tiles;
+  for (const auto& tile : tiles) {
+    if (resident_tiles_.count(tile) == 0) {
+      loaded_tiles.push_back(tile);
+    }
+  }
+  std::sort(loaded_tiles.begin(), loaded_tiles.end(),
+            [this, &position](const TileId& lhs, const TileId& rhs) {
+              return GetTileBox(lhs).DistanceTo(position) <
+                     GetTileBox(rhs).DistanceTo(position);
+            });
+  for (const auto& tile : loaded_tiles) {
+    map_->PinArea(GetTileBox(tile));
+    resident_tiles_.insert(tile);
+  }
+  stats.num_loaded_tiles = loaded_tiles.size();
+  stats.num_resident_tiles = resident_tiles_.size();
+  ADEBUG << "Map tiles resident: " << stats.num_resident_tiles
+         << ", loaded: " << stats.num_loaded_tiles
+         << ", unloaded: " << stats.num_unloaded_tiles
+         << ", evicted objects: " << stats.num_evicted_objects;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.num_resident_tiles = stats.num_resident_tiles;
+  stats_.num_loaded_tiles += stats.num_loaded_tiles;
+  stats_.num_unloaded_tiles += stats.num_unloaded_tiles;
+  stats_.num_evicted_objects += stats.num_evicted_objects;
+}
+
+MapTileStreamer::TileId MapTileStreamer::GetTileId(const Vec2d& point) const {
+  return {static_cast<int64_t>(std::floor(point.x() / tile_size_)),
+          static_cast<int64_t>(std::floor(point.y() / tile_size_))};
+}
+
+AABox2d MapTileStreamer::GetTileBox(const TileId& tile) const {
+  const double min_x = static_cast<double>(tile.first) * tile_size_;
+  const double min_y = static_cast<double>(tile.second) * tile_size_;
+  return AABox2d({min_x, min_y}, {min_x + tile_size_, min_y + tile_size_});
+}
+
+void MapTileStreamer::AddTilesInRadius(const Vec2d& position, double radius,
+                                       std::set<TileId>* tiles) const {
+  const TileId min_tile = GetTileId(position - Vec2d(radius, radius));
+  const TileId max_tile = GetTileId(position + Vec2d(radius, radius));
+  for (int64_t x = min_tile.first; x <= max_tile.first; ++x) {
+    for (int64_t y = min_tile.second; y <= max_tile.second; ++y) {
+      const TileId tile(x, y);
+      if (GetTileBox(tile).DistanceTo(position) <= radius) {
+        tiles->insert(tile);
+      }
+    }
+  }
+}
+
+void MapTileStreamer::AddTilesOnRoute(const Vec2d& position,
+                                      const std::vector<Vec2d>& route,
+                                      std::set<TileId>* tiles) const {
+  if (route.empty()) {
+    return;
+  }
+  size_t start = 0;
+  double min_distance_sqr = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < route.size(); ++i) {
+    const double distance_sqr = route[i].DistanceSquareTo(position);
+    if (distance_sqr < min_distance_sqr) {
+      min_distance_sqr = distance_sqr;
+      start = i;
+    }
+  }
+  // walks the route in steps of half a tile so no tile it crosses is missed
+  const double step = tile_size_ * 0.5;
+  double distance = 0.0;
+  tiles->insert(GetTileId(route[start]));
+  for (size_t i = start + 1; i < route.size(); ++i) {
+    const Vec2d& from = route[i - 1];
+    const Vec2d& to = route[i];
+    const double length = from.DistanceTo(to);
+    for (double s = step; s < length; s += step) {
+      tiles->insert(GetTileId(from + (to - from) * (s / length)));
+    }
+    tiles->insert(GetTileId(to));
+    distance += length;
+    if (distance >= prefetch_distance_) {
+      break;
+    }
+  }
+}
+
+}  // namespace hdmap
+}  // namespace apollo
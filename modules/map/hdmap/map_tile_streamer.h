@@ -0,0 +1,128 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Defines the MapTileStreamer class, which keeps the objects of a flat
+ * map resident around the vehicle and along its route.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "modules/common/math/aabox2d.h"
+#include "modules/common/math/vec2d.h"
+#include "modules/map/hdmap/hdmap_impl.h"
+
+namespace apollo {
+namespace hdmap {
+
+/**
+ * @class MapTileStreamer
+ * @brief Splits the plane into square tiles. The tiles within a radius of the
+ * vehicle and along the route ahead of it are pinned in the map on a
+ * background thread, so their objects are built before planning asks for
+ * them, and the objects of tiles left behind are dropped. Queries outside of
+ * the resident tiles still work, they only build their objects on demand.
+ */
+class MapTileStreamer {
+ public:
+  struct Stats {
+    size_t num_resident_tiles = 0;
+    size_t num_loaded_tiles = 0;
+    size_t num_unloaded_tiles = 0;
+    size_t num_evicted_objects = 0;
+  };
+
+  /**
+   * @param map a map loaded from a flat map, which has to outlive the
+   * streamer
+   * @param tile_size side length of a tile
+   * @param resident_radius tiles within this distance of the position are
+   * resident
+   * @param prefetch_distance tiles along the route up to this distance ahead
+   * of the position are resident
+   */
+  MapTileStreamer(const HDMapImpl* map, double tile_size,
+                  double resident_radius, double prefetch_distance);
+  ~MapTileStreamer();
+
+  /**
+   * @brief set the position of the vehicle, the tiles are updated in the
+   * background when it moves to another tile
+   */
+  void UpdatePosition(const apollo::common::math::Vec2d& position);
+
+  /**
+   * @brief set the points of the route the vehicle follows, in order
+   */
+  void SetRoute(std::vector<apollo::common::math::Vec2d> route);
+
+  /**
+   * @brief block until the tiles for the last position and route are
+   * resident
+   */
+  void WaitUntilIdle();
+
+  Stats GetStats() const;
+
+ private:
+  using TileId = std::pair<int64_t, int64_t>;
+
+  void Run();
+  void UpdateTiles(const apollo::common::math::Vec2d& position,
+                   const std::vector<apollo::common::math::Vec2d>& route);
+  TileId GetTileId(const apollo::common::math::Vec2d& point) const;
+  apollo::common::math::AABox2d GetTileBox(const TileId& tile) const;
+  void AddTilesInRadius(const apollo::common::math::Vec2d& position,
+                        double radius, std::set<TileId>* tiles) const;
+  void AddTilesOnRoute(const apollo::common::math::Vec2d& position,
+                       const std::vector<apollo::common::math::Vec2d>& route,
+                       std::set<TileId>* tiles) const;
+
+  const HDMapImpl* map_ = nullptr;
+  const double tile_size_;
+  const double resident_radius_;
+  const double prefetch_distance_;
+
+  // only used by the background thread
+  std::set<TileId> resident_tiles_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable update_cv_;
+  std::condition_variable idle_cv_;
+  bool has_position_ = false;
+  apollo::common::math::Vec2d position_;
+  TileId position_tile_;
+  std::shared_ptr<const std::vector<apollo::common::math::Vec2d>> route_;
+  bool pending_ = false;
+  bool busy_ = false;
+  bool stopped_ = false;
+  Stats stats_;
+
+  std::thread thread_;
+};
+
+}  // namespace hdmap
+}  // namespace apollo
@@ -0,0 +1,136 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/map/hdmap/map_tile_streamer.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/file.h"
+#include "modules/map/hdmap/flat_map.h"
+
+namespace apollo {
+namespace hdmap {
+namespace {
+
+using apollo::common::math::Vec2d;
+
+constexpr char kMapFilename[] = "modules/map/hdmap/test-data/base_map.bin";
+constexpr char kFlatMapFilename[] = "/tmp/map_tile_streamer_test.flat";
+
+std::set<std::string> LaneIds(const std::vector<LaneInfoConstPtr>& lanes) {
+  std::set<std::string> ids;
+  for (const auto& lane : lanes) {
+    ids.insert(lane->id().id());
+  }
+  return ids;
+}
+
+apollo::common::PointENU ToPointENU(const Vec2d& point) {
+  apollo::common::PointENU result;
+  result.set_x(point.x());
+  result.set_y(point.y());
+  return result;
+}
+
+}  // namespace
+
+class MapTileStreamerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    Map map;
+    ASSERT_TRUE(cyber::common::GetProtoFromFile(kMapFilename, &map));
+    ASSERT_TRUE(FlatMap::Write(map, kFlatMapFilename));
+  }
+
+  void SetUp() override {
+    ASSERT_EQ(0, map_.LoadMapFromFile(kMapFilename));
+    ASSERT_EQ(0, flat_map_.LoadMapFromFile(kFlatMapFilename));
+    // follows the successors of a lane for a route of a few hundred meters
+    Id id;
+    id.set_id("1272_1_-1");
+    for (int i = 0; i < 20; ++i) {
+      const auto lane = map_.GetLaneById(id);
+      ASSERT_NE(nullptr, lane);
+      route_.insert(route_.end(), lane->points().begin(),
+                    lane->points().end());
+      if (lane->lane().successor_id().empty()) {
+        break;
+      }
+      id = lane->lane().successor_id(0);
+    }
+  }
+
+  HDMapImpl map_;
+  HDMapImpl flat_map_;
+  std::vector<Vec2d> route_;
+};
+
+TEST_F(MapTileStreamerTest, EvictBehind) {
+  MapTileStreamer streamer(&flat_map_, 50.0, 100.0, 0.0);
+  const Vec2d position = route_.front();
+  streamer.UpdatePosition(position);
+  streamer.WaitUntilIdle();
+  auto stats = streamer.GetStats();
+  const size_t num_tiles = stats.num_resident_tiles;
+  EXPECT_GT(num_tiles, 0);
+  EXPECT_EQ(num_tiles, stats.num_loaded_tiles);
+
+  // moving within the same tile does not change anything
+  streamer.UpdatePosition(position + Vec2d(0.1, 0.1));
+  streamer.WaitUntilIdle();
+  EXPECT_EQ(stats.num_loaded_tiles, streamer.GetStats().num_loaded_tiles);
+
+  std::vector<LaneInfoConstPtr> lanes;
+  ASSERT_EQ(0, flat_map_.GetLanes(ToPointENU(position), 50.0, &lanes));
+  ASSERT_FALSE(lanes.empty());
+  const LaneInfoConstPtr held_lane = lanes.front();
+  const std::set<std::string> lane_ids = LaneIds(lanes);
+  lanes.clear();
+
+  streamer.UpdatePosition(position + Vec2d(1.0e5, 1.0e5));
+  streamer.WaitUntilIdle();
+  stats = streamer.GetStats();
+  EXPECT_EQ(num_tiles, stats.num_unloaded_tiles);
+  EXPECT_GT(stats.num_evicted_objects, 0);
+
+  // objects still held are kept, dropped ones are built again
+  EXPECT_EQ(held_lane, flat_map_.GetLaneById(held_lane->id()));
+  ASSERT_EQ(0, flat_map_.GetLanes(ToPointENU(position), 50.0, &lanes));
+  EXPECT_EQ(lane_ids, LaneIds(lanes));
+  std::vector<LaneInfoConstPtr> expected_lanes;
+  ASSERT_EQ(0, map_.GetLanes(ToPointENU(position), 50.0, &expected_lanes));
+  EXPECT_EQ(LaneIds(expected_lanes), LaneIds(lanes));
+}
+
+TEST_F(MapTileStreamerTest, PrefetchRoute) {
+  MapTileStreamer streamer(&flat_map_, 20.0, 10.0, 0.0);
+  streamer.UpdatePosition(route_.front());
+  streamer.WaitUntilIdle();
+  const size_t num_tiles = streamer.GetStats().num_resident_tiles;
+
+  MapTileStreamer route_streamer(&flat_map_, 20.0, 10.0, 1.0e4);
+  route_streamer.SetRoute(route_);
+  route_streamer.UpdatePosition(route_.front());
+  route_streamer.WaitUntilIdle();
+  EXPECT_GT(route_streamer.GetStats().num_resident_tiles, num_tiles);
+}
+
+}  // namespace hdmap
+}  // namespace apollo
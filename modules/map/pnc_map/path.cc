@@ -832,29 +832,83 @@ bool Path::GetProjectionWithHueristicParams(const Vec2d& point,
     }
   }
   *min_distance = std::sqrt(*min_distance);
-  const auto& nearest_seg = segments_[min_index];
+  ProjectOntoSegment(point, min_index, *min_distance, accumulate_s, lateral);
+  return true;
+}
+
+bool Path::GetProjectionsAlongPath(const std::vector<Vec2d>& points,
+                                   const double hueristic_start_s,
+                                   const double hueristic_end_s,
+                                   std::vector<double>* accumulate_s,
+                                   std::vector<double>* lateral) const {
+  if (segments_.empty()) {
+    return false;
+  }
+  if (accumulate_s == nullptr || lateral == nullptr) {
+    return false;
+  }
+  accumulate_s->resize(points.size());
+  lateral->resize(points.size());
+  if (points.empty()) {
+    return true;
+  }
+  double min_distance = 0.0;
+  GetProjectionWithHueristicParams(points[0], hueristic_start_s,
+                                   hueristic_end_s, &(*accumulate_s)[0],
+                                   &(*lateral)[0], &min_distance);
+  int index =
+      std::min(GetIndexFromS((*accumulate_s)[0]).id, num_segments_ - 1);
+  for (size_t i = 1; i < points.size(); ++i) {
+    const Vec2d& point = points[i];
+    // walk from the segment of the last point to the nearest one around it
+    double distance = segments_[index].DistanceSquareTo(point);
+    while (index > 0) {
+      const double prev_distance = segments_[index - 1].DistanceSquareTo(point);
+      if (prev_distance > distance) {
+        break;
+      }
+      --index;
+      distance = prev_distance;
+    }
+    while (index + 1 < num_segments_) {
+      const double next_distance = segments_[index + 1].DistanceSquareTo(point);
+      if (next_distance >= distance) {
+        break;
+      }
+      ++index;
+      distance = next_distance;
+    }
+    ProjectOntoSegment(point, index, std::sqrt(distance), &(*accumulate_s)[i],
+                       &(*lateral)[i]);
+  }
+  return true;
+}
+
+void Path::ProjectOntoSegment(const Vec2d& point, const int index,
+                              const double distance, double* accumulate_s,
+                              double* lateral) const {
+  const auto& nearest_seg = segments_[index];
   const auto prod = nearest_seg.ProductOntoUnit(point);
   const auto proj = nearest_seg.ProjectOntoUnit(point);
-  if (min_index == 0) {
+  if (index == 0) {
     *accumulate_s = std::min(proj, nearest_seg.length());
     if (proj < 0) {
       *lateral = prod;
     } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+      *lateral = (prod > 0.0 ? 1 : -1) * distance;
     }
-  } else if (min_index == num_segments_ - 1) {
-    *accumulate_s = accumulated_s_[min_index] + std::max(0.0, proj);
+  } else if (index == num_segments_ - 1) {
+    *accumulate_s = accumulated_s_[index] + std::max(0.0, proj);
     if (proj > 0) {
       *lateral = prod;
     } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+      *lateral = (prod > 0.0 ? 1 : -1) * distance;
     }
   } else {
-    *accumulate_s = accumulated_s_[min_index] +
+    *accumulate_s = accumulated_s_[index] +
                     std::max(0.0, std::min(proj, nearest_seg.length()));
-    *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+    *lateral = (prod > 0.0 ? 1 : -1) * distance;
   }
-  return true;
 }
 
 bool Path::GetProjection(const Vec2d& point, double* accumulate_s,
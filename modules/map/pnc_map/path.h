@@ -254,6 +254,15 @@ class Path {
                                         const double hueristic_end_s,
                                         double* accumulate_s, double* lateral,
                                         double* min_distance) const;
+  // Projects points which move along the path, like the points of a
+  // trajectory, in one pass. The first point is searched in the heuristic
+  // range of s and each of the others from the segment of the point before
+  // it, walking to the neighbouring segments while they are closer.
+  bool GetProjectionsAlongPath(const std::vector<common::math::Vec2d>& points,
+                               const double hueristic_start_s,
+                               const double hueristic_end_s,
+                               std::vector<double>* accumulate_s,
+                               std::vector<double>* lateral) const;
   bool GetProjection(const common::math::Vec2d& point, double* accumulate_s,
                      double* lateral) const;
 
@@ -406,6 +415,18 @@ class Path {
    */
   void FindIndex(int left_index, int right_index, double target_s,
                  int* mid_index) const;
+
+  /**
+   * @brief Project the point onto the segment nearest to it.
+   * @param point The point to project.
+   * @param index The index of the nearest segment.
+   * @param distance The distance from the point to the segment.
+   * @param accumulate_s The s of the projection.
+   * @param lateral The l of the projection.
+   */
+  void ProjectOntoSegment(const common::math::Vec2d& point, const int index,
+                          const double distance, double* accumulate_s,
+                          double* lateral) const;
 };
 
 }  // namespace hdmap
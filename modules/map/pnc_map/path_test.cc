@@ -16,6 +16,7 @@
 
 #include "modules/map/pnc_map/path.h"
 
+#include <algorithm>
 #include <string>
 
 #include "absl/strings/str_cat.h"
@@ -648,6 +649,65 @@ TEST(TestSuite, hdmap_s_path) {
   }
 }
 
+TEST(TestSuite, hdmap_path_get_projections_along_path) {
+  const double kRadius = 50.0;
+  const int kNumSegments = 100;
+  std::vector<MapPathPoint> points;
+  for (int i = 0; i <= kNumSegments; ++i) {
+    const double p =
+        M_PI_2 * static_cast<double>(i) / static_cast<double>(kNumSegments);
+    points.push_back(MakeMapPathPoint(kRadius * cos(p), kRadius * sin(p)));
+  }
+  const Path path(points);
+  const double total_length = path.accumulated_s().back();
+
+  // a trajectory outside of the circle, moving along it and away from it
+  std::vector<Vec2d> trajectory;
+  for (int i = 0; i <= 80; ++i) {
+    const double p = M_PI_2 * (static_cast<double>(i) / 80.0 * 1.2 - 0.1);
+    const double radius = kRadius + 1.0 + 0.05 * i;
+    trajectory.emplace_back(radius * cos(p), radius * sin(p));
+  }
+  std::vector<double> accumulate_s;
+  std::vector<double> lateral;
+  EXPECT_TRUE(path.GetProjectionsAlongPath(trajectory, 0.0, total_length,
+                                           &accumulate_s, &lateral));
+  ASSERT_EQ(accumulate_s.size(), trajectory.size());
+  ASSERT_EQ(lateral.size(), trajectory.size());
+  for (size_t i = 0; i < trajectory.size(); ++i) {
+    double other_accumulate_s;
+    double other_lateral;
+    double distance;
+    EXPECT_TRUE(path.GetProjectionWithHueristicParams(
+        trajectory[i], 0.0, total_length, &other_accumulate_s, &other_lateral,
+        &distance));
+    EXPECT_NEAR(accumulate_s[i], other_accumulate_s, 1e-6);
+    EXPECT_NEAR(lateral[i], other_lateral, 1e-6);
+  }
+  EXPECT_LT(accumulate_s.front(), 0.0);
+  EXPECT_GT(accumulate_s.back(), total_length);
+
+  // a trajectory going back along the circle
+  std::reverse(trajectory.begin(), trajectory.end());
+  EXPECT_TRUE(path.GetProjectionsAlongPath(trajectory, 0.0, total_length,
+                                           &accumulate_s, &lateral));
+  for (size_t i = 0; i < trajectory.size(); ++i) {
+    double other_accumulate_s;
+    double other_lateral;
+    double distance;
+    EXPECT_TRUE(path.GetProjectionWithHueristicParams(
+        trajectory[i], 0.0, total_length, &other_accumulate_s, &other_lateral,
+        &distance));
+    EXPECT_NEAR(accumulate_s[i], other_accumulate_s, 1e-6);
+    EXPECT_NEAR(lateral[i], other_lateral, 1e-6);
+  }
+
+  EXPECT_TRUE(path.GetProjectionsAlongPath({}, 0.0, total_length,
+                                           &accumulate_s, &lateral));
+  EXPECT_TRUE(accumulate_s.empty());
+  EXPECT_TRUE(lateral.empty());
+}
+
 TEST(TestSuite, hdmap_path_get_smooth_point) {
   const double kRadius = 50.0;
   const int kNumSegments = 100;
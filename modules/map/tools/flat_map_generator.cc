@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "absl/strings/match.h"
+#include "gflags/gflags.h"
+
+#include "modules/common_msgs/map_msgs/map.pb.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+#include "modules/map/hdmap/adapter/opendrive_adapter.h"
+#include "modules/map/hdmap/flat_map.h"
+#include "modules/map/hdmap/hdmap_util.h"
+
+/**
+ * A map tool to compile a .xml, .bin or .txt map to a .flat map, which
+ * HDMap loads with mmap and builds objects from on first access.
+ */
+
+DEFINE_string(input_map, "base_map.bin", "map file in map_dir to compile");
+DEFINE_string(output_dir, "/tmp", "output map directory");
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_alsologtostderr = true;
+
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  const auto map_filename = FLAGS_map_dir + "/" + FLAGS_input_map;
+  apollo::hdmap::Map pb_map;
+  bool loaded = false;
+  if (absl::EndsWith(map_filename, ".xml")) {
+    loaded = apollo::hdmap::adapter::OpendriveAdapter::LoadData(map_filename,
+                                                                &pb_map);
+  } else {
+    loaded = apollo::cyber::common::GetProtoFromFile(map_filename, &pb_map);
+  }
+  if (!loaded) {
+    AERROR << "Failed to load map from " << map_filename;
+    return -1;
+  }
+  AINFO << "Loaded map from " << map_filename;
+
+  const std::string output_flat_file = FLAGS_output_dir + "/base_map.flat";
+  if (!apollo::hdmap::FlatMap::Write(pb_map, output_flat_file)) {
+    AERROR << "Failed to generate flat base map";
+    return -1;
+  }
+
+  ACHECK(apollo::hdmap::FlatMap::Open(output_flat_file) != nullptr)
+      << "Failed to load generated flat base map";
+
+  AINFO << "Successfully compiled map to flat map: " << output_flat_file;
+
+  return 0;
+}
@@ -21,9 +21,11 @@
 #include "modules/planning/planners/lattice/trajectory_generation/trajectory_evaluator.h"
 
 #include <algorithm>
+#include <future>
 #include <limits>
 
 #include "cyber/common/log.h"
+#include "cyber/task/task.h"
 #include "modules/common/math/path_matcher.h"
 #include "modules/planning/planners/lattice/trajectory_generation/piecewise_braking_trajectory_generator.h"
 #include "modules/planning/planning_base/common/trajectory1d/piecewise_acceleration_trajectory1d.h"
@@ -48,7 +50,8 @@ TrajectoryEvaluator::TrajectoryEvaluator(
     const std::vector<PtrTrajectory1d>& lat_trajectories,
     std::shared_ptr<PathTimeGraph> path_time_graph,
     std::shared_ptr<std::vector<PathPoint>> reference_line)
-    : path_time_graph_(path_time_graph),
+    : lat_trajectories_(lat_trajectories),
+      path_time_graph_(path_time_graph),
       reference_line_(reference_line),
       init_s_(init_s) {
   const double start_time = 0.0;
@@ -74,19 +77,63 @@ TrajectoryEvaluator::TrajectoryEvaluator(
     if (!ConstraintChecker1d::IsValidLongitudinalTrajectory(*lon_trajectory)) {
       continue;
     }
+    /**
+     * The validity of the code needs to be verified.
     for (const auto& lat_trajectory : lat_trajectories) {
-      /**
-       * The validity of the code needs to be verified.
       if (!ConstraintChecker1d::IsValidLateralTrajectory(*lat_trajectory,
                                                          *lon_trajectory)) {
         continue;
       }
-      */
-      double cost = Evaluate(planning_target, lon_trajectory, lat_trajectory);
-      cost_queue_.emplace(Trajectory1dPair(lon_trajectory, lat_trajectory),
-                          cost);
     }
+    */
+    lon_trajectories_.push_back(lon_trajectory);
   }
+
+  for (double s = 0.0; s < FLAGS_speed_lon_decision_horizon;
+       s += FLAGS_trajectory_space_resolution) {
+    lat_offset_s_values_.emplace_back(s);
+  }
+  const size_t num_lat_trajectories = lat_trajectories_.size();
+  lat_offset_cost_sqr_sums_.resize(num_lat_trajectories);
+  lat_offset_cost_abs_sums_.resize(num_lat_trajectories);
+  for (size_t i = 0; i < num_lat_trajectories; ++i) {
+    TabulateLatOffsetCosts(lat_trajectories_[i], &lat_offset_cost_sqr_sums_[i],
+                           &lat_offset_cost_abs_sums_[i]);
+  }
+
+  const size_t num_lon_trajectories = lon_trajectories_.size();
+  lon_samples_.resize(num_lon_trajectories);
+  std::vector<PairCost> pairs(num_lon_trajectories * num_lat_trajectories);
+  const auto evaluate_lon_trajectories = [this, &planning_target, &pairs,
+                                          num_lat_trajectories](
+                                             const size_t begin,
+                                             const size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      EvaluateLonTrajectory(planning_target, i,
+                            pairs.data() + i * num_lat_trajectories);
+    }
+  };
+  if (FLAGS_enable_parallel_lattice_trajectory_evaluation) {
+    static constexpr size_t kNumLonTrajectoriesPerTask = 4;
+    std::vector<std::future<void>> results;
+    for (size_t begin = kNumLonTrajectoriesPerTask;
+         begin < num_lon_trajectories; begin += kNumLonTrajectoriesPerTask) {
+      results.push_back(cyber::Async(
+          evaluate_lon_trajectories, begin,
+          std::min(begin + kNumLonTrajectoriesPerTask, num_lon_trajectories)));
+    }
+    evaluate_lon_trajectories(
+        0, std::min(kNumLonTrajectoriesPerTask, num_lon_trajectories));
+    for (auto& result : results) {
+      result.get();
+    }
+  } else {
+    evaluate_lon_trajectories(0, num_lon_trajectories);
+  }
+  cost_queue_ =
+      std::priority_queue<PairCost, std::vector<PairCost>, CostComparator>(
+          CostComparator(), std::move(pairs));
+  EvaluateTopTrajectoryPair();
   ADEBUG << "Number of valid 1d trajectory pairs: " << cost_queue_.size();
 }
 
@@ -103,24 +150,25 @@ TrajectoryEvaluator::next_top_trajectory_pair() {
   ACHECK(has_more_trajectory_pairs());
   auto top = cost_queue_.top();
   cost_queue_.pop();
-  return top.first;
+  EvaluateTopTrajectoryPair();
+  return Trajectory1dPair(lon_trajectories_[top.lon_index],
+                          lat_trajectories_[top.lat_index]);
 }
 
 double TrajectoryEvaluator::top_trajectory_pair_cost() const {
-  return cost_queue_.top().second;
+  return cost_queue_.top().cost;
 }
 
-double TrajectoryEvaluator::Evaluate(
-    const PlanningTarget& planning_target,
-    const PtrTrajectory1d& lon_trajectory,
-    const PtrTrajectory1d& lat_trajectory,
-    std::vector<double>* cost_components) const {
+void TrajectoryEvaluator::EvaluateLonTrajectory(
+    const PlanningTarget& planning_target, const size_t lon_index,
+    PairCost* pairs) {
   // Costs:
   // 1. Cost of missing the objective, e.g., cruise, stop, etc.
   // 2. Cost of longitudinal jerk
   // 3. Cost of longitudinal collision
   // 4. Cost of lateral offsets
   // 5. Cost of lateral comfort
+  const auto& lon_trajectory = lon_trajectories_[lon_index];
 
   // Longitudinal costs
   double lon_objective_cost =
@@ -132,43 +180,64 @@ double TrajectoryEvaluator::Evaluate(
 
   double centripetal_acc_cost = CentripetalAccelerationCost(lon_trajectory);
 
+  const double lon_cost =
+      lon_objective_cost * FLAGS_weight_lon_objective +
+      lon_jerk_cost * FLAGS_weight_lon_jerk +
+      lon_collision_cost * FLAGS_weight_lon_collision +
+      centripetal_acc_cost * FLAGS_weight_centripetal_acceleration;
+
   // decides the longitudinal evaluation horizon for lateral trajectories.
   double evaluation_horizon =
       std::min(FLAGS_speed_lon_decision_horizon,
                lon_trajectory->Evaluate(0, lon_trajectory->ParamLength()));
-  std::vector<double> s_values;
-  for (double s = 0.0; s < evaluation_horizon;
-       s += FLAGS_trajectory_space_resolution) {
-    s_values.emplace_back(s);
-  }
-
-  // Lateral costs
-  double lat_offset_cost = LatOffsetCost(lat_trajectory, s_values);
+  const size_t num_s_values =
+      std::lower_bound(lat_offset_s_values_.begin(),
+                       lat_offset_s_values_.end(), evaluation_horizon) -
+      lat_offset_s_values_.begin();
 
-  double lat_comfort_cost = LatComfortCost(lon_trajectory, lat_trajectory);
+  auto& lon_samples = lon_samples_[lon_index];
+  for (double t = 0.0; t < FLAGS_trajectory_time_length;
+       t += FLAGS_trajectory_time_resolution) {
+    lon_samples.relative_s.push_back(lon_trajectory->Evaluate(0, t) -
+                                     init_s_[0]);
+    lon_samples.s_dot.push_back(lon_trajectory->Evaluate(1, t));
+    lon_samples.s_dotdot.push_back(lon_trajectory->Evaluate(2, t));
+  }
 
-  if (cost_components != nullptr) {
-    cost_components->emplace_back(lon_objective_cost);
-    cost_components->emplace_back(lon_jerk_cost);
-    cost_components->emplace_back(lon_collision_cost);
-    cost_components->emplace_back(lat_offset_cost);
+  // Lateral costs, but the comfort cost which depends on both trajectories
+  for (size_t i = 0; i < lat_trajectories_.size(); ++i) {
+    pairs[i].lon_index = lon_index;
+    pairs[i].lat_index = i;
+    pairs[i].cost = lon_cost + LatOffsetCost(i, num_s_values) *
+                                   FLAGS_weight_lat_offset;
   }
+}
 
-  return lon_objective_cost * FLAGS_weight_lon_objective +
-         lon_jerk_cost * FLAGS_weight_lon_jerk +
-         lon_collision_cost * FLAGS_weight_lon_collision +
-         centripetal_acc_cost * FLAGS_weight_centripetal_acceleration +
-         lat_offset_cost * FLAGS_weight_lat_offset +
-         lat_comfort_cost * FLAGS_weight_lat_comfort;
+void TrajectoryEvaluator::EvaluateTopTrajectoryPair() {
+  // The lateral comfort cost is not negative, so a complete cost at the top
+  // is not larger than any lower bound in the queue.
+  while (!cost_queue_.empty() && cost_queue_.top().is_lower_bound) {
+    auto top = cost_queue_.top();
+    cost_queue_.pop();
+    top.cost += LatComfortCost(lon_samples_[top.lon_index],
+                               lat_trajectories_[top.lat_index]) *
+                FLAGS_weight_lat_comfort;
+    top.is_lower_bound = false;
+    cost_queue_.push(top);
+  }
 }
 
-double TrajectoryEvaluator::LatOffsetCost(
-    const PtrTrajectory1d& lat_trajectory,
-    const std::vector<double>& s_values) const {
+void TrajectoryEvaluator::TabulateLatOffsetCosts(
+    const PtrTrajectory1d& lat_trajectory, std::vector<double>* cost_sqr_sums,
+    std::vector<double>* cost_abs_sums) const {
   double lat_offset_start = lat_trajectory->Evaluate(0, 0.0);
   double cost_sqr_sum = 0.0;
   double cost_abs_sum = 0.0;
-  for (const auto& s : s_values) {
+  cost_sqr_sums->reserve(lat_offset_s_values_.size() + 1);
+  cost_abs_sums->reserve(lat_offset_s_values_.size() + 1);
+  cost_sqr_sums->push_back(cost_sqr_sum);
+  cost_abs_sums->push_back(cost_abs_sum);
+  for (const auto& s : lat_offset_s_values_) {
     double lat_offset = lat_trajectory->Evaluate(0, s);
     double cost = lat_offset / FLAGS_lat_offset_bound;
     if (lat_offset * lat_offset_start < 0.0) {
@@ -178,21 +247,27 @@ double TrajectoryEvaluator::LatOffsetCost(
       cost_sqr_sum += cost * cost * FLAGS_weight_same_side_offset;
       cost_abs_sum += std::fabs(cost) * FLAGS_weight_same_side_offset;
     }
+    cost_sqr_sums->push_back(cost_sqr_sum);
+    cost_abs_sums->push_back(cost_abs_sum);
   }
-  return cost_sqr_sum / (cost_abs_sum + FLAGS_numerical_epsilon);
+}
+
+double TrajectoryEvaluator::LatOffsetCost(const size_t lat_index,
+                                          const size_t num_s_values) const {
+  return lat_offset_cost_sqr_sums_[lat_index][num_s_values] /
+         (lat_offset_cost_abs_sums_[lat_index][num_s_values] +
+          FLAGS_numerical_epsilon);
 }
 
 double TrajectoryEvaluator::LatComfortCost(
-    const PtrTrajectory1d& lon_trajectory,
+    const LonSamples& lon_samples,
     const PtrTrajectory1d& lat_trajectory) const {
   double max_cost = 0.0;
-  for (double t = 0.0; t < FLAGS_trajectory_time_length;
-       t += FLAGS_trajectory_time_resolution) {
-    double s = lon_trajectory->Evaluate(0, t);
-    double s_dot = lon_trajectory->Evaluate(1, t);
-    double s_dotdot = lon_trajectory->Evaluate(2, t);
+  for (size_t i = 0; i < lon_samples.relative_s.size(); ++i) {
+    double s_dot = lon_samples.s_dot[i];
+    double s_dotdot = lon_samples.s_dotdot[i];
 
-    double relative_s = s - init_s_[0];
+    double relative_s = lon_samples.relative_s[i];
     double l_prime = lat_trajectory->Evaluate(1, relative_s);
     double l_primeprime = lat_trajectory->Evaluate(2, relative_s);
     double cost = l_primeprime * s_dot * s_dot + l_prime * s_dotdot;
@@ -20,12 +20,15 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <queue>
 #include <utility>
 #include <vector>
 
+#include "gtest/gtest_prod.h"
+
 #include "modules/planning/planning_base/proto/lattice_structure.pb.h"
 #include "modules/planning/planning_base/proto/planning_config.pb.h"
 
@@ -36,11 +39,6 @@ namespace apollo {
 namespace planning {
 
 class TrajectoryEvaluator {
-  // normal use
-  typedef std::pair<
-      std::pair<std::shared_ptr<Curve1d>, std::shared_ptr<Curve1d>>, double>
-      PairCost;
-
   // auto tuning
   typedef std::pair<
       std::pair<std::shared_ptr<Curve1d>, std::shared_ptr<Curve1d>>,
@@ -70,15 +68,45 @@ class TrajectoryEvaluator {
   std::vector<double> top_trajectory_pair_component_cost() const;
 
  private:
-  double Evaluate(const PlanningTarget& planning_target,
-                  const std::shared_ptr<Curve1d>& lon_trajectory,
-                  const std::shared_ptr<Curve1d>& lat_trajectory,
-                  std::vector<double>* cost_components = nullptr) const;
+  FRIEND_TEST(TrajectoryEvaluatorTest, EvaluateAllPairs);
+
+  // A trajectory pair in the cost queue. Its cost is a lower bound without
+  // the lateral comfort cost until the pair comes to the top of the queue,
+  // so only the pairs which are taken out of it are evaluated completely.
+  struct PairCost {
+    size_t lon_index = 0;
+    size_t lat_index = 0;
+    double cost = 0.0;
+    bool is_lower_bound = true;
+  };
+
+  // The longitudinal trajectory sampled at the trajectory time resolution for
+  // the lateral comfort cost.
+  struct LonSamples {
+    std::vector<double> relative_s;
+    std::vector<double> s_dot;
+    std::vector<double> s_dotdot;
+  };
+
+  // Evaluates the costs of the longitudinal trajectory, and the lower bounds
+  // of the costs of its pairs with all the lateral trajectories.
+  void EvaluateLonTrajectory(const PlanningTarget& planning_target,
+                             const size_t lon_index, PairCost* pairs);
+
+  // Adds the lateral comfort costs to the pairs at the top of the queue until
+  // the cost of the top pair is complete.
+  void EvaluateTopTrajectoryPair();
 
-  double LatOffsetCost(const std::shared_ptr<Curve1d>& lat_trajectory,
-                       const std::vector<double>& s_values) const;
+  // Tabulates the sums of the lateral offset costs of the lateral trajectory
+  // over the s values of the longitudinal evaluation horizons.
+  void TabulateLatOffsetCosts(const std::shared_ptr<Curve1d>& lat_trajectory,
+                              std::vector<double>* cost_sqr_sums,
+                              std::vector<double>* cost_abs_sums) const;
 
-  double LatComfortCost(const std::shared_ptr<Curve1d>& lon_trajectory,
+  double LatOffsetCost(const size_t lat_index,
+                       const size_t num_s_values) const;
+
+  double LatComfortCost(const LonSamples& lon_samples,
                         const std::shared_ptr<Curve1d>& lat_trajectory) const;
 
   double LonComfortCost(const std::shared_ptr<Curve1d>& lon_trajectory) const;
@@ -102,13 +130,28 @@ class TrajectoryEvaluator {
   struct CostComparator
       : public std::binary_function<const PairCost&, const PairCost&, bool> {
     bool operator()(const PairCost& left, const PairCost& right) const {
-      return left.second > right.second;
+      return left.cost > right.cost;
     }
   };
 
   std::priority_queue<PairCost, std::vector<PairCost>, CostComparator>
       cost_queue_;
 
+  std::vector<std::shared_ptr<Curve1d>> lon_trajectories_;
+
+  std::vector<std::shared_ptr<Curve1d>> lat_trajectories_;
+
+  std::vector<LonSamples> lon_samples_;
+
+  // the s values at which the lateral offset costs are evaluated
+  std::vector<double> lat_offset_s_values_;
+
+  // lat_offset_cost_sqr_sums_[i][k] is the sum over the first k s values of
+  // the i-th lateral trajectory, the same for the abs sums.
+  std::vector<std::vector<double>> lat_offset_cost_sqr_sums_;
+
+  std::vector<std::vector<double>> lat_offset_cost_abs_sums_;
+
   std::shared_ptr<PathTimeGraph> path_time_graph_;
 
   std::shared_ptr<std::vector<apollo::common::PathPoint>> reference_line_;
@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/planning/planners/lattice/trajectory_generation/lattice_trajectory1d.h"
+#include "modules/planning/planners/lattice/trajectory_generation/trajectory_evaluator.h"
+#include "modules/planning/planning_base/gflags/planning_gflags.h"
+#include "modules/planning/planning_base/math/curve1d/quartic_polynomial_curve1d.h"
+#include "modules/planning/planning_base/math/curve1d/quintic_polynomial_curve1d.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::PathPoint;
+
+namespace {
+
+struct Scenario {
+  std::array<double, 3> init_s{{0.0, 8.0, 0.0}};
+  PlanningTarget planning_target;
+  std::vector<std::shared_ptr<Curve1d>> lon_trajectories;
+  std::vector<std::shared_ptr<Curve1d>> lat_trajectories;
+  std::shared_ptr<PathTimeGraph> path_time_graph;
+  std::shared_ptr<std::vector<PathPoint>> reference_line;
+};
+
+// The bundles of the lattice planner cruising on a gently curved road
+// without obstacles, with the lateral trajectories sampled instead of
+// optimized: 9 end speeds x 8 end times by 5 end offsets x 4 end s.
+Scenario MakeScenario() {
+  Scenario scenario;
+  scenario.planning_target.set_cruise_speed(10.0);
+
+  scenario.reference_line = std::make_shared<std::vector<PathPoint>>();
+  const double kappa = 0.002;
+  for (int i = 0; i <= 300; ++i) {
+    const double s = static_cast<double>(i);
+    PathPoint point;
+    point.set_x(std::sin(kappa * s) / kappa);
+    point.set_y((1.0 - std::cos(kappa * s)) / kappa);
+    point.set_theta(kappa * s);
+    point.set_kappa(kappa);
+    point.set_s(s);
+    scenario.reference_line->push_back(point);
+  }
+  scenario.path_time_graph = std::make_shared<PathTimeGraph>(
+      std::vector<const Obstacle*>(), *scenario.reference_line, nullptr,
+      scenario.init_s[0], FLAGS_speed_lon_decision_horizon, 0.0,
+      FLAGS_trajectory_time_length, std::array<double, 3>{{0.5, 0.0, 0.0}});
+
+  for (int i = 0; i <= 8; ++i) {
+    for (int j = 1; j <= 8; ++j) {
+      const double v = 2.0 * static_cast<double>(i);
+      const double t = static_cast<double>(j);
+      auto lon_trajectory = std::make_shared<LatticeTrajectory1d>(
+          std::make_shared<QuarticPolynomialCurve1d>(
+              scenario.init_s, std::array<double, 2>{{v, 0.0}}, t));
+      lon_trajectory->set_target_velocity(v);
+      lon_trajectory->set_target_time(t);
+      scenario.lon_trajectories.push_back(lon_trajectory);
+    }
+  }
+  for (const double d : {-1.0, -0.5, 0.0, 0.5, 1.0}) {
+    for (const double s : {10.0, 20.0, 40.0, 80.0}) {
+      auto lat_trajectory = std::make_shared<LatticeTrajectory1d>(
+          std::make_shared<QuinticPolynomialCurve1d>(
+              std::array<double, 3>{{0.5, 0.0, 0.0}},
+              std::array<double, 3>{{d, 0.0, 0.0}}, s));
+      lat_trajectory->set_target_position(d);
+      lat_trajectory->set_target_time(s);
+      scenario.lat_trajectories.push_back(lat_trajectory);
+    }
+  }
+  return scenario;
+}
+
+}  // namespace
+
+// The usual planning cycle, in which the best pair is collision free and
+// valid.
+void BM_EvaluateTopPair(benchmark::State& state) {
+  const Scenario scenario = MakeScenario();
+  for (auto _ : state) {
+    TrajectoryEvaluator evaluator(
+        scenario.init_s, scenario.planning_target, scenario.lon_trajectories,
+        scenario.lat_trajectories, scenario.path_time_graph,
+        scenario.reference_line);
+    benchmark::DoNotOptimize(evaluator.next_top_trajectory_pair());
+  }
+}
+BENCHMARK(BM_EvaluateTopPair)->Unit(benchmark::kMicrosecond);
+
+// Taking all the pairs evaluates each of them completely, which the
+// evaluator used to do for every planning cycle.
+void BM_EvaluateAllPairs(benchmark::State& state) {
+  const Scenario scenario = MakeScenario();
+  for (auto _ : state) {
+    TrajectoryEvaluator evaluator(
+        scenario.init_s, scenario.planning_target, scenario.lon_trajectories,
+        scenario.lat_trajectories, scenario.path_time_graph,
+        scenario.reference_line);
+    while (evaluator.has_more_trajectory_pairs()) {
+      benchmark::DoNotOptimize(evaluator.next_top_trajectory_pair());
+    }
+  }
+}
+BENCHMARK(BM_EvaluateAllPairs)->Unit(benchmark::kMicrosecond);
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,217 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/planners/lattice/trajectory_generation/trajectory_evaluator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/planners/lattice/trajectory_generation/lattice_trajectory1d.h"
+#include "modules/planning/planning_base/gflags/planning_gflags.h"
+#include "modules/planning/planning_base/math/curve1d/quartic_polynomial_curve1d.h"
+#include "modules/planning/planning_base/math/curve1d/quintic_polynomial_curve1d.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::PathPoint;
+
+namespace {
+
+using Trajectory1dPair =
+    std::pair<std::shared_ptr<Curve1d>, std::shared_ptr<Curve1d>>;
+
+// The lateral offset cost of the pair over the longitudinal evaluation
+// horizon, computed point by point.
+double LatOffsetCost(const std::shared_ptr<Curve1d>& lon_trajectory,
+                     const std::shared_ptr<Curve1d>& lat_trajectory) {
+  const double evaluation_horizon =
+      std::min(FLAGS_speed_lon_decision_horizon,
+               lon_trajectory->Evaluate(0, lon_trajectory->ParamLength()));
+  const double lat_offset_start = lat_trajectory->Evaluate(0, 0.0);
+  double cost_sqr_sum = 0.0;
+  double cost_abs_sum = 0.0;
+  for (double s = 0.0; s < evaluation_horizon;
+       s += FLAGS_trajectory_space_resolution) {
+    const double lat_offset = lat_trajectory->Evaluate(0, s);
+    const double cost = lat_offset / FLAGS_lat_offset_bound;
+    const double weight = lat_offset * lat_offset_start < 0.0
+                              ? FLAGS_weight_opposite_side_offset
+                              : FLAGS_weight_same_side_offset;
+    cost_sqr_sum += cost * cost * weight;
+    cost_abs_sum += std::fabs(cost) * weight;
+  }
+  return cost_sqr_sum / (cost_abs_sum + FLAGS_numerical_epsilon);
+}
+
+// The lateral comfort cost of the pair, computed from both trajectories.
+double LatComfortCost(const double init_s,
+                      const std::shared_ptr<Curve1d>& lon_trajectory,
+                      const std::shared_ptr<Curve1d>& lat_trajectory) {
+  double max_cost = 0.0;
+  for (double t = 0.0; t < FLAGS_trajectory_time_length;
+       t += FLAGS_trajectory_time_resolution) {
+    const double s_dot = lon_trajectory->Evaluate(1, t);
+    const double s_dotdot = lon_trajectory->Evaluate(2, t);
+    const double relative_s = lon_trajectory->Evaluate(0, t) - init_s;
+    const double l_prime = lat_trajectory->Evaluate(1, relative_s);
+    const double l_primeprime = lat_trajectory->Evaluate(2, relative_s);
+    const double cost = l_primeprime * s_dot * s_dot + l_prime * s_dotdot;
+    max_cost = std::max(max_cost, std::fabs(cost));
+  }
+  return max_cost;
+}
+
+}  // namespace
+
+class TrajectoryEvaluatorTest : public ::testing::Test {
+ public:
+  // The bundles of the lattice planner cruising on a gently curved road
+  // without obstacles: 9 end speeds x 8 end times by 5 end offsets x 4 end s.
+  virtual void SetUp() {
+    planning_target_.set_cruise_speed(10.0);
+
+    reference_line_ = std::make_shared<std::vector<PathPoint>>();
+    const double kappa = 0.002;
+    for (int i = 0; i <= 300; ++i) {
+      const double s = static_cast<double>(i);
+      PathPoint point;
+      point.set_x(std::sin(kappa * s) / kappa);
+      point.set_y((1.0 - std::cos(kappa * s)) / kappa);
+      point.set_theta(kappa * s);
+      point.set_kappa(kappa);
+      point.set_s(s);
+      reference_line_->push_back(point);
+    }
+    path_time_graph_ = std::make_shared<PathTimeGraph>(
+        std::vector<const Obstacle*>(), *reference_line_, nullptr, init_s_[0],
+        FLAGS_speed_lon_decision_horizon, 0.0, FLAGS_trajectory_time_length,
+        std::array<double, 3>{{0.5, 0.0, 0.0}});
+
+    for (int i = 0; i <= 8; ++i) {
+      for (int j = 1; j <= 8; ++j) {
+        const double v = 2.0 * static_cast<double>(i);
+        const double t = static_cast<double>(j);
+        auto lon_trajectory = std::make_shared<LatticeTrajectory1d>(
+            std::make_shared<QuarticPolynomialCurve1d>(
+                init_s_, std::array<double, 2>{{v, 0.0}}, t));
+        lon_trajectory->set_target_velocity(v);
+        lon_trajectory->set_target_time(t);
+        lon_trajectories_.push_back(lon_trajectory);
+      }
+    }
+    for (const double d : {-1.0, -0.5, 0.0, 0.5, 1.0}) {
+      for (const double s : {10.0, 20.0, 40.0, 80.0}) {
+        auto lat_trajectory = std::make_shared<LatticeTrajectory1d>(
+            std::make_shared<QuinticPolynomialCurve1d>(
+                std::array<double, 3>{{0.5, 0.0, 0.0}},
+                std::array<double, 3>{{d, 0.0, 0.0}}, s));
+        lat_trajectory->set_target_position(d);
+        lat_trajectory->set_target_time(s);
+        lat_trajectories_.push_back(lat_trajectory);
+      }
+    }
+  }
+
+  virtual void TearDown() {
+    FLAGS_enable_parallel_lattice_trajectory_evaluation = false;
+  }
+
+ protected:
+  std::array<double, 3> init_s_{{0.0, 8.0, 0.0}};
+  PlanningTarget planning_target_;
+  std::vector<std::shared_ptr<Curve1d>> lon_trajectories_;
+  std::vector<std::shared_ptr<Curve1d>> lat_trajectories_;
+  std::shared_ptr<PathTimeGraph> path_time_graph_;
+  std::shared_ptr<std::vector<PathPoint>> reference_line_;
+};
+
+// The pairs are taken out in the order of their costs, which are the same as
+// the ones of evaluating every pair completely.
+TEST_F(TrajectoryEvaluatorTest, EvaluateAllPairs) {
+  for (const bool parallel : {false, true}) {
+    for (const bool has_stop_point : {false, true}) {
+      FLAGS_enable_parallel_lattice_trajectory_evaluation = parallel;
+      PlanningTarget planning_target = planning_target_;
+      if (has_stop_point) {
+        planning_target.mutable_stop_point()->set_s(60.0);
+      }
+      TrajectoryEvaluator evaluator(init_s_, planning_target,
+                                    lon_trajectories_, lat_trajectories_,
+                                    path_time_graph_, reference_line_);
+
+      // the full cost of every pair of the longitudinal trajectories kept
+      // by the evaluator
+      std::map<Trajectory1dPair, double> pair_costs;
+      std::vector<double> costs;
+      for (const auto& lon_trajectory : evaluator.lon_trajectories_) {
+        const double lon_cost =
+            evaluator.LonObjectiveCost(lon_trajectory, planning_target,
+                                       evaluator.reference_s_dot_) *
+                FLAGS_weight_lon_objective +
+            evaluator.LonComfortCost(lon_trajectory) * FLAGS_weight_lon_jerk +
+            evaluator.LonCollisionCost(lon_trajectory) *
+                FLAGS_weight_lon_collision +
+            evaluator.CentripetalAccelerationCost(lon_trajectory) *
+                FLAGS_weight_centripetal_acceleration;
+        for (const auto& lat_trajectory : lat_trajectories_) {
+          const double cost =
+              lon_cost +
+              LatOffsetCost(lon_trajectory, lat_trajectory) *
+                  FLAGS_weight_lat_offset +
+              LatComfortCost(init_s_[0], lon_trajectory, lat_trajectory) *
+                  FLAGS_weight_lat_comfort;
+          pair_costs[{lon_trajectory, lat_trajectory}] = cost;
+          costs.push_back(cost);
+        }
+      }
+      std::sort(costs.begin(), costs.end());
+      if (has_stop_point) {
+        EXPECT_LT(evaluator.lon_trajectories_.size(),
+                  lon_trajectories_.size());
+      }
+      ASSERT_FALSE(costs.empty());
+      EXPECT_EQ(evaluator.num_of_trajectory_pairs(), costs.size());
+
+      // ties may come out in any order, but their costs are the same
+      for (const double expected_cost : costs) {
+        ASSERT_TRUE(evaluator.has_more_trajectory_pairs());
+        const double cost = evaluator.top_trajectory_pair_cost();
+        EXPECT_NEAR(cost, expected_cost, 1e-9);
+        const auto trajectory_pair = evaluator.next_top_trajectory_pair();
+        const auto it = pair_costs.find(trajectory_pair);
+        ASSERT_NE(it, pair_costs.end());
+        EXPECT_NEAR(cost, it->second, 1e-9);
+        pair_costs.erase(it);
+      }
+      EXPECT_FALSE(evaluator.has_more_trajectory_pairs());
+      EXPECT_TRUE(pair_costs.empty());
+    }
+  }
+}
+
+}  // namespace planning
+}  // namespace apollo
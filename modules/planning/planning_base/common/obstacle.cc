@@ -372,6 +372,28 @@ bool Obstacle::BuildTrajectoryStBoundary(const ReferenceLine& reference_line,
   common::math::Box2d max_box({0, 0}, 1.0, 1.0, 1.0);
   std::vector<std::pair<STPoint, STPoint>> polygon_points;
 
+  // the boxes the object sweeps between two trajectory points
+  std::vector<common::math::Box2d> object_moving_boxes;
+  object_moving_boxes.reserve(trajectory_points.size());
+  for (int i = 1; i < trajectory_points.size(); ++i) {
+    const auto& first_point = trajectory_points[i - 1].path_point();
+    const auto& second_point = trajectory_points[i].path_point();
+    double object_moving_box_length =
+        object_length + common::util::DistanceXY(first_point, second_point);
+    common::math::Vec2d center((first_point.x() + second_point.x()) / 2.0,
+                               (first_point.y() + second_point.y()) / 2.0);
+    object_moving_boxes.emplace_back(center, first_point.theta(),
+                                     object_moving_box_length, object_width);
+  }
+  // NOTICE: this method will have errors when the reference line is not
+  // straight. Need double loop to cover all corner cases.
+  std::vector<SLBoundary> object_boundaries;
+  if (!reference_line.GetApproximateSLBoundaries(object_moving_boxes,
+                                                 &object_boundaries)) {
+    AERROR << "failed to calculate boundary";
+    return false;
+  }
+
   SLBoundary last_sl_boundary;
   int last_index = 0;
 
@@ -380,19 +402,8 @@ bool Obstacle::BuildTrajectoryStBoundary(const ReferenceLine& reference_line,
 
     const auto& first_traj_point = trajectory_points[i - 1];
     const auto& second_traj_point = trajectory_points[i];
-    const auto& first_point = first_traj_point.path_point();
-    const auto& second_point = second_traj_point.path_point();
-
-    double object_moving_box_length =
-        object_length + common::util::DistanceXY(first_point, second_point);
-
-    common::math::Vec2d center((first_point.x() + second_point.x()) / 2.0,
-                               (first_point.y() + second_point.y()) / 2.0);
-    common::math::Box2d object_moving_box(
-        center, first_point.theta(), object_moving_box_length, object_width);
-    SLBoundary object_boundary;
-    // NOTICE: this method will have errors when the reference line is not
-    // straight. Need double loop to cover all corner cases.
+    const auto& object_moving_box = object_moving_boxes[i - 1];
+    const SLBoundary& object_boundary = object_boundaries[i - 1];
     // roughly skip points that are too close to last_sl_boundary box
     const double distance_xy =
         common::util::DistanceXY(trajectory_points[last_index].path_point(),
@@ -402,19 +413,6 @@ bool Obstacle::BuildTrajectoryStBoundary(const ReferenceLine& reference_line,
       continue;
     }
 
-    const double mid_s =
-        (last_sl_boundary.start_s() + last_sl_boundary.end_s()) / 2.0;
-    const double start_s = std::fmax(0.0, mid_s - 2.0 * distance_xy);
-    const double end_s = (i == 1) ? reference_line.Length()
-                                  : std::fmin(reference_line.Length(),
-                                              mid_s + 2.0 * distance_xy);
-
-    if (!reference_line.GetApproximateSLBoundary(object_moving_box, start_s,
-                                                 end_s, &object_boundary)) {
-      AERROR << "failed to calculate boundary";
-      return false;
-    }
-
     // update history record
     last_sl_boundary = object_boundary;
     last_index = i;
@@ -16,12 +16,61 @@
 
 #include "modules/planning/planning_base/common/planning_context.h"
 
+#include "cyber/common/log.h"
+#include "modules/common/util/util.h"
+
 namespace apollo {
 namespace planning {
 
+using google::protobuf::FieldDescriptor;
+
+thread_local const PlanningContext* PlanningContext::thread_context_ =
+    nullptr;
+thread_local PlanningStatus* PlanningContext::thread_status_ = nullptr;
+
 void PlanningContext::Init() {}
 
-void PlanningContext::Clear() { planning_status_.Clear(); }
+void PlanningContext::Clear() { mutable_planning_status()->Clear(); }
+
+PlanningContext::ScopedStatus::ScopedStatus(const PlanningContext* context,
+                                            PlanningStatus* status)
+    : previous_context_(thread_context_), previous_status_(thread_status_) {
+  thread_context_ = context;
+  thread_status_ = status;
+}
+
+PlanningContext::ScopedStatus::~ScopedStatus() {
+  thread_context_ = previous_context_;
+  thread_status_ = previous_status_;
+}
+
+void PlanningContext::MergeStatus(const PlanningStatus& base,
+                                  const PlanningStatus& status) {
+  const auto* descriptor = PlanningStatus::descriptor();
+  const auto* reflection = PlanningStatus::GetReflection();
+  auto* planning_status = mutable_planning_status();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (field->is_repeated() ||
+        field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+      AERROR << "Can not merge planning status field " << field->name();
+      continue;
+    }
+    const bool has_field = reflection->HasField(status, field);
+    if (has_field == reflection->HasField(base, field) &&
+        (!has_field ||
+         common::util::IsProtoEqual(reflection->GetMessage(base, field),
+                                    reflection->GetMessage(status, field)))) {
+      continue;
+    }
+    if (has_field) {
+      reflection->MutableMessage(planning_status, field)
+          ->CopyFrom(reflection->GetMessage(status, field));
+    } else {
+      reflection->ClearField(planning_status, field);
+    }
+  }
+}
 
 }  // namespace planning
 }  // namespace apollo
@@ -42,11 +42,44 @@ class PlanningContext {
    * please put all status info inside PlanningStatus for easy maintenance.
    * do NOT create new struct at this level.
    * */
-  const PlanningStatus& planning_status() const { return planning_status_; }
-  PlanningStatus* mutable_planning_status() { return &planning_status_; }
+  const PlanningStatus& planning_status() const {
+    return thread_context_ == this ? *thread_status_ : planning_status_;
+  }
+  PlanningStatus* mutable_planning_status() {
+    return thread_context_ == this ? thread_status_ : &planning_status_;
+  }
+
+  /**
+   * @brief While a ScopedStatus is alive, the planning status of the context
+   * seen from the current thread is the given status, so that the task
+   * pipelines of several reference lines can run at the same time, each one
+   * on its own copy of the planning status.
+   */
+  class ScopedStatus {
+   public:
+    ScopedStatus(const PlanningContext* context, PlanningStatus* status);
+    ~ScopedStatus();
+
+   private:
+    const PlanningContext* previous_context_;
+    PlanningStatus* previous_status_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedStatus);
+  };
+
+  /**
+   * @brief Applies the changes made on a copy of the planning status to the
+   * planning status, field by field.
+   * @param base The planning status the copy was made from.
+   * @param status The copy.
+   */
+  void MergeStatus(const PlanningStatus& base, const PlanningStatus& status);
 
  private:
   PlanningStatus planning_status_;
+
+  static thread_local const PlanningContext* thread_context_;
+  static thread_local PlanningStatus* thread_status_;
 };
 
 }  // namespace planning
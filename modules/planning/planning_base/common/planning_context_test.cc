@@ -0,0 +1,84 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/planning_base/common/planning_context.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+TEST(PlanningContextTest, ScopedStatus) {
+  PlanningContext planning_context;
+  planning_context.mutable_planning_status()
+      ->mutable_change_lane()
+      ->set_path_id("base");
+
+  PlanningStatus status = planning_context.planning_status();
+  {
+    PlanningContext::ScopedStatus scoped_status(&planning_context, &status);
+    planning_context.mutable_planning_status()
+        ->mutable_change_lane()
+        ->set_path_id("line");
+    EXPECT_EQ("line",
+              planning_context.planning_status().change_lane().path_id());
+
+    // other threads still see the planning status of the context
+    std::thread thread([&planning_context]() {
+      EXPECT_EQ("base",
+                planning_context.planning_status().change_lane().path_id());
+    });
+    thread.join();
+  }
+  EXPECT_EQ("base", planning_context.planning_status().change_lane().path_id());
+  EXPECT_EQ("line", status.change_lane().path_id());
+}
+
+TEST(PlanningContextTest, MergeStatus) {
+  PlanningContext planning_context;
+  auto* planning_status = planning_context.mutable_planning_status();
+  planning_status->mutable_change_lane()->set_path_id("base");
+  planning_status->mutable_crosswalk()->set_crosswalk_id("crosswalk");
+  planning_status->mutable_destination()->set_has_passed_destination(false);
+  const PlanningStatus base = planning_context.planning_status();
+
+  PlanningStatus first = base;
+  first.mutable_change_lane()->set_path_id("first");
+  first.clear_crosswalk();
+  PlanningStatus second = base;
+  second.mutable_change_lane()->set_path_id("second");
+  second.mutable_destination()->set_has_passed_destination(true);
+
+  // the status of the context changes in the meantime
+  planning_status->mutable_pull_over()->set_plan_pull_over_path(true);
+
+  planning_context.MergeStatus(base, first);
+  planning_context.MergeStatus(base, second);
+  const auto& merged = planning_context.planning_status();
+  EXPECT_EQ("second", merged.change_lane().path_id());
+  EXPECT_FALSE(merged.has_crosswalk());
+  EXPECT_TRUE(merged.destination().has_passed_destination());
+  EXPECT_TRUE(merged.pull_over().plan_pull_over_path());
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -378,22 +378,26 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
     AERROR << "failed to add obstacle " << obstacle->Id();
     return nullptr;
   }
+  BuildObstacleBoundaries(mutable_obstacle);
+  return mutable_obstacle;
+}
 
+void ReferenceLineInfo::BuildObstacleBoundaries(Obstacle* obstacle) {
   SLBoundary perception_sl;
   if (!reference_line_.GetSLBoundary(obstacle->PerceptionPolygon(),
                                      &perception_sl)) {
     AERROR << "Failed to get sl boundary for obstacle: " << obstacle->Id();
-    return mutable_obstacle;
+    return;
   }
-  mutable_obstacle->SetPerceptionSlBoundary(perception_sl);
-  mutable_obstacle->CheckLaneBlocking(reference_line_);
-  if (mutable_obstacle->IsLaneBlocking()) {
+  obstacle->SetPerceptionSlBoundary(perception_sl);
+  obstacle->CheckLaneBlocking(reference_line_);
+  if (obstacle->IsLaneBlocking()) {
     ADEBUG << "obstacle [" << obstacle->Id() << "] is lane blocking.";
   } else {
     ADEBUG << "obstacle [" << obstacle->Id() << "] is NOT lane blocking.";
   }
 
-  if (IsIrrelevantObstacle(*mutable_obstacle)) {
+  if (IsIrrelevantObstacle(*obstacle)) {
     ObjectDecisionType ignore;
     ignore.mutable_ignore();
     path_decision_.AddLateralDecision("reference_line_filter", obstacle->Id(),
@@ -403,31 +407,52 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle) {
     ADEBUG << "NO build reference line st boundary. id:" << obstacle->Id();
   } else {
     ADEBUG << "build reference line st boundary. id:" << obstacle->Id();
-    mutable_obstacle->BuildReferenceLineStBoundary(reference_line_,
-                                                   adc_sl_boundary_.start_s());
+    obstacle->BuildReferenceLineStBoundary(reference_line_,
+                                           adc_sl_boundary_.start_s());
 
     ADEBUG << "reference line st boundary: t["
-           << mutable_obstacle->reference_line_st_boundary().min_t() << ", "
-           << mutable_obstacle->reference_line_st_boundary().max_t() << "] s["
-           << mutable_obstacle->reference_line_st_boundary().min_s() << ", "
-           << mutable_obstacle->reference_line_st_boundary().max_s() << "]";
+           << obstacle->reference_line_st_boundary().min_t() << ", "
+           << obstacle->reference_line_st_boundary().max_t() << "] s["
+           << obstacle->reference_line_st_boundary().min_s() << ", "
+           << obstacle->reference_line_st_boundary().max_s() << "]";
   }
-  return mutable_obstacle;
 }
 
 bool ReferenceLineInfo::AddObstacles(
     const std::vector<const Obstacle*>& obstacles) {
   if (FLAGS_use_multi_thread_to_add_obstacles) {
-    std::vector<std::future<Obstacle*>> results;
+    // The path decision is not thread safe, so the obstacles are added to it
+    // first and only their boundaries are built concurrently, in chunks big
+    // enough to pay for the tasks.
+    static constexpr size_t kNumObstaclesPerTask = 8;
+    std::vector<Obstacle*> mutable_obstacles;
+    mutable_obstacles.reserve(obstacles.size());
     for (const auto* obstacle : obstacles) {
-      results.push_back(
-          cyber::Async(&ReferenceLineInfo::AddObstacle, this, obstacle));
-    }
-    for (auto& result : results) {
-      if (!result.get()) {
+      auto* mutable_obstacle =
+          obstacle ? path_decision_.AddObstacle(*obstacle) : nullptr;
+      if (!mutable_obstacle) {
         AERROR << "Fail to add obstacles.";
         return false;
       }
+      mutable_obstacles.push_back(mutable_obstacle);
+    }
+    const auto build_boundaries = [this, &mutable_obstacles](
+                                      const size_t begin, const size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        BuildObstacleBoundaries(mutable_obstacles[i]);
+      }
+    };
+    std::vector<std::future<void>> results;
+    for (size_t begin = kNumObstaclesPerTask;
+         begin < mutable_obstacles.size(); begin += kNumObstaclesPerTask) {
+      results.push_back(cyber::Async(
+          build_boundaries, begin,
+          std::min(begin + kNumObstaclesPerTask, mutable_obstacles.size())));
+    }
+    build_boundaries(0, std::min(kNumObstaclesPerTask,
+                                 mutable_obstacles.size()));
+    for (auto& result : results) {
+      result.get();
     }
   } else {
     for (const auto* obstacle : obstacles) {
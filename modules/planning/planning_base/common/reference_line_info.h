@@ -275,6 +275,10 @@ class ReferenceLineInfo {
 
   bool IsIrrelevantObstacle(const Obstacle& obstacle);
 
+  // Builds the SL boundary and the reference line ST boundary of an obstacle
+  // in the path decision, or ignores it if it is irrelevant.
+  void BuildObstacleBoundaries(Obstacle* obstacle);
+
   void MakeDecision(DecisionResult* decision_result,
                     PlanningContext* planning_context) const;
 
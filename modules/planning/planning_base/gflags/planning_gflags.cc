@@ -207,6 +207,8 @@ DEFINE_double(speed_fallback_distance, 3.0,
 /// thread pool
 DEFINE_bool(use_multi_thread_to_add_obstacles, false,
             "use multiple thread to add obstacles.");
+DEFINE_bool(enable_parallel_reference_line_planning, false,
+            "run the task pipelines of the reference lines concurrently.");
 
 /// Lattice Planner
 DEFINE_double(numerical_epsilon, 1e-6, "Epsilon in lattice planner.");
@@ -266,6 +268,9 @@ DEFINE_double(polynomial_minimal_param, 0.01,
               "Minimal time parameter in polynomials.");
 DEFINE_double(lattice_stop_buffer, 0.02,
               "The buffer before the stop s to check trajectories.");
+DEFINE_bool(enable_parallel_lattice_trajectory_evaluation, false,
+            "True to evaluate the longitudinal trajectories of the lattice "
+            "planner concurrently.");
 
 DEFINE_bool(lateral_optimization, true,
             "whether using optimization for lateral trajectory generation");
@@ -336,6 +341,9 @@ DEFINE_bool(
 
 DEFINE_bool(enable_osqp_debug, false,
             "True to turn on OSQP verbose debug output in log.");
+DEFINE_bool(enable_piecewise_jerk_osqp_session, true,
+            "True to keep the OSQP workspaces of the piecewise jerk problems "
+            "to update and warm start them in the next planning cycle.");
 
 DEFINE_bool(export_chart, false, "export chart in planning");
 DEFINE_bool(enable_record_debug, true,
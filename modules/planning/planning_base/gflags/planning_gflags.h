@@ -101,6 +101,7 @@ DECLARE_double(slowdown_profile_deceleration);
 DECLARE_double(speed_fallback_distance);
 /// thread pool
 DECLARE_bool(use_multi_thread_to_add_obstacles);
+DECLARE_bool(enable_parallel_reference_line_planning);
 
 DECLARE_double(numerical_epsilon);
 DECLARE_double(default_cruise_speed);
@@ -146,6 +147,7 @@ DECLARE_double(time_min_density);
 DECLARE_double(comfort_acceleration_factor);
 DECLARE_double(polynomial_minimal_param);
 DECLARE_double(lattice_stop_buffer);
+DECLARE_bool(enable_parallel_lattice_trajectory_evaluation);
 DECLARE_double(max_s_lateral_optimization);
 DECLARE_double(default_delta_s_lateral_optimization);
 DECLARE_double(bound_buffer);
@@ -171,6 +173,7 @@ DECLARE_bool(enable_parallel_trajectory_smoothing);
 DECLARE_bool(enable_parallel_hybrid_a);
 
 DECLARE_bool(enable_osqp_debug);
+DECLARE_bool(enable_piecewise_jerk_osqp_session);
 DECLARE_bool(export_chart);
 DECLARE_bool(enable_record_debug);
 DECLARE_bool(enable_print_curve);
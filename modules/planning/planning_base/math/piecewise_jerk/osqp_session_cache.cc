@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/planning_base/math/piecewise_jerk/osqp_session_cache.h"
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+std::vector<c_float> ValuesInLayout(const csc& layout,
+                                    const std::vector<c_float>& data,
+                                    const std::vector<c_int>& indices,
+                                    const std::vector<c_int>& indptr) {
+  std::vector<c_float> values;
+  values.reserve(layout.p[layout.n]);
+  for (c_int j = 0; j < layout.n; ++j) {
+    c_int k = indptr[j];
+    for (c_int ptr = layout.p[j]; ptr < layout.p[j + 1]; ++ptr) {
+      while (k < indptr[j + 1] && indices[k] < layout.i[ptr]) {
+        ++k;
+      }
+      values.push_back(k < indptr[j + 1] && indices[k] == layout.i[ptr]
+                           ? data[k]
+                           : 0.0);
+    }
+  }
+  return values;
+}
+
+constexpr size_t OsqpSessionCache::kMaxNumSessions;
+
+bool OsqpProblem::HasSameStructure(const OsqpProblem& other) const {
+  return n == other.n && m == other.m && P_indptr == other.P_indptr &&
+         P_indices == other.P_indices && A_indptr == other.A_indptr &&
+         A_indices == other.A_indices;
+}
+
+OsqpSession::OsqpSession(const std::string& type, const OsqpProblem& problem,
+                         const OSQPSettings* settings)
+    : type_(type), problem_(problem) {
+  // osqp_setup copies the data into the workspace
+  OSQPData data;
+  data.n = problem_.n;
+  data.m = problem_.m;
+  data.P = csc_matrix(problem_.n, problem_.n, problem_.P_data.size(),
+                      problem_.P_data.data(), problem_.P_indices.data(),
+                      problem_.P_indptr.data());
+  data.q = problem_.q.data();
+  data.A = csc_matrix(problem_.m, problem_.n, problem_.A_data.size(),
+                      problem_.A_data.data(), problem_.A_indices.data(),
+                      problem_.A_indptr.data());
+  data.l = problem_.lower_bounds.data();
+  data.u = problem_.upper_bounds.data();
+  work_ = osqp_setup(&data, settings);
+  c_free(data.P);
+  c_free(data.A);
+}
+
+OsqpSession::~OsqpSession() {
+  if (work_ != nullptr) {
+    osqp_cleanup(work_);
+  }
+}
+
+bool OsqpSession::Update(const OsqpProblem& problem) {
+  if (work_ == nullptr || !problem_.HasSameStructure(problem)) {
+    return false;
+  }
+  const auto P_values =
+      ValuesInLayout(*work_->data->P, problem.P_data, problem.P_indices,
+                     problem.P_indptr);
+  const auto A_values =
+      ValuesInLayout(*work_->data->A, problem.A_data, problem.A_indices,
+                     problem.A_indptr);
+  if (osqp_update_P_A(work_, P_values.data(), OSQP_NULL,
+                      static_cast<c_int>(P_values.size()), A_values.data(),
+                      OSQP_NULL, static_cast<c_int>(A_values.size())) != 0) {
+    AERROR << "Fail to update P and A of the OSQP workspace.";
+    return false;
+  }
+  if (osqp_update_lin_cost(work_, problem.q.data()) != 0 ||
+      osqp_update_bounds(work_, problem.lower_bounds.data(),
+                         problem.upper_bounds.data()) != 0) {
+    AERROR << "Fail to update q and the bounds of the OSQP workspace.";
+    return false;
+  }
+  return true;
+}
+
+OsqpSessionCache::OsqpSessionCache() {}
+
+std::unique_ptr<OsqpSession> OsqpSessionCache::Acquire(
+    const std::string& type, const OsqpProblem& problem) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
+    if ((*it)->type() == type && (*it)->problem().HasSameStructure(problem)) {
+      auto session = std::move(*it);
+      sessions_.erase(it);
+      return session;
+    }
+  }
+  return nullptr;
+}
+
+void OsqpSessionCache::Release(std::unique_ptr<OsqpSession> session) {
+  if (session == nullptr || !session->ok()) {
+    return;
+  }
+  // cleaned up out of the lock
+  std::unique_ptr<OsqpSession> dropped;
+  std::lock_guard<std::mutex> lock(mutex_);
+  sessions_.push_front(std::move(session));
+  if (sessions_.size() > kMaxNumSessions) {
+    dropped = std::move(sessions_.back());
+    sessions_.pop_back();
+  }
+}
+
+void OsqpSessionCache::Clear() {
+  std::list<std::unique_ptr<OsqpSession>> sessions;
+  std::lock_guard<std::mutex> lock(mutex_);
+  sessions_.swap(sessions);
+}
+
+}  // namespace planning
+}  // namespace apollo
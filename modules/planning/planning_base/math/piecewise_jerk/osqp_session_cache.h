@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "osqp/osqp.h"
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace planning {
+
+/*
+ * @brief A quadratic program in the csc format of OSQP.
+ */
+struct OsqpProblem {
+  c_int n = 0;
+  c_int m = 0;
+  std::vector<c_float> P_data;
+  std::vector<c_int> P_indices;
+  std::vector<c_int> P_indptr;
+  std::vector<c_float> q;
+  std::vector<c_float> A_data;
+  std::vector<c_int> A_indices;
+  std::vector<c_int> A_indptr;
+  std::vector<c_float> lower_bounds;
+  std::vector<c_float> upper_bounds;
+
+  /*
+   * @brief Whether the other problem has the same size and the same sparsity
+   * patterns of P and A, only their values differ.
+   */
+  bool HasSameStructure(const OsqpProblem& other) const;
+};
+
+/*
+ * @brief The values of a csc matrix in the layout of another one, such as
+ * the upper triangular part of P kept by an OSQP workspace. The rows of each
+ * column are sorted in both, entries of the layout missing in the matrix
+ * are 0.
+ */
+std::vector<c_float> ValuesInLayout(const csc& layout,
+                                    const std::vector<c_float>& data,
+                                    const std::vector<c_int>& indices,
+                                    const std::vector<c_int>& indptr);
+
+/*
+ * @brief An OSQP workspace set up for one problem structure. Solving another
+ * problem of the same structure only updates the values in the workspace,
+ * which keeps the symbolic factorization of the KKT system and the last
+ * solution for a warm start.
+ */
+class OsqpSession {
+ public:
+  /*
+   * @param type The kind of problem, sessions are only shared by problems of
+   * the same kind as they are set up with its solver settings.
+   */
+  OsqpSession(const std::string& type, const OsqpProblem& problem,
+              const OSQPSettings* settings);
+
+  ~OsqpSession();
+
+  /*
+   * @brief Whether the workspace was set up.
+   */
+  bool ok() const { return work_ != nullptr; }
+
+  const std::string& type() const { return type_; }
+
+  const OsqpProblem& problem() const { return problem_; }
+
+  /*
+   * @brief Replaces the values of the problem in the workspace.
+   * @param problem A problem of the same structure.
+   */
+  bool Update(const OsqpProblem& problem);
+
+  OSQPWorkspace* work() { return work_; }
+
+  /*
+   * @brief The primal solution of the last solve, empty if there is none.
+   */
+  const std::vector<c_float>& last_solution() const { return last_solution_; }
+
+  void set_last_solution(std::vector<c_float> last_solution) {
+    last_solution_ = std::move(last_solution);
+  }
+
+ private:
+  std::string type_;
+  OsqpProblem problem_;
+  OSQPWorkspace* work_ = nullptr;
+  std::vector<c_float> last_solution_;
+
+  DISALLOW_COPY_AND_ASSIGN(OsqpSession);
+};
+
+/*
+ * @brief The sessions of the problems solved recently, shared by the planning
+ * threads. A session is taken out of the cache while a problem is solved
+ * with it and put back afterwards.
+ */
+class OsqpSessionCache {
+ public:
+  // enough for the path and speed problems of a few reference lines
+  static constexpr size_t kMaxNumSessions = 16;
+
+  /*
+   * @brief Takes the most recently used session of the kind of problem with
+   * the structure of the problem out of the cache.
+   * @return nullptr if there is no such session.
+   */
+  std::unique_ptr<OsqpSession> Acquire(const std::string& type,
+                                       const OsqpProblem& problem);
+
+  /*
+   * @brief Puts the session back into the cache, which drops the least
+   * recently used session when it is full.
+   */
+  void Release(std::unique_ptr<OsqpSession> session);
+
+  void Clear();
+
+ private:
+  std::mutex mutex_;
+  // the most recently used first
+  std::list<std::unique_ptr<OsqpSession>> sessions_;
+
+  DECLARE_SINGLETON(OsqpSessionCache)
+};
+
+}  // namespace planning
+}  // namespace apollo
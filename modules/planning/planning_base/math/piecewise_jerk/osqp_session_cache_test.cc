@@ -0,0 +1,198 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/planning_base/math/piecewise_jerk/osqp_session_cache.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/planning_base/gflags/planning_gflags.h"
+#include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_path_problem.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+// min x'x/2 with -1 <= x <= 1, P and A are the identity
+OsqpProblem MakeProblem(const c_int n) {
+  OsqpProblem problem;
+  problem.n = n;
+  problem.m = n;
+  for (c_int i = 0; i < n; ++i) {
+    problem.P_data.push_back(1.0);
+    problem.P_indices.push_back(i);
+    problem.P_indptr.push_back(i);
+    problem.A_data.push_back(1.0);
+    problem.A_indices.push_back(i);
+    problem.A_indptr.push_back(i);
+  }
+  problem.P_indptr.push_back(n);
+  problem.A_indptr.push_back(n);
+  problem.q.assign(n, 0.0);
+  problem.lower_bounds.assign(n, -1.0);
+  problem.upper_bounds.assign(n, 1.0);
+  return problem;
+}
+
+std::unique_ptr<OsqpSession> MakeSession(const std::string& type,
+                                         const OsqpProblem& problem) {
+  OSQPSettings* settings =
+      reinterpret_cast<OSQPSettings*>(c_malloc(sizeof(OSQPSettings)));
+  osqp_set_default_settings(settings);
+  settings->verbose = false;
+  std::unique_ptr<OsqpSession> session(
+      new OsqpSession(type, problem, settings));
+  c_free(settings);
+  EXPECT_TRUE(session->ok());
+  return session;
+}
+
+// solves a path problem whose reference is shifted by offset
+std::vector<double> SolvePath(const double offset) {
+  constexpr size_t kNumKnots = 50;
+  PiecewiseJerkPathProblem problem(kNumKnots, 0.5, {0.3, 0.0, 0.0});
+  std::vector<double> x_ref(kNumKnots);
+  for (size_t i = 0; i < kNumKnots; ++i) {
+    x_ref[i] = std::sin(0.1 * static_cast<double>(i) + offset);
+  }
+  problem.set_x_ref(1.0, std::move(x_ref));
+  problem.set_weight_x(1.0);
+  problem.set_weight_dx(10.0);
+  problem.set_weight_ddx(100.0);
+  problem.set_weight_dddx(1000.0);
+  problem.set_scale_factor({1.0, 10.0, 100.0});
+  problem.set_x_bounds(-2.0, 2.0);
+  problem.set_dx_bounds(-2.0, 2.0);
+  problem.set_ddx_bounds(-1.0, 1.0);
+  problem.set_dddx_bound(1.0);
+  EXPECT_TRUE(problem.Optimize(4000));
+  return problem.opt_x();
+}
+
+}  // namespace
+
+TEST(OsqpSessionCacheTest, HasSameStructure) {
+  const OsqpProblem problem = MakeProblem(3);
+  OsqpProblem other = problem;
+  other.P_data[0] = 2.0;
+  other.q[1] = 1.0;
+  other.A_data[2] = 3.0;
+  other.upper_bounds[0] = 5.0;
+  EXPECT_TRUE(problem.HasSameStructure(other));
+
+  other = problem;
+  other.A_indices[2] = 1;
+  EXPECT_FALSE(problem.HasSameStructure(other));
+
+  other = problem;
+  other.P_indptr = {0, 0, 2, 3};
+  other.P_indices = {0, 1, 2};
+  EXPECT_FALSE(problem.HasSameStructure(other));
+
+  other = problem;
+  other.m = 4;
+  EXPECT_FALSE(problem.HasSameStructure(other));
+  EXPECT_FALSE(problem.HasSameStructure(MakeProblem(4)));
+}
+
+TEST(OsqpSessionCacheTest, ValuesInLayout) {
+  // [[4, 1, 0], [1, 2, 5], [0, 5, 3]] with all its entries
+  std::vector<c_float> data = {4.0, 1.0, 1.0, 2.0, 5.0, 5.0, 3.0};
+  std::vector<c_int> indices = {0, 1, 0, 1, 2, 1, 2};
+  std::vector<c_int> indptr = {0, 2, 5, 7};
+  // its upper triangular part, as osqp_setup keeps P
+  std::vector<c_float> layout_data(5, 0.0);
+  std::vector<c_int> layout_indices = {0, 0, 1, 1, 2};
+  std::vector<c_int> layout_indptr = {0, 1, 3, 5};
+  csc* layout = csc_matrix(3, 3, 5, layout_data.data(), layout_indices.data(),
+                           layout_indptr.data());
+  EXPECT_EQ(std::vector<c_float>({4.0, 1.0, 2.0, 5.0, 3.0}),
+            ValuesInLayout(*layout, data, indices, indptr));
+
+  // entries of the layout missing in the matrix
+  data = {4.0, 2.0, 5.0, 3.0};
+  indices = {0, 1, 1, 2};
+  indptr = {0, 1, 2, 4};
+  EXPECT_EQ(std::vector<c_float>({4.0, 0.0, 2.0, 5.0, 3.0}),
+            ValuesInLayout(*layout, data, indices, indptr));
+  c_free(layout);
+}
+
+TEST(OsqpSessionCacheTest, AcquireAndRelease) {
+  auto* cache = OsqpSessionCache::Instance();
+  cache->Clear();
+  const OsqpProblem problem = MakeProblem(3);
+  EXPECT_EQ(nullptr, cache->Acquire("path", problem));
+
+  auto session = MakeSession("path", problem);
+  const OsqpSession* first = session.get();
+  cache->Release(std::move(session));
+  session = MakeSession("path", problem);
+  const OsqpSession* second = session.get();
+  cache->Release(std::move(session));
+  EXPECT_EQ(nullptr, cache->Acquire("speed", problem));
+  EXPECT_EQ(nullptr, cache->Acquire("path", MakeProblem(4)));
+
+  // the most recently used first, a session is taken out of the cache
+  auto acquired = cache->Acquire("path", problem);
+  EXPECT_EQ(second, acquired.get());
+  auto other = cache->Acquire("path", problem);
+  EXPECT_EQ(first, other.get());
+  EXPECT_EQ(nullptr, cache->Acquire("path", problem));
+
+  cache->Release(std::move(acquired));
+  EXPECT_EQ(second, cache->Acquire("path", problem).get());
+  cache->Clear();
+}
+
+TEST(OsqpSessionCacheTest, EvictLeastRecentlyUsed) {
+  auto* cache = OsqpSessionCache::Instance();
+  cache->Clear();
+  const c_int num_sessions =
+      static_cast<c_int>(OsqpSessionCache::kMaxNumSessions);
+  for (c_int n = 1; n <= num_sessions + 1; ++n) {
+    cache->Release(MakeSession("path", MakeProblem(n)));
+  }
+  EXPECT_EQ(nullptr, cache->Acquire("path", MakeProblem(1)));
+  for (c_int n = 2; n <= num_sessions + 1; ++n) {
+    EXPECT_NE(nullptr, cache->Acquire("path", MakeProblem(n))) << n;
+  }
+  cache->Clear();
+}
+
+TEST(OsqpSessionCacheTest, WarmStartedSolveMatchesColdSolve) {
+  FLAGS_enable_piecewise_jerk_osqp_session = true;
+  OsqpSessionCache::Instance()->Clear();
+  SolvePath(0.0);
+  // warm started from the last solve
+  const auto warm = SolvePath(0.2);
+  OsqpSessionCache::Instance()->Clear();
+  const auto cold = SolvePath(0.2);
+  ASSERT_EQ(cold.size(), warm.size());
+  for (size_t i = 0; i < cold.size(); ++i) {
+    EXPECT_NEAR(cold[i], warm[i], 1e-2) << i;
+  }
+  OsqpSessionCache::Instance()->Clear();
+}
+
+}  // namespace planning
+}  // namespace apollo
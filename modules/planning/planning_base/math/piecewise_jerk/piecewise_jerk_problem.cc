@@ -16,6 +16,12 @@
 
 #include "modules/planning/planning_base/math/piecewise_jerk/piecewise_jerk_problem.h"
 
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <typeinfo>
+
 #include "cyber/common/log.h"
 #include "modules/planning/planning_base/gflags/planning_gflags.h"
 
@@ -48,70 +54,83 @@ PiecewiseJerkProblem::PiecewiseJerkProblem(
   weight_x_ref_vec_ = std::vector<double>(num_of_knots_, 0.0);
 }
 
-bool PiecewiseJerkProblem::FormulateProblem(OSQPData* data) {
+bool PiecewiseJerkProblem::FormulateProblem(OsqpProblem* problem) {
   // calculate kernel
-  std::vector<c_float> P_data;
-  std::vector<c_int> P_indices;
-  std::vector<c_int> P_indptr;
-  CalculateKernel(&P_data, &P_indices, &P_indptr);
+  CalculateKernel(&problem->P_data, &problem->P_indices, &problem->P_indptr);
 
   // calculate affine constraints
-  std::vector<c_float> A_data;
-  std::vector<c_int> A_indices;
-  std::vector<c_int> A_indptr;
-  std::vector<c_float> lower_bounds;
-  std::vector<c_float> upper_bounds;
-  CalculateAffineConstraint(&A_data, &A_indices, &A_indptr, &lower_bounds,
-                            &upper_bounds);
+  CalculateAffineConstraint(&problem->A_data, &problem->A_indices,
+                            &problem->A_indptr, &problem->lower_bounds,
+                            &problem->upper_bounds);
 
   // calculate offset
-  std::vector<c_float> q;
-  CalculateOffset(&q);
-
-  CHECK_EQ(lower_bounds.size(), upper_bounds.size());
-
-  size_t kernel_dim = 3 * num_of_knots_;
-  size_t num_affine_constraint = lower_bounds.size();
-
-  data->n = kernel_dim;
-  data->m = num_affine_constraint;
-  data->P = csc_matrix(kernel_dim, kernel_dim, P_data.size(), CopyData(P_data),
-                       CopyData(P_indices), CopyData(P_indptr));
-  data->q = CopyData(q);
-  data->A =
-      csc_matrix(num_affine_constraint, kernel_dim, A_data.size(),
-                 CopyData(A_data), CopyData(A_indices), CopyData(A_indptr));
-  data->l = CopyData(lower_bounds);
-  data->u = CopyData(upper_bounds);
-
-  return CheckLowUpperBound(lower_bounds, upper_bounds);
+  CalculateOffset(&problem->q);
+
+  CHECK_EQ(problem->lower_bounds.size(), problem->upper_bounds.size());
+
+  problem->n = static_cast<c_int>(3 * num_of_knots_);
+  problem->m = static_cast<c_int>(problem->lower_bounds.size());
+
+  return !CheckLowUpperBound(problem->lower_bounds, problem->upper_bounds);
 }
 
 bool PiecewiseJerkProblem::Optimize(const int max_iter) {
-  OSQPData* data = reinterpret_cast<OSQPData*>(c_malloc(sizeof(OSQPData)));
-  if (FormulateProblem(data)) {
-    FreeData(data);
+  const auto start_time = std::chrono::system_clock::now();
+  OsqpProblem problem;
+  if (!FormulateProblem(&problem)) {
     return false;
   }
-  OSQPSettings* settings = SolverDefaultSettings();
-  settings->max_iter = max_iter;
-  OSQPWorkspace* osqp_work = nullptr;
-  osqp_work = osqp_setup(data, settings);
-  // osqp_setup(&osqp_work, data, settings);
+
+  // The sessions are only shared by problems of the same class, which are set
+  // up with the same solver settings.
+  const std::string type = typeid(*this).name();
+  std::unique_ptr<OsqpSession> session;
+  if (FLAGS_enable_piecewise_jerk_osqp_session) {
+    session = OsqpSessionCache::Instance()->Acquire(type, problem);
+    if (session != nullptr && !session->Update(problem)) {
+      session.reset();
+    }
+  }
+  const bool warm_start =
+      session != nullptr && !session->last_solution().empty();
+  if (session == nullptr) {
+    OSQPSettings* settings = SolverDefaultSettings();
+    settings->max_iter = max_iter;
+    session.reset(new OsqpSession(type, problem, settings));
+    c_free(settings);
+    if (!session->ok()) {
+      AERROR << "Fail to set up the OSQP workspace.";
+      return false;
+    }
+  } else {
+    osqp_update_max_iter(session->work(), max_iter);
+    if (warm_start) {
+      WarmStart(session->last_solution(), session->work());
+    }
+  }
+  OSQPWorkspace* osqp_work = session->work();
+
+  const auto solve_start_time = std::chrono::system_clock::now();
   osqp_solve(osqp_work);
+  const auto end_time = std::chrono::system_clock::now();
+  setup_time_ms_ = std::chrono::duration<double, std::milli>(
+                       solve_start_time - start_time)
+                       .count();
+  solve_time_ms_ =
+      std::chrono::duration<double, std::milli>(end_time - solve_start_time)
+          .count();
+  ADEBUG << "OSQP setup time: " << setup_time_ms_
+         << " ms, solve time: " << solve_time_ms_
+         << " ms, iterations: " << osqp_work->info->iter
+         << ", warm started: " << warm_start;
+
   auto status = osqp_work->info->status_val;
 
   if (status < 0 || (status != 1 && status != 2)) {
     AERROR << "failed optimization status:\t" << osqp_work->info->status;
-    osqp_cleanup(osqp_work);
-    FreeData(data);
-    c_free(settings);
     return false;
   } else if (osqp_work->solution == nullptr) {
     AERROR << "The solution from OSQP is nullptr";
-    osqp_cleanup(osqp_work);
-    FreeData(data);
-    c_free(settings);
     return false;
   }
 
@@ -126,13 +145,42 @@ bool PiecewiseJerkProblem::Optimize(const int max_iter) {
         osqp_work->solution->x[i + 2 * num_of_knots_] / scale_factor_[2];
   }
 
-  // Cleanup
-  osqp_cleanup(osqp_work);
-  FreeData(data);
-  c_free(settings);
+  // Keep the workspace for the next problem of the same structure. The ones
+  // of failed solves are dropped above, their iterates are no good to start
+  // from.
+  if (FLAGS_enable_piecewise_jerk_osqp_session) {
+    session->set_last_solution(std::vector<c_float>(
+        osqp_work->solution->x, osqp_work->solution->x + problem.n));
+    OsqpSessionCache::Instance()->Release(std::move(session));
+  }
   return true;
 }
 
+void PiecewiseJerkProblem::WarmStart(const std::vector<c_float>& last_solution,
+                                     OSQPWorkspace* work) const {
+  // x, x' and x'' of the last solution, each shifted along the knots
+  const size_t n = num_of_knots_;
+  const double shift = std::max(warm_start_shift_ / delta_s_, 0.0);
+  std::vector<c_float> x(3 * n);
+  for (size_t i = 0; i < n; ++i) {
+    const double index = std::min(static_cast<double>(i) + shift, n - 1.0);
+    const size_t lower = static_cast<size_t>(index);
+    const size_t upper = std::min(lower + 1, n - 1);
+    const double ratio = index - static_cast<double>(lower);
+    for (size_t k = 0; k < 3; ++k) {
+      x[k * n + i] = (1.0 - ratio) * last_solution[k * n + lower] +
+                     ratio * last_solution[k * n + upper];
+    }
+  }
+  // x starts from x_init, which makes the shifted s of a speed problem start
+  // from zero again
+  const double offset = x_init_[0] * scale_factor_[0] - x[0];
+  for (size_t i = 0; i < n; ++i) {
+    x[i] += offset;
+  }
+  osqp_warm_start_x(work, x.data());
+}
+
 void PiecewiseJerkProblem::CalculateAffineConstraint(
     std::vector<c_float>* A_data, std::vector<c_int>* A_indices,
     std::vector<c_int>* A_indptr, std::vector<c_float>* lower_bounds,
@@ -338,20 +386,6 @@ void PiecewiseJerkProblem::set_end_state_ref(
   has_end_state_ref_ = true;
 }
 
-void PiecewiseJerkProblem::FreeData(OSQPData* data) {
-  delete[] data->q;
-  delete[] data->l;
-  delete[] data->u;
-
-  delete[] data->P->i;
-  delete[] data->P->p;
-  delete[] data->P->x;
-
-  delete[] data->A->i;
-  delete[] data->A->p;
-  delete[] data->A->x;
-}
-
 bool PiecewiseJerkProblem::CheckLowUpperBound(std::vector<c_float>& lower,
                                               std::vector<c_float>& upper) {
   for (size_t i = 0; i < lower.size(); i++) {
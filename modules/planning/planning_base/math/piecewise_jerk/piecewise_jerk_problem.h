@@ -20,12 +20,15 @@
 
 #pragma once
 
+#include <array>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 #include "osqp/osqp.h"
 
+#include "modules/planning/planning_base/math/piecewise_jerk/osqp_session_cache.h"
+
 namespace apollo {
 namespace planning {
 
@@ -108,6 +111,15 @@ class PiecewiseJerkProblem {
   void set_end_state_ref(const std::array<double, 3>& weight_end_state,
                          const std::array<double, 3>& end_state_ref);
 
+  /**
+   * @brief Set how far the knots moved since the last solve of a problem of
+   * the same structure, in the unit of delta_s. The last solution is shifted
+   * by it to warm start the solver.
+   */
+  void set_warm_start_shift(const double warm_start_shift) {
+    warm_start_shift_ = warm_start_shift;
+  }
+
   virtual bool Optimize(const int max_iter = 4000);
 
   const std::vector<double>& opt_x() const { return x_; }
@@ -116,6 +128,17 @@ class PiecewiseJerkProblem {
 
   const std::vector<double>& opt_ddx() const { return ddx_; }
 
+  /**
+   * @brief The time the last Optimize spent to set up or update the OSQP
+   * workspace, including the formulation of the problem.
+   */
+  double setup_time_ms() const { return setup_time_ms_; }
+
+  /**
+   * @brief The time the last Optimize spent in the OSQP solve.
+   */
+  double solve_time_ms() const { return solve_time_ms_; }
+
  protected:
   // naming convention follows osqp solver.
   virtual void CalculateKernel(std::vector<c_float>* P_data,
@@ -132,19 +155,13 @@ class PiecewiseJerkProblem {
 
   virtual OSQPSettings* SolverDefaultSettings();
 
-  bool FormulateProblem(OSQPData* data);
-
-  void FreeData(OSQPData* data);
+  bool FormulateProblem(OsqpProblem* problem);
 
   bool CheckLowUpperBound(std::vector<c_float>& lower,
                           std::vector<c_float>& upper);
 
-  template <typename T>
-  T* CopyData(const std::vector<T>& vec) {
-    T* data = new T[vec.size()];
-    memcpy(data, vec.data(), sizeof(T) * vec.size());
-    return data;
-  }
+  void WarmStart(const std::vector<c_float>& last_solution,
+                 OSQPWorkspace* work) const;
 
  protected:
   size_t num_of_knots_ = 0;
@@ -178,6 +195,11 @@ class PiecewiseJerkProblem {
   bool has_end_state_ref_ = false;
   std::array<double, 3> weight_end_state_ = {{0.0, 0.0, 0.0}};
   std::array<double, 3> end_state_ref_;
+
+  double warm_start_shift_ = 0.0;
+
+  double setup_time_ms_ = 0.0;
+  double solve_time_ms_ = 0.0;
 };
 
 }  // namespace planning
@@ -20,9 +20,65 @@
 
 #include "modules/planning/planning_base/open_space/coarse_trajectory_generator/grid_search.h"
 
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
 namespace apollo {
 namespace planning {
 
+namespace {
+
+// Grid offsets and costs of the neighbors of a node, in the order up, up
+// right, right, down right, down, down left, left, up left.
+struct Neighbor {
+  int dx;
+  int dy;
+  double cost;
+};
+
+const Neighbor kNeighbors[] = {{0, 1, 1.0},
+                               {1, 1, std::sqrt(2.0)},
+                               {1, 0, 1.0},
+                               {1, -1, std::sqrt(2.0)},
+                               {0, -1, 1.0},
+                               {-1, -1, std::sqrt(2.0)},
+                               {-1, 0, 1.0},
+                               {-1, 1, std::sqrt(2.0)}};
+
+bool IsSameObstacles(
+    const std::vector<std::vector<common::math::LineSegment2d>>& obstacles1,
+    const std::vector<std::vector<common::math::LineSegment2d>>& obstacles2) {
+  if (obstacles1.size() != obstacles2.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < obstacles1.size(); ++i) {
+    if (obstacles1[i].size() != obstacles2[i].size()) {
+      return false;
+    }
+    for (size_t j = 0; j < obstacles1[i].size(); ++j) {
+      if (!(obstacles1[i][j].start() == obstacles2[i][j].start()) ||
+          !(obstacles1[i][j].end() == obstacles2[i][j].end())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The grid coordinates in [min, max] clamped to [0, max_grid], empty if
+// there is none.
+std::pair<int, int> GridRange(const double min, const double max,
+                              const int max_grid) {
+  return {static_cast<int>(
+              std::min(max_grid + 1.0, std::max(0.0, std::ceil(min)))),
+          static_cast<int>(
+              std::max(-1.0, std::min(static_cast<double>(max_grid),
+                                      std::floor(max))))};
+}
+
+}  // namespace
+
 GridSearch::GridSearch(const PlannerOpenSpaceConfig& open_space_conf) {
   xy_grid_resolution_ =
       open_space_conf.warm_start_config().grid_a_star_xy_resolution();
@@ -34,69 +90,94 @@ double GridSearch::EuclidDistance(const double x1, const double y1,
   return std::sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2));
 }
 
-bool GridSearch::CheckConstraints(std::shared_ptr<Node2d> node) {
-  const double node_grid_x = node->GetGridX();
-  const double node_grid_y = node->GetGridY();
-  if (node_grid_x > max_grid_x_ || node_grid_x < 0 ||
-      node_grid_y > max_grid_y_ || node_grid_y < 0) {
-    return false;
-  }
-  if (obstacles_linesegments_vec_.empty()) {
+bool GridSearch::UpdateGrid(
+    const std::vector<double>& XYbounds,
+    const std::vector<std::vector<common::math::LineSegment2d>>&
+        obstacles_linesegments_vec) {
+  const bool same_bounds = XYbounds == XYbounds_;
+  const bool same_obstacles =
+      IsSameObstacles(obstacles_linesegments_vec, obstacles_linesegments_vec_);
+  if (same_bounds && same_obstacles) {
     return true;
   }
+  if (!same_bounds) {
+    XYbounds_ = XYbounds;
+    // XYbounds with xmin, xmax, ymin, ymax
+    max_grid_x_ = static_cast<int>(
+        std::round((XYbounds_[1] - XYbounds_[0]) / xy_grid_resolution_));
+    max_grid_y_ = static_cast<int>(
+        std::round((XYbounds_[3] - XYbounds_[2]) / xy_grid_resolution_));
+    const size_t num_cells = static_cast<size_t>(max_grid_x_ + 1) *
+                             static_cast<size_t>(max_grid_y_ + 1);
+    nodes_.resize(num_cells);
+    node_states_.resize(num_cells);
+  }
+  if (!same_obstacles) {
+    obstacles_linesegments_vec_ = obstacles_linesegments_vec;
+  }
+  RasterizeObstacles();
+  dp_map_end_index_ = -1;
+  return false;
+}
+
+void GridSearch::RasterizeObstacles() {
+  blocked_cells_.assign(nodes_.size(), false);
   for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
     for (const common::math::LineSegment2d& linesegment :
          obstacle_linesegments) {
-      if (linesegment.DistanceTo({node->GetGridX(), node->GetGridY()}) <
-          node_radius_) {
-        return false;
+      // only the cells around the segment can be closer than node_radius_
+      const auto x_range = GridRange(
+          std::min(linesegment.start().x(), linesegment.end().x()) -
+              node_radius_,
+          std::max(linesegment.start().x(), linesegment.end().x()) +
+              node_radius_,
+          max_grid_x_);
+      const auto y_range = GridRange(
+          std::min(linesegment.start().y(), linesegment.end().y()) -
+              node_radius_,
+          std::max(linesegment.start().y(), linesegment.end().y()) +
+              node_radius_,
+          max_grid_y_);
+      for (int grid_x = x_range.first; grid_x <= x_range.second; ++grid_x) {
+        for (int grid_y = y_range.first; grid_y <= y_range.second; ++grid_y) {
+          const int index = CalcGridIndex(grid_x, grid_y);
+          if (!blocked_cells_[index] &&
+              linesegment.DistanceTo({static_cast<double>(grid_x),
+                                      static_cast<double>(grid_y)}) <
+                  node_radius_) {
+            blocked_cells_[index] = true;
+          }
+        }
       }
     }
   }
-  return true;
 }
 
-std::vector<std::shared_ptr<Node2d>> GridSearch::GenerateNextNodes(
-    std::shared_ptr<Node2d> current_node) {
-  double current_node_x = current_node->GetGridX();
-  double current_node_y = current_node->GetGridY();
-  double current_node_path_cost = current_node->GetPathCost();
-  double diagonal_distance = std::sqrt(2.0);
-  std::vector<std::shared_ptr<Node2d>> next_nodes;
-  std::shared_ptr<Node2d> up =
-      std::make_shared<Node2d>(current_node_x, current_node_y + 1.0, XYbounds_);
-  up->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> up_right = std::make_shared<Node2d>(
-      current_node_x + 1.0, current_node_y + 1.0, XYbounds_);
-  up_right->SetPathCost(current_node_path_cost + diagonal_distance);
-  std::shared_ptr<Node2d> right =
-      std::make_shared<Node2d>(current_node_x + 1.0, current_node_y, XYbounds_);
-  right->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> down_right = std::make_shared<Node2d>(
-      current_node_x + 1.0, current_node_y - 1.0, XYbounds_);
-  down_right->SetPathCost(current_node_path_cost + diagonal_distance);
-  std::shared_ptr<Node2d> down =
-      std::make_shared<Node2d>(current_node_x, current_node_y - 1.0, XYbounds_);
-  down->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> down_left = std::make_shared<Node2d>(
-      current_node_x - 1.0, current_node_y - 1.0, XYbounds_);
-  down_left->SetPathCost(current_node_path_cost + diagonal_distance);
-  std::shared_ptr<Node2d> left =
-      std::make_shared<Node2d>(current_node_x - 1.0, current_node_y, XYbounds_);
-  left->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> up_left = std::make_shared<Node2d>(
-      current_node_x - 1.0, current_node_y + 1.0, XYbounds_);
-  up_left->SetPathCost(current_node_path_cost + diagonal_distance);
-
-  next_nodes.emplace_back(up);
-  next_nodes.emplace_back(up_right);
-  next_nodes.emplace_back(right);
-  next_nodes.emplace_back(down_right);
-  next_nodes.emplace_back(down);
-  next_nodes.emplace_back(down_left);
-  next_nodes.emplace_back(left);
-  next_nodes.emplace_back(up_left);
-  return next_nodes;
+int GridSearch::CalcIndex(const double x, const double y) const {
+  if (XYbounds_.size() < 4) {
+    return -1;
+  }
+  // XYbounds with xmin, xmax, ymin, ymax
+  const int grid_x = static_cast<int>((x - XYbounds_[0]) / xy_grid_resolution_);
+  const int grid_y = static_cast<int>((y - XYbounds_[2]) / xy_grid_resolution_);
+  if (grid_x > max_grid_x_ || grid_x < 0 || grid_y > max_grid_y_ ||
+      grid_y < 0) {
+    return -1;
+  }
+  return CalcGridIndex(grid_x, grid_y);
+}
+
+bool GridSearch::CheckConstraints(const int grid_x, const int grid_y) const {
+  if (grid_x > max_grid_x_ || grid_x < 0 || grid_y > max_grid_y_ ||
+      grid_y < 0) {
+    return false;
+  }
+  return !blocked_cells_[CalcGridIndex(grid_x, grid_y)];
+}
+
+void GridSearch::ResetNodes() {
+  std::fill(node_states_.begin(), node_states_.end(), NodeState::kNew);
+  final_node_ = nullptr;
 }
 
 bool GridSearch::GenerateAStarPath(
@@ -105,51 +186,61 @@ bool GridSearch::GenerateAStarPath(
     const std::vector<std::vector<common::math::LineSegment2d>>&
         obstacles_linesegments_vec,
     GridAStartResult* result) {
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
+  UpdateGrid(XYbounds, obstacles_linesegments_vec);
+  const int start_index = CalcIndex(sx, sy);
+  const int end_index = CalcIndex(ex, ey);
+  if (start_index < 0 || end_index < 0) {
+    AERROR << "Grid A searching start or end out of XYbounds";
+    return false;
+  }
+  std::priority_queue<std::pair<int, double>,
+                      std::vector<std::pair<int, double>>, cmp>
       open_pq;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> close_set;
-  XYbounds_ = XYbounds;
-  std::shared_ptr<Node2d> start_node =
-      std::make_shared<Node2d>(sx, sy, xy_grid_resolution_, XYbounds_);
-  std::shared_ptr<Node2d> end_node =
-      std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
-  std::shared_ptr<Node2d> final_node_ = nullptr;
-  obstacles_linesegments_vec_ = obstacles_linesegments_vec;
-  open_set.emplace(start_node->GetIndex(), start_node);
-  open_pq.emplace(start_node->GetIndex(), start_node->GetCost());
+  ResetNodes();
+  Node2d& start_node = nodes_[start_index];
+  start_node = Node2d(static_cast<int>((sx - XYbounds_[0]) /
+                                       xy_grid_resolution_),
+                      static_cast<int>((sy - XYbounds_[2]) /
+                                       xy_grid_resolution_),
+                      start_index);
+  const int end_grid_x =
+      static_cast<int>((ex - XYbounds_[0]) / xy_grid_resolution_);
+  const int end_grid_y =
+      static_cast<int>((ey - XYbounds_[2]) / xy_grid_resolution_);
+  node_states_[start_index] = NodeState::kOpen;
+  open_pq.emplace(start_index, start_node.GetCost());
 
   // Grid a star begins
   size_t explored_node_num = 0;
   while (!open_pq.empty()) {
-    std::string current_id = open_pq.top().first;
+    const int current_index = open_pq.top().first;
     open_pq.pop();
-    std::shared_ptr<Node2d> current_node = open_set[current_id];
+    const Node2d& current_node = nodes_[current_index];
     // Check destination
-    if (*(current_node) == *(end_node)) {
-      final_node_ = current_node;
+    if (current_index == end_index) {
+      final_node_ = &current_node;
       break;
     }
-    close_set.emplace(current_node->GetIndex(), current_node);
-    std::vector<std::shared_ptr<Node2d>> next_nodes =
-        std::move(GenerateNextNodes(current_node));
-    for (auto& next_node : next_nodes) {
-      if (!CheckConstraints(next_node)) {
+    node_states_[current_index] = NodeState::kClosed;
+    for (const Neighbor& neighbor : kNeighbors) {
+      const int grid_x = current_node.GetGridX() + neighbor.dx;
+      const int grid_y = current_node.GetGridY() + neighbor.dy;
+      if (!CheckConstraints(grid_x, grid_y)) {
         continue;
       }
-      if (close_set.find(next_node->GetIndex()) != close_set.end()) {
+      const int next_index = CalcGridIndex(grid_x, grid_y);
+      if (node_states_[next_index] != NodeState::kNew) {
         continue;
       }
-      if (open_set.find(next_node->GetIndex()) == open_set.end()) {
-        ++explored_node_num;
-        next_node->SetHeuristic(
-            EuclidDistance(next_node->GetGridX(), next_node->GetGridY(),
-                           end_node->GetGridX(), end_node->GetGridY()));
-        next_node->SetPreNode(current_node);
-        open_set.emplace(next_node->GetIndex(), next_node);
-        open_pq.emplace(next_node->GetIndex(), next_node->GetCost());
-      }
+      ++explored_node_num;
+      Node2d& next_node = nodes_[next_index];
+      next_node = Node2d(grid_x, grid_y, next_index);
+      next_node.SetPathCost(current_node.GetPathCost() + neighbor.cost);
+      next_node.SetHeuristic(
+          EuclidDistance(grid_x, grid_y, end_grid_x, end_grid_y));
+      next_node.SetPreNode(&current_node);
+      node_states_[next_index] = NodeState::kOpen;
+      open_pq.emplace(next_index, next_node.GetCost());
     }
   }
 
@@ -166,66 +257,77 @@ bool GridSearch::GenerateDpMap(
     const double ex, const double ey, const std::vector<double>& XYbounds,
     const std::vector<std::vector<common::math::LineSegment2d>>&
         obstacles_linesegments_vec) {
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
+  const bool same_grid = UpdateGrid(XYbounds, obstacles_linesegments_vec);
+  const int end_index = CalcIndex(ex, ey);
+  if (end_index < 0) {
+    AERROR << "Dp map end out of XYbounds";
+    dp_map_end_index_ = -1;
+    dp_map_.assign(nodes_.size(), std::numeric_limits<double>::infinity());
+    return false;
+  }
+  if (same_grid && end_index == dp_map_end_index_) {
+    ADEBUG << "reuse dp map";
+    return true;
+  }
+  std::priority_queue<std::pair<int, double>,
+                      std::vector<std::pair<int, double>>, cmp>
       open_pq;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
-  dp_map_ = decltype(dp_map_)();
-  XYbounds_ = XYbounds;
-  // XYbounds with xmin, xmax, ymin, ymax
-  max_grid_y_ = std::round((XYbounds_[3] - XYbounds_[2]) / xy_grid_resolution_);
-  max_grid_x_ = std::round((XYbounds_[1] - XYbounds_[0]) / xy_grid_resolution_);
-  std::shared_ptr<Node2d> end_node =
-      std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
-  obstacles_linesegments_vec_ = obstacles_linesegments_vec;
-  open_set.emplace(end_node->GetIndex(), end_node);
-  open_pq.emplace(end_node->GetIndex(), end_node->GetCost());
+  ResetNodes();
+  dp_map_.assign(nodes_.size(), std::numeric_limits<double>::infinity());
+  nodes_[end_index] = Node2d(
+      static_cast<int>((ex - XYbounds_[0]) / xy_grid_resolution_),
+      static_cast<int>((ey - XYbounds_[2]) / xy_grid_resolution_), end_index);
+  node_states_[end_index] = NodeState::kOpen;
+  open_pq.emplace(end_index, nodes_[end_index].GetCost());
 
   // Grid a star begins
   size_t explored_node_num = 0;
   while (!open_pq.empty()) {
-    const std::string current_id = open_pq.top().first;
+    const int current_index = open_pq.top().first;
     open_pq.pop();
-    std::shared_ptr<Node2d> current_node = open_set[current_id];
-    dp_map_.emplace(current_node->GetIndex(), current_node);
-    std::vector<std::shared_ptr<Node2d>> next_nodes =
-        std::move(GenerateNextNodes(current_node));
-    for (auto& next_node : next_nodes) {
-      if (!CheckConstraints(next_node)) {
-        continue;
-      }
-      if (dp_map_.find(next_node->GetIndex()) != dp_map_.end()) {
+    const Node2d& current_node = nodes_[current_index];
+    node_states_[current_index] = NodeState::kClosed;
+    dp_map_[current_index] = current_node.GetCost();
+    for (const Neighbor& neighbor : kNeighbors) {
+      const int grid_x = current_node.GetGridX() + neighbor.dx;
+      const int grid_y = current_node.GetGridY() + neighbor.dy;
+      if (!CheckConstraints(grid_x, grid_y)) {
         continue;
       }
-      if (open_set.find(next_node->GetIndex()) == open_set.end()) {
+      const int next_index = CalcGridIndex(grid_x, grid_y);
+      const double path_cost = current_node.GetPathCost() + neighbor.cost;
+      Node2d& next_node = nodes_[next_index];
+      if (node_states_[next_index] == NodeState::kNew) {
         ++explored_node_num;
-        next_node->SetPreNode(current_node);
-        open_set.emplace(next_node->GetIndex(), next_node);
-        open_pq.emplace(next_node->GetIndex(), next_node->GetCost());
-      } else {
-        if (open_set[next_node->GetIndex()]->GetCost() > next_node->GetCost()) {
-          open_set[next_node->GetIndex()]->SetCost(next_node->GetCost());
-          open_set[next_node->GetIndex()]->SetPreNode(current_node);
+        next_node = Node2d(grid_x, grid_y, next_index);
+        next_node.SetPathCost(path_cost);
+        next_node.SetPreNode(&current_node);
+        node_states_[next_index] = NodeState::kOpen;
+        open_pq.emplace(next_index, next_node.GetCost());
+      } else if (node_states_[next_index] == NodeState::kOpen) {
+        if (next_node.GetCost() > path_cost) {
+          next_node.SetCost(path_cost);
+          next_node.SetPreNode(&current_node);
         }
       }
     }
   }
+  dp_map_end_index_ = end_index;
   ADEBUG << "explored node num is " << explored_node_num;
   return true;
 }
 
-double GridSearch::CheckDpMap(const double sx, const double sy) {
-  std::string index = Node2d::CalcIndex(sx, sy, xy_grid_resolution_, XYbounds_);
-  if (dp_map_.find(index) != dp_map_.end()) {
-    return dp_map_[index]->GetCost() * xy_grid_resolution_;
-  } else {
+double GridSearch::CheckDpMap(const double sx, const double sy) const {
+  const int index = CalcIndex(sx, sy);
+  if (index < 0 || dp_map_end_index_ < 0) {
     return std::numeric_limits<double>::infinity();
   }
+  return dp_map_[index] * xy_grid_resolution_;
 }
 
 void GridSearch::LoadGridAStarResult(GridAStartResult* result) {
   (*result).path_cost = final_node_->GetPathCost() * xy_grid_resolution_;
-  std::shared_ptr<Node2d> current_node = final_node_;
+  const Node2d* current_node = final_node_;
   std::vector<double> grid_a_x;
   std::vector<double> grid_a_y;
   while (current_node->GetPreNode() != nullptr) {
@@ -20,16 +20,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <limits>
-#include <memory>
-#include <queue>
-#include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "absl/strings/str_cat.h"
-
 #include "modules/planning/planning_base/proto/planner_open_space_config.pb.h"
 
 #include "cyber/common/log.h"
@@ -40,19 +35,9 @@ namespace planning {
 
 class Node2d {
  public:
-  Node2d(const double x, const double y, const double xy_resolution,
-         const std::vector<double>& XYbounds) {
-    // XYbounds with xmin, xmax, ymin, ymax
-    grid_x_ = static_cast<int>((x - XYbounds[0]) / xy_resolution);
-    grid_y_ = static_cast<int>((y - XYbounds[2]) / xy_resolution);
-    index_ = ComputeStringIndex(grid_x_, grid_y_);
-  }
-  Node2d(const int grid_x, const int grid_y,
-         const std::vector<double>& XYbounds) {
-    grid_x_ = grid_x;
-    grid_y_ = grid_y;
-    index_ = ComputeStringIndex(grid_x_, grid_y_);
-  }
+  Node2d() = default;
+  Node2d(const int grid_x, const int grid_y, const int index)
+      : grid_x_(grid_x), grid_y_(grid_y), index_(index) {}
   void SetPathCost(const double path_cost) {
     path_cost_ = path_cost;
     cost_ = path_cost_ + heuristic_;
@@ -62,39 +47,27 @@ class Node2d {
     cost_ = path_cost_ + heuristic_;
   }
   void SetCost(const double cost) { cost_ = cost; }
-  void SetPreNode(std::shared_ptr<Node2d> pre_node) { pre_node_ = pre_node; }
-  double GetGridX() const { return grid_x_; }
-  double GetGridY() const { return grid_y_; }
+  void SetPreNode(const Node2d* pre_node) { pre_node_ = pre_node; }
+  int GetGridX() const { return grid_x_; }
+  int GetGridY() const { return grid_y_; }
   double GetPathCost() const { return path_cost_; }
   double GetHeuCost() const { return heuristic_; }
   double GetCost() const { return cost_; }
-  const std::string& GetIndex() const { return index_; }
-  std::shared_ptr<Node2d> GetPreNode() const { return pre_node_; }
-  static std::string CalcIndex(const double x, const double y,
-                               const double xy_resolution,
-                               const std::vector<double>& XYbounds) {
-    // XYbounds with xmin, xmax, ymin, ymax
-    int grid_x = static_cast<int>((x - XYbounds[0]) / xy_resolution);
-    int grid_y = static_cast<int>((y - XYbounds[2]) / xy_resolution);
-    return ComputeStringIndex(grid_x, grid_y);
-  }
+  int GetIndex() const { return index_; }
+  const Node2d* GetPreNode() const { return pre_node_; }
   bool operator==(const Node2d& right) const {
     return right.GetIndex() == index_;
   }
 
- private:
-  static std::string ComputeStringIndex(int x_grid, int y_grid) {
-    return absl::StrCat(x_grid, "_", y_grid);
-  }
-
  private:
   int grid_x_ = 0;
   int grid_y_ = 0;
+  // index of the grid cell of the node
+  int index_ = -1;
   double path_cost_ = 0.0;
   double heuristic_ = 0.0;
   double cost_ = 0.0;
-  std::string index_;
-  std::shared_ptr<Node2d> pre_node_ = nullptr;
+  const Node2d* pre_node_ = nullptr;
 };
 
 struct GridAStartResult {
@@ -113,39 +86,65 @@ class GridSearch {
       const std::vector<std::vector<common::math::LineSegment2d>>&
           obstacles_linesegments_vec,
       GridAStartResult* result);
+  /**
+   * @brief Generates the holonomic cost to reach (ex, ey) from every grid
+   *        cell. The map of the last call is kept if the goal cell, the
+   *        bounds and the obstacles have not changed since.
+   */
   bool GenerateDpMap(
       const double ex, const double ey, const std::vector<double>& XYbounds,
       const std::vector<std::vector<common::math::LineSegment2d>>&
           obstacles_linesegments_vec);
-  double CheckDpMap(const double sx, const double sy);
+  double CheckDpMap(const double sx, const double sy) const;
 
  private:
+  // States of the nodes of a search.
+  enum class NodeState : uint8_t { kNew, kOpen, kClosed };
+
   double EuclidDistance(const double x1, const double y1, const double x2,
                         const double y2);
-  std::vector<std::shared_ptr<Node2d>> GenerateNextNodes(
-      std::shared_ptr<Node2d> node);
-  bool CheckConstraints(std::shared_ptr<Node2d> node);
+  // Sets up the grid for the bounds and obstacles, returns false if they are
+  // different from the last search.
+  bool UpdateGrid(const std::vector<double>& XYbounds,
+                  const std::vector<std::vector<common::math::LineSegment2d>>&
+                      obstacles_linesegments_vec);
+  void RasterizeObstacles();
+  // Index of the grid cell of a point, -1 if it is out of the grid.
+  int CalcIndex(const double x, const double y) const;
+  int CalcGridIndex(const int grid_x, const int grid_y) const {
+    return grid_x * (max_grid_y_ + 1) + grid_y;
+  }
+  bool CheckConstraints(const int grid_x, const int grid_y) const;
+  void ResetNodes();
   void LoadGridAStarResult(GridAStartResult* result);
 
  private:
   double xy_grid_resolution_ = 0.0;
   double node_radius_ = 0.0;
   std::vector<double> XYbounds_;
-  double max_grid_x_ = 0.0;
-  double max_grid_y_ = 0.0;
-  std::shared_ptr<Node2d> start_node_;
-  std::shared_ptr<Node2d> end_node_;
-  std::shared_ptr<Node2d> final_node_;
+  int max_grid_x_ = -1;
+  int max_grid_y_ = -1;
+  const Node2d* final_node_ = nullptr;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec_;
 
+  // Node pool with one node per grid cell, used by all the searches.
+  std::vector<Node2d> nodes_;
+  std::vector<NodeState> node_states_;
+  // Whether a grid cell is too close to an obstacle, kept until the bounds
+  // or the obstacles change.
+  std::vector<bool> blocked_cells_;
+
   struct cmp {
-    bool operator()(const std::pair<std::string, double>& left,
-                    const std::pair<std::string, double>& right) const {
+    bool operator()(const std::pair<int, double>& left,
+                    const std::pair<int, double>& right) const {
       return left.second >= right.second;
     }
   };
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> dp_map_;
+  // Cost to the goal of each grid cell, infinity if it can not be reached.
+  std::vector<double> dp_map_;
+  // Index of the goal cell of dp_map_, -1 if there is no map.
+  int dp_map_end_index_ = -1;
 };
 }  // namespace planning
 }  // namespace apollo
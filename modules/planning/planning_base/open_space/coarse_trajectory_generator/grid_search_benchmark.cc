@@ -0,0 +1,139 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/planning/planning_base/open_space/coarse_trajectory_generator/grid_search.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+struct Scenario {
+  PlannerOpenSpaceConfig config;
+  double ex = 0.0;
+  double ey = 0.0;
+  std::vector<double> XYbounds;
+  std::vector<std::vector<LineSegment2d>> obstacles;
+};
+
+void AddPolygon(const std::vector<Vec2d>& vertices, Scenario* scenario) {
+  std::vector<LineSegment2d> segments;
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    segments.emplace_back(vertices[i], vertices[(i + 1) % vertices.size()]);
+  }
+  scenario->obstacles.push_back(segments);
+}
+
+// state.range(0) selects the scenario: 0 is the one of hybrid_a_star_test
+// with the grid of open_space_standard_parking_lot.pb.txt, 1 a parking lot
+// with two rows of parked cars at the resolution of the valet parking
+// scenario.
+Scenario MakeScenario(const int index) {
+  Scenario scenario;
+  auto* warm_start_config = scenario.config.mutable_warm_start_config();
+  if (index == 0) {
+    warm_start_config->set_grid_a_star_xy_resolution(1.0);
+    warm_start_config->set_node_radius(0.5);
+    scenario.ex = 15.0;
+    scenario.ey = 0.0;
+    scenario.XYbounds = {-50.0, 50.0, -50.0, 50.0};
+    scenario.obstacles.push_back({LineSegment2d({1.0, 0.0}, {-1.0, 0.0})});
+    return scenario;
+  }
+  warm_start_config->set_grid_a_star_xy_resolution(0.25);
+  warm_start_config->set_node_radius(0.2);
+  scenario.ex = 21.0;
+  scenario.ey = 4.0;
+  scenario.XYbounds = {0.0, 40.0, 0.0, 24.0};
+  // the lane between the rows and the slots on both sides of it
+  scenario.obstacles.push_back({LineSegment2d({0.0, 6.0}, {19.5, 6.0}),
+                                LineSegment2d({19.5, 6.0}, {19.5, 1.0}),
+                                LineSegment2d({19.5, 1.0}, {22.5, 1.0}),
+                                LineSegment2d({22.5, 1.0}, {22.5, 6.0}),
+                                LineSegment2d({22.5, 6.0}, {40.0, 6.0})});
+  scenario.obstacles.push_back({LineSegment2d({0.0, 18.0}, {40.0, 18.0})});
+  for (double x = 1.0; x < 39.0; x += 3.0) {
+    if (x < 19.5 || x > 22.5) {
+      AddPolygon({{x, 1.0}, {x + 2.0, 1.0}, {x + 2.0, 5.5}, {x, 5.5}},
+                 &scenario);
+    }
+    AddPolygon({{x, 18.5}, {x + 2.0, 18.5}, {x + 2.0, 23.0}, {x, 23.0}},
+               &scenario);
+  }
+  return scenario;
+}
+
+}  // namespace
+
+void BM_GenerateDpMap(benchmark::State& state) {
+  const Scenario scenario = MakeScenario(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    GridSearch grid_search(scenario.config);
+    benchmark::DoNotOptimize(grid_search.GenerateDpMap(
+        scenario.ex, scenario.ey, scenario.XYbounds, scenario.obstacles));
+  }
+}
+BENCHMARK(BM_GenerateDpMap)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Planning cycles in which the goal and the ROI stay the same.
+void BM_GenerateDpMapUnchanged(benchmark::State& state) {
+  const Scenario scenario = MakeScenario(static_cast<int>(state.range(0)));
+  GridSearch grid_search(scenario.config);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(grid_search.GenerateDpMap(
+        scenario.ex, scenario.ey, scenario.XYbounds, scenario.obstacles));
+  }
+}
+BENCHMARK(BM_GenerateDpMapUnchanged)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+// The heuristic lookups of the hybrid A* node expansions.
+void BM_CheckDpMap(benchmark::State& state) {
+  const Scenario scenario = MakeScenario(static_cast<int>(state.range(0)));
+  GridSearch grid_search(scenario.config);
+  grid_search.GenerateDpMap(scenario.ex, scenario.ey, scenario.XYbounds,
+                            scenario.obstacles);
+  std::vector<Vec2d> points;
+  const auto& bounds = scenario.XYbounds;
+  for (double x = bounds[0]; x < bounds[1]; x += 0.37) {
+    for (double y = bounds[2]; y < bounds[3]; y += 0.41) {
+      points.emplace_back(x, y);
+    }
+  }
+  for (auto _ : state) {
+    for (const Vec2d& point : points) {
+      benchmark::DoNotOptimize(grid_search.CheckDpMap(point.x(), point.y()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_CheckDpMap)->Arg(0)->Arg(1);
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/planning_base/open_space/coarse_trajectory_generator/grid_search.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+class GridSearchTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    auto* warm_start_config =
+        planner_open_space_config_.mutable_warm_start_config();
+    warm_start_config->set_grid_a_star_xy_resolution(1.0);
+    warm_start_config->set_node_radius(0.5);
+    grid_search_.reset(new GridSearch(planner_open_space_config_));
+    XYbounds_ = {0.0, 20.0, 0.0, 20.0};
+  }
+
+ protected:
+  PlannerOpenSpaceConfig planner_open_space_config_;
+  std::unique_ptr<GridSearch> grid_search_;
+  std::vector<double> XYbounds_;
+};
+
+TEST_F(GridSearchTest, DpMap) {
+  std::vector<std::vector<LineSegment2d>> obstacles;
+  ASSERT_TRUE(grid_search_->GenerateDpMap(10.0, 10.0, XYbounds_, obstacles));
+  EXPECT_DOUBLE_EQ(0.0, grid_search_->CheckDpMap(10.5, 10.5));
+  EXPECT_DOUBLE_EQ(1.0, grid_search_->CheckDpMap(10.5, 11.5));
+  EXPECT_DOUBLE_EQ(std::sqrt(2.0), grid_search_->CheckDpMap(9.5, 9.5));
+  EXPECT_DOUBLE_EQ(5.0, grid_search_->CheckDpMap(15.5, 10.5));
+  EXPECT_TRUE(std::isinf(grid_search_->CheckDpMap(25.0, 10.0)));
+  EXPECT_TRUE(std::isinf(grid_search_->CheckDpMap(10.0, -5.0)));
+
+  // a wall at x = 12 from y = 0 to 18 makes the way around it longer
+  obstacles.push_back({LineSegment2d({12.0, 0.0}, {12.0, 18.0})});
+  ASSERT_TRUE(grid_search_->GenerateDpMap(10.0, 10.0, XYbounds_, obstacles));
+  EXPECT_TRUE(std::isinf(grid_search_->CheckDpMap(12.5, 10.5)));
+  EXPECT_GT(grid_search_->CheckDpMap(15.5, 10.5), 10.0);
+
+  // the same map is kept for the same goal cell
+  ASSERT_TRUE(grid_search_->GenerateDpMap(10.2, 10.7, XYbounds_, obstacles));
+  EXPECT_TRUE(std::isinf(grid_search_->CheckDpMap(12.5, 10.5)));
+
+  obstacles.clear();
+  ASSERT_TRUE(grid_search_->GenerateDpMap(10.2, 10.7, XYbounds_, obstacles));
+  EXPECT_DOUBLE_EQ(5.0, grid_search_->CheckDpMap(15.5, 10.5));
+
+  EXPECT_FALSE(grid_search_->GenerateDpMap(30.0, 10.0, XYbounds_, obstacles));
+  EXPECT_TRUE(std::isinf(grid_search_->CheckDpMap(10.5, 10.5)));
+}
+
+TEST_F(GridSearchTest, AStarPath) {
+  std::vector<std::vector<LineSegment2d>> obstacles;
+  obstacles.push_back({LineSegment2d({12.0, 0.0}, {12.0, 18.0})});
+  GridAStartResult result;
+  ASSERT_TRUE(grid_search_->GenerateAStarPath(5.0, 5.0, 15.0, 5.0, XYbounds_,
+                                              obstacles, &result));
+  ASSERT_FALSE(result.x.empty());
+  ASSERT_EQ(result.x.size(), result.y.size());
+  EXPECT_DOUBLE_EQ(15.0, result.x.back());
+  EXPECT_DOUBLE_EQ(5.0, result.y.back());
+  for (size_t i = 0; i < result.x.size(); ++i) {
+    EXPECT_FALSE(result.y[i] < 19.0 && std::abs(result.x[i] - 12.0) < 0.5);
+  }
+  EXPECT_GT(result.path_cost, 10.0);
+
+  EXPECT_FALSE(grid_search_->GenerateAStarPath(5.0, 5.0, 25.0, 5.0, XYbounds_,
+                                               obstacles, &result));
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -21,6 +21,7 @@
 #include "modules/planning/planning_base/reference_line/reference_line.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <unordered_set>
 
@@ -702,6 +703,45 @@ bool ReferenceLine::GetApproximateSLBoundary(
   return true;
 }
 
+bool ReferenceLine::GetApproximateSLBoundaries(
+    const std::vector<common::math::Box2d>& boxes,
+    std::vector<SLBoundary>* const sl_boundaries) const {
+  std::vector<common::math::Vec2d> centers;
+  centers.reserve(boxes.size());
+  for (const auto& box : boxes) {
+    centers.push_back(box.center());
+  }
+  std::vector<double> s;
+  std::vector<double> l;
+  if (!map_path_.GetProjectionsAlongPath(centers, 0.0, map_path_.length(), &s,
+                                         &l)) {
+    AERROR << "Cannot get projection points from path.";
+    return false;
+  }
+
+  sl_boundaries->resize(boxes.size());
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    // The half extents of the box rotated to align the reference line, the
+    // same as the ones of the corners in GetApproximateSLBoundary.
+    const double heading = map_path_.GetSmoothPoint(s[i]).heading();
+    const double delta_heading = boxes[i].heading() - heading;
+    const double cos_heading = std::cos(delta_heading);
+    const double sin_heading = std::sin(delta_heading);
+    const double half_length = boxes[i].half_length();
+    const double half_width = boxes[i].half_width();
+    const double half_s = std::fabs(half_length * cos_heading) +
+                          std::fabs(half_width * sin_heading);
+    const double half_l = std::fabs(half_length * sin_heading) +
+                          std::fabs(half_width * cos_heading);
+    auto& sl_boundary = (*sl_boundaries)[i];
+    sl_boundary.set_start_s(s[i] - half_s);
+    sl_boundary.set_end_s(s[i] + half_s);
+    sl_boundary.set_start_l(l[i] - half_l);
+    sl_boundary.set_end_l(l[i] + half_l);
+  }
+  return true;
+}
+
 bool ReferenceLine::GetSLBoundary(const common::math::Box2d& box,
                                   SLBoundary* const sl_boundary,
                                   double warm_start_s) const {
@@ -106,6 +106,19 @@ class ReferenceLine {
   bool GetApproximateSLBoundary(const common::math::Box2d& box,
                                 const double start_s, const double end_s,
                                 SLBoundary* const sl_boundary) const;
+  /**
+   * @brief Get the approximate SL Boundaries of boxes which move along the
+   * reference line, such as an obstacle along its predicted trajectory. The
+   * box centers are projected in one pass, each starting from the projection
+   * of the box before it.
+   * @param boxes The boxes in the order they move in.
+   * @param sl_boundaries Output of the SLBoundary of each box.
+   *
+   * @return True if success.
+   */
+  bool GetApproximateSLBoundaries(
+      const std::vector<common::math::Box2d>& boxes,
+      std::vector<SLBoundary>* const sl_boundaries) const;
   /**
    * @brief Get the SL Boundary of the box.
    * @param box The box to calculate.
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file reference_line_test.cc
+ **/
+#include "modules/planning/planning_base/reference_line/reference_line.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/math/box2d.h"
+#include "modules/common/math/vec2d.h"
+#include "modules/map/hdmap/hdmap_common.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::Box2d;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+constexpr double kRadius = 50.0;
+constexpr int kNumSegments = 100;
+
+void ExpectSameSLBoundaries(const ReferenceLine& reference_line,
+                            const std::vector<Box2d>& boxes) {
+  std::vector<SLBoundary> sl_boundaries;
+  EXPECT_TRUE(reference_line.GetApproximateSLBoundaries(boxes, &sl_boundaries));
+  ASSERT_EQ(sl_boundaries.size(), boxes.size());
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    SLBoundary sl_boundary;
+    EXPECT_TRUE(reference_line.GetApproximateSLBoundary(
+        boxes[i], 0.0, reference_line.Length(), &sl_boundary));
+    EXPECT_NEAR(sl_boundaries[i].start_s(), sl_boundary.start_s(), 1e-6) << i;
+    EXPECT_NEAR(sl_boundaries[i].end_s(), sl_boundary.end_s(), 1e-6) << i;
+    EXPECT_NEAR(sl_boundaries[i].start_l(), sl_boundary.start_l(), 1e-6) << i;
+    EXPECT_NEAR(sl_boundaries[i].end_l(), sl_boundary.end_l(), 1e-6) << i;
+  }
+}
+
+}  // namespace
+
+class ReferenceLineTest : public ::testing::Test {
+ public:
+  // A lane along a quarter circle of radius kRadius, counterclockwise from
+  // (kRadius, 0), and the reference line on it.
+  virtual void SetUp() {
+    lane_.mutable_id()->set_id("quarter_circle");
+    auto* line_segment =
+        lane_.mutable_central_curve()->add_segment()->mutable_line_segment();
+    for (int i = 0; i <= kNumSegments; ++i) {
+      const double p =
+          M_PI_2 * static_cast<double>(i) / static_cast<double>(kNumSegments);
+      auto* point = line_segment->add_point();
+      point->set_x(kRadius * std::cos(p));
+      point->set_y(kRadius * std::sin(p));
+    }
+    for (auto* sample : {lane_.add_left_sample(), lane_.add_right_sample()}) {
+      sample->set_s(0.0);
+      sample->set_width(1.75);
+    }
+    lane_info_.reset(new hdmap::LaneInfo(lane_));
+
+    std::vector<ReferencePoint> ref_points;
+    for (size_t i = 0; i < lane_info_->points().size(); ++i) {
+      hdmap::MapPathPoint map_path_point(
+          lane_info_->points()[i], lane_info_->headings()[i],
+          hdmap::LaneWaypoint(lane_info_, lane_info_->accumulate_s()[i]));
+      ref_points.emplace_back(map_path_point, 1.0 / kRadius, 0.0);
+    }
+    reference_line_.reset(new ReferenceLine(ref_points));
+  }
+
+ protected:
+  hdmap::Lane lane_;
+  hdmap::LaneInfoConstPtr lane_info_;
+  std::unique_ptr<ReferenceLine> reference_line_;
+};
+
+TEST_F(ReferenceLineTest, GetApproximateSLBoundaries) {
+  // boxes outside of the circle, moving along it and away from it, turning
+  // relative to the reference line
+  std::vector<Box2d> boxes;
+  for (int i = 0; i <= 80; ++i) {
+    const double p = M_PI_2 * (static_cast<double>(i) / 80.0 * 1.2 - 0.1);
+    const double radius = kRadius + 1.0 + 0.05 * i;
+    const double heading = p + M_PI_2 + 0.02 * i;
+    boxes.emplace_back(Vec2d(radius * std::cos(p), radius * std::sin(p)),
+                       heading, 4.0, 2.0);
+  }
+  ExpectSameSLBoundaries(*reference_line_, boxes);
+
+  // boxes going back along the circle
+  std::reverse(boxes.begin(), boxes.end());
+  ExpectSameSLBoundaries(*reference_line_, boxes);
+
+  std::vector<SLBoundary> sl_boundaries;
+  EXPECT_TRUE(reference_line_->GetApproximateSLBoundaries({}, &sl_boundaries));
+  EXPECT_TRUE(sl_boundaries.empty());
+}
+
+}  // namespace planning
+}  // namespace apollo
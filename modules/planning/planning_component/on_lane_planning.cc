@@ -20,6 +20,7 @@
 #include <limits>
 #include <list>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest_prod.h"
 
@@ -51,6 +52,7 @@ namespace planning {
 using apollo::canbus::Chassis;
 using apollo::common::EngageAdvice;
 using apollo::common::ErrorCode;
+using apollo::common::PointENU;
 using apollo::common::Status;
 using apollo::common::TrajectoryPoint;
 using apollo::common::VehicleState;
@@ -158,6 +160,29 @@ Status OnLanePlanning::Init(const PlanningConfig& config) {
   return planner_->Init(injector_, FLAGS_planner_config_path);
 }
 
+void OnLanePlanning::SetMapStreamingRoute(const PlanningCommand& command) {
+  std::vector<PointENU> route;
+  for (const auto& road : command.lane_follow_command().road()) {
+    if (road.passage().empty()) {
+      continue;
+    }
+    // the lanes of the first passage are enough to find the tiles ahead
+    for (const auto& segment : road.passage(0).segment()) {
+      const auto lane = hdmap_->GetLaneById(hdmap::MakeMapId(segment.id()));
+      if (lane == nullptr) {
+        continue;
+      }
+      for (const auto& point : lane->points()) {
+        PointENU route_point;
+        route_point.set_x(point.x());
+        route_point.set_y(point.y());
+        route.push_back(route_point);
+      }
+    }
+  }
+  hdmap_->SetStreamingRoute(route);
+}
+
 Status OnLanePlanning::InitFrame(const uint32_t sequence_num,
                                  const TrajectoryPoint& planning_start_point,
                                  const VehicleState& vehicle_state) {
@@ -282,6 +307,11 @@ void OnLanePlanning::RunOnce(const LocalView& local_view,
     vehicle_state = AlignTimeStamp(vehicle_state, start_timestamp);
   }
 
+  PointENU adc_position;
+  adc_position.set_x(vehicle_state.x());
+  adc_position.set_y(vehicle_state.y());
+  hdmap_->UpdateStreamingPosition(adc_position);
+
   // Update reference line provider and reset scenario if new routing
   reference_line_provider_->UpdateVehicleState(vehicle_state);
   if (local_view_.planning_command->is_motion_command() &&
@@ -294,6 +324,7 @@ void OnLanePlanning::RunOnce(const LocalView& local_view,
     reference_line_provider_->UpdatePlanningCommand(
         *(local_view_.planning_command));
     planner_->Reset(frame_.get());
+    SetMapStreamingRoute(last_command_);
   }
   // Get end lane way point.
   reference_line_provider_->GetEndLaneWayPoint(local_view_.end_lane_way_point);
@@ -428,6 +459,25 @@ void OnLanePlanning::RunOnce(const LocalView& local_view,
   injector_->frame_history()->Add(n, std::move(frame_));
 }
 
+void OnLanePlanning::ExportReferenceLineStats(LatencyStats* latency_stats) {
+  if (!FLAGS_enable_record_debug) {
+    return;
+  }
+  for (const auto& reference_line_info : frame_->reference_line_info()) {
+    auto* stats = latency_stats->add_reference_line_stats();
+    stats->set_id(reference_line_info.Lanes().Id());
+    stats->set_is_change_lane_path(reference_line_info.IsChangeLanePath());
+    stats->set_is_drivable(reference_line_info.IsDrivable());
+    double time_ms = 0.0;
+    for (const auto& task_stats :
+         reference_line_info.latency_stats().task_stats()) {
+      time_ms += task_stats.time_ms();
+      stats->add_task_stats()->CopyFrom(task_stats);
+    }
+    stats->set_time_ms(time_ms);
+  }
+}
+
 void OnLanePlanning::ExportReferenceLineDebug(planning_internal::Debug* debug) {
   if (!FLAGS_enable_record_debug) {
     return;
@@ -590,6 +640,7 @@ Status OnLanePlanning::Plan(
     }
     ptr_trajectory_pb->mutable_latency_stats()->MergeFrom(
         best_ref_info->latency_stats());
+    ExportReferenceLineStats(ptr_trajectory_pb->mutable_latency_stats());
     // set right of way status
     ptr_trajectory_pb->set_right_of_way_status(
         best_ref_info->GetRightOfWayStatus());
@@ -74,7 +74,10 @@ class OnLanePlanning : public PlanningBase {
   common::VehicleState AlignTimeStamp(const common::VehicleState& vehicle_state,
                                       const double curr_timestamp) const;
 
+  void SetMapStreamingRoute(const PlanningCommand& command);
+
   void ExportReferenceLineDebug(planning_internal::Debug* debug);
+  void ExportReferenceLineStats(LatencyStats* latency_stats);
   bool CheckPlanningConfig(const PlanningConfig& config);
   void GenerateStopTrajectory(ADCTrajectory* ptr_trajectory_pb);
   void ExportFailedLaneChangeSTChart(const planning_internal::Debug& debug_info,
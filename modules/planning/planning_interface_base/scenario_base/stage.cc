@@ -20,16 +20,19 @@
 
 #include "modules/planning/planning_interface_base/scenario_base/stage.h"
 
+#include <future>
 #include <unordered_map>
 #include <utility>
 
 #include "cyber/plugin_manager/plugin_manager.h"
+#include "cyber/task/task.h"
 #include "cyber/time/clock.h"
 #include "modules/planning/planning_base/common/frame.h"
 #include "modules/planning/planning_base/common/planning_context.h"
 #include "modules/planning/planning_base/common/speed_profile_generator.h"
 #include "modules/planning/planning_base/common/trajectory/publishable_trajectory.h"
 #include "modules/planning/planning_base/common/util/config_util.h"
+#include "modules/planning/planning_base/gflags/planning_gflags.h"
 #include "modules/planning/planning_interface_base/task_base/task.h"
 
 namespace apollo {
@@ -53,7 +56,17 @@ bool Stage::Init(const StagePipeline& config,
       ->mutable_scenario()
       ->set_stage_type(name_);
   std::string path_name = ConfigUtil::TransformToPathName(name_);
-  std::string task_config_dir = config_dir + "/" + path_name;
+  task_config_dir_ = config_dir + "/" + path_name;
+  TaskPipeline pipeline;
+  if (!CreateTaskPipeline(&pipeline)) {
+    return false;
+  }
+  task_list_ = std::move(pipeline.task_list);
+  fallback_task_ = std::move(pipeline.fallback_task);
+  return true;
+}
+
+bool Stage::CreateTaskPipeline(TaskPipeline* pipeline) const {
   // Load task plugin.
   for (int i = 0; i < pipeline_config_.task_size(); ++i) {
     auto task = pipeline_config_.task(i);
@@ -65,8 +78,8 @@ bool Stage::Init(const StagePipeline& config,
       AERROR << "Create task " << task.name() << " of " << name_ << " failed!";
       return false;
     }
-    if (task_ptr->Init(task_config_dir, task.name(), injector)) {
-      task_list_.push_back(task_ptr);
+    if (task_ptr->Init(task_config_dir_, task.name(), injector_)) {
+      pipeline->task_list.push_back(task_ptr);
     } else {
       AERROR << task.name() << " init failed!";
       return false;
@@ -80,16 +93,17 @@ bool Stage::Init(const StagePipeline& config,
     fallback_task_type = pipeline_config_.fallback_task().type();
     fallback_task_name = pipeline_config_.fallback_task().name();
   }
-  fallback_task_ =
+  pipeline->fallback_task =
       apollo::cyber::plugin_manager::PluginManager::Instance()
           ->CreateInstance<Task>(
               ConfigUtil::GetFullPlanningClassName(fallback_task_type));
-  if (nullptr == fallback_task_) {
+  if (nullptr == pipeline->fallback_task) {
     AERROR << "Create fallback task " << fallback_task_name << " of " << name_
            << " failed!";
     return false;
   }
-  if (!fallback_task_->Init(task_config_dir, fallback_task_name, injector)) {
+  if (!pipeline->fallback_task->Init(task_config_dir_, fallback_task_name,
+                                     injector_)) {
     AERROR << fallback_task_name << " init failed!";
     return false;
   }
@@ -105,6 +119,8 @@ StageResult Stage::ExecuteTaskOnReferenceLine(
     AERROR << "referenceline is empty in stage" << name_;
     return stage_result.SetStageStatus(StageStatusType::ERROR);
   }
+  const TaskPipeline pipeline{task_list_, fallback_task_};
+  std::vector<ReferenceLineInfo*> reference_line_infos;
   for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
     if (!reference_line_info.IsDrivable()) {
       AERROR << "The generated path is not drivable skip";
@@ -117,46 +133,85 @@ StageResult Stage::ExecuteTaskOnReferenceLine(
       reference_line_info.SetDrivable(false);
       continue;
     }
-    common::Status ret = common::Status::OK();
-    for (auto task : task_list_) {
-      const double start_timestamp = Clock::NowInSeconds();
-
-      ret = task->Execute(frame, &reference_line_info);
-
-      const double end_timestamp = Clock::NowInSeconds();
-      const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
-      ADEBUG << "after task[" << task->Name()
-             << "]: " << reference_line_info.PathSpeedDebugString();
-      ADEBUG << task->Name() << " time spend: " << time_diff_ms << " ms.";
-      RecordDebugInfo(&reference_line_info, task->Name(), time_diff_ms);
-
-      if (!ret.ok()) {
-        stage_result.SetTaskStatus(ret);
-        AERROR << "Failed to run tasks[" << task->Name()
-               << "], Error message: " << ret.error_message();
-        break;
-      }
-    }
-    // Generate fallback trajectory in case of task error.
-    if (!ret.ok()) {
-      fallback_task_->Execute(frame, &reference_line_info);
-    }
-    DiscretizedTrajectory trajectory;
-    if (!reference_line_info.CombinePathAndSpeedProfile(
-            planning_start_point.relative_time(),
-            planning_start_point.path_point().s(), &trajectory)) {
-      AERROR << "Fail to aggregate planning trajectory."
-             << reference_line_info.IsChangeLanePath();
-      reference_line_info.SetDrivable(false);
+    if (FLAGS_enable_parallel_reference_line_planning) {
+      reference_line_infos.push_back(&reference_line_info);
       continue;
     }
-    reference_line_info.SetTrajectory(trajectory);
-    reference_line_info.SetDrivable(true);
+    if (ExecuteTaskPipeline(pipeline, planning_start_point, frame,
+                            &reference_line_info, &stage_result)) {
+      return stage_result;
+    }
+  }
+  if (reference_line_infos.empty()) {
     return stage_result;
   }
+
+  // Take the first reference line planned successfully, as the reference
+  // lines after it would not have been planned one after another.
+  PlanOnReferenceLines(
+      reference_line_infos,
+      [this, &planning_start_point, frame](
+          const TaskPipeline& line_pipeline,
+          ReferenceLineInfo* reference_line_info) {
+        StageResult result;
+        if (!ExecuteTaskPipeline(line_pipeline, planning_start_point, frame,
+                                 reference_line_info, &result)) {
+          result.SetStageStatus(StageStatusType::ERROR);
+        }
+        return result;
+      },
+      [&stage_result](const StageResult& result,
+                      ReferenceLineInfo* /*reference_line_info*/) {
+        if (result.IsTaskError()) {
+          stage_result.SetTaskStatus(result.GetTaskStatus());
+        }
+        return !result.HasError();
+      });
   return stage_result;
 }
 
+bool Stage::ExecuteTaskPipeline(
+    const TaskPipeline& pipeline,
+    const common::TrajectoryPoint& planning_start_point, Frame* frame,
+    ReferenceLineInfo* reference_line_info, StageResult* stage_result) {
+  common::Status ret = common::Status::OK();
+  for (auto task : pipeline.task_list) {
+    const double start_timestamp = Clock::NowInSeconds();
+
+    ret = task->Execute(frame, reference_line_info);
+
+    const double end_timestamp = Clock::NowInSeconds();
+    const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
+    ADEBUG << "after task[" << task->Name()
+           << "]: " << reference_line_info->PathSpeedDebugString();
+    ADEBUG << task->Name() << " time spend: " << time_diff_ms << " ms.";
+    RecordDebugInfo(reference_line_info, task->Name(), time_diff_ms);
+
+    if (!ret.ok()) {
+      stage_result->SetTaskStatus(ret);
+      AERROR << "Failed to run tasks[" << task->Name()
+             << "], Error message: " << ret.error_message();
+      break;
+    }
+  }
+  // Generate fallback trajectory in case of task error.
+  if (!ret.ok()) {
+    pipeline.fallback_task->Execute(frame, reference_line_info);
+  }
+  DiscretizedTrajectory trajectory;
+  if (!reference_line_info->CombinePathAndSpeedProfile(
+          planning_start_point.relative_time(),
+          planning_start_point.path_point().s(), &trajectory)) {
+    AERROR << "Fail to aggregate planning trajectory."
+           << reference_line_info->IsChangeLanePath();
+    reference_line_info->SetDrivable(false);
+    return false;
+  }
+  reference_line_info->SetTrajectory(trajectory);
+  reference_line_info->SetDrivable(true);
+  return true;
+}
+
 StageResult Stage::ExecuteTaskOnReferenceLineForOnlineLearning(
     const common::TrajectoryPoint& planning_start_point, Frame* frame) {
   // online learning mode
@@ -246,6 +301,89 @@ StageResult Stage::FinishScenario() {
   return StageResult(StageStatusType::FINISHED);
 }
 
+void Stage::PlanOnReferenceLines(
+    const std::vector<ReferenceLineInfo*>& reference_line_infos,
+    const std::function<StageResult(const TaskPipeline&, ReferenceLineInfo*)>&
+        plan,
+    const std::function<bool(const StageResult&, ReferenceLineInfo*)>&
+        choose) {
+  const size_t num_lines = reference_line_infos.size();
+  const TaskPipeline pipeline{task_list_, fallback_task_};
+  auto choose_line = [&reference_line_infos, &choose](
+                         const size_t i, const StageResult& result) {
+    return choose(result, reference_line_infos[i]);
+  };
+  size_t chosen = num_lines;
+  // The tasks keep state from one planning cycle to the next, so each
+  // reference line needs its own instances of them.
+  while (line_pipelines_.size() + 1 < num_lines) {
+    TaskPipeline line_pipeline;
+    if (!CreateTaskPipeline(&line_pipeline)) {
+      AERROR << "Fail to create the tasks of reference line "
+             << line_pipelines_.size() + 1 << " in stage " << name_
+             << ", plan on the reference lines one after another.";
+      for (size_t i = 0; i < num_lines && chosen == num_lines; ++i) {
+        if (choose_line(i, plan(pipeline, reference_line_infos[i]))) {
+          chosen = i;
+        }
+      }
+      break;
+    }
+    line_pipelines_.push_back(std::move(line_pipeline));
+  }
+  if (line_pipelines_.size() + 1 >= num_lines) {
+    chosen = PlanInParallel(
+        injector_->planning_context(), num_lines,
+        [&](const size_t i) {
+          return plan(i == 0 ? pipeline : line_pipelines_[i - 1],
+                      reference_line_infos[i]);
+        },
+        choose_line);
+  }
+  for (size_t i = chosen + 1; i < num_lines; ++i) {
+    reference_line_infos[i]->SetDrivable(false);
+  }
+}
+
+size_t Stage::PlanInParallel(
+    PlanningContext* planning_context, const size_t num_lines,
+    const std::function<StageResult(size_t)>& plan,
+    const std::function<bool(size_t, const StageResult&)>& choose) {
+  const PlanningStatus base_status = planning_context->planning_status();
+  std::vector<PlanningStatus> statuses(num_lines, base_status);
+  auto plan_on_line = [&](const size_t i) {
+    PlanningContext::ScopedStatus scoped_status(planning_context,
+                                                &statuses[i]);
+    const double start_timestamp = Clock::NowInSeconds();
+    StageResult result = plan(i);
+    ADEBUG << "reference line[" << i << "] time spend: "
+           << (Clock::NowInSeconds() - start_timestamp) * 1000 << " ms.";
+    return result;
+  };
+  std::vector<std::future<StageResult>> futures;
+  for (size_t i = 1; i < num_lines; ++i) {
+    futures.push_back(cyber::Async(plan_on_line, i));
+  }
+  // The first reference line is planned on the calling thread, which would
+  // only wait for the others otherwise.
+  std::vector<StageResult> results(num_lines);
+  if (num_lines > 0) {
+    results[0] = plan_on_line(0);
+  }
+  for (size_t i = 1; i < num_lines; ++i) {
+    results[i] = futures[i - 1].get();
+  }
+  // The reference lines after the chosen one would not have been planned
+  // one after another, their changes to the status are dropped.
+  for (size_t i = 0; i < num_lines; ++i) {
+    planning_context->MergeStatus(base_status, statuses[i]);
+    if (choose(i, results[i])) {
+      return i;
+    }
+  }
+  return num_lines;
+}
+
 void Stage::RecordDebugInfo(ReferenceLineInfo* reference_line_info,
                             const std::string& name,
                             const double time_diff_ms) {
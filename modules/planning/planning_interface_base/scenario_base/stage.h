@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -41,6 +42,7 @@ namespace planning {
 
 class Task;
 class Frame;
+class PlanningContext;
 class ReferenceLineInfo;
 
 class Stage {
@@ -71,6 +73,14 @@ class Stage {
   const std::string& NextStage() const { return next_stage_; }
 
  protected:
+  /**
+   * @brief The tasks run on one reference line.
+   */
+  struct TaskPipeline {
+    std::vector<std::shared_ptr<Task>> task_list;
+    std::shared_ptr<Task> fallback_task;
+  };
+
   StageResult ExecuteTaskOnReferenceLine(
       const common::TrajectoryPoint& planning_start_point, Frame* frame);
 
@@ -81,6 +91,38 @@ class Stage {
 
   virtual StageResult FinishScenario();
 
+  /**
+   * @brief Plans on the reference lines at the same time, the first one on
+   * the calling thread and the others on the task pool. Each reference line
+   * but the first one is planned with its own instances of the tasks.
+   * The reference lines are then chosen from in order, as if they had been
+   * planned one after another, and the ones after the chosen one are set
+   * not drivable.
+   * @param reference_line_infos The reference lines to plan on.
+   * @param plan Plans on one reference line with the given tasks.
+   * @param choose Called in order on the result of each reference line up
+   * to the chosen one, returns true to choose it.
+   */
+  void PlanOnReferenceLines(
+      const std::vector<ReferenceLineInfo*>& reference_line_infos,
+      const std::function<StageResult(const TaskPipeline&,
+                                      ReferenceLineInfo*)>& plan,
+      const std::function<bool(const StageResult&, ReferenceLineInfo*)>&
+          choose);
+
+  /**
+   * @brief Plans on num_lines reference lines at the same time, each one on
+   * its own copy of the planning status. Going through the reference lines
+   * in order, the status changes of each one are applied and choose is
+   * called on its result, until choose returns true. The status changes of
+   * the reference lines after the chosen one are dropped.
+   * @return The index of the chosen reference line, num_lines if none is.
+   */
+  static size_t PlanInParallel(
+      PlanningContext* planning_context, const size_t num_lines,
+      const std::function<StageResult(size_t)>& plan,
+      const std::function<bool(size_t, const StageResult&)>& choose);
+
   void RecordDebugInfo(ReferenceLineInfo* reference_line_info,
                        const std::string& name, const double time_diff_ms);
 
@@ -92,7 +134,19 @@ class Stage {
   StagePipeline pipeline_config_;
 
  private:
+  bool CreateTaskPipeline(TaskPipeline* pipeline) const;
+
+  bool ExecuteTaskPipeline(const TaskPipeline& pipeline,
+                           const common::TrajectoryPoint& planning_start_point,
+                           Frame* frame,
+                           ReferenceLineInfo* reference_line_info,
+                           StageResult* stage_result);
+
   std::string name_;
+  std::string task_config_dir_;
+  // the tasks of the reference lines after the first one when they are
+  // planned at the same time
+  std::vector<TaskPipeline> line_pipelines_;
 };
 
 }  // namespace planning
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/planning_interface_base/scenario_base/stage.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/planning_base/common/planning_context.h"
+
+namespace apollo {
+namespace planning {
+
+class PlanInParallelTest : public ::testing::Test {
+ protected:
+  // Stage is abstract, a test stage gives access to its helpers.
+  class TestStage : public Stage {
+   public:
+    StageResult Process(const common::TrajectoryPoint& planning_init_point,
+                        Frame* frame) override {
+      return StageResult();
+    }
+    using Stage::PlanInParallel;
+  };
+
+  // Each reference line sets its own path id, line 1 also sets a crosswalk
+  // and line 2 fails.
+  size_t Plan(const size_t num_lines, const size_t choose_from) {
+    return TestStage::PlanInParallel(
+        &planning_context_, num_lines,
+        [this](const size_t i) {
+          auto* status = planning_context_.mutable_planning_status();
+          status->mutable_change_lane()->set_path_id(std::to_string(i));
+          if (i == 1) {
+            status->mutable_crosswalk()->set_crosswalk_id("crosswalk");
+          }
+          return i == 2 ? StageResult(StageStatusType::ERROR)
+                        : StageResult(StageStatusType::RUNNING);
+        },
+        [this, choose_from](const size_t i, const StageResult& result) {
+          chosen_from_.push_back(i);
+          return i >= choose_from && !result.HasError();
+        });
+  }
+
+  PlanningContext planning_context_;
+  std::vector<size_t> chosen_from_;
+};
+
+TEST_F(PlanInParallelTest, MergeUpToChosen) {
+  planning_context_.mutable_planning_status()
+      ->mutable_change_lane()
+      ->set_path_id("base");
+  EXPECT_EQ(0, Plan(4, 0));
+  EXPECT_EQ(std::vector<size_t>({0}), chosen_from_);
+  // the changes of the reference lines after the chosen one are dropped
+  const auto& status = planning_context_.planning_status();
+  EXPECT_EQ("0", status.change_lane().path_id());
+  EXPECT_FALSE(status.has_crosswalk());
+}
+
+TEST_F(PlanInParallelTest, MergeInOrder) {
+  // the failed reference line 2 comes before the chosen one, its changes
+  // are applied as if it had been planned before
+  EXPECT_EQ(3, Plan(4, 2));
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2, 3}), chosen_from_);
+  const auto& status = planning_context_.planning_status();
+  EXPECT_EQ("3", status.change_lane().path_id());
+  EXPECT_EQ("crosswalk", status.crosswalk().crosswalk_id());
+}
+
+TEST_F(PlanInParallelTest, NoneChosen) {
+  EXPECT_EQ(3, Plan(3, 2));
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2}), chosen_from_);
+  EXPECT_EQ("2", planning_context_.planning_status().change_lane().path_id());
+  EXPECT_EQ(0, Plan(0, 0));
+}
+
+}  // namespace planning
+}  // namespace apollo
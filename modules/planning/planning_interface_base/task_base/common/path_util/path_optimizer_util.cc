@@ -157,6 +157,10 @@ bool PathOptimizerUtil::OptimizePath(
   auto end_time = std::chrono::system_clock::now();
   std::chrono::duration<double> diff = end_time - start_time;
   ADEBUG << "Path Optimizer used time: " << diff.count() * 1000 << " ms.";
+  ADEBUG << "Path Optimizer setup time: "
+         << piecewise_jerk_problem.setup_time_ms()
+         << " ms, solve time: " << piecewise_jerk_problem.solve_time_ms()
+         << " ms.";
 
   if (!success) {
     AERROR << path_boundary.label() << "piecewise jerk path optimizer failed";
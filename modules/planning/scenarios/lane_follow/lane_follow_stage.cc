@@ -21,6 +21,7 @@
 #include "modules/planning/scenarios/lane_follow/lane_follow_stage.h"
 
 #include <utility>
+#include <vector>
 
 #include "cyber/common/log.h"
 #include "cyber/time/clock.h"
@@ -84,6 +85,9 @@ StageResult LaneFollowStage::Process(
   if (frame->reference_line_info().empty()) {
     return StageResult(StageStatusType::FINISHED);
   }
+  if (FLAGS_enable_parallel_reference_line_planning) {
+    return ProcessInParallel(planning_start_point, frame);
+  }
 
   bool has_drivable_reference_line = false;
 
@@ -107,35 +111,80 @@ StageResult LaneFollowStage::Process(
 
     result =
         PlanOnReferenceLine(planning_start_point, frame, &reference_line_info);
+    UpdateDrivable(result, &reference_line_info, &has_drivable_reference_line);
+  }
 
-    if (!result.HasError()) {
-      if (!reference_line_info.IsChangeLanePath()) {
-        ADEBUG << "reference line is NOT lane change ref.";
-        has_drivable_reference_line = true;
-        continue;
-      }
-      if (reference_line_info.Cost() < kStraightForwardLineCost) {
-        // If the path and speed optimization succeed on target lane while
-        // under smart lane-change or IsClearToChangeLane under older version
-        has_drivable_reference_line = true;
-        reference_line_info.SetDrivable(true);
-      } else {
-        reference_line_info.SetDrivable(false);
-        ADEBUG << "\tlane change failed";
-      }
-    } else {
-      reference_line_info.SetDrivable(false);
-    }
+  return has_drivable_reference_line
+             ? result.SetStageStatus(StageStatusType::RUNNING)
+             : result.SetStageStatus(StageStatusType::ERROR);
+}
+
+StageResult LaneFollowStage::ProcessInParallel(
+    const TrajectoryPoint& planning_start_point, Frame* frame) {
+  std::vector<ReferenceLineInfo*> reference_line_infos;
+  for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
+    reference_line_infos.push_back(&reference_line_info);
   }
+  ADEBUG << "Number of reference lines:\t" << reference_line_infos.size();
+  // Choose in the same way as when the reference lines are planned one after
+  // another, up to the first drivable one.
+  bool has_drivable_reference_line = false;
+  StageResult result;
+  PlanOnReferenceLines(
+      reference_line_infos,
+      [this, &planning_start_point, frame](
+          const TaskPipeline& pipeline,
+          ReferenceLineInfo* reference_line_info) {
+        return PlanOnReferenceLine(planning_start_point, frame,
+                                   reference_line_info, pipeline);
+      },
+      [this, &result, &has_drivable_reference_line](
+          const StageResult& line_result,
+          ReferenceLineInfo* reference_line_info) {
+        result = line_result;
+        UpdateDrivable(result, reference_line_info,
+                       &has_drivable_reference_line);
+        return has_drivable_reference_line;
+      });
 
   return has_drivable_reference_line
              ? result.SetStageStatus(StageStatusType::RUNNING)
              : result.SetStageStatus(StageStatusType::ERROR);
 }
 
+void LaneFollowStage::UpdateDrivable(const StageResult& result,
+                                     ReferenceLineInfo* reference_line_info,
+                                     bool* has_drivable_reference_line) {
+  if (result.HasError()) {
+    reference_line_info->SetDrivable(false);
+    return;
+  }
+  if (!reference_line_info->IsChangeLanePath()) {
+    ADEBUG << "reference line is NOT lane change ref.";
+    *has_drivable_reference_line = true;
+    return;
+  }
+  if (reference_line_info->Cost() < kStraightForwardLineCost) {
+    // If the path and speed optimization succeed on target lane while
+    // under smart lane-change or IsClearToChangeLane under older version
+    *has_drivable_reference_line = true;
+    reference_line_info->SetDrivable(true);
+  } else {
+    reference_line_info->SetDrivable(false);
+    ADEBUG << "\tlane change failed";
+  }
+}
+
 StageResult LaneFollowStage::PlanOnReferenceLine(
     const TrajectoryPoint& planning_start_point, Frame* frame,
     ReferenceLineInfo* reference_line_info) {
+  return PlanOnReferenceLine(planning_start_point, frame, reference_line_info,
+                             {task_list_, fallback_task_});
+}
+
+StageResult LaneFollowStage::PlanOnReferenceLine(
+    const TrajectoryPoint& planning_start_point, Frame* frame,
+    ReferenceLineInfo* reference_line_info, const TaskPipeline& pipeline) {
   if (!reference_line_info->IsChangeLanePath()) {
     reference_line_info->AddCost(kStraightForwardLineCost);
   }
@@ -144,7 +193,7 @@ StageResult LaneFollowStage::PlanOnReferenceLine(
          << reference_line_info->IsChangeLanePath();
 
   StageResult ret;
-  for (auto task : task_list_) {
+  for (auto task : pipeline.task_list) {
     const double start_timestamp = Clock::NowInSeconds();
 
     ret.SetTaskStatus(task->Execute(frame, reference_line_info));
@@ -175,7 +224,7 @@ StageResult LaneFollowStage::PlanOnReferenceLine(
   // check path and speed results for path or speed fallback
   reference_line_info->set_trajectory_type(ADCTrajectory::NORMAL);
   if (ret.IsTaskError()) {
-    fallback_task_->Execute(frame, reference_line_info);
+    pipeline.fallback_task->Execute(frame, reference_line_info);
   }
 
   DiscretizedTrajectory trajectory;
@@ -53,6 +53,18 @@ class LaneFollowStage : public Stage {
                             const ReferenceLine& reference_line) const;
 
   void RecordObstacleDebugInfo(ReferenceLineInfo* reference_line_info);
+
+ private:
+  StageResult PlanOnReferenceLine(
+      const common::TrajectoryPoint& planning_start_point, Frame* frame,
+      ReferenceLineInfo* reference_line_info, const TaskPipeline& pipeline);
+
+  StageResult ProcessInParallel(
+      const common::TrajectoryPoint& planning_start_point, Frame* frame);
+
+  void UpdateDrivable(const StageResult& result,
+                      ReferenceLineInfo* reference_line_info,
+                      bool* has_drivable_reference_line);
 };
 
 CYBER_PLUGIN_MANAGER_REGISTER_PLUGIN(apollo::planning::LaneFollowStage, Stage)
@@ -31,7 +31,30 @@ namespace apollo {
 namespace planning {
 namespace {
 constexpr double kInf = std::numeric_limits<double>::infinity();
+
+constexpr double kAccelResolution = 0.1;
+constexpr size_t kAccelShift = 100;
+constexpr double kJerkResolution = 0.1;
+constexpr size_t kJerkShift = 200;
+
+// The s range between the lower and upper points of the boundary at time t,
+// which is strictly inside of its time range.
+void GetOccupiedSRange(const std::vector<STPoint>& lower_points,
+                       const std::vector<STPoint>& upper_points,
+                       const double t, double* s_lower, double* s_upper) {
+  auto comp = [](const STPoint& p, const double t) { return p.t() < t; };
+  const size_t right = std::distance(
+      lower_points.begin(),
+      std::lower_bound(lower_points.begin(), lower_points.end(), t, comp));
+  const size_t left = right - 1;
+  const double r = (t - upper_points[left].t()) /
+                   (upper_points[right].t() - upper_points[left].t());
+  *s_upper = upper_points[left].s() +
+             r * (upper_points[right].s() - upper_points[left].s());
+  *s_lower = lower_points[left].s() +
+             r * (lower_points[right].s() - lower_points[left].s());
 }
+}  // namespace
 
 DpStCost::DpStCost(const DpStSpeedOptimizerConfig& config, const double total_t,
                    const double total_s,
@@ -44,22 +67,103 @@ DpStCost::DpStCost(const DpStSpeedOptimizerConfig& config, const double total_t,
       init_point_(init_point),
       unit_t_(config.unit_t()),
       total_s_(total_s) {
-  int index = 0;
-  for (const auto& obstacle : obstacles) {
-    boundary_map_[obstacle->path_st_boundary().id()] = index++;
-  }
+  max_adc_stop_speed_ = common::VehicleConfigHelper::Instance()
+                            ->GetConfig()
+                            .vehicle_param()
+                            .max_abs_speed_when_stopped();
 
   AddToKeepClearRange(obstacles);
+  InitTimeLayers(total_t);
+  InitAccelCost();
+  InitJerkCost();
+}
 
+void DpStCost::InitTimeLayers(const double total_t) {
   const auto dimension_t =
       static_cast<uint32_t>(std::ceil(total_t / static_cast<double>(unit_t_))) +
       1;
-  boundary_cost_.resize(obstacles_.size());
-  for (auto& vec : boundary_cost_) {
-    vec.resize(dimension_t, std::make_pair(-1.0, -1.0));
+  // the times are accumulated as those of the graph points
+  time_layers_.resize(dimension_t);
+  double t = 0.0;
+  for (uint32_t i = 0; i < dimension_t; ++i, t += unit_t_) {
+    time_layers_[i].t = t;
+  }
+
+  for (const auto* obstacle : obstacles_) {
+    // Not applying obstacle approaching cost to virtual obstacle like created
+    // stop fences
+    if (obstacle->IsVirtual()) {
+      continue;
+    }
+
+    // Stop obstacles are assumed to have a safety margin when mapping them out,
+    // so repelling force in dp st is not needed as it is designed to have adc
+    // stop right at the stop distance we design in prior mapping process
+    if (obstacle->LongitudinalDecision().has_stop()) {
+      continue;
+    }
+
+    const auto& boundary = obstacle->path_st_boundary();
+    if (boundary.IsEmpty() ||
+        boundary.min_s() > FLAGS_speed_lon_decision_horizon) {
+      continue;
+    }
+    const auto lower_points = boundary.lower_points();
+    const auto upper_points = boundary.upper_points();
+
+    for (auto& layer : time_layers_) {
+      const double t = layer.t;
+      if (t < boundary.min_t() || t > boundary.max_t()) {
+        continue;
+      }
+      ObstacleRange range;
+      boundary.GetBoundarySRange(t, &range.s_upper, &range.s_lower);
+      if (t > boundary.min_t() && t < boundary.max_t()) {
+        range.is_blocking = true;
+        GetOccupiedSRange(lower_points, upper_points, t,
+                          &range.blocked_s_lower, &range.blocked_s_upper);
+      }
+      layer.obstacle_ranges.push_back(range);
+    }
+  }
+}
+
+void DpStCost::InitAccelCost() {
+  const double max_acc = config_.max_acceleration();
+  const double max_dec = config_.max_deceleration();
+  const double accel_penalty = config_.accel_penalty();
+  const double decel_penalty = config_.decel_penalty();
+  for (size_t i = 0; i < accel_cost_.size(); ++i) {
+    const double accel =
+        (static_cast<double>(i) - static_cast<double>(kAccelShift)) *
+        kAccelResolution;
+    const double accel_sq = accel * accel;
+    double cost = 0.0;
+    if (accel > 0.0) {
+      cost = accel_penalty * accel_sq;
+    } else {
+      cost = decel_penalty * accel_sq;
+    }
+    cost += accel_sq * decel_penalty * decel_penalty /
+                (1 + std::exp(1.0 * (accel - max_dec))) +
+            accel_sq * accel_penalty * accel_penalty /
+                (1 + std::exp(-1.0 * (accel - max_acc)));
+    accel_cost_[i] = cost;
+  }
+}
+
+void DpStCost::InitJerkCost() {
+  for (size_t i = 0; i < jerk_cost_.size(); ++i) {
+    const double jerk =
+        (static_cast<double>(i) - static_cast<double>(kJerkShift)) *
+        kJerkResolution;
+    const double jerk_sq = jerk * jerk;
+    if (jerk > 0) {
+      jerk_cost_[i] = config_.positive_jerk_coeff() * jerk_sq * unit_t_;
+    } else {
+      jerk_cost_[i] = config_.negative_jerk_coeff() * jerk_sq * unit_t_;
+    }
   }
-  accel_cost_.fill(-1.0);
-  jerk_cost_.fill(-1.0);
 }
 
 void DpStCost::AddToKeepClearRange(
@@ -110,16 +214,15 @@ bool DpStCost::InKeepClearRange(double s) const {
   return false;
 }
 
-double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
-  const double s = st_graph_point.point().s();
-  const double t = st_graph_point.point().t();
-
+double DpStCost::GetObstacleCost(const uint32_t index_t,
+                                 const double s) const {
+  const auto& layer = time_layers_[index_t];
   double cost = 0.0;
 
   if (FLAGS_use_st_drivable_boundary) {
     // TODO(Jiancheng): move to configs
     static constexpr double boundary_resolution = 0.1;
-    int index = static_cast<int>(t / boundary_resolution);
+    int index = static_cast<int>(layer.t / boundary_resolution);
     const double lower_bound =
         st_drivable_boundary_.st_boundary(index).s_lower();
     const double upper_bound =
@@ -130,59 +233,28 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
     }
   }
 
-  for (const auto* obstacle : obstacles_) {
-    // Not applying obstacle approaching cost to virtual obstacle like created
-    // stop fences
-    if (obstacle->IsVirtual()) {
-      continue;
-    }
-
-    // Stop obstacles are assumed to have a safety margin when mapping them out,
-    // so repelling force in dp st is not needed as it is designed to have adc
-    // stop right at the stop distance we design in prior mapping process
-    if (obstacle->LongitudinalDecision().has_stop()) {
-      continue;
-    }
-
-    auto boundary = obstacle->path_st_boundary();
-
-    if (boundary.min_s() > FLAGS_speed_lon_decision_horizon) {
-      continue;
-    }
-    if (t < boundary.min_t() || t > boundary.max_t()) {
-      continue;
-    }
-    if (boundary.IsPointInBoundary(st_graph_point.point())) {
+  for (const auto& range : layer.obstacle_ranges) {
+    if (range.is_blocking && s > range.blocked_s_lower &&
+        s < range.blocked_s_upper) {
       return kInf;
     }
-    double s_upper = 0.0;
-    double s_lower = 0.0;
-
-    int boundary_index = boundary_map_[boundary.id()];
-    if (boundary_cost_[boundary_index][st_graph_point.index_t()].first < 0.0) {
-      boundary.GetBoundarySRange(t, &s_upper, &s_lower);
-      boundary_cost_[boundary_index][st_graph_point.index_t()] =
-          std::make_pair(s_upper, s_lower);
-    } else {
-      s_upper = boundary_cost_[boundary_index][st_graph_point.index_t()].first;
-      s_lower = boundary_cost_[boundary_index][st_graph_point.index_t()].second;
-    }
-    if (s < s_lower) {
+    if (s < range.s_lower) {
       const double follow_distance_s = config_.safe_distance();
-      if (s + follow_distance_s < s_lower) {
+      if (s + follow_distance_s < range.s_lower) {
         continue;
       } else {
-        auto s_diff = follow_distance_s - s_lower + s;
+        auto s_diff = follow_distance_s - range.s_lower + s;
         cost += config_.obstacle_weight() * config_.default_obstacle_cost() *
                 s_diff * s_diff;
       }
-    } else if (s > s_upper) {
+    } else if (s > range.s_upper) {
       const double overtake_distance_s =
           StGapEstimator::EstimateSafeOvertakingGap();
-      if (s > s_upper + overtake_distance_s) {  // or calculated from velocity
+      if (s > range.s_upper + overtake_distance_s) {
+        // or calculated from velocity
         continue;
       } else {
-        auto s_diff = overtake_distance_s + s_upper - s;
+        auto s_diff = overtake_distance_s + range.s_upper - s;
         cost += config_.obstacle_weight() * config_.default_obstacle_cost() *
                 s_diff * s_diff;
       }
@@ -191,8 +263,8 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
   return cost * unit_t_;
 }
 
-double DpStCost::GetSpatialPotentialCost(const StGraphPoint& point) {
-  return (total_s_ - point.point().s()) * config_.spatial_potential_penalty();
+double DpStCost::GetSpatialPotentialCost(const double s) const {
+  return (total_s_ - s) * config_.spatial_potential_penalty();
 }
 
 double DpStCost::GetReferenceCost(const STPoint& point,
@@ -210,11 +282,7 @@ double DpStCost::GetSpeedCost(const STPoint& first, const STPoint& second,
     return kInf;
   }
 
-  const double max_adc_stop_speed = common::VehicleConfigHelper::Instance()
-                                        ->GetConfig()
-                                        .vehicle_param()
-                                        .max_abs_speed_when_stopped();
-  if (speed < max_adc_stop_speed && InKeepClearRange(second.s())) {
+  if (speed < max_adc_stop_speed_ && InKeepClearRange(second.s())) {
     // first.s in range
     cost += config_.keep_clear_low_speed_penalty() * unit_t_ *
             config_.default_speed_cost();
@@ -238,83 +306,45 @@ double DpStCost::GetSpeedCost(const STPoint& first, const STPoint& second,
   return cost;
 }
 
-double DpStCost::GetAccelCost(const double accel) {
-  double cost = 0.0;
-  static constexpr double kEpsilon = 0.1;
-  static constexpr size_t kShift = 100;
-  const size_t accel_key = static_cast<size_t>(accel / kEpsilon + 0.5 + kShift);
+double DpStCost::GetAccelCost(const double accel) const {
+  const size_t accel_key =
+      static_cast<size_t>(accel / kAccelResolution + 0.5 + kAccelShift);
   DCHECK_LT(accel_key, accel_cost_.size());
   if (accel_key >= accel_cost_.size()) {
     return kInf;
   }
-
-  if (accel_cost_.at(accel_key) < 0.0) {
-    const double accel_sq = accel * accel;
-    double max_acc = config_.max_acceleration();
-    double max_dec = config_.max_deceleration();
-    double accel_penalty = config_.accel_penalty();
-    double decel_penalty = config_.decel_penalty();
-
-    if (accel > 0.0) {
-      cost = accel_penalty * accel_sq;
-    } else {
-      cost = decel_penalty * accel_sq;
-    }
-    cost += accel_sq * decel_penalty * decel_penalty /
-                (1 + std::exp(1.0 * (accel - max_dec))) +
-            accel_sq * accel_penalty * accel_penalty /
-                (1 + std::exp(-1.0 * (accel - max_acc)));
-    accel_cost_.at(accel_key) = cost;
-  } else {
-    cost = accel_cost_.at(accel_key);
-  }
-  return cost * unit_t_;
+  return accel_cost_[accel_key] * unit_t_;
 }
 
 double DpStCost::GetAccelCostByThreePoints(const STPoint& first,
                                            const STPoint& second,
-                                           const STPoint& third) {
+                                           const STPoint& third) const {
   double accel = (first.s() + third.s() - 2 * second.s()) / (unit_t_ * unit_t_);
   return GetAccelCost(accel);
 }
 
 double DpStCost::GetAccelCostByTwoPoints(const double pre_speed,
                                          const STPoint& pre_point,
-                                         const STPoint& curr_point) {
+                                         const STPoint& curr_point) const {
   double current_speed = (curr_point.s() - pre_point.s()) / unit_t_;
   double accel = (current_speed - pre_speed) / unit_t_;
   return GetAccelCost(accel);
 }
 
-double DpStCost::JerkCost(const double jerk) {
-  double cost = 0.0;
-  static constexpr double kEpsilon = 0.1;
-  static constexpr size_t kShift = 200;
-  const size_t jerk_key = static_cast<size_t>(jerk / kEpsilon + 0.5 + kShift);
+double DpStCost::JerkCost(const double jerk) const {
+  const size_t jerk_key =
+      static_cast<size_t>(jerk / kJerkResolution + 0.5 + kJerkShift);
   if (jerk_key >= jerk_cost_.size()) {
     return kInf;
   }
-
-  if (jerk_cost_.at(jerk_key) < 0.0) {
-    double jerk_sq = jerk * jerk;
-    if (jerk > 0) {
-      cost = config_.positive_jerk_coeff() * jerk_sq * unit_t_;
-    } else {
-      cost = config_.negative_jerk_coeff() * jerk_sq * unit_t_;
-    }
-    jerk_cost_.at(jerk_key) = cost;
-  } else {
-    cost = jerk_cost_.at(jerk_key);
-  }
-
   // TODO(All): normalize to unit_t_
-  return cost;
+  return jerk_cost_[jerk_key];
 }
 
 double DpStCost::GetJerkCostByFourPoints(const STPoint& first,
                                          const STPoint& second,
                                          const STPoint& third,
-                                         const STPoint& fourth) {
+                                         const STPoint& fourth) const {
   double jerk = (fourth.s() - 3 * third.s() + 3 * second.s() - first.s()) /
                 (unit_t_ * unit_t_ * unit_t_);
   return JerkCost(jerk);
@@ -323,7 +353,7 @@ double DpStCost::GetJerkCostByFourPoints(const STPoint& first,
 double DpStCost::GetJerkCostByTwoPoints(const double pre_speed,
                                         const double pre_acc,
                                         const STPoint& pre_point,
-                                        const STPoint& curr_point) {
+                                        const STPoint& curr_point) const {
   const double curr_speed = (curr_point.s() - pre_point.s()) / unit_t_;
   const double curr_accel = (curr_speed - pre_speed) / unit_t_;
   const double jerk = (curr_accel - pre_acc) / unit_t_;
@@ -333,7 +363,7 @@ double DpStCost::GetJerkCostByTwoPoints(const double pre_speed,
 double DpStCost::GetJerkCostByThreePoints(const double first_speed,
                                           const STPoint& first,
                                           const STPoint& second,
-                                          const STPoint& third) {
+                                          const STPoint& third) const {
   const double pre_speed = (second.s() - first.s()) / unit_t_;
   const double pre_acc = (pre_speed - first_speed) / unit_t_;
   const double curr_speed = (third.s() - second.s()) / unit_t_;
@@ -20,8 +20,7 @@
 
 #pragma once
 
-#include <string>
-#include <unordered_map>
+#include <array>
 #include <utility>
 #include <vector>
 
@@ -31,7 +30,6 @@
 #include "modules/planning/planning_base/common/obstacle.h"
 #include "modules/planning/planning_base/common/speed/st_boundary.h"
 #include "modules/planning/planning_base/common/speed/st_point.h"
-#include "modules/planning/tasks/path_time_heuristic/st_graph_point.h"
 
 namespace apollo {
 namespace planning {
@@ -43,9 +41,15 @@ class DpStCost {
            const STDrivableBoundary& st_drivable_boundary,
            const common::TrajectoryPoint& init_point);
 
-  double GetObstacleCost(const StGraphPoint& point);
+  /*
+   * @brief The obstacle cost of a point of the graph, which is infinite if the
+   * point collides with an obstacle.
+   * @param index_t The time layer of the point.
+   * @param s The s of the point.
+   */
+  double GetObstacleCost(const uint32_t index_t, const double s) const;
 
-  double GetSpatialPotentialCost(const StGraphPoint& point);
+  double GetSpatialPotentialCost(const double s) const;
 
   double GetReferenceCost(const STPoint& point,
                           const STPoint& reference_point) const;
@@ -55,24 +59,47 @@ class DpStCost {
                       const double cruise_speed) const;
 
   double GetAccelCostByTwoPoints(const double pre_speed, const STPoint& first,
-                                 const STPoint& second);
+                                 const STPoint& second) const;
   double GetAccelCostByThreePoints(const STPoint& first, const STPoint& second,
-                                   const STPoint& third);
+                                   const STPoint& third) const;
 
   double GetJerkCostByTwoPoints(const double pre_speed, const double pre_acc,
                                 const STPoint& pre_point,
-                                const STPoint& curr_point);
+                                const STPoint& curr_point) const;
   double GetJerkCostByThreePoints(const double first_speed,
                                   const STPoint& first_point,
                                   const STPoint& second_point,
-                                  const STPoint& third_point);
+                                  const STPoint& third_point) const;
 
   double GetJerkCostByFourPoints(const STPoint& first, const STPoint& second,
-                                 const STPoint& third, const STPoint& fourth);
+                                 const STPoint& third,
+                                 const STPoint& fourth) const;
 
  private:
-  double GetAccelCost(const double accel);
-  double JerkCost(const double jerk);
+  // The s range of an obstacle at a time layer of the graph.
+  struct ObstacleRange {
+    // the range the obstacle cost is measured from
+    double s_lower = 0.0;
+    double s_upper = 0.0;
+    // the points strictly inside of the range collide with the obstacle
+    bool is_blocking = false;
+    double blocked_s_lower = 0.0;
+    double blocked_s_upper = 0.0;
+  };
+
+  // A time layer of the graph.
+  struct TimeLayer {
+    double t = 0.0;
+    std::vector<ObstacleRange> obstacle_ranges;
+  };
+
+  void InitTimeLayers(const double total_t);
+
+  void InitAccelCost();
+  void InitJerkCost();
+
+  double GetAccelCost(const double accel) const;
+  double JerkCost(const double jerk) const;
 
   void AddToKeepClearRange(const std::vector<const Obstacle*>& obstacles);
   static void SortAndMergeRange(
@@ -88,12 +115,16 @@ class DpStCost {
 
   double unit_t_ = 0.0;
   double total_s_ = 0.0;
+  double max_adc_stop_speed_ = 0.0;
 
-  std::unordered_map<std::string, int> boundary_map_;
-  std::vector<std::vector<std::pair<double, double>>> boundary_cost_;
+  // the ranges of the obstacles considered at each time layer, computed once
+  // rather than for every point of the layer
+  std::vector<TimeLayer> time_layers_;
 
   std::vector<std::pair<double, double>> keep_clear_range_;
 
+  // the costs are tabulated up front so the graph can be searched by several
+  // threads at once
   std::array<double, 200> accel_cost_;
   std::array<double, 400> jerk_cost_;
 };
@@ -44,11 +44,12 @@ using apollo::common::util::PointFactory;
 namespace {
 
 static constexpr double kDoubleEpsilon = 1.0e-6;
+static constexpr double kInf = std::numeric_limits<double>::infinity();
 
 // Continuous-time collision check using linear interpolation as closed-loop
 // dynamics
 bool CheckOverlapOnDpStGraph(const std::vector<const STBoundary*>& boundaries,
-                             const StGraphPoint& p1, const StGraphPoint& p2) {
+                             const STPoint& p1, const STPoint& p2) {
   if (FLAGS_use_st_drivable_boundary) {
     return false;
   }
@@ -57,7 +58,7 @@ bool CheckOverlapOnDpStGraph(const std::vector<const STBoundary*>& boundaries,
       continue;
     }
     // Check collision between a polygon and a line segment
-    if (boundary->HasOverlap({p1.point(), p2.point()})) {
+    if (boundary->HasOverlap({p1, p2})) {
       return true;
     }
   }
@@ -185,31 +186,34 @@ Status GriddedPathTimeGraph::InitCostTable() {
     return Status(ErrorCode::PLANNING_ERROR, msg);
   }
 
-  cost_table_ = std::vector<std::vector<StGraphPoint>>(
-      dimension_t_, std::vector<StGraphPoint>(dimension_s_, StGraphPoint()));
-
+  time_by_index_ = std::vector<double>(dimension_t_, 0.0);
   double curr_t = 0.0;
-  for (uint32_t i = 0; i < cost_table_.size(); ++i, curr_t += unit_t_) {
-    auto& cost_table_i = cost_table_[i];
-    double curr_s = 0.0;
-    for (uint32_t j = 0; j < dense_dimension_s_; ++j, curr_s += dense_unit_s_) {
-      cost_table_i[j].Init(i, j, STPoint(curr_s, curr_t));
-      debug.AddPoint("dp_node_points", curr_t, curr_s);
-    }
-    curr_s = static_cast<double>(dense_dimension_s_ - 1) * dense_unit_s_ +
-             sparse_unit_s_;
-    for (uint32_t j = dense_dimension_s_; j < cost_table_i.size();
-         ++j, curr_s += sparse_unit_s_) {
-      cost_table_i[j].Init(i, j, STPoint(curr_s, curr_t));
-      debug.AddPoint("dp_node_points", curr_t, curr_s);
-    }
+  for (uint32_t i = 0; i < dimension_t_; ++i, curr_t += unit_t_) {
+    time_by_index_[i] = curr_t;
   }
 
-  const auto& cost_table_0 = cost_table_[0];
-  spatial_distance_by_index_ = std::vector<double>(cost_table_0.size(), 0.0);
-  for (uint32_t i = 0; i < cost_table_0.size(); ++i) {
-    spatial_distance_by_index_[i] = cost_table_0[i].point().s();
+  spatial_distance_by_index_ = std::vector<double>(dimension_s_, 0.0);
+  double curr_s = 0.0;
+  for (uint32_t j = 0; j < dense_dimension_s_; ++j, curr_s += dense_unit_s_) {
+    spatial_distance_by_index_[j] = curr_s;
+  }
+  curr_s = static_cast<double>(dense_dimension_s_ - 1) * dense_unit_s_ +
+           sparse_unit_s_;
+  for (uint32_t j = dense_dimension_s_; j < dimension_s_;
+       ++j, curr_s += sparse_unit_s_) {
+    spatial_distance_by_index_[j] = curr_s;
+  }
+
+  for (const double t : time_by_index_) {
+    for (const double s : spatial_distance_by_index_) {
+      debug.AddPoint("dp_node_points", t, s);
+    }
   }
+
+  const size_t num_points = static_cast<size_t>(dimension_t_) * dimension_s_;
+  total_cost_ = std::vector<double>(num_points, kInf);
+  optimal_speed_ = std::vector<double>(num_points, 0.0);
+  pre_row_ = std::vector<int32_t>(num_points, -1);
   return Status::OK();
 }
 
@@ -221,7 +225,7 @@ Status GriddedPathTimeGraph::InitSpeedLimitLookUp() {
 
   for (uint32_t i = 0; i < dimension_s_; ++i) {
     speed_limit_by_index_[i] =
-        speed_limit.GetSpeedLimitByS(cost_table_[0][i].point().s());
+        speed_limit.GetSpeedLimitByS(spatial_distance_by_index_[i]);
   }
   return Status::OK();
 }
@@ -233,38 +237,47 @@ Status GriddedPathTimeGraph::CalculateTotalCost() {
   size_t next_highest_row = 0;
   size_t next_lowest_row = 0;
 
-  for (size_t c = 0; c < cost_table_.size(); ++c) {
+  // The points of a col only depend on the previous cols, so the rows of a
+  // col are calculated concurrently, in chunks big enough to pay for the
+  // tasks.
+  static constexpr size_t kNumRowsPerTask = 16;
+  const bool enable_multi_thread =
+      gridded_path_time_graph_config_.enable_multi_thread_in_dp_st_graph();
+
+  for (uint32_t c = 0; c < dimension_t_; ++c) {
     size_t highest_row = 0;
-    size_t lowest_row = cost_table_.back().size() - 1;
-
-    int count = static_cast<int>(next_highest_row) -
-                static_cast<int>(next_lowest_row) + 1;
-    if (count > 0) {
-      std::vector<std::future<void>> results;
-      for (size_t r = next_lowest_row; r <= next_highest_row; ++r) {
-        auto msg = std::make_shared<StGraphMessage>(c, r);
-        if (gridded_path_time_graph_config_
-                .enable_multi_thread_in_dp_st_graph()) {
-          results.push_back(
-              cyber::Async(&GriddedPathTimeGraph::CalculateCostAt, this, msg));
-        } else {
-          CalculateCostAt(msg);
+    size_t lowest_row = dimension_s_ - 1;
+
+    const size_t end_row = next_highest_row + 1;
+    if (next_lowest_row < end_row) {
+      if (enable_multi_thread) {
+        std::vector<std::future<void>> results;
+        for (size_t begin = next_lowest_row + kNumRowsPerTask; begin < end_row;
+             begin += kNumRowsPerTask) {
+          results.push_back(cyber::Async(
+              &GriddedPathTimeGraph::CalculateCostsAt, this, c,
+              static_cast<uint32_t>(begin),
+              static_cast<uint32_t>(std::min(begin + kNumRowsPerTask,
+                                             end_row))));
         }
-      }
-      if (gridded_path_time_graph_config_
-              .enable_multi_thread_in_dp_st_graph()) {
+        CalculateCostsAt(
+            c, static_cast<uint32_t>(next_lowest_row),
+            static_cast<uint32_t>(
+                std::min(next_lowest_row + kNumRowsPerTask, end_row)));
         for (auto& result : results) {
           result.get();
         }
+      } else {
+        CalculateCostsAt(c, static_cast<uint32_t>(next_lowest_row),
+                         static_cast<uint32_t>(end_row));
       }
     }
 
     for (size_t r = next_lowest_row; r <= next_highest_row; ++r) {
-      const auto& cost_cr = cost_table_[c][r];
-      if (cost_cr.total_cost() < std::numeric_limits<double>::infinity()) {
+      if (total_cost_[CellIndex(c, static_cast<uint32_t>(r))] < kInf) {
         size_t h_r = 0;
         size_t l_r = 0;
-        GetRowRange(cost_cr, &h_r, &l_r);
+        GetRowRange(c, static_cast<uint32_t>(r), &h_r, &l_r);
         highest_row = std::max(highest_row, h_r);
         lowest_row = std::min(lowest_row, l_r);
       }
@@ -276,26 +289,27 @@ Status GriddedPathTimeGraph::CalculateTotalCost() {
   return Status::OK();
 }
 
-void GriddedPathTimeGraph::GetRowRange(const StGraphPoint& point,
+void GriddedPathTimeGraph::GetRowRange(const uint32_t c, const uint32_t r,
                                        size_t* next_highest_row,
-                                       size_t* next_lowest_row) {
+                                       size_t* next_lowest_row) const {
   double v0 = 0.0;
-  // TODO(all): Record speed information in StGraphPoint and deprecate this.
+  // TODO(all): Record speed information in the cost table and deprecate this.
   // A scaling parameter for DP range search due to the lack of accurate
   // information of the current velocity (set to 1 by default since we use
   // past 1 second's average v as approximation)
   double acc_coeff = 0.5;
-  if (!point.pre_point()) {
+  const size_t index = CellIndex(c, r);
+  if (pre_row_[index] < 0) {
     v0 = init_point_.v();
   } else {
-    v0 = point.GetOptimalSpeed();
+    v0 = optimal_speed_[index];
   }
 
   const auto max_s_size = dimension_s_ - 1;
   const double t_squared = unit_t_ * unit_t_;
   const double s_upper_bound = v0 * unit_t_ +
                                acc_coeff * max_acceleration_ * t_squared +
-                               point.point().s();
+                               spatial_distance_by_index_[r];
   const auto next_highest_itr =
       std::lower_bound(spatial_distance_by_index_.begin(),
                        spatial_distance_by_index_.end(), s_upper_bound);
@@ -308,7 +322,7 @@ void GriddedPathTimeGraph::GetRowRange(const StGraphPoint& point,
 
   const double s_lower_bound =
       std::fmax(0.0, v0 * unit_t_ + acc_coeff * max_deceleration_ * t_squared) +
-      point.point().s();
+      spatial_distance_by_index_[r];
   const auto next_lowest_itr =
       std::lower_bound(spatial_distance_by_index_.begin(),
                        spatial_distance_by_index_.end(), s_lower_bound);
@@ -320,24 +334,29 @@ void GriddedPathTimeGraph::GetRowRange(const StGraphPoint& point,
   }
 }
 
-void GriddedPathTimeGraph::CalculateCostAt(
-    const std::shared_ptr<StGraphMessage>& msg) {
-  const uint32_t c = msg->c;
-  const uint32_t r = msg->r;
-  auto& cost_cr = cost_table_[c][r];
+void GriddedPathTimeGraph::CalculateCostsAt(const uint32_t c,
+                                            const uint32_t begin_row,
+                                            const uint32_t end_row) {
+  for (uint32_t r = begin_row; r < end_row; ++r) {
+    CalculateCostAt(c, r);
+  }
+}
+
+void GriddedPathTimeGraph::CalculateCostAt(const uint32_t c, const uint32_t r) {
+  const size_t index = CellIndex(c, r);
+  const STPoint curr_point = PointAt(c, r);
 
-  cost_cr.SetObstacleCost(dp_st_cost_.GetObstacleCost(cost_cr));
-  if (cost_cr.obstacle_cost() > std::numeric_limits<double>::max()) {
+  const double obstacle_cost = dp_st_cost_.GetObstacleCost(c, curr_point.s());
+  if (obstacle_cost > std::numeric_limits<double>::max()) {
     return;
   }
+  const double point_cost =
+      obstacle_cost + dp_st_cost_.GetSpatialPotentialCost(curr_point.s());
 
-  cost_cr.SetSpatialPotentialCost(dp_st_cost_.GetSpatialPotentialCost(cost_cr));
-
-  const auto& cost_init = cost_table_[0][0];
   if (c == 0) {
     DCHECK_EQ(r, 0U) << "Incorrect. Row should be 0 with col = 0. row: " << r;
-    cost_cr.SetTotalCost(0.0);
-    cost_cr.SetOptimalSpeed(init_point_.v());
+    total_cost_[index] = 0.0;
+    optimal_speed_[index] = init_point_.v();
     return;
   }
 
@@ -349,32 +368,31 @@ void GriddedPathTimeGraph::CalculateCostAt(
 
   if (c == 1) {
     const double acc =
-        2 * (cost_cr.point().s() / unit_t_ - init_point_.v()) / unit_t_;
+        2 * (curr_point.s() / unit_t_ - init_point_.v()) / unit_t_;
     if (acc < max_deceleration_ || acc > max_acceleration_) {
       return;
     }
 
     if (init_point_.v() + acc * unit_t_ < -kDoubleEpsilon &&
-        cost_cr.point().s() > min_s_consider_speed) {
+        curr_point.s() > min_s_consider_speed) {
       return;
     }
 
-    if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), cost_cr,
-                                cost_init)) {
+    if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), curr_point,
+                                PointAt(0, 0))) {
       return;
     }
-    cost_cr.SetTotalCost(
-        cost_cr.obstacle_cost() + cost_cr.spatial_potential_cost() +
-        cost_init.total_cost() +
-        CalculateEdgeCostForSecondCol(r, speed_limit, cruise_speed));
-    cost_cr.SetPrePoint(cost_init);
-    cost_cr.SetOptimalSpeed(init_point_.v() + acc * unit_t_);
+    total_cost_[index] =
+        point_cost + total_cost_[CellIndex(0, 0)] +
+        CalculateEdgeCostForSecondCol(r, speed_limit, cruise_speed);
+    pre_row_[index] = 0;
+    optimal_speed_[index] = init_point_.v() + acc * unit_t_;
     return;
   }
 
   static constexpr double kSpeedRangeBuffer = 0.20;
   const double pre_lowest_s =
-      cost_cr.point().s() -
+      curr_point.s() -
       FLAGS_planning_upper_speed_limit * (1 + kSpeedRangeBuffer) * unit_t_;
   const auto pre_lowest_itr =
       std::lower_bound(spatial_distance_by_index_.begin(),
@@ -387,14 +405,13 @@ void GriddedPathTimeGraph::CalculateCostAt(
         std::distance(spatial_distance_by_index_.begin(), pre_lowest_itr));
   }
   const uint32_t r_pre_size = r - r_low + 1;
-  const auto& pre_col = cost_table_[c - 1];
   double curr_speed_limit = speed_limit;
 
   if (c == 2) {
     for (uint32_t i = 0; i < r_pre_size; ++i) {
       uint32_t r_pre = r - i;
-      if (std::isinf(pre_col[r_pre].total_cost()) ||
-          pre_col[r_pre].pre_point() == nullptr) {
+      const size_t pre_index = CellIndex(c - 1, r_pre);
+      if (std::isinf(total_cost_[pre_index]) || pre_row_[pre_index] < 0) {
         continue;
       }
       // TODO(Jiaxuan): Calculate accurate acceleration by recording speed
@@ -403,40 +420,36 @@ void GriddedPathTimeGraph::CalculateCostAt(
       // Use pre_v = (pre_point.s - prepre_point.s) / unit_t as previous v
       // Current acc estimate: curr_a = (curr_v - pre_v) / unit_t
       // = (point.s + prepre_point.s - 2 * pre_point.s) / (unit_t * unit_t)
+      const STPoint pre_point = PointAt(c - 1, r_pre);
+      const double pre_speed = optimal_speed_[pre_index];
       const double curr_a =
-          2 *
-          ((cost_cr.point().s() - pre_col[r_pre].point().s()) / unit_t_ -
-           pre_col[r_pre].GetOptimalSpeed()) /
+          2 * ((curr_point.s() - pre_point.s()) / unit_t_ - pre_speed) /
           unit_t_;
       if (curr_a < max_deceleration_ || curr_a > max_acceleration_) {
         continue;
       }
 
-      if (pre_col[r_pre].GetOptimalSpeed() + curr_a * unit_t_ <
-              -kDoubleEpsilon &&
-          cost_cr.point().s() > min_s_consider_speed) {
+      if (pre_speed + curr_a * unit_t_ < -kDoubleEpsilon &&
+          curr_point.s() > min_s_consider_speed) {
         continue;
       }
 
       // Filter out continuous-time node connection which is in collision with
       // obstacle
-      if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), cost_cr,
-                                  pre_col[r_pre])) {
+      if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), curr_point,
+                                  pre_point)) {
         continue;
       }
       curr_speed_limit =
           std::fmin(curr_speed_limit, speed_limit_by_index_[r_pre]);
-      const double cost = cost_cr.obstacle_cost() +
-                          cost_cr.spatial_potential_cost() +
-                          pre_col[r_pre].total_cost() +
+      const double cost = point_cost + total_cost_[pre_index] +
                           CalculateEdgeCostForThirdCol(
                               r, r_pre, curr_speed_limit, cruise_speed);
 
-      if (cost < cost_cr.total_cost()) {
-        cost_cr.SetTotalCost(cost);
-        cost_cr.SetPrePoint(pre_col[r_pre]);
-        cost_cr.SetOptimalSpeed(pre_col[r_pre].GetOptimalSpeed() +
-                                curr_a * unit_t_);
+      if (cost < total_cost_[index]) {
+        total_cost_[index] = cost;
+        pre_row_[index] = static_cast<int32_t>(r_pre);
+        optimal_speed_[index] = pre_speed + curr_a * unit_t_;
       }
     }
     return;
@@ -444,109 +457,114 @@ void GriddedPathTimeGraph::CalculateCostAt(
 
   for (uint32_t i = 0; i < r_pre_size; ++i) {
     uint32_t r_pre = r - i;
-    if (std::isinf(pre_col[r_pre].total_cost()) ||
-        pre_col[r_pre].pre_point() == nullptr) {
+    const size_t pre_index = CellIndex(c - 1, r_pre);
+    if (std::isinf(total_cost_[pre_index]) || pre_row_[pre_index] < 0) {
       continue;
     }
     // Use curr_v = (point.s - pre_point.s) / unit_t as current v
     // Use pre_v = (pre_point.s - prepre_point.s) / unit_t as previous v
     // Current acc estimate: curr_a = (curr_v - pre_v) / unit_t
     // = (point.s + prepre_point.s - 2 * pre_point.s) / (unit_t * unit_t)
+    const STPoint pre_point = PointAt(c - 1, r_pre);
+    const double pre_speed = optimal_speed_[pre_index];
     const double curr_a =
-        2 *
-        ((cost_cr.point().s() - pre_col[r_pre].point().s()) / unit_t_ -
-         pre_col[r_pre].GetOptimalSpeed()) /
-        unit_t_;
+        2 * ((curr_point.s() - pre_point.s()) / unit_t_ - pre_speed) / unit_t_;
     if (curr_a > max_acceleration_ || curr_a < max_deceleration_) {
       continue;
     }
 
-    if (pre_col[r_pre].GetOptimalSpeed() + curr_a * unit_t_ < -kDoubleEpsilon &&
-        cost_cr.point().s() > min_s_consider_speed) {
+    if (pre_speed + curr_a * unit_t_ < -kDoubleEpsilon &&
+        curr_point.s() > min_s_consider_speed) {
       continue;
     }
 
-    if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), cost_cr,
-                                pre_col[r_pre])) {
+    if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), curr_point,
+                                pre_point)) {
       continue;
     }
 
-    uint32_t r_prepre = pre_col[r_pre].pre_point()->index_s();
-    const StGraphPoint& prepre_graph_point = cost_table_[c - 2][r_prepre];
-    if (std::isinf(prepre_graph_point.total_cost())) {
+    const uint32_t r_prepre = static_cast<uint32_t>(pre_row_[pre_index]);
+    const size_t prepre_index = CellIndex(c - 2, r_prepre);
+    if (std::isinf(total_cost_[prepre_index])) {
       continue;
     }
 
-    if (!prepre_graph_point.pre_point()) {
+    if (pre_row_[prepre_index] < 0) {
       continue;
     }
-    const STPoint& triple_pre_point = prepre_graph_point.pre_point()->point();
-    const STPoint& prepre_point = prepre_graph_point.point();
-    const STPoint& pre_point = pre_col[r_pre].point();
-    const STPoint& curr_point = cost_cr.point();
+    const STPoint triple_pre_point =
+        PointAt(c - 3, static_cast<uint32_t>(pre_row_[prepre_index]));
+    const STPoint prepre_point = PointAt(c - 2, r_prepre);
     curr_speed_limit =
         std::fmin(curr_speed_limit, speed_limit_by_index_[r_pre]);
-    double cost = cost_cr.obstacle_cost() + cost_cr.spatial_potential_cost() +
-                  pre_col[r_pre].total_cost() +
+    double cost = point_cost + total_cost_[pre_index] +
                   CalculateEdgeCost(triple_pre_point, prepre_point, pre_point,
                                     curr_point, curr_speed_limit, cruise_speed);
 
-    if (cost < cost_cr.total_cost()) {
-      cost_cr.SetTotalCost(cost);
-      cost_cr.SetPrePoint(pre_col[r_pre]);
-      cost_cr.SetOptimalSpeed(pre_col[r_pre].GetOptimalSpeed() +
-                              curr_a * unit_t_);
+    if (cost < total_cost_[index]) {
+      total_cost_[index] = cost;
+      pre_row_[index] = static_cast<int32_t>(r_pre);
+      optimal_speed_[index] = pre_speed + curr_a * unit_t_;
     }
   }
 }
 
 Status GriddedPathTimeGraph::RetrieveSpeedProfile(SpeedData* const speed_data) {
   double min_cost = std::numeric_limits<double>::infinity();
-  const StGraphPoint* best_end_point = nullptr;
+  uint32_t best_c = 0;
+  int32_t best_r = -1;
   PrintPoints debug("dp_node_edge");
-  for (const auto& points_vec : cost_table_) {
-    for (const auto& pt : points_vec) {
-      debug.AddPoint(pt.point().t(), pt.point().s());
+  for (const double t : time_by_index_) {
+    for (const double s : spatial_distance_by_index_) {
+      debug.AddPoint(t, s);
     }
   }
   // for debug plot
   // debug.PrintToLog();
-  for (const StGraphPoint& cur_point : cost_table_.back()) {
-    if (!std::isinf(cur_point.total_cost()) &&
-        cur_point.total_cost() < min_cost) {
-      best_end_point = &cur_point;
-      min_cost = cur_point.total_cost();
+  const uint32_t last_c = dimension_t_ - 1;
+  for (uint32_t r = 0; r < dimension_s_; ++r) {
+    const double cost = total_cost_[CellIndex(last_c, r)];
+    if (!std::isinf(cost) && cost < min_cost) {
+      best_c = last_c;
+      best_r = static_cast<int32_t>(r);
+      min_cost = cost;
     }
   }
 
-  for (const auto& row : cost_table_) {
-    const StGraphPoint& cur_point = row.back();
-    if (!std::isinf(cur_point.total_cost()) &&
-        cur_point.total_cost() < min_cost) {
-      best_end_point = &cur_point;
-      min_cost = cur_point.total_cost();
+  const uint32_t last_r = dimension_s_ - 1;
+  for (uint32_t c = 0; c < dimension_t_; ++c) {
+    const double cost = total_cost_[CellIndex(c, last_r)];
+    if (!std::isinf(cost) && cost < min_cost) {
+      best_c = c;
+      best_r = static_cast<int32_t>(last_r);
+      min_cost = cost;
     }
   }
 
-  if (best_end_point == nullptr) {
+  if (best_r < 0) {
     const std::string msg = "Fail to find the best feasible trajectory.";
     AERROR << msg;
     return Status(ErrorCode::PLANNING_ERROR, msg);
   }
 
   std::vector<SpeedPoint> speed_profile;
-  const StGraphPoint* cur_point = best_end_point;
   PrintPoints debug_res("dp_result");
-  while (cur_point != nullptr) {
-    ADEBUG << "Time: " << cur_point->point().t();
-    ADEBUG << "S: " << cur_point->point().s();
-    ADEBUG << "V: " << cur_point->GetOptimalSpeed();
+  uint32_t c = best_c;
+  int32_t r = best_r;
+  while (r >= 0) {
+    const size_t index = CellIndex(c, static_cast<uint32_t>(r));
+    const STPoint cur_point = PointAt(c, static_cast<uint32_t>(r));
+    const double cur_speed = optimal_speed_[index];
+    ADEBUG << "Time: " << cur_point.t();
+    ADEBUG << "S: " << cur_point.s();
+    ADEBUG << "V: " << cur_speed;
     SpeedPoint speed_point;
-    debug_res.AddPoint(cur_point->point().t(), cur_point->point().s());
-    speed_point.set_s(cur_point->point().s());
-    speed_point.set_t(cur_point->point().t());
+    debug_res.AddPoint(cur_point.t(), cur_point.s());
+    speed_point.set_s(cur_point.s());
+    speed_point.set_t(cur_point.t());
     speed_profile.push_back(speed_point);
-    cur_point = cur_point->pre_point();
+    r = pre_row_[index];
+    --c;
   }
   //  for debug plot
   //   debug_res.PrintToLog();
@@ -582,8 +600,8 @@ double GriddedPathTimeGraph::CalculateEdgeCostForSecondCol(
     const uint32_t row, const double speed_limit, const double cruise_speed) {
   double init_speed = init_point_.v();
   double init_acc = init_point_.a();
-  const STPoint& pre_point = cost_table_[0][0].point();
-  const STPoint& curr_point = cost_table_[1][row].point();
+  const STPoint pre_point = PointAt(0, 0);
+  const STPoint curr_point = PointAt(1, row);
   return dp_st_cost_.GetSpeedCost(pre_point, curr_point, speed_limit,
                                   cruise_speed) +
          dp_st_cost_.GetAccelCostByTwoPoints(init_speed, pre_point,
@@ -596,9 +614,9 @@ double GriddedPathTimeGraph::CalculateEdgeCostForThirdCol(
     const uint32_t curr_row, const uint32_t pre_row, const double speed_limit,
     const double cruise_speed) {
   double init_speed = init_point_.v();
-  const STPoint& first = cost_table_[0][0].point();
-  const STPoint& second = cost_table_[1][pre_row].point();
-  const STPoint& third = cost_table_[2][curr_row].point();
+  const STPoint first = PointAt(0, 0);
+  const STPoint second = PointAt(1, pre_row);
+  const STPoint third = PointAt(2, curr_row);
   return dp_st_cost_.GetSpeedCost(second, third, speed_limit, cruise_speed) +
          dp_st_cost_.GetAccelCostByThreePoints(first, second, third) +
          dp_st_cost_.GetJerkCostByThreePoints(init_speed, first, second, third);
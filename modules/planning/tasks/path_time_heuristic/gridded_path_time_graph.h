@@ -20,7 +20,7 @@
 
 #pragma once
 
-#include <memory>
+#include <cstdint>
 #include <vector>
 
 #include "modules/common_msgs/config_msgs/vehicle_config.pb.h"
@@ -35,7 +35,6 @@
 #include "modules/planning/planning_base/common/speed/st_point.h"
 #include "modules/planning/planning_base/common/st_graph_data.h"
 #include "modules/planning/tasks/path_time_heuristic/dp_st_cost.h"
-#include "modules/planning/tasks/path_time_heuristic/st_graph_point.h"
 
 namespace apollo {
 namespace planning {
@@ -58,13 +57,11 @@ class GriddedPathTimeGraph {
 
   common::Status CalculateTotalCost();
 
-  // defined for cyber task
-  struct StGraphMessage {
-    StGraphMessage(const uint32_t c_, const int32_t r_) : c(c_), r(r_) {}
-    uint32_t c;
-    uint32_t r;
-  };
-  void CalculateCostAt(const std::shared_ptr<StGraphMessage>& msg);
+  // calculates the costs of the rows [begin_row, end_row) of col c
+  void CalculateCostsAt(const uint32_t c, const uint32_t begin_row,
+                        const uint32_t end_row);
+
+  void CalculateCostAt(const uint32_t c, const uint32_t r);
 
   double CalculateEdgeCost(const STPoint& first, const STPoint& second,
                            const STPoint& third, const STPoint& forth,
@@ -78,8 +75,17 @@ class GriddedPathTimeGraph {
                                       const double cruise_speed);
 
   // get the row-range of next time step
-  void GetRowRange(const StGraphPoint& point, size_t* next_highest_row,
-                   size_t* next_lowest_row);
+  void GetRowRange(const uint32_t c, const uint32_t r, size_t* next_highest_row,
+                   size_t* next_lowest_row) const;
+
+  // the index of the point of col c and row r in the cost table
+  size_t CellIndex(const uint32_t c, const uint32_t r) const {
+    return static_cast<size_t>(c) * dimension_s_ + r;
+  }
+
+  STPoint PointAt(const uint32_t c, const uint32_t r) const {
+    return STPoint(spatial_distance_by_index_[r], time_by_index_[c]);
+  }
 
  private:
   const StGraphData& st_graph_data_;
@@ -88,6 +94,8 @@ class GriddedPathTimeGraph {
 
   std::vector<double> spatial_distance_by_index_;
 
+  std::vector<double> time_by_index_;
+
   // dp st configuration
   DpStSpeedOptimizerConfig gridded_path_time_graph_config_;
 
@@ -118,9 +126,13 @@ class GriddedPathTimeGraph {
   double max_acceleration_ = 0.0;
   double max_deceleration_ = 0.0;
 
-  // cost_table_[t][s]
+  // The cost table as one array per field, each indexed by CellIndex(t, s)
+  // so that a col is contiguous.
   // row: s, col: t --- NOTICE: Please do NOT change.
-  std::vector<std::vector<StGraphPoint>> cost_table_;
+  std::vector<double> total_cost_;
+  std::vector<double> optimal_speed_;
+  // the row of the pre point in the previous col, -1 for none
+  std::vector<int32_t> pre_row_;
 };
 
 }  // namespace planning
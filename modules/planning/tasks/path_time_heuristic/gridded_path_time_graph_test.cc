@@ -107,5 +107,50 @@ TEST_F(DpStGraphTest, simple) {
   EXPECT_TRUE(ret.ok());
 }
 
+TEST_F(DpStGraphTest, multi_thread) {
+  Obstacle o1;
+  o1.SetId("o1");
+  obstacle_list_.push_back(o1);
+
+  std::vector<const Obstacle*> obstacles_;
+  obstacles_.emplace_back(&(obstacle_list_.back()));
+
+  // an obstacle cutting in ahead and moving away
+  std::vector<std::pair<STPoint, STPoint>> point_pairs;
+  point_pairs.emplace_back(STPoint(15.0, 1.0), STPoint(20.0, 1.0));
+  point_pairs.emplace_back(STPoint(35.0, 5.0), STPoint(40.0, 5.0));
+  obstacle_list_.back().set_path_st_boundary(STBoundary(point_pairs));
+
+  std::vector<const STBoundary*> boundaries;
+  boundaries.push_back(&(obstacles_.back()->path_st_boundary()));
+
+  init_point_.set_v(8.0);
+  init_point_.set_a(0.0);
+
+  planning_internal::STGraphDebug st_graph_debug;
+  st_graph_data_ = StGraphData();
+  st_graph_data_.LoadData(boundaries, 15.0, init_point_, speed_limit_, 10.0,
+                          120.0, 7.0, &st_graph_debug);
+
+  SpeedData serial_speed_data;
+  GriddedPathTimeGraph serial_graph(st_graph_data_, dp_config_, obstacles_,
+                                    init_point_);
+  ASSERT_TRUE(serial_graph.Search(&serial_speed_data).ok());
+
+  // the rows of a time step are split among the tasks, which must not change
+  // the result
+  dp_config_.set_enable_multi_thread_in_dp_st_graph(true);
+  SpeedData speed_data;
+  GriddedPathTimeGraph dp_st_graph(st_graph_data_, dp_config_, obstacles_,
+                                   init_point_);
+  ASSERT_TRUE(dp_st_graph.Search(&speed_data).ok());
+
+  ASSERT_EQ(serial_speed_data.size(), speed_data.size());
+  for (size_t i = 0; i < speed_data.size(); ++i) {
+    EXPECT_DOUBLE_EQ(serial_speed_data[i].s(), speed_data[i].s());
+    EXPECT_DOUBLE_EQ(serial_speed_data[i].t(), speed_data[i].t());
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -177,6 +177,8 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
   piecewise_jerk_problem.set_x_ref(config_.ref_s_weight(), std::move(x_ref));
   piecewise_jerk_problem.set_penalty_dx(penalty_dx);
   piecewise_jerk_problem.set_dx_bounds(std::move(s_dot_bounds));
+  // the knots move by one planning cycle from the last solve
+  piecewise_jerk_problem.set_warm_start_shift(1.0 / FLAGS_planning_loop_rate);
 
   // Solve the problem
   if (!piecewise_jerk_problem.Optimize()) {
@@ -200,6 +202,11 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
     }
   }
 
+  ADEBUG << "Speed optimizer setup time: "
+         << piecewise_jerk_problem.setup_time_ms()
+         << " ms, solve time: " << piecewise_jerk_problem.solve_time_ms()
+         << " ms.";
+
   // Extract output
   const std::vector<double>& s = piecewise_jerk_problem.opt_x();
   const std::vector<double>& ds = piecewise_jerk_problem.opt_dx();
@@ -47,7 +47,17 @@ bool RuleBasedStopDecider::Init(
     return false;
   }
   // Load the config this task.
-  return Decider::LoadConfig<RuleBasedStopDeciderConfig>(&config_);
+  if (!Decider::LoadConfig<RuleBasedStopDeciderConfig>(&config_)) {
+    return false;
+  }
+  if (config_.enable_lane_change_urgency_checking() &&
+      FLAGS_enable_parallel_reference_line_planning) {
+    // the check changes the other reference lines while they are planned
+    AWARN << "Lane change urgency checking is disabled with parallel "
+             "reference line planning.";
+    config_.set_enable_lane_change_urgency_checking(false);
+  }
+  return true;
 }
 
 apollo::common::Status RuleBasedStopDecider::Process(
@@ -134,24 +144,21 @@ void RuleBasedStopDecider::AddPathEndStop(
 
 void RuleBasedStopDecider::StopOnSidePass(
     Frame *const frame, ReferenceLineInfo *const reference_line_info) {
-  static bool check_clear;
-  static common::PathPoint change_lane_stop_path_point;
-
   const PathData &path_data = reference_line_info->path_data();
   double stop_s_on_pathdata = 0.0;
 
   if (path_data.path_label().find("self") != std::string::npos) {
-    check_clear = false;
-    change_lane_stop_path_point.Clear();
+    check_clear_ = false;
+    change_lane_stop_path_point_.Clear();
     return;
   }
 
-  if (check_clear &&
-      CheckClearDone(*reference_line_info, change_lane_stop_path_point)) {
-    check_clear = false;
+  if (check_clear_ &&
+      CheckClearDone(*reference_line_info, change_lane_stop_path_point_)) {
+    check_clear_ = false;
   }
 
-  if (!check_clear &&
+  if (!check_clear_ &&
       CheckSidePassStop(path_data, *reference_line_info, &stop_s_on_pathdata)) {
     if (!IsPerceptionBlocked(*reference_line_info, config_.search_beam_length(),
                              config_.search_beam_radius_intensity(),
@@ -162,13 +169,13 @@ void RuleBasedStopDecider::StopOnSidePass(
     }
     if (!CheckADCStop(path_data, *reference_line_info, stop_s_on_pathdata)) {
       if (!BuildSidePassStopFence(path_data, stop_s_on_pathdata,
-                                  &change_lane_stop_path_point, frame,
+                                  &change_lane_stop_path_point_, frame,
                                   reference_line_info)) {
         AERROR << "Set side pass stop fail";
       }
     } else {
       if (IsClearToChangeLane(reference_line_info)) {
-        check_clear = true;
+        check_clear_ = true;
       }
     }
   }
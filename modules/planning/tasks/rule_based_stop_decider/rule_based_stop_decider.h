@@ -73,6 +73,9 @@ class RuleBasedStopDecider : public Decider {
   RuleBasedStopDeciderConfig config_;
   bool is_clear_to_change_lane_ = false;
   bool is_change_lane_planning_succeed_ = false;
+  // side pass stop state of the reference line planned by this instance
+  bool check_clear_ = false;
+  common::PathPoint change_lane_stop_path_point_;
 };
 
 CYBER_PLUGIN_MANAGER_REGISTER_PLUGIN(apollo::planning::RuleBasedStopDecider,